@@ -15,6 +15,7 @@ KOBJ = obj/k/$(BINARYDIR)
 IOBJ = obj/i/$(BINARYDIR)
 VOBJ = obj/v/$(BINARYDIR)
 SOBJ = obj/s/$(BINARYDIR)
+BENCHOBJ = obj/bench/$(BINARYDIR)
 BLUEOBJ = obj/blue/$(BINARYDIR)
 CFGOBJ = obj/cfg/$(BINARYDIR)
 LINEOBJ = obj/line/$(BINARYBUILDDIR)
@@ -170,6 +171,7 @@ menu: $(MENUOBJ) $(MENUOBJ)/advmenu$(EXE)
 cfg: $(CFGOBJ) $(CFGOBJ)/advcfg$(EXE)
 v: $(VOBJ) $(VOBJ)/advv$(EXE)
 s: $(SOBJ) $(SOBJ)/advs$(EXE)
+bench: $(BENCHOBJ) $(BENCHOBJ)/advblitbench$(EXE) $(BENCHOBJ)/advresamplebench$(EXE)
 k: $(KOBJ) $(KOBJ)/advk$(EXE)
 i: $(IOBJ) $(IOBJ)/advi$(EXE)
 j: $(JOBJ) $(JOBJ)/advj$(EXE)
@@ -283,6 +285,10 @@ S_SRC = \
 	$(wildcard $(srcdir)/advance/s/*.c) \
 	$(wildcard $(srcdir)/advance/s/*.h)
 
+BENCH_SRC = \
+	$(wildcard $(srcdir)/advance/bench/*.c) \
+	$(wildcard $(srcdir)/advance/bench/*.h)
+
 I_SRC = \
 	$(wildcard $(srcdir)/advance/i/*.c) \
 	$(wildcard $(srcdir)/advance/i/*.h)
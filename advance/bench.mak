@@ -0,0 +1,128 @@
+############################################################################
+# BENCH
+
+# Dependencies on VERSION
+$(BENCHOBJ)/bench/bench.o: Makefile
+$(BENCHOBJ)/bench/rbench.o: Makefile
+
+BENCHCFLAGS += \
+	-DADV_VERSION=\"$(VERSION)\" \
+	-I$(srcdir)/advance/lib \
+	-I$(srcdir)/advance/blit \
+	-I$(srcdir)/src/sound
+BENCHOBJS += \
+	$(BENCHOBJ)/lib/portable.o \
+	$(BENCHOBJ)/lib/snstring.o \
+	$(BENCHOBJ)/lib/log.o \
+	$(BENCHOBJ)/lib/video.o \
+	$(BENCHOBJ)/lib/measure.o \
+	$(BENCHOBJ)/lib/rgb.o \
+	$(BENCHOBJ)/lib/conf.o \
+	$(BENCHOBJ)/lib/incstr.o \
+	$(BENCHOBJ)/lib/videoio.o \
+	$(BENCHOBJ)/lib/update.o \
+	$(BENCHOBJ)/lib/generate.o \
+	$(BENCHOBJ)/lib/crtc.o \
+	$(BENCHOBJ)/lib/crtcbag.o \
+	$(BENCHOBJ)/lib/monitor.o \
+	$(BENCHOBJ)/lib/device.o \
+	$(BENCHOBJ)/lib/gtf.o \
+	$(BENCHOBJ)/lib/videoall.o \
+	$(BENCHOBJ)/lib/error.o \
+	$(BENCHOBJ)/blit/blit.o \
+	$(BENCHOBJ)/blit/hq2x.o \
+	$(BENCHOBJ)/blit/hq2x3.o \
+	$(BENCHOBJ)/blit/hq2x4.o \
+	$(BENCHOBJ)/blit/hq3x.o \
+	$(BENCHOBJ)/blit/hq4x.o \
+	$(BENCHOBJ)/blit/xbr2x.o \
+	$(BENCHOBJ)/blit/xbr3x.o \
+	$(BENCHOBJ)/blit/xbr4x.o \
+	$(BENCHOBJ)/blit/scale2x.o \
+	$(BENCHOBJ)/blit/scale3x.o \
+	$(BENCHOBJ)/blit/scale2k.o \
+	$(BENCHOBJ)/blit/scale3k.o \
+	$(BENCHOBJ)/blit/scale4k.o \
+	$(BENCHOBJ)/blit/interp.o \
+	$(BENCHOBJ)/blit/clear.o \
+	$(BENCHOBJ)/blit/slice.o \
+	$(BENCHOBJ)/bench/bench.o
+RBENCHOBJS += \
+	$(BENCHOBJ)/lib/portable.o \
+	$(BENCHOBJ)/lib/snstring.o \
+	$(BENCHOBJ)/lib/log.o \
+	$(BENCHOBJ)/lib/conf.o \
+	$(BENCHOBJ)/lib/incstr.o \
+	$(BENCHOBJ)/lib/measure.o \
+	$(BENCHOBJ)/lib/error.o \
+	$(BENCHOBJ)/sound/resample.o \
+	$(BENCHOBJ)/bench/rbench.o
+BENCHOBJDIRS += \
+	$(BENCHOBJ)/bench \
+	$(BENCHOBJ)/lib \
+	$(BENCHOBJ)/blit \
+	$(BENCHOBJ)/sound
+
+ifeq ($(CONF_SYSTEM),unix)
+BENCHCFLAGS += \
+	-DADV_DATADIR=\"$(datadir)\" \
+	-DADV_SYSCONFDIR=\"$(sysconfdir)\" \
+	-I$(srcdir)/advance/linux
+BENCHOBJDIRS += \
+	$(BENCHOBJ)/linux
+BENCHOBJS += \
+	$(BENCHOBJ)/linux/file.o \
+	$(BENCHOBJ)/linux/target.o \
+	$(BENCHOBJ)/linux/os.o
+RBENCHOBJS += \
+	$(BENCHOBJ)/linux/file.o \
+	$(BENCHOBJ)/linux/target.o \
+	$(BENCHOBJ)/linux/os.o
+BENCHLIBS += -lm
+endif
+
+ifeq ($(CONF_SYSTEM),windows)
+BENCHCFLAGS += \
+	-DADV_DATADIR=\"$(DATADIR)\" \
+	-I$(srcdir)/advance/windows
+BENCHOBJDIRS += \
+	$(BENCHOBJ)/windows \
+	$(BENCHOBJ)/dos
+BENCHOBJS += \
+	$(BENCHOBJ)/dos/file.o \
+	$(BENCHOBJ)/windows/target.o \
+	$(BENCHOBJ)/windows/os.o
+RBENCHOBJS += \
+	$(BENCHOBJ)/dos/file.o \
+	$(BENCHOBJ)/windows/target.o \
+	$(BENCHOBJ)/windows/os.o
+BENCHLIBS += -lm
+endif
+
+$(BENCHOBJ)/%.o: $(srcdir)/advance/%.c
+	$(ECHO) $@ $(MSG)
+	$(CC) $(CFLAGS) $(BENCHCFLAGS) -c $< -o $@
+
+$(BENCHOBJ)/sound/%.o: $(srcdir)/src/sound/%.c
+	$(ECHO) $@ $(MSG)
+	$(CC) $(CFLAGS) $(BENCHCFLAGS) -c $< -o $@
+
+$(BENCHOBJ):
+	$(ECHO) $@
+	$(MD) $@
+
+$(sort $(BENCHOBJDIRS)):
+	$(ECHO) $@
+	$(MD) $@
+
+$(BENCHOBJ)/advblitbench$(EXE) : $(sort $(BENCHOBJDIRS)) $(BENCHOBJS)
+	$(ECHO) $@ $(MSG)
+	$(LD) $(BENCHOBJS) $(BENCHLIBS) $(BENCHLDFLAGS) $(LDFLAGS) $(LIBS) -o $@
+	$(RM) advblitbench$(EXE)
+	$(LN_S) $@ advblitbench$(EXE)
+
+$(BENCHOBJ)/advresamplebench$(EXE) : $(sort $(BENCHOBJDIRS)) $(RBENCHOBJS)
+	$(ECHO) $@ $(MSG)
+	$(LD) $(RBENCHOBJS) $(BENCHLIBS) $(BENCHLDFLAGS) $(LDFLAGS) $(LIBS) -o $@
+	$(RM) advresamplebench$(EXE)
+	$(LN_S) $@ advresamplebench$(EXE)
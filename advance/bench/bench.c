@@ -0,0 +1,882 @@
+/*
+ * This file is part of the Advance project.
+ *
+ * Copyright (C) 2001, 2002, 2003 Andrea Mazzoleni
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "portable.h"
+
+#include "advance.h"
+
+/***************************************************************************/
+/* tables */
+
+#define BENCH_DIRECT 0
+#define BENCH_PALETTE8 1
+#define BENCH_PALETTE16 2
+
+/* Format of the source and of the target */
+struct bench_format {
+	const char* name;
+	unsigned type; /**< BENCH_DIRECT or BENCH_PALETTE*, only for the source. */
+	unsigned bytes_per_pixel;
+	unsigned red_len, red_pos, green_len, green_pos, blue_len, blue_pos; /**< Only for rgb. */
+};
+
+static struct bench_format SOURCE[] = {
+	{ "palette8", BENCH_PALETTE8, 1, 0, 0, 0, 0, 0, 0 },
+	{ "palette16", BENCH_PALETTE16, 2, 0, 0, 0, 0, 0, 0 },
+	{ "bgra5551", BENCH_DIRECT, 2, 5, 10, 5, 5, 5, 0 },
+	{ "bgr565", BENCH_DIRECT, 2, 5, 11, 6, 5, 5, 0 },
+	{ "bgra8888", BENCH_DIRECT, 4, 8, 16, 8, 8, 8, 0 }
+};
+
+static struct bench_format TARGET[] = {
+	{ "bgr332", BENCH_DIRECT, 1, 3, 5, 3, 2, 2, 0 },
+	{ "bgra5551", BENCH_DIRECT, 2, 5, 10, 5, 5, 5, 0 },
+	{ "bgr565", BENCH_DIRECT, 2, 5, 11, 6, 5, 5, 0 },
+	{ "bgra8888", BENCH_DIRECT, 4, 8, 16, 8, 8, 8, 0 },
+	{ "yuy2", BENCH_DIRECT, 2, 0, 0, 0, 0, 0, 0 }
+};
+
+#define BENCH_SWAP_XY 0x1
+#define BENCH_FLIP_X 0x2
+#define BENCH_FLIP_Y 0x4
+
+/* Orientation of the source, like the one of the game */
+struct bench_orientation {
+	const char* name;
+	unsigned flags;
+};
+
+static struct bench_orientation ORIENTATION[] = {
+	{ "none", 0 },
+	{ "flipx", BENCH_FLIP_X },
+	{ "flipy", BENCH_FLIP_Y },
+	{ "swapxy", BENCH_SWAP_XY },
+	{ "rol", BENCH_SWAP_XY | BENCH_FLIP_Y },
+	{ "ror", BENCH_SWAP_XY | BENCH_FLIP_X }
+};
+
+/* Size of the target, as fraction of the source */
+struct bench_scale {
+	const char* name;
+	unsigned mul;
+	unsigned div;
+};
+
+static struct bench_scale SCALE[] = {
+	{ "1", 1, 1 },
+	{ "2", 2, 1 },
+	{ "3", 3, 1 },
+	{ "4", 4, 1 },
+	{ "5/3", 5, 3 },
+	{ "3/5", 3, 5 }
+};
+
+#define BENCH_MAGNIFY 0x1 /**< The effect requires a magnify of 2, 3 or 4. */
+#define BENCH_EXPAND 0x2 /**< The effect requires an expansion. */
+
+/* Effects, with the names of the advmame options */
+struct bench_effect {
+	const char* name;
+	unsigned combine;
+	unsigned flags;
+};
+
+static struct bench_effect EFFECT[] = {
+	{ "none", VIDEO_COMBINE_Y_NONE, 0 },
+	{ "max", VIDEO_COMBINE_Y_MAXMIN | VIDEO_COMBINE_X_MAXMIN, 0 },
+	{ "mean", VIDEO_COMBINE_Y_MEAN | VIDEO_COMBINE_X_MEAN, 0 },
+	{ "filter", VIDEO_COMBINE_Y_FILTER | VIDEO_COMBINE_X_FILTER, BENCH_EXPAND },
+	{ "scalex", VIDEO_COMBINE_Y_SCALEX, BENCH_MAGNIFY },
+	{ "scalek", VIDEO_COMBINE_Y_SCALEK, BENCH_MAGNIFY },
+	{ "hq", VIDEO_COMBINE_Y_HQ, BENCH_MAGNIFY },
+	{ "xbr", VIDEO_COMBINE_Y_XBR, BENCH_MAGNIFY },
+	{ "triad3dot", VIDEO_COMBINE_X_RGB_TRIAD3PIX, 0 },
+	{ "triad6dot", VIDEO_COMBINE_X_RGB_TRIAD6PIX, 0 },
+	{ "triad16dot", VIDEO_COMBINE_X_RGB_TRIAD16PIX, 0 },
+	{ "triadstrong3dot", VIDEO_COMBINE_X_RGB_TRIADSTRONG3PIX, 0 },
+	{ "triadstrong6dot", VIDEO_COMBINE_X_RGB_TRIADSTRONG6PIX, 0 },
+	{ "triadstrong16dot", VIDEO_COMBINE_X_RGB_TRIADSTRONG16PIX, 0 },
+	{ "scan2horz", VIDEO_COMBINE_X_RGB_SCANDOUBLEHORZ, 0 },
+	{ "scan2vert", VIDEO_COMBINE_X_RGB_SCANDOUBLEVERT, 0 },
+	{ "scan3horz", VIDEO_COMBINE_X_RGB_SCANTRIPLEHORZ, 0 },
+	{ "scan3vert", VIDEO_COMBINE_X_RGB_SCANTRIPLEVERT, 0 },
+	{ "odd", VIDEO_COMBINE_SWAP_ODD, 0 },
+	{ "even", VIDEO_COMBINE_SWAP_EVEN, 0 },
+	{ "interlacefilter", VIDEO_COMBINE_INTERLACE_FILTER, 0 }
+};
+
+#define BENCH_COUNT(table) (sizeof(table) / sizeof(table[0]))
+
+/***************************************************************************/
+/* state */
+
+/* Max size of the target in every direction */
+#define BENCH_SIZE_MAX 4096
+
+static unsigned bench_source_size_x = 320;
+static unsigned bench_source_size_y = 240;
+static target_clock_t bench_clock_limit;
+
+static unsigned bench_source_mask = ~0U;
+static unsigned bench_target_mask = ~0U;
+static unsigned bench_orientation_mask = ~0U;
+static unsigned bench_scale_mask = ~0U;
+static unsigned bench_effect_mask = ~0U;
+static unsigned bench_level_mask = ~0U;
+static adv_bool bench_fuse = 1;
+static adv_bool bench_rotate = 1;
+
+static uint8* bench_bitmap;
+static unsigned bench_bitmap_dw;
+static unsigned bench_bitmap_size;
+static uint8* bench_screen;
+static uint8* bench_row[2];
+
+static uint8 bench_palette8[65536];
+static uint16 bench_palette16[65536];
+static uint32 bench_palette32[65536];
+
+/**
+ * Allocate a memory block aligned for the SIMD instructions.
+ */
+static void* bench_alloc(void** raw, unsigned size)
+{
+	*raw = malloc(size + 64);
+	if (!*raw)
+		return 0;
+	return ALIGN_PTR(*raw, 64);
+}
+
+/**
+ * Fill a memory block with not uniform data, to not favorite the effects
+ * that check the equality of the pixels.
+ * \param mask Mask of the bits used. With a few bits there are also equal near pixels.
+ */
+static void bench_fill(void* ptr, unsigned size, unsigned mask)
+{
+	uint8* p = ptr;
+	unsigned seed = 1;
+	unsigned i;
+
+	for (i = 0; i < size; ++i) {
+		seed = seed * 1103515245 + 12345;
+		p[i] = (seed >> 16) & mask;
+	}
+}
+
+/**
+ * Get the index of a name in a table.
+ * \return The index, or -1 if not found.
+ */
+static int bench_find(const char* name, const void* table, unsigned count, unsigned size)
+{
+	unsigned i;
+
+	for (i = 0; i < count; ++i) {
+		const char* entry = *(const char* const*)((const uint8*)table + i * size);
+		if (strcasecmp(entry, name) == 0)
+			return i;
+	}
+
+	return -1;
+}
+
+/**
+ * Select an entry of a table from a command line option.
+ * The first selection clears the default of all the entries.
+ */
+static adv_error bench_select(unsigned* mask, adv_bool* first, const char* option, const char* name, const void* table, unsigned count, unsigned size)
+{
+	int i;
+
+	if (!*first) {
+		*first = 1;
+		*mask = 0;
+	}
+
+	if (strcasecmp(name, "all") == 0) {
+		*mask = ~0U;
+		return 0;
+	}
+
+	i = bench_find(name, table, count, size);
+	if (i < 0) {
+		target_err("Invalid value '%s' for option '-%s'.\n", name, option);
+		return -1;
+	}
+
+	*mask |= 1U << i;
+
+	return 0;
+}
+
+static adv_color_def bench_def(const struct bench_format* format)
+{
+	if (strcmp(format->name, "yuy2") == 0)
+		return color_def_make(adv_color_type_yuy2);
+
+	return color_def_make_rgb_from_sizelenpos(format->bytes_per_pixel, format->red_len, format->red_pos, format->green_len, format->green_pos, format->blue_len, format->blue_pos);
+}
+
+/***************************************************************************/
+/* bench */
+
+static void bench_header(void)
+{
+	printf("level,fuse,rotate,source,target,orientation,scale,effect,src_dx,src_dy,dst_dx,dst_dy,pipeline,stage,name,pixels,ns_per_pixel,mb_per_s\n");
+}
+
+/**
+ * Print a result row.
+ * \param pixels Number of target pixels written.
+ * \param size Number of target bytes written.
+ * \param clock Time used.
+ */
+static void bench_print(const char* prefix, const char* pipeline, const char* stage, const char* name, unsigned long long pixels, unsigned long long size, target_clock_t clock)
+{
+	double seconds = clock / (double)TARGET_CLOCKS_PER_SEC;
+
+	printf("%s,\"%s\",%s,\"%s\",%llu,%.3f,%.1f\n", prefix, pipeline, stage, name, pixels, seconds * 1E9 / pixels, size / seconds / 1E6);
+	fflush(stdout);
+}
+
+/**
+ * Get the description of the stages of a pipeline.
+ * The vertical stage is inserted before the pivot stage.
+ */
+static void bench_pipeline_name(char* buffer, unsigned size, const struct video_pipeline_struct* pipeline)
+{
+	const struct video_stage_vert_struct* stage_vert = video_pipeline_vert(pipeline);
+	const struct video_stage_horz_struct* stage;
+
+	*buffer = 0;
+	for (stage = video_pipeline_begin(pipeline); stage != video_pipeline_end(pipeline); ++stage) {
+		if (stage == stage_vert->stage_pivot) {
+			if (*buffer)
+				sncat(buffer, size, "|");
+			sncat(buffer, size, pipe_name(stage_vert->type));
+		}
+		if (*buffer)
+			sncat(buffer, size, "|");
+		sncat(buffer, size, pipe_name(stage->type));
+	}
+	if (stage_vert->stage_pivot == video_pipeline_end(pipeline)) {
+		if (*buffer)
+			sncat(buffer, size, "|");
+		sncat(buffer, size, pipe_name(stage_vert->type));
+	}
+}
+
+/**
+ * Measure a complete blit.
+ */
+static void bench_blit(const char* prefix, const char* name, const struct video_pipeline_struct* pipeline, const void* src)
+{
+	const struct video_stage_vert_struct* stage_vert = video_pipeline_vert(pipeline);
+	unsigned long long pixels = stage_vert->ddx * (unsigned long long)stage_vert->ddy;
+	unsigned long long size = pixels * pipeline->target.bytes_per_pixel;
+	target_clock_t start, stop;
+	unsigned count;
+
+	/* warm up the cache */
+	video_pipeline_blit(pipeline, 0, 0, src);
+
+	count = 0;
+	start = target_clock();
+	do {
+		video_pipeline_blit(pipeline, 0, 0, src);
+		++count;
+		stop = target_clock();
+	} while (stop - start < bench_clock_limit);
+
+	bench_print(prefix, name, "all", pipe_name(stage_vert->type), pixels * count, size * count, stop - start);
+}
+
+/**
+ * Measure a single horizontal stage.
+ * The first stage reads the source rows, unless it's after a vertical
+ * stage which computes plain rows. The others read a row of the same
+ * format of their input.
+ */
+static void bench_stage(const char* prefix, const char* name, const struct video_pipeline_struct* pipeline, const struct video_stage_horz_struct* stage, const void* src)
+{
+	const struct video_stage_vert_struct* stage_vert = video_pipeline_vert(pipeline);
+	target_clock_t start, stop;
+	unsigned count;
+	unsigned line;
+	char index[16];
+	adv_bool source;
+
+	source = stage == video_pipeline_begin(pipeline)
+		&& (stage != stage_vert->stage_pivot || stage->sdp != (int)stage->sbpp);
+
+	count = 0;
+	line = 0;
+	start = target_clock();
+	do {
+		unsigned i;
+
+		/* more rows for every clock read */
+		for (i = 0; i < 64; ++i) {
+			const uint8* row;
+
+			if (source)
+				row = (const uint8*)src + (int)line * stage_vert->sdw;
+			else
+				row = bench_row[0];
+
+			stage->put(stage, line, bench_row[1], row, stage->slice.count);
+
+			if (++line >= stage_vert->sdy)
+				line = 0;
+		}
+
+		count += 64;
+		stop = target_clock();
+	} while (stop - start < bench_clock_limit);
+
+	snprintf(index, sizeof(index), "%d", (int)(stage - video_pipeline_begin(pipeline)));
+
+	bench_print(prefix, name, index, pipe_name(stage->type), stage->ddx * (unsigned long long)count, stage->ddx * stage->dbpp * (unsigned long long)count, stop - start);
+}
+
+/**
+ * Setup the pipeline of a combination, with the same setup of the game
+ * bitmap done by the emulator.
+ * \param src Where to put the pointer at the first source pixel.
+ * \return 0 on success, -1 if the combination isn't possible.
+ */
+static adv_error bench_pipeline(struct video_pipeline_struct* pipeline, const uint8** src, char* prefix, unsigned prefix_size, unsigned level, unsigned s, unsigned t, unsigned o, unsigned m, unsigned e)
+{
+	const struct bench_format* source = &SOURCE[s];
+	const struct bench_format* target = &TARGET[t];
+	const struct bench_orientation* orientation = &ORIENTATION[o];
+	const struct bench_scale* scale = &SCALE[m];
+	const struct bench_effect* effect = &EFFECT[e];
+	unsigned src_dx, src_dy;
+	unsigned dst_dx, dst_dy;
+	int src_dw, src_dp;
+
+	if ((effect->flags & BENCH_MAGNIFY) != 0 && (scale->div != 1 || scale->mul < 2 || scale->mul > 4))
+		return -1;
+	if ((effect->flags & BENCH_EXPAND) != 0 && scale->mul < scale->div)
+		return -1;
+
+	*src = bench_bitmap;
+	src_dw = bench_bitmap_dw;
+	src_dp = source->bytes_per_pixel;
+	src_dx = bench_source_size_x;
+	src_dy = bench_source_size_y;
+	if (orientation->flags & BENCH_SWAP_XY) {
+		int t = src_dw;
+		src_dw = src_dp;
+		src_dp = t;
+		src_dx = bench_source_size_y;
+		src_dy = bench_source_size_x;
+	}
+	if (orientation->flags & BENCH_FLIP_Y) {
+		*src += (src_dy - 1) * src_dw;
+		src_dw = -src_dw;
+	}
+	if (orientation->flags & BENCH_FLIP_X) {
+		*src += (src_dx - 1) * src_dp;
+		src_dp = -src_dp;
+	}
+
+	dst_dx = src_dx * scale->mul / scale->div;
+	dst_dy = src_dy * scale->mul / scale->div;
+	if (dst_dx > BENCH_SIZE_MAX || dst_dy > BENCH_SIZE_MAX)
+		return -1;
+
+	/* yuy2 stores two pixels in 4 bytes, and the magnify effects need the exact size */
+	if (strcmp(target->name, "yuy2") == 0 && (dst_dx & 1) != 0) {
+		if ((effect->flags & BENCH_MAGNIFY) != 0)
+			return -1;
+		dst_dx &= ~1U;
+	}
+
+	if (dst_dx == 0 || dst_dy == 0)
+		return -1;
+
+	video_pipeline_init(pipeline);
+	video_pipeline_target(pipeline, bench_screen, BENCH_SIZE_MAX * 4, bench_def(target));
+
+	switch (source->type) {
+	case BENCH_DIRECT :
+		video_pipeline_direct(pipeline, dst_dx, dst_dy, src_dx, src_dy, src_dw, src_dp, bench_def(source), effect->combine);
+		break;
+	case BENCH_PALETTE8 :
+		video_pipeline_palette8(pipeline, dst_dx, dst_dy, src_dx, src_dy, src_dw, src_dp, bench_palette8, bench_palette16, bench_palette32, effect->combine);
+		break;
+	case BENCH_PALETTE16 :
+		video_pipeline_palette16(pipeline, dst_dx, dst_dy, src_dx, src_dy, src_dw, src_dp, bench_palette8, bench_palette16, bench_palette32, effect->combine);
+		break;
+	}
+
+	snprintf(prefix, prefix_size, "%s,%d,%d,%s,%s,%s,%s,%s,%u,%u,%u,%u",
+		video_blit_level_name(level), bench_fuse, bench_rotate, source->name, target->name,
+		orientation->name, scale->name, effect->name, src_dx, src_dy, dst_dx, dst_dy);
+
+	return 0;
+}
+
+static void bench_run(unsigned level, unsigned s, unsigned t, unsigned o, unsigned m, unsigned e)
+{
+	struct video_pipeline_struct pipeline;
+	const struct video_stage_horz_struct* stage;
+	const uint8* src;
+	char prefix[256];
+	char name[256];
+
+	if (bench_pipeline(&pipeline, &src, prefix, sizeof(prefix), level, s, t, o, m, e) != 0)
+		return;
+
+	bench_pipeline_name(name, sizeof(name), &pipeline);
+
+	bench_blit(prefix, name, &pipeline, src);
+
+	for (stage = video_pipeline_begin(&pipeline); stage != video_pipeline_end(&pipeline); ++stage)
+		bench_stage(prefix, name, &pipeline, stage, src);
+
+	video_pipeline_done(&pipeline);
+}
+
+static adv_error bench_level(unsigned level)
+{
+	unsigned s, t, o, m, e;
+
+	video_blit_level_set(level);
+
+	if (video_blit_init() != 0) {
+		target_err("Error initializing the blit.\n");
+		return -1;
+	}
+
+	/* the level isn't supported by the processor */
+	if (video_blit_level_get() != level) {
+		video_blit_done();
+		return 0;
+	}
+
+	log_std(("bench: level %s\n", video_blit_level_name(level)));
+
+	for (s = 0; s < BENCH_COUNT(SOURCE); ++s) {
+		if ((bench_source_mask & (1U << s)) == 0)
+			continue;
+		for (t = 0; t < BENCH_COUNT(TARGET); ++t) {
+			if ((bench_target_mask & (1U << t)) == 0)
+				continue;
+			for (o = 0; o < BENCH_COUNT(ORIENTATION); ++o) {
+				if ((bench_orientation_mask & (1U << o)) == 0)
+					continue;
+				for (m = 0; m < BENCH_COUNT(SCALE); ++m) {
+					if ((bench_scale_mask & (1U << m)) == 0)
+						continue;
+					for (e = 0; e < BENCH_COUNT(EFFECT); ++e) {
+						if ((bench_effect_mask & (1U << e)) == 0)
+							continue;
+						bench_run(level, s, t, o, m, e);
+					}
+				}
+			}
+		}
+	}
+
+	video_blit_done();
+
+	return 0;
+}
+
+/***************************************************************************/
+/* check */
+
+/*
+ * Sizes of the source in check mode. The odd widths and heights, also
+ * after a rotation, exercise the tails of the SIMD loops. The minimum
+ * is the same of the -size option.
+ */
+static unsigned CHECK_SIZE[][2] = {
+	{ 9, 9 },
+	{ 17, 11 },
+	{ 33, 9 },
+	{ 67, 13 },
+	{ 131, 9 },
+	{ 11, 67 }
+};
+
+#define CHECK_SIZE_MAX 131 /**< Max value in CHECK_SIZE. */
+#define CHECK_GUARD 64 /**< Bytes checked after the end of every row, to detect overruns. */
+
+static uint8* bench_check_reference;
+static unsigned bench_check_count;
+static unsigned bench_check_error;
+
+/**
+ * Compare the blit of a combination done at every level with the one
+ * done with the C implementation.
+ */
+static adv_error bench_check_run(const char* data, unsigned s, unsigned t, unsigned o, unsigned m, unsigned e)
+{
+	unsigned level;
+
+	for (level = 0; level < VIDEO_BLIT_LEVEL_MAX; ++level) {
+		struct video_pipeline_struct pipeline;
+		const struct video_stage_vert_struct* stage_vert;
+		const uint8* src;
+		char prefix[256];
+		char name[256];
+		unsigned row_size;
+		unsigned y;
+
+		/* the C level is always used as reference */
+		if (level != VIDEO_BLIT_LEVEL_C && (bench_level_mask & (1U << level)) == 0)
+			continue;
+
+		video_blit_level_set(level);
+
+		if (video_blit_init() != 0) {
+			target_err("Error initializing the blit.\n");
+			return -1;
+		}
+
+		/* the level isn't supported by the processor */
+		if (video_blit_level_get() != level) {
+			video_blit_done();
+			continue;
+		}
+
+		if (bench_pipeline(&pipeline, &src, prefix, sizeof(prefix), level, s, t, o, m, e) != 0) {
+			video_blit_done();
+			return 0;
+		}
+
+		stage_vert = video_pipeline_vert(&pipeline);
+		row_size = stage_vert->ddx * pipeline.target.bytes_per_pixel + CHECK_GUARD;
+
+		/* the same background for all the levels, the pixels not written must match */
+		for (y = 0; y < stage_vert->ddy; ++y)
+			memset(bench_screen + y * BENCH_SIZE_MAX * 4, 0x5A, row_size);
+
+		video_pipeline_blit(&pipeline, 0, 0, src);
+		++bench_check_count;
+
+		for (y = 0; y < stage_vert->ddy; ++y) {
+			const uint8* row = bench_screen + y * BENCH_SIZE_MAX * 4;
+			uint8* ref = bench_check_reference + y * row_size;
+
+			if (level == VIDEO_BLIT_LEVEL_C) {
+				memcpy(ref, row, row_size);
+			} else if (memcmp(ref, row, row_size) != 0) {
+				unsigned x = 0;
+				while (ref[x] == row[x])
+					++x;
+				bench_pipeline_name(name, sizeof(name), &pipeline);
+				printf("%s,\"%s\",%s,%u,%u\n", prefix, name, data, x / pipeline.target.bytes_per_pixel, y);
+				fflush(stdout);
+				++bench_check_error;
+				break;
+			}
+		}
+
+		video_pipeline_done(&pipeline);
+		video_blit_done();
+	}
+
+	return 0;
+}
+
+/**
+ * Check all the selected combinations, for every size in CHECK_SIZE and
+ * with and without the fuse and rotate optimizations.
+ */
+static adv_error bench_check(void)
+{
+	unsigned data, size, fuse, rotate;
+	unsigned s, t, o, m, e;
+
+	printf("level,fuse,rotate,source,target,orientation,scale,effect,src_dx,src_dy,dst_dx,dst_dy,pipeline,data,x,y\n");
+
+	for (data = 0; data < 2; ++data) {
+		/* with a few values for the effects that check the equality of the pixels, and with all the values */
+		unsigned mask = data == 0 ? 0xC3 : 0xFF;
+		const char* data_name = data == 0 ? "few" : "all";
+
+		bench_fill(bench_bitmap, bench_bitmap_size, mask);
+		bench_fill(bench_palette8, sizeof(bench_palette8), mask);
+		bench_fill(bench_palette16, sizeof(bench_palette16), mask);
+		bench_fill(bench_palette32, sizeof(bench_palette32), mask);
+
+		for (fuse = 0; fuse < 2; ++fuse) {
+			for (rotate = 0; rotate < 2; ++rotate) {
+				bench_fuse = fuse;
+				bench_rotate = rotate;
+				video_blit_fuse_set(fuse);
+				video_blit_rotate_set(rotate);
+				for (size = 0; size < BENCH_COUNT(CHECK_SIZE); ++size) {
+					bench_source_size_x = CHECK_SIZE[size][0];
+					bench_source_size_y = CHECK_SIZE[size][1];
+					for (s = 0; s < BENCH_COUNT(SOURCE); ++s) {
+						if ((bench_source_mask & (1U << s)) == 0)
+							continue;
+						for (t = 0; t < BENCH_COUNT(TARGET); ++t) {
+							if ((bench_target_mask & (1U << t)) == 0)
+								continue;
+							for (o = 0; o < BENCH_COUNT(ORIENTATION); ++o) {
+								if ((bench_orientation_mask & (1U << o)) == 0)
+									continue;
+								for (m = 0; m < BENCH_COUNT(SCALE); ++m) {
+									if ((bench_scale_mask & (1U << m)) == 0)
+										continue;
+									for (e = 0; e < BENCH_COUNT(EFFECT); ++e) {
+										if ((bench_effect_mask & (1U << e)) == 0)
+											continue;
+										if (bench_check_run(data_name, s, t, o, m, e) != 0)
+											return -1;
+									}
+								}
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+
+	log_std(("bench: checked %u blits, %u differences\n", bench_check_count, bench_check_error));
+
+	if (bench_check_error != 0) {
+		target_err("%u blits of %u are different than the C implementation.\n", bench_check_error, bench_check_count);
+		return -1;
+	}
+
+	target_err("%u blits are equal to the C implementation.\n", bench_check_count);
+
+	return 0;
+}
+
+/***************************************************************************/
+/* main */
+
+static void error_callback(void* context, enum conf_callback_error error, const char* file, const char* tag, const char* valid, const char* desc, ...)
+{
+	va_list arg;
+	va_start(arg, desc);
+	target_err_va(desc, arg);
+	target_err("\n");
+	if (valid)
+		target_err("%s\n", valid);
+	va_end(arg);
+}
+
+void os_signal(int signum, void* info, void* context)
+{
+	os_default_signal(signum, info, context);
+}
+
+int os_main(int argc, char* argv[])
+{
+	int i;
+	unsigned level;
+	adv_conf* context;
+	adv_bool opt_log;
+	adv_bool opt_logsync;
+	adv_bool opt_check;
+	adv_bool first_source, first_target, first_orientation, first_scale, first_effect, first_level;
+	double opt_time;
+	void* bitmap_raw;
+	void* screen_raw;
+	void* row_raw[2];
+	void* reference_raw;
+
+	opt_log = 0;
+	opt_logsync = 0;
+	opt_check = 0;
+	opt_time = 0.02;
+	first_source = 0;
+	first_target = 0;
+	first_orientation = 0;
+	first_scale = 0;
+	first_effect = 0;
+	first_level = 0;
+
+	context = conf_init();
+
+	if (os_init(context) != 0)
+		goto err_conf;
+
+	if (conf_input_args_load(context, 0, "", &argc, argv, error_callback, 0) != 0)
+		goto err_os;
+
+	for (i = 1; i < argc; ++i) {
+		if (target_option_compare(argv[i], "log")) {
+			opt_log = 1;
+		} else if (target_option_compare(argv[i], "logsync")) {
+			opt_logsync = 1;
+		} else if (target_option_compare(argv[i], "check")) {
+			opt_check = 1;
+		} else if (target_option_compare(argv[i], "nofuse")) {
+			bench_fuse = 0;
+		} else if (target_option_compare(argv[i], "norotate")) {
+			bench_rotate = 0;
+		} else if (target_option_compare(argv[i], "time") && i + 1 < argc) {
+			opt_time = atof(argv[++i]);
+			if (opt_time <= 0) {
+				target_err("Invalid value '%s' for option '-time'.\n", argv[i]);
+				goto err_os;
+			}
+		} else if (target_option_compare(argv[i], "size") && i + 1 < argc) {
+			if (sscanf(argv[++i], "%ux%u", &bench_source_size_x, &bench_source_size_y) != 2
+				|| bench_source_size_x < 8 || bench_source_size_y < 8
+				|| bench_source_size_x > BENCH_SIZE_MAX / 4 || bench_source_size_y > BENCH_SIZE_MAX / 4
+			) {
+				target_err("Invalid value '%s' for option '-size'.\n", argv[i]);
+				goto err_os;
+			}
+		} else if (target_option_compare(argv[i], "level") && i + 1 < argc) {
+			++i;
+			if (!first_level) {
+				first_level = 1;
+				bench_level_mask = 0;
+			}
+			if (strcasecmp(argv[i], "all") == 0) {
+				bench_level_mask = ~0U;
+			} else {
+				for (level = 0; level < VIDEO_BLIT_LEVEL_MAX; ++level)
+					if (strcasecmp(argv[i], video_blit_level_name(level)) == 0)
+						break;
+				if (level == VIDEO_BLIT_LEVEL_MAX) {
+					target_err("Invalid value '%s' for option '-level'.\n", argv[i]);
+					goto err_os;
+				}
+				bench_level_mask |= 1U << level;
+			}
+		} else if (target_option_compare(argv[i], "source") && i + 1 < argc) {
+			if (bench_select(&bench_source_mask, &first_source, "source", argv[++i], SOURCE, BENCH_COUNT(SOURCE), sizeof(SOURCE[0])) != 0)
+				goto err_os;
+		} else if (target_option_compare(argv[i], "target") && i + 1 < argc) {
+			if (bench_select(&bench_target_mask, &first_target, "target", argv[++i], TARGET, BENCH_COUNT(TARGET), sizeof(TARGET[0])) != 0)
+				goto err_os;
+		} else if (target_option_compare(argv[i], "orientation") && i + 1 < argc) {
+			if (bench_select(&bench_orientation_mask, &first_orientation, "orientation", argv[++i], ORIENTATION, BENCH_COUNT(ORIENTATION), sizeof(ORIENTATION[0])) != 0)
+				goto err_os;
+		} else if (target_option_compare(argv[i], "scale") && i + 1 < argc) {
+			if (bench_select(&bench_scale_mask, &first_scale, "scale", argv[++i], SCALE, BENCH_COUNT(SCALE), sizeof(SCALE[0])) != 0)
+				goto err_os;
+		} else if (target_option_compare(argv[i], "effect") && i + 1 < argc) {
+			if (bench_select(&bench_effect_mask, &first_effect, "effect", argv[++i], EFFECT, BENCH_COUNT(EFFECT), sizeof(EFFECT[0])) != 0)
+				goto err_os;
+		} else {
+			target_err("Unknown command line option '%s'.\n", argv[i]);
+			target_err("Syntax: advblitbench [-level LEVEL] [-source FORMAT] [-target FORMAT]\n");
+			target_err("\t[-orientation ORIENTATION] [-scale SCALE] [-effect EFFECT]\n");
+			target_err("\t[-size XxY] [-time SECONDS] [-nofuse] [-norotate] [-check] [-log]\n");
+			goto err_os;
+		}
+	}
+
+	if (opt_log || opt_logsync) {
+		const char* log = "advblitbench.log";
+		remove(log);
+		log_init(log, opt_logsync);
+	}
+
+	log_std(("bench: %s %s %s %s\n", "AdvanceBLITBENCH", ADV_VERSION, __DATE__, __TIME__));
+
+	if (os_inner_init("AdvanceBLITBENCH") != 0)
+		goto err_os;
+
+	bench_clock_limit = opt_time * TARGET_CLOCKS_PER_SEC;
+
+	video_blit_fuse_set(bench_fuse);
+	video_blit_rotate_set(bench_rotate);
+
+	/* the check uses its sizes, up to CHECK_SIZE_MAX in both directions */
+	if (opt_check) {
+		bench_source_size_x = CHECK_SIZE_MAX;
+		bench_source_size_y = CHECK_SIZE_MAX;
+	}
+
+	/* the bitmap has some unused pixels at the end of every row, like the game bitmap */
+	bench_bitmap_dw = ALIGN_UNSIGNED((bench_source_size_x + 16) * 4, 64);
+	bench_bitmap_size = bench_bitmap_dw * bench_source_size_y;
+	bench_bitmap = bench_alloc(&bitmap_raw, bench_bitmap_size);
+	bench_screen = bench_alloc(&screen_raw, BENCH_SIZE_MAX * 4 * BENCH_SIZE_MAX);
+	bench_row[0] = bench_alloc(&row_raw[0], BENCH_SIZE_MAX * 4);
+	bench_row[1] = bench_alloc(&row_raw[1], BENCH_SIZE_MAX * 4);
+	bench_check_reference = bench_alloc(&reference_raw, (CHECK_SIZE_MAX * 4 * 4 + CHECK_GUARD) * CHECK_SIZE_MAX * 4);
+	if (!bench_bitmap || !bench_screen || !bench_row[0] || !bench_row[1] || !bench_check_reference) {
+		target_err("Low memory.\n");
+		goto err_inner;
+	}
+
+	bench_fill(bench_bitmap, bench_bitmap_size, 0xC3);
+	bench_fill(bench_row[0], BENCH_SIZE_MAX * 4, 0xC3);
+	bench_fill(bench_palette8, sizeof(bench_palette8), 0xC3);
+	bench_fill(bench_palette16, sizeof(bench_palette16), 0xC3);
+	bench_fill(bench_palette32, sizeof(bench_palette32), 0xC3);
+
+	if (opt_check) {
+		if (bench_check() != 0)
+			goto err_inner;
+	} else {
+		bench_header();
+
+		for (level = 0; level < VIDEO_BLIT_LEVEL_MAX; ++level) {
+			if ((bench_level_mask & (1U << level)) == 0)
+				continue;
+			if (bench_level(level) != 0)
+				goto err_inner;
+		}
+	}
+
+	free(bitmap_raw);
+	free(screen_raw);
+	free(row_raw[0]);
+	free(row_raw[1]);
+	free(reference_raw);
+
+	os_inner_done();
+
+	log_std(("bench: the end\n"));
+
+	if (opt_log || opt_logsync) {
+		log_done();
+	}
+
+	os_done();
+	conf_done(context);
+
+	return EXIT_SUCCESS;
+
+err_inner:
+	free(bitmap_raw);
+	free(screen_raw);
+	free(row_raw[0]);
+	free(row_raw[1]);
+	free(reference_raw);
+	os_inner_done();
+	log_done();
+err_os:
+	os_done();
+err_conf:
+	conf_done(context);
+	return EXIT_FAILURE;
+}
+
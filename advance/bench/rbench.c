@@ -0,0 +1,377 @@
+/*
+ * This file is part of the Advance project.
+ *
+ * Copyright (C) 2001, 2002, 2003 Andrea Mazzoleni
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "portable.h"
+
+#include "advance.h"
+
+#include "resample.h"
+
+#if defined(USE_ASM_INTRINSIC)
+#include <x86intrin.h>
+#endif
+
+/***************************************************************************/
+/* tables */
+
+/* Rate of the mixer, the target of all the conversions */
+#define BENCH_TARGET_RATE 44100
+
+/* Samples generated at every call, like a frame at 60 Hz */
+#define BENCH_BLOCK 735
+
+/* Rate of the source, like the one of the emulated chips */
+struct bench_rate {
+	const char* name;
+	unsigned rate;
+};
+
+static struct bench_rate RATE[] = {
+	{ "11025", 11025 },
+	{ "22050", 22050 },
+	{ "32000", 32000 },
+	{ "48000", 48000 },
+	{ "96000", 96000 },
+	{ "223721", 223721 }, /* AY8910 at 1.79 MHz */
+	{ "1789772", 1789772 } /* chips running at the clock rate */
+};
+
+/* Quality of the conversion, with the names of the advmame options */
+struct bench_quality {
+	const char* name;
+	unsigned taps;
+};
+
+static struct bench_quality QUALITY[] = {
+	{ "linear", 0 },
+	{ "fast", 8 },
+	{ "medium", 16 },
+	{ "best", 32 }
+};
+
+#define BENCH_COUNT(table) (sizeof(table) / sizeof(table[0]))
+
+/***************************************************************************/
+/* state */
+
+/* Size of the source buffer, enough for a block at the highest rate */
+#define BENCH_SOURCE_MAX (128 * 1024)
+
+static target_clock_t bench_clock_limit;
+
+static unsigned bench_rate_mask = ~0U;
+static unsigned bench_quality_mask = ~0U;
+static unsigned bench_level_mask = ~0U;
+
+static int bench_source[BENCH_SOURCE_MAX];
+static int bench_dest[BENCH_BLOCK];
+
+/**
+ * Fill the source with a sweep and some noise, like the output of a chip.
+ */
+static void bench_fill(int* ptr, unsigned size)
+{
+	unsigned seed = 1;
+	unsigned i;
+
+	for (i = 0; i < size; ++i) {
+		seed = seed * 1103515245 + 12345;
+		ptr[i] = (int)(8192 * sin(i * i * 1E-6)) + (int)((seed >> 16) & 0x3FF) - 0x200;
+	}
+}
+
+/**
+ * Get the index of a name in a table.
+ * \return The index, or -1 if not found.
+ */
+static int bench_find(const char* name, const void* table, unsigned count, unsigned size)
+{
+	unsigned i;
+
+	for (i = 0; i < count; ++i) {
+		const char* entry = *(const char* const*)((const uint8*)table + i * size);
+		if (strcasecmp(entry, name) == 0)
+			return i;
+	}
+
+	return -1;
+}
+
+/**
+ * Select an entry of a table from a command line option.
+ * The first selection clears the default of all the entries.
+ */
+static adv_error bench_select(unsigned* mask, adv_bool* first, const char* option, const char* name, const void* table, unsigned count, unsigned size)
+{
+	int i;
+
+	if (!*first) {
+		*first = 1;
+		*mask = 0;
+	}
+
+	if (strcasecmp(name, "all") == 0) {
+		*mask = ~0U;
+		return 0;
+	}
+
+	i = bench_find(name, table, count, size);
+	if (i < 0) {
+		target_err("Invalid value '%s' for option '-%s'.\n", name, option);
+		return -1;
+	}
+
+	*mask |= 1U << i;
+
+	return 0;
+}
+
+/***************************************************************************/
+/* bench */
+
+static unsigned long long bench_cycles(void)
+{
+#if defined(USE_ASM_INTRINSIC)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+static void bench_header(void)
+{
+	printf("level,quality,source_rate,target_rate,taps,width,samples,ns_per_sample,cycles_per_sample\n");
+}
+
+static void bench_run(unsigned level, unsigned r, unsigned q)
+{
+	const struct bench_rate* rate = &RATE[r];
+	const struct bench_quality* quality = &QUALITY[q];
+	unsigned step = ((unsigned long long)rate->rate << RESAMPLE_FRAC_BITS) / BENCH_TARGET_RATE;
+	unsigned begin, end;
+	unsigned width;
+	resample* filter;
+	target_clock_t start, stop;
+	unsigned long long cycles;
+	unsigned long long samples;
+	unsigned pos;
+
+	if (quality->taps != 0) {
+		filter = resample_alloc(step, quality->taps);
+		if (!filter) {
+			target_err("Low memory.\n");
+			return;
+		}
+		/* the level isn't supported by the processor */
+		if (filter->level != level) {
+			resample_free(filter);
+			return;
+		}
+		width = filter->width;
+	} else {
+		/* the linear interpolation has only the C implementation */
+		if (level != RESAMPLE_LEVEL_C)
+			return;
+		filter = 0;
+		width = 2;
+	}
+
+	/* range of positions with the full history and with a complete block after them */
+	begin = width << RESAMPLE_FRAC_BITS;
+	end = (BENCH_SOURCE_MAX - 2) << RESAMPLE_FRAC_BITS;
+	end -= BENCH_BLOCK * step;
+
+	samples = 0;
+	pos = begin;
+	cycles = bench_cycles();
+	start = target_clock();
+	do {
+		unsigned i;
+
+		/* more blocks for every clock read */
+		for (i = 0; i < 16; ++i) {
+			if (filter)
+				pos = resample_poly(filter, bench_dest, bench_source, pos, 0x100, BENCH_BLOCK);
+			else
+				pos = resample_linear(bench_dest, bench_source, pos, step, 0x100, BENCH_BLOCK);
+			if (pos >= end)
+				pos = begin;
+		}
+
+		samples += 16 * BENCH_BLOCK;
+		stop = target_clock();
+	} while (stop - start < bench_clock_limit);
+	cycles = bench_cycles() - cycles;
+
+	printf("%s,%s,%u,%u,%u,%u,%llu,%.3f,%.1f\n", resample_level_name(level), quality->name, rate->rate, BENCH_TARGET_RATE, quality->taps, width, samples, (stop - start) * 1E9 / TARGET_CLOCKS_PER_SEC / samples, cycles / (double)samples);
+	fflush(stdout);
+
+	if (filter)
+		resample_free(filter);
+}
+
+static void bench_level(unsigned level)
+{
+	unsigned r, q;
+
+	resample_level_set(level);
+
+	log_std(("bench: level %s\n", resample_level_name(level)));
+
+	for (q = 0; q < BENCH_COUNT(QUALITY); ++q) {
+		if ((bench_quality_mask & (1U << q)) == 0)
+			continue;
+		for (r = 0; r < BENCH_COUNT(RATE); ++r) {
+			if ((bench_rate_mask & (1U << r)) == 0)
+				continue;
+			bench_run(level, r, q);
+		}
+	}
+}
+
+/***************************************************************************/
+/* main */
+
+static void error_callback(void* context, enum conf_callback_error error, const char* file, const char* tag, const char* valid, const char* desc, ...)
+{
+	va_list arg;
+	va_start(arg, desc);
+	target_err_va(desc, arg);
+	target_err("\n");
+	if (valid)
+		target_err("%s\n", valid);
+	va_end(arg);
+}
+
+void os_signal(int signum, void* info, void* context)
+{
+	os_default_signal(signum, info, context);
+}
+
+int os_main(int argc, char* argv[])
+{
+	int i;
+	unsigned level;
+	adv_conf* context;
+	adv_bool opt_log;
+	adv_bool opt_logsync;
+	adv_bool first_rate, first_quality, first_level;
+	double opt_time;
+
+	opt_log = 0;
+	opt_logsync = 0;
+	opt_time = 0.1;
+	first_rate = 0;
+	first_quality = 0;
+	first_level = 0;
+
+	context = conf_init();
+
+	if (os_init(context) != 0)
+		goto err_conf;
+
+	if (conf_input_args_load(context, 0, "", &argc, argv, error_callback, 0) != 0)
+		goto err_os;
+
+	for (i = 1; i < argc; ++i) {
+		if (target_option_compare(argv[i], "log")) {
+			opt_log = 1;
+		} else if (target_option_compare(argv[i], "logsync")) {
+			opt_logsync = 1;
+		} else if (target_option_compare(argv[i], "time") && i + 1 < argc) {
+			opt_time = atof(argv[++i]);
+			if (opt_time <= 0) {
+				target_err("Invalid value '%s' for option '-time'.\n", argv[i]);
+				goto err_os;
+			}
+		} else if (target_option_compare(argv[i], "level") && i + 1 < argc) {
+			++i;
+			if (!first_level) {
+				first_level = 1;
+				bench_level_mask = 0;
+			}
+			if (strcasecmp(argv[i], "all") == 0) {
+				bench_level_mask = ~0U;
+			} else {
+				for (level = 0; level < RESAMPLE_LEVEL_MAX; ++level)
+					if (strcasecmp(argv[i], resample_level_name(level)) == 0)
+						break;
+				if (level == RESAMPLE_LEVEL_MAX) {
+					target_err("Invalid value '%s' for option '-level'.\n", argv[i]);
+					goto err_os;
+				}
+				bench_level_mask |= 1U << level;
+			}
+		} else if (target_option_compare(argv[i], "rate") && i + 1 < argc) {
+			if (bench_select(&bench_rate_mask, &first_rate, "rate", argv[++i], RATE, BENCH_COUNT(RATE), sizeof(RATE[0])) != 0)
+				goto err_os;
+		} else if (target_option_compare(argv[i], "quality") && i + 1 < argc) {
+			if (bench_select(&bench_quality_mask, &first_quality, "quality", argv[++i], QUALITY, BENCH_COUNT(QUALITY), sizeof(QUALITY[0])) != 0)
+				goto err_os;
+		} else {
+			target_err("Unknown command line option '%s'.\n", argv[i]);
+			target_err("Syntax: advresamplebench [-level LEVEL] [-rate RATE] [-quality QUALITY]\n");
+			target_err("\t[-time SECONDS] [-log]\n");
+			goto err_os;
+		}
+	}
+
+	if (opt_log || opt_logsync) {
+		const char* log = "advresamplebench.log";
+		remove(log);
+		log_init(log, opt_logsync);
+	}
+
+	log_std(("bench: %s %s %s %s\n", "AdvanceRESAMPLEBENCH", ADV_VERSION, __DATE__, __TIME__));
+
+	if (os_inner_init("AdvanceRESAMPLEBENCH") != 0)
+		goto err_os;
+
+	bench_clock_limit = opt_time * TARGET_CLOCKS_PER_SEC;
+
+	bench_fill(bench_source, BENCH_SOURCE_MAX);
+
+	bench_header();
+
+	for (level = 0; level < RESAMPLE_LEVEL_MAX; ++level) {
+		if ((bench_level_mask & (1U << level)) == 0)
+			continue;
+		bench_level(level);
+	}
+
+	os_inner_done();
+
+	log_std(("bench: the end\n"));
+
+	if (opt_log || opt_logsync) {
+		log_done();
+	}
+
+	os_done();
+	conf_done(context);
+
+	return EXIT_SUCCESS;
+
+err_os:
+	os_done();
+err_conf:
+	conf_done(context);
+	return EXIT_FAILURE;
+}
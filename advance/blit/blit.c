@@ -36,7 +36,7 @@
 #include "endianrw.h"
 
 /***************************************************************************/
-/* mmx */
+/* cpu */
 
 #if defined(USE_ASM_INLINE)
 
@@ -51,68 +51,285 @@ static void blit_cpuid(unsigned level, unsigned* regs)
 		"movl %%edx, 12(%1)\n"
 		"popal\n"
 		:
-		: "a" (level), "D" (regs)
+		: "a" (level), "D" (regs), "c" (0)
 		: "cc", "memory"
 	);
 }
 
-static void blit_has_capability(adv_bool* has_asm)
-{
-	unsigned regs[4];
-	unsigned a, b;
+/* The assembler blitters use only MMX/SSE2. */
+#define BLIT_LEVEL_BUILD VIDEO_BLIT_LEVEL_SSE2
 
-	*has_asm = 0;
+#elif defined(USE_ASM_INTRINSIC)
 
-	blit_cpuid(0, regs);
-	if (regs[0] > 0) {
-		blit_cpuid(1, regs);
-		if ((regs[3] & 0x800000) != 0) {
-			if ((regs[3] & 0x4000000) != 0) {
-				*has_asm = 1; /* MMX/SSE2 */
-			}
-		}
-	}
+#include <cpuid.h>
+
+static void blit_cpuid(unsigned level, unsigned* regs)
+{
+	__cpuid_count(level, 0, regs[0], regs[1], regs[2], regs[3]);
 }
 
-adv_bool the_blit_asm = 0;
+#define BLIT_LEVEL_BUILD VIDEO_BLIT_LEVEL_AVX2
+
+#else
+
+/* Assume that MMX/SSE2 is NOT present. */
+
+#define BLIT_LEVEL_BUILD VIDEO_BLIT_LEVEL_C
 
-#define BLITTER(name) (the_blit_asm ? name ## _asm : name ## _def)
+#endif
+
+#if defined(USE_ASM_INLINE) || defined(USE_ASM_INTRINSIC)
 
-static adv_error blit_cpu(void)
+static unsigned blit_xgetbv(void)
 {
-	blit_has_capability(&the_blit_asm);
+	unsigned lo, hi;
 
-	return 0;
+	__asm__ __volatile__ (
+		"xgetbv"
+		: "=a" (lo), "=d" (hi)
+		: "c" (0)
+	);
+
+	return lo;
 }
 
-static inline void internal_end(void)
+/**
+ * Detect the instruction set level of the processor.
+ */
+static unsigned blit_cpu_level(void)
 {
-	if (the_blit_asm) {
-		__asm__ __volatile__ (
-			"emms"
-		);
-	}
-}
+	unsigned regs[4];
+	unsigned max;
 
-#else
+	blit_cpuid(0, regs);
+	max = regs[0];
+	if (max < 1)
+		return VIDEO_BLIT_LEVEL_C;
 
-/* Assume that MMX/SSE2 is NOT present. */
+	blit_cpuid(1, regs);
+
+	/* MMX and SSE2 */
+	if ((regs[3] & 0x800000) == 0 || (regs[3] & 0x4000000) == 0)
+		return VIDEO_BLIT_LEVEL_C;
+
+	/* SSSE3 */
+	if ((regs[2] & 0x200) == 0)
+		return VIDEO_BLIT_LEVEL_SSE2;
 
-#define the_blit_asm 0
+	/* SSE4.1 */
+	if ((regs[2] & 0x80000) == 0)
+		return VIDEO_BLIT_LEVEL_SSSE3;
 
-#define BLITTER(name) (name ## _def)
+	/* OSXSAVE and AVX */
+	if ((regs[2] & 0x18000000) != 0x18000000)
+		return VIDEO_BLIT_LEVEL_SSE41;
 
-static adv_error blit_cpu(void)
+	/* the OS must save the XMM and YMM registers */
+	if ((blit_xgetbv() & 0x6) != 0x6)
+		return VIDEO_BLIT_LEVEL_SSE41;
+
+	if (max < 7)
+		return VIDEO_BLIT_LEVEL_SSE41;
+
+	blit_cpuid(7, regs);
+
+	/* AVX2 */
+	if ((regs[1] & 0x20) == 0)
+		return VIDEO_BLIT_LEVEL_SSE41;
+
+	return VIDEO_BLIT_LEVEL_AVX2;
+}
+
+#else
+
+static unsigned blit_cpu_level(void)
 {
-	return 0;
+	return VIDEO_BLIT_LEVEL_C;
 }
 
+#endif
+
+/* Level forced by the user */
+static int the_blit_level_force = VIDEO_BLIT_LEVEL_AUTO;
+
+/* Level in use */
+static unsigned the_blit_level = VIDEO_BLIT_LEVEL_C;
+
 static inline void internal_end(void)
 {
+#if defined(USE_ASM_INLINE)
+	if (the_blit_level >= VIDEO_BLIT_LEVEL_SSE2) {
+		__asm__ __volatile__ (
+			"emms"
+		);
+	}
+#endif
 }
 
+/***************************************************************************/
+/* dispatch */
+
+/*
+ * List of all the blit functions with more than one version.
+ * For every one a <name>_def function must exist, and also a <name>_asm
+ * with USE_ASM_INLINE, or <name>_sse2 and <name>_avx2 with USE_ASM_INTRINSIC.
+ */
+#define BLIT_KERNEL_LIST \
+	BLIT_KERNEL(internal_copy16_step) \
+	BLIT_KERNEL(internal_copy32_step) \
+	BLIT_KERNEL(internal_copy8) \
+	BLIT_KERNEL(internal_copy8_step) \
+	BLIT_KERNEL(internal_mean16_vert_self) \
+	BLIT_KERNEL(internal_mean32_vert_self) \
+	BLIT_KERNEL(internal_mean8_vert_self) \
+	BLIT_KERNEL(internal_transpose16) \
+	BLIT_KERNEL(internal_transpose32) \
+	BLIT_KERNEL(internal_transpose8) \
+	BLIT_KERNEL(video_line_bgra5551tobgr332_step2) \
+	BLIT_KERNEL(video_line_bgra5551tobgr565_step2) \
+	BLIT_KERNEL(video_line_bgra5551tobgra8888_step2) \
+	BLIT_KERNEL(video_line_bgra5551toyuy2) \
+	BLIT_KERNEL(video_line_bgra5551toyuy2_step) \
+	BLIT_KERNEL(video_line_bgra8888tobgr332_step4) \
+	BLIT_KERNEL(video_line_bgra8888tobgr565_step4) \
+	BLIT_KERNEL(video_line_bgra8888tobgra5551_step4) \
+	BLIT_KERNEL(video_line_bgra8888toyuy2) \
+	BLIT_KERNEL(video_line_bgra8888toyuy2_step) \
+	BLIT_KERNEL(video_line_filter16_step2) \
+	BLIT_KERNEL(video_line_filter32_step4) \
+	BLIT_KERNEL(video_line_filter8_step1) \
+	BLIT_KERNEL(video_line_interlacefilter16_step1) \
+	BLIT_KERNEL(video_line_interlacefilter32_step1) \
+	BLIT_KERNEL(video_line_interlacefilter8_step1) \
+	BLIT_KERNEL(video_line_palette16to16) \
+	BLIT_KERNEL(video_line_palette16to16_step2) \
+	BLIT_KERNEL(video_line_palette16to32) \
+	BLIT_KERNEL(video_line_palette16to32_step2) \
+	BLIT_KERNEL(video_line_palette16to32_stretchx_2x_step2) \
+	BLIT_KERNEL(video_line_palette16to8) \
+	BLIT_KERNEL(video_line_palette16to8_step2) \
+	BLIT_KERNEL(video_line_palette8to16_step1) \
+	BLIT_KERNEL(video_line_palette8to32_stretchx_2x_step1) \
+	BLIT_KERNEL(video_line_stretchx16_11) \
+	BLIT_KERNEL(video_line_stretchx16_11_step2) \
+	BLIT_KERNEL(video_line_stretchx16_22_step2) \
+	BLIT_KERNEL(video_line_stretchx32_11) \
+	BLIT_KERNEL(video_line_stretchx32_11_step4) \
+	BLIT_KERNEL(video_line_stretchx32_22_step4) \
+	BLIT_KERNEL(video_line_stretchx8_11) \
+	BLIT_KERNEL(video_line_stretchx8_11_step1) \
+	BLIT_KERNEL(video_line_stretchx8_11_step2) \
+	BLIT_KERNEL(video_line_stretchx8_22_step1) \
+	BLIT_KERNEL(video_line_swapeven16_step1) \
+	BLIT_KERNEL(video_line_swapeven32_step1) \
+	BLIT_KERNEL(video_line_swapeven8_step1) \
+	BLIT_KERNEL(video_line_swapodd16_step1) \
+	BLIT_KERNEL(video_line_swapodd32_step1) \
+	BLIT_KERNEL(video_line_swapodd8_step1)
+
+#ifndef USE_BLIT_TINY
+#define BLIT_KERNEL_LIST_BIG \
+	BLIT_KERNEL(scale2k_16) \
+	BLIT_KERNEL(scale2k_32) \
+	BLIT_KERNEL(scale2k_yuy2) \
+	BLIT_KERNEL(scale2x3_16) \
+	BLIT_KERNEL(scale2x3_32) \
+	BLIT_KERNEL(scale2x3_8) \
+	BLIT_KERNEL(scale2x4_16) \
+	BLIT_KERNEL(scale2x4_32) \
+	BLIT_KERNEL(scale2x4_8) \
+	BLIT_KERNEL(scale2x_16) \
+	BLIT_KERNEL(scale2x_32) \
+	BLIT_KERNEL(scale2x_8) \
+	BLIT_KERNEL(scale3k_16) \
+	BLIT_KERNEL(scale3k_32) \
+	BLIT_KERNEL(scale3k_yuy2) \
+	BLIT_KERNEL(scale3x_16) \
+	BLIT_KERNEL(scale3x_32) \
+	BLIT_KERNEL(scale3x_8) \
+	BLIT_KERNEL(scale4k_16) \
+	BLIT_KERNEL(scale4k_32) \
+	BLIT_KERNEL(scale4k_yuy2) \
+	BLIT_KERNEL(video_line_rgb_scandouble16_step2) \
+	BLIT_KERNEL(video_line_rgb_scandouble32_step4) \
+	BLIT_KERNEL(video_line_rgb_scandouble8_step1) \
+	BLIT_KERNEL(video_line_rgb_scandoublevert16_step2) \
+	BLIT_KERNEL(video_line_rgb_scandoublevert32_step4) \
+	BLIT_KERNEL(video_line_rgb_scandoublevert8_step1) \
+	BLIT_KERNEL(video_line_rgb_scantriple16_step2) \
+	BLIT_KERNEL(video_line_rgb_scantriple32_step4) \
+	BLIT_KERNEL(video_line_rgb_scantriple8_step1) \
+	BLIT_KERNEL(video_line_rgb_scantriplevert16_step2) \
+	BLIT_KERNEL(video_line_rgb_scantriplevert32_step4) \
+	BLIT_KERNEL(video_line_rgb_scantriplevert8_step1) \
+	BLIT_KERNEL(video_line_rgb_triad16pix16_step2) \
+	BLIT_KERNEL(video_line_rgb_triad16pix32_step4) \
+	BLIT_KERNEL(video_line_rgb_triad16pix8_step1) \
+	BLIT_KERNEL(video_line_rgb_triad3pix16_step2) \
+	BLIT_KERNEL(video_line_rgb_triad3pix32_step4) \
+	BLIT_KERNEL(video_line_rgb_triad3pix8_step1) \
+	BLIT_KERNEL(video_line_rgb_triad6pix16_step2) \
+	BLIT_KERNEL(video_line_rgb_triad6pix32_step4) \
+	BLIT_KERNEL(video_line_rgb_triad6pix8_step1) \
+	BLIT_KERNEL(video_line_rgb_triadstrong16pix16_step2) \
+	BLIT_KERNEL(video_line_rgb_triadstrong16pix32_step4) \
+	BLIT_KERNEL(video_line_rgb_triadstrong16pix8_step1) \
+	BLIT_KERNEL(video_line_rgb_triadstrong3pix16_step2) \
+	BLIT_KERNEL(video_line_rgb_triadstrong3pix32_step4) \
+	BLIT_KERNEL(video_line_rgb_triadstrong3pix8_step1) \
+	BLIT_KERNEL(video_line_rgb_triadstrong6pix16_step2) \
+	BLIT_KERNEL(video_line_rgb_triadstrong6pix32_step4) \
+	BLIT_KERNEL(video_line_rgb_triadstrong6pix8_step1)
+#else
+#define BLIT_KERNEL_LIST_BIG
 #endif
 
+#if !defined(USE_BLIT_TINY) && !defined(USE_BLIT_SMALL)
+#define BLIT_KERNEL_LIST_INTERP \
+	BLIT_KERNEL(hq2x3_16) \
+	BLIT_KERNEL(hq2x3_32) \
+	BLIT_KERNEL(hq2x3_yuy2) \
+	BLIT_KERNEL(hq2x4_16) \
+	BLIT_KERNEL(hq2x4_32) \
+	BLIT_KERNEL(hq2x4_yuy2) \
+	BLIT_KERNEL(hq2x_16) \
+	BLIT_KERNEL(hq2x_32) \
+	BLIT_KERNEL(hq2x_yuy2) \
+	BLIT_KERNEL(hq3x_16) \
+	BLIT_KERNEL(hq3x_32) \
+	BLIT_KERNEL(hq3x_yuy2) \
+	BLIT_KERNEL(hq4x_16) \
+	BLIT_KERNEL(hq4x_32) \
+	BLIT_KERNEL(hq4x_yuy2) \
+	BLIT_KERNEL(xbr2x_16) \
+	BLIT_KERNEL(xbr2x_32) \
+	BLIT_KERNEL(xbr2x_yuy2) \
+	BLIT_KERNEL(xbr3x_16) \
+	BLIT_KERNEL(xbr3x_32) \
+	BLIT_KERNEL(xbr3x_yuy2) \
+	BLIT_KERNEL(xbr4x_16) \
+	BLIT_KERNEL(xbr4x_32) \
+	BLIT_KERNEL(xbr4x_yuy2)
+#else
+#define BLIT_KERNEL_LIST_INTERP
+#endif
+
+#define BLIT_KERNEL(name) BLIT_KERNEL_ ## name,
+enum blit_kernel_enum {
+	BLIT_KERNEL_LIST
+	BLIT_KERNEL_LIST_BIG
+	BLIT_KERNEL_LIST_INTERP
+	BLIT_KERNEL_MAX
+};
+#undef BLIT_KERNEL
+
+typedef void blit_kernel(void);
+
+/* Version selected of every blit function, indexed by blit_kernel_enum */
+static blit_kernel* the_blit_kernel[BLIT_KERNEL_MAX];
+
+#define BLITTER(name) ((__typeof__(&name ## _def))the_blit_kernel[BLIT_KERNEL_ ## name])
+
 /***************************************************************************/
 /* internal */
 
@@ -212,6 +429,8 @@ static inline void internal_end(void)
 #include "vrgb.h"
 #endif
 
+#include "vfuse.h"
+
 /***************************************************************************/
 /* fast_buffer */
 
@@ -226,34 +445,39 @@ static inline void internal_end(void)
 /* Align */
 #define FAST_BUFFER_ALIGN 16 /* SSE2 requirement */
 
-void* fast_buffer; /* raw pointer */
-void* fast_buffer_aligned; /* aligned pointer */
-unsigned fast_buffer_map[FAST_BUFFER_MAX]; /* stack of incremental size used */
-unsigned fast_buffer_mac; /* top of the stack */
+struct video_buffer_struct {
+	void* raw; /* raw pointer */
+	void* aligned; /* aligned pointer */
+	unsigned map[FAST_BUFFER_MAX]; /* stack of incremental size used */
+	unsigned mac; /* top of the stack */
+};
 
-static void* video_buffer_alloc(unsigned size)
+/* Global buffers */
+static struct video_buffer_struct fast_buffer;
+
+static void* fast_buffer_alloc(struct video_buffer_struct* fast, unsigned size)
 {
 	unsigned size_aligned = ALIGN_UNSIGNED(size, FAST_BUFFER_ALIGN);
 
-	assert(fast_buffer_mac < FAST_BUFFER_MAX);
+	assert(fast->mac < FAST_BUFFER_MAX);
 
-	if (fast_buffer_map[fast_buffer_mac] + size_aligned > FAST_BUFFER_SIZE - FAST_BUFFER_ALIGN) {
+	if (fast->map[fast->mac] + size_aligned > FAST_BUFFER_SIZE - FAST_BUFFER_ALIGN) {
 		log_std(("ERROR:blit: out of memory\n"));
 		return 0;
 	}
 
-	++fast_buffer_mac;
-	fast_buffer_map[fast_buffer_mac] = fast_buffer_map[fast_buffer_mac - 1] + size_aligned;
+	++fast->mac;
+	fast->map[fast->mac] = fast->map[fast->mac - 1] + size_aligned;
 
-	return (uint8*)fast_buffer_aligned + fast_buffer_map[fast_buffer_mac - 1];
+	return (uint8*)fast->aligned + fast->map[fast->mac - 1];
 }
 
 /* Buffers must be allocated and freed in exact reverse order */
-static void video_buffer_free(void* buffer)
+static void fast_buffer_free(struct video_buffer_struct* fast, void* buffer)
 {
 	(void)buffer;
-	assert(fast_buffer_mac != 0);
-	--fast_buffer_mac;
+	assert(fast->mac != 0);
+	--fast->mac;
 }
 
 /* Debug version of the alloc functions */
@@ -261,41 +485,163 @@ static void video_buffer_free(void* buffer)
 
 #define WRAP_SIZE 32
 
-static void* video_buffer_alloc_wrap(unsigned size)
+static void* fast_buffer_alloc_wrap(struct video_buffer_struct* fast, unsigned size)
 {
-	uint8* buffer8 = (uint8*)video_buffer_alloc(size + WRAP_SIZE);
+	uint8* buffer8 = (uint8*)fast_buffer_alloc(fast, size + WRAP_SIZE);
 	unsigned i;
 	for (i = 0; i < WRAP_SIZE; ++i)
 		buffer8[i] = i;
 	return buffer8 + WRAP_SIZE;
 }
 
-static void video_buffer_free_wrap(void* buffer)
+static void fast_buffer_free_wrap(struct video_buffer_struct* fast, void* buffer)
 {
 	uint8* buffer8 = (uint8*)buffer - WRAP_SIZE;
 	unsigned i;
 	for (i = 0; i < WRAP_SIZE; ++i)
 		assert(buffer8[i] == i);
-	video_buffer_free(buffer8);
+	fast_buffer_free(fast, buffer8);
 }
 
-#define video_buffer_free video_buffer_free_wrap
-#define video_buffer_alloc video_buffer_alloc_wrap
+#define fast_buffer_free fast_buffer_free_wrap
+#define fast_buffer_alloc fast_buffer_alloc_wrap
 
 #endif
 
+static adv_error fast_buffer_init(struct video_buffer_struct* fast)
+{
+	fast->raw = malloc(FAST_BUFFER_SIZE + FAST_BUFFER_ALIGN);
+	if (!fast->raw)
+		return -1;
+	fast->aligned = ALIGN_PTR(fast->raw, FAST_BUFFER_ALIGN);
+	fast->mac = 0;
+	fast->map[0] = 0;
+	return 0;
+}
+
+static void fast_buffer_done(struct video_buffer_struct* fast)
+{
+	assert(fast->mac == 0);
+	free(fast->raw);
+}
+
+static void* video_buffer_alloc(unsigned size)
+{
+	return fast_buffer_alloc(&fast_buffer, size);
+}
+
+static void video_buffer_free(void* buffer)
+{
+	fast_buffer_free(&fast_buffer, buffer);
+}
+
+/* Allocate in the buffers of the target, different for every band */
+static void* video_target_alloc(const struct video_pipeline_target_struct* target, unsigned size)
+{
+	return fast_buffer_alloc(target->buffer ? target->buffer : &fast_buffer, size);
+}
+
+static void video_target_free(const struct video_pipeline_target_struct* target, void* buffer)
+{
+	fast_buffer_free(target->buffer ? target->buffer : &fast_buffer, buffer);
+}
+
 static void video_buffer_init(void)
 {
-	fast_buffer = malloc(FAST_BUFFER_SIZE + FAST_BUFFER_ALIGN);
-	fast_buffer_aligned = ALIGN_PTR(fast_buffer, FAST_BUFFER_ALIGN);
-	fast_buffer_mac = 0;
-	fast_buffer_map[0] = 0;
+	fast_buffer_init(&fast_buffer);
 }
 
 static void video_buffer_done(void)
 {
-	assert(fast_buffer_mac == 0);
-	free(fast_buffer);
+	fast_buffer_done(&fast_buffer);
+}
+
+/***************************************************************************/
+/* dispatch table */
+
+struct blit_kernel_struct {
+	const char* name;
+	blit_kernel* variant[VIDEO_BLIT_LEVEL_MAX]; /**< Version for every level, 0 if missing. */
+};
+
+#if defined(USE_ASM_INLINE)
+#define BLIT_KERNEL(name) { #name, { (blit_kernel*)name ## _def, (blit_kernel*)name ## _asm, 0, 0, 0 } },
+#elif defined(USE_ASM_INTRINSIC)
+#define BLIT_KERNEL(name) { #name, { (blit_kernel*)name ## _def, (blit_kernel*)name ## _sse2, 0, 0, (blit_kernel*)name ## _avx2 } },
+#else
+#define BLIT_KERNEL(name) { #name, { (blit_kernel*)name ## _def, 0, 0, 0, 0 } },
+#endif
+static const struct blit_kernel_struct BLIT_KERNEL_TABLE[BLIT_KERNEL_MAX] = {
+	BLIT_KERNEL_LIST
+	BLIT_KERNEL_LIST_BIG
+	BLIT_KERNEL_LIST_INTERP
+};
+#undef BLIT_KERNEL
+
+void video_blit_level_set(int level)
+{
+	the_blit_level_force = level;
+}
+
+unsigned video_blit_level_get(void)
+{
+	return the_blit_level;
+}
+
+const char* video_blit_level_name(unsigned level)
+{
+	switch (level) {
+	case VIDEO_BLIT_LEVEL_C : return "c";
+	case VIDEO_BLIT_LEVEL_SSE2 : return "sse2";
+	case VIDEO_BLIT_LEVEL_SSSE3 : return "ssse3";
+	case VIDEO_BLIT_LEVEL_SSE41 : return "sse41";
+	case VIDEO_BLIT_LEVEL_AVX2 : return "avx2";
+	}
+	return "unknown";
+}
+
+static void blit_cpu(void)
+{
+	unsigned cpu;
+	unsigned i;
+
+	cpu = blit_cpu_level();
+
+	log_std(("blit: cpu level %s, build level %s\n", video_blit_level_name(cpu), video_blit_level_name(BLIT_LEVEL_BUILD)));
+
+	the_blit_level = cpu;
+	if (the_blit_level > BLIT_LEVEL_BUILD)
+		the_blit_level = BLIT_LEVEL_BUILD;
+
+	if (the_blit_level_force != VIDEO_BLIT_LEVEL_AUTO) {
+		if (the_blit_level_force >= 0 && (unsigned)the_blit_level_force <= the_blit_level) {
+			the_blit_level = the_blit_level_force;
+		} else {
+			log_std(("WARNING:blit: level %s not supported, ignored\n", video_blit_level_name(the_blit_level_force)));
+		}
+	}
+
+	log_std(("blit: using level %s\n", video_blit_level_name(the_blit_level)));
+
+	for (i = 0; i < BLIT_KERNEL_MAX; ++i) {
+		const struct blit_kernel_struct* k = &BLIT_KERNEL_TABLE[i];
+		unsigned level;
+		unsigned real;
+
+		/* the highest version available */
+		level = the_blit_level;
+		while (level > VIDEO_BLIT_LEVEL_C && k->variant[level] == 0)
+			--level;
+
+		/* a version may be only an alias of a lower one */
+		for (real = VIDEO_BLIT_LEVEL_C; real < level; ++real)
+			if (k->variant[real] == k->variant[level])
+				break;
+
+		the_blit_kernel[i] = k->variant[level];
+
+		log_std(("blit: %s %s\n", k->name, video_blit_level_name(real)));
+	}
 }
 
 /***************************************************************************/
@@ -303,10 +649,7 @@ static void video_buffer_done(void)
 
 adv_error video_blit_init(void)
 {
-	if (blit_cpu() != 0) {
-		error_set("This executable requires an SSE2 processor.\n");
-		return -1;
-	}
+	blit_cpu();
 
 	video_buffer_init();
 
@@ -450,9 +793,9 @@ static inline void scale2x4(void* dst0, void* dst1, void* dst2, void* dst3, void
 static inline void scale2k(void* dst0, void* dst1, void* src0, void* src1, void* src2, unsigned interp, unsigned count)
 {
 	switch (interp) {
-	case INTERP_16: scale2k_16_def(dst0, dst1, src0, src1, src2, count); break;
-	case INTERP_32: scale2k_32_def(dst0, dst1, src0, src1, src2, count); break;
-	case INTERP_YUY2: scale2k_yuy2_def(dst0, dst1, src0, src1, src2, count); break;
+	case INTERP_16: BLITTER(scale2k_16)(dst0, dst1, src0, src1, src2, count); break;
+	case INTERP_32: BLITTER(scale2k_32)(dst0, dst1, src0, src1, src2, count); break;
+	case INTERP_YUY2: BLITTER(scale2k_yuy2)(dst0, dst1, src0, src1, src2, count); break;
 	}
 }
 
@@ -460,36 +803,36 @@ static inline void scale2k(void* dst0, void* dst1, void* src0, void* src1, void*
 static inline void hq2x(void* dst0, void* dst1, void* src0, void* src1, void* src2, unsigned interp, unsigned count)
 {
 	switch (interp) {
-	case INTERP_16: hq2x_16_def(dst0, dst1, src0, src1, src2, count); break;
-	case INTERP_32: hq2x_32_def(dst0, dst1, src0, src1, src2, count); break;
-	case INTERP_YUY2: hq2x_yuy2_def(dst0, dst1, src0, src1, src2, count); break;
+	case INTERP_16: BLITTER(hq2x_16)(dst0, dst1, src0, src1, src2, count); break;
+	case INTERP_32: BLITTER(hq2x_32)(dst0, dst1, src0, src1, src2, count); break;
+	case INTERP_YUY2: BLITTER(hq2x_yuy2)(dst0, dst1, src0, src1, src2, count); break;
 	}
 }
 
 static inline void hq2x3(void* dst0, void* dst1, void* dst2, void* src0, void* src1, void* src2, unsigned interp, unsigned count)
 {
 	switch (interp) {
-	case INTERP_16: hq2x3_16_def(dst0, dst1, dst2, src0, src1, src2, count); break;
-	case INTERP_32: hq2x3_32_def(dst0, dst1, dst2, src0, src1, src2, count); break;
-	case INTERP_YUY2: hq2x3_yuy2_def(dst0, dst1, dst2, src0, src1, src2, count); break;
+	case INTERP_16: BLITTER(hq2x3_16)(dst0, dst1, dst2, src0, src1, src2, count); break;
+	case INTERP_32: BLITTER(hq2x3_32)(dst0, dst1, dst2, src0, src1, src2, count); break;
+	case INTERP_YUY2: BLITTER(hq2x3_yuy2)(dst0, dst1, dst2, src0, src1, src2, count); break;
 	}
 }
 
 static inline void hq2x4(void* dst0, void* dst1, void* dst2, void* dst3, void* src0, void* src1, void* src2, unsigned interp, unsigned count)
 {
 	switch (interp) {
-	case INTERP_16: hq2x4_16_def(dst0, dst1, dst2, dst3, src0, src1, src2, count); break;
-	case INTERP_32: hq2x4_32_def(dst0, dst1, dst2, dst3, src0, src1, src2, count); break;
-	case INTERP_YUY2: hq2x4_yuy2_def(dst0, dst1, dst2, dst3, src0, src1, src2, count); break;
+	case INTERP_16: BLITTER(hq2x4_16)(dst0, dst1, dst2, dst3, src0, src1, src2, count); break;
+	case INTERP_32: BLITTER(hq2x4_32)(dst0, dst1, dst2, dst3, src0, src1, src2, count); break;
+	case INTERP_YUY2: BLITTER(hq2x4_yuy2)(dst0, dst1, dst2, dst3, src0, src1, src2, count); break;
 	}
 }
 
 static inline void xbr2x(void* dst0, void* dst1, void* src0, void* src1, void* src2, void* src3, void* src4, unsigned interp, unsigned count)
 {
 	switch (interp) {
-	case INTERP_16: xbr2x_16_def(dst0, dst1, src0, src1, src2, src3, src4, count); break;
-	case INTERP_32: xbr2x_32_def(dst0, dst1, src0, src1, src2, src3, src4, count); break;
-	case INTERP_YUY2: xbr2x_yuy2_def(dst0, dst1, src0, src1, src2, src3, src4, count); break;
+	case INTERP_16: BLITTER(xbr2x_16)(dst0, dst1, src0, src1, src2, src3, src4, count); break;
+	case INTERP_32: BLITTER(xbr2x_32)(dst0, dst1, src0, src1, src2, src3, src4, count); break;
+	case INTERP_YUY2: BLITTER(xbr2x_yuy2)(dst0, dst1, src0, src1, src2, src3, src4, count); break;
 	}
 }
 #endif
@@ -497,18 +840,18 @@ static inline void xbr2x(void* dst0, void* dst1, void* src0, void* src1, void* s
 static inline void scale3x(void* dst0, void* dst1, void* dst2, void* src0, void* src1, void* src2, unsigned bytes_per_pixel, unsigned count)
 {
 	switch (bytes_per_pixel) {
-	case 1: scale3x_8_def(dst0, dst1, dst2, src0, src1, src2, count); break;
-	case 2: scale3x_16_def(dst0, dst1, dst2, src0, src1, src2, count); break;
-	case 4: scale3x_32_def(dst0, dst1, dst2, src0, src1, src2, count); break;
+	case 1: BLITTER(scale3x_8)(dst0, dst1, dst2, src0, src1, src2, count); break;
+	case 2: BLITTER(scale3x_16)(dst0, dst1, dst2, src0, src1, src2, count); break;
+	case 4: BLITTER(scale3x_32)(dst0, dst1, dst2, src0, src1, src2, count); break;
 	}
 }
 
 static inline void scale3k(void* dst0, void* dst1, void* dst2, void* src0, void* src1, void* src2, unsigned interp, unsigned count)
 {
 	switch (interp) {
-	case INTERP_16: scale3k_16_def(dst0, dst1, dst2, src0, src1, src2, count); break;
-	case INTERP_32: scale3k_32_def(dst0, dst1, dst2, src0, src1, src2, count); break;
-	case INTERP_YUY2: scale3k_yuy2_def(dst0, dst1, dst2, src0, src1, src2, count); break;
+	case INTERP_16: BLITTER(scale3k_16)(dst0, dst1, dst2, src0, src1, src2, count); break;
+	case INTERP_32: BLITTER(scale3k_32)(dst0, dst1, dst2, src0, src1, src2, count); break;
+	case INTERP_YUY2: BLITTER(scale3k_yuy2)(dst0, dst1, dst2, src0, src1, src2, count); break;
 	}
 }
 
@@ -516,18 +859,18 @@ static inline void scale3k(void* dst0, void* dst1, void* dst2, void* src0, void*
 static inline void hq3x(void* dst0, void* dst1, void* dst2, void* src0, void* src1, void* src2, unsigned interp, unsigned count)
 {
 	switch (interp) {
-	case INTERP_16: hq3x_16_def(dst0, dst1, dst2, src0, src1, src2, count); break;
-	case INTERP_32: hq3x_32_def(dst0, dst1, dst2, src0, src1, src2, count); break;
-	case INTERP_YUY2: hq3x_yuy2_def(dst0, dst1, dst2, src0, src1, src2, count); break;
+	case INTERP_16: BLITTER(hq3x_16)(dst0, dst1, dst2, src0, src1, src2, count); break;
+	case INTERP_32: BLITTER(hq3x_32)(dst0, dst1, dst2, src0, src1, src2, count); break;
+	case INTERP_YUY2: BLITTER(hq3x_yuy2)(dst0, dst1, dst2, src0, src1, src2, count); break;
 	}
 }
 
 static inline void xbr3x(void* dst0, void* dst1, void* dst2, void* src0, void* src1, void* src2, void* src3, void* src4, unsigned interp, unsigned count)
 {
 	switch (interp) {
-	case INTERP_16: xbr3x_16_def(dst0, dst1, dst2, src0, src1, src2, src3, src4, count); break;
-	case INTERP_32: xbr3x_32_def(dst0, dst1, dst2, src0, src1, src2, src3, src4, count); break;
-	case INTERP_YUY2: xbr3x_yuy2_def(dst0, dst1, dst2, src0, src1, src2, src3, src4, count); break;
+	case INTERP_16: BLITTER(xbr3x_16)(dst0, dst1, dst2, src0, src1, src2, src3, src4, count); break;
+	case INTERP_32: BLITTER(xbr3x_32)(dst0, dst1, dst2, src0, src1, src2, src3, src4, count); break;
+	case INTERP_YUY2: BLITTER(xbr3x_yuy2)(dst0, dst1, dst2, src0, src1, src2, src3, src4, count); break;
 	}
 }
 #endif
@@ -535,9 +878,9 @@ static inline void xbr3x(void* dst0, void* dst1, void* dst2, void* src0, void* s
 static inline void scale4k(void* dst0, void* dst1, void* dst2, void* dst3, void* src0, void* src1, void* src2, unsigned interp, unsigned count)
 {
 	switch (interp) {
-	case INTERP_16: scale4k_16_def(dst0, dst1, dst2, dst3, src0, src1, src2, count); break;
-	case INTERP_32: scale4k_32_def(dst0, dst1, dst2, dst3, src0, src1, src2, count); break;
-	case INTERP_YUY2: scale4k_yuy2_def(dst0, dst1, dst2, dst3, src0, src1, src2, count); break;
+	case INTERP_16: BLITTER(scale4k_16)(dst0, dst1, dst2, dst3, src0, src1, src2, count); break;
+	case INTERP_32: BLITTER(scale4k_32)(dst0, dst1, dst2, dst3, src0, src1, src2, count); break;
+	case INTERP_YUY2: BLITTER(scale4k_yuy2)(dst0, dst1, dst2, dst3, src0, src1, src2, count); break;
 	}
 }
 
@@ -545,18 +888,18 @@ static inline void scale4k(void* dst0, void* dst1, void* dst2, void* dst3, void*
 static inline void hq4x(void* dst0, void* dst1, void* dst2, void* dst3, void* src0, void* src1, void* src2, unsigned interp, unsigned count)
 {
 	switch (interp) {
-	case INTERP_16: hq4x_16_def(dst0, dst1, dst2, dst3, src0, src1, src2, count); break;
-	case INTERP_32: hq4x_32_def(dst0, dst1, dst2, dst3, src0, src1, src2, count); break;
-	case INTERP_YUY2: hq4x_yuy2_def(dst0, dst1, dst2, dst3, src0, src1, src2, count); break;
+	case INTERP_16: BLITTER(hq4x_16)(dst0, dst1, dst2, dst3, src0, src1, src2, count); break;
+	case INTERP_32: BLITTER(hq4x_32)(dst0, dst1, dst2, dst3, src0, src1, src2, count); break;
+	case INTERP_YUY2: BLITTER(hq4x_yuy2)(dst0, dst1, dst2, dst3, src0, src1, src2, count); break;
 	}
 }
 
 static inline void xbr4x(void* dst0, void* dst1, void* dst2, void* dst3, void* src0, void* src1, void* src2, void* src3, void* src4, unsigned interp, unsigned count)
 {
 	switch (interp) {
-	case INTERP_16: xbr4x_16_def(dst0, dst1, dst2, dst3, src0, src1, src2, src3, src4, count); break;
-	case INTERP_32: xbr4x_32_def(dst0, dst1, dst2, dst3, src0, src1, src2, src3, src4, count); break;
-	case INTERP_YUY2: xbr4x_yuy2_def(dst0, dst1, dst2, dst3, src0, src1, src2, src3, src4, count); break;
+	case INTERP_16: BLITTER(xbr4x_16)(dst0, dst1, dst2, dst3, src0, src1, src2, src3, src4, count); break;
+	case INTERP_32: BLITTER(xbr4x_32)(dst0, dst1, dst2, dst3, src0, src1, src2, src3, src4, count); break;
+	case INTERP_YUY2: BLITTER(xbr4x_yuy2)(dst0, dst1, dst2, dst3, src0, src1, src2, src3, src4, count); break;
 	}
 }
 #endif
@@ -674,9 +1017,23 @@ void video_pipeline_init(struct video_pipeline_struct* pipeline)
 	pipeline->stage_mac = 0;
 	pipeline->target.line = &video_line;
 	pipeline->target.ptr = 0;
-	pipeline->target.color_def = video_color_def();
-	pipeline->target.bytes_per_pixel = color_def_bytes_per_pixel_get(video_color_def());
-	pipeline->target.bytes_per_scanline = video_bytes_per_scanline();
+	pipeline->target.buffer = 0;
+
+	/* without a video mode, only a memory target can be used */
+	if (video_is_active() && video_mode_is_active()) {
+		pipeline->target.color_def = video_color_def();
+		pipeline->target.bytes_per_pixel = color_def_bytes_per_pixel_get(video_color_def());
+		pipeline->target.bytes_per_scanline = video_bytes_per_scanline();
+	} else {
+		pipeline->target.color_def = 0;
+		pipeline->target.bytes_per_pixel = 0;
+		pipeline->target.bytes_per_scanline = 0;
+	}
+
+	pipeline->band_map = 0;
+	pipeline->band_mac = 0;
+	pipeline->band_max = 0;
+	pipeline->fuse_mac = 0;
 }
 
 void video_pipeline_target(struct video_pipeline_struct* pipeline, void* ptr, unsigned bytes_per_scanline, adv_color_def def)
@@ -688,6 +1045,469 @@ void video_pipeline_target(struct video_pipeline_struct* pipeline, void* ptr, un
 	pipeline->target.bytes_per_scanline = bytes_per_scanline;
 }
 
+/***************************************************************************/
+/* band */
+
+/* Min number of source rows of a band */
+#define VIDEO_BAND_ROW_MIN 16
+
+/**
+ * Band of a pipeline.
+ * Every band has its copy of the pipeline stages with its own buffers,
+ * and it can be run in parallel with the others.
+ */
+struct video_band_struct {
+	struct video_pipeline_target_struct target; /**< Target of the band. It must be the first field. */
+	const struct video_pipeline_target_struct* target_pipeline; /**< Target of the pipeline. */
+	struct video_stage_horz_struct stage_map[VIDEO_STAGE_MAX]; /**< Horizontal stages. */
+	struct video_stage_vert_struct stage_vert; /**< Vertical stage limited to the band. */
+	struct video_buffer_struct buffer; /**< Temporary buffers. */
+	unsigned char* halo_line; /**< Row written in place of the rows outside the band. */
+	unsigned y_begin; /**< First row of the band in the target. */
+	unsigned y_end; /**< Last row (excluded) of the band in the target. */
+	unsigned char* rotate_buffer; /**< Transposed source rows, 0 if the source isn't transposed. */
+	unsigned rotate_dw; /**< Row size of the transposed source rows. */
+	unsigned rotate_row_max; /**< Max number of transposed source rows. */
+};
+
+/* Arguments of a band execution */
+struct video_band_arg_struct {
+	const struct video_pipeline_struct* pipeline;
+	unsigned x;
+	unsigned y;
+	const void* src;
+};
+
+static video_blit_parallelize_func* the_blit_parallelize = 0;
+static unsigned the_blit_band_max = 0;
+
+static adv_bool the_blit_fuse = 1;
+static adv_bool the_blit_change = 0;
+static adv_bool the_blit_rotate = 1;
+
+void video_blit_fuse_set(adv_bool enable)
+{
+	the_blit_fuse = enable;
+}
+
+void video_blit_change_set(adv_bool enable)
+{
+	the_blit_change = enable;
+}
+
+void video_blit_rotate_set(adv_bool enable)
+{
+	the_blit_rotate = enable;
+}
+
+void video_blit_band_set(video_blit_parallelize_func* parallelize, unsigned band_max)
+{
+	if (band_max > VIDEO_BAND_MAX)
+		band_max = VIDEO_BAND_MAX;
+
+	the_blit_parallelize = parallelize;
+	the_blit_band_max = band_max;
+}
+
+static unsigned char* band_line(const struct video_pipeline_target_struct* target, unsigned y)
+{
+	const struct video_band_struct* band = (const struct video_band_struct*)target;
+
+	/* the rows computed only for the halo are discarded */
+	if (y < band->y_begin || y >= band->y_end)
+		return band->halo_line;
+
+	return band->target_pipeline->line(band->target_pipeline, y);
+}
+
+static void video_band_free(struct video_pipeline_struct* pipeline, struct video_band_struct* band)
+{
+	int i;
+
+	/* deallocate with the same allocation order */
+	for (i = pipeline->stage_mac - 1; i >= 0; --i) {
+		struct video_stage_horz_struct* stage = &band->stage_map[i];
+		if (stage->buffer_extra)
+			fast_buffer_free(&band->buffer, stage->buffer_extra);
+	}
+	for (i = pipeline->stage_mac - 1; i >= 0; --i) {
+		struct video_stage_horz_struct* stage = &band->stage_map[i];
+		if (stage->buffer)
+			fast_buffer_free(&band->buffer, stage->buffer);
+	}
+
+	fast_buffer_done(&band->buffer);
+	free(band->halo_line);
+	free(band->rotate_buffer);
+}
+
+static adv_error video_band_alloc(struct video_pipeline_struct* pipeline, struct video_band_struct* band, unsigned rotate_row_max)
+{
+	const struct video_stage_vert_struct* stage_vert = video_pipeline_vert(pipeline);
+	unsigned row_size;
+	unsigned i;
+
+	band->rotate_buffer = 0;
+	band->rotate_dw = 0;
+	band->rotate_row_max = 0;
+	if (rotate_row_max != 0) {
+		const struct video_stage_horz_struct* stage = stage_vert->stage_begin;
+		band->rotate_dw = ALIGN_UNSIGNED(stage->sdx * stage->sbpp, 32);
+		band->rotate_buffer = malloc(band->rotate_dw * rotate_row_max);
+		if (!band->rotate_buffer)
+			return -1;
+		band->rotate_row_max = rotate_row_max;
+	}
+
+	if (fast_buffer_init(&band->buffer) != 0) {
+		free(band->rotate_buffer);
+		return -1;
+	}
+
+	/* the halo row may be written at any horizontal position */
+	if (stage_vert->stage_pivot != stage_vert->stage_end)
+		row_size = stage_vert->stage_end[-1].ddx * stage_vert->stage_end[-1].dbpp;
+	else
+		row_size = stage_vert->ddx * stage_vert->bpp;
+	band->halo_line = malloc(pipeline->target.bytes_per_scanline + row_size);
+	if (!band->halo_line) {
+		fast_buffer_done(&band->buffer);
+		free(band->rotate_buffer);
+		return -1;
+	}
+
+	band->target = pipeline->target;
+	band->target.line = &band_line;
+	band->target.buffer = &band->buffer;
+	band->target_pipeline = &pipeline->target;
+
+	memcpy(band->stage_map, pipeline->stage_map, sizeof(band->stage_map));
+
+	band->stage_vert = *stage_vert;
+	band->stage_vert.stage_begin = band->stage_map + (stage_vert->stage_begin - pipeline->stage_map);
+	band->stage_vert.stage_end = band->stage_map + (stage_vert->stage_end - pipeline->stage_map);
+	band->stage_vert.stage_pivot = band->stage_map + (stage_vert->stage_pivot - pipeline->stage_map);
+
+	/* allocate with the same order of the pipeline */
+	for (i = 0; i < pipeline->stage_mac; ++i) {
+		struct video_stage_horz_struct* stage = &band->stage_map[i];
+		if (stage->buffer_size)
+			stage->buffer = fast_buffer_alloc(&band->buffer, stage->buffer_size);
+	}
+	for (i = 0; i < pipeline->stage_mac; ++i) {
+		struct video_stage_horz_struct* stage = &band->stage_map[i];
+		if (stage->buffer_extra_size)
+			stage->buffer_extra = fast_buffer_alloc(&band->buffer, stage->buffer_extra_size);
+	}
+
+	return 0;
+}
+
+/* Position in the slice of the vertical stage */
+struct video_slice_pos_struct {
+	unsigned i; /**< Segment of the slice. */
+	unsigned src_row; /**< First source row of the segment. */
+	unsigned dst_row; /**< First target row of the segment. */
+	int error; /**< Error of the slice algorithm at the segment. */
+};
+
+static inline void video_slice_pos_init(const struct video_stage_vert_struct* stage_vert, struct video_slice_pos_struct* pos)
+{
+	pos->i = 0;
+	pos->src_row = 0;
+	pos->dst_row = 0;
+	pos->error = stage_vert->slice.error;
+}
+
+static inline void video_slice_pos_next(const struct video_stage_vert_struct* stage_vert, struct video_slice_pos_struct* pos)
+{
+	unsigned run;
+
+	run = stage_vert->slice.whole;
+	if ((pos->error += stage_vert->slice.up) > 0) {
+		++run;
+		pos->error -= stage_vert->slice.down;
+	}
+
+	if (stage_vert->sdy < stage_vert->ddy) {
+		/* expansion */
+		pos->src_row += 1;
+		pos->dst_row += run;
+	} else if (stage_vert->sdy > stage_vert->ddy) {
+		/* reduction */
+		pos->src_row += run;
+		pos->dst_row += 1;
+	} else {
+		pos->src_row += 1;
+		pos->dst_row += 1;
+	}
+
+	++pos->i;
+}
+
+/**
+ * Check if the source of the pipeline is read by columns.
+ * It happens for the rotated games, where every pixel of a source row is read
+ * from a different row of the bitmap. In this case the source rows are
+ * transposed in a buffer before running the stages.
+ */
+static adv_bool video_pipeline_is_rotate(const struct video_pipeline_struct* pipeline)
+{
+	const struct video_stage_vert_struct* stage_vert = video_pipeline_vert(pipeline);
+	const struct video_stage_horz_struct* stage = stage_vert->stage_begin;
+
+	if (!the_blit_rotate)
+		return 0;
+
+	/* the vertical stage must not read directly the source */
+	if (stage == stage_vert->stage_pivot)
+		return 0;
+
+	if (stage->sbpp != 1 && stage->sbpp != 2 && stage->sbpp != 4)
+		return 0;
+
+	if (stage->put_plain == 0)
+		return 0;
+
+	/* the source rows are adjacent pixels, and the pixels are rows */
+	if (stage_vert->sdw != (int)stage->sbpp && stage_vert->sdw != -(int)stage->sbpp)
+		return 0;
+	if (stage->sdp == (int)stage->sbpp || stage->sdp == -(int)stage->sbpp)
+		return 0;
+
+	return 1;
+}
+
+/**
+ * Max number of source rows read by a band.
+ */
+static unsigned video_band_row_max(const struct video_stage_vert_struct* stage_vert, unsigned num, unsigned max)
+{
+	unsigned count = stage_vert->slice.count;
+	unsigned halo = stage_vert->halo;
+	struct video_slice_pos_struct pos;
+	unsigned begin;
+	unsigned end;
+	unsigned src_row;
+
+	begin = count * num / max;
+	end = count * (num + 1) / max;
+	begin = begin > halo ? begin - halo : 0;
+	end = end + halo < count ? end + halo : count;
+
+	video_slice_pos_init(stage_vert, &pos);
+	while (pos.i < begin)
+		video_slice_pos_next(stage_vert, &pos);
+	src_row = pos.src_row;
+	while (pos.i < end)
+		video_slice_pos_next(stage_vert, &pos);
+
+	return pos.src_row - src_row;
+}
+
+/* Split the pipeline in bands, if enabled */
+static void video_pipeline_band_realize(struct video_pipeline_struct* pipeline)
+{
+	unsigned band_mac;
+	unsigned band_max;
+	adv_bool rotate;
+	unsigned i;
+
+	pipeline->band_map = 0;
+	pipeline->band_mac = 0;
+	pipeline->band_max = 0;
+
+	/* the stages with an extra buffer, like swap and interlace, */
+	/* keep the state of the previous two rows, which must already */
+	/* be correct when they are computed */
+	for (i = 0; i < pipeline->stage_mac; ++i) {
+		if (pipeline->stage_map[i].buffer_extra_size != 0) {
+			pipeline->stage_vert.halo += 2;
+			break;
+		}
+	}
+
+	if (the_blit_parallelize) {
+		band_mac = video_pipeline_vert(pipeline)->slice.count / VIDEO_BAND_ROW_MIN;
+		if (band_mac > the_blit_band_max)
+			band_mac = the_blit_band_max;
+		if (band_mac < 2)
+			band_mac = 0;
+	} else {
+		band_mac = 0;
+	}
+
+	rotate = video_pipeline_is_rotate(pipeline);
+
+	/* a band is required for the partial blit and for the transpose */
+	band_max = band_mac;
+	if (band_max == 0 && (the_blit_change || rotate))
+		band_max = 1;
+	if (band_max == 0)
+		return;
+
+	pipeline->band_map = malloc(band_max * sizeof(struct video_band_struct));
+	if (!pipeline->band_map)
+		return;
+
+	for (i = 0; i < band_max; ++i) {
+		unsigned rotate_row_max;
+
+		/* the first band is used also for the complete and partial blit */
+		if (!rotate)
+			rotate_row_max = 0;
+		else if (i == 0)
+			rotate_row_max = video_pipeline_vert(pipeline)->sdy;
+		else
+			rotate_row_max = video_band_row_max(video_pipeline_vert(pipeline), i, band_mac);
+
+		if (video_band_alloc(pipeline, &pipeline->band_map[i], rotate_row_max) != 0) {
+			log_std(("ERROR:blit: out of memory for the bands\n"));
+			while (i > 0) {
+				--i;
+				video_band_free(pipeline, &pipeline->band_map[i]);
+			}
+			free(pipeline->band_map);
+			pipeline->band_map = 0;
+			return;
+		}
+	}
+
+	pipeline->band_mac = band_mac;
+	pipeline->band_max = band_max;
+}
+
+static void video_pipeline_band_done(struct video_pipeline_struct* pipeline)
+{
+	unsigned i;
+
+	for (i = 0; i < pipeline->band_max; ++i)
+		video_band_free(pipeline, &pipeline->band_map[i]);
+
+	free(pipeline->band_map);
+	pipeline->band_map = 0;
+	pipeline->band_mac = 0;
+	pipeline->band_max = 0;
+}
+
+/**
+ * Transpose the source rows read by the band in the rotate buffer.
+ * The first stage of the band is then changed to read the buffer as
+ * a plain image. If the rows don't fit in the buffer the stage is
+ * restored to read the source directly.
+ * \return The source to use for the band.
+ */
+static const void* video_band_rotate(const struct video_pipeline_struct* pipeline, struct video_band_struct* band, const void* src, const struct video_slice_pos_struct* halo_pos, unsigned halo_end)
+{
+	const struct video_stage_vert_struct* stage_vert = video_pipeline_vert(pipeline);
+	const struct video_stage_horz_struct* stage = stage_vert->stage_begin;
+	struct video_stage_horz_struct* band_stage = band->stage_map + (stage - pipeline->stage_map);
+	struct video_slice_pos_struct end_pos;
+	unsigned rows;
+
+	end_pos = *halo_pos;
+	while (end_pos.i < halo_end)
+		video_slice_pos_next(stage_vert, &end_pos);
+	rows = end_pos.src_row - halo_pos->src_row;
+
+	if (rows > band->rotate_row_max) {
+		band_stage->put = stage->put;
+		band_stage->sdp = stage->sdp;
+		band->stage_vert.sdw = stage_vert->sdw;
+		return src;
+	}
+
+	switch (stage->sbpp) {
+	case 1: BLITTER(internal_transpose8)(band->rotate_buffer, band->rotate_dw, src, stage_vert->sdw, stage->sdp, stage->sdx, rows); break;
+	case 2: BLITTER(internal_transpose16)(band->rotate_buffer, band->rotate_dw, src, stage_vert->sdw, stage->sdp, stage->sdx, rows); break;
+	case 4: BLITTER(internal_transpose32)(band->rotate_buffer, band->rotate_dw, src, stage_vert->sdw, stage->sdp, stage->sdx, rows); break;
+	}
+
+	band_stage->put = stage->put_plain;
+	band_stage->sdp = stage->sbpp;
+	band->stage_vert.sdw = band->rotate_dw;
+
+	return band->rotate_buffer;
+}
+
+/**
+ * Run the segments [begin, end) of the slice in a band.
+ * The band is computed starting some source rows before and ending some rows
+ * after, to give at the vertical stage the same neighbor rows of the complete
+ * blit. The rows of this halo are then written in a discarded row.
+ * The position is moved forward from its current segment, that must not be
+ * after the first segment of the halo, and it's left at the end segment.
+ * \return Number of target rows written.
+ */
+static unsigned video_band_segment(const struct video_pipeline_struct* pipeline, struct video_band_struct* band, unsigned x, unsigned y, const void* src, struct video_slice_pos_struct* pos, unsigned begin, unsigned end)
+{
+	const struct video_stage_vert_struct* stage_vert = video_pipeline_vert(pipeline);
+	unsigned count = stage_vert->slice.count;
+	unsigned halo = stage_vert->halo;
+	unsigned halo_begin;
+	unsigned halo_end;
+	unsigned begin_dst_row;
+	struct video_slice_pos_struct halo_pos;
+
+	halo_begin = begin > halo ? begin - halo : 0;
+	halo_end = end + halo < count ? end + halo : count;
+
+	assert(pos->i <= halo_begin);
+
+	/* run the slice algorithm to get the position of the band */
+	while (pos->i < halo_begin)
+		video_slice_pos_next(stage_vert, pos);
+	halo_pos = *pos;
+	while (pos->i < begin)
+		video_slice_pos_next(stage_vert, pos);
+	begin_dst_row = pos->dst_row;
+	while (pos->i < end)
+		video_slice_pos_next(stage_vert, pos);
+
+	band->stage_vert.sdy = halo_end - halo_begin;
+	band->stage_vert.slice.count = halo_end - halo_begin;
+	band->stage_vert.slice.error = halo_pos.error;
+	band->stage_vert.line_base = halo_pos.dst_row;
+	band->y_begin = y + begin_dst_row;
+	band->y_end = y + pos->dst_row;
+
+	PADD(src, stage_vert->sdw * (int)halo_pos.src_row);
+
+	if (band->rotate_buffer)
+		src = video_band_rotate(pipeline, band, src, &halo_pos, halo_end);
+
+	band->stage_vert.put(&band->target, &band->stage_vert, x, y + halo_pos.dst_row, src);
+
+	return pos->dst_row - begin_dst_row;
+}
+
+/**
+ * Run a band of the pipeline.
+ */
+static void video_band_run(void* void_arg, int num, int max)
+{
+	const struct video_band_arg_struct* arg = (const struct video_band_arg_struct*)void_arg;
+	const struct video_pipeline_struct* pipeline = arg->pipeline;
+	const struct video_stage_vert_struct* stage_vert = video_pipeline_vert(pipeline);
+	unsigned count = stage_vert->slice.count;
+	struct video_slice_pos_struct pos;
+	unsigned begin;
+	unsigned end;
+
+	/* segments of the slice of the band */
+	begin = count * num / max;
+	end = count * (num + 1) / max;
+	if (begin == end)
+		return;
+
+	video_slice_pos_init(stage_vert, &pos);
+
+	video_band_segment(pipeline, &pipeline->band_map[num], arg->x, arg->y, arg->src, &pos, begin, end);
+
+	/* restore the SSE2 micro state of this thread */
+	internal_end();
+}
+
 void video_pipeline_done(struct video_pipeline_struct* pipeline)
 {
 	int i;
@@ -705,6 +1525,8 @@ void video_pipeline_done(struct video_pipeline_struct* pipeline)
 				video_buffer_free(stage->buffer);
 		}
 	}
+
+	video_pipeline_band_done(pipeline);
 }
 
 static inline struct video_stage_horz_struct* video_pipeline_begin_mutable(struct video_pipeline_struct* pipeline)
@@ -729,6 +1551,83 @@ static inline struct video_stage_horz_struct* video_pipeline_insert(struct video
 	return stage;
 }
 
+/* Remove the stages from begin to end, excluded */
+static void video_pipeline_remove(struct video_pipeline_struct* pipeline, unsigned begin, unsigned end)
+{
+	struct video_stage_vert_struct* stage_vert = video_pipeline_vert_mutable(pipeline);
+	unsigned pivot = stage_vert->stage_pivot - pipeline->stage_map;
+
+	memmove(pipeline->stage_map + begin, pipeline->stage_map + end, (pipeline->stage_mac - end) * sizeof(struct video_stage_horz_struct));
+	pipeline->stage_mac -= end - begin;
+
+	if (pivot >= end)
+		pivot -= end - begin;
+
+	stage_vert->stage_pivot = pipeline->stage_map + pivot;
+	stage_vert->stage_end = pipeline->stage_map + pipeline->stage_mac;
+}
+
+/* Merge the adjacent horizontal stages */
+static void video_pipeline_fuse(struct video_pipeline_struct* pipeline)
+{
+	struct video_stage_vert_struct* stage_vert = video_pipeline_vert_mutable(pipeline);
+	struct video_stage_horz_struct* map = pipeline->stage_map;
+	unsigned i, j;
+
+	pipeline->fuse_mac = 0;
+
+	if (!the_blit_fuse)
+		return;
+
+	/* the stages are never merged across the pivot, because the */
+	/* vertical stage works between them */
+
+	/* remove the copy stages, the previous stage can write directly in the destination */
+	i = 1;
+	while (i < pipeline->stage_mac) {
+		if (map[i].type == pipe_x_copy
+			&& map[i].sdp == map[i].sbpp
+			&& &map[i] != stage_vert->stage_pivot) {
+			video_pipeline_remove(pipeline, i, i + 1);
+		} else {
+			++i;
+		}
+	}
+
+	/* merge the palette conversion with the stretch */
+	i = 0;
+	while (i + 1 < pipeline->stage_mac) {
+		if (&map[i + 1] != stage_vert->stage_pivot
+			&& video_stage_palette_stretchx_set(&map[i], &map[i + 1])) {
+			video_pipeline_remove(pipeline, i + 1, i + 2);
+		} else {
+			++i;
+		}
+	}
+
+	/* merge the sequences of stages that can be run in blocks */
+	i = 0;
+	while (i < pipeline->stage_mac) {
+		j = i + 1;
+		while (j < pipeline->stage_mac
+			&& &map[j] != stage_vert->stage_pivot
+			&& video_stage_fuse_ratio(&map[j]) != 0)
+			++j;
+
+		if (j - i >= 2) {
+			struct video_stage_horz_struct stage;
+
+			if (video_stage_fuse_set(&stage, pipeline->fuse_map + pipeline->fuse_mac, &map[i], &map[j])) {
+				pipeline->fuse_mac += j - i;
+				map[i] = stage;
+				video_pipeline_remove(pipeline, i + 1, j);
+			}
+		}
+
+		++i;
+	}
+}
+
 static void video_pipeline_realize(struct video_pipeline_struct* pipeline, unsigned sdx, unsigned ddx, unsigned dbpp, unsigned combine)
 {
 	struct video_stage_vert_struct* stage_vert = video_pipeline_vert_mutable(pipeline);
@@ -736,6 +1635,10 @@ static void video_pipeline_realize(struct video_pipeline_struct* pipeline, unsig
 	struct video_stage_horz_struct* stage_end = video_pipeline_end_mutable(pipeline);
 	struct video_stage_horz_struct* stage;
 
+	/* merge the stages */
+	video_pipeline_fuse(pipeline);
+	stage_end = video_pipeline_end_mutable(pipeline);
+
 	/* adjust vert stage */
 	if (stage_begin == stage_end) {
 		stage_vert->sdx = sdx;
@@ -778,6 +1681,9 @@ static void video_pipeline_realize(struct video_pipeline_struct* pipeline, unsig
 
 		++stage;
 	}
+
+	/* split in bands */
+	video_pipeline_band_realize(pipeline);
 }
 
 /* Run a partial pipeline (all except the last stage) and store the result in the specified buffer */
@@ -904,6 +1810,8 @@ const char* pipe_name(enum video_stage_enum pipe)
 	case pipe_bgr888tobgra8888: return "bgr 888>bgra 8888";
 	case pipe_rgbtorgb: return "rgb>rgb";
 	case pipe_rgbtoyuy2: return "rgb>yuy2";
+	case pipe_palette_stretch: return "palette hstretch";
+	case pipe_fuse: return "fuse";
 	case pipe_y_copy: return "vstretch";
 	case pipe_y_mean: return "vmean";
 	case pipe_y_filter: return "vlowpass";
@@ -956,6 +1864,7 @@ static adv_bool pipe_is_conversion(enum video_stage_enum pipe)
 	case pipe_bgr888tobgra8888:
 	case pipe_rgbtorgb:
 	case pipe_rgbtoyuy2:
+	case pipe_palette_stretch:
 		return 1;
 	default:
 		return 0;
@@ -1049,7 +1958,7 @@ static void video_stage_stretchy_x1(const struct video_pipeline_target_struct* t
 	int down = stage_vert->slice.down;
 	int error = stage_vert->slice.error;
 	unsigned count = stage_vert->slice.count;
-	unsigned line = 0;
+	unsigned line = stage_vert->line_base;
 
 	while (count) {
 		void* dst;
@@ -1063,7 +1972,7 @@ static void video_stage_stretchy_x1(const struct video_pipeline_target_struct* t
 		video_pipeline_run(stage_vert->stage_begin, stage_vert->stage_end, line++, dst, src, -1);
 		++y;
 
-		PADD(src, stage_vert->sdw * run);
+		PADD(src, stage_vert->sdw * (int)run);
 		--count;
 	}
 }
@@ -1076,14 +1985,14 @@ static void video_stage_stretchy_max_x1(const struct video_pipeline_target_struc
 	const struct video_stage_horz_struct* stage_end = stage_vert->stage_end;
 	const struct video_stage_horz_struct* stage_pivot = stage_vert->stage_pivot;
 
-	void* buffer = video_buffer_alloc(stage_vert->stage_begin->sdx * stage_vert->stage_begin->sbpp);
+	void* buffer = video_target_alloc(target, stage_vert->stage_begin->sdx * stage_vert->stage_begin->sbpp);
 
 	unsigned whole = stage_vert->slice.whole;
 	int up = stage_vert->slice.up;
 	int down = stage_vert->slice.down;
 	int error = stage_vert->slice.error;
 	unsigned count = stage_vert->slice.count;
-	unsigned line = 0;
+	unsigned line = stage_vert->line_base;
 
 	while (count) {
 		void* dst;
@@ -1122,7 +2031,7 @@ static void video_stage_stretchy_max_x1(const struct video_pipeline_target_struc
 		--count;
 	}
 
-	video_buffer_free(buffer);
+	video_target_free(target, buffer);
 }
 
 /* Compute the mean of every lines reduced to a single line */
@@ -1134,14 +2043,14 @@ static void video_stage_stretchy_mean_x1(const struct video_pipeline_target_stru
 	const struct video_stage_horz_struct* stage_end = stage_vert->stage_end;
 	const struct video_stage_horz_struct* stage_pivot = stage_vert->stage_pivot;
 
-	void* buffer = video_buffer_alloc(stage_pivot->sdx * stage_pivot->sbpp);
+	void* buffer = video_target_alloc(target, stage_pivot->sdx * stage_pivot->sbpp);
 
 	unsigned whole = stage_vert->slice.whole;
 	int up = stage_vert->slice.up;
 	int down = stage_vert->slice.down;
 	int error = stage_vert->slice.error;
 	unsigned count = stage_vert->slice.count;
-	unsigned line = 0;
+	unsigned line = stage_vert->line_base;
 
 	while (count) {
 		void* dst;
@@ -1177,7 +2086,7 @@ static void video_stage_stretchy_mean_x1(const struct video_pipeline_target_stru
 		--count;
 	}
 
-	video_buffer_free(buffer);
+	video_target_free(target, buffer);
 }
 
 /* Compute the mean of the previous line and the first of every iteration */
@@ -1190,14 +2099,14 @@ static void video_stage_stretchy_filter_x1(const struct video_pipeline_target_st
 	const struct video_stage_horz_struct* stage_pivot = stage_vert->stage_pivot;
 
 	adv_bool buffer_full = 0;
-	void* buffer = video_buffer_alloc(stage_pivot->sdx * stage_pivot->sbpp);
+	void* buffer = video_target_alloc(target, stage_pivot->sdx * stage_pivot->sbpp);
 
 	unsigned whole = stage_vert->slice.whole;
 	int up = stage_vert->slice.up;
 	int down = stage_vert->slice.down;
 	int error = stage_vert->slice.error;
 	unsigned count = stage_vert->slice.count;
-	unsigned line = 0;
+	unsigned line = stage_vert->line_base;
 
 	while (count) {
 		void* dst;
@@ -1220,7 +2129,7 @@ static void video_stage_stretchy_filter_x1(const struct video_pipeline_target_st
 
 		if (count > 1) {
 			if (run > 1) {
-				PADD(src, (run - 1) * stage_vert->sdw);
+				PADD(src, (int)(run - 1) * stage_vert->sdw);
 				src_buffer = video_pipeline_run_partial(0, stage_begin, stage_pivot, 0, src, -1);
 			}
 
@@ -1233,7 +2142,7 @@ static void video_stage_stretchy_filter_x1(const struct video_pipeline_target_st
 		--count;
 	}
 
-	video_buffer_free(buffer);
+	video_target_free(target, buffer);
 }
 
 /***************************************************************************/
@@ -1263,7 +2172,7 @@ static void video_stage_stretchy_1x(const struct video_pipeline_target_struct* t
 	int down = stage_vert->slice.down;
 	int error = stage_vert->slice.error;
 	unsigned count = stage_vert->slice.count;
-	unsigned line = 0;
+	unsigned line = stage_vert->line_base;
 	unsigned pos = -1;
 
 	while (count) {
@@ -1305,7 +2214,7 @@ static void video_stage_stretchy_mean_1x(const struct video_pipeline_target_stru
 	const struct video_stage_horz_struct* stage_end = stage_vert->stage_end;
 	const struct video_stage_horz_struct* stage_pivot = stage_vert->stage_pivot;
 
-	void* buffer = video_buffer_alloc(stage_pivot->sdx * stage_pivot->sbpp);
+	void* buffer = video_target_alloc(target, stage_pivot->sdx * stage_pivot->sbpp);
 	void* previous_buffer = 0;
 
 	unsigned whole = stage_vert->slice.whole;
@@ -1313,7 +2222,7 @@ static void video_stage_stretchy_mean_1x(const struct video_pipeline_target_stru
 	int down = stage_vert->slice.down;
 	int error = stage_vert->slice.error;
 	unsigned count = stage_vert->slice.count;
-	unsigned line = 0;
+	unsigned line = stage_vert->line_base;
 
 	while (count) {
 		void* src_buffer;
@@ -1362,7 +2271,7 @@ static void video_stage_stretchy_mean_1x(const struct video_pipeline_target_stru
 		--count;
 	}
 
-	video_buffer_free(buffer);
+	video_target_free(target, buffer);
 }
 
 static void video_stage_stretchy_min_1x(const struct video_pipeline_target_struct* target, const struct video_stage_vert_struct* stage_vert, unsigned x, unsigned y, const void* src)
@@ -1373,7 +2282,7 @@ static void video_stage_stretchy_min_1x(const struct video_pipeline_target_struc
 	const struct video_stage_horz_struct* stage_end = stage_vert->stage_end;
 	const struct video_stage_horz_struct* stage_pivot = stage_vert->stage_pivot;
 
-	void* buffer = video_buffer_alloc(stage_pivot->sdx * stage_pivot->sbpp);
+	void* buffer = video_target_alloc(target, stage_pivot->sdx * stage_pivot->sbpp);
 	adv_bool buffer_set = 0;
 
 	unsigned whole = stage_vert->slice.whole;
@@ -1381,7 +2290,7 @@ static void video_stage_stretchy_min_1x(const struct video_pipeline_target_struc
 	int down = stage_vert->slice.down;
 	int error = stage_vert->slice.error;
 	unsigned count = stage_vert->slice.count;
-	unsigned line = 0;
+	unsigned line = stage_vert->line_base;
 
 	while (count) {
 		void* src_buffer;
@@ -1428,7 +2337,7 @@ static void video_stage_stretchy_min_1x(const struct video_pipeline_target_struc
 		--count;
 	}
 
-	video_buffer_free(buffer);
+	video_target_free(target, buffer);
 }
 
 
@@ -1441,7 +2350,7 @@ static void video_stage_stretchy_filter_1x(const struct video_pipeline_target_st
 	const struct video_stage_horz_struct* stage_end = stage_vert->stage_end;
 	const struct video_stage_horz_struct* stage_pivot = stage_vert->stage_pivot;
 
-	void* buffer = video_buffer_alloc(stage_pivot->sdx * stage_pivot->sbpp);
+	void* buffer = video_target_alloc(target, stage_pivot->sdx * stage_pivot->sbpp);
 	void* previous_buffer = 0;
 
 	unsigned whole = stage_vert->slice.whole;
@@ -1449,7 +2358,7 @@ static void video_stage_stretchy_filter_1x(const struct video_pipeline_target_st
 	int down = stage_vert->slice.down;
 	int error = stage_vert->slice.error;
 	unsigned count = stage_vert->slice.count;
-	unsigned line = 0;
+	unsigned line = stage_vert->line_base;
 
 	while (count) {
 		void* src_buffer;
@@ -1494,7 +2403,7 @@ static void video_stage_stretchy_filter_1x(const struct video_pipeline_target_st
 		--count;
 	}
 
-	video_buffer_free(buffer);
+	video_target_free(target, buffer);
 }
 
 /***************************************************************************/
@@ -1505,7 +2414,7 @@ static void video_stage_stretchy_scale2x(const struct video_pipeline_target_stru
 {
 	unsigned x_off = x * target->bytes_per_pixel;
 	unsigned count = stage_vert->sdy;
-	unsigned line = 0;
+	unsigned line = stage_vert->line_base;
 	unsigned pos = -1;
 
 	const struct video_stage_horz_struct* stage_begin = stage_vert->stage_begin;
@@ -1521,7 +2430,7 @@ static void video_stage_stretchy_scale2x(const struct video_pipeline_target_stru
 
 	if (stage_pivot != stage_end) {
 		for (i = 0; i < 2; ++i) {
-			final[i] = video_buffer_alloc(2 * stage_pivot->sdx * stage_pivot->sbpp);
+			final[i] = video_target_alloc(target, 2 * stage_pivot->sdx * stage_pivot->sbpp);
 		}
 	} else {
 		for (i = 0; i < 2; ++i) {
@@ -1536,7 +2445,7 @@ static void video_stage_stretchy_scale2x(const struct video_pipeline_target_stru
 	PADD(input[2], stage_vert->sdw * 2);
 
 	for (i = 0; i < 3; ++i) {
-		partial_copy[i] = partial[i] = video_buffer_alloc(stage_vert->sdx * stage_vert->bpp);
+		partial_copy[i] = partial[i] = video_target_alloc(target, stage_vert->sdx * stage_vert->bpp);
 	}
 
 	partial[0] = video_pipeline_run_partial(partial[0], stage_begin, stage_pivot, 0, input[0], -1);
@@ -1642,12 +2551,12 @@ static void video_stage_stretchy_scale2x(const struct video_pipeline_target_stru
 	}
 
 	for (i = 0; i < 3; ++i) {
-		video_buffer_free(partial_copy[2 - i]);
+		video_target_free(target, partial_copy[2 - i]);
 	}
 
 	if (stage_pivot != stage_end) {
 		for (i = 0; i < 2; ++i) {
-			video_buffer_free(final[1 - i]);
+			video_target_free(target, final[1 - i]);
 		}
 	}
 }
@@ -1656,7 +2565,7 @@ static void video_stage_stretchy_scale2x3(const struct video_pipeline_target_str
 {
 	unsigned x_off = x * target->bytes_per_pixel;
 	unsigned count = stage_vert->sdy;
-	unsigned line = 0;
+	unsigned line = stage_vert->line_base;
 	unsigned pos = -1;
 
 	const struct video_stage_horz_struct* stage_begin = stage_vert->stage_begin;
@@ -1672,7 +2581,7 @@ static void video_stage_stretchy_scale2x3(const struct video_pipeline_target_str
 
 	if (stage_pivot != stage_end) {
 		for (i = 0; i < 3; ++i) {
-			final[i] = video_buffer_alloc(2 * stage_pivot->sdx * stage_pivot->sbpp);
+			final[i] = video_target_alloc(target, 2 * stage_pivot->sdx * stage_pivot->sbpp);
 		}
 	} else {
 		for (i = 0; i < 3; ++i) {
@@ -1687,7 +2596,7 @@ static void video_stage_stretchy_scale2x3(const struct video_pipeline_target_str
 	PADD(input[2], stage_vert->sdw * 2);
 
 	for (i = 0; i < 3; ++i) {
-		partial_copy[i] = partial[i] = video_buffer_alloc(stage_vert->sdx * stage_vert->bpp);
+		partial_copy[i] = partial[i] = video_target_alloc(target, stage_vert->sdx * stage_vert->bpp);
 	}
 
 	partial[0] = video_pipeline_run_partial(partial[0], stage_begin, stage_pivot, 0, input[0], -1);
@@ -1792,12 +2701,12 @@ static void video_stage_stretchy_scale2x3(const struct video_pipeline_target_str
 	}
 
 	for (i = 0; i < 3; ++i) {
-		video_buffer_free(partial_copy[2 - i]);
+		video_target_free(target, partial_copy[2 - i]);
 	}
 
 	if (stage_pivot != stage_end) {
 		for (i = 0; i < 3; ++i) {
-			video_buffer_free(final[2 - i]);
+			video_target_free(target, final[2 - i]);
 		}
 	}
 }
@@ -1806,7 +2715,7 @@ static void video_stage_stretchy_scale2x4(const struct video_pipeline_target_str
 {
 	unsigned x_off = x * target->bytes_per_pixel;
 	unsigned count = stage_vert->sdy;
-	unsigned line = 0;
+	unsigned line = stage_vert->line_base;
 	unsigned pos = -1;
 
 	const struct video_stage_horz_struct* stage_begin = stage_vert->stage_begin;
@@ -1822,7 +2731,7 @@ static void video_stage_stretchy_scale2x4(const struct video_pipeline_target_str
 
 	if (stage_pivot != stage_end) {
 		for (i = 0; i < 4; ++i) {
-			final[i] = video_buffer_alloc(2 * stage_pivot->sdx * stage_pivot->sbpp);
+			final[i] = video_target_alloc(target, 2 * stage_pivot->sdx * stage_pivot->sbpp);
 		}
 	} else {
 		for (i = 0; i < 4; ++i) {
@@ -1837,7 +2746,7 @@ static void video_stage_stretchy_scale2x4(const struct video_pipeline_target_str
 	PADD(input[2], stage_vert->sdw * 2);
 
 	for (i = 0; i < 3; ++i) {
-		partial_copy[i] = partial[i] = video_buffer_alloc(stage_vert->sdx * stage_vert->bpp);
+		partial_copy[i] = partial[i] = video_target_alloc(target, stage_vert->sdx * stage_vert->bpp);
 	}
 
 	partial[0] = video_pipeline_run_partial(partial[0], stage_begin, stage_pivot, 0, input[0], -1);
@@ -1942,12 +2851,12 @@ static void video_stage_stretchy_scale2x4(const struct video_pipeline_target_str
 	}
 
 	for (i = 0; i < 3; ++i) {
-		video_buffer_free(partial_copy[2 - i]);
+		video_target_free(target, partial_copy[2 - i]);
 	}
 
 	if (stage_pivot != stage_end) {
 		for (i = 0; i < 4; ++i) {
-			video_buffer_free(final[3 - i]);
+			video_target_free(target, final[3 - i]);
 		}
 	}
 }
@@ -1961,7 +2870,7 @@ static void video_stage_stretchy_scale2k(const struct video_pipeline_target_stru
 {
 	unsigned x_off = x * target->bytes_per_pixel;
 	unsigned count = stage_vert->sdy;
-	unsigned line = 0;
+	unsigned line = stage_vert->line_base;
 	unsigned pos = -1;
 
 	const struct video_stage_horz_struct* stage_begin = stage_vert->stage_begin;
@@ -1977,7 +2886,7 @@ static void video_stage_stretchy_scale2k(const struct video_pipeline_target_stru
 
 	if (stage_pivot != stage_end) {
 		for (i = 0; i < 2; ++i) {
-			final[i] = video_buffer_alloc(2 * stage_pivot->sdx * stage_pivot->sbpp);
+			final[i] = video_target_alloc(target, 2 * stage_pivot->sdx * stage_pivot->sbpp);
 		}
 	} else {
 		for (i = 0; i < 2; ++i) {
@@ -1992,7 +2901,7 @@ static void video_stage_stretchy_scale2k(const struct video_pipeline_target_stru
 	PADD(input[2], stage_vert->sdw * 2);
 
 	for (i = 0; i < 3; ++i) {
-		partial_copy[i] = partial[i] = video_buffer_alloc(stage_vert->sdx * stage_vert->bpp);
+		partial_copy[i] = partial[i] = video_target_alloc(target, stage_vert->sdx * stage_vert->bpp);
 	}
 
 	partial[0] = video_pipeline_run_partial(partial[0], stage_begin, stage_pivot, 0, input[0], -1);
@@ -2097,12 +3006,12 @@ static void video_stage_stretchy_scale2k(const struct video_pipeline_target_stru
 	}
 
 	for (i = 0; i < 3; ++i) {
-		video_buffer_free(partial_copy[2 - i]);
+		video_target_free(target, partial_copy[2 - i]);
 	}
 
 	if (stage_pivot != stage_end) {
 		for (i = 0; i < 2; ++i) {
-			video_buffer_free(final[1 - i]);
+			video_target_free(target, final[1 - i]);
 		}
 	}
 }
@@ -2117,7 +3026,7 @@ static void video_stage_stretchy_hq2x(const struct video_pipeline_target_struct*
 {
 	unsigned x_off = x * target->bytes_per_pixel;
 	unsigned count = stage_vert->sdy;
-	unsigned line = 0;
+	unsigned line = stage_vert->line_base;
 	unsigned pos = -1;
 
 	const struct video_stage_horz_struct* stage_begin = stage_vert->stage_begin;
@@ -2133,7 +3042,7 @@ static void video_stage_stretchy_hq2x(const struct video_pipeline_target_struct*
 
 	if (stage_pivot != stage_end) {
 		for (i = 0; i < 2; ++i) {
-			final[i] = video_buffer_alloc(2 * stage_pivot->sdx * stage_pivot->sbpp);
+			final[i] = video_target_alloc(target, 2 * stage_pivot->sdx * stage_pivot->sbpp);
 		}
 	} else {
 		for (i = 0; i < 2; ++i) {
@@ -2148,7 +3057,7 @@ static void video_stage_stretchy_hq2x(const struct video_pipeline_target_struct*
 	PADD(input[2], stage_vert->sdw * 2);
 
 	for (i = 0; i < 3; ++i) {
-		partial_copy[i] = partial[i] = video_buffer_alloc(stage_vert->sdx * stage_vert->bpp);
+		partial_copy[i] = partial[i] = video_target_alloc(target, stage_vert->sdx * stage_vert->bpp);
 	}
 
 	partial[0] = video_pipeline_run_partial(partial[0], stage_begin, stage_pivot, 0, input[0], -1);
@@ -2253,12 +3162,12 @@ static void video_stage_stretchy_hq2x(const struct video_pipeline_target_struct*
 	}
 
 	for (i = 0; i < 3; ++i) {
-		video_buffer_free(partial_copy[2 - i]);
+		video_target_free(target, partial_copy[2 - i]);
 	}
 
 	if (stage_pivot != stage_end) {
 		for (i = 0; i < 2; ++i) {
-			video_buffer_free(final[1 - i]);
+			video_target_free(target, final[1 - i]);
 		}
 	}
 }
@@ -2267,7 +3176,7 @@ static void video_stage_stretchy_hq2x3(const struct video_pipeline_target_struct
 {
 	unsigned x_off = x * target->bytes_per_pixel;
 	unsigned count = stage_vert->sdy;
-	unsigned line = 0;
+	unsigned line = stage_vert->line_base;
 	unsigned pos = -1;
 
 	const struct video_stage_horz_struct* stage_begin = stage_vert->stage_begin;
@@ -2283,7 +3192,7 @@ static void video_stage_stretchy_hq2x3(const struct video_pipeline_target_struct
 
 	if (stage_pivot != stage_end) {
 		for (i = 0; i < 3; ++i) {
-			final[i] = video_buffer_alloc(2 * stage_pivot->sdx * stage_pivot->sbpp);
+			final[i] = video_target_alloc(target, 2 * stage_pivot->sdx * stage_pivot->sbpp);
 		}
 	} else {
 		for (i = 0; i < 3; ++i) {
@@ -2298,7 +3207,7 @@ static void video_stage_stretchy_hq2x3(const struct video_pipeline_target_struct
 	PADD(input[2], stage_vert->sdw * 2);
 
 	for (i = 0; i < 3; ++i) {
-		partial_copy[i] = partial[i] = video_buffer_alloc(stage_vert->sdx * stage_vert->bpp);
+		partial_copy[i] = partial[i] = video_target_alloc(target, stage_vert->sdx * stage_vert->bpp);
 	}
 
 	partial[0] = video_pipeline_run_partial(partial[0], stage_begin, stage_pivot, 0, input[0], -1);
@@ -2403,12 +3312,12 @@ static void video_stage_stretchy_hq2x3(const struct video_pipeline_target_struct
 	}
 
 	for (i = 0; i < 3; ++i) {
-		video_buffer_free(partial_copy[2 - i]);
+		video_target_free(target, partial_copy[2 - i]);
 	}
 
 	if (stage_pivot != stage_end) {
 		for (i = 0; i < 3; ++i) {
-			video_buffer_free(final[2 - i]);
+			video_target_free(target, final[2 - i]);
 		}
 	}
 }
@@ -2417,7 +3326,7 @@ static void video_stage_stretchy_hq2x4(const struct video_pipeline_target_struct
 {
 	unsigned x_off = x * target->bytes_per_pixel;
 	unsigned count = stage_vert->sdy;
-	unsigned line = 0;
+	unsigned line = stage_vert->line_base;
 	unsigned pos = -1;
 
 	const struct video_stage_horz_struct* stage_begin = stage_vert->stage_begin;
@@ -2433,7 +3342,7 @@ static void video_stage_stretchy_hq2x4(const struct video_pipeline_target_struct
 
 	if (stage_pivot != stage_end) {
 		for (i = 0; i < 4; ++i) {
-			final[i] = video_buffer_alloc(2 * stage_pivot->sdx * stage_pivot->sbpp);
+			final[i] = video_target_alloc(target, 2 * stage_pivot->sdx * stage_pivot->sbpp);
 		}
 	} else {
 		for (i = 0; i < 4; ++i) {
@@ -2448,7 +3357,7 @@ static void video_stage_stretchy_hq2x4(const struct video_pipeline_target_struct
 	PADD(input[2], stage_vert->sdw * 2);
 
 	for (i = 0; i < 3; ++i) {
-		partial_copy[i] = partial[i] = video_buffer_alloc(stage_vert->sdx * stage_vert->bpp);
+		partial_copy[i] = partial[i] = video_target_alloc(target, stage_vert->sdx * stage_vert->bpp);
 	}
 
 	partial[0] = video_pipeline_run_partial(partial[0], stage_begin, stage_pivot, 0, input[0], -1);
@@ -2553,12 +3462,12 @@ static void video_stage_stretchy_hq2x4(const struct video_pipeline_target_struct
 	}
 
 	for (i = 0; i < 3; ++i) {
-		video_buffer_free(partial_copy[2 - i]);
+		video_target_free(target, partial_copy[2 - i]);
 	}
 
 	if (stage_pivot != stage_end) {
 		for (i = 0; i < 4; ++i) {
-			video_buffer_free(final[3 - i]);
+			video_target_free(target, final[3 - i]);
 		}
 	}
 }
@@ -2574,7 +3483,7 @@ static void video_stage_stretchy_xbr2x(const struct video_pipeline_target_struct
 {
 	unsigned x_off = x * target->bytes_per_pixel;
 	unsigned count = stage_vert->sdy;
-	unsigned line = 0;
+	unsigned line = stage_vert->line_base;
 	unsigned pos = -1;
 
 	const struct video_stage_horz_struct* stage_begin = stage_vert->stage_begin;
@@ -2590,7 +3499,7 @@ static void video_stage_stretchy_xbr2x(const struct video_pipeline_target_struct
 
 	if (stage_pivot != stage_end) {
 		for (i = 0; i < 2; ++i) {
-			final[i] = video_buffer_alloc(2 * stage_pivot->sdx * stage_pivot->sbpp);
+			final[i] = video_target_alloc(target, 2 * stage_pivot->sdx * stage_pivot->sbpp);
 		}
 	} else {
 		for (i = 0; i < 2; ++i) {
@@ -2609,7 +3518,7 @@ static void video_stage_stretchy_xbr2x(const struct video_pipeline_target_struct
 	PADD(input[4], stage_vert->sdw * 4);
 
 	for (i = 0; i < 5; ++i) {
-		partial_copy[i] = partial[i] = video_buffer_alloc(stage_vert->sdx * stage_vert->bpp);
+		partial_copy[i] = partial[i] = video_target_alloc(target, stage_vert->sdx * stage_vert->bpp);
 	}
 
 	partial[0] = video_pipeline_run_partial(partial[0], stage_begin, stage_pivot, 0, input[0], -1);
@@ -2764,12 +3673,12 @@ static void video_stage_stretchy_xbr2x(const struct video_pipeline_target_struct
 	}
 
 	for (i = 0; i < 5; ++i) {
-		video_buffer_free(partial_copy[4 - i]);
+		video_target_free(target, partial_copy[4 - i]);
 	}
 
 	if (stage_pivot != stage_end) {
 		for (i = 0; i < 2; ++i) {
-			video_buffer_free(final[1 - i]);
+			video_target_free(target, final[1 - i]);
 		}
 	}
 }
@@ -2785,7 +3694,7 @@ static void video_stage_stretchy_scale3x(const struct video_pipeline_target_stru
 {
 	unsigned x_off = x * target->bytes_per_pixel;
 	unsigned count = stage_vert->sdy;
-	unsigned line = 0;
+	unsigned line = stage_vert->line_base;
 	unsigned pos = -1;
 
 	const struct video_stage_horz_struct* stage_begin = stage_vert->stage_begin;
@@ -2801,7 +3710,7 @@ static void video_stage_stretchy_scale3x(const struct video_pipeline_target_stru
 
 	if (stage_pivot != stage_end) {
 		for (i = 0; i < 3; ++i) {
-			final[i] = video_buffer_alloc(3 * stage_pivot->sdx * stage_pivot->sbpp);
+			final[i] = video_target_alloc(target, 3 * stage_pivot->sdx * stage_pivot->sbpp);
 		}
 	} else {
 		for (i = 0; i < 3; ++i) {
@@ -2816,7 +3725,7 @@ static void video_stage_stretchy_scale3x(const struct video_pipeline_target_stru
 	PADD(input[2], stage_vert->sdw * 2);
 
 	for (i = 0; i < 3; ++i) {
-		partial_copy[i] = partial[i] = video_buffer_alloc(stage_vert->sdx * stage_vert->bpp);
+		partial_copy[i] = partial[i] = video_target_alloc(target, stage_vert->sdx * stage_vert->bpp);
 	}
 
 	partial[0] = video_pipeline_run_partial(partial[0], stage_begin, stage_pivot, 0, input[0], -1);
@@ -2921,12 +3830,12 @@ static void video_stage_stretchy_scale3x(const struct video_pipeline_target_stru
 	}
 
 	for (i = 0; i < 3; ++i) {
-		video_buffer_free(partial_copy[2 - i]);
+		video_target_free(target, partial_copy[2 - i]);
 	}
 
 	if (stage_pivot != stage_end) {
 		for (i = 0; i < 3; ++i) {
-			video_buffer_free(final[2 - i]);
+			video_target_free(target, final[2 - i]);
 		}
 	}
 }
@@ -2940,7 +3849,7 @@ static void video_stage_stretchy_scale3k(const struct video_pipeline_target_stru
 {
 	unsigned x_off = x * target->bytes_per_pixel;
 	unsigned count = stage_vert->sdy;
-	unsigned line = 0;
+	unsigned line = stage_vert->line_base;
 	unsigned pos = -1;
 
 	const struct video_stage_horz_struct* stage_begin = stage_vert->stage_begin;
@@ -2956,7 +3865,7 @@ static void video_stage_stretchy_scale3k(const struct video_pipeline_target_stru
 
 	if (stage_pivot != stage_end) {
 		for (i = 0; i < 3; ++i) {
-			final[i] = video_buffer_alloc(3 * stage_pivot->sdx * stage_pivot->sbpp);
+			final[i] = video_target_alloc(target, 3 * stage_pivot->sdx * stage_pivot->sbpp);
 		}
 	} else {
 		for (i = 0; i < 3; ++i) {
@@ -2971,7 +3880,7 @@ static void video_stage_stretchy_scale3k(const struct video_pipeline_target_stru
 	PADD(input[2], stage_vert->sdw * 2);
 
 	for (i = 0; i < 3; ++i) {
-		partial_copy[i] = partial[i] = video_buffer_alloc(stage_vert->sdx * stage_vert->bpp);
+		partial_copy[i] = partial[i] = video_target_alloc(target, stage_vert->sdx * stage_vert->bpp);
 	}
 
 	partial[0] = video_pipeline_run_partial(partial[0], stage_begin, stage_pivot, 0, input[0], -1);
@@ -3076,12 +3985,12 @@ static void video_stage_stretchy_scale3k(const struct video_pipeline_target_stru
 	}
 
 	for (i = 0; i < 3; ++i) {
-		video_buffer_free(partial_copy[2 - i]);
+		video_target_free(target, partial_copy[2 - i]);
 	}
 
 	if (stage_pivot != stage_end) {
 		for (i = 0; i < 3; ++i) {
-			video_buffer_free(final[2 - i]);
+			video_target_free(target, final[2 - i]);
 		}
 	}
 }
@@ -3096,7 +4005,7 @@ static void video_stage_stretchy_hq3x(const struct video_pipeline_target_struct*
 {
 	unsigned x_off = x * target->bytes_per_pixel;
 	unsigned count = stage_vert->sdy;
-	unsigned line = 0;
+	unsigned line = stage_vert->line_base;
 	unsigned pos = -1;
 
 	const struct video_stage_horz_struct* stage_begin = stage_vert->stage_begin;
@@ -3112,7 +4021,7 @@ static void video_stage_stretchy_hq3x(const struct video_pipeline_target_struct*
 
 	if (stage_pivot != stage_end) {
 		for (i = 0; i < 3; ++i) {
-			final[i] = video_buffer_alloc(3 * stage_pivot->sdx * stage_pivot->sbpp);
+			final[i] = video_target_alloc(target, 3 * stage_pivot->sdx * stage_pivot->sbpp);
 		}
 	} else {
 		for (i = 0; i < 3; ++i) {
@@ -3127,7 +4036,7 @@ static void video_stage_stretchy_hq3x(const struct video_pipeline_target_struct*
 	PADD(input[2], stage_vert->sdw * 2);
 
 	for (i = 0; i < 3; ++i) {
-		partial_copy[i] = partial[i] = video_buffer_alloc(stage_vert->sdx * stage_vert->bpp);
+		partial_copy[i] = partial[i] = video_target_alloc(target, stage_vert->sdx * stage_vert->bpp);
 	}
 
 	partial[0] = video_pipeline_run_partial(partial[0], stage_begin, stage_pivot, 0, input[0], -1);
@@ -3232,12 +4141,12 @@ static void video_stage_stretchy_hq3x(const struct video_pipeline_target_struct*
 	}
 
 	for (i = 0; i < 3; ++i) {
-		video_buffer_free(partial_copy[2 - i]);
+		video_target_free(target, partial_copy[2 - i]);
 	}
 
 	if (stage_pivot != stage_end) {
 		for (i = 0; i < 3; ++i) {
-			video_buffer_free(final[2 - i]);
+			video_target_free(target, final[2 - i]);
 		}
 	}
 }
@@ -3253,7 +4162,7 @@ static void video_stage_stretchy_xbr3x(const struct video_pipeline_target_struct
 {
 	unsigned x_off = x * target->bytes_per_pixel;
 	unsigned count = stage_vert->sdy;
-	unsigned line = 0;
+	unsigned line = stage_vert->line_base;
 	unsigned pos = -1;
 
 	const struct video_stage_horz_struct* stage_begin = stage_vert->stage_begin;
@@ -3269,7 +4178,7 @@ static void video_stage_stretchy_xbr3x(const struct video_pipeline_target_struct
 
 	if (stage_pivot != stage_end) {
 		for (i = 0; i < 3; ++i) {
-			final[i] = video_buffer_alloc(3 * stage_pivot->sdx * stage_pivot->sbpp);
+			final[i] = video_target_alloc(target, 3 * stage_pivot->sdx * stage_pivot->sbpp);
 		}
 	} else {
 		for (i = 0; i < 3; ++i) {
@@ -3288,7 +4197,7 @@ static void video_stage_stretchy_xbr3x(const struct video_pipeline_target_struct
 	PADD(input[4], stage_vert->sdw * 4);
 
 	for (i = 0; i < 5; ++i) {
-		partial_copy[i] = partial[i] = video_buffer_alloc(stage_vert->sdx * stage_vert->bpp);
+		partial_copy[i] = partial[i] = video_target_alloc(target, stage_vert->sdx * stage_vert->bpp);
 	}
 
 	partial[0] = video_pipeline_run_partial(partial[0], stage_begin, stage_pivot, 0, input[0], -1);
@@ -3443,12 +4352,12 @@ static void video_stage_stretchy_xbr3x(const struct video_pipeline_target_struct
 	}
 
 	for (i = 0; i < 5; ++i) {
-		video_buffer_free(partial_copy[4 - i]);
+		video_target_free(target, partial_copy[4 - i]);
 	}
 
 	if (stage_pivot != stage_end) {
 		for (i = 0; i < 3; ++i) {
-			video_buffer_free(final[2 - i]);
+			video_target_free(target, final[2 - i]);
 		}
 	}
 }
@@ -3463,7 +4372,7 @@ static void video_stage_stretchy_scale4x(const struct video_pipeline_target_stru
 {
 	unsigned x_off = x * target->bytes_per_pixel;
 	unsigned count = stage_vert->sdy;
-	unsigned line = 0;
+	unsigned line = stage_vert->line_base;
 	unsigned pos = -1;
 
 	const struct video_stage_horz_struct* stage_begin = stage_vert->stage_begin;
@@ -3481,7 +4390,7 @@ static void video_stage_stretchy_scale4x(const struct video_pipeline_target_stru
 
 	if (stage_pivot != stage_end) {
 		for (i = 0; i < 4; ++i) {
-			final[i] = video_buffer_alloc(4 * stage_pivot->sdx * stage_pivot->sbpp);
+			final[i] = video_target_alloc(target, 4 * stage_pivot->sdx * stage_pivot->sbpp);
 		}
 	} else {
 		for (i = 0; i < 4; ++i) {
@@ -3500,11 +4409,11 @@ static void video_stage_stretchy_scale4x(const struct video_pipeline_target_stru
 	PADD(input[4], stage_vert->sdw * 4);
 
 	for (i = 0; i < 5; ++i) {
-		partial_copy[i] = partial[i] = video_buffer_alloc(stage_vert->sdx * stage_vert->bpp);
+		partial_copy[i] = partial[i] = video_target_alloc(target, stage_vert->sdx * stage_vert->bpp);
 	}
 
 	for (i = 0; i < 6; ++i) {
-		middle_copy[i] = middle[i] = video_buffer_alloc(2 * stage_vert->sdx * stage_vert->bpp);
+		middle_copy[i] = middle[i] = video_target_alloc(target, 2 * stage_vert->sdx * stage_vert->bpp);
 	}
 
 	for (i = 0; i < 4; ++i) {
@@ -3680,16 +4589,16 @@ static void video_stage_stretchy_scale4x(const struct video_pipeline_target_stru
 	}
 
 	for (i = 0; i < 6; ++i) {
-		video_buffer_free(middle_copy[5 - i]);
+		video_target_free(target, middle_copy[5 - i]);
 	}
 
 	for (i = 0; i < 5; ++i) {
-		video_buffer_free(partial_copy[4 - i]);
+		video_target_free(target, partial_copy[4 - i]);
 	}
 
 	if (stage_pivot != stage_end) {
 		for (i = 0; i < 4; ++i) {
-			video_buffer_free(final[3 - i]);
+			video_target_free(target, final[3 - i]);
 		}
 	}
 }
@@ -3703,7 +4612,7 @@ static void video_stage_stretchy_scale4k(const struct video_pipeline_target_stru
 {
 	unsigned x_off = x * target->bytes_per_pixel;
 	unsigned count = stage_vert->sdy;
-	unsigned line = 0;
+	unsigned line = stage_vert->line_base;
 	unsigned pos = -1;
 
 	const struct video_stage_horz_struct* stage_begin = stage_vert->stage_begin;
@@ -3719,7 +4628,7 @@ static void video_stage_stretchy_scale4k(const struct video_pipeline_target_stru
 
 	if (stage_pivot != stage_end) {
 		for (i = 0; i < 4; ++i) {
-			final[i] = video_buffer_alloc(4 * stage_pivot->sdx * stage_pivot->sbpp);
+			final[i] = video_target_alloc(target, 4 * stage_pivot->sdx * stage_pivot->sbpp);
 		}
 	} else {
 		for (i = 0; i < 4; ++i) {
@@ -3734,7 +4643,7 @@ static void video_stage_stretchy_scale4k(const struct video_pipeline_target_stru
 	PADD(input[2], stage_vert->sdw * 2);
 
 	for (i = 0; i < 3; ++i) {
-		partial_copy[i] = partial[i] = video_buffer_alloc(stage_vert->sdx * stage_vert->bpp);
+		partial_copy[i] = partial[i] = video_target_alloc(target, stage_vert->sdx * stage_vert->bpp);
 	}
 
 	partial[0] = video_pipeline_run_partial(partial[0], stage_begin, stage_pivot, 0, input[0], -1);
@@ -3839,12 +4748,12 @@ static void video_stage_stretchy_scale4k(const struct video_pipeline_target_stru
 	}
 
 	for (i = 0; i < 3; ++i) {
-		video_buffer_free(partial_copy[2 - i]);
+		video_target_free(target, partial_copy[2 - i]);
 	}
 
 	if (stage_pivot != stage_end) {
 		for (i = 0; i < 4; ++i) {
-			video_buffer_free(final[3 - i]);
+			video_target_free(target, final[3 - i]);
 		}
 	}
 }
@@ -3859,7 +4768,7 @@ static void video_stage_stretchy_hq4x(const struct video_pipeline_target_struct*
 {
 	unsigned x_off = x * target->bytes_per_pixel;
 	unsigned count = stage_vert->sdy;
-	unsigned line = 0;
+	unsigned line = stage_vert->line_base;
 	unsigned pos = -1;
 
 	const struct video_stage_horz_struct* stage_begin = stage_vert->stage_begin;
@@ -3875,7 +4784,7 @@ static void video_stage_stretchy_hq4x(const struct video_pipeline_target_struct*
 
 	if (stage_pivot != stage_end) {
 		for (i = 0; i < 4; ++i) {
-			final[i] = video_buffer_alloc(4 * stage_pivot->sdx * stage_pivot->sbpp);
+			final[i] = video_target_alloc(target, 4 * stage_pivot->sdx * stage_pivot->sbpp);
 		}
 	} else {
 		for (i = 0; i < 4; ++i) {
@@ -3890,7 +4799,7 @@ static void video_stage_stretchy_hq4x(const struct video_pipeline_target_struct*
 	PADD(input[2], stage_vert->sdw * 2);
 
 	for (i = 0; i < 3; ++i) {
-		partial_copy[i] = partial[i] = video_buffer_alloc(stage_vert->sdx * stage_vert->bpp);
+		partial_copy[i] = partial[i] = video_target_alloc(target, stage_vert->sdx * stage_vert->bpp);
 	}
 
 	partial[0] = video_pipeline_run_partial(partial[0], stage_begin, stage_pivot, 0, input[0], -1);
@@ -3995,12 +4904,12 @@ static void video_stage_stretchy_hq4x(const struct video_pipeline_target_struct*
 	}
 
 	for (i = 0; i < 3; ++i) {
-		video_buffer_free(partial_copy[2 - i]);
+		video_target_free(target, partial_copy[2 - i]);
 	}
 
 	if (stage_pivot != stage_end) {
 		for (i = 0; i < 4; ++i) {
-			video_buffer_free(final[3 - i]);
+			video_target_free(target, final[3 - i]);
 		}
 	}
 }
@@ -4016,7 +4925,7 @@ static void video_stage_stretchy_xbr4x(const struct video_pipeline_target_struct
 {
 	unsigned x_off = x * target->bytes_per_pixel;
 	unsigned count = stage_vert->sdy;
-	unsigned line = 0;
+	unsigned line = stage_vert->line_base;
 	unsigned pos = -1;
 
 	const struct video_stage_horz_struct* stage_begin = stage_vert->stage_begin;
@@ -4032,7 +4941,7 @@ static void video_stage_stretchy_xbr4x(const struct video_pipeline_target_struct
 
 	if (stage_pivot != stage_end) {
 		for (i = 0; i < 4; ++i) {
-			final[i] = video_buffer_alloc(4 * stage_pivot->sdx * stage_pivot->sbpp);
+			final[i] = video_target_alloc(target, 4 * stage_pivot->sdx * stage_pivot->sbpp);
 		}
 	} else {
 		for (i = 0; i < 4; ++i) {
@@ -4051,7 +4960,7 @@ static void video_stage_stretchy_xbr4x(const struct video_pipeline_target_struct
 	PADD(input[4], stage_vert->sdw * 4);
 
 	for (i = 0; i < 5; ++i) {
-		partial_copy[i] = partial[i] = video_buffer_alloc(stage_vert->sdx * stage_vert->bpp);
+		partial_copy[i] = partial[i] = video_target_alloc(target, stage_vert->sdx * stage_vert->bpp);
 	}
 
 	partial[0] = video_pipeline_run_partial(partial[0], stage_begin, stage_pivot, 0, input[0], -1);
@@ -4206,12 +5115,12 @@ static void video_stage_stretchy_xbr4x(const struct video_pipeline_target_struct
 	}
 
 	for (i = 0; i < 5; ++i) {
-		video_buffer_free(partial_copy[4 - i]);
+		video_target_free(target, partial_copy[4 - i]);
 	}
 
 	if (stage_pivot != stage_end) {
 		for (i = 0; i < 4; ++i) {
-			video_buffer_free(final[3 - i]);
+			video_target_free(target, final[3 - i]);
 		}
 	}
 }
@@ -4226,7 +5135,7 @@ static void video_stage_stretchy_11(const struct video_pipeline_target_struct* t
 {
 	unsigned x_off = x * target->bytes_per_pixel;
 	unsigned count = stage_vert->sdy;
-	unsigned line = 0;
+	unsigned line = stage_vert->line_base;
 	unsigned pos = -1;
 
 	while (count) {
@@ -4281,6 +5190,8 @@ static void video_stage_stretchy_set(const struct video_pipeline_target_struct*
 	stage_vert->sdy = sdy;
 	stage_vert->sdw = sdw;
 	stage_vert->ddy = ddy;
+	stage_vert->line_base = 0;
+	stage_vert->halo = 1;
 
 	/* the pixel type is always the target pixel type because, when used, any conversion is done before */
 	if (color_def_type_get(target->color_def) == adv_color_type_yuy2)
@@ -4352,6 +5263,7 @@ static void video_stage_stretchy_set(const struct video_pipeline_target_struct*
 
 		video_stage_pivot_late_set(stage_vert, combine);
 		stage_vert->put = video_stage_stretchy_xbr2x;
+		stage_vert->halo = 2;
 		stage_vert->type = pipe_y_xbr2x;
 #endif
 	} else if (ddx == 3 * sdx && ddy == 3 * sdy && combine_y == VIDEO_COMBINE_Y_SCALEX) {
@@ -4382,6 +5294,7 @@ static void video_stage_stretchy_set(const struct video_pipeline_target_struct*
 
 		video_stage_pivot_late_set(stage_vert, combine);
 		stage_vert->put = video_stage_stretchy_xbr3x;
+		stage_vert->halo = 2;
 		stage_vert->type = pipe_y_xbr3x;
 #endif
 	} else if (ddx == 4 * sdx && ddy == 4 * sdy && combine_y == VIDEO_COMBINE_Y_SCALEX) {
@@ -4390,6 +5303,7 @@ static void video_stage_stretchy_set(const struct video_pipeline_target_struct*
 
 		video_stage_pivot_late_set(stage_vert, combine);
 		stage_vert->put = video_stage_stretchy_scale4x;
+		stage_vert->halo = 2;
 		stage_vert->type = pipe_y_scale4x;
 	} else if (ddx == 4 * sdx && ddy == 4 * sdy && combine_y == VIDEO_COMBINE_Y_SCALEK) {
 		/* scale4k */
@@ -4412,6 +5326,7 @@ static void video_stage_stretchy_set(const struct video_pipeline_target_struct*
 
 		video_stage_pivot_late_set(stage_vert, combine);
 		stage_vert->put = video_stage_stretchy_xbr4x;
+		stage_vert->halo = 2;
 		stage_vert->type = pipe_y_xbr4x;
 #endif
 	} else
@@ -4458,6 +5373,7 @@ static void video_stage_stretchy_set(const struct video_pipeline_target_struct*
 		default:
 			video_stage_pivot_early_set(stage_vert, combine);
 			stage_vert->put = video_stage_stretchy_11;
+			stage_vert->halo = 0;
 			stage_vert->type = pipe_y_copy;
 			break;
 		}
@@ -4520,6 +5436,8 @@ static void video_stage_stretchy_11_set(struct video_stage_vert_struct* stage_ve
 	stage_vert->sdy = sdy;
 	stage_vert->sdw = sdw;
 	stage_vert->ddy = sdy;
+	stage_vert->line_base = 0;
+	stage_vert->halo = 0;
 
 	slice_set(&stage_vert->slice, sdy, sdy);
 
@@ -4979,6 +5897,130 @@ void video_pipeline_palette16(struct video_pipeline_struct* pipeline, unsigned d
 
 void video_pipeline_blit(const struct video_pipeline_struct* pipeline, unsigned dst_x, unsigned dst_y, const void* src)
 {
-	video_pipeline_vert_run(pipeline, dst_x, dst_y, src);
+	if (pipeline->band_mac != 0 && the_blit_parallelize != 0) {
+		struct video_band_arg_struct arg;
+
+		arg.pipeline = pipeline;
+		arg.x = dst_x;
+		arg.y = dst_y;
+		arg.src = src;
+
+		the_blit_parallelize(video_band_run, &arg, pipeline->band_mac);
+	} else if (pipeline->band_max != 0 && pipeline->band_map[0].rotate_buffer != 0) {
+		struct video_slice_pos_struct pos;
+
+		/* a single band covering all the image, only to transpose the source */
+		video_slice_pos_init(video_pipeline_vert(pipeline), &pos);
+
+		video_band_segment(pipeline, &pipeline->band_map[0], dst_x, dst_y, src, &pos, 0, video_pipeline_vert(pipeline)->slice.count);
+
+		/* restore the SSE2 micro state */
+		internal_end();
+	} else {
+		video_pipeline_vert_run(pipeline, dst_x, dst_y, src);
+	}
+}
+
+/**
+ * Scan the slice segments reading a changed source row.
+ * The segments which may be affected by the change, considering the halo of the
+ * vertical stage, are joined in runs. If a band is specified the runs are also
+ * computed.
+ * \return Number of segments in the runs, or number of target rows written if the runs are computed.
+ */
+static unsigned video_pipeline_change_scan(const struct video_pipeline_struct* pipeline, struct video_band_struct* band, unsigned x, unsigned y, const void* src, const unsigned char* change_map)
+{
+	const struct video_stage_vert_struct* stage_vert = video_pipeline_vert(pipeline);
+	unsigned count = stage_vert->slice.count;
+	unsigned halo = stage_vert->halo;
+	struct video_slice_pos_struct pos;
+	struct video_slice_pos_struct run_pos;
+	unsigned run_begin;
+	unsigned run_end;
+	adv_bool run_flag;
+	unsigned result;
+
+	video_slice_pos_init(stage_vert, &pos);
+	video_slice_pos_init(stage_vert, &run_pos);
+
+	result = 0;
+	run_begin = 0;
+	run_end = 0;
+	run_flag = 0;
+	while (pos.i < count) {
+		unsigned src_row = pos.src_row;
+		unsigned i = pos.i;
+		adv_bool changed;
+
+		video_slice_pos_next(stage_vert, &pos);
+
+		/* the segment reads at least its first row */
+		changed = change_map[src_row] != 0;
+		while (!changed && ++src_row < pos.src_row)
+			changed = change_map[src_row] != 0;
+
+		if (changed) {
+			unsigned begin = i > halo ? i - halo : 0;
+			unsigned end = i + halo + 1 < count ? i + halo + 1 : count;
+
+			/* join the runs with overlapping halo */
+			if (run_flag && begin < run_end + halo) {
+				run_end = end;
+			} else {
+				if (run_flag) {
+					if (band)
+						result += video_band_segment(pipeline, band, x, y, src, &run_pos, run_begin, run_end);
+					else
+						result += run_end - run_begin;
+				}
+				run_begin = begin;
+				run_end = end;
+				run_flag = 1;
+			}
+		}
+	}
+
+	if (run_flag) {
+		if (band)
+			result += video_band_segment(pipeline, band, x, y, src, &run_pos, run_begin, run_end);
+		else
+			result += run_end - run_begin;
+	}
+
+	return result;
+}
+
+unsigned video_pipeline_blit_change(const struct video_pipeline_struct* pipeline, unsigned dst_x, unsigned dst_y, const void* src, const unsigned char* change_map)
+{
+	const struct video_stage_vert_struct* stage_vert = video_pipeline_vert(pipeline);
+	unsigned count;
+
+	/* without the band for the partial blit, or if the halo covers */
+	/* everything, the whole image is written */
+	if (pipeline->band_max == 0 || 2 * stage_vert->halo + 1 >= stage_vert->slice.count) {
+		video_pipeline_blit(pipeline, dst_x, dst_y, src);
+		return stage_vert->ddy;
+	}
+
+	count = video_pipeline_change_scan(pipeline, 0, dst_x, dst_y, src, change_map);
+
+	if (count == 0)
+		return 0;
+
+	/* the partial blit is done in a single band, prefer the parallel */
+	/* complete blit if the most of the image changed */
+	if (count == stage_vert->slice.count
+		|| (pipeline->band_mac != 0 && the_blit_parallelize != 0 && 2 * count > stage_vert->slice.count)
+	) {
+		video_pipeline_blit(pipeline, dst_x, dst_y, src);
+		return stage_vert->ddy;
+	}
+
+	count = video_pipeline_change_scan(pipeline, &pipeline->band_map[0], dst_x, dst_y, src, change_map);
+
+	/* restore the SSE2 micro state */
+	internal_end();
+
+	return count;
 }
 
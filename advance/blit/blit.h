@@ -109,6 +109,8 @@ enum video_stage_enum {
 	pipe_bgr888tobgra8888, /**< RGB conversion 888 (bgr) -\> 8888 (bgra). */
 	pipe_rgbtorgb, /**< Generic RGB conversion. */
 	pipe_rgbtoyuy2, /**< Generic YUY2 conversion. */
+	pipe_palette_stretch, /**< Palette conversion and horizontal stretch in a single pass. */
+	pipe_fuse, /**< Sequence of horizontal stages run in blocks, without a full row buffer between them. */
 	pipe_y_copy, /**< Vertical copy. */
 	pipe_y_mean, /**< Vertical mean. */
 	pipe_y_filter, /**< Vertical FIR filter. */
@@ -188,6 +190,11 @@ struct __attribute__((aligned(8))) video_stage_horz_struct {
 
 	adv_slice slice; /**< Slice used in streching. */
 	const void* palette; /**< Palette used in conversion. The palette size depends on the conversion. */
+
+	/* fuse */
+	const struct video_stage_horz_struct* fuse_begin; /**< First stage fused in a ::pipe_fuse stage. */
+	const struct video_stage_horz_struct* fuse_end; /**< End of the stages fused in a ::pipe_fuse stage. */
+	unsigned fuse_block; /**< Number of source pixels processed by every block of a ::pipe_fuse stage. */
 };
 
 /** \name Effects */
@@ -230,6 +237,8 @@ struct __attribute__((aligned(8))) video_stage_horz_struct {
 /*@}*/
 
 struct video_stage_vert_struct;
+struct video_buffer_struct;
+struct video_band_struct;
 
 /**
  * Pipeline target.
@@ -240,6 +249,7 @@ struct video_pipeline_target_struct {
 	adv_color_def color_def;
 	unsigned bytes_per_pixel;
 	unsigned bytes_per_scanline;
+	struct video_buffer_struct* buffer; /**< Temporary buffers. If 0 the global ones are used. */
 };
 
 /**
@@ -271,6 +281,9 @@ struct __attribute__((aligned(8))) video_stage_vert_struct {
 	/* stretch slice */
 	adv_slice slice;
 
+	unsigned line_base; /**< Number of the first row passed to the horizontal stages. */
+	unsigned halo; /**< Number of source rows read above and below every row. */
+
 	/* pipeline */
 	const struct video_stage_horz_struct* stage_begin;
 	const struct video_stage_horz_struct* stage_end;
@@ -305,6 +318,11 @@ struct __attribute__((aligned(8))) video_pipeline_struct {
 	struct video_stage_vert_struct stage_vert; /**< Vertical stage. */
 	unsigned stage_mac; /**< Number of horizontal stages. */
 	struct video_pipeline_target_struct target; /**< Target of the pipeline. */
+	struct video_band_struct* band_map; /**< Bands for the parallel execution. */
+	unsigned band_mac; /**< Number of bands, 0 if the pipeline isn't split. */
+	unsigned band_max; /**< Number of allocated bands. */
+	struct video_stage_horz_struct fuse_map[VIDEO_STAGE_MAX]; /**< Horizontal stages merged in a ::pipe_fuse stage. */
+	unsigned fuse_mac; /**< Number of merged stages. */
 };
 
 /**
@@ -366,8 +384,95 @@ static inline const struct video_stage_horz_struct* video_pipeline_pivot(const s
 /***************************************************************************/
 /* blit */
 
+/**
+ * Instruction set levels of the blit functions.
+ * Every blit function is used at the highest level available not greater
+ * than the selected one.
+ */
+enum video_blit_level_enum {
+	VIDEO_BLIT_LEVEL_AUTO = -1, /**< Best level supported by the processor. */
+	VIDEO_BLIT_LEVEL_C = 0, /**< Generic C implementation. */
+	VIDEO_BLIT_LEVEL_SSE2 = 1, /**< SSE2 instructions. On x86 32 bits the MMX/SSE2 assembler. */
+	VIDEO_BLIT_LEVEL_SSSE3 = 2, /**< SSSE3 instructions. */
+	VIDEO_BLIT_LEVEL_SSE41 = 3, /**< SSE4.1 instructions. */
+	VIDEO_BLIT_LEVEL_AVX2 = 4 /**< AVX2 instructions. */
+};
+
+#define VIDEO_BLIT_LEVEL_MAX 5 /**< Number of levels. */
+
+/**
+ * Force the instruction set level of the blit functions.
+ * It must be called before video_blit_init(). A level greater than the one
+ * supported by the processor is ignored.
+ * \param level One of the ::video_blit_level_enum values.
+ */
+void video_blit_level_set(int level);
+
+/**
+ * Get the instruction set level selected by video_blit_init().
+ */
+unsigned video_blit_level_get(void);
+
+/**
+ * Get the name of a instruction set level.
+ */
+const char* video_blit_level_name(unsigned level);
+
+/**
+ * Max number of bands in which a blit can be split.
+ */
+#define VIDEO_BAND_MAX 16
+
+/**
+ * Function used to run the bands of a blit.
+ * It must call func(arg, num, max) for every num from 0 to max - 1, and
+ * return only when all the calls are completed. The calls may be done in
+ * parallel from different threads, and max may be reduced.
+ * The osd_parallelize() function has this interface.
+ */
+typedef void video_blit_parallelize_func(void (*func)(void* arg, int num, int max), void* arg, int max);
+
+/**
+ * Split the blits in horizontal bands executed in parallel.
+ * It affects only the pipelines created after the call.
+ * Every band computes also the few source rows around its edges read by the
+ * effects like scale2x, hq2x and xbr.
+ * \param parallelize Function used to run the bands. Use 0 to disable the bands.
+ * \param band_max Max number of bands. It's limited to VIDEO_BAND_MAX.
+ */
+void video_blit_band_set(video_blit_parallelize_func* parallelize, unsigned band_max);
+
+/**
+ * Enable or disable the fusion of the horizontal stages.
+ * When enabled, chains of stages like a palette conversion followed by a stretch,
+ * or a color conversion followed by a double and by a rgb effect, are merged
+ * in a single stage, which doesn't store the intermediate rows in memory.
+ * It affects only the pipelines created after the call.
+ * By default it's enabled.
+ */
+void video_blit_fuse_set(adv_bool enable);
+
+/**
+ * Enable or disable the partial blits with video_pipeline_blit_change().
+ * When enabled, every pipeline gets the band used to write only a part of the image.
+ * It affects only the pipelines created after the call.
+ * By default it's disabled.
+ */
+void video_blit_change_set(adv_bool enable);
+
+/**
+ * Enable or disable the transpose of the source of the rotated games.
+ * When enabled, the source rows read by columns are first transposed in
+ * strips in a buffer, and the pipeline reads the buffer as a plain image.
+ * It affects only the pipelines created after the call.
+ * By default it's enabled.
+ */
+void video_blit_rotate_set(adv_bool enable);
+
 /**
  * Initialize the blit system.
+ * It detects the processor capabilities and selects the version of
+ * every blit function to use.
  */
 adv_error video_blit_init(void);
 
@@ -412,6 +517,21 @@ void video_pipeline_palette16(struct video_pipeline_struct* pipeline, unsigned d
  */
 void video_pipeline_blit(const struct video_pipeline_struct* pipeline, unsigned dst_x, unsigned dst_y, const void* src);
 
+/**
+ * Blit using a precomputed pipeline, writing only the rows affected by some changed source rows.
+ * The target rows read by the vertical stage from a changed source row, also
+ * as neighbor row of an effect, are written. The others are left untouched,
+ * and they must already contain the result of the same source rows.
+ * If the partial blits are disabled with video_blit_change_set(), all the rows are written.
+ * \param pipeline Pipeline to use.
+ * \param dst_x Destination x.
+ * \param dst_y Destination y.
+ * \param src Source data.
+ * \param change_map Vector with one element for every source row, not 0 if the row changed.
+ * \return Number of target rows written.
+ */
+unsigned video_pipeline_blit_change(const struct video_pipeline_struct* pipeline, unsigned dst_x, unsigned dst_y, const void* src, const unsigned char* change_map);
+
 /***************************************************************************/
 /* blit */
 
@@ -37,5 +37,23 @@ void hq2x3_16_def(interp_uint16* dst0, interp_uint16* dst1, interp_uint16* dst2,
 void hq2x3_32_def(interp_uint32* dst0, interp_uint32* dst1, interp_uint32* dst2, const interp_uint32* src0, const interp_uint32* src1, const interp_uint32* src2, unsigned count);
 void hq2x3_yuy2_def(interp_uint32* dst0, interp_uint32* dst1, interp_uint32* dst2, const interp_uint32* src0, const interp_uint32* src1, const interp_uint32* src2, unsigned count);
 
+#if defined(USE_ASM_INLINE)
+/* No assembler version, use the C one */
+#define hq2x3_16_asm hq2x3_16_def
+#define hq2x3_32_asm hq2x3_32_def
+#define hq2x3_yuy2_asm hq2x3_yuy2_def
+#endif
+
+#if defined(USE_ASM_INTRINSIC)
+void hq2x3_16_sse2(interp_uint16* dst0, interp_uint16* dst1, interp_uint16* dst2, const interp_uint16* src0, const interp_uint16* src1, const interp_uint16* src2, unsigned count);
+void hq2x3_32_sse2(interp_uint32* dst0, interp_uint32* dst1, interp_uint32* dst2, const interp_uint32* src0, const interp_uint32* src1, const interp_uint32* src2, unsigned count);
+/* No vector version for yuy2, use the C one */
+#define hq2x3_yuy2_sse2 hq2x3_yuy2_def
+
+void hq2x3_16_avx2(interp_uint16* dst0, interp_uint16* dst1, interp_uint16* dst2, const interp_uint16* src0, const interp_uint16* src1, const interp_uint16* src2, unsigned count);
+void hq2x3_32_avx2(interp_uint32* dst0, interp_uint32* dst1, interp_uint32* dst2, const interp_uint32* src0, const interp_uint32* src1, const interp_uint32* src2, unsigned count);
+#define hq2x3_yuy2_avx2 hq2x3_yuy2_def
+#endif
+
 #endif
 
@@ -34,6 +34,12 @@
 
 #include <assert.h>
 
+#if defined(USE_ASM_INTRINSIC)
+#include <immintrin.h>
+
+#define HQ2X4_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
 /***************************************************************************/
 /* HQ2x4 C implementation */
 
@@ -41,11 +47,17 @@
  * This effect is derived from the hq4x effect made by Maxim Stepin
  */
 
-void hq2x4_16_def(interp_uint16* restrict dst0, interp_uint16* restrict dst1, interp_uint16* restrict dst2, interp_uint16* restrict dst3, const interp_uint16* restrict src0, const interp_uint16* restrict src1, const interp_uint16* restrict src2, unsigned count)
+static inline void hq2x4_16_def_range(interp_uint16* restrict dst0, interp_uint16* restrict dst1, interp_uint16* restrict dst2, interp_uint16* restrict dst3, const interp_uint16* restrict src0, const interp_uint16* restrict src1, const interp_uint16* restrict src2, unsigned i, unsigned end, unsigned count)
 {
-	unsigned i;
-
-	for (i = 0; i < count; ++i) {
+	src0 += i;
+	src1 += i;
+	src2 += i;
+	dst0 += 2 * i;
+	dst1 += 2 * i;
+	dst2 += 2 * i;
+	dst3 += 2 * i;
+
+	for (; i < end; ++i) {
 		unsigned char mask;
 
 		interp_uint16 c[9];
@@ -125,11 +137,22 @@ void hq2x4_16_def(interp_uint16* restrict dst0, interp_uint16* restrict dst1, in
 	}
 }
 
-void hq2x4_32_def(interp_uint32* restrict dst0, interp_uint32* restrict dst1, interp_uint32* restrict dst2, interp_uint32* restrict dst3, const interp_uint32* restrict src0, const interp_uint32* restrict src1, const interp_uint32* restrict src2, unsigned count)
+void hq2x4_16_def(interp_uint16* restrict dst0, interp_uint16* restrict dst1, interp_uint16* restrict dst2, interp_uint16* restrict dst3, const interp_uint16* restrict src0, const interp_uint16* restrict src1, const interp_uint16* restrict src2, unsigned count)
 {
-	unsigned i;
+	hq2x4_16_def_range(dst0, dst1, dst2, dst3, src0, src1, src2, 0, count, count);
+}
 
-	for (i = 0; i < count; ++i) {
+static inline void hq2x4_32_def_range(interp_uint32* restrict dst0, interp_uint32* restrict dst1, interp_uint32* restrict dst2, interp_uint32* restrict dst3, const interp_uint32* restrict src0, const interp_uint32* restrict src1, const interp_uint32* restrict src2, unsigned i, unsigned end, unsigned count)
+{
+	src0 += i;
+	src1 += i;
+	src2 += i;
+	dst0 += 2 * i;
+	dst1 += 2 * i;
+	dst2 += 2 * i;
+	dst3 += 2 * i;
+
+	for (; i < end; ++i) {
 		unsigned char mask;
 
 		interp_uint32 c[9];
@@ -209,11 +232,22 @@ void hq2x4_32_def(interp_uint32* restrict dst0, interp_uint32* restrict dst1, in
 	}
 }
 
-void hq2x4_yuy2_def(interp_uint32* restrict dst0, interp_uint32* restrict dst1, interp_uint32* restrict dst2, interp_uint32* restrict dst3, const interp_uint32* restrict src0, const interp_uint32* restrict src1, const interp_uint32* restrict src2, unsigned count)
+void hq2x4_32_def(interp_uint32* restrict dst0, interp_uint32* restrict dst1, interp_uint32* restrict dst2, interp_uint32* restrict dst3, const interp_uint32* restrict src0, const interp_uint32* restrict src1, const interp_uint32* restrict src2, unsigned count)
 {
-	unsigned i;
+	hq2x4_32_def_range(dst0, dst1, dst2, dst3, src0, src1, src2, 0, count, count);
+}
 
-	for (i = 0; i < count; ++i) {
+static inline void hq2x4_yuy2_def_range(interp_uint32* restrict dst0, interp_uint32* restrict dst1, interp_uint32* restrict dst2, interp_uint32* restrict dst3, const interp_uint32* restrict src0, const interp_uint32* restrict src1, const interp_uint32* restrict src2, unsigned i, unsigned end, unsigned count)
+{
+	src0 += i;
+	src1 += i;
+	src2 += i;
+	dst0 += 2 * i;
+	dst1 += 2 * i;
+	dst2 += 2 * i;
+	dst3 += 2 * i;
+
+	for (; i < end; ++i) {
 		unsigned char mask;
 
 		interp_uint32 c[9];
@@ -293,3 +327,487 @@ void hq2x4_yuy2_def(interp_uint32* restrict dst0, interp_uint32* restrict dst1,
 	}
 }
 
+void hq2x4_yuy2_def(interp_uint32* restrict dst0, interp_uint32* restrict dst1, interp_uint32* restrict dst2, interp_uint32* restrict dst3, const interp_uint32* restrict src0, const interp_uint32* restrict src1, const interp_uint32* restrict src2, unsigned count)
+{
+	hq2x4_yuy2_def_range(dst0, dst1, dst2, dst3, src0, src1, src2, 0, count, count);
+}
+
+/***************************************************************************/
+/* HQ2x4 SSE2/AVX2 intrinsic implementation */
+
+#if defined(USE_ASM_INTRINSIC)
+
+/*
+ * The vector versions compute the masks of a whole vector of pixels at a
+ * time, comparing all the eight neighbours, and the four edges used by
+ * the MUR, MDR, MDL and MUL conditions, with the vector interp diff.
+ * If all the neighbours are equal at the center, the mask is zero
+ * without computing it.
+ * If all the pixels have the same mask, the pixels are computed together
+ * with the vector interp functions. Otherwise every pixel is computed
+ * with the precomputed mask. The first and last pixels use the
+ * C implementation. The results are the same of the C implementation.
+ */
+
+static inline void hq2x4_16_blend(interp_uint16* restrict dst0, interp_uint16* restrict dst1, interp_uint16* restrict dst2, interp_uint16* restrict dst3, const interp_uint16* restrict c, unsigned mask, unsigned edge)
+{
+#define P(a, b) dst ## b[a]
+#define MUR (edge & 1)
+#define MDR (edge & 2)
+#define MDL (edge & 4)
+#define MUL (edge & 8)
+#define I1(p0) c[p0]
+#define I2(i0, i1, p0, p1) interp_16_ ## i0 ## i1(c[p0], c[p1])
+#define I3(i0, i1, i2, p0, p1, p2) interp_16_ ## i0 ## i1 ## i2(c[p0], c[p1], c[p2])
+
+	switch (mask) {
+#include "hq2x4.dat"
+	}
+
+#undef P
+#undef MUR
+#undef MDR
+#undef MDL
+#undef MUL
+#undef I1
+#undef I2
+#undef I3
+}
+
+static inline void hq2x4_32_blend(interp_uint32* restrict dst0, interp_uint32* restrict dst1, interp_uint32* restrict dst2, interp_uint32* restrict dst3, const interp_uint32* restrict c, unsigned mask, unsigned edge)
+{
+#define P(a, b) dst ## b[a]
+#define MUR (edge & 1)
+#define MDR (edge & 2)
+#define MDL (edge & 4)
+#define MUL (edge & 8)
+#define I1(p0) c[p0]
+#define I2(i0, i1, p0, p1) interp_32_ ## i0 ## i1(c[p0], c[p1])
+#define I3(i0, i1, i2, p0, p1, p2) interp_32_ ## i0 ## i1 ## i2(c[p0], c[p1], c[p2])
+
+	switch (mask) {
+#include "hq2x4.dat"
+	}
+
+#undef P
+#undef MUR
+#undef MDR
+#undef MDL
+#undef MUL
+#undef I1
+#undef I2
+#undef I3
+}
+
+static void hq2x4_sse2_blend(__m128i* o, const __m128i* c, const struct interp_sse2_struct* k, unsigned mask, unsigned edge)
+{
+#define P(a, b) o[(b) * 2 + (a)]
+#define MUR (edge & 1)
+#define MDR (edge & 2)
+#define MDL (edge & 4)
+#define MUL (edge & 8)
+#define I1(p0) c[p0]
+#define I2(i0, i1, p0, p1) interp_sse2_ ## i0 ## i1(k, c[p0], c[p1])
+#define I3(i0, i1, i2, p0, p1, p2) interp_sse2_ ## i0 ## i1 ## i2(k, c[p0], c[p1], c[p2])
+
+	switch (mask) {
+#include "hq2x4.dat"
+	}
+
+#undef P
+#undef MUR
+#undef MDR
+#undef MDL
+#undef MUL
+#undef I1
+#undef I2
+#undef I3
+}
+
+static HQ2X4_TARGET_AVX2 void hq2x4_avx2_blend(__m256i* o, const __m256i* c, const struct interp_avx2_struct* k, unsigned mask, unsigned edge)
+{
+#define P(a, b) o[(b) * 2 + (a)]
+#define MUR (edge & 1)
+#define MDR (edge & 2)
+#define MDL (edge & 4)
+#define MUL (edge & 8)
+#define I1(p0) c[p0]
+#define I2(i0, i1, p0, p1) interp_avx2_ ## i0 ## i1(k, c[p0], c[p1])
+#define I3(i0, i1, i2, p0, p1, p2) interp_avx2_ ## i0 ## i1 ## i2(k, c[p0], c[p1], c[p2])
+
+	switch (mask) {
+#include "hq2x4.dat"
+	}
+
+#undef P
+#undef MUR
+#undef MDR
+#undef MDL
+#undef MUL
+#undef I1
+#undef I2
+#undef I3
+}
+
+/**
+ * Scale a row of pixels with the HQ2x4 effect.
+ * This function operates like hq2x4_16_def() but it uses the SSE2
+ * instruction set.
+ */
+void hq2x4_16_sse2(interp_uint16* dst0, interp_uint16* dst1, interp_uint16* dst2, interp_uint16* dst3, const interp_uint16* src0, const interp_uint16* src1, const interp_uint16* src2, unsigned count)
+{
+	unsigned i = 0;
+
+	if (count > 4 + 1) {
+		struct interp_sse2_struct k;
+
+		interp_16_sse2_set(&k);
+
+		/* first pixel */
+		hq2x4_16_def_range(dst0, dst1, dst2, dst3, src0, src1, src2, 0, 1, count);
+
+		/* central pixels */
+		for (i = 1; i + 4 < count; i += 4) {
+			__m128i c[9];
+			__m128i o[8];
+			__m128i m;
+			unsigned j;
+			__m128i z = _mm_setzero_si128();
+
+			c[0] = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(src0 + i - 1)), z);
+			c[1] = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(src0 + i)), z);
+			c[2] = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(src0 + i + 1)), z);
+			c[3] = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(src1 + i - 1)), z);
+			c[4] = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(src1 + i)), z);
+			c[5] = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(src1 + i + 1)), z);
+			c[6] = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(src2 + i - 1)), z);
+			c[7] = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(src2 + i)), z);
+			c[8] = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(src2 + i + 1)), z);
+
+			/* all the neighbours equal at the center have a zero mask */
+			m = _mm_and_si128(_mm_and_si128(_mm_cmpeq_epi32(c[0], c[4]), _mm_cmpeq_epi32(c[1], c[4])), _mm_and_si128(_mm_cmpeq_epi32(c[2], c[4]), _mm_cmpeq_epi32(c[3], c[4])));
+			m = _mm_and_si128(m, _mm_and_si128(_mm_and_si128(_mm_cmpeq_epi32(c[5], c[4]), _mm_cmpeq_epi32(c[6], c[4])), _mm_and_si128(_mm_cmpeq_epi32(c[7], c[4]), _mm_cmpeq_epi32(c[8], c[4]))));
+			if (_mm_movemask_epi8(m) == 0xFFFF) {
+				hq2x4_sse2_blend(o, c, &k, 0, 0);
+			} else {
+				/* masks of the neighbours, and of the edges in the bits 8-11 */
+				m = _mm_and_si128(interp_16_sse2_diff(&k, c[0], c[4]), _mm_set1_epi32(1 << 0));
+				m = _mm_or_si128(m, _mm_and_si128(interp_16_sse2_diff(&k, c[1], c[4]), _mm_set1_epi32(1 << 1)));
+				m = _mm_or_si128(m, _mm_and_si128(interp_16_sse2_diff(&k, c[2], c[4]), _mm_set1_epi32(1 << 2)));
+				m = _mm_or_si128(m, _mm_and_si128(interp_16_sse2_diff(&k, c[3], c[4]), _mm_set1_epi32(1 << 3)));
+				m = _mm_or_si128(m, _mm_and_si128(interp_16_sse2_diff(&k, c[5], c[4]), _mm_set1_epi32(1 << 4)));
+				m = _mm_or_si128(m, _mm_and_si128(interp_16_sse2_diff(&k, c[6], c[4]), _mm_set1_epi32(1 << 5)));
+				m = _mm_or_si128(m, _mm_and_si128(interp_16_sse2_diff(&k, c[7], c[4]), _mm_set1_epi32(1 << 6)));
+				m = _mm_or_si128(m, _mm_and_si128(interp_16_sse2_diff(&k, c[8], c[4]), _mm_set1_epi32(1 << 7)));
+				m = _mm_or_si128(m, _mm_and_si128(interp_16_sse2_diff(&k, c[1], c[5]), _mm_set1_epi32(1 << 8)));
+				m = _mm_or_si128(m, _mm_and_si128(interp_16_sse2_diff(&k, c[5], c[7]), _mm_set1_epi32(1 << 9)));
+				m = _mm_or_si128(m, _mm_and_si128(interp_16_sse2_diff(&k, c[7], c[3]), _mm_set1_epi32(1 << 10)));
+				m = _mm_or_si128(m, _mm_and_si128(interp_16_sse2_diff(&k, c[3], c[1]), _mm_set1_epi32(1 << 11)));
+
+				if (_mm_movemask_epi8(_mm_cmpeq_epi32(m, _mm_shuffle_epi32(m, 0))) == 0xFFFF) {
+					/* all the pixels with the same mask */
+					unsigned mask = _mm_cvtsi128_si32(m);
+
+					hq2x4_sse2_blend(o, c, &k, mask & 0xFF, mask >> 8);
+				} else {
+					/* every pixel with its mask */
+					interp_uint32 v[9][4];
+					interp_uint32 vm[4];
+					interp_uint16 e[9];
+					unsigned l;
+
+					for (l = 0; l < 9; ++l)
+						_mm_storeu_si128((__m128i*)v[l], c[l]);
+					_mm_storeu_si128((__m128i*)vm, m);
+
+					for (j = 0; j < 4; ++j) {
+						for (l = 0; l < 9; ++l)
+							e[l] = v[l][j];
+						hq2x4_16_blend(dst0 + 2 * (i + j), dst1 + 2 * (i + j), dst2 + 2 * (i + j), dst3 + 2 * (i + j), e, vm[j] & 0xFF, vm[j] >> 8);
+					}
+					continue;
+				}
+			}
+
+			interp_16_sse2_store(dst0 + 2 * i, o + 0, 2);
+			interp_16_sse2_store(dst1 + 2 * i, o + 2, 2);
+			interp_16_sse2_store(dst2 + 2 * i, o + 4, 2);
+			interp_16_sse2_store(dst3 + 2 * i, o + 6, 2);
+		}
+	}
+
+	/* remaining pixels */
+	hq2x4_16_def_range(dst0, dst1, dst2, dst3, src0, src1, src2, i, count, count);
+}
+
+/**
+ * Scale a row of pixels with the HQ2x4 effect.
+ * This function operates like hq2x4_32_def() but it uses the SSE2
+ * instruction set.
+ */
+void hq2x4_32_sse2(interp_uint32* dst0, interp_uint32* dst1, interp_uint32* dst2, interp_uint32* dst3, const interp_uint32* src0, const interp_uint32* src1, const interp_uint32* src2, unsigned count)
+{
+	unsigned i = 0;
+
+	if (count > 4 + 1) {
+		struct interp_sse2_struct k;
+
+		interp_32_sse2_set(&k);
+
+		/* first pixel */
+		hq2x4_32_def_range(dst0, dst1, dst2, dst3, src0, src1, src2, 0, 1, count);
+
+		/* central pixels */
+		for (i = 1; i + 4 < count; i += 4) {
+			__m128i c[9];
+			__m128i o[8];
+			__m128i m;
+			unsigned j;
+
+			c[0] = _mm_loadu_si128((const __m128i*)(src0 + i - 1));
+			c[1] = _mm_loadu_si128((const __m128i*)(src0 + i));
+			c[2] = _mm_loadu_si128((const __m128i*)(src0 + i + 1));
+			c[3] = _mm_loadu_si128((const __m128i*)(src1 + i - 1));
+			c[4] = _mm_loadu_si128((const __m128i*)(src1 + i));
+			c[5] = _mm_loadu_si128((const __m128i*)(src1 + i + 1));
+			c[6] = _mm_loadu_si128((const __m128i*)(src2 + i - 1));
+			c[7] = _mm_loadu_si128((const __m128i*)(src2 + i));
+			c[8] = _mm_loadu_si128((const __m128i*)(src2 + i + 1));
+
+			/* all the neighbours equal at the center have a zero mask */
+			m = _mm_and_si128(_mm_and_si128(_mm_cmpeq_epi32(c[0], c[4]), _mm_cmpeq_epi32(c[1], c[4])), _mm_and_si128(_mm_cmpeq_epi32(c[2], c[4]), _mm_cmpeq_epi32(c[3], c[4])));
+			m = _mm_and_si128(m, _mm_and_si128(_mm_and_si128(_mm_cmpeq_epi32(c[5], c[4]), _mm_cmpeq_epi32(c[6], c[4])), _mm_and_si128(_mm_cmpeq_epi32(c[7], c[4]), _mm_cmpeq_epi32(c[8], c[4]))));
+			if (_mm_movemask_epi8(m) == 0xFFFF) {
+				hq2x4_sse2_blend(o, c, &k, 0, 0);
+			} else {
+				/* masks of the neighbours, and of the edges in the bits 8-11 */
+				m = _mm_and_si128(interp_32_sse2_diff(&k, c[0], c[4]), _mm_set1_epi32(1 << 0));
+				m = _mm_or_si128(m, _mm_and_si128(interp_32_sse2_diff(&k, c[1], c[4]), _mm_set1_epi32(1 << 1)));
+				m = _mm_or_si128(m, _mm_and_si128(interp_32_sse2_diff(&k, c[2], c[4]), _mm_set1_epi32(1 << 2)));
+				m = _mm_or_si128(m, _mm_and_si128(interp_32_sse2_diff(&k, c[3], c[4]), _mm_set1_epi32(1 << 3)));
+				m = _mm_or_si128(m, _mm_and_si128(interp_32_sse2_diff(&k, c[5], c[4]), _mm_set1_epi32(1 << 4)));
+				m = _mm_or_si128(m, _mm_and_si128(interp_32_sse2_diff(&k, c[6], c[4]), _mm_set1_epi32(1 << 5)));
+				m = _mm_or_si128(m, _mm_and_si128(interp_32_sse2_diff(&k, c[7], c[4]), _mm_set1_epi32(1 << 6)));
+				m = _mm_or_si128(m, _mm_and_si128(interp_32_sse2_diff(&k, c[8], c[4]), _mm_set1_epi32(1 << 7)));
+				m = _mm_or_si128(m, _mm_and_si128(interp_32_sse2_diff(&k, c[1], c[5]), _mm_set1_epi32(1 << 8)));
+				m = _mm_or_si128(m, _mm_and_si128(interp_32_sse2_diff(&k, c[5], c[7]), _mm_set1_epi32(1 << 9)));
+				m = _mm_or_si128(m, _mm_and_si128(interp_32_sse2_diff(&k, c[7], c[3]), _mm_set1_epi32(1 << 10)));
+				m = _mm_or_si128(m, _mm_and_si128(interp_32_sse2_diff(&k, c[3], c[1]), _mm_set1_epi32(1 << 11)));
+
+				if (_mm_movemask_epi8(_mm_cmpeq_epi32(m, _mm_shuffle_epi32(m, 0))) == 0xFFFF) {
+					/* all the pixels with the same mask */
+					unsigned mask = _mm_cvtsi128_si32(m);
+
+					hq2x4_sse2_blend(o, c, &k, mask & 0xFF, mask >> 8);
+				} else {
+					/* every pixel with its mask */
+					interp_uint32 v[9][4];
+					interp_uint32 vm[4];
+					interp_uint32 e[9];
+					unsigned l;
+
+					for (l = 0; l < 9; ++l)
+						_mm_storeu_si128((__m128i*)v[l], c[l]);
+					_mm_storeu_si128((__m128i*)vm, m);
+
+					for (j = 0; j < 4; ++j) {
+						for (l = 0; l < 9; ++l)
+							e[l] = v[l][j];
+						hq2x4_32_blend(dst0 + 2 * (i + j), dst1 + 2 * (i + j), dst2 + 2 * (i + j), dst3 + 2 * (i + j), e, vm[j] & 0xFF, vm[j] >> 8);
+					}
+					continue;
+				}
+			}
+
+			interp_32_sse2_store(dst0 + 2 * i, o + 0, 2);
+			interp_32_sse2_store(dst1 + 2 * i, o + 2, 2);
+			interp_32_sse2_store(dst2 + 2 * i, o + 4, 2);
+			interp_32_sse2_store(dst3 + 2 * i, o + 6, 2);
+		}
+	}
+
+	/* remaining pixels */
+	hq2x4_32_def_range(dst0, dst1, dst2, dst3, src0, src1, src2, i, count, count);
+}
+
+/**
+ * Scale a row of pixels with the HQ2x4 effect.
+ * This function operates like hq2x4_16_def() but it uses the AVX2
+ * instruction set. It must be called only if the processor supports it.
+ */
+HQ2X4_TARGET_AVX2 void hq2x4_16_avx2(interp_uint16* dst0, interp_uint16* dst1, interp_uint16* dst2, interp_uint16* dst3, const interp_uint16* src0, const interp_uint16* src1, const interp_uint16* src2, unsigned count)
+{
+	unsigned i = 0;
+
+	if (count > 8 + 1) {
+		struct interp_avx2_struct k;
+
+		interp_16_avx2_set(&k);
+
+		/* first pixel */
+		hq2x4_16_def_range(dst0, dst1, dst2, dst3, src0, src1, src2, 0, 1, count);
+
+		/* central pixels */
+		for (i = 1; i + 8 < count; i += 8) {
+			__m256i c[9];
+			__m256i o[8];
+			__m256i m;
+			unsigned j;
+
+			c[0] = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src0 + i - 1)));
+			c[1] = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src0 + i)));
+			c[2] = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src0 + i + 1)));
+			c[3] = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src1 + i - 1)));
+			c[4] = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src1 + i)));
+			c[5] = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src1 + i + 1)));
+			c[6] = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src2 + i - 1)));
+			c[7] = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src2 + i)));
+			c[8] = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src2 + i + 1)));
+
+			/* all the neighbours equal at the center have a zero mask */
+			m = _mm256_and_si256(_mm256_and_si256(_mm256_cmpeq_epi32(c[0], c[4]), _mm256_cmpeq_epi32(c[1], c[4])), _mm256_and_si256(_mm256_cmpeq_epi32(c[2], c[4]), _mm256_cmpeq_epi32(c[3], c[4])));
+			m = _mm256_and_si256(m, _mm256_and_si256(_mm256_and_si256(_mm256_cmpeq_epi32(c[5], c[4]), _mm256_cmpeq_epi32(c[6], c[4])), _mm256_and_si256(_mm256_cmpeq_epi32(c[7], c[4]), _mm256_cmpeq_epi32(c[8], c[4]))));
+			if ((unsigned)_mm256_movemask_epi8(m) == 0xFFFFFFFF) {
+				hq2x4_avx2_blend(o, c, &k, 0, 0);
+			} else {
+				/* masks of the neighbours, and of the edges in the bits 8-11 */
+				m = _mm256_and_si256(interp_16_avx2_diff(&k, c[0], c[4]), _mm256_set1_epi32(1 << 0));
+				m = _mm256_or_si256(m, _mm256_and_si256(interp_16_avx2_diff(&k, c[1], c[4]), _mm256_set1_epi32(1 << 1)));
+				m = _mm256_or_si256(m, _mm256_and_si256(interp_16_avx2_diff(&k, c[2], c[4]), _mm256_set1_epi32(1 << 2)));
+				m = _mm256_or_si256(m, _mm256_and_si256(interp_16_avx2_diff(&k, c[3], c[4]), _mm256_set1_epi32(1 << 3)));
+				m = _mm256_or_si256(m, _mm256_and_si256(interp_16_avx2_diff(&k, c[5], c[4]), _mm256_set1_epi32(1 << 4)));
+				m = _mm256_or_si256(m, _mm256_and_si256(interp_16_avx2_diff(&k, c[6], c[4]), _mm256_set1_epi32(1 << 5)));
+				m = _mm256_or_si256(m, _mm256_and_si256(interp_16_avx2_diff(&k, c[7], c[4]), _mm256_set1_epi32(1 << 6)));
+				m = _mm256_or_si256(m, _mm256_and_si256(interp_16_avx2_diff(&k, c[8], c[4]), _mm256_set1_epi32(1 << 7)));
+				m = _mm256_or_si256(m, _mm256_and_si256(interp_16_avx2_diff(&k, c[1], c[5]), _mm256_set1_epi32(1 << 8)));
+				m = _mm256_or_si256(m, _mm256_and_si256(interp_16_avx2_diff(&k, c[5], c[7]), _mm256_set1_epi32(1 << 9)));
+				m = _mm256_or_si256(m, _mm256_and_si256(interp_16_avx2_diff(&k, c[7], c[3]), _mm256_set1_epi32(1 << 10)));
+				m = _mm256_or_si256(m, _mm256_and_si256(interp_16_avx2_diff(&k, c[3], c[1]), _mm256_set1_epi32(1 << 11)));
+
+				if ((unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi32(m, _mm256_broadcastd_epi32(_mm256_castsi256_si128(m)))) == 0xFFFFFFFF) {
+					/* all the pixels with the same mask */
+					unsigned mask = _mm_cvtsi128_si32(_mm256_castsi256_si128(m));
+
+					hq2x4_avx2_blend(o, c, &k, mask & 0xFF, mask >> 8);
+				} else {
+					/* every pixel with its mask */
+					interp_uint32 v[9][8];
+					interp_uint32 vm[8];
+					interp_uint16 e[9];
+					unsigned l;
+
+					for (l = 0; l < 9; ++l)
+						_mm256_storeu_si256((__m256i*)v[l], c[l]);
+					_mm256_storeu_si256((__m256i*)vm, m);
+
+					for (j = 0; j < 8; ++j) {
+						for (l = 0; l < 9; ++l)
+							e[l] = v[l][j];
+						hq2x4_16_blend(dst0 + 2 * (i + j), dst1 + 2 * (i + j), dst2 + 2 * (i + j), dst3 + 2 * (i + j), e, vm[j] & 0xFF, vm[j] >> 8);
+					}
+					continue;
+				}
+			}
+
+			interp_16_avx2_store(dst0 + 2 * i, o + 0, 2);
+			interp_16_avx2_store(dst1 + 2 * i, o + 2, 2);
+			interp_16_avx2_store(dst2 + 2 * i, o + 4, 2);
+			interp_16_avx2_store(dst3 + 2 * i, o + 6, 2);
+		}
+	}
+
+	/* remaining pixels */
+	hq2x4_16_def_range(dst0, dst1, dst2, dst3, src0, src1, src2, i, count, count);
+}
+
+/**
+ * Scale a row of pixels with the HQ2x4 effect.
+ * This function operates like hq2x4_32_def() but it uses the AVX2
+ * instruction set. It must be called only if the processor supports it.
+ */
+HQ2X4_TARGET_AVX2 void hq2x4_32_avx2(interp_uint32* dst0, interp_uint32* dst1, interp_uint32* dst2, interp_uint32* dst3, const interp_uint32* src0, const interp_uint32* src1, const interp_uint32* src2, unsigned count)
+{
+	unsigned i = 0;
+
+	if (count > 8 + 1) {
+		struct interp_avx2_struct k;
+
+		interp_32_avx2_set(&k);
+
+		/* first pixel */
+		hq2x4_32_def_range(dst0, dst1, dst2, dst3, src0, src1, src2, 0, 1, count);
+
+		/* central pixels */
+		for (i = 1; i + 8 < count; i += 8) {
+			__m256i c[9];
+			__m256i o[8];
+			__m256i m;
+			unsigned j;
+
+			c[0] = _mm256_loadu_si256((const __m256i*)(src0 + i - 1));
+			c[1] = _mm256_loadu_si256((const __m256i*)(src0 + i));
+			c[2] = _mm256_loadu_si256((const __m256i*)(src0 + i + 1));
+			c[3] = _mm256_loadu_si256((const __m256i*)(src1 + i - 1));
+			c[4] = _mm256_loadu_si256((const __m256i*)(src1 + i));
+			c[5] = _mm256_loadu_si256((const __m256i*)(src1 + i + 1));
+			c[6] = _mm256_loadu_si256((const __m256i*)(src2 + i - 1));
+			c[7] = _mm256_loadu_si256((const __m256i*)(src2 + i));
+			c[8] = _mm256_loadu_si256((const __m256i*)(src2 + i + 1));
+
+			/* all the neighbours equal at the center have a zero mask */
+			m = _mm256_and_si256(_mm256_and_si256(_mm256_cmpeq_epi32(c[0], c[4]), _mm256_cmpeq_epi32(c[1], c[4])), _mm256_and_si256(_mm256_cmpeq_epi32(c[2], c[4]), _mm256_cmpeq_epi32(c[3], c[4])));
+			m = _mm256_and_si256(m, _mm256_and_si256(_mm256_and_si256(_mm256_cmpeq_epi32(c[5], c[4]), _mm256_cmpeq_epi32(c[6], c[4])), _mm256_and_si256(_mm256_cmpeq_epi32(c[7], c[4]), _mm256_cmpeq_epi32(c[8], c[4]))));
+			if ((unsigned)_mm256_movemask_epi8(m) == 0xFFFFFFFF) {
+				hq2x4_avx2_blend(o, c, &k, 0, 0);
+			} else {
+				/* masks of the neighbours, and of the edges in the bits 8-11 */
+				m = _mm256_and_si256(interp_32_avx2_diff(&k, c[0], c[4]), _mm256_set1_epi32(1 << 0));
+				m = _mm256_or_si256(m, _mm256_and_si256(interp_32_avx2_diff(&k, c[1], c[4]), _mm256_set1_epi32(1 << 1)));
+				m = _mm256_or_si256(m, _mm256_and_si256(interp_32_avx2_diff(&k, c[2], c[4]), _mm256_set1_epi32(1 << 2)));
+				m = _mm256_or_si256(m, _mm256_and_si256(interp_32_avx2_diff(&k, c[3], c[4]), _mm256_set1_epi32(1 << 3)));
+				m = _mm256_or_si256(m, _mm256_and_si256(interp_32_avx2_diff(&k, c[5], c[4]), _mm256_set1_epi32(1 << 4)));
+				m = _mm256_or_si256(m, _mm256_and_si256(interp_32_avx2_diff(&k, c[6], c[4]), _mm256_set1_epi32(1 << 5)));
+				m = _mm256_or_si256(m, _mm256_and_si256(interp_32_avx2_diff(&k, c[7], c[4]), _mm256_set1_epi32(1 << 6)));
+				m = _mm256_or_si256(m, _mm256_and_si256(interp_32_avx2_diff(&k, c[8], c[4]), _mm256_set1_epi32(1 << 7)));
+				m = _mm256_or_si256(m, _mm256_and_si256(interp_32_avx2_diff(&k, c[1], c[5]), _mm256_set1_epi32(1 << 8)));
+				m = _mm256_or_si256(m, _mm256_and_si256(interp_32_avx2_diff(&k, c[5], c[7]), _mm256_set1_epi32(1 << 9)));
+				m = _mm256_or_si256(m, _mm256_and_si256(interp_32_avx2_diff(&k, c[7], c[3]), _mm256_set1_epi32(1 << 10)));
+				m = _mm256_or_si256(m, _mm256_and_si256(interp_32_avx2_diff(&k, c[3], c[1]), _mm256_set1_epi32(1 << 11)));
+
+				if ((unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi32(m, _mm256_broadcastd_epi32(_mm256_castsi256_si128(m)))) == 0xFFFFFFFF) {
+					/* all the pixels with the same mask */
+					unsigned mask = _mm_cvtsi128_si32(_mm256_castsi256_si128(m));
+
+					hq2x4_avx2_blend(o, c, &k, mask & 0xFF, mask >> 8);
+				} else {
+					/* every pixel with its mask */
+					interp_uint32 v[9][8];
+					interp_uint32 vm[8];
+					interp_uint32 e[9];
+					unsigned l;
+
+					for (l = 0; l < 9; ++l)
+						_mm256_storeu_si256((__m256i*)v[l], c[l]);
+					_mm256_storeu_si256((__m256i*)vm, m);
+
+					for (j = 0; j < 8; ++j) {
+						for (l = 0; l < 9; ++l)
+							e[l] = v[l][j];
+						hq2x4_32_blend(dst0 + 2 * (i + j), dst1 + 2 * (i + j), dst2 + 2 * (i + j), dst3 + 2 * (i + j), e, vm[j] & 0xFF, vm[j] >> 8);
+					}
+					continue;
+				}
+			}
+
+			interp_32_avx2_store(dst0 + 2 * i, o + 0, 2);
+			interp_32_avx2_store(dst1 + 2 * i, o + 2, 2);
+			interp_32_avx2_store(dst2 + 2 * i, o + 4, 2);
+			interp_32_avx2_store(dst3 + 2 * i, o + 6, 2);
+		}
+	}
+
+	/* remaining pixels */
+	hq2x4_32_def_range(dst0, dst1, dst2, dst3, src0, src1, src2, i, count, count);
+}
+
+#endif
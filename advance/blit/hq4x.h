@@ -37,5 +37,23 @@ void hq4x_16_def(interp_uint16* dst0, interp_uint16* dst1, interp_uint16* dst2,
 void hq4x_32_def(interp_uint32* dst0, interp_uint32* dst1, interp_uint32* dst2, interp_uint32* dst3, const interp_uint32* src0, const interp_uint32* src1, const interp_uint32* src2, unsigned count);
 void hq4x_yuy2_def(interp_uint32* dst0, interp_uint32* dst1, interp_uint32* dst2, interp_uint32* dst3, const interp_uint32* src0, const interp_uint32* src1, const interp_uint32* src2, unsigned count);
 
+#if defined(USE_ASM_INLINE)
+/* No assembler version, use the C one */
+#define hq4x_16_asm hq4x_16_def
+#define hq4x_32_asm hq4x_32_def
+#define hq4x_yuy2_asm hq4x_yuy2_def
+#endif
+
+#if defined(USE_ASM_INTRINSIC)
+void hq4x_16_sse2(interp_uint16* dst0, interp_uint16* dst1, interp_uint16* dst2, interp_uint16* dst3, const interp_uint16* src0, const interp_uint16* src1, const interp_uint16* src2, unsigned count);
+void hq4x_32_sse2(interp_uint32* dst0, interp_uint32* dst1, interp_uint32* dst2, interp_uint32* dst3, const interp_uint32* src0, const interp_uint32* src1, const interp_uint32* src2, unsigned count);
+/* No vector version for yuy2, use the C one */
+#define hq4x_yuy2_sse2 hq4x_yuy2_def
+
+void hq4x_16_avx2(interp_uint16* dst0, interp_uint16* dst1, interp_uint16* dst2, interp_uint16* dst3, const interp_uint16* src0, const interp_uint16* src1, const interp_uint16* src2, unsigned count);
+void hq4x_32_avx2(interp_uint32* dst0, interp_uint32* dst1, interp_uint32* dst2, interp_uint32* dst3, const interp_uint32* src0, const interp_uint32* src1, const interp_uint32* src2, unsigned count);
+#define hq4x_yuy2_avx2 hq4x_yuy2_def
+#endif
+
 #endif
 
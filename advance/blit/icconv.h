@@ -142,7 +142,9 @@ static inline void internal_convbgra8888tobgr332_def(void* dst, const void* src,
 {
 	uint32* src32 = (uint32*)src;
 	uint32* dst32 = (uint32*)dst;
+	unsigned rest = count % 4;
 
+	count /= 4;
 	while (count) {
 #ifdef USE_LSB
 		*dst32++ = ((src32[0] >> (8 - 2)) & 0x03)
@@ -174,6 +176,18 @@ static inline void internal_convbgra8888tobgr332_def(void* dst, const void* src,
 		src32 += 4;
 		--count;
 	}
+
+	if (rest) {
+		uint8* dst8 = (uint8*)dst32;
+		do {
+			*dst8 = ((src32[0] >> (8 - 2)) & 0x03)
+				| ((src32[0] >> (16 - 3 - 2)) & 0x1C)
+				| ((src32[0] >> (24 - 3 - 3 - 2)) & 0xE0);
+			++src32;
+			++dst8;
+			--rest;
+		} while (rest);
+	}
 }
 
 #if defined(USE_ASM_INLINE)
@@ -250,6 +264,7 @@ static inline void internal_convbgra8888tobgr565_def(void* dst, const void* src,
 {
 	uint32* src32 = (uint32*)src;
 	uint32* dst32 = (uint32*)dst;
+	unsigned rest = count % 2;
 
 	count /= 2;
 	while (count) {
@@ -271,6 +286,11 @@ static inline void internal_convbgra8888tobgr565_def(void* dst, const void* src,
 		src32 += 2;
 		--count;
 	}
+
+	if (rest)
+		*(uint16*)dst32 = ((src32[0] >> (8 - 5)) & 0x001F)
+			| ((src32[0] >> (16 - 5 - 6)) & 0x07E0)
+			| ((src32[0] >> (24 - 5 - 6 - 5)) & 0xF800);
 }
 
 #if defined(USE_ASM_INLINE)
@@ -351,6 +371,7 @@ static inline void internal_convbgra8888tobgra5551_def(void* dst, const void* sr
 {
 	uint32* src32 = (uint32*)src;
 	uint32* dst32 = (uint32*)dst;
+	unsigned rest = count % 2;
 
 	count /= 2;
 	while (count) {
@@ -372,6 +393,11 @@ static inline void internal_convbgra8888tobgra5551_def(void* dst, const void* sr
 		src32 += 2;
 		--count;
 	}
+
+	if (rest)
+		*(uint16*)dst32 = ((src32[0] >> (8 - 5)) & 0x001F)
+			| ((src32[0] >> (16 - 5 - 5)) & 0x03E0)
+			| ((src32[0] >> (24 - 5 - 5 - 5)) & 0x7C00);
 }
 
 #if defined(USE_ASM_INLINE)
@@ -452,6 +478,7 @@ static inline void internal_convbgra5551tobgr332_def(void* dst, const void* src,
 {
 	uint16* src16 = (uint16*)src;
 	uint32* dst32 = (uint32*)dst;
+	unsigned rest = count % 4;
 
 	count /= 4;
 	while (count) {
@@ -485,6 +512,18 @@ static inline void internal_convbgra5551tobgr332_def(void* dst, const void* src,
 		src16 += 4;
 		--count;
 	}
+
+	if (rest) {
+		uint8* dst8 = (uint8*)dst32;
+		do {
+			*dst8 = ((src16[0] >> (5 - 2)) & 0x03)
+				| ((src16[0] >> (10 - 3 - 2)) & 0x1C)
+				| ((src16[0] >> (15 - 3 - 3 - 2)) & 0xE0);
+			++src16;
+			++dst8;
+			--rest;
+		} while (rest);
+	}
 }
 
 #if defined(USE_ASM_INLINE)
@@ -541,6 +580,7 @@ static inline void internal_convbgra5551tobgr565_def(void* dst, const void* src,
 {
 	uint32* src32 = (uint32*)src;
 	uint32* dst32 = (uint32*)dst;
+	unsigned rest = count % 2;
 
 	count /= 2;
 	while (count) {
@@ -549,6 +589,10 @@ static inline void internal_convbgra5551tobgr565_def(void* dst, const void* src,
 		src32 += 1;
 		--count;
 	}
+
+	if (rest)
+		*(uint16*)dst32 = (*(uint16*)src32 & 0x001F)
+			| ((*(uint16*)src32 << 1) & 0xFFC0);
 }
 
 #if defined(USE_ASM_INLINE)
@@ -624,6 +668,393 @@ static inline void internal_convbgra5551tobgra8888_def(void* dst, const void* sr
 	}
 }
 
+#if defined(USE_ASM_INTRINSIC)
+static inline void internal_convbgra8888tobgr332_sse2(void* dst, const void* src, unsigned count)
+{
+	const uint32* src32 = (const uint32*)src;
+	uint8* dst8 = (uint8*)dst;
+	__m128i mr = _mm_set1_epi32(0x000000E0);
+	__m128i mg = _mm_set1_epi32(0x0000001C);
+	__m128i mb = _mm_set1_epi32(0x00000003);
+
+	while (count >= 16) {
+		__m128i v[4];
+		unsigned i;
+
+		for (i = 0; i < 4; ++i) {
+			__m128i p = _mm_loadu_si128((const __m128i*)(src32 + 4 * i));
+			v[i] = _mm_or_si128(_mm_or_si128(
+				_mm_and_si128(_mm_srli_epi32(p, 16), mr),
+				_mm_and_si128(_mm_srli_epi32(p, 11), mg)),
+				_mm_and_si128(_mm_srli_epi32(p, 6), mb));
+		}
+
+		v[0] = _mm_packs_epi32(v[0], v[1]);
+		v[2] = _mm_packs_epi32(v[2], v[3]);
+		_mm_storeu_si128((__m128i*)dst8, _mm_packus_epi16(v[0], v[2]));
+		src32 += 16;
+		dst8 += 16;
+		count -= 16;
+	}
+
+	while (count) {
+		*dst8 = ((src32[0] >> (8 - 2)) & 0x03)
+			| ((src32[0] >> (16 - 3 - 2)) & 0x1C)
+			| ((src32[0] >> (24 - 3 - 3 - 2)) & 0xE0);
+		++src32;
+		++dst8;
+		--count;
+	}
+}
+
+static inline ASM_TARGET_AVX2 void internal_convbgra8888tobgr332_avx2(void* dst, const void* src, unsigned count)
+{
+	const uint32* src32 = (const uint32*)src;
+	uint8* dst8 = (uint8*)dst;
+	__m256i mr = _mm256_set1_epi32(0x000000E0);
+	__m256i mg = _mm256_set1_epi32(0x0000001C);
+	__m256i mb = _mm256_set1_epi32(0x00000003);
+
+	while (count >= 32) {
+		__m256i v[4];
+		unsigned i;
+
+		for (i = 0; i < 4; ++i) {
+			__m256i p = _mm256_loadu_si256((const __m256i*)(src32 + 8 * i));
+			v[i] = _mm256_or_si256(_mm256_or_si256(
+				_mm256_and_si256(_mm256_srli_epi32(p, 16), mr),
+				_mm256_and_si256(_mm256_srli_epi32(p, 11), mg)),
+				_mm256_and_si256(_mm256_srli_epi32(p, 6), mb));
+		}
+
+		/* the packs work in the two 128 bits lanes, restore the dword order at the end */
+		v[0] = _mm256_packs_epi32(v[0], v[1]);
+		v[2] = _mm256_packs_epi32(v[2], v[3]);
+		v[0] = _mm256_packus_epi16(v[0], v[2]);
+		v[0] = _mm256_permutevar8x32_epi32(v[0], _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+		_mm256_storeu_si256((__m256i*)dst8, v[0]);
+		src32 += 32;
+		dst8 += 32;
+		count -= 32;
+	}
+
+	internal_convbgra8888tobgr332_sse2(dst8, src32, count);
+}
+
+static inline void internal_convbgra8888tobgr565_sse2(void* dst, const void* src, unsigned count)
+{
+	const uint32* src32 = (const uint32*)src;
+	uint16* dst16 = (uint16*)dst;
+	__m128i mr = _mm_set1_epi32(0x0000F800);
+	__m128i mg = _mm_set1_epi32(0x000007E0);
+	__m128i mb = _mm_set1_epi32(0x0000001F);
+
+	while (count >= 8) {
+		__m128i p0 = _mm_loadu_si128((const __m128i*)src32);
+		__m128i p1 = _mm_loadu_si128((const __m128i*)(src32 + 4));
+		__m128i v0 = _mm_or_si128(_mm_or_si128(
+			_mm_and_si128(_mm_srli_epi32(p0, 8), mr),
+			_mm_and_si128(_mm_srli_epi32(p0, 5), mg)),
+			_mm_and_si128(_mm_srli_epi32(p0, 3), mb));
+		__m128i v1 = _mm_or_si128(_mm_or_si128(
+			_mm_and_si128(_mm_srli_epi32(p1, 8), mr),
+			_mm_and_si128(_mm_srli_epi32(p1, 5), mg)),
+			_mm_and_si128(_mm_srli_epi32(p1, 3), mb));
+
+		/* sign extend to avoid the signed saturation of the pack */
+		v0 = _mm_srai_epi32(_mm_slli_epi32(v0, 16), 16);
+		v1 = _mm_srai_epi32(_mm_slli_epi32(v1, 16), 16);
+		_mm_storeu_si128((__m128i*)dst16, _mm_packs_epi32(v0, v1));
+		src32 += 8;
+		dst16 += 8;
+		count -= 8;
+	}
+
+	while (count) {
+		*dst16 = ((src32[0] >> (8 - 5)) & 0x001F)
+			| ((src32[0] >> (16 - 5 - 6)) & 0x07E0)
+			| ((src32[0] >> (24 - 5 - 6 - 5)) & 0xF800);
+		++src32;
+		++dst16;
+		--count;
+	}
+}
+
+static inline ASM_TARGET_AVX2 void internal_convbgra8888tobgr565_avx2(void* dst, const void* src, unsigned count)
+{
+	const uint32* src32 = (const uint32*)src;
+	uint16* dst16 = (uint16*)dst;
+	__m256i mr = _mm256_set1_epi32(0x0000F800);
+	__m256i mg = _mm256_set1_epi32(0x000007E0);
+	__m256i mb = _mm256_set1_epi32(0x0000001F);
+
+	while (count >= 16) {
+		__m256i p0 = _mm256_loadu_si256((const __m256i*)src32);
+		__m256i p1 = _mm256_loadu_si256((const __m256i*)(src32 + 8));
+		__m256i v0 = _mm256_or_si256(_mm256_or_si256(
+			_mm256_and_si256(_mm256_srli_epi32(p0, 8), mr),
+			_mm256_and_si256(_mm256_srli_epi32(p0, 5), mg)),
+			_mm256_and_si256(_mm256_srli_epi32(p0, 3), mb));
+		__m256i v1 = _mm256_or_si256(_mm256_or_si256(
+			_mm256_and_si256(_mm256_srli_epi32(p1, 8), mr),
+			_mm256_and_si256(_mm256_srli_epi32(p1, 5), mg)),
+			_mm256_and_si256(_mm256_srli_epi32(p1, 3), mb));
+
+		/* unsigned pack, the values are never greather than 0xFFFF */
+		v0 = _mm256_packus_epi32(v0, v1);
+		_mm256_storeu_si256((__m256i*)dst16, _mm256_permute4x64_epi64(v0, 0xD8));
+		src32 += 16;
+		dst16 += 16;
+		count -= 16;
+	}
+
+	internal_convbgra8888tobgr565_sse2(dst16, src32, count);
+}
+
+static inline void internal_convbgra8888tobgra5551_sse2(void* dst, const void* src, unsigned count)
+{
+	const uint32* src32 = (const uint32*)src;
+	uint16* dst16 = (uint16*)dst;
+	__m128i mr = _mm_set1_epi32(0x00007C00);
+	__m128i mg = _mm_set1_epi32(0x000003E0);
+	__m128i mb = _mm_set1_epi32(0x0000001F);
+
+	while (count >= 8) {
+		__m128i p0 = _mm_loadu_si128((const __m128i*)src32);
+		__m128i p1 = _mm_loadu_si128((const __m128i*)(src32 + 4));
+		__m128i v0 = _mm_or_si128(_mm_or_si128(
+			_mm_and_si128(_mm_srli_epi32(p0, 9), mr),
+			_mm_and_si128(_mm_srli_epi32(p0, 6), mg)),
+			_mm_and_si128(_mm_srli_epi32(p0, 3), mb));
+		__m128i v1 = _mm_or_si128(_mm_or_si128(
+			_mm_and_si128(_mm_srli_epi32(p1, 9), mr),
+			_mm_and_si128(_mm_srli_epi32(p1, 6), mg)),
+			_mm_and_si128(_mm_srli_epi32(p1, 3), mb));
+
+		_mm_storeu_si128((__m128i*)dst16, _mm_packs_epi32(v0, v1));
+		src32 += 8;
+		dst16 += 8;
+		count -= 8;
+	}
+
+	while (count) {
+		*dst16 = ((src32[0] >> (8 - 5)) & 0x001F)
+			| ((src32[0] >> (16 - 5 - 5)) & 0x03E0)
+			| ((src32[0] >> (24 - 5 - 5 - 5)) & 0x7C00);
+		++src32;
+		++dst16;
+		--count;
+	}
+}
+
+static inline ASM_TARGET_AVX2 void internal_convbgra8888tobgra5551_avx2(void* dst, const void* src, unsigned count)
+{
+	const uint32* src32 = (const uint32*)src;
+	uint16* dst16 = (uint16*)dst;
+	__m256i mr = _mm256_set1_epi32(0x00007C00);
+	__m256i mg = _mm256_set1_epi32(0x000003E0);
+	__m256i mb = _mm256_set1_epi32(0x0000001F);
+
+	while (count >= 16) {
+		__m256i p0 = _mm256_loadu_si256((const __m256i*)src32);
+		__m256i p1 = _mm256_loadu_si256((const __m256i*)(src32 + 8));
+		__m256i v0 = _mm256_or_si256(_mm256_or_si256(
+			_mm256_and_si256(_mm256_srli_epi32(p0, 9), mr),
+			_mm256_and_si256(_mm256_srli_epi32(p0, 6), mg)),
+			_mm256_and_si256(_mm256_srli_epi32(p0, 3), mb));
+		__m256i v1 = _mm256_or_si256(_mm256_or_si256(
+			_mm256_and_si256(_mm256_srli_epi32(p1, 9), mr),
+			_mm256_and_si256(_mm256_srli_epi32(p1, 6), mg)),
+			_mm256_and_si256(_mm256_srli_epi32(p1, 3), mb));
+
+		v0 = _mm256_packs_epi32(v0, v1);
+		_mm256_storeu_si256((__m256i*)dst16, _mm256_permute4x64_epi64(v0, 0xD8));
+		src32 += 16;
+		dst16 += 16;
+		count -= 16;
+	}
+
+	internal_convbgra8888tobgra5551_sse2(dst16, src32, count);
+}
+
+static inline void internal_convbgra5551tobgr332_sse2(void* dst, const void* src, unsigned count)
+{
+	const uint16* src16 = (const uint16*)src;
+	uint8* dst8 = (uint8*)dst;
+	__m128i mr = _mm_set1_epi16(0x00E0);
+	__m128i mg = _mm_set1_epi16(0x001C);
+	__m128i mb = _mm_set1_epi16(0x0003);
+
+	while (count >= 16) {
+		__m128i p0 = _mm_loadu_si128((const __m128i*)src16);
+		__m128i p1 = _mm_loadu_si128((const __m128i*)(src16 + 8));
+		__m128i v0 = _mm_or_si128(_mm_or_si128(
+			_mm_and_si128(_mm_srli_epi16(p0, 7), mr),
+			_mm_and_si128(_mm_srli_epi16(p0, 5), mg)),
+			_mm_and_si128(_mm_srli_epi16(p0, 3), mb));
+		__m128i v1 = _mm_or_si128(_mm_or_si128(
+			_mm_and_si128(_mm_srli_epi16(p1, 7), mr),
+			_mm_and_si128(_mm_srli_epi16(p1, 5), mg)),
+			_mm_and_si128(_mm_srli_epi16(p1, 3), mb));
+
+		_mm_storeu_si128((__m128i*)dst8, _mm_packus_epi16(v0, v1));
+		src16 += 16;
+		dst8 += 16;
+		count -= 16;
+	}
+
+	while (count) {
+		*dst8 = ((src16[0] >> (5 - 2)) & 0x03)
+			| ((src16[0] >> (10 - 3 - 2)) & 0x1C)
+			| ((src16[0] >> (15 - 3 - 3 - 2)) & 0xE0);
+		++src16;
+		++dst8;
+		--count;
+	}
+}
+
+static inline ASM_TARGET_AVX2 void internal_convbgra5551tobgr332_avx2(void* dst, const void* src, unsigned count)
+{
+	const uint16* src16 = (const uint16*)src;
+	uint8* dst8 = (uint8*)dst;
+	__m256i mr = _mm256_set1_epi16(0x00E0);
+	__m256i mg = _mm256_set1_epi16(0x001C);
+	__m256i mb = _mm256_set1_epi16(0x0003);
+
+	while (count >= 32) {
+		__m256i p0 = _mm256_loadu_si256((const __m256i*)src16);
+		__m256i p1 = _mm256_loadu_si256((const __m256i*)(src16 + 16));
+		__m256i v0 = _mm256_or_si256(_mm256_or_si256(
+			_mm256_and_si256(_mm256_srli_epi16(p0, 7), mr),
+			_mm256_and_si256(_mm256_srli_epi16(p0, 5), mg)),
+			_mm256_and_si256(_mm256_srli_epi16(p0, 3), mb));
+		__m256i v1 = _mm256_or_si256(_mm256_or_si256(
+			_mm256_and_si256(_mm256_srli_epi16(p1, 7), mr),
+			_mm256_and_si256(_mm256_srli_epi16(p1, 5), mg)),
+			_mm256_and_si256(_mm256_srli_epi16(p1, 3), mb));
+
+		v0 = _mm256_packus_epi16(v0, v1);
+		_mm256_storeu_si256((__m256i*)dst8, _mm256_permute4x64_epi64(v0, 0xD8));
+		src16 += 32;
+		dst8 += 32;
+		count -= 32;
+	}
+
+	internal_convbgra5551tobgr332_sse2(dst8, src16, count);
+}
+
+static inline void internal_convbgra5551tobgr565_sse2(void* dst, const void* src, unsigned count)
+{
+	const uint16* src16 = (const uint16*)src;
+	uint16* dst16 = (uint16*)dst;
+	__m128i mrg = _mm_set1_epi16(0xFFC0);
+	__m128i mb = _mm_set1_epi16(0x001F);
+
+	while (count >= 8) {
+		__m128i p0 = _mm_loadu_si128((const __m128i*)src16);
+		p0 = _mm_or_si128(_mm_and_si128(p0, mb), _mm_and_si128(_mm_slli_epi16(p0, 1), mrg));
+		_mm_storeu_si128((__m128i*)dst16, p0);
+		src16 += 8;
+		dst16 += 8;
+		count -= 8;
+	}
+
+	while (count) {
+		*dst16 = (src16[0] & 0x001F)
+			| ((src16[0] << 1) & 0xFFC0);
+		++src16;
+		++dst16;
+		--count;
+	}
+}
+
+static inline ASM_TARGET_AVX2 void internal_convbgra5551tobgr565_avx2(void* dst, const void* src, unsigned count)
+{
+	const uint16* src16 = (const uint16*)src;
+	uint16* dst16 = (uint16*)dst;
+	__m256i mrg = _mm256_set1_epi16(0xFFC0);
+	__m256i mb = _mm256_set1_epi16(0x001F);
+
+	while (count >= 16) {
+		__m256i p0 = _mm256_loadu_si256((const __m256i*)src16);
+		p0 = _mm256_or_si256(_mm256_and_si256(p0, mb), _mm256_and_si256(_mm256_slli_epi16(p0, 1), mrg));
+		_mm256_storeu_si256((__m256i*)dst16, p0);
+		src16 += 16;
+		dst16 += 16;
+		count -= 16;
+	}
+
+	internal_convbgra5551tobgr565_sse2(dst16, src16, count);
+}
+
+static inline void internal_convbgra5551tobgra8888_sse2(void* dst, const void* src, unsigned count)
+{
+	const uint16* src16 = (const uint16*)src;
+	uint32* dst32 = (uint32*)dst;
+	__m128i mr = _mm_set1_epi32(0x00F80000);
+	__m128i mg = _mm_set1_epi32(0x0000F800);
+	__m128i mb = _mm_set1_epi32(0x000000F8);
+	__m128i zero = _mm_setzero_si128();
+
+	while (count >= 8) {
+		__m128i p = _mm_loadu_si128((const __m128i*)src16);
+		__m128i p0 = _mm_unpacklo_epi16(p, zero);
+		__m128i p1 = _mm_unpackhi_epi16(p, zero);
+		p0 = _mm_or_si128(_mm_or_si128(
+			_mm_and_si128(_mm_slli_epi32(p0, 9), mr),
+			_mm_and_si128(_mm_slli_epi32(p0, 6), mg)),
+			_mm_and_si128(_mm_slli_epi32(p0, 3), mb));
+		p1 = _mm_or_si128(_mm_or_si128(
+			_mm_and_si128(_mm_slli_epi32(p1, 9), mr),
+			_mm_and_si128(_mm_slli_epi32(p1, 6), mg)),
+			_mm_and_si128(_mm_slli_epi32(p1, 3), mb));
+		_mm_storeu_si128((__m128i*)dst32, p0);
+		_mm_storeu_si128((__m128i*)(dst32 + 4), p1);
+		src16 += 8;
+		dst32 += 8;
+		count -= 8;
+	}
+
+	while (count) {
+		*dst32 = ((src16[0] << 3) & 0x000000F8)
+			| ((src16[0] << 6) & 0x0000F800)
+			| ((src16[0] << 9) & 0x00F80000);
+		++src16;
+		++dst32;
+		--count;
+	}
+}
+
+static inline ASM_TARGET_AVX2 void internal_convbgra5551tobgra8888_avx2(void* dst, const void* src, unsigned count)
+{
+	const uint16* src16 = (const uint16*)src;
+	uint32* dst32 = (uint32*)dst;
+	__m256i mr = _mm256_set1_epi32(0x00F80000);
+	__m256i mg = _mm256_set1_epi32(0x0000F800);
+	__m256i mb = _mm256_set1_epi32(0x000000F8);
+
+	while (count >= 16) {
+		__m256i p0 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)src16));
+		__m256i p1 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src16 + 8)));
+		p0 = _mm256_or_si256(_mm256_or_si256(
+			_mm256_and_si256(_mm256_slli_epi32(p0, 9), mr),
+			_mm256_and_si256(_mm256_slli_epi32(p0, 6), mg)),
+			_mm256_and_si256(_mm256_slli_epi32(p0, 3), mb));
+		p1 = _mm256_or_si256(_mm256_or_si256(
+			_mm256_and_si256(_mm256_slli_epi32(p1, 9), mr),
+			_mm256_and_si256(_mm256_slli_epi32(p1, 6), mg)),
+			_mm256_and_si256(_mm256_slli_epi32(p1, 3), mb));
+		_mm256_storeu_si256((__m256i*)dst32, p0);
+		_mm256_storeu_si256((__m256i*)(dst32 + 8), p1);
+		src16 += 16;
+		dst32 += 16;
+		count -= 16;
+	}
+
+	internal_convbgra5551tobgra8888_sse2(dst32, src16, count);
+}
+#endif
+
 #if defined(USE_ASM_INLINE)
 /*
         Y =  0.299  R + 0.587  G + 0.114  B
@@ -758,6 +1189,187 @@ static inline void pixel_convbgra8888toyuy2_def(void* dst, const void* src)
 	dst8[3] = v;
 }
 
+#if defined(USE_ASM_INTRINSIC)
+/*
+   Same coefficients and rounding of pixel_convbgra8888toyuy2_def().
+   The coefficients of 32768 and more don't fit in the signed 16 bits words
+   of pmaddwd, and they are splitted as (c - 65536) * x + (x << 16).
+ */
+#define YUY2_COEFF(lo, hi) ((int)(((unsigned)(hi) << 16) | ((unsigned)(lo) & 0xFFFF)))
+
+static inline __m128i internal_convrgbtoyuy2_4_sse2(__m128i r, __m128i g, __m128i b)
+{
+	__m128i rg, y, u, v;
+
+	rg = _mm_or_si128(r, _mm_slli_epi32(g, 16));
+
+	y = _mm_add_epi32(_mm_add_epi32(
+		_mm_madd_epi16(rg, _mm_set1_epi32(YUY2_COEFF(19595, -27067))),
+		_mm_madd_epi16(b, _mm_set1_epi32(YUY2_COEFF(7471, 0)))),
+		_mm_slli_epi32(g, 16));
+	u = _mm_add_epi32(_mm_add_epi32(
+		_mm_madd_epi16(rg, _mm_set1_epi32(YUY2_COEFF(-11055, -21712))),
+		_mm_madd_epi16(b, _mm_set1_epi32(YUY2_COEFF(-32768, 0)))),
+		_mm_slli_epi32(b, 16));
+	v = _mm_add_epi32(_mm_add_epi32(
+		_mm_madd_epi16(rg, _mm_set1_epi32(YUY2_COEFF(-32768, -27439))),
+		_mm_madd_epi16(b, _mm_set1_epi32(YUY2_COEFF(-5328, 0)))),
+		_mm_slli_epi32(r, 16));
+
+	y = _mm_srli_epi32(y, 16);
+	u = _mm_add_epi32(_mm_srai_epi32(u, 16), _mm_set1_epi32(128));
+	v = _mm_add_epi32(_mm_srai_epi32(v, 16), _mm_set1_epi32(128));
+
+	return _mm_or_si128(_mm_or_si128(y, _mm_slli_epi32(y, 16)), _mm_or_si128(_mm_slli_epi32(u, 8), _mm_slli_epi32(v, 24)));
+}
+
+/* Convert 8 pixels with the components in 16 bits words */
+static inline void internal_convrgbtoyuy2_sse2(void* dst, __m128i r, __m128i g, __m128i b)
+{
+	__m128i z = _mm_setzero_si128();
+
+	_mm_storeu_si128((__m128i*)dst, internal_convrgbtoyuy2_4_sse2(_mm_unpacklo_epi16(r, z), _mm_unpacklo_epi16(g, z), _mm_unpacklo_epi16(b, z)));
+	_mm_storeu_si128((__m128i*)((uint8*)dst + 16), internal_convrgbtoyuy2_4_sse2(_mm_unpackhi_epi16(r, z), _mm_unpackhi_epi16(g, z), _mm_unpackhi_epi16(b, z)));
+}
+
+static inline ASM_TARGET_AVX2 __m256i internal_convrgbtoyuy2_8_avx2(__m256i r, __m256i g, __m256i b)
+{
+	__m256i rg, y, u, v;
+
+	rg = _mm256_or_si256(r, _mm256_slli_epi32(g, 16));
+
+	y = _mm256_add_epi32(_mm256_add_epi32(
+		_mm256_madd_epi16(rg, _mm256_set1_epi32(YUY2_COEFF(19595, -27067))),
+		_mm256_madd_epi16(b, _mm256_set1_epi32(YUY2_COEFF(7471, 0)))),
+		_mm256_slli_epi32(g, 16));
+	u = _mm256_add_epi32(_mm256_add_epi32(
+		_mm256_madd_epi16(rg, _mm256_set1_epi32(YUY2_COEFF(-11055, -21712))),
+		_mm256_madd_epi16(b, _mm256_set1_epi32(YUY2_COEFF(-32768, 0)))),
+		_mm256_slli_epi32(b, 16));
+	v = _mm256_add_epi32(_mm256_add_epi32(
+		_mm256_madd_epi16(rg, _mm256_set1_epi32(YUY2_COEFF(-32768, -27439))),
+		_mm256_madd_epi16(b, _mm256_set1_epi32(YUY2_COEFF(-5328, 0)))),
+		_mm256_slli_epi32(r, 16));
+
+	y = _mm256_srli_epi32(y, 16);
+	u = _mm256_add_epi32(_mm256_srai_epi32(u, 16), _mm256_set1_epi32(128));
+	v = _mm256_add_epi32(_mm256_srai_epi32(v, 16), _mm256_set1_epi32(128));
+
+	return _mm256_or_si256(_mm256_or_si256(y, _mm256_slli_epi32(y, 16)), _mm256_or_si256(_mm256_slli_epi32(u, 8), _mm256_slli_epi32(v, 24)));
+}
+
+/* Convert 16 pixels with the components in 16 bits words, in the order given by _mm256_packs_epi32() */
+static inline ASM_TARGET_AVX2 void internal_convrgbtoyuy2_avx2(void* dst, __m256i r, __m256i g, __m256i b)
+{
+	__m256i z = _mm256_setzero_si256();
+
+	_mm256_storeu_si256((__m256i*)dst, internal_convrgbtoyuy2_8_avx2(_mm256_unpacklo_epi16(r, z), _mm256_unpacklo_epi16(g, z), _mm256_unpacklo_epi16(b, z)));
+	_mm256_storeu_si256((__m256i*)((uint8*)dst + 32), internal_convrgbtoyuy2_8_avx2(_mm256_unpackhi_epi16(r, z), _mm256_unpackhi_epi16(g, z), _mm256_unpackhi_epi16(b, z)));
+}
+
+static inline void internal_convbgra8888toyuy2_sse2(void* dst, const void* src, unsigned count)
+{
+	const uint32* src32 = (const uint32*)src;
+	uint8* dst8 = (uint8*)dst;
+	__m128i m = _mm_set1_epi32(0xFF);
+
+	while (count >= 8) {
+		__m128i p0 = _mm_loadu_si128((const __m128i*)src32);
+		__m128i p1 = _mm_loadu_si128((const __m128i*)(src32 + 4));
+		__m128i b = _mm_packs_epi32(_mm_and_si128(p0, m), _mm_and_si128(p1, m));
+		__m128i g = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(p0, 8), m), _mm_and_si128(_mm_srli_epi32(p1, 8), m));
+		__m128i r = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(p0, 16), m), _mm_and_si128(_mm_srli_epi32(p1, 16), m));
+
+		internal_convrgbtoyuy2_sse2(dst8, r, g, b);
+		src32 += 8;
+		dst8 += 32;
+		count -= 8;
+	}
+
+	while (count) {
+		pixel_convbgra8888toyuy2_def(dst8, src32);
+		src32 += 1;
+		dst8 += 4;
+		--count;
+	}
+}
+
+static inline ASM_TARGET_AVX2 void internal_convbgra8888toyuy2_avx2(void* dst, const void* src, unsigned count)
+{
+	const uint32* src32 = (const uint32*)src;
+	uint8* dst8 = (uint8*)dst;
+	__m256i m = _mm256_set1_epi32(0xFF);
+
+	while (count >= 16) {
+		__m256i p0 = _mm256_loadu_si256((const __m256i*)src32);
+		__m256i p1 = _mm256_loadu_si256((const __m256i*)(src32 + 8));
+		__m256i b = _mm256_packs_epi32(_mm256_and_si256(p0, m), _mm256_and_si256(p1, m));
+		__m256i g = _mm256_packs_epi32(_mm256_and_si256(_mm256_srli_epi32(p0, 8), m), _mm256_and_si256(_mm256_srli_epi32(p1, 8), m));
+		__m256i r = _mm256_packs_epi32(_mm256_and_si256(_mm256_srli_epi32(p0, 16), m), _mm256_and_si256(_mm256_srli_epi32(p1, 16), m));
+
+		internal_convrgbtoyuy2_avx2(dst8, r, g, b);
+		src32 += 16;
+		dst8 += 64;
+		count -= 16;
+	}
+
+	internal_convbgra8888toyuy2_sse2(dst8, src32, count);
+}
+
+static inline void internal_convbgra5551toyuy2_sse2(void* dst, const void* src, unsigned count)
+{
+	const uint16* src16 = (const uint16*)src;
+	uint8* dst8 = (uint8*)dst;
+	__m128i m = _mm_set1_epi16(0xF8);
+
+	while (count >= 8) {
+		__m128i p = _mm_loadu_si128((const __m128i*)src16);
+		__m128i b = _mm_and_si128(_mm_slli_epi16(p, 3), m);
+		__m128i g = _mm_and_si128(_mm_srli_epi16(p, 2), m);
+		__m128i r = _mm_and_si128(_mm_srli_epi16(p, 7), m);
+
+		internal_convrgbtoyuy2_sse2(dst8, r, g, b);
+		src16 += 8;
+		dst8 += 32;
+		count -= 8;
+	}
+
+	while (count) {
+		uint8 p4[4];
+
+		p4[0] = (src16[0] << 3) & 0xF8;
+		p4[1] = (src16[0] >> 2) & 0xF8;
+		p4[2] = (src16[0] >> 7) & 0xF8;
+		pixel_convbgra8888toyuy2_def(dst8, p4);
+		src16 += 1;
+		dst8 += 4;
+		--count;
+	}
+}
+
+static inline ASM_TARGET_AVX2 void internal_convbgra5551toyuy2_avx2(void* dst, const void* src, unsigned count)
+{
+	const uint16* src16 = (const uint16*)src;
+	uint8* dst8 = (uint8*)dst;
+	__m256i m = _mm256_set1_epi16(0xF8);
+
+	while (count >= 16) {
+		/* preorder the pixels as they were generated by _mm256_packs_epi32() */
+		__m256i p = _mm256_permute4x64_epi64(_mm256_loadu_si256((const __m256i*)src16), 0xD8);
+		__m256i b = _mm256_and_si256(_mm256_slli_epi16(p, 3), m);
+		__m256i g = _mm256_and_si256(_mm256_srli_epi16(p, 2), m);
+		__m256i r = _mm256_and_si256(_mm256_srli_epi16(p, 7), m);
+
+		internal_convrgbtoyuy2_avx2(dst8, r, g, b);
+		src16 += 16;
+		dst8 += 64;
+		count -= 16;
+	}
+
+	internal_convbgra5551toyuy2_sse2(dst8, src16, count);
+}
+#endif
+
 static inline void pixel_alphabgra8888_def(void* dst, const void* src)
 {
 	int a;
@@ -93,5 +93,21 @@
 #define assert_align(x) \
 	do { } while (0)
 
+/*
+   Intrinsic notes:
+   ) With USE_ASM_INTRINSIC the x86-64 builds get two additional versions of
+   the internal_* and video_line_* functions, the *_sse2 ones using only the
+   SSE2 instruction set always present on x86-64, and the *_avx2 ones
+   compiled for AVX2 with the ASM_TARGET_AVX2 attribute. The *_avx2
+   versions must be called only after checking the processor capabilities.
+   ) Unlike the *_asm versions, the remaining pixels not filling a whole
+   vector register are processed with a scalar loop.
+ */
+#if defined(USE_ASM_INTRINSIC)
+#include <immintrin.h>
+
+#define ASM_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
 #endif
 
@@ -156,6 +156,113 @@ static inline void internal_copy32_def(uint32* dst, const uint32* src, unsigned
 	internal_copy8_def((uint8*)dst, (uint8*)src, 4 * count);
 }
 
+#if defined(USE_ASM_INTRINSIC)
+static inline void internal_copy8_sse2(uint8* dst, const uint8* src, unsigned count)
+{
+	while (count >= 16) {
+		/* unaligned move as both the bitmap and the scanline may not be 16 bytes aligned */
+		__m128i v0 = _mm_loadu_si128((const __m128i*)src);
+		_mm_storeu_si128((__m128i*)dst, v0);
+		src += 16;
+		dst += 16;
+		count -= 16;
+	}
+
+	while (count) {
+		dst[0] = src[0];
+		dst += 1;
+		src += 1;
+		--count;
+	}
+}
+
+static inline ASM_TARGET_AVX2 void internal_copy8_avx2(uint8* dst, const uint8* src, unsigned count)
+{
+	while (count >= 64) {
+		__m256i v0 = _mm256_loadu_si256((const __m256i*)src);
+		__m256i v1 = _mm256_loadu_si256((const __m256i*)(src + 32));
+		_mm256_storeu_si256((__m256i*)dst, v0);
+		_mm256_storeu_si256((__m256i*)(dst + 32), v1);
+		src += 64;
+		dst += 64;
+		count -= 64;
+	}
+
+	if (count >= 32) {
+		__m256i v0 = _mm256_loadu_si256((const __m256i*)src);
+		_mm256_storeu_si256((__m256i*)dst, v0);
+		src += 32;
+		dst += 32;
+		count -= 32;
+	}
+
+	internal_copy8_sse2(dst, src, count);
+}
+
+static inline void internal_copy8_step2_sse2(uint8* dst, const uint8* src, unsigned count)
+{
+	__m128i mask = _mm_set1_epi16(0x00FF);
+
+	while (count >= 16) {
+		__m128i v0 = _mm_loadu_si128((const __m128i*)src);
+		__m128i v1 = _mm_loadu_si128((const __m128i*)(src + 16));
+		v0 = _mm_and_si128(v0, mask);
+		v1 = _mm_and_si128(v1, mask);
+		_mm_storeu_si128((__m128i*)dst, _mm_packus_epi16(v0, v1));
+		src += 32;
+		dst += 16;
+		count -= 16;
+	}
+
+	while (count) {
+		dst[0] = src[0];
+		dst += 1;
+		src += 2;
+		--count;
+	}
+}
+
+static inline ASM_TARGET_AVX2 void internal_copy8_step2_avx2(uint8* dst, const uint8* src, unsigned count)
+{
+	__m256i mask = _mm256_set1_epi16(0x00FF);
+
+	while (count >= 32) {
+		__m256i v0 = _mm256_loadu_si256((const __m256i*)src);
+		__m256i v1 = _mm256_loadu_si256((const __m256i*)(src + 32));
+		v0 = _mm256_and_si256(v0, mask);
+		v1 = _mm256_and_si256(v1, mask);
+		/* packus works in the two 128 bits lanes, reorder the 64 bits blocks */
+		v0 = _mm256_permute4x64_epi64(_mm256_packus_epi16(v0, v1), 0xD8);
+		_mm256_storeu_si256((__m256i*)dst, v0);
+		src += 64;
+		dst += 32;
+		count -= 32;
+	}
+
+	internal_copy8_step2_sse2(dst, src, count);
+}
+
+static inline void internal_copy16_sse2(uint16* dst, const uint16* src, unsigned count)
+{
+	internal_copy8_sse2((uint8*)dst, (uint8*)src, 2 * count);
+}
+
+static inline ASM_TARGET_AVX2 void internal_copy16_avx2(uint16* dst, const uint16* src, unsigned count)
+{
+	internal_copy8_avx2((uint8*)dst, (uint8*)src, 2 * count);
+}
+
+static inline void internal_copy32_sse2(uint32* dst, const uint32* src, unsigned count)
+{
+	internal_copy8_sse2((uint8*)dst, (uint8*)src, 4 * count);
+}
+
+static inline ASM_TARGET_AVX2 void internal_copy32_avx2(uint32* dst, const uint32* src, unsigned count)
+{
+	internal_copy8_avx2((uint8*)dst, (uint8*)src, 4 * count);
+}
+#endif
+
 #if defined(USE_ASM_INLINE)
 static inline void internal_copy8_step_asm(uint8* dst, const uint8* src, unsigned count, int step)
 {
@@ -400,6 +507,99 @@ static inline void internal_copy32_step_def(uint32* dst, const uint32* src, unsi
 	}
 }
 
+#if defined(USE_ASM_INTRINSIC)
+static inline void internal_copy8_step_sse2(uint8* dst, const uint8* src, unsigned count, int step)
+{
+	while (count >= 16) {
+		__m128i v0 = _mm_setr_epi8(
+			P8DER(src, 0), P8DER(src, step), P8DER(src, 2 * step), P8DER(src, 3 * step),
+			P8DER(src, 4 * step), P8DER(src, 5 * step), P8DER(src, 6 * step), P8DER(src, 7 * step),
+			P8DER(src, 8 * step), P8DER(src, 9 * step), P8DER(src, 10 * step), P8DER(src, 11 * step),
+			P8DER(src, 12 * step), P8DER(src, 13 * step), P8DER(src, 14 * step), P8DER(src, 15 * step)
+		);
+		PADD(src, 16 * step);
+
+		_mm_storeu_si128((__m128i*)dst, v0);
+		dst += 16;
+		count -= 16;
+	}
+
+	while (count) {
+		dst[0] = src[0];
+		dst += 1;
+		PADD(src, step);
+		--count;
+	}
+}
+
+static inline void internal_copy16_step_sse2(uint16* dst, const uint16* src, unsigned count, int step)
+{
+	while (count >= 8) {
+		__m128i v0 = _mm_setzero_si128();
+
+		v0 = _mm_insert_epi16(v0, P16DER(src, 0), 0);
+		v0 = _mm_insert_epi16(v0, P16DER(src, step), 1);
+		v0 = _mm_insert_epi16(v0, P16DER(src, 2 * step), 2);
+		v0 = _mm_insert_epi16(v0, P16DER(src, 3 * step), 3);
+		v0 = _mm_insert_epi16(v0, P16DER(src, 4 * step), 4);
+		v0 = _mm_insert_epi16(v0, P16DER(src, 5 * step), 5);
+		v0 = _mm_insert_epi16(v0, P16DER(src, 6 * step), 6);
+		v0 = _mm_insert_epi16(v0, P16DER(src, 7 * step), 7);
+		PADD(src, 8 * step);
+
+		_mm_storeu_si128((__m128i*)dst, v0);
+		dst += 8;
+		count -= 8;
+	}
+
+	while (count) {
+		dst[0] = src[0];
+		dst += 1;
+		PADD(src, step);
+		--count;
+	}
+}
+
+static inline void internal_copy32_step_sse2(uint32* dst, const uint32* src, unsigned count, int step)
+{
+	while (count >= 4) {
+		__m128i v0 = _mm_setr_epi32(P32DER(src, 0), P32DER(src, step), P32DER(src, 2 * step), P32DER(src, 3 * step));
+		PADD(src, 4 * step);
+
+		_mm_storeu_si128((__m128i*)dst, v0);
+		dst += 4;
+		count -= 4;
+	}
+
+	while (count) {
+		dst[0] = src[0];
+		dst += 1;
+		PADD(src, step);
+		--count;
+	}
+}
+
+/* The 8 and 16 bits gathers would read outside the source pixels, use the SSE2 versions */
+#define internal_copy8_step_avx2 internal_copy8_step_sse2
+#define internal_copy16_step_avx2 internal_copy16_step_sse2
+
+static inline ASM_TARGET_AVX2 void internal_copy32_step_avx2(uint32* dst, const uint32* src, unsigned count, int step)
+{
+	__m256i index = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(step));
+
+	while (count >= 8) {
+		__m256i v0 = _mm256_i32gather_epi32((const int*)src, index, 1);
+		PADD(src, 8 * step);
+
+		_mm256_storeu_si256((__m256i*)dst, v0);
+		dst += 8;
+		count -= 8;
+	}
+
+	internal_copy32_step_sse2(dst, src, count, step);
+}
+#endif
+
 /***************************************************************************/
 /* internal fill */
 
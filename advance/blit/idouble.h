@@ -120,6 +120,111 @@ static inline void internal_double32_asm(uint32* dst, const uint32* src, unsigne
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static inline void internal_double8_sse2(uint8* dst, const uint8* src, unsigned count)
+{
+	while (count >= 16) {
+		__m128i v0 = _mm_loadu_si128((const __m128i*)src);
+		_mm_storeu_si128((__m128i*)dst, _mm_unpacklo_epi8(v0, v0));
+		_mm_storeu_si128((__m128i*)(dst + 16), _mm_unpackhi_epi8(v0, v0));
+		src += 16;
+		dst += 32;
+		count -= 16;
+	}
+
+	while (count) {
+		dst[0] = src[0];
+		dst[1] = src[0];
+		dst += 2;
+		src += 1;
+		--count;
+	}
+}
+
+static inline ASM_TARGET_AVX2 void internal_double8_avx2(uint8* dst, const uint8* src, unsigned count)
+{
+	while (count >= 32) {
+		/* the unpack works in the two 128 bits lanes, so the source lanes are preordered */
+		__m256i v0 = _mm256_permute4x64_epi64(_mm256_loadu_si256((const __m256i*)src), 0xD8);
+		_mm256_storeu_si256((__m256i*)dst, _mm256_unpacklo_epi8(v0, v0));
+		_mm256_storeu_si256((__m256i*)(dst + 32), _mm256_unpackhi_epi8(v0, v0));
+		src += 32;
+		dst += 64;
+		count -= 32;
+	}
+
+	internal_double8_sse2(dst, src, count);
+}
+
+static inline void internal_double16_sse2(uint16* dst, const uint16* src, unsigned count)
+{
+	while (count >= 8) {
+		__m128i v0 = _mm_loadu_si128((const __m128i*)src);
+		_mm_storeu_si128((__m128i*)dst, _mm_unpacklo_epi16(v0, v0));
+		_mm_storeu_si128((__m128i*)(dst + 8), _mm_unpackhi_epi16(v0, v0));
+		src += 8;
+		dst += 16;
+		count -= 8;
+	}
+
+	while (count) {
+		dst[0] = src[0];
+		dst[1] = src[0];
+		dst += 2;
+		src += 1;
+		--count;
+	}
+}
+
+static inline ASM_TARGET_AVX2 void internal_double16_avx2(uint16* dst, const uint16* src, unsigned count)
+{
+	while (count >= 16) {
+		__m256i v0 = _mm256_permute4x64_epi64(_mm256_loadu_si256((const __m256i*)src), 0xD8);
+		_mm256_storeu_si256((__m256i*)dst, _mm256_unpacklo_epi16(v0, v0));
+		_mm256_storeu_si256((__m256i*)(dst + 16), _mm256_unpackhi_epi16(v0, v0));
+		src += 16;
+		dst += 32;
+		count -= 16;
+	}
+
+	internal_double16_sse2(dst, src, count);
+}
+
+static inline void internal_double32_sse2(uint32* dst, const uint32* src, unsigned count)
+{
+	while (count >= 4) {
+		__m128i v0 = _mm_loadu_si128((const __m128i*)src);
+		_mm_storeu_si128((__m128i*)dst, _mm_unpacklo_epi32(v0, v0));
+		_mm_storeu_si128((__m128i*)(dst + 4), _mm_unpackhi_epi32(v0, v0));
+		src += 4;
+		dst += 8;
+		count -= 4;
+	}
+
+	while (count) {
+		dst[0] = src[0];
+		dst[1] = src[0];
+		dst += 2;
+		src += 1;
+		--count;
+	}
+}
+
+static inline ASM_TARGET_AVX2 void internal_double32_avx2(uint32* dst, const uint32* src, unsigned count)
+{
+	while (count >= 8) {
+		__m256i v0 = _mm256_permute4x64_epi64(_mm256_loadu_si256((const __m256i*)src), 0xD8);
+		_mm256_storeu_si256((__m256i*)dst, _mm256_unpacklo_epi32(v0, v0));
+		_mm256_storeu_si256((__m256i*)(dst + 8), _mm256_unpackhi_epi32(v0, v0));
+		src += 8;
+		dst += 16;
+		count -= 8;
+	}
+
+	internal_double32_sse2(dst, src, count);
+}
+#endif
+
 static inline void internal_double8_def(uint8* restrict dst, const uint8* restrict src, unsigned count)
 {
 	while (count) {
@@ -151,6 +151,64 @@ static inline void internal_mean16_vert_self_def(uint16* dst, const uint16* src,
 	internal_mean32_vert_self_def((uint32*)dst, (uint32*)src, count / 2);
 }
 
+#if defined(USE_ASM_INTRINSIC)
+static inline void internal_mean32_vert_self_sse2(uint32* dst32, const uint32* src32, unsigned count)
+{
+	__m128i mask = _mm_set1_epi32(mean_mask[MEAN_MASK_H_0]);
+
+	while (count >= 4) {
+		__m128i v0 = _mm_loadu_si128((const __m128i*)dst32);
+		__m128i v1 = _mm_loadu_si128((const __m128i*)src32);
+		__m128i m = _mm_and_si128(_mm_srli_epi32(_mm_xor_si128(v0, v1), 1), mask);
+		m = _mm_add_epi32(m, _mm_and_si128(v0, v1));
+		_mm_storeu_si128((__m128i*)dst32, m);
+		src32 += 4;
+		dst32 += 4;
+		count -= 4;
+	}
+
+	internal_mean32_vert_self_def(dst32, src32, count);
+}
+
+static inline ASM_TARGET_AVX2 void internal_mean32_vert_self_avx2(uint32* dst32, const uint32* src32, unsigned count)
+{
+	__m256i mask = _mm256_set1_epi32(mean_mask[MEAN_MASK_H_0]);
+
+	while (count >= 8) {
+		__m256i v0 = _mm256_loadu_si256((const __m256i*)dst32);
+		__m256i v1 = _mm256_loadu_si256((const __m256i*)src32);
+		__m256i m = _mm256_and_si256(_mm256_srli_epi32(_mm256_xor_si256(v0, v1), 1), mask);
+		m = _mm256_add_epi32(m, _mm256_and_si256(v0, v1));
+		_mm256_storeu_si256((__m256i*)dst32, m);
+		src32 += 8;
+		dst32 += 8;
+		count -= 8;
+	}
+
+	internal_mean32_vert_self_sse2(dst32, src32, count);
+}
+
+static inline void internal_mean8_vert_self_sse2(uint8* dst, const uint8* src, unsigned count)
+{
+	internal_mean32_vert_self_sse2((uint32*)dst, (uint32*)src, count / 4);
+}
+
+static inline ASM_TARGET_AVX2 void internal_mean8_vert_self_avx2(uint8* dst, const uint8* src, unsigned count)
+{
+	internal_mean32_vert_self_avx2((uint32*)dst, (uint32*)src, count / 4);
+}
+
+static inline void internal_mean16_vert_self_sse2(uint16* dst, const uint16* src, unsigned count)
+{
+	internal_mean32_vert_self_sse2((uint32*)dst, (uint32*)src, count / 2);
+}
+
+static inline ASM_TARGET_AVX2 void internal_mean16_vert_self_avx2(uint16* dst, const uint16* src, unsigned count)
+{
+	internal_mean32_vert_self_avx2((uint32*)dst, (uint32*)src, count / 2);
+}
+#endif
+
 static inline void internal_mean8_vert_self_step(uint8* dst8, const uint8* src8, unsigned count, int step1)
 {
 	while (count) {
@@ -438,6 +496,93 @@ static inline void internal_mean32_horz_next_step4_def(uint32* dst32, const uint
 	}
 }
 
+#if defined(USE_ASM_INTRINSIC)
+/*
+ * Compute the mean of src and src+1 for pixels of bpp bytes.
+ * The last pixel is paired with itself, like the *_def versions.
+ * The size argument is the number of bytes to process.
+ */
+static inline void internal_mean_horz_next_sse2(uint8* dst8, const uint8* src8, unsigned size, unsigned bpp)
+{
+	__m128i mask = _mm_set1_epi32(mean_mask[MEAN_MASK_H_0]);
+	unsigned i = 0;
+
+	if (!size)
+		return;
+
+	while (i + 16 + bpp <= size) {
+		__m128i v0 = _mm_loadu_si128((const __m128i*)(src8 + i));
+		__m128i v1 = _mm_loadu_si128((const __m128i*)(src8 + i + bpp));
+		__m128i m = _mm_and_si128(_mm_srli_epi32(_mm_xor_si128(v0, v1), 1), mask);
+		m = _mm_add_epi32(m, _mm_and_si128(v0, v1));
+		_mm_storeu_si128((__m128i*)(dst8 + i), m);
+		i += 16;
+	}
+
+	while (i + bpp < size) {
+		switch (bpp) {
+		case 1: dst8[i] = internal_mean_value(src8[i], src8[i + 1]); break;
+		case 2: P16DER(dst8, i) = internal_mean_value(P16DER(src8, i), P16DER(src8, i + 2)); break;
+		case 4: P32DER(dst8, i) = internal_mean_value(P32DER(src8, i), P32DER(src8, i + 4)); break;
+		}
+		i += bpp;
+	}
+
+	switch (bpp) {
+	case 1: dst8[i] = src8[i]; break;
+	case 2: P16DER(dst8, i) = P16DER(src8, i); break;
+	case 4: P32DER(dst8, i) = P32DER(src8, i); break;
+	}
+}
+
+static inline ASM_TARGET_AVX2 void internal_mean_horz_next_avx2(uint8* dst8, const uint8* src8, unsigned size, unsigned bpp)
+{
+	__m256i mask = _mm256_set1_epi32(mean_mask[MEAN_MASK_H_0]);
+	unsigned i = 0;
+
+	while (i + 32 + bpp <= size) {
+		__m256i v0 = _mm256_loadu_si256((const __m256i*)(src8 + i));
+		__m256i v1 = _mm256_loadu_si256((const __m256i*)(src8 + i + bpp));
+		__m256i m = _mm256_and_si256(_mm256_srli_epi32(_mm256_xor_si256(v0, v1), 1), mask);
+		m = _mm256_add_epi32(m, _mm256_and_si256(v0, v1));
+		_mm256_storeu_si256((__m256i*)(dst8 + i), m);
+		i += 32;
+	}
+
+	internal_mean_horz_next_sse2(dst8 + i, src8 + i, size - i, bpp);
+}
+
+static inline void internal_mean8_horz_next_step1_sse2(uint8* dst8, const uint8* src8, unsigned count)
+{
+	internal_mean_horz_next_sse2(dst8, src8, count & ~3U, 1);
+}
+
+static inline ASM_TARGET_AVX2 void internal_mean8_horz_next_step1_avx2(uint8* dst8, const uint8* src8, unsigned count)
+{
+	internal_mean_horz_next_avx2(dst8, src8, count & ~3U, 1);
+}
+
+static inline void internal_mean16_horz_next_step2_sse2(uint16* dst16, const uint16* src16, unsigned count)
+{
+	internal_mean_horz_next_sse2((uint8*)dst16, (const uint8*)src16, (count & ~1U) * 2, 2);
+}
+
+static inline ASM_TARGET_AVX2 void internal_mean16_horz_next_step2_avx2(uint16* dst16, const uint16* src16, unsigned count)
+{
+	internal_mean_horz_next_avx2((uint8*)dst16, (const uint8*)src16, (count & ~1U) * 2, 2);
+}
+
+static inline void internal_mean32_horz_next_step4_sse2(uint32* dst32, const uint32* src32, unsigned count)
+{
+	internal_mean_horz_next_sse2((uint8*)dst32, (const uint8*)src32, count * 4, 4);
+}
+
+static inline ASM_TARGET_AVX2 void internal_mean32_horz_next_step4_avx2(uint32* dst32, const uint32* src32, unsigned count)
+{
+	internal_mean_horz_next_avx2((uint8*)dst32, (const uint8*)src32, count * 4, 4);
+}
+#endif
+
 static inline void internal_mean8_horz_next_step(uint8* dst8, const uint8* src8, unsigned count, int step)
 {
 	if (count) {
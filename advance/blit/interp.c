@@ -43,17 +43,6 @@ unsigned interp_highnot_mask;
 /***************************************************************************/
 /* diff */
 
-#define INTERP_Y_LIMIT 0x30
-#define INTERP_U_LIMIT 0x07
-#define INTERP_V_LIMIT 0x06
-
-/* Multipled version */
-#define INTERP_Y_LIMIT_S2 (INTERP_Y_LIMIT << 2)
-#define INTERP_U_LIMIT_S2 (INTERP_U_LIMIT << 2)
-#define INTERP_V_LIMIT_S3 (INTERP_V_LIMIT << 3)
-#define INTERP_U_LIMIT_S8 (INTERP_U_LIMIT << 8)
-#define INTERP_V_LIMIT_S24 (INTERP_V_LIMIT << 24)
-
 int interp_16_diff(interp_uint16 p1, interp_uint16 p2)
 {
 	int r, g, b;
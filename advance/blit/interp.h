@@ -31,6 +31,11 @@
 #ifndef __INTERP_H
 #define __INTERP_H
 
+#if defined(USE_ASM_INTRINSIC)
+#include <immintrin.h>
+#define INTERP_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
 /***************************************************************************/
 /* Basic types */
 
@@ -464,6 +469,20 @@ INTERP_YUY2_GEN3(14, 1, 1)
 INTERP_YUY2_GEN2(15, 1)
 INTERP_YUY2_GEN2(9, 7)
 
+/**
+ * Limits used by the diff functions.
+ */
+#define INTERP_Y_LIMIT 0x30
+#define INTERP_U_LIMIT 0x07
+#define INTERP_V_LIMIT 0x06
+
+/* Multipled version */
+#define INTERP_Y_LIMIT_S2 (INTERP_Y_LIMIT << 2)
+#define INTERP_U_LIMIT_S2 (INTERP_U_LIMIT << 2)
+#define INTERP_V_LIMIT_S3 (INTERP_V_LIMIT << 3)
+#define INTERP_U_LIMIT_S8 (INTERP_U_LIMIT << 8)
+#define INTERP_V_LIMIT_S24 (INTERP_V_LIMIT << 24)
+
 /**
  * Compares two pixels and return if different.
  * Used by HQ/LQ algorithm.
@@ -500,6 +519,727 @@ static inline int interp_32_dist3(interp_uint32 p1, interp_uint32 p2, interp_uin
 }
 int interp_yuy2_dist3(interp_uint32 p1, interp_uint32 p2, interp_uint32 p3);
 
+/***************************************************************************/
+/* vector interpolation */
+
+#if defined(USE_ASM_INTRINSIC)
+
+/*
+ * Vector versions of the interp_16_*() and interp_32_*() functions.
+ * Every 32 bits lane contains a pixel, also for the 16 bits format,
+ * to have the same intermediate precision of the scalar versions.
+ * All the results are the same of the scalar versions.
+ */
+
+/**
+ * Masks used by the vector interpolation functions.
+ * Initialize it with interp_16_sse2_set() or interp_32_sse2_set().
+ */
+struct interp_sse2_struct {
+	__m128i mask1; /**< Like INTERP_*_MASK_1. */
+	__m128i mask2; /**< Like INTERP_*_MASK_2. */
+	__m128i hnmask; /**< Like INTERP_*_HNMASK. */
+	__m128i diff_red; /**< Red mask for the 16 bits diff and dist. */
+	__m128i diff_green; /**< Green mask for the 16 bits diff and dist. */
+	__m128i diff_red_shift; /**< Red shift for the 16 bits diff and dist. */
+	__m128i diff_green_shift; /**< Green shift for the 16 bits diff and dist. */
+};
+
+static inline void interp_16_sse2_set(struct interp_sse2_struct* k)
+{
+	k->mask1 = _mm_set1_epi32(interp_mask[0]);
+	k->mask2 = _mm_set1_epi32(interp_mask[1]);
+	k->hnmask = _mm_set1_epi32(interp_highnot_mask);
+	if (interp_green_mask == 0x7E0) {
+		k->diff_red = _mm_set1_epi32(0xF800);
+		k->diff_green = _mm_set1_epi32(0x7E0);
+		k->diff_red_shift = _mm_cvtsi32_si128(8);
+		k->diff_green_shift = _mm_cvtsi32_si128(3);
+	} else {
+		k->diff_red = _mm_set1_epi32(0x7C00);
+		k->diff_green = _mm_set1_epi32(0x3E0);
+		k->diff_red_shift = _mm_cvtsi32_si128(7);
+		k->diff_green_shift = _mm_cvtsi32_si128(2);
+	}
+}
+
+static inline void interp_32_sse2_set(struct interp_sse2_struct* k)
+{
+	k->mask1 = _mm_set1_epi32(0xFF00FF);
+	k->mask2 = _mm_set1_epi32(0x00FF00);
+	k->hnmask = _mm_set1_epi32(INTERP_32_HNMASK);
+	k->diff_red = _mm_setzero_si128();
+	k->diff_green = _mm_setzero_si128();
+	k->diff_red_shift = _mm_setzero_si128();
+	k->diff_green_shift = _mm_setzero_si128();
+}
+
+/* Multiply by a constant with shifts and adds, SSE2 has no 32 bits multiply */
+static inline __m128i interp_sse2_mul(__m128i x, unsigned w)
+{
+	__m128i r = _mm_setzero_si128();
+
+	if (w & 1)
+		r = _mm_add_epi32(r, x);
+	if (w & 2)
+		r = _mm_add_epi32(r, _mm_slli_epi32(x, 1));
+	if (w & 4)
+		r = _mm_add_epi32(r, _mm_slli_epi32(x, 2));
+	if (w & 8)
+		r = _mm_add_epi32(r, _mm_slli_epi32(x, 3));
+	if (w & 16)
+		r = _mm_add_epi32(r, _mm_slli_epi32(x, 4));
+
+	return r;
+}
+
+/* Weighted sum of three pixels divided by (1 << shift) */
+static inline __m128i interp_sse2_mix(const struct interp_sse2_struct* k, __m128i p1, unsigned w1, __m128i p2, unsigned w2, __m128i p3, unsigned w3, unsigned shift)
+{
+	__m128i a, b;
+
+	a = _mm_add_epi32(interp_sse2_mul(_mm_and_si128(p1, k->mask1), w1), interp_sse2_mul(_mm_and_si128(p2, k->mask1), w2));
+	a = _mm_add_epi32(a, interp_sse2_mul(_mm_and_si128(p3, k->mask1), w3));
+	b = _mm_add_epi32(interp_sse2_mul(_mm_and_si128(p1, k->mask2), w1), interp_sse2_mul(_mm_and_si128(p2, k->mask2), w2));
+	b = _mm_add_epi32(b, interp_sse2_mul(_mm_and_si128(p3, k->mask2), w3));
+
+	return _mm_or_si128(_mm_and_si128(_mm_srli_epi32(a, shift), k->mask1), _mm_and_si128(_mm_srli_epi32(b, shift), k->mask2));
+}
+
+#define INTERP_SSE2_GEN2(a, b) \
+	static inline __m128i interp_sse2_ ## a ## b(const struct interp_sse2_struct* k, __m128i p1, __m128i p2) \
+	{ \
+		return interp_sse2_mix(k, p1, a, p2, b, p2, 0, 4); \
+	}
+
+#define INTERP_SSE2_GEN3(a, b, c) \
+	static inline __m128i interp_sse2_ ## a ## b ## c(const struct interp_sse2_struct* k, __m128i p1, __m128i p2, __m128i p3) \
+	{ \
+		return interp_sse2_mix(k, p1, a, p2, b, p3, c, 4); \
+	}
+
+static inline __m128i interp_sse2_11(const struct interp_sse2_struct* k, __m128i p1, __m128i p2)
+{
+#ifdef USE_INTERP_MASK_1
+	return interp_sse2_mix(k, p1, 1, p2, 1, p2, 0, 1);
+#else
+	return _mm_add_epi32(_mm_and_si128(_mm_srli_epi32(_mm_xor_si128(p1, p2), 1), k->hnmask), _mm_and_si128(p1, p2));
+#endif
+}
+
+static inline __m128i interp_sse2_211(const struct interp_sse2_struct* k, __m128i p1, __m128i p2, __m128i p3)
+{
+#ifdef USE_INTERP_MASK_2
+	return interp_sse2_mix(k, p1, 2, p2, 1, p3, 1, 2);
+#else
+	return interp_sse2_11(k, p1, interp_sse2_11(k, p2, p3));
+#endif
+}
+
+static inline __m128i interp_sse2_31(const struct interp_sse2_struct* k, __m128i p1, __m128i p2)
+{
+#ifdef USE_INTERP_MASK_2
+	return interp_sse2_mix(k, p1, 3, p2, 1, p2, 0, 2);
+#else
+	return interp_sse2_11(k, p1, interp_sse2_11(k, p1, p2));
+#endif
+}
+
+static inline __m128i interp_sse2_521(const struct interp_sse2_struct* k, __m128i p1, __m128i p2, __m128i p3)
+{
+#ifdef USE_INTERP_MASK_3
+	return interp_sse2_mix(k, p1, 5, p2, 2, p3, 1, 3);
+#else
+	return interp_sse2_11(k, p1, interp_sse2_11(k, p2, interp_sse2_11(k, p1, p3)));
+#endif
+}
+
+static inline __m128i interp_sse2_431(const struct interp_sse2_struct* k, __m128i p1, __m128i p2, __m128i p3)
+{
+#ifdef USE_INTERP_MASK_3
+	return interp_sse2_mix(k, p1, 4, p2, 3, p3, 1, 3);
+#else
+	return interp_sse2_11(k, p1, interp_sse2_11(k, p2, interp_sse2_11(k, p2, p3)));
+#endif
+}
+
+static inline __m128i interp_sse2_53(const struct interp_sse2_struct* k, __m128i p1, __m128i p2)
+{
+#ifdef USE_INTERP_MASK_3
+	return interp_sse2_mix(k, p1, 5, p2, 3, p2, 0, 3);
+#else
+	return interp_sse2_11(k, p1, interp_sse2_11(k, p2, interp_sse2_11(k, p1, p2)));
+#endif
+}
+
+static inline __m128i interp_sse2_332(const struct interp_sse2_struct* k, __m128i p1, __m128i p2, __m128i p3)
+{
+#ifdef USE_INTERP_MASK_3
+	return interp_sse2_mix(k, p1, 3, p2, 3, p3, 2, 3);
+#else
+	__m128i t = interp_sse2_11(k, p1, p2);
+	return interp_sse2_11(k, t, interp_sse2_11(k, p3, t));
+#endif
+}
+
+static inline __m128i interp_sse2_611(const struct interp_sse2_struct* k, __m128i p1, __m128i p2, __m128i p3)
+{
+#ifdef USE_INTERP_MASK_3
+	return interp_sse2_mix(k, p1, 6, p2, 1, p3, 1, 3);
+#else
+	return interp_sse2_11(k, p1, interp_sse2_11(k, p1, interp_sse2_11(k, p2, p3)));
+#endif
+}
+
+static inline __m128i interp_sse2_71(const struct interp_sse2_struct* k, __m128i p1, __m128i p2)
+{
+#ifdef USE_INTERP_MASK_3
+	return interp_sse2_mix(k, p1, 7, p2, 1, p2, 0, 3);
+#else
+	return interp_sse2_11(k, p1, interp_sse2_11(k, p1, interp_sse2_11(k, p1, p2)));
+#endif
+}
+
+INTERP_SSE2_GEN3(6, 5, 5)
+INTERP_SSE2_GEN3(7, 5, 4)
+INTERP_SSE2_GEN3(7, 6, 3)
+INTERP_SSE2_GEN3(7, 7, 2)
+INTERP_SSE2_GEN3(8, 5, 3)
+INTERP_SSE2_GEN3(9, 4, 3)
+INTERP_SSE2_GEN3(9, 6, 1)
+INTERP_SSE2_GEN3(10, 3, 3)
+INTERP_SSE2_GEN3(10, 5, 1)
+INTERP_SSE2_GEN3(11, 3, 2)
+INTERP_SSE2_GEN2(11, 5)
+INTERP_SSE2_GEN3(12, 3, 1)
+INTERP_SSE2_GEN2(13, 3)
+INTERP_SSE2_GEN3(14, 1, 1)
+INTERP_SSE2_GEN2(15, 1)
+INTERP_SSE2_GEN2(9, 7)
+
+/* Lanes with the value out of the [-limit, limit] range */
+static inline __m128i interp_sse2_outside(__m128i v, int limit)
+{
+	return _mm_or_si128(_mm_cmpgt_epi32(v, _mm_set1_epi32(limit)), _mm_cmplt_epi32(v, _mm_set1_epi32(-limit)));
+}
+
+/* Lanes with the y, u, v differences out of the limits */
+static inline __m128i interp_sse2_yuv(__m128i r, __m128i g, __m128i b)
+{
+	__m128i y = _mm_add_epi32(_mm_add_epi32(r, g), b);
+	__m128i u = _mm_sub_epi32(r, b);
+	__m128i v = _mm_sub_epi32(_mm_sub_epi32(_mm_slli_epi32(g, 1), r), b);
+
+	return _mm_or_si128(_mm_or_si128(interp_sse2_outside(y, INTERP_Y_LIMIT_S2), interp_sse2_outside(u, INTERP_U_LIMIT_S2)), interp_sse2_outside(v, INTERP_V_LIMIT_S3));
+}
+
+/**
+ * Compares two vectors of pixels like interp_16_diff().
+ * \return All the bits set in the lanes with different pixels.
+ */
+static inline __m128i interp_16_sse2_diff(const struct interp_sse2_struct* k, __m128i p1, __m128i p2)
+{
+	__m128i m = _mm_set1_epi32(0x1F);
+	__m128i r, g, b;
+
+	b = _mm_slli_epi32(_mm_sub_epi32(_mm_and_si128(p1, m), _mm_and_si128(p2, m)), 3);
+	g = _mm_sra_epi32(_mm_sub_epi32(_mm_and_si128(p1, k->diff_green), _mm_and_si128(p2, k->diff_green)), k->diff_green_shift);
+	r = _mm_sra_epi32(_mm_sub_epi32(_mm_and_si128(p1, k->diff_red), _mm_and_si128(p2, k->diff_red)), k->diff_red_shift);
+
+	return interp_sse2_yuv(r, g, b);
+}
+
+/**
+ * Compares two vectors of pixels like interp_32_diff().
+ * \return All the bits set in the lanes with different pixels.
+ */
+static inline __m128i interp_32_sse2_diff(const struct interp_sse2_struct* k, __m128i p1, __m128i p2)
+{
+	__m128i m = _mm_set1_epi32(0xFF);
+	__m128i r, g, b;
+
+	b = _mm_sub_epi32(_mm_and_si128(p1, m), _mm_and_si128(p2, m));
+	g = _mm_sub_epi32(_mm_and_si128(_mm_srli_epi32(p1, 8), m), _mm_and_si128(_mm_srli_epi32(p2, 8), m));
+	r = _mm_sub_epi32(_mm_and_si128(_mm_srli_epi32(p1, 16), m), _mm_and_si128(_mm_srli_epi32(p2, 16), m));
+
+	return interp_sse2_yuv(r, g, b);
+}
+
+/* Absolute value of 32 bits lanes */
+static inline __m128i interp_sse2_abs(__m128i v)
+{
+	__m128i s = _mm_srai_epi32(v, 31);
+	return _mm_sub_epi32(_mm_xor_si128(v, s), s);
+}
+
+/* Select a in the lanes with the mask set, and b in the others */
+static inline __m128i interp_sse2_select(__m128i m, __m128i a, __m128i b)
+{
+	return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b));
+}
+
+/**
+ * Computes the distance of two vectors of pixels like interp_16_dist().
+ */
+static inline __m128i interp_16_sse2_dist(const struct interp_sse2_struct* k, __m128i p1, __m128i p2)
+{
+	__m128i m = _mm_set1_epi32(0x1F);
+	__m128i r, g, b;
+
+	b = _mm_slli_epi32(_mm_sub_epi32(_mm_and_si128(p1, m), _mm_and_si128(p2, m)), 3);
+	g = _mm_sra_epi32(_mm_sub_epi32(_mm_and_si128(p1, k->diff_green), _mm_and_si128(p2, k->diff_green)), k->diff_green_shift);
+	r = _mm_sra_epi32(_mm_sub_epi32(_mm_and_si128(p1, k->diff_red), _mm_and_si128(p2, k->diff_red)), k->diff_red_shift);
+
+	r = interp_sse2_abs(r);
+	g = interp_sse2_abs(g);
+	b = interp_sse2_abs(b);
+
+	/* 3 * r + 4 * g + 2 * b */
+	return _mm_add_epi32(_mm_add_epi32(r, _mm_slli_epi32(r, 1)), _mm_add_epi32(_mm_slli_epi32(g, 2), _mm_slli_epi32(b, 1)));
+}
+
+/**
+ * Computes the distance of two vectors of pixels like interp_32_dist().
+ */
+static inline __m128i interp_32_sse2_dist(const struct interp_sse2_struct* k, __m128i p1, __m128i p2)
+{
+	__m128i m = _mm_set1_epi32(0xFF);
+	__m128i h = _mm_set1_epi32(0xF8F8F8);
+	__m128i r, g, b, d;
+
+	(void)k;
+
+	b = _mm_sub_epi32(_mm_and_si128(p1, m), _mm_and_si128(p2, m));
+	g = _mm_sub_epi32(_mm_and_si128(_mm_srli_epi32(p1, 8), m), _mm_and_si128(_mm_srli_epi32(p2, 8), m));
+	r = _mm_sub_epi32(_mm_and_si128(_mm_srli_epi32(p1, 16), m), _mm_and_si128(_mm_srli_epi32(p2, 16), m));
+
+	r = interp_sse2_abs(r);
+	g = interp_sse2_abs(g);
+	b = interp_sse2_abs(b);
+
+	/* 3 * r + 4 * g + 2 * b */
+	d = _mm_add_epi32(_mm_add_epi32(r, _mm_slli_epi32(r, 1)), _mm_add_epi32(_mm_slli_epi32(g, 2), _mm_slli_epi32(b, 1)));
+
+	/* zero if the high bits are equal */
+	return _mm_andnot_si128(_mm_cmpeq_epi32(_mm_and_si128(p1, h), _mm_and_si128(p2, h)), d);
+}
+
+/* Interleave n = 2, 3, 4 vectors of pixels, the vector i of the result contains the pixels from 4 * i */
+static inline void interp_sse2_interleave(__m128i* v, const __m128i* o, unsigned n)
+{
+	if (n == 3) {
+		__m128 ab = _mm_castsi128_ps(_mm_unpacklo_epi32(o[0], o[1]));
+		__m128 ca = _mm_castsi128_ps(_mm_unpacklo_epi32(o[2], o[0]));
+		__m128 bc = _mm_castsi128_ps(_mm_unpacklo_epi32(o[1], o[2]));
+		__m128 abh = _mm_castsi128_ps(_mm_unpackhi_epi32(o[0], o[1]));
+		__m128 cah = _mm_castsi128_ps(_mm_unpackhi_epi32(o[2], o[0]));
+		__m128 bch = _mm_castsi128_ps(_mm_unpackhi_epi32(o[1], o[2]));
+		v[0] = _mm_castps_si128(_mm_shuffle_ps(ab, ca, _MM_SHUFFLE(3, 0, 1, 0)));
+		v[1] = _mm_castps_si128(_mm_shuffle_ps(bc, abh, _MM_SHUFFLE(1, 0, 3, 2)));
+		v[2] = _mm_castps_si128(_mm_shuffle_ps(cah, bch, _MM_SHUFFLE(3, 2, 3, 0)));
+	} else if (n == 2) {
+		v[0] = _mm_unpacklo_epi32(o[0], o[1]);
+		v[1] = _mm_unpackhi_epi32(o[0], o[1]);
+	} else {
+		__m128i a = _mm_unpacklo_epi32(o[0], o[1]);
+		__m128i b = _mm_unpacklo_epi32(o[2], o[3]);
+		__m128i c = _mm_unpackhi_epi32(o[0], o[1]);
+		__m128i d = _mm_unpackhi_epi32(o[2], o[3]);
+		v[0] = _mm_unpacklo_epi64(a, b);
+		v[1] = _mm_unpackhi_epi64(a, b);
+		v[2] = _mm_unpacklo_epi64(c, d);
+		v[3] = _mm_unpackhi_epi64(c, d);
+	}
+}
+
+/**
+ * Stores interleaved n = 2, 3, 4 vectors of 32 bits pixels.
+ * The pixel j of the vector i is stored at dst[n * j + i].
+ */
+static inline void interp_32_sse2_store(interp_uint32* dst, const __m128i* o, unsigned n)
+{
+	__m128i v[4];
+	unsigned i;
+
+	interp_sse2_interleave(v, o, n);
+	for (i = 0; i < n; ++i)
+		_mm_storeu_si128((__m128i*)(dst + 4 * i), v[i]);
+}
+
+/* Packs two vectors of 16 bits pixels in 32 bits lanes */
+static inline __m128i interp_16_sse2_pack(__m128i a, __m128i b)
+{
+	a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+	b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+	return _mm_packs_epi32(a, b);
+}
+
+/**
+ * Stores interleaved n = 2, 3, 4 vectors of 16 bits pixels in 32 bits lanes.
+ * The pixel j of the vector i is stored at dst[n * j + i].
+ */
+static inline void interp_16_sse2_store(interp_uint16* dst, const __m128i* o, unsigned n)
+{
+	__m128i v[4];
+	unsigned i;
+
+	interp_sse2_interleave(v, o, n);
+	for (i = 0; i + 1 < n; i += 2)
+		_mm_storeu_si128((__m128i*)(dst + 4 * i), interp_16_sse2_pack(v[i], v[i + 1]));
+	if (i < n)
+		_mm_storel_epi64((__m128i*)(dst + 4 * i), interp_16_sse2_pack(v[i], v[i]));
+}
+
+/**
+ * Masks used by the vector interpolation functions.
+ * Initialize it with interp_16_avx2_set() or interp_32_avx2_set().
+ */
+struct interp_avx2_struct {
+	__m256i mask1; /**< Like INTERP_*_MASK_1. */
+	__m256i mask2; /**< Like INTERP_*_MASK_2. */
+	__m256i hnmask; /**< Like INTERP_*_HNMASK. */
+	__m256i diff_red; /**< Red mask for the 16 bits diff and dist. */
+	__m256i diff_green; /**< Green mask for the 16 bits diff and dist. */
+	__m128i diff_red_shift; /**< Red shift for the 16 bits diff and dist. */
+	__m128i diff_green_shift; /**< Green shift for the 16 bits diff and dist. */
+};
+
+static inline INTERP_TARGET_AVX2 void interp_16_avx2_set(struct interp_avx2_struct* k)
+{
+	k->mask1 = _mm256_set1_epi32(interp_mask[0]);
+	k->mask2 = _mm256_set1_epi32(interp_mask[1]);
+	k->hnmask = _mm256_set1_epi32(interp_highnot_mask);
+	if (interp_green_mask == 0x7E0) {
+		k->diff_red = _mm256_set1_epi32(0xF800);
+		k->diff_green = _mm256_set1_epi32(0x7E0);
+		k->diff_red_shift = _mm_cvtsi32_si128(8);
+		k->diff_green_shift = _mm_cvtsi32_si128(3);
+	} else {
+		k->diff_red = _mm256_set1_epi32(0x7C00);
+		k->diff_green = _mm256_set1_epi32(0x3E0);
+		k->diff_red_shift = _mm_cvtsi32_si128(7);
+		k->diff_green_shift = _mm_cvtsi32_si128(2);
+	}
+}
+
+static inline INTERP_TARGET_AVX2 void interp_32_avx2_set(struct interp_avx2_struct* k)
+{
+	k->mask1 = _mm256_set1_epi32(0xFF00FF);
+	k->mask2 = _mm256_set1_epi32(0x00FF00);
+	k->hnmask = _mm256_set1_epi32(INTERP_32_HNMASK);
+	k->diff_red = _mm256_setzero_si256();
+	k->diff_green = _mm256_setzero_si256();
+	k->diff_red_shift = _mm_setzero_si128();
+	k->diff_green_shift = _mm_setzero_si128();
+}
+
+static inline INTERP_TARGET_AVX2 __m256i interp_avx2_mul(__m256i x, unsigned w)
+{
+	return _mm256_mullo_epi32(x, _mm256_set1_epi32(w));
+}
+
+/* Weighted sum of three pixels divided by (1 << shift) */
+static inline INTERP_TARGET_AVX2 __m256i interp_avx2_mix(const struct interp_avx2_struct* k, __m256i p1, unsigned w1, __m256i p2, unsigned w2, __m256i p3, unsigned w3, unsigned shift)
+{
+	__m256i a, b;
+
+	a = _mm256_add_epi32(interp_avx2_mul(_mm256_and_si256(p1, k->mask1), w1), interp_avx2_mul(_mm256_and_si256(p2, k->mask1), w2));
+	a = _mm256_add_epi32(a, interp_avx2_mul(_mm256_and_si256(p3, k->mask1), w3));
+	b = _mm256_add_epi32(interp_avx2_mul(_mm256_and_si256(p1, k->mask2), w1), interp_avx2_mul(_mm256_and_si256(p2, k->mask2), w2));
+	b = _mm256_add_epi32(b, interp_avx2_mul(_mm256_and_si256(p3, k->mask2), w3));
+
+	return _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(a, shift), k->mask1), _mm256_and_si256(_mm256_srli_epi32(b, shift), k->mask2));
+}
+
+#define INTERP_AVX2_GEN2(a, b) \
+	static inline INTERP_TARGET_AVX2 __m256i interp_avx2_ ## a ## b(const struct interp_avx2_struct* k, __m256i p1, __m256i p2) \
+	{ \
+		return interp_avx2_mix(k, p1, a, p2, b, p2, 0, 4); \
+	}
+
+#define INTERP_AVX2_GEN3(a, b, c) \
+	static inline INTERP_TARGET_AVX2 __m256i interp_avx2_ ## a ## b ## c(const struct interp_avx2_struct* k, __m256i p1, __m256i p2, __m256i p3) \
+	{ \
+		return interp_avx2_mix(k, p1, a, p2, b, p3, c, 4); \
+	}
+
+static inline INTERP_TARGET_AVX2 __m256i interp_avx2_11(const struct interp_avx2_struct* k, __m256i p1, __m256i p2)
+{
+#ifdef USE_INTERP_MASK_1
+	return interp_avx2_mix(k, p1, 1, p2, 1, p2, 0, 1);
+#else
+	return _mm256_add_epi32(_mm256_and_si256(_mm256_srli_epi32(_mm256_xor_si256(p1, p2), 1), k->hnmask), _mm256_and_si256(p1, p2));
+#endif
+}
+
+static inline INTERP_TARGET_AVX2 __m256i interp_avx2_211(const struct interp_avx2_struct* k, __m256i p1, __m256i p2, __m256i p3)
+{
+#ifdef USE_INTERP_MASK_2
+	return interp_avx2_mix(k, p1, 2, p2, 1, p3, 1, 2);
+#else
+	return interp_avx2_11(k, p1, interp_avx2_11(k, p2, p3));
+#endif
+}
+
+static inline INTERP_TARGET_AVX2 __m256i interp_avx2_31(const struct interp_avx2_struct* k, __m256i p1, __m256i p2)
+{
+#ifdef USE_INTERP_MASK_2
+	return interp_avx2_mix(k, p1, 3, p2, 1, p2, 0, 2);
+#else
+	return interp_avx2_11(k, p1, interp_avx2_11(k, p1, p2));
+#endif
+}
+
+static inline INTERP_TARGET_AVX2 __m256i interp_avx2_521(const struct interp_avx2_struct* k, __m256i p1, __m256i p2, __m256i p3)
+{
+#ifdef USE_INTERP_MASK_3
+	return interp_avx2_mix(k, p1, 5, p2, 2, p3, 1, 3);
+#else
+	return interp_avx2_11(k, p1, interp_avx2_11(k, p2, interp_avx2_11(k, p1, p3)));
+#endif
+}
+
+static inline INTERP_TARGET_AVX2 __m256i interp_avx2_431(const struct interp_avx2_struct* k, __m256i p1, __m256i p2, __m256i p3)
+{
+#ifdef USE_INTERP_MASK_3
+	return interp_avx2_mix(k, p1, 4, p2, 3, p3, 1, 3);
+#else
+	return interp_avx2_11(k, p1, interp_avx2_11(k, p2, interp_avx2_11(k, p2, p3)));
+#endif
+}
+
+static inline INTERP_TARGET_AVX2 __m256i interp_avx2_53(const struct interp_avx2_struct* k, __m256i p1, __m256i p2)
+{
+#ifdef USE_INTERP_MASK_3
+	return interp_avx2_mix(k, p1, 5, p2, 3, p2, 0, 3);
+#else
+	return interp_avx2_11(k, p1, interp_avx2_11(k, p2, interp_avx2_11(k, p1, p2)));
+#endif
+}
+
+static inline INTERP_TARGET_AVX2 __m256i interp_avx2_332(const struct interp_avx2_struct* k, __m256i p1, __m256i p2, __m256i p3)
+{
+#ifdef USE_INTERP_MASK_3
+	return interp_avx2_mix(k, p1, 3, p2, 3, p3, 2, 3);
+#else
+	__m256i t = interp_avx2_11(k, p1, p2);
+	return interp_avx2_11(k, t, interp_avx2_11(k, p3, t));
+#endif
+}
+
+static inline INTERP_TARGET_AVX2 __m256i interp_avx2_611(const struct interp_avx2_struct* k, __m256i p1, __m256i p2, __m256i p3)
+{
+#ifdef USE_INTERP_MASK_3
+	return interp_avx2_mix(k, p1, 6, p2, 1, p3, 1, 3);
+#else
+	return interp_avx2_11(k, p1, interp_avx2_11(k, p1, interp_avx2_11(k, p2, p3)));
+#endif
+}
+
+static inline INTERP_TARGET_AVX2 __m256i interp_avx2_71(const struct interp_avx2_struct* k, __m256i p1, __m256i p2)
+{
+#ifdef USE_INTERP_MASK_3
+	return interp_avx2_mix(k, p1, 7, p2, 1, p2, 0, 3);
+#else
+	return interp_avx2_11(k, p1, interp_avx2_11(k, p1, interp_avx2_11(k, p1, p2)));
+#endif
+}
+
+INTERP_AVX2_GEN3(6, 5, 5)
+INTERP_AVX2_GEN3(7, 5, 4)
+INTERP_AVX2_GEN3(7, 6, 3)
+INTERP_AVX2_GEN3(7, 7, 2)
+INTERP_AVX2_GEN3(8, 5, 3)
+INTERP_AVX2_GEN3(9, 4, 3)
+INTERP_AVX2_GEN3(9, 6, 1)
+INTERP_AVX2_GEN3(10, 3, 3)
+INTERP_AVX2_GEN3(10, 5, 1)
+INTERP_AVX2_GEN3(11, 3, 2)
+INTERP_AVX2_GEN2(11, 5)
+INTERP_AVX2_GEN3(12, 3, 1)
+INTERP_AVX2_GEN2(13, 3)
+INTERP_AVX2_GEN3(14, 1, 1)
+INTERP_AVX2_GEN2(15, 1)
+INTERP_AVX2_GEN2(9, 7)
+
+/* Lanes with the value out of the [-limit, limit] range */
+static inline INTERP_TARGET_AVX2 __m256i interp_avx2_outside(__m256i v, int limit)
+{
+	return _mm256_or_si256(_mm256_cmpgt_epi32(v, _mm256_set1_epi32(limit)), _mm256_cmpgt_epi32(_mm256_set1_epi32(-limit), v));
+}
+
+/* Lanes with the y, u, v differences out of the limits */
+static inline INTERP_TARGET_AVX2 __m256i interp_avx2_yuv(__m256i r, __m256i g, __m256i b)
+{
+	__m256i y = _mm256_add_epi32(_mm256_add_epi32(r, g), b);
+	__m256i u = _mm256_sub_epi32(r, b);
+	__m256i v = _mm256_sub_epi32(_mm256_sub_epi32(_mm256_slli_epi32(g, 1), r), b);
+
+	return _mm256_or_si256(_mm256_or_si256(interp_avx2_outside(y, INTERP_Y_LIMIT_S2), interp_avx2_outside(u, INTERP_U_LIMIT_S2)), interp_avx2_outside(v, INTERP_V_LIMIT_S3));
+}
+
+/**
+ * Compares two vectors of pixels like interp_16_diff().
+ * \return All the bits set in the lanes with different pixels.
+ */
+static inline INTERP_TARGET_AVX2 __m256i interp_16_avx2_diff(const struct interp_avx2_struct* k, __m256i p1, __m256i p2)
+{
+	__m256i m = _mm256_set1_epi32(0x1F);
+	__m256i r, g, b;
+
+	b = _mm256_slli_epi32(_mm256_sub_epi32(_mm256_and_si256(p1, m), _mm256_and_si256(p2, m)), 3);
+	g = _mm256_sra_epi32(_mm256_sub_epi32(_mm256_and_si256(p1, k->diff_green), _mm256_and_si256(p2, k->diff_green)), k->diff_green_shift);
+	r = _mm256_sra_epi32(_mm256_sub_epi32(_mm256_and_si256(p1, k->diff_red), _mm256_and_si256(p2, k->diff_red)), k->diff_red_shift);
+
+	return interp_avx2_yuv(r, g, b);
+}
+
+/**
+ * Compares two vectors of pixels like interp_32_diff().
+ * \return All the bits set in the lanes with different pixels.
+ */
+static inline INTERP_TARGET_AVX2 __m256i interp_32_avx2_diff(const struct interp_avx2_struct* k, __m256i p1, __m256i p2)
+{
+	__m256i m = _mm256_set1_epi32(0xFF);
+	__m256i r, g, b;
+
+	b = _mm256_sub_epi32(_mm256_and_si256(p1, m), _mm256_and_si256(p2, m));
+	g = _mm256_sub_epi32(_mm256_and_si256(_mm256_srli_epi32(p1, 8), m), _mm256_and_si256(_mm256_srli_epi32(p2, 8), m));
+	r = _mm256_sub_epi32(_mm256_and_si256(_mm256_srli_epi32(p1, 16), m), _mm256_and_si256(_mm256_srli_epi32(p2, 16), m));
+
+	return interp_avx2_yuv(r, g, b);
+}
+
+/* Absolute value of 32 bits lanes */
+static inline INTERP_TARGET_AVX2 __m256i interp_avx2_abs(__m256i v)
+{
+	return _mm256_abs_epi32(v);
+}
+
+/* Select a in the lanes with the mask set, and b in the others */
+static inline INTERP_TARGET_AVX2 __m256i interp_avx2_select(__m256i m, __m256i a, __m256i b)
+{
+	return _mm256_blendv_epi8(b, a, m);
+}
+
+/**
+ * Computes the distance of two vectors of pixels like interp_16_dist().
+ */
+static inline INTERP_TARGET_AVX2 __m256i interp_16_avx2_dist(const struct interp_avx2_struct* k, __m256i p1, __m256i p2)
+{
+	__m256i m = _mm256_set1_epi32(0x1F);
+	__m256i r, g, b;
+
+	b = _mm256_slli_epi32(_mm256_sub_epi32(_mm256_and_si256(p1, m), _mm256_and_si256(p2, m)), 3);
+	g = _mm256_sra_epi32(_mm256_sub_epi32(_mm256_and_si256(p1, k->diff_green), _mm256_and_si256(p2, k->diff_green)), k->diff_green_shift);
+	r = _mm256_sra_epi32(_mm256_sub_epi32(_mm256_and_si256(p1, k->diff_red), _mm256_and_si256(p2, k->diff_red)), k->diff_red_shift);
+
+	r = interp_avx2_abs(r);
+	g = interp_avx2_abs(g);
+	b = interp_avx2_abs(b);
+
+	/* 3 * r + 4 * g + 2 * b */
+	return _mm256_add_epi32(_mm256_add_epi32(r, _mm256_slli_epi32(r, 1)), _mm256_add_epi32(_mm256_slli_epi32(g, 2), _mm256_slli_epi32(b, 1)));
+}
+
+/**
+ * Computes the distance of two vectors of pixels like interp_32_dist().
+ */
+static inline INTERP_TARGET_AVX2 __m256i interp_32_avx2_dist(const struct interp_avx2_struct* k, __m256i p1, __m256i p2)
+{
+	__m256i h = _mm256_set1_epi32(0xF8F8F8);
+	__m256i d;
+
+	(void)k;
+
+	/* absolute difference of every channel */
+	d = _mm256_or_si256(_mm256_subs_epu8(p1, p2), _mm256_subs_epu8(p2, p1));
+
+	/* 3 * r + 4 * g + 2 * b, ignoring the fourth channel */
+	d = _mm256_maddubs_epi16(d, _mm256_set1_epi32(0x00030402));
+	d = _mm256_madd_epi16(d, _mm256_set1_epi16(1));
+
+	/* zero if the high bits are equal */
+	return _mm256_andnot_si256(_mm256_cmpeq_epi32(_mm256_and_si256(p1, h), _mm256_and_si256(p2, h)), d);
+}
+
+/* Interleave n = 2, 3, 4 vectors of pixels, the vector i of the result contains the pixels from 8 * i */
+static inline INTERP_TARGET_AVX2 void interp_avx2_interleave(__m256i* v, const __m256i* o, unsigned n)
+{
+	if (n == 3) {
+		__m256 ab = _mm256_castsi256_ps(_mm256_unpacklo_epi32(o[0], o[1]));
+		__m256 ca = _mm256_castsi256_ps(_mm256_unpacklo_epi32(o[2], o[0]));
+		__m256 bc = _mm256_castsi256_ps(_mm256_unpacklo_epi32(o[1], o[2]));
+		__m256 abh = _mm256_castsi256_ps(_mm256_unpackhi_epi32(o[0], o[1]));
+		__m256 cah = _mm256_castsi256_ps(_mm256_unpackhi_epi32(o[2], o[0]));
+		__m256 bch = _mm256_castsi256_ps(_mm256_unpackhi_epi32(o[1], o[2]));
+		__m256i p0 = _mm256_castps_si256(_mm256_shuffle_ps(ab, ca, _MM_SHUFFLE(3, 0, 1, 0)));
+		__m256i p1 = _mm256_castps_si256(_mm256_shuffle_ps(bc, abh, _MM_SHUFFLE(1, 0, 3, 2)));
+		__m256i p2 = _mm256_castps_si256(_mm256_shuffle_ps(cah, bch, _MM_SHUFFLE(3, 2, 3, 0)));
+		v[0] = _mm256_permute2x128_si256(p0, p1, 0x20);
+		v[1] = _mm256_permute2x128_si256(p2, p0, 0x30);
+		v[2] = _mm256_permute2x128_si256(p1, p2, 0x31);
+	} else if (n == 2) {
+		__m256i a = _mm256_unpacklo_epi32(o[0], o[1]);
+		__m256i b = _mm256_unpackhi_epi32(o[0], o[1]);
+		v[0] = _mm256_permute2x128_si256(a, b, 0x20);
+		v[1] = _mm256_permute2x128_si256(a, b, 0x31);
+	} else {
+		__m256i a = _mm256_unpacklo_epi32(o[0], o[1]);
+		__m256i b = _mm256_unpacklo_epi32(o[2], o[3]);
+		__m256i c = _mm256_unpackhi_epi32(o[0], o[1]);
+		__m256i d = _mm256_unpackhi_epi32(o[2], o[3]);
+		__m256i p0 = _mm256_unpacklo_epi64(a, b);
+		__m256i p1 = _mm256_unpackhi_epi64(a, b);
+		__m256i p2 = _mm256_unpacklo_epi64(c, d);
+		__m256i p3 = _mm256_unpackhi_epi64(c, d);
+		v[0] = _mm256_permute2x128_si256(p0, p1, 0x20);
+		v[1] = _mm256_permute2x128_si256(p2, p3, 0x20);
+		v[2] = _mm256_permute2x128_si256(p0, p1, 0x31);
+		v[3] = _mm256_permute2x128_si256(p2, p3, 0x31);
+	}
+}
+
+/**
+ * Stores interleaved n = 2, 3, 4 vectors of 32 bits pixels.
+ * The pixel j of the vector i is stored at dst[n * j + i].
+ */
+static inline INTERP_TARGET_AVX2 void interp_32_avx2_store(interp_uint32* dst, const __m256i* o, unsigned n)
+{
+	__m256i v[4];
+	unsigned i;
+
+	interp_avx2_interleave(v, o, n);
+	for (i = 0; i < n; ++i)
+		_mm256_storeu_si256((__m256i*)(dst + 8 * i), v[i]);
+}
+
+/* Packs two vectors of 16 bits pixels in 32 bits lanes */
+static inline INTERP_TARGET_AVX2 __m256i interp_16_avx2_pack(__m256i a, __m256i b)
+{
+	a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+	b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+	return _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xD8);
+}
+
+/**
+ * Stores interleaved n = 2, 3, 4 vectors of 16 bits pixels in 32 bits lanes.
+ * The pixel j of the vector i is stored at dst[n * j + i].
+ */
+static inline INTERP_TARGET_AVX2 void interp_16_avx2_store(interp_uint16* dst, const __m256i* o, unsigned n)
+{
+	__m256i v[4];
+	unsigned i;
+
+	interp_avx2_interleave(v, o, n);
+	for (i = 0; i + 1 < n; i += 2)
+		_mm256_storeu_si256((__m256i*)(dst + 8 * i), interp_16_avx2_pack(v[i], v[i + 1]));
+	if (i < n)
+		_mm_storeu_si128((__m128i*)(dst + 8 * i), _mm256_castsi256_si128(interp_16_avx2_pack(v[i], v[i])));
+}
+
+#endif
+
 void interp_set(unsigned color_def);
 
 #endif
@@ -612,6 +612,212 @@ static inline void internal_rgb_raw32x3_012_def(uint32* dst32, const uint32* src
 	}
 }
 
+#if defined(USE_ASM_INTRINSIC)
+
+/*
+ * Generic mask/shift/add kernel used by the *_sse2 and *_avx2 versions of
+ * the internal_rgb_raw32*_def() functions, with the same result.
+ * *dst = (*src & m0) + ((*src >> 1) & m1) + ((*src >> 2) & m2)
+ * The masks are periodic of 1, 2 or 3 uint32, and a NULL mask is a zero mask.
+ * The count argument is the number of uint32 to process.
+ */
+static inline void internal_rgb_raw32_sse2(uint32* dst32, const uint32* src32, const uint32* m0, const uint32* m1, const uint32* m2, unsigned period, unsigned count)
+{
+	uint32 mask[3][3 * 4];
+	__m128i v0[3], v1[3], v2[3];
+	unsigned round = period == 3 ? 3 : 1;
+	unsigned i;
+
+	for (i = 0; i < 3 * 4; ++i) {
+		mask[0][i] = m0 ? m0[i % period] : 0;
+		mask[1][i] = m1 ? m1[i % period] : 0;
+		mask[2][i] = m2 ? m2[i % period] : 0;
+	}
+
+	for (i = 0; i < 3; ++i) {
+		v0[i] = _mm_loadu_si128((const __m128i*)(mask[0] + 4 * i));
+		v1[i] = _mm_loadu_si128((const __m128i*)(mask[1] + 4 * i));
+		v2[i] = _mm_loadu_si128((const __m128i*)(mask[2] + 4 * i));
+	}
+
+	while (count >= 4 * round) {
+		for (i = 0; i < round; ++i) {
+			__m128i p0 = _mm_loadu_si128((const __m128i*)src32);
+			__m128i p1 = _mm_and_si128(_mm_srli_epi32(p0, 1), v1[i]);
+			__m128i p2 = _mm_and_si128(_mm_srli_epi32(p0, 2), v2[i]);
+			p0 = _mm_and_si128(p0, v0[i]);
+			_mm_storeu_si128((__m128i*)dst32, _mm_add_epi32(_mm_add_epi32(p0, p1), p2));
+			src32 += 4;
+			dst32 += 4;
+		}
+		count -= 4 * round;
+	}
+
+	/* the vector loop always stops at the start of the mask period */
+	for (i = 0; i < count; ++i) {
+		uint32 p = src32[i];
+		dst32[i] = (p & mask[0][i]) + ((p >> 1) & mask[1][i]) + ((p >> 2) & mask[2][i]);
+	}
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_raw32_avx2(uint32* dst32, const uint32* src32, const uint32* m0, const uint32* m1, const uint32* m2, unsigned period, unsigned count)
+{
+	uint32 mask[3][3 * 8];
+	__m256i v0[3], v1[3], v2[3];
+	unsigned round = period == 3 ? 3 : 1;
+	unsigned i;
+
+	for (i = 0; i < 3 * 8; ++i) {
+		mask[0][i] = m0 ? m0[i % period] : 0;
+		mask[1][i] = m1 ? m1[i % period] : 0;
+		mask[2][i] = m2 ? m2[i % period] : 0;
+	}
+
+	for (i = 0; i < 3; ++i) {
+		v0[i] = _mm256_loadu_si256((const __m256i*)(mask[0] + 8 * i));
+		v1[i] = _mm256_loadu_si256((const __m256i*)(mask[1] + 8 * i));
+		v2[i] = _mm256_loadu_si256((const __m256i*)(mask[2] + 8 * i));
+	}
+
+	while (count >= 8 * round) {
+		for (i = 0; i < round; ++i) {
+			__m256i p0 = _mm256_loadu_si256((const __m256i*)src32);
+			__m256i p1 = _mm256_and_si256(_mm256_srli_epi32(p0, 1), v1[i]);
+			__m256i p2 = _mm256_and_si256(_mm256_srli_epi32(p0, 2), v2[i]);
+			p0 = _mm256_and_si256(p0, v0[i]);
+			_mm256_storeu_si256((__m256i*)dst32, _mm256_add_epi32(_mm256_add_epi32(p0, p1), p2));
+			src32 += 8;
+			dst32 += 8;
+		}
+		count -= 8 * round;
+	}
+
+	/* the vector loop always stops at the start of the mask period */
+	for (i = 0; i < count; ++i) {
+		uint32 p = src32[i];
+		dst32[i] = (p & mask[0][i]) + ((p >> 1) & mask[1][i]) + ((p >> 2) & mask[2][i]);
+	}
+}
+
+static inline void internal_rgb_raw32_012_sse2(uint32* dst32, const uint32* src32, const uint32* mask, unsigned count)
+{
+	internal_rgb_raw32_sse2(dst32, src32, mask, mask + 2, mask + 4, 1, count);
+}
+
+static inline void internal_rgb_raw32_01_sse2(uint32* dst32, const uint32* src32, const uint32* mask, unsigned count)
+{
+	internal_rgb_raw32_sse2(dst32, src32, mask, mask + 2, 0, 1, count);
+}
+
+static inline void internal_rgb_raw32_12_sse2(uint32* dst32, const uint32* src32, const uint32* mask, unsigned count)
+{
+	internal_rgb_raw32_sse2(dst32, src32, 0, mask + 2, mask + 4, 1, count);
+}
+
+static inline void internal_rgb_raw32_1_sse2(uint32* dst32, const uint32* src32, const uint32* mask, unsigned count)
+{
+	internal_rgb_raw32_sse2(dst32, src32, 0, mask + 2, 0, 1, count);
+}
+
+static inline void internal_rgb_raw32_2_sse2(uint32* dst32, const uint32* src32, const uint32* mask, unsigned count)
+{
+	internal_rgb_raw32_sse2(dst32, src32, 0, 0, mask + 4, 1, count);
+}
+
+static inline void internal_rgb_raw32_02_sse2(uint32* dst32, const uint32* src32, const uint32* mask, unsigned count)
+{
+	internal_rgb_raw32_sse2(dst32, src32, mask, 0, mask + 4, 1, count);
+}
+
+static inline void internal_rgb_raw32x2_012_sse2(uint32* dst32, const uint32* src32, const uint32* mask, unsigned count)
+{
+	internal_rgb_raw32_sse2(dst32, src32, mask, mask + 2, mask + 4, 2, count);
+}
+
+static inline void internal_rgb_raw32x2_01_sse2(uint32* dst32, const uint32* src32, const uint32* mask, unsigned count)
+{
+	internal_rgb_raw32_sse2(dst32, src32, mask, mask + 2, 0, 2, count);
+}
+
+static inline void internal_rgb_raw32x2_12_sse2(uint32* dst32, const uint32* src32, const uint32* mask, unsigned count)
+{
+	internal_rgb_raw32_sse2(dst32, src32, 0, mask + 2, mask + 4, 2, count);
+}
+
+static inline void internal_rgb_raw32x2_1_sse2(uint32* dst32, const uint32* src32, const uint32* mask, unsigned count)
+{
+	internal_rgb_raw32_sse2(dst32, src32, 0, mask + 2, 0, 2, count);
+}
+
+static inline void internal_rgb_raw32x3_012_sse2(uint32* dst32, const uint32* src32, const uint32* mask, unsigned count)
+{
+	internal_rgb_raw32_sse2(dst32, src32, mask, mask + 6, mask + 12, 3, count);
+}
+
+/* Like the *_def versions, the carry isn't implemented */
+#define internal_rgb_raw32_012carry_sse2 internal_rgb_raw32_012_sse2
+#define internal_rgb_raw32_12carry_sse2 internal_rgb_raw32_12_sse2
+
+static inline ASM_TARGET_AVX2 void internal_rgb_raw32_012_avx2(uint32* dst32, const uint32* src32, const uint32* mask, unsigned count)
+{
+	internal_rgb_raw32_avx2(dst32, src32, mask, mask + 2, mask + 4, 1, count);
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_raw32_01_avx2(uint32* dst32, const uint32* src32, const uint32* mask, unsigned count)
+{
+	internal_rgb_raw32_avx2(dst32, src32, mask, mask + 2, 0, 1, count);
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_raw32_12_avx2(uint32* dst32, const uint32* src32, const uint32* mask, unsigned count)
+{
+	internal_rgb_raw32_avx2(dst32, src32, 0, mask + 2, mask + 4, 1, count);
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_raw32_1_avx2(uint32* dst32, const uint32* src32, const uint32* mask, unsigned count)
+{
+	internal_rgb_raw32_avx2(dst32, src32, 0, mask + 2, 0, 1, count);
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_raw32_2_avx2(uint32* dst32, const uint32* src32, const uint32* mask, unsigned count)
+{
+	internal_rgb_raw32_avx2(dst32, src32, 0, 0, mask + 4, 1, count);
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_raw32_02_avx2(uint32* dst32, const uint32* src32, const uint32* mask, unsigned count)
+{
+	internal_rgb_raw32_avx2(dst32, src32, mask, 0, mask + 4, 1, count);
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_raw32x2_012_avx2(uint32* dst32, const uint32* src32, const uint32* mask, unsigned count)
+{
+	internal_rgb_raw32_avx2(dst32, src32, mask, mask + 2, mask + 4, 2, count);
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_raw32x2_01_avx2(uint32* dst32, const uint32* src32, const uint32* mask, unsigned count)
+{
+	internal_rgb_raw32_avx2(dst32, src32, mask, mask + 2, 0, 2, count);
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_raw32x2_12_avx2(uint32* dst32, const uint32* src32, const uint32* mask, unsigned count)
+{
+	internal_rgb_raw32_avx2(dst32, src32, 0, mask + 2, mask + 4, 2, count);
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_raw32x2_1_avx2(uint32* dst32, const uint32* src32, const uint32* mask, unsigned count)
+{
+	internal_rgb_raw32_avx2(dst32, src32, 0, mask + 2, 0, 2, count);
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_raw32x3_012_avx2(uint32* dst32, const uint32* src32, const uint32* mask, unsigned count)
+{
+	internal_rgb_raw32_avx2(dst32, src32, mask, mask + 6, mask + 12, 3, count);
+}
+
+/* Like the *_def versions, the carry isn't implemented */
+#define internal_rgb_raw32_012carry_avx2 internal_rgb_raw32_012_avx2
+#define internal_rgb_raw32_12carry_avx2 internal_rgb_raw32_12_avx2
+#endif
+
 /***************************************************************************/
 /* rgb_compute */
 
@@ -1221,205 +1427,509 @@ static inline void internal_rgb_triadstrong16pix32_def(unsigned line, uint32* ds
 	}
 }
 
-/***************************************************************************/
-/* internal_rgb_triad6pix */
-
-/*
-   This mask is applyed at the image:
-
-   BR (type 0)
-   BG (type 1)
-   RG (type 2)
-   RB (type 3)
-   GB (type 4)
-   GR (type 5)
-
-   G = red:75%, green:100%, blue:75%
-   B = red:75%, green:75%, blue:100%
-   R = red:100%, green:75%, blue:75%
- */
-
-enum RGB_TRIAD6PIX_MASK {
-	RGB_TRIAD6PIX_MASK_0_0_0, /* type 0 shift 0 addr 0 */
-	RGB_TRIAD6PIX_MASK_0_0_1, /* type 0 shift 0 addr 1 */
-	RGB_TRIAD6PIX_MASK_0_1_0, /* type 0 shift 1 addr 0 */
-	RGB_TRIAD6PIX_MASK_0_1_1, /* type 0 shift 1 addr 1 */
-	RGB_TRIAD6PIX_MASK_0_2_0, /* ... */
-	RGB_TRIAD6PIX_MASK_0_2_1,
-	RGB_TRIAD6PIX_MASK_0_c_0,
-	RGB_TRIAD6PIX_MASK_0_c_1,
-	RGB_TRIAD6PIX_MASK_1_0_0,
-	RGB_TRIAD6PIX_MASK_1_0_1,
-	RGB_TRIAD6PIX_MASK_1_1_0,
-	RGB_TRIAD6PIX_MASK_1_1_1,
-	RGB_TRIAD6PIX_MASK_1_2_0,
-	RGB_TRIAD6PIX_MASK_1_2_1,
-	RGB_TRIAD6PIX_MASK_1_c_0,
-	RGB_TRIAD6PIX_MASK_1_c_1,
-	RGB_TRIAD6PIX_MASK_2_0_0,
-	RGB_TRIAD6PIX_MASK_2_0_1,
-	RGB_TRIAD6PIX_MASK_2_1_0,
-	RGB_TRIAD6PIX_MASK_2_1_1,
-	RGB_TRIAD6PIX_MASK_2_2_0,
-	RGB_TRIAD6PIX_MASK_2_2_1,
-	RGB_TRIAD6PIX_MASK_2_c_0,
-	RGB_TRIAD6PIX_MASK_2_c_1,
-	RGB_TRIAD6PIX_MASK_3_0_0,
-	RGB_TRIAD6PIX_MASK_3_0_1,
-	RGB_TRIAD6PIX_MASK_3_1_0,
-	RGB_TRIAD6PIX_MASK_3_1_1,
-	RGB_TRIAD6PIX_MASK_3_2_0,
-	RGB_TRIAD6PIX_MASK_3_2_1,
-	RGB_TRIAD6PIX_MASK_3_c_0,
-	RGB_TRIAD6PIX_MASK_3_c_1,
-	RGB_TRIAD6PIX_MASK_4_0_0,
-	RGB_TRIAD6PIX_MASK_4_0_1,
-	RGB_TRIAD6PIX_MASK_4_1_0,
-	RGB_TRIAD6PIX_MASK_4_1_1,
-	RGB_TRIAD6PIX_MASK_4_2_0,
-	RGB_TRIAD6PIX_MASK_4_2_1,
-	RGB_TRIAD6PIX_MASK_4_c_0,
-	RGB_TRIAD6PIX_MASK_4_c_1,
-	RGB_TRIAD6PIX_MASK_5_0_0,
-	RGB_TRIAD6PIX_MASK_5_0_1,
-	RGB_TRIAD6PIX_MASK_5_1_0,
-	RGB_TRIAD6PIX_MASK_5_1_1,
-	RGB_TRIAD6PIX_MASK_5_2_0,
-	RGB_TRIAD6PIX_MASK_5_2_1,
-	RGB_TRIAD6PIX_MASK_5_c_0,
-	RGB_TRIAD6PIX_MASK_5_c_1,
-	RGB_TRIAD6PIX_MASK_MAX
-};
-
-static void internal_rgb_triad6pix_set(const struct video_pipeline_target_struct* target, uint32* data)
-{
-	/* type 0 */
-	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_0_0_0, 0, 0x14); /* factor 2^0 = 100% */
-	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_0_1_0, 1, 0x63); /* factor 2^-1 = 50% */
-	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_0_2_0, 2, 0x63); /* factor 2^-2 = 25% */
-	rgb_raw_carry2_compute(target, data + RGB_TRIAD6PIX_MASK_0_c_0, 0x63); /* carry */
-
-	/* type 1 */
-	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_1_0_0, 0, 0x12); /* factor 2^0 = 100% */
-	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_1_1_0, 1, 0x65); /* factor 2^-1 = 50% */
-	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_1_2_0, 2, 0x65); /* factor 2^-2 = 25% */
-	rgb_raw_carry2_compute(target, data + RGB_TRIAD6PIX_MASK_1_c_0, 0x65); /* carry */
-
-	/* type 2 */
-	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_2_0_0, 0, 0x42); /* factor 2^0 = 100% */
-	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_2_1_0, 1, 0x35); /* factor 2^-1 = 50% */
-	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_2_2_0, 2, 0x35); /* factor 2^-2 = 25% */
-	rgb_raw_carry2_compute(target, data + RGB_TRIAD6PIX_MASK_2_c_0, 0x35); /* carry */
-
-	/* type 3 */
-	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_3_0_0, 0, 0x41); /* factor 2^0 = 100% */
-	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_3_1_0, 1, 0x36); /* factor 2^-1 = 50% */
-	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_3_2_0, 2, 0x36); /* factor 2^-2 = 25% */
-	rgb_raw_carry2_compute(target, data + RGB_TRIAD6PIX_MASK_3_c_0, 0x36); /* carry */
-
-	/* type 4 */
-	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_4_0_0, 0, 0x21); /* factor 2^0 = 100% */
-	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_4_1_0, 1, 0x56); /* factor 2^-1 = 50% */
-	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_4_2_0, 2, 0x56); /* factor 2^-2 = 25% */
-	rgb_raw_carry2_compute(target, data + RGB_TRIAD6PIX_MASK_4_c_0, 0x56); /* carry */
-
-	/* type 5 */
-	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_5_0_0, 0, 0x24); /* factor 2^0 = 100% */
-	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_5_1_0, 1, 0x53); /* factor 2^-1 = 50% */
-	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_5_2_0, 2, 0x53); /* factor 2^-2 = 25% */
-	rgb_raw_carry2_compute(target, data + RGB_TRIAD6PIX_MASK_5_c_0, 0x53); /* carry */
-}
-
-#if defined(USE_ASM_INLINE)
-
-static inline void internal_rgb_triad6pix8_asm(unsigned line, uint8* dst, const uint8* src, const uint32* data, unsigned count)
+#if defined(USE_ASM_INTRINSIC)
+static inline void internal_rgb_triad16pix8_sse2(unsigned line, uint8* dst, const uint8* src, const uint32* data, unsigned count)
 {
-	const uint32* mask = data + (RGB_TRIAD6PIX_MASK_1_0_0 - RGB_TRIAD6PIX_MASK_0_0_0) * (line % 6);
-	const uint32* carry = mask + (RGB_TRIAD6PIX_MASK_0_c_0 - RGB_TRIAD6PIX_MASK_0_0_0);
-
-	internal_rgb_raw64_012carry_asm(dst, src, mask, carry, count / 8);
+	switch (line % 8) {
+	case 0:
+	case 4:
+		internal_rgb_raw32_12carry_sse2((uint32*)dst, (uint32*)src, data + RGB_TRIAD16PIX_MASK_0_0_0, count / 4);
+		break;
+	case 1:
+	case 2:
+	case 3:
+		internal_rgb_raw32_012carry_sse2((uint32*)dst, (uint32*)src, data + RGB_TRIAD16PIX_MASK_1_0_0, count / 4);
+		break;
+	default:
+		internal_rgb_raw32_012carry_sse2((uint32*)dst, (uint32*)src, data + RGB_TRIAD16PIX_MASK_2_0_0, count / 4);
+		break;
+	}
 }
 
-static inline void internal_rgb_triadstrong6pix8_asm(unsigned line, uint8* dst, const uint8* src, const uint32* data, unsigned count)
+static inline void internal_rgb_triadstrong16pix8_sse2(unsigned line, uint8* dst, const uint8* src, const uint32* data, unsigned count)
 {
-	const uint32* mask = data + (RGB_TRIAD6PIX_MASK_1_0_0 - RGB_TRIAD6PIX_MASK_0_0_0) * (line % 6);
-
-	internal_rgb_raw64_01_asm(dst, src, mask, count / 8);
+	switch (line % 8) {
+	case 0:
+	case 4:
+		internal_rgb_raw32_1_sse2((uint32*)dst, (uint32*)src, data + RGB_TRIAD16PIX_MASK_0_0_0, count / 4);
+		break;
+	case 1:
+	case 2:
+	case 3:
+		internal_rgb_raw32_01_sse2((uint32*)dst, (uint32*)src, data + RGB_TRIAD16PIX_MASK_1_0_0, count / 4);
+		break;
+	default:
+		internal_rgb_raw32_01_sse2((uint32*)dst, (uint32*)src, data + RGB_TRIAD16PIX_MASK_2_0_0, count / 4);
+		break;
+	}
 }
 
-static inline void internal_rgb_triad6pix16_asm(unsigned line, uint16* dst, const uint16* src, const uint32* data, unsigned count)
+static inline void internal_rgb_triad16pix16_sse2(unsigned line, uint16* dst, const uint16* src, const uint32* data, unsigned count)
 {
-	const uint32* mask = data + (RGB_TRIAD6PIX_MASK_1_0_0 - RGB_TRIAD6PIX_MASK_0_0_0) * (line % 6);
-	const uint32* carry = mask + (RGB_TRIAD6PIX_MASK_0_c_0 - RGB_TRIAD6PIX_MASK_0_0_0);
-
-	internal_rgb_raw64_012carry_asm(dst, src, mask, carry, count / 4);
+	switch (line % 8) {
+	case 0:
+	case 4:
+		internal_rgb_raw32x2_12_sse2((uint32*)dst, (uint32*)src, data + RGB_TRIAD16PIX_MASK_0_0_0, count / 2);
+		break;
+	case 1:
+	case 2:
+	case 3:
+		internal_rgb_raw32x2_012_sse2((uint32*)dst, (uint32*)src, data + RGB_TRIAD16PIX_MASK_1_0_0, count / 2);
+		break;
+	default:
+		internal_rgb_raw32x2_012_sse2((uint32*)dst, (uint32*)src, data + RGB_TRIAD16PIX_MASK_2_0_0, count / 2);
+		break;
+	}
 }
 
-static inline void internal_rgb_triadstrong6pix16_asm(unsigned line, uint16* dst, const uint16* src, const uint32* data, unsigned count)
+static inline void internal_rgb_triadstrong16pix16_sse2(unsigned line, uint16* dst, const uint16* src, const uint32* data, unsigned count)
 {
-	const uint32* mask = data + (RGB_TRIAD6PIX_MASK_1_0_0 - RGB_TRIAD6PIX_MASK_0_0_0) * (line % 6);
-
-	internal_rgb_raw64_01_asm(dst, src, mask, count / 4);
+	switch (line % 8) {
+	case 0:
+	case 4:
+		internal_rgb_raw32x2_1_sse2((uint32*)dst, (uint32*)src, data + RGB_TRIAD16PIX_MASK_0_0_0, count / 2);
+		break;
+	case 1:
+	case 2:
+	case 3:
+		internal_rgb_raw32x2_01_sse2((uint32*)dst, (uint32*)src, data + RGB_TRIAD16PIX_MASK_1_0_0, count / 2);
+		break;
+	default:
+		internal_rgb_raw32x2_01_sse2((uint32*)dst, (uint32*)src, data + RGB_TRIAD16PIX_MASK_2_0_0, count / 2);
+		break;
+	}
+}
+
+static inline void internal_rgb_triad16pix32_sse2(unsigned line, uint32* dst, const uint32* src, const uint32* data, unsigned count)
+{
+	switch (line % 8) {
+	case 0:
+	case 4:
+		internal_rgb_raw32x2_12_sse2(dst, src, data + RGB_TRIAD16PIX_MASK_0_0_0, count);
+		break;
+	case 1:
+	case 2:
+	case 3:
+		internal_rgb_raw32x2_012_sse2(dst, src, data + RGB_TRIAD16PIX_MASK_1_0_0, count);
+		break;
+	default:
+		internal_rgb_raw32x2_012_sse2(dst, src, data + RGB_TRIAD16PIX_MASK_2_0_0, count);
+		break;
+	}
+}
+
+static inline void internal_rgb_triadstrong16pix32_sse2(unsigned line, uint32* dst, const uint32* src, const uint32* data, unsigned count)
+{
+	switch (line % 8) {
+	case 0:
+	case 4:
+		internal_rgb_raw32x2_1_sse2(dst, src, data + RGB_TRIAD16PIX_MASK_0_0_0, count);
+		break;
+	case 1:
+	case 2:
+	case 3:
+		internal_rgb_raw32x2_01_sse2(dst, src, data + RGB_TRIAD16PIX_MASK_1_0_0, count);
+		break;
+	default:
+		internal_rgb_raw32x2_01_sse2(dst, src, data + RGB_TRIAD16PIX_MASK_2_0_0, count);
+		break;
+	}
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_triad16pix8_avx2(unsigned line, uint8* dst, const uint8* src, const uint32* data, unsigned count)
+{
+	switch (line % 8) {
+	case 0:
+	case 4:
+		internal_rgb_raw32_12carry_avx2((uint32*)dst, (uint32*)src, data + RGB_TRIAD16PIX_MASK_0_0_0, count / 4);
+		break;
+	case 1:
+	case 2:
+	case 3:
+		internal_rgb_raw32_012carry_avx2((uint32*)dst, (uint32*)src, data + RGB_TRIAD16PIX_MASK_1_0_0, count / 4);
+		break;
+	default:
+		internal_rgb_raw32_012carry_avx2((uint32*)dst, (uint32*)src, data + RGB_TRIAD16PIX_MASK_2_0_0, count / 4);
+		break;
+	}
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_triadstrong16pix8_avx2(unsigned line, uint8* dst, const uint8* src, const uint32* data, unsigned count)
+{
+	switch (line % 8) {
+	case 0:
+	case 4:
+		internal_rgb_raw32_1_avx2((uint32*)dst, (uint32*)src, data + RGB_TRIAD16PIX_MASK_0_0_0, count / 4);
+		break;
+	case 1:
+	case 2:
+	case 3:
+		internal_rgb_raw32_01_avx2((uint32*)dst, (uint32*)src, data + RGB_TRIAD16PIX_MASK_1_0_0, count / 4);
+		break;
+	default:
+		internal_rgb_raw32_01_avx2((uint32*)dst, (uint32*)src, data + RGB_TRIAD16PIX_MASK_2_0_0, count / 4);
+		break;
+	}
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_triad16pix16_avx2(unsigned line, uint16* dst, const uint16* src, const uint32* data, unsigned count)
+{
+	switch (line % 8) {
+	case 0:
+	case 4:
+		internal_rgb_raw32x2_12_avx2((uint32*)dst, (uint32*)src, data + RGB_TRIAD16PIX_MASK_0_0_0, count / 2);
+		break;
+	case 1:
+	case 2:
+	case 3:
+		internal_rgb_raw32x2_012_avx2((uint32*)dst, (uint32*)src, data + RGB_TRIAD16PIX_MASK_1_0_0, count / 2);
+		break;
+	default:
+		internal_rgb_raw32x2_012_avx2((uint32*)dst, (uint32*)src, data + RGB_TRIAD16PIX_MASK_2_0_0, count / 2);
+		break;
+	}
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_triadstrong16pix16_avx2(unsigned line, uint16* dst, const uint16* src, const uint32* data, unsigned count)
+{
+	switch (line % 8) {
+	case 0:
+	case 4:
+		internal_rgb_raw32x2_1_avx2((uint32*)dst, (uint32*)src, data + RGB_TRIAD16PIX_MASK_0_0_0, count / 2);
+		break;
+	case 1:
+	case 2:
+	case 3:
+		internal_rgb_raw32x2_01_avx2((uint32*)dst, (uint32*)src, data + RGB_TRIAD16PIX_MASK_1_0_0, count / 2);
+		break;
+	default:
+		internal_rgb_raw32x2_01_avx2((uint32*)dst, (uint32*)src, data + RGB_TRIAD16PIX_MASK_2_0_0, count / 2);
+		break;
+	}
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_triad16pix32_avx2(unsigned line, uint32* dst, const uint32* src, const uint32* data, unsigned count)
+{
+	switch (line % 8) {
+	case 0:
+	case 4:
+		internal_rgb_raw32x2_12_avx2(dst, src, data + RGB_TRIAD16PIX_MASK_0_0_0, count);
+		break;
+	case 1:
+	case 2:
+	case 3:
+		internal_rgb_raw32x2_012_avx2(dst, src, data + RGB_TRIAD16PIX_MASK_1_0_0, count);
+		break;
+	default:
+		internal_rgb_raw32x2_012_avx2(dst, src, data + RGB_TRIAD16PIX_MASK_2_0_0, count);
+		break;
+	}
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_triadstrong16pix32_avx2(unsigned line, uint32* dst, const uint32* src, const uint32* data, unsigned count)
+{
+	switch (line % 8) {
+	case 0:
+	case 4:
+		internal_rgb_raw32x2_1_avx2(dst, src, data + RGB_TRIAD16PIX_MASK_0_0_0, count);
+		break;
+	case 1:
+	case 2:
+	case 3:
+		internal_rgb_raw32x2_01_avx2(dst, src, data + RGB_TRIAD16PIX_MASK_1_0_0, count);
+		break;
+	default:
+		internal_rgb_raw32x2_01_avx2(dst, src, data + RGB_TRIAD16PIX_MASK_2_0_0, count);
+		break;
+	}
+}
+#endif
+
+/***************************************************************************/
+/* internal_rgb_triad6pix */
+
+/*
+   This mask is applyed at the image:
+
+   BR (type 0)
+   BG (type 1)
+   RG (type 2)
+   RB (type 3)
+   GB (type 4)
+   GR (type 5)
+
+   G = red:75%, green:100%, blue:75%
+   B = red:75%, green:75%, blue:100%
+   R = red:100%, green:75%, blue:75%
+ */
+
+enum RGB_TRIAD6PIX_MASK {
+	RGB_TRIAD6PIX_MASK_0_0_0, /* type 0 shift 0 addr 0 */
+	RGB_TRIAD6PIX_MASK_0_0_1, /* type 0 shift 0 addr 1 */
+	RGB_TRIAD6PIX_MASK_0_1_0, /* type 0 shift 1 addr 0 */
+	RGB_TRIAD6PIX_MASK_0_1_1, /* type 0 shift 1 addr 1 */
+	RGB_TRIAD6PIX_MASK_0_2_0, /* ... */
+	RGB_TRIAD6PIX_MASK_0_2_1,
+	RGB_TRIAD6PIX_MASK_0_c_0,
+	RGB_TRIAD6PIX_MASK_0_c_1,
+	RGB_TRIAD6PIX_MASK_1_0_0,
+	RGB_TRIAD6PIX_MASK_1_0_1,
+	RGB_TRIAD6PIX_MASK_1_1_0,
+	RGB_TRIAD6PIX_MASK_1_1_1,
+	RGB_TRIAD6PIX_MASK_1_2_0,
+	RGB_TRIAD6PIX_MASK_1_2_1,
+	RGB_TRIAD6PIX_MASK_1_c_0,
+	RGB_TRIAD6PIX_MASK_1_c_1,
+	RGB_TRIAD6PIX_MASK_2_0_0,
+	RGB_TRIAD6PIX_MASK_2_0_1,
+	RGB_TRIAD6PIX_MASK_2_1_0,
+	RGB_TRIAD6PIX_MASK_2_1_1,
+	RGB_TRIAD6PIX_MASK_2_2_0,
+	RGB_TRIAD6PIX_MASK_2_2_1,
+	RGB_TRIAD6PIX_MASK_2_c_0,
+	RGB_TRIAD6PIX_MASK_2_c_1,
+	RGB_TRIAD6PIX_MASK_3_0_0,
+	RGB_TRIAD6PIX_MASK_3_0_1,
+	RGB_TRIAD6PIX_MASK_3_1_0,
+	RGB_TRIAD6PIX_MASK_3_1_1,
+	RGB_TRIAD6PIX_MASK_3_2_0,
+	RGB_TRIAD6PIX_MASK_3_2_1,
+	RGB_TRIAD6PIX_MASK_3_c_0,
+	RGB_TRIAD6PIX_MASK_3_c_1,
+	RGB_TRIAD6PIX_MASK_4_0_0,
+	RGB_TRIAD6PIX_MASK_4_0_1,
+	RGB_TRIAD6PIX_MASK_4_1_0,
+	RGB_TRIAD6PIX_MASK_4_1_1,
+	RGB_TRIAD6PIX_MASK_4_2_0,
+	RGB_TRIAD6PIX_MASK_4_2_1,
+	RGB_TRIAD6PIX_MASK_4_c_0,
+	RGB_TRIAD6PIX_MASK_4_c_1,
+	RGB_TRIAD6PIX_MASK_5_0_0,
+	RGB_TRIAD6PIX_MASK_5_0_1,
+	RGB_TRIAD6PIX_MASK_5_1_0,
+	RGB_TRIAD6PIX_MASK_5_1_1,
+	RGB_TRIAD6PIX_MASK_5_2_0,
+	RGB_TRIAD6PIX_MASK_5_2_1,
+	RGB_TRIAD6PIX_MASK_5_c_0,
+	RGB_TRIAD6PIX_MASK_5_c_1,
+	RGB_TRIAD6PIX_MASK_MAX
+};
+
+static void internal_rgb_triad6pix_set(const struct video_pipeline_target_struct* target, uint32* data)
+{
+	/* type 0 */
+	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_0_0_0, 0, 0x14); /* factor 2^0 = 100% */
+	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_0_1_0, 1, 0x63); /* factor 2^-1 = 50% */
+	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_0_2_0, 2, 0x63); /* factor 2^-2 = 25% */
+	rgb_raw_carry2_compute(target, data + RGB_TRIAD6PIX_MASK_0_c_0, 0x63); /* carry */
+
+	/* type 1 */
+	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_1_0_0, 0, 0x12); /* factor 2^0 = 100% */
+	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_1_1_0, 1, 0x65); /* factor 2^-1 = 50% */
+	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_1_2_0, 2, 0x65); /* factor 2^-2 = 25% */
+	rgb_raw_carry2_compute(target, data + RGB_TRIAD6PIX_MASK_1_c_0, 0x65); /* carry */
+
+	/* type 2 */
+	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_2_0_0, 0, 0x42); /* factor 2^0 = 100% */
+	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_2_1_0, 1, 0x35); /* factor 2^-1 = 50% */
+	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_2_2_0, 2, 0x35); /* factor 2^-2 = 25% */
+	rgb_raw_carry2_compute(target, data + RGB_TRIAD6PIX_MASK_2_c_0, 0x35); /* carry */
+
+	/* type 3 */
+	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_3_0_0, 0, 0x41); /* factor 2^0 = 100% */
+	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_3_1_0, 1, 0x36); /* factor 2^-1 = 50% */
+	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_3_2_0, 2, 0x36); /* factor 2^-2 = 25% */
+	rgb_raw_carry2_compute(target, data + RGB_TRIAD6PIX_MASK_3_c_0, 0x36); /* carry */
+
+	/* type 4 */
+	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_4_0_0, 0, 0x21); /* factor 2^0 = 100% */
+	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_4_1_0, 1, 0x56); /* factor 2^-1 = 50% */
+	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_4_2_0, 2, 0x56); /* factor 2^-2 = 25% */
+	rgb_raw_carry2_compute(target, data + RGB_TRIAD6PIX_MASK_4_c_0, 0x56); /* carry */
+
+	/* type 5 */
+	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_5_0_0, 0, 0x24); /* factor 2^0 = 100% */
+	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_5_1_0, 1, 0x53); /* factor 2^-1 = 50% */
+	rgb_raw_mask2_compute(target, data + RGB_TRIAD6PIX_MASK_5_2_0, 2, 0x53); /* factor 2^-2 = 25% */
+	rgb_raw_carry2_compute(target, data + RGB_TRIAD6PIX_MASK_5_c_0, 0x53); /* carry */
+}
+
+#if defined(USE_ASM_INLINE)
+
+static inline void internal_rgb_triad6pix8_asm(unsigned line, uint8* dst, const uint8* src, const uint32* data, unsigned count)
+{
+	const uint32* mask = data + (RGB_TRIAD6PIX_MASK_1_0_0 - RGB_TRIAD6PIX_MASK_0_0_0) * (line % 6);
+	const uint32* carry = mask + (RGB_TRIAD6PIX_MASK_0_c_0 - RGB_TRIAD6PIX_MASK_0_0_0);
+
+	internal_rgb_raw64_012carry_asm(dst, src, mask, carry, count / 8);
+}
+
+static inline void internal_rgb_triadstrong6pix8_asm(unsigned line, uint8* dst, const uint8* src, const uint32* data, unsigned count)
+{
+	const uint32* mask = data + (RGB_TRIAD6PIX_MASK_1_0_0 - RGB_TRIAD6PIX_MASK_0_0_0) * (line % 6);
+
+	internal_rgb_raw64_01_asm(dst, src, mask, count / 8);
+}
+
+static inline void internal_rgb_triad6pix16_asm(unsigned line, uint16* dst, const uint16* src, const uint32* data, unsigned count)
+{
+	const uint32* mask = data + (RGB_TRIAD6PIX_MASK_1_0_0 - RGB_TRIAD6PIX_MASK_0_0_0) * (line % 6);
+	const uint32* carry = mask + (RGB_TRIAD6PIX_MASK_0_c_0 - RGB_TRIAD6PIX_MASK_0_0_0);
+
+	internal_rgb_raw64_012carry_asm(dst, src, mask, carry, count / 4);
+}
+
+static inline void internal_rgb_triadstrong6pix16_asm(unsigned line, uint16* dst, const uint16* src, const uint32* data, unsigned count)
+{
+	const uint32* mask = data + (RGB_TRIAD6PIX_MASK_1_0_0 - RGB_TRIAD6PIX_MASK_0_0_0) * (line % 6);
+
+	internal_rgb_raw64_01_asm(dst, src, mask, count / 4);
+}
+
+static inline void internal_rgb_triad6pix32_asm(unsigned line, uint32* dst, const uint32* src, const uint32* data, unsigned count)
+{
+	const uint32* mask = data + (RGB_TRIAD6PIX_MASK_1_0_0 - RGB_TRIAD6PIX_MASK_0_0_0) * (line % 6);
+	const uint32* carry = mask + (RGB_TRIAD6PIX_MASK_0_c_0 - RGB_TRIAD6PIX_MASK_0_0_0);
+
+	internal_rgb_raw64_012carry_asm(dst, src, mask, carry, count / 2);
+}
+
+static inline void internal_rgb_triadstrong6pix32_asm(unsigned line, uint32* dst, const uint32* src, const uint32* data, unsigned count)
+{
+	const uint32* mask = data + (RGB_TRIAD6PIX_MASK_1_0_0 - RGB_TRIAD6PIX_MASK_0_0_0) * (line % 6);
+
+	internal_rgb_raw64_01_asm(dst, src, mask, count / 2);
+}
+
+#endif
+
+static inline void internal_rgb_triad6pix8_def(unsigned line, uint8* dst, const uint8* src, const uint32* data, unsigned count)
+{
+	const uint32* mask = data + (RGB_TRIAD6PIX_MASK_1_0_0 - RGB_TRIAD6PIX_MASK_0_0_0) * (line % 6);
+
+	internal_rgb_raw32_012carry_def((uint32*)dst, (uint32*)src, mask, count / 4);
+}
+
+static inline void internal_rgb_triadstrong6pix8_def(unsigned line, uint8* dst, const uint8* src, const uint32* data, unsigned count)
+{
+	const uint32* mask = data + (RGB_TRIAD6PIX_MASK_1_0_0 - RGB_TRIAD6PIX_MASK_0_0_0) * (line % 6);
+
+	internal_rgb_raw32_01_def((uint32*)dst, (uint32*)src, mask, count / 4);
+}
+
+static inline void internal_rgb_triad6pix16_def(unsigned line, uint16* dst, const uint16* src, const uint32* data, unsigned count)
+{
+	const uint32* mask = data + (RGB_TRIAD6PIX_MASK_1_0_0 - RGB_TRIAD6PIX_MASK_0_0_0) * (line % 6);
+
+	internal_rgb_raw32_012carry_def((uint32*)dst, (uint32*)src, mask, count / 2);
+}
+
+static inline void internal_rgb_triadstrong6pix16_def(unsigned line, uint16* dst, const uint16* src, const uint32* data, unsigned count)
+{
+	const uint32* mask = data + (RGB_TRIAD6PIX_MASK_1_0_0 - RGB_TRIAD6PIX_MASK_0_0_0) * (line % 6);
+
+	internal_rgb_raw32_01_def((uint32*)dst, (uint32*)src, mask, count / 2);
+}
+
+static inline void internal_rgb_triad6pix32_def(unsigned line, uint32* dst, const uint32* src, const uint32* data, unsigned count)
+{
+	const uint32* mask = data + (RGB_TRIAD6PIX_MASK_1_0_0 - RGB_TRIAD6PIX_MASK_0_0_0) * (line % 6);
+
+	internal_rgb_raw32_012carry_def(dst, src, mask, count);
+}
+
+static inline void internal_rgb_triadstrong6pix32_def(unsigned line, uint32* dst, const uint32* src, const uint32* data, unsigned count)
+{
+	const uint32* mask = data + (RGB_TRIAD6PIX_MASK_1_0_0 - RGB_TRIAD6PIX_MASK_0_0_0) * (line % 6);
+
+	internal_rgb_raw32_01_def(dst, src, mask, count);
 }
 
-static inline void internal_rgb_triad6pix32_asm(unsigned line, uint32* dst, const uint32* src, const uint32* data, unsigned count)
+#if defined(USE_ASM_INTRINSIC)
+static inline void internal_rgb_triad6pix8_sse2(unsigned line, uint8* dst, const uint8* src, const uint32* data, unsigned count)
 {
 	const uint32* mask = data + (RGB_TRIAD6PIX_MASK_1_0_0 - RGB_TRIAD6PIX_MASK_0_0_0) * (line % 6);
-	const uint32* carry = mask + (RGB_TRIAD6PIX_MASK_0_c_0 - RGB_TRIAD6PIX_MASK_0_0_0);
 
-	internal_rgb_raw64_012carry_asm(dst, src, mask, carry, count / 2);
+	internal_rgb_raw32_012carry_sse2((uint32*)dst, (uint32*)src, mask, count / 4);
 }
 
-static inline void internal_rgb_triadstrong6pix32_asm(unsigned line, uint32* dst, const uint32* src, const uint32* data, unsigned count)
+static inline void internal_rgb_triadstrong6pix8_sse2(unsigned line, uint8* dst, const uint8* src, const uint32* data, unsigned count)
 {
 	const uint32* mask = data + (RGB_TRIAD6PIX_MASK_1_0_0 - RGB_TRIAD6PIX_MASK_0_0_0) * (line % 6);
 
-	internal_rgb_raw64_01_asm(dst, src, mask, count / 2);
+	internal_rgb_raw32_01_sse2((uint32*)dst, (uint32*)src, mask, count / 4);
 }
 
-#endif
+static inline void internal_rgb_triad6pix16_sse2(unsigned line, uint16* dst, const uint16* src, const uint32* data, unsigned count)
+{
+	const uint32* mask = data + (RGB_TRIAD6PIX_MASK_1_0_0 - RGB_TRIAD6PIX_MASK_0_0_0) * (line % 6);
 
-static inline void internal_rgb_triad6pix8_def(unsigned line, uint8* dst, const uint8* src, const uint32* data, unsigned count)
+	internal_rgb_raw32_012carry_sse2((uint32*)dst, (uint32*)src, mask, count / 2);
+}
+
+static inline void internal_rgb_triadstrong6pix16_sse2(unsigned line, uint16* dst, const uint16* src, const uint32* data, unsigned count)
 {
 	const uint32* mask = data + (RGB_TRIAD6PIX_MASK_1_0_0 - RGB_TRIAD6PIX_MASK_0_0_0) * (line % 6);
 
-	internal_rgb_raw32_012carry_def((uint32*)dst, (uint32*)src, mask, count / 4);
+	internal_rgb_raw32_01_sse2((uint32*)dst, (uint32*)src, mask, count / 2);
 }
 
-static inline void internal_rgb_triadstrong6pix8_def(unsigned line, uint8* dst, const uint8* src, const uint32* data, unsigned count)
+static inline void internal_rgb_triad6pix32_sse2(unsigned line, uint32* dst, const uint32* src, const uint32* data, unsigned count)
 {
 	const uint32* mask = data + (RGB_TRIAD6PIX_MASK_1_0_0 - RGB_TRIAD6PIX_MASK_0_0_0) * (line % 6);
 
-	internal_rgb_raw32_01_def((uint32*)dst, (uint32*)src, mask, count / 4);
+	internal_rgb_raw32_012carry_sse2(dst, src, mask, count);
 }
 
-static inline void internal_rgb_triad6pix16_def(unsigned line, uint16* dst, const uint16* src, const uint32* data, unsigned count)
+static inline void internal_rgb_triadstrong6pix32_sse2(unsigned line, uint32* dst, const uint32* src, const uint32* data, unsigned count)
 {
 	const uint32* mask = data + (RGB_TRIAD6PIX_MASK_1_0_0 - RGB_TRIAD6PIX_MASK_0_0_0) * (line % 6);
 
-	internal_rgb_raw32_012carry_def((uint32*)dst, (uint32*)src, mask, count / 2);
+	internal_rgb_raw32_01_sse2(dst, src, mask, count);
 }
 
-static inline void internal_rgb_triadstrong6pix16_def(unsigned line, uint16* dst, const uint16* src, const uint32* data, unsigned count)
+static inline ASM_TARGET_AVX2 void internal_rgb_triad6pix8_avx2(unsigned line, uint8* dst, const uint8* src, const uint32* data, unsigned count)
 {
 	const uint32* mask = data + (RGB_TRIAD6PIX_MASK_1_0_0 - RGB_TRIAD6PIX_MASK_0_0_0) * (line % 6);
 
-	internal_rgb_raw32_01_def((uint32*)dst, (uint32*)src, mask, count / 2);
+	internal_rgb_raw32_012carry_avx2((uint32*)dst, (uint32*)src, mask, count / 4);
 }
 
-static inline void internal_rgb_triad6pix32_def(unsigned line, uint32* dst, const uint32* src, const uint32* data, unsigned count)
+static inline ASM_TARGET_AVX2 void internal_rgb_triadstrong6pix8_avx2(unsigned line, uint8* dst, const uint8* src, const uint32* data, unsigned count)
 {
 	const uint32* mask = data + (RGB_TRIAD6PIX_MASK_1_0_0 - RGB_TRIAD6PIX_MASK_0_0_0) * (line % 6);
 
-	internal_rgb_raw32_012carry_def(dst, src, mask, count);
+	internal_rgb_raw32_01_avx2((uint32*)dst, (uint32*)src, mask, count / 4);
 }
 
-static inline void internal_rgb_triadstrong6pix32_def(unsigned line, uint32* dst, const uint32* src, const uint32* data, unsigned count)
+static inline ASM_TARGET_AVX2 void internal_rgb_triad6pix16_avx2(unsigned line, uint16* dst, const uint16* src, const uint32* data, unsigned count)
 {
 	const uint32* mask = data + (RGB_TRIAD6PIX_MASK_1_0_0 - RGB_TRIAD6PIX_MASK_0_0_0) * (line % 6);
 
-	internal_rgb_raw32_01_def(dst, src, mask, count);
+	internal_rgb_raw32_012carry_avx2((uint32*)dst, (uint32*)src, mask, count / 2);
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_triadstrong6pix16_avx2(unsigned line, uint16* dst, const uint16* src, const uint32* data, unsigned count)
+{
+	const uint32* mask = data + (RGB_TRIAD6PIX_MASK_1_0_0 - RGB_TRIAD6PIX_MASK_0_0_0) * (line % 6);
+
+	internal_rgb_raw32_01_avx2((uint32*)dst, (uint32*)src, mask, count / 2);
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_triad6pix32_avx2(unsigned line, uint32* dst, const uint32* src, const uint32* data, unsigned count)
+{
+	const uint32* mask = data + (RGB_TRIAD6PIX_MASK_1_0_0 - RGB_TRIAD6PIX_MASK_0_0_0) * (line % 6);
+
+	internal_rgb_raw32_012carry_avx2(dst, src, mask, count);
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_triadstrong6pix32_avx2(unsigned line, uint32* dst, const uint32* src, const uint32* data, unsigned count)
+{
+	const uint32* mask = data + (RGB_TRIAD6PIX_MASK_1_0_0 - RGB_TRIAD6PIX_MASK_0_0_0) * (line % 6);
+
+	internal_rgb_raw32_01_avx2(dst, src, mask, count);
 }
+#endif
 
 /***************************************************************************/
 /* internal_rgb_triad3pix */
@@ -1576,6 +2086,92 @@ static inline void internal_rgb_triadstrong3pix32_def(unsigned line, uint32* dst
 	internal_rgb_raw32_01_def(dst, src, mask, count);
 }
 
+#if defined(USE_ASM_INTRINSIC)
+static inline void internal_rgb_triad3pix8_sse2(unsigned line, uint8* dst, const uint8* src, const uint32* data, unsigned count)
+{
+	const uint32* mask = data + (RGB_TRIAD3PIX_MASK_1_0_0 - RGB_TRIAD3PIX_MASK_0_0_0) * (line % 3);
+
+	internal_rgb_raw32_012carry_sse2((uint32*)dst, (uint32*)src, mask, count / 4);
+}
+
+static inline void internal_rgb_triadstrong3pix8_sse2(unsigned line, uint8* dst, const uint8* src, const uint32* data, unsigned count)
+{
+	const uint32* mask = data + (RGB_TRIAD3PIX_MASK_1_0_0 - RGB_TRIAD3PIX_MASK_0_0_0) * (line % 3);
+
+	internal_rgb_raw32_01_sse2((uint32*)dst, (uint32*)src, mask, count / 4);
+}
+
+static inline void internal_rgb_triad3pix16_sse2(unsigned line, uint8* dst, const uint16* src, const uint32* data, unsigned count)
+{
+	const uint32* mask = data + (RGB_TRIAD3PIX_MASK_1_1_0 - RGB_TRIAD3PIX_MASK_0_1_0) * (line % 3);
+
+	internal_rgb_raw32_012carry_sse2((uint32*)dst, (uint32*)src, mask, count / 2);
+}
+
+static inline void internal_rgb_triadstrong3pix16_sse2(unsigned line, uint8* dst, const uint8* src, const uint32* data, unsigned count)
+{
+	const uint32* mask = data + (RGB_TRIAD3PIX_MASK_1_1_0 - RGB_TRIAD3PIX_MASK_0_1_0) * (line % 3);
+
+	internal_rgb_raw32_01_sse2((uint32*)dst, (uint32*)src, mask, count / 2);
+}
+
+static inline void internal_rgb_triad3pix32_sse2(unsigned line, uint32* dst, const uint32* src, const uint32* data, unsigned count)
+{
+	const uint32* mask = data + (RGB_TRIAD3PIX_MASK_1_1_0 - RGB_TRIAD3PIX_MASK_0_1_0) * (line % 3);
+
+	internal_rgb_raw32_012carry_sse2(dst, src, mask, count);
+}
+
+static inline void internal_rgb_triadstrong3pix32_sse2(unsigned line, uint32* dst, const uint32* src, const uint32* data, unsigned count)
+{
+	const uint32* mask = data + (RGB_TRIAD3PIX_MASK_1_1_0 - RGB_TRIAD3PIX_MASK_0_1_0) * (line % 3);
+
+	internal_rgb_raw32_01_sse2(dst, src, mask, count);
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_triad3pix8_avx2(unsigned line, uint8* dst, const uint8* src, const uint32* data, unsigned count)
+{
+	const uint32* mask = data + (RGB_TRIAD3PIX_MASK_1_0_0 - RGB_TRIAD3PIX_MASK_0_0_0) * (line % 3);
+
+	internal_rgb_raw32_012carry_avx2((uint32*)dst, (uint32*)src, mask, count / 4);
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_triadstrong3pix8_avx2(unsigned line, uint8* dst, const uint8* src, const uint32* data, unsigned count)
+{
+	const uint32* mask = data + (RGB_TRIAD3PIX_MASK_1_0_0 - RGB_TRIAD3PIX_MASK_0_0_0) * (line % 3);
+
+	internal_rgb_raw32_01_avx2((uint32*)dst, (uint32*)src, mask, count / 4);
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_triad3pix16_avx2(unsigned line, uint8* dst, const uint16* src, const uint32* data, unsigned count)
+{
+	const uint32* mask = data + (RGB_TRIAD3PIX_MASK_1_1_0 - RGB_TRIAD3PIX_MASK_0_1_0) * (line % 3);
+
+	internal_rgb_raw32_012carry_avx2((uint32*)dst, (uint32*)src, mask, count / 2);
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_triadstrong3pix16_avx2(unsigned line, uint8* dst, const uint8* src, const uint32* data, unsigned count)
+{
+	const uint32* mask = data + (RGB_TRIAD3PIX_MASK_1_1_0 - RGB_TRIAD3PIX_MASK_0_1_0) * (line % 3);
+
+	internal_rgb_raw32_01_avx2((uint32*)dst, (uint32*)src, mask, count / 2);
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_triad3pix32_avx2(unsigned line, uint32* dst, const uint32* src, const uint32* data, unsigned count)
+{
+	const uint32* mask = data + (RGB_TRIAD3PIX_MASK_1_1_0 - RGB_TRIAD3PIX_MASK_0_1_0) * (line % 3);
+
+	internal_rgb_raw32_012carry_avx2(dst, src, mask, count);
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_triadstrong3pix32_avx2(unsigned line, uint32* dst, const uint32* src, const uint32* data, unsigned count)
+{
+	const uint32* mask = data + (RGB_TRIAD3PIX_MASK_1_1_0 - RGB_TRIAD3PIX_MASK_0_1_0) * (line % 3);
+
+	internal_rgb_raw32_01_avx2(dst, src, mask, count);
+}
+#endif
+
 /***************************************************************************/
 /* internal_rgb_scandouble */
 
@@ -1675,6 +2271,68 @@ static inline void internal_rgb_scandouble32_def(unsigned line, uint32* dst, con
 	}
 }
 
+#if defined(USE_ASM_INTRINSIC)
+static inline void internal_rgb_scandouble8_sse2(unsigned line, uint8* dst, const uint8* src, const uint32* data, unsigned count)
+{
+	if (line % 2) {
+		internal_rgb_raw32_1_sse2((uint32*)dst, (uint32*)src, data + RGB_SCANDOUBLE_MASK_1_0_0, count / 4);
+	} else {
+		internal_copy8_sse2(dst, src, count);
+	}
+}
+
+static inline void internal_rgb_scandouble16_sse2(unsigned line, uint16* dst, const uint16* src, const uint32* data, unsigned count)
+{
+	if (line % 2) {
+		internal_rgb_raw32_1_sse2((uint32*)dst, (uint32*)src, data + RGB_SCANDOUBLE_MASK_1_0_0, count / 2);
+	} else {
+		internal_copy16_sse2(dst, src, count);
+	}
+}
+
+static inline void internal_rgb_scandouble32_sse2(unsigned line, uint32* dst, const uint32* src, const uint32* data, unsigned count)
+{
+	if (line % 2) {
+		if (data[RGB_SCANDOUBLE_MASK_1_0_0] == 0)
+			internal_rgb_raw32_1_sse2(dst, src, data + RGB_SCANDOUBLE_MASK_1_0_0, count);
+		else
+			internal_rgb_raw32_01_sse2(dst, src, data + RGB_SCANDOUBLE_MASK_1_0_0, count);
+	} else {
+		internal_copy32_sse2(dst, src, count);
+	}
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_scandouble8_avx2(unsigned line, uint8* dst, const uint8* src, const uint32* data, unsigned count)
+{
+	if (line % 2) {
+		internal_rgb_raw32_1_avx2((uint32*)dst, (uint32*)src, data + RGB_SCANDOUBLE_MASK_1_0_0, count / 4);
+	} else {
+		internal_copy8_avx2(dst, src, count);
+	}
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_scandouble16_avx2(unsigned line, uint16* dst, const uint16* src, const uint32* data, unsigned count)
+{
+	if (line % 2) {
+		internal_rgb_raw32_1_avx2((uint32*)dst, (uint32*)src, data + RGB_SCANDOUBLE_MASK_1_0_0, count / 2);
+	} else {
+		internal_copy16_avx2(dst, src, count);
+	}
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_scandouble32_avx2(unsigned line, uint32* dst, const uint32* src, const uint32* data, unsigned count)
+{
+	if (line % 2) {
+		if (data[RGB_SCANDOUBLE_MASK_1_0_0] == 0)
+			internal_rgb_raw32_1_avx2(dst, src, data + RGB_SCANDOUBLE_MASK_1_0_0, count);
+		else
+			internal_rgb_raw32_01_avx2(dst, src, data + RGB_SCANDOUBLE_MASK_1_0_0, count);
+	} else {
+		internal_copy32_avx2(dst, src, count);
+	}
+}
+#endif
+
 /***************************************************************************/
 /* internal_rgb_scandoublevert */
 
@@ -1733,6 +2391,38 @@ static inline void internal_rgb_scandoublevert32_def(uint32* dst, const uint32*
 	internal_rgb_raw32_01_def(dst, src, data + RGB_SCANDOUBLEVERT_MASK_0_0_0, count);
 }
 
+#if defined(USE_ASM_INTRINSIC)
+static inline void internal_rgb_scandoublevert8_sse2(uint8* dst, const uint8* src, const uint32* data, unsigned count)
+{
+	internal_rgb_raw32_01_sse2((uint32*)dst, (uint32*)src, data + RGB_SCANDOUBLEVERT_MASK_0_0_0, count / 4);
+}
+
+static inline void internal_rgb_scandoublevert16_sse2(uint16* dst, const uint16* src, const uint32* data, unsigned count)
+{
+	internal_rgb_raw32_01_sse2((uint32*)dst, (uint32*)src, data + RGB_SCANDOUBLEVERT_MASK_0_0_0, count / 2);
+}
+
+static inline void internal_rgb_scandoublevert32_sse2(uint32* dst, const uint32* src, const uint32* data, unsigned count)
+{
+	internal_rgb_raw32_01_sse2(dst, src, data + RGB_SCANDOUBLEVERT_MASK_0_0_0, count);
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_scandoublevert8_avx2(uint8* dst, const uint8* src, const uint32* data, unsigned count)
+{
+	internal_rgb_raw32_01_avx2((uint32*)dst, (uint32*)src, data + RGB_SCANDOUBLEVERT_MASK_0_0_0, count / 4);
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_scandoublevert16_avx2(uint16* dst, const uint16* src, const uint32* data, unsigned count)
+{
+	internal_rgb_raw32_01_avx2((uint32*)dst, (uint32*)src, data + RGB_SCANDOUBLEVERT_MASK_0_0_0, count / 2);
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_scandoublevert32_avx2(uint32* dst, const uint32* src, const uint32* data, unsigned count)
+{
+	internal_rgb_raw32_01_avx2(dst, src, data + RGB_SCANDOUBLEVERT_MASK_0_0_0, count);
+}
+#endif
+
 /***************************************************************************/
 /* internal_rgb_scantriple */
 
@@ -1899,6 +2589,110 @@ static inline void internal_rgb_scantriple32_def(unsigned line, uint32* dst, con
 	}
 }
 
+#if defined(USE_ASM_INTRINSIC)
+static inline void internal_rgb_scantriple8_sse2(unsigned line, uint8* dst, const uint8* src, const uint32* data, unsigned count)
+{
+	switch (line % 3) {
+	case 0:
+		internal_copy8_sse2(dst, src, count);
+		break;
+	case 1:
+		internal_rgb_raw32_1_sse2((uint32*)dst, (uint32*)src, data + RGB_SCANTRIPLE_MASK_1_0_0, count / 4);
+		break;
+	case 2:
+		internal_rgb_raw32_2_sse2((uint32*)dst, (uint32*)src, data + RGB_SCANTRIPLE_MASK_2_0_0, count / 4);
+		break;
+	}
+}
+
+static inline void internal_rgb_scantriple16_sse2(unsigned line, uint16* dst, const uint16* src, const uint32* data, unsigned count)
+{
+	switch (line % 3) {
+	case 0:
+		internal_copy16_sse2(dst, src, count);
+		break;
+	case 1:
+		internal_rgb_raw32_1_sse2((uint32*)dst, (uint32*)src, data + RGB_SCANTRIPLE_MASK_1_0_0, count / 2);
+		break;
+	case 2:
+		internal_rgb_raw32_2_sse2((uint32*)dst, (uint32*)src, data + RGB_SCANTRIPLE_MASK_2_0_0, count / 2);
+		break;
+	}
+}
+
+static inline void internal_rgb_scantriple32_sse2(unsigned line, uint32* dst, const uint32* src, const uint32* data, unsigned count)
+{
+	switch (line % 3) {
+	case 0:
+		internal_copy32_sse2(dst, src, count);
+		break;
+	case 1:
+		if (data[RGB_SCANTRIPLE_MASK_1_0_0] == 0)
+			internal_rgb_raw32_1_sse2(dst, src, data + RGB_SCANTRIPLE_MASK_1_0_0, count);
+		else
+			internal_rgb_raw32_01_sse2(dst, src, data + RGB_SCANTRIPLE_MASK_1_0_0, count);
+		break;
+	case 2:
+		if (data[RGB_SCANTRIPLE_MASK_2_0_0] == 0)
+			internal_rgb_raw32_2_sse2(dst, src, data + RGB_SCANTRIPLE_MASK_2_0_0, count);
+		else
+			internal_rgb_raw32_02_sse2(dst, src, data + RGB_SCANTRIPLE_MASK_2_0_0, count);
+		break;
+	}
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_scantriple8_avx2(unsigned line, uint8* dst, const uint8* src, const uint32* data, unsigned count)
+{
+	switch (line % 3) {
+	case 0:
+		internal_copy8_avx2(dst, src, count);
+		break;
+	case 1:
+		internal_rgb_raw32_1_avx2((uint32*)dst, (uint32*)src, data + RGB_SCANTRIPLE_MASK_1_0_0, count / 4);
+		break;
+	case 2:
+		internal_rgb_raw32_2_avx2((uint32*)dst, (uint32*)src, data + RGB_SCANTRIPLE_MASK_2_0_0, count / 4);
+		break;
+	}
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_scantriple16_avx2(unsigned line, uint16* dst, const uint16* src, const uint32* data, unsigned count)
+{
+	switch (line % 3) {
+	case 0:
+		internal_copy16_avx2(dst, src, count);
+		break;
+	case 1:
+		internal_rgb_raw32_1_avx2((uint32*)dst, (uint32*)src, data + RGB_SCANTRIPLE_MASK_1_0_0, count / 2);
+		break;
+	case 2:
+		internal_rgb_raw32_2_avx2((uint32*)dst, (uint32*)src, data + RGB_SCANTRIPLE_MASK_2_0_0, count / 2);
+		break;
+	}
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_scantriple32_avx2(unsigned line, uint32* dst, const uint32* src, const uint32* data, unsigned count)
+{
+	switch (line % 3) {
+	case 0:
+		internal_copy32_avx2(dst, src, count);
+		break;
+	case 1:
+		if (data[RGB_SCANTRIPLE_MASK_1_0_0] == 0)
+			internal_rgb_raw32_1_avx2(dst, src, data + RGB_SCANTRIPLE_MASK_1_0_0, count);
+		else
+			internal_rgb_raw32_01_avx2(dst, src, data + RGB_SCANTRIPLE_MASK_1_0_0, count);
+		break;
+	case 2:
+		if (data[RGB_SCANTRIPLE_MASK_2_0_0] == 0)
+			internal_rgb_raw32_2_avx2(dst, src, data + RGB_SCANTRIPLE_MASK_2_0_0, count);
+		else
+			internal_rgb_raw32_02_avx2(dst, src, data + RGB_SCANTRIPLE_MASK_2_0_0, count);
+		break;
+	}
+}
+#endif
+
 /***************************************************************************/
 /* internal_rgb_scantriplevert */
 
@@ -1973,6 +2767,38 @@ static inline void internal_rgb_scantriplevert32_def(uint32* dst, const uint32*
 	internal_rgb_raw32x3_012_def(dst, src, data + RGB_SCANTRIPLEVERT_MASK_0_0_0, count);
 }
 
+#if defined(USE_ASM_INTRINSIC)
+static inline void internal_rgb_scantriplevert8_sse2(uint8* dst, const uint8* src, const uint32* data, unsigned count)
+{
+	internal_rgb_raw32x3_012_sse2((uint32*)dst, (uint32*)src, data + RGB_SCANTRIPLEVERT_MASK_0_0_0, count / 4);
+}
+
+static inline void internal_rgb_scantriplevert16_sse2(uint16* dst, const uint16* src, const uint32* data, unsigned count)
+{
+	internal_rgb_raw32x3_012_sse2((uint32*)dst, (uint32*)src, data + RGB_SCANTRIPLEVERT_MASK_0_0_0, count / 2);
+}
+
+static inline void internal_rgb_scantriplevert32_sse2(uint32* dst, const uint32* src, const uint32* data, unsigned count)
+{
+	internal_rgb_raw32x3_012_sse2(dst, src, data + RGB_SCANTRIPLEVERT_MASK_0_0_0, count);
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_scantriplevert8_avx2(uint8* dst, const uint8* src, const uint32* data, unsigned count)
+{
+	internal_rgb_raw32x3_012_avx2((uint32*)dst, (uint32*)src, data + RGB_SCANTRIPLEVERT_MASK_0_0_0, count / 4);
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_scantriplevert16_avx2(uint16* dst, const uint16* src, const uint32* data, unsigned count)
+{
+	internal_rgb_raw32x3_012_avx2((uint32*)dst, (uint32*)src, data + RGB_SCANTRIPLEVERT_MASK_0_0_0, count / 2);
+}
+
+static inline ASM_TARGET_AVX2 void internal_rgb_scantriplevert32_avx2(uint32* dst, const uint32* src, const uint32* data, unsigned count)
+{
+	internal_rgb_raw32x3_012_avx2(dst, src, data + RGB_SCANTRIPLEVERT_MASK_0_0_0, count);
+}
+#endif
+
 /***************************************************************************/
 /* internal_rgb_skipdouble */
 
@@ -34,6 +34,12 @@
 
 #include <assert.h>
 
+#if defined(USE_ASM_INTRINSIC)
+#include <immintrin.h>
+
+#define SCALE2K_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
 /***************************************************************************/
 /* Scale2k C implementation */
 
@@ -75,11 +81,15 @@
 #define interp_13(A, B) interp_16_31(B, A)
 #define interp_11(A, B) interp_16_11(A, B)
 
-void scale2k_16_def(interp_uint16* restrict dst0, interp_uint16* restrict dst1, const interp_uint16* restrict src0, const interp_uint16* restrict src1, const interp_uint16* restrict src2, unsigned count)
+static inline void scale2k_16_def_range(interp_uint16* restrict dst0, interp_uint16* restrict dst1, const interp_uint16* restrict src0, const interp_uint16* restrict src1, const interp_uint16* restrict src2, unsigned i, unsigned end, unsigned count)
 {
-	unsigned i;
+	src0 += i;
+	src1 += i;
+	src2 += i;
+	dst0 += 2 * i;
+	dst1 += 2 * i;
 
-	for (i = 0; i < count; ++i) {
+	for (; i < end; ++i) {
 		interp_uint16 c[9];
 		interp_uint16 e[4];
 
@@ -130,6 +140,11 @@ void scale2k_16_def(interp_uint16* restrict dst0, interp_uint16* restrict dst1,
 	}
 }
 
+void scale2k_16_def(interp_uint16* restrict dst0, interp_uint16* restrict dst1, const interp_uint16* restrict src0, const interp_uint16* restrict src1, const interp_uint16* restrict src2, unsigned count)
+{
+	scale2k_16_def_range(dst0, dst1, src0, src1, src2, 0, count, count);
+}
+
 #undef interp_31
 #undef interp_13
 #undef interp_11
@@ -138,11 +153,15 @@ void scale2k_16_def(interp_uint16* restrict dst0, interp_uint16* restrict dst1,
 #define interp_13(A, B) interp_32_31(B, A)
 #define interp_11(A, B) interp_32_11(A, B)
 
-void scale2k_32_def(interp_uint32* restrict dst0, interp_uint32* restrict dst1, const interp_uint32* restrict src0, const interp_uint32* restrict src1, const interp_uint32* restrict src2, unsigned count)
+static inline void scale2k_32_def_range(interp_uint32* restrict dst0, interp_uint32* restrict dst1, const interp_uint32* restrict src0, const interp_uint32* restrict src1, const interp_uint32* restrict src2, unsigned i, unsigned end, unsigned count)
 {
-	unsigned i;
+	src0 += i;
+	src1 += i;
+	src2 += i;
+	dst0 += 2 * i;
+	dst1 += 2 * i;
 
-	for (i = 0; i < count; ++i) {
+	for (; i < end; ++i) {
 		interp_uint32 c[9];
 		interp_uint32 e[4];
 
@@ -193,6 +212,11 @@ void scale2k_32_def(interp_uint32* restrict dst0, interp_uint32* restrict dst1,
 	}
 }
 
+void scale2k_32_def(interp_uint32* restrict dst0, interp_uint32* restrict dst1, const interp_uint32* restrict src0, const interp_uint32* restrict src1, const interp_uint32* restrict src2, unsigned count)
+{
+	scale2k_32_def_range(dst0, dst1, src0, src1, src2, 0, count, count);
+}
+
 #undef interp_31
 #undef interp_13
 #undef interp_11
@@ -201,11 +225,15 @@ void scale2k_32_def(interp_uint32* restrict dst0, interp_uint32* restrict dst1,
 #define interp_13(A, B) interp_yuy2_31(B, A)
 #define interp_11(A, B) interp_yuy2_11(A, B)
 
-void scale2k_yuy2_def(interp_uint32* restrict dst0, interp_uint32* restrict dst1, const interp_uint32* restrict src0, const interp_uint32* restrict src1, const interp_uint32* restrict src2, unsigned count)
+static inline void scale2k_yuy2_def_range(interp_uint32* restrict dst0, interp_uint32* restrict dst1, const interp_uint32* restrict src0, const interp_uint32* restrict src1, const interp_uint32* restrict src2, unsigned i, unsigned end, unsigned count)
 {
-	unsigned i;
+	src0 += i;
+	src1 += i;
+	src2 += i;
+	dst0 += 2 * i;
+	dst1 += 2 * i;
 
-	for (i = 0; i < count; ++i) {
+	for (; i < end; ++i) {
 		interp_uint32 c[9];
 		interp_uint32 e[4];
 
@@ -256,3 +284,322 @@ void scale2k_yuy2_def(interp_uint32* restrict dst0, interp_uint32* restrict dst1
 	}
 }
 
+void scale2k_yuy2_def(interp_uint32* restrict dst0, interp_uint32* restrict dst1, const interp_uint32* restrict src0, const interp_uint32* restrict src1, const interp_uint32* restrict src2, unsigned count)
+{
+	scale2k_yuy2_def_range(dst0, dst1, src0, src1, src2, 0, count, count);
+}
+
+/***************************************************************************/
+/* Scale2k SSE2/AVX2 intrinsic implementation */
+
+#if defined(USE_ASM_INTRINSIC)
+
+/*
+ * The vector versions check a whole vector of pixels at a time. If for all
+ * of them none of the four diagonals D == B, H == D, F == H and B == F
+ * is active, the pixels are simply replicated. Otherwise, and for the
+ * first and last pixels, the C implementation is used.
+ * This is the common case with the sharp edges of the game graphics.
+ */
+
+/**
+ * Scale by a factor of 2 a row of pixels with the Scale2k effect.
+ * This function operates like scale2k_16_def() but it uses the SSE2
+ * instruction set.
+ */
+void scale2k_16_sse2(interp_uint16* dst0, interp_uint16* dst1, const interp_uint16* src0, const interp_uint16* src1, const interp_uint16* src2, unsigned count)
+{
+	unsigned i = 0;
+
+	if (count > 8 + 1) {
+		/* first pixel */
+		scale2k_16_def_range(dst0, dst1, src0, src1, src2, 0, 1, count);
+
+		/* central pixels */
+		for (i = 1; i + 8 < count; i += 8) {
+			__m128i b, d, e, f, h;
+			__m128i m;
+			__m128i lo, hi;
+
+			b = _mm_loadu_si128((const __m128i*)(src0 + i));
+			d = _mm_loadu_si128((const __m128i*)(src1 + i - 1));
+			e = _mm_loadu_si128((const __m128i*)(src1 + i));
+			f = _mm_loadu_si128((const __m128i*)(src1 + i + 1));
+			h = _mm_loadu_si128((const __m128i*)(src2 + i));
+
+			/* m = (D == B && B != E) || (H == D && D != E) || (F == H && H != E) || (B == F && F != E) */
+			m = _mm_or_si128(_mm_andnot_si128(_mm_cmpeq_epi16(b, e), _mm_cmpeq_epi16(d, b)), _mm_andnot_si128(_mm_cmpeq_epi16(d, e), _mm_cmpeq_epi16(h, d)));
+			m = _mm_or_si128(m, _mm_or_si128(_mm_andnot_si128(_mm_cmpeq_epi16(h, e), _mm_cmpeq_epi16(f, h)), _mm_andnot_si128(_mm_cmpeq_epi16(f, e), _mm_cmpeq_epi16(b, f))));
+
+			if (_mm_movemask_epi8(m) != 0) {
+				scale2k_16_def_range(dst0, dst1, src0, src1, src2, i, i + 8, count);
+				continue;
+			}
+
+			/* all the pixels are copied */
+			lo = _mm_unpacklo_epi16(e, e);
+			hi = _mm_unpackhi_epi16(e, e);
+			_mm_storeu_si128((__m128i*)(dst0 + 2 * i + 0), lo);
+			_mm_storeu_si128((__m128i*)(dst0 + 2 * i + 8), hi);
+			_mm_storeu_si128((__m128i*)(dst1 + 2 * i + 0), lo);
+			_mm_storeu_si128((__m128i*)(dst1 + 2 * i + 8), hi);
+		}
+	}
+
+	/* remaining pixels */
+	scale2k_16_def_range(dst0, dst1, src0, src1, src2, i, count, count);
+}
+
+/**
+ * Scale by a factor of 2 a row of pixels with the Scale2k effect.
+ * This function operates like scale2k_32_def() but it uses the SSE2
+ * instruction set.
+ */
+void scale2k_32_sse2(interp_uint32* dst0, interp_uint32* dst1, const interp_uint32* src0, const interp_uint32* src1, const interp_uint32* src2, unsigned count)
+{
+	unsigned i = 0;
+
+	if (count > 4 + 1) {
+		/* first pixel */
+		scale2k_32_def_range(dst0, dst1, src0, src1, src2, 0, 1, count);
+
+		/* central pixels */
+		for (i = 1; i + 4 < count; i += 4) {
+			__m128i b, d, e, f, h;
+			__m128i m;
+			__m128i lo, hi;
+
+			b = _mm_loadu_si128((const __m128i*)(src0 + i));
+			d = _mm_loadu_si128((const __m128i*)(src1 + i - 1));
+			e = _mm_loadu_si128((const __m128i*)(src1 + i));
+			f = _mm_loadu_si128((const __m128i*)(src1 + i + 1));
+			h = _mm_loadu_si128((const __m128i*)(src2 + i));
+
+			/* m = (D == B && B != E) || (H == D && D != E) || (F == H && H != E) || (B == F && F != E) */
+			m = _mm_or_si128(_mm_andnot_si128(_mm_cmpeq_epi32(b, e), _mm_cmpeq_epi32(d, b)), _mm_andnot_si128(_mm_cmpeq_epi32(d, e), _mm_cmpeq_epi32(h, d)));
+			m = _mm_or_si128(m, _mm_or_si128(_mm_andnot_si128(_mm_cmpeq_epi32(h, e), _mm_cmpeq_epi32(f, h)), _mm_andnot_si128(_mm_cmpeq_epi32(f, e), _mm_cmpeq_epi32(b, f))));
+
+			if (_mm_movemask_epi8(m) != 0) {
+				scale2k_32_def_range(dst0, dst1, src0, src1, src2, i, i + 4, count);
+				continue;
+			}
+
+			/* all the pixels are copied */
+			lo = _mm_unpacklo_epi32(e, e);
+			hi = _mm_unpackhi_epi32(e, e);
+			_mm_storeu_si128((__m128i*)(dst0 + 2 * i + 0), lo);
+			_mm_storeu_si128((__m128i*)(dst0 + 2 * i + 4), hi);
+			_mm_storeu_si128((__m128i*)(dst1 + 2 * i + 0), lo);
+			_mm_storeu_si128((__m128i*)(dst1 + 2 * i + 4), hi);
+		}
+	}
+
+	/* remaining pixels */
+	scale2k_32_def_range(dst0, dst1, src0, src1, src2, i, count, count);
+}
+
+/**
+ * Scale by a factor of 2 a row of pixels with the Scale2k effect.
+ * This function operates like scale2k_yuy2_def() but it uses the SSE2
+ * instruction set.
+ */
+void scale2k_yuy2_sse2(interp_uint32* dst0, interp_uint32* dst1, const interp_uint32* src0, const interp_uint32* src1, const interp_uint32* src2, unsigned count)
+{
+	unsigned i = 0;
+
+	if (count > 4 + 1) {
+		/* first pixel */
+		scale2k_yuy2_def_range(dst0, dst1, src0, src1, src2, 0, 1, count);
+
+		/* central pixels */
+		for (i = 1; i + 4 < count; i += 4) {
+			__m128i b, d, e, f, h;
+			__m128i m;
+			__m128i lo, hi;
+
+			b = _mm_loadu_si128((const __m128i*)(src0 + i));
+			d = _mm_loadu_si128((const __m128i*)(src1 + i - 1));
+			e = _mm_loadu_si128((const __m128i*)(src1 + i));
+			f = _mm_loadu_si128((const __m128i*)(src1 + i + 1));
+			h = _mm_loadu_si128((const __m128i*)(src2 + i));
+
+			/* m = (D == B && B != E) || (H == D && D != E) || (F == H && H != E) || (B == F && F != E) */
+			m = _mm_or_si128(_mm_andnot_si128(_mm_cmpeq_epi32(b, e), _mm_cmpeq_epi32(d, b)), _mm_andnot_si128(_mm_cmpeq_epi32(d, e), _mm_cmpeq_epi32(h, d)));
+			m = _mm_or_si128(m, _mm_or_si128(_mm_andnot_si128(_mm_cmpeq_epi32(h, e), _mm_cmpeq_epi32(f, h)), _mm_andnot_si128(_mm_cmpeq_epi32(f, e), _mm_cmpeq_epi32(b, f))));
+
+			if (_mm_movemask_epi8(m) != 0) {
+				scale2k_yuy2_def_range(dst0, dst1, src0, src1, src2, i, i + 4, count);
+				continue;
+			}
+
+			/* all the pixels are copied */
+			lo = _mm_unpacklo_epi32(e, e);
+			hi = _mm_unpackhi_epi32(e, e);
+			_mm_storeu_si128((__m128i*)(dst0 + 2 * i + 0), lo);
+			_mm_storeu_si128((__m128i*)(dst0 + 2 * i + 4), hi);
+			_mm_storeu_si128((__m128i*)(dst1 + 2 * i + 0), lo);
+			_mm_storeu_si128((__m128i*)(dst1 + 2 * i + 4), hi);
+		}
+	}
+
+	/* remaining pixels */
+	scale2k_yuy2_def_range(dst0, dst1, src0, src1, src2, i, count, count);
+}
+
+/**
+ * Scale by a factor of 2 a row of pixels with the Scale2k effect.
+ * This function operates like scale2k_16_def() but it uses the AVX2
+ * instruction set. It must be called only if the processor supports it.
+ */
+SCALE2K_TARGET_AVX2 void scale2k_16_avx2(interp_uint16* dst0, interp_uint16* dst1, const interp_uint16* src0, const interp_uint16* src1, const interp_uint16* src2, unsigned count)
+{
+	unsigned i = 0;
+
+	if (count > 16 + 1) {
+		/* first pixel */
+		scale2k_16_def_range(dst0, dst1, src0, src1, src2, 0, 1, count);
+
+		/* central pixels */
+		for (i = 1; i + 16 < count; i += 16) {
+			__m256i b, d, e, f, h;
+			__m256i m;
+			__m256i lo, hi;
+			__m256i t;
+
+			b = _mm256_loadu_si256((const __m256i*)(src0 + i));
+			d = _mm256_loadu_si256((const __m256i*)(src1 + i - 1));
+			e = _mm256_loadu_si256((const __m256i*)(src1 + i));
+			f = _mm256_loadu_si256((const __m256i*)(src1 + i + 1));
+			h = _mm256_loadu_si256((const __m256i*)(src2 + i));
+
+			/* m = (D == B && B != E) || (H == D && D != E) || (F == H && H != E) || (B == F && F != E) */
+			m = _mm256_or_si256(_mm256_andnot_si256(_mm256_cmpeq_epi16(b, e), _mm256_cmpeq_epi16(d, b)), _mm256_andnot_si256(_mm256_cmpeq_epi16(d, e), _mm256_cmpeq_epi16(h, d)));
+			m = _mm256_or_si256(m, _mm256_or_si256(_mm256_andnot_si256(_mm256_cmpeq_epi16(h, e), _mm256_cmpeq_epi16(f, h)), _mm256_andnot_si256(_mm256_cmpeq_epi16(f, e), _mm256_cmpeq_epi16(b, f))));
+
+			if (_mm256_movemask_epi8(m) != 0) {
+				scale2k_16_def_range(dst0, dst1, src0, src1, src2, i, i + 16, count);
+				continue;
+			}
+
+			/* all the pixels are copied */
+			lo = _mm256_unpacklo_epi16(e, e);
+			hi = _mm256_unpackhi_epi16(e, e);
+			t = _mm256_permute2x128_si256(lo, hi, 0x20);
+			hi = _mm256_permute2x128_si256(lo, hi, 0x31);
+			lo = t;
+			_mm256_storeu_si256((__m256i*)(dst0 + 2 * i + 0), lo);
+			_mm256_storeu_si256((__m256i*)(dst0 + 2 * i + 16), hi);
+			_mm256_storeu_si256((__m256i*)(dst1 + 2 * i + 0), lo);
+			_mm256_storeu_si256((__m256i*)(dst1 + 2 * i + 16), hi);
+		}
+	}
+
+	/* remaining pixels */
+	scale2k_16_def_range(dst0, dst1, src0, src1, src2, i, count, count);
+}
+
+/**
+ * Scale by a factor of 2 a row of pixels with the Scale2k effect.
+ * This function operates like scale2k_32_def() but it uses the AVX2
+ * instruction set. It must be called only if the processor supports it.
+ */
+SCALE2K_TARGET_AVX2 void scale2k_32_avx2(interp_uint32* dst0, interp_uint32* dst1, const interp_uint32* src0, const interp_uint32* src1, const interp_uint32* src2, unsigned count)
+{
+	unsigned i = 0;
+
+	if (count > 8 + 1) {
+		/* first pixel */
+		scale2k_32_def_range(dst0, dst1, src0, src1, src2, 0, 1, count);
+
+		/* central pixels */
+		for (i = 1; i + 8 < count; i += 8) {
+			__m256i b, d, e, f, h;
+			__m256i m;
+			__m256i lo, hi;
+			__m256i t;
+
+			b = _mm256_loadu_si256((const __m256i*)(src0 + i));
+			d = _mm256_loadu_si256((const __m256i*)(src1 + i - 1));
+			e = _mm256_loadu_si256((const __m256i*)(src1 + i));
+			f = _mm256_loadu_si256((const __m256i*)(src1 + i + 1));
+			h = _mm256_loadu_si256((const __m256i*)(src2 + i));
+
+			/* m = (D == B && B != E) || (H == D && D != E) || (F == H && H != E) || (B == F && F != E) */
+			m = _mm256_or_si256(_mm256_andnot_si256(_mm256_cmpeq_epi32(b, e), _mm256_cmpeq_epi32(d, b)), _mm256_andnot_si256(_mm256_cmpeq_epi32(d, e), _mm256_cmpeq_epi32(h, d)));
+			m = _mm256_or_si256(m, _mm256_or_si256(_mm256_andnot_si256(_mm256_cmpeq_epi32(h, e), _mm256_cmpeq_epi32(f, h)), _mm256_andnot_si256(_mm256_cmpeq_epi32(f, e), _mm256_cmpeq_epi32(b, f))));
+
+			if (_mm256_movemask_epi8(m) != 0) {
+				scale2k_32_def_range(dst0, dst1, src0, src1, src2, i, i + 8, count);
+				continue;
+			}
+
+			/* all the pixels are copied */
+			lo = _mm256_unpacklo_epi32(e, e);
+			hi = _mm256_unpackhi_epi32(e, e);
+			t = _mm256_permute2x128_si256(lo, hi, 0x20);
+			hi = _mm256_permute2x128_si256(lo, hi, 0x31);
+			lo = t;
+			_mm256_storeu_si256((__m256i*)(dst0 + 2 * i + 0), lo);
+			_mm256_storeu_si256((__m256i*)(dst0 + 2 * i + 8), hi);
+			_mm256_storeu_si256((__m256i*)(dst1 + 2 * i + 0), lo);
+			_mm256_storeu_si256((__m256i*)(dst1 + 2 * i + 8), hi);
+		}
+	}
+
+	/* remaining pixels */
+	scale2k_32_def_range(dst0, dst1, src0, src1, src2, i, count, count);
+}
+
+/**
+ * Scale by a factor of 2 a row of pixels with the Scale2k effect.
+ * This function operates like scale2k_yuy2_def() but it uses the AVX2
+ * instruction set. It must be called only if the processor supports it.
+ */
+SCALE2K_TARGET_AVX2 void scale2k_yuy2_avx2(interp_uint32* dst0, interp_uint32* dst1, const interp_uint32* src0, const interp_uint32* src1, const interp_uint32* src2, unsigned count)
+{
+	unsigned i = 0;
+
+	if (count > 8 + 1) {
+		/* first pixel */
+		scale2k_yuy2_def_range(dst0, dst1, src0, src1, src2, 0, 1, count);
+
+		/* central pixels */
+		for (i = 1; i + 8 < count; i += 8) {
+			__m256i b, d, e, f, h;
+			__m256i m;
+			__m256i lo, hi;
+			__m256i t;
+
+			b = _mm256_loadu_si256((const __m256i*)(src0 + i));
+			d = _mm256_loadu_si256((const __m256i*)(src1 + i - 1));
+			e = _mm256_loadu_si256((const __m256i*)(src1 + i));
+			f = _mm256_loadu_si256((const __m256i*)(src1 + i + 1));
+			h = _mm256_loadu_si256((const __m256i*)(src2 + i));
+
+			/* m = (D == B && B != E) || (H == D && D != E) || (F == H && H != E) || (B == F && F != E) */
+			m = _mm256_or_si256(_mm256_andnot_si256(_mm256_cmpeq_epi32(b, e), _mm256_cmpeq_epi32(d, b)), _mm256_andnot_si256(_mm256_cmpeq_epi32(d, e), _mm256_cmpeq_epi32(h, d)));
+			m = _mm256_or_si256(m, _mm256_or_si256(_mm256_andnot_si256(_mm256_cmpeq_epi32(h, e), _mm256_cmpeq_epi32(f, h)), _mm256_andnot_si256(_mm256_cmpeq_epi32(f, e), _mm256_cmpeq_epi32(b, f))));
+
+			if (_mm256_movemask_epi8(m) != 0) {
+				scale2k_yuy2_def_range(dst0, dst1, src0, src1, src2, i, i + 8, count);
+				continue;
+			}
+
+			/* all the pixels are copied */
+			lo = _mm256_unpacklo_epi32(e, e);
+			hi = _mm256_unpackhi_epi32(e, e);
+			t = _mm256_permute2x128_si256(lo, hi, 0x20);
+			hi = _mm256_permute2x128_si256(lo, hi, 0x31);
+			lo = t;
+			_mm256_storeu_si256((__m256i*)(dst0 + 2 * i + 0), lo);
+			_mm256_storeu_si256((__m256i*)(dst0 + 2 * i + 8), hi);
+			_mm256_storeu_si256((__m256i*)(dst1 + 2 * i + 0), lo);
+			_mm256_storeu_si256((__m256i*)(dst1 + 2 * i + 8), hi);
+		}
+	}
+
+	/* remaining pixels */
+	scale2k_yuy2_def_range(dst0, dst1, src0, src1, src2, i, count, count);
+}
+
+#endif
@@ -37,5 +37,22 @@ void scale2k_16_def(interp_uint16* dst0, interp_uint16* dst1, const interp_uint1
 void scale2k_32_def(interp_uint32* dst0, interp_uint32* dst1, const interp_uint32* src0, const interp_uint32* src1, const interp_uint32* src2, unsigned count);
 void scale2k_yuy2_def(interp_uint32* dst0, interp_uint32* dst1, const interp_uint32* src0, const interp_uint32* src1, const interp_uint32* src2, unsigned count);
 
+#if defined(USE_ASM_INLINE)
+/* No assembler version, use the C one */
+#define scale2k_16_asm scale2k_16_def
+#define scale2k_32_asm scale2k_32_def
+#define scale2k_yuy2_asm scale2k_yuy2_def
+#endif
+
+#if defined(USE_ASM_INTRINSIC)
+void scale2k_16_sse2(interp_uint16* dst0, interp_uint16* dst1, const interp_uint16* src0, const interp_uint16* src1, const interp_uint16* src2, unsigned count);
+void scale2k_32_sse2(interp_uint32* dst0, interp_uint32* dst1, const interp_uint32* src0, const interp_uint32* src1, const interp_uint32* src2, unsigned count);
+void scale2k_yuy2_sse2(interp_uint32* dst0, interp_uint32* dst1, const interp_uint32* src0, const interp_uint32* src1, const interp_uint32* src2, unsigned count);
+
+void scale2k_16_avx2(interp_uint16* dst0, interp_uint16* dst1, const interp_uint16* src0, const interp_uint16* src1, const interp_uint16* src2, unsigned count);
+void scale2k_32_avx2(interp_uint32* dst0, interp_uint32* dst1, const interp_uint32* src0, const interp_uint32* src1, const interp_uint32* src2, unsigned count);
+void scale2k_yuy2_avx2(interp_uint32* dst0, interp_uint32* dst1, const interp_uint32* src0, const interp_uint32* src1, const interp_uint32* src2, unsigned count);
+#endif
+
 #endif
 
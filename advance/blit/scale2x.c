@@ -19,7 +19,7 @@
  */
 
 /*
- * This file contains a C and MMX implementation of the Scale2x effect.
+ * This file contains a C, MMX and SSE2/AVX2 implementation of the Scale2x effect.
  *
  * You can find an high level description of the effect at :
  *
@@ -38,6 +38,12 @@
 
 #include <assert.h>
 
+#if defined(USE_ASM_INTRINSIC)
+#include <immintrin.h>
+
+#define SCALE2X_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
 /***************************************************************************/
 /* Scale2x C implementation */
 
@@ -1497,3 +1503,703 @@ void scale2x4_32_asm(scale2x_uint32* dst0, scale2x_uint32* dst1, scale2x_uint32*
 
 #endif
 
+/***************************************************************************/
+/* Scale2x SSE2/AVX2 intrinsic implementation */
+
+#if defined(USE_ASM_INTRINSIC)
+
+/*
+ * Apply the Scale2x effect at a single row using vector registers.
+ * This function must be called only by the other scale2x functions.
+ *
+ * It computes the same result of the scale2x_*_def_border() functions.
+ * The first and the last pixels, and the central pixels not filling a
+ * whole vector register, are computed with scalar code.
+ *
+ * With the pixel map :
+ *
+ *      ABC (src0)
+ *      DEF (src1)
+ *      GHI (src2)
+ *
+ * the vector registers contain :
+ *
+ *      b -> B (src0)
+ *      d -> D (src1 - 1)
+ *      e -> E (src1)
+ *      f -> F (src1 + 1)
+ *      h -> H (src2)
+ */
+
+static inline void scale2x_8_sse2_border(scale2x_uint8* restrict dst, const scale2x_uint8* restrict src0, const scale2x_uint8* restrict src1, const scale2x_uint8* restrict src2, unsigned count)
+{
+	assert(count >= 2);
+
+	/* first pixel */
+	if (src0[0] != src2[0] && src1[0] != src1[1]) {
+		dst[0] = src1[0] == src0[0] ? src0[0] : src1[0];
+		dst[1] = src1[1] == src0[0] ? src0[0] : src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+	}
+	++src0;
+	++src1;
+	++src2;
+	dst += 2;
+	--count;
+
+	/* central pixels */
+	--count;
+	while (count >= 16) {
+		__m128i b = _mm_loadu_si128((const __m128i*)(src0));
+		__m128i d = _mm_loadu_si128((const __m128i*)(src1 - 1));
+		__m128i e = _mm_loadu_si128((const __m128i*)(src1));
+		__m128i f = _mm_loadu_si128((const __m128i*)(src1 + 1));
+		__m128i h = _mm_loadu_si128((const __m128i*)(src2));
+		__m128i c, a0, a1;
+
+		/* c = B != H && D != F */
+		c = _mm_andnot_si128(_mm_or_si128(_mm_cmpeq_epi8(b, h), _mm_cmpeq_epi8(d, f)), _mm_set1_epi32(-1));
+
+		/* a0 = c && D == B ? B : E */
+		a0 = _mm_and_si128(c, _mm_cmpeq_epi8(d, b));
+		a0 = _mm_or_si128(_mm_and_si128(a0, b), _mm_andnot_si128(a0, e));
+
+		/* a1 = c && F == B ? B : E */
+		a1 = _mm_and_si128(c, _mm_cmpeq_epi8(f, b));
+		a1 = _mm_or_si128(_mm_and_si128(a1, b), _mm_andnot_si128(a1, e));
+
+		_mm_storeu_si128((__m128i*)(dst), _mm_unpacklo_epi8(a0, a1));
+		_mm_storeu_si128((__m128i*)(dst + 16), _mm_unpackhi_epi8(a0, a1));
+
+		src0 += 16;
+		src1 += 16;
+		src2 += 16;
+		dst += 32;
+		count -= 16;
+	}
+
+	while (count) {
+		if (src0[0] != src2[0] && src1[-1] != src1[1]) {
+			dst[0] = src1[-1] == src0[0] ? src0[0] : src1[0];
+			dst[1] = src1[1] == src0[0] ? src0[0] : src1[0];
+		} else {
+			dst[0] = src1[0];
+			dst[1] = src1[0];
+		}
+
+		++src0;
+		++src1;
+		++src2;
+		dst += 2;
+		--count;
+	}
+
+	/* last pixel */
+	if (src0[0] != src2[0] && src1[-1] != src1[0]) {
+		dst[0] = src1[-1] == src0[0] ? src0[0] : src1[0];
+		dst[1] = src1[0] == src0[0] ? src0[0] : src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+	}
+}
+
+static inline void scale2x_16_sse2_border(scale2x_uint16* restrict dst, const scale2x_uint16* restrict src0, const scale2x_uint16* restrict src1, const scale2x_uint16* restrict src2, unsigned count)
+{
+	assert(count >= 2);
+
+	/* first pixel */
+	if (src0[0] != src2[0] && src1[0] != src1[1]) {
+		dst[0] = src1[0] == src0[0] ? src0[0] : src1[0];
+		dst[1] = src1[1] == src0[0] ? src0[0] : src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+	}
+	++src0;
+	++src1;
+	++src2;
+	dst += 2;
+	--count;
+
+	/* central pixels */
+	--count;
+	while (count >= 8) {
+		__m128i b = _mm_loadu_si128((const __m128i*)(src0));
+		__m128i d = _mm_loadu_si128((const __m128i*)(src1 - 1));
+		__m128i e = _mm_loadu_si128((const __m128i*)(src1));
+		__m128i f = _mm_loadu_si128((const __m128i*)(src1 + 1));
+		__m128i h = _mm_loadu_si128((const __m128i*)(src2));
+		__m128i c, a0, a1;
+
+		/* c = B != H && D != F */
+		c = _mm_andnot_si128(_mm_or_si128(_mm_cmpeq_epi16(b, h), _mm_cmpeq_epi16(d, f)), _mm_set1_epi32(-1));
+
+		/* a0 = c && D == B ? B : E */
+		a0 = _mm_and_si128(c, _mm_cmpeq_epi16(d, b));
+		a0 = _mm_or_si128(_mm_and_si128(a0, b), _mm_andnot_si128(a0, e));
+
+		/* a1 = c && F == B ? B : E */
+		a1 = _mm_and_si128(c, _mm_cmpeq_epi16(f, b));
+		a1 = _mm_or_si128(_mm_and_si128(a1, b), _mm_andnot_si128(a1, e));
+
+		_mm_storeu_si128((__m128i*)(dst), _mm_unpacklo_epi16(a0, a1));
+		_mm_storeu_si128((__m128i*)(dst + 8), _mm_unpackhi_epi16(a0, a1));
+
+		src0 += 8;
+		src1 += 8;
+		src2 += 8;
+		dst += 16;
+		count -= 8;
+	}
+
+	while (count) {
+		if (src0[0] != src2[0] && src1[-1] != src1[1]) {
+			dst[0] = src1[-1] == src0[0] ? src0[0] : src1[0];
+			dst[1] = src1[1] == src0[0] ? src0[0] : src1[0];
+		} else {
+			dst[0] = src1[0];
+			dst[1] = src1[0];
+		}
+
+		++src0;
+		++src1;
+		++src2;
+		dst += 2;
+		--count;
+	}
+
+	/* last pixel */
+	if (src0[0] != src2[0] && src1[-1] != src1[0]) {
+		dst[0] = src1[-1] == src0[0] ? src0[0] : src1[0];
+		dst[1] = src1[0] == src0[0] ? src0[0] : src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+	}
+}
+
+static inline void scale2x_32_sse2_border(scale2x_uint32* restrict dst, const scale2x_uint32* restrict src0, const scale2x_uint32* restrict src1, const scale2x_uint32* restrict src2, unsigned count)
+{
+	assert(count >= 2);
+
+	/* first pixel */
+	if (src0[0] != src2[0] && src1[0] != src1[1]) {
+		dst[0] = src1[0] == src0[0] ? src0[0] : src1[0];
+		dst[1] = src1[1] == src0[0] ? src0[0] : src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+	}
+	++src0;
+	++src1;
+	++src2;
+	dst += 2;
+	--count;
+
+	/* central pixels */
+	--count;
+	while (count >= 4) {
+		__m128i b = _mm_loadu_si128((const __m128i*)(src0));
+		__m128i d = _mm_loadu_si128((const __m128i*)(src1 - 1));
+		__m128i e = _mm_loadu_si128((const __m128i*)(src1));
+		__m128i f = _mm_loadu_si128((const __m128i*)(src1 + 1));
+		__m128i h = _mm_loadu_si128((const __m128i*)(src2));
+		__m128i c, a0, a1;
+
+		/* c = B != H && D != F */
+		c = _mm_andnot_si128(_mm_or_si128(_mm_cmpeq_epi32(b, h), _mm_cmpeq_epi32(d, f)), _mm_set1_epi32(-1));
+
+		/* a0 = c && D == B ? B : E */
+		a0 = _mm_and_si128(c, _mm_cmpeq_epi32(d, b));
+		a0 = _mm_or_si128(_mm_and_si128(a0, b), _mm_andnot_si128(a0, e));
+
+		/* a1 = c && F == B ? B : E */
+		a1 = _mm_and_si128(c, _mm_cmpeq_epi32(f, b));
+		a1 = _mm_or_si128(_mm_and_si128(a1, b), _mm_andnot_si128(a1, e));
+
+		_mm_storeu_si128((__m128i*)(dst), _mm_unpacklo_epi32(a0, a1));
+		_mm_storeu_si128((__m128i*)(dst + 4), _mm_unpackhi_epi32(a0, a1));
+
+		src0 += 4;
+		src1 += 4;
+		src2 += 4;
+		dst += 8;
+		count -= 4;
+	}
+
+	while (count) {
+		if (src0[0] != src2[0] && src1[-1] != src1[1]) {
+			dst[0] = src1[-1] == src0[0] ? src0[0] : src1[0];
+			dst[1] = src1[1] == src0[0] ? src0[0] : src1[0];
+		} else {
+			dst[0] = src1[0];
+			dst[1] = src1[0];
+		}
+
+		++src0;
+		++src1;
+		++src2;
+		dst += 2;
+		--count;
+	}
+
+	/* last pixel */
+	if (src0[0] != src2[0] && src1[-1] != src1[0]) {
+		dst[0] = src1[-1] == src0[0] ? src0[0] : src1[0];
+		dst[1] = src1[0] == src0[0] ? src0[0] : src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+	}
+}
+
+static inline SCALE2X_TARGET_AVX2 void scale2x_8_avx2_border(scale2x_uint8* restrict dst, const scale2x_uint8* restrict src0, const scale2x_uint8* restrict src1, const scale2x_uint8* restrict src2, unsigned count)
+{
+	assert(count >= 2);
+
+	/* first pixel */
+	if (src0[0] != src2[0] && src1[0] != src1[1]) {
+		dst[0] = src1[0] == src0[0] ? src0[0] : src1[0];
+		dst[1] = src1[1] == src0[0] ? src0[0] : src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+	}
+	++src0;
+	++src1;
+	++src2;
+	dst += 2;
+	--count;
+
+	/* central pixels */
+	--count;
+	while (count >= 32) {
+		__m256i b = _mm256_loadu_si256((const __m256i*)(src0));
+		__m256i d = _mm256_loadu_si256((const __m256i*)(src1 - 1));
+		__m256i e = _mm256_loadu_si256((const __m256i*)(src1));
+		__m256i f = _mm256_loadu_si256((const __m256i*)(src1 + 1));
+		__m256i h = _mm256_loadu_si256((const __m256i*)(src2));
+		__m256i c, a0, a1;
+		__m256i lo, hi;
+
+		/* c = B != H && D != F */
+		c = _mm256_andnot_si256(_mm256_or_si256(_mm256_cmpeq_epi8(b, h), _mm256_cmpeq_epi8(d, f)), _mm256_set1_epi32(-1));
+
+		/* a0 = c && D == B ? B : E */
+		a0 = _mm256_and_si256(c, _mm256_cmpeq_epi8(d, b));
+		a0 = _mm256_or_si256(_mm256_and_si256(a0, b), _mm256_andnot_si256(a0, e));
+
+		/* a1 = c && F == B ? B : E */
+		a1 = _mm256_and_si256(c, _mm256_cmpeq_epi8(f, b));
+		a1 = _mm256_or_si256(_mm256_and_si256(a1, b), _mm256_andnot_si256(a1, e));
+
+		lo = _mm256_unpacklo_epi8(a0, a1);
+		hi = _mm256_unpackhi_epi8(a0, a1);
+		_mm256_storeu_si256((__m256i*)(dst), _mm256_permute2x128_si256(lo, hi, 0x20));
+		_mm256_storeu_si256((__m256i*)(dst + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+
+		src0 += 32;
+		src1 += 32;
+		src2 += 32;
+		dst += 64;
+		count -= 32;
+	}
+
+	while (count) {
+		if (src0[0] != src2[0] && src1[-1] != src1[1]) {
+			dst[0] = src1[-1] == src0[0] ? src0[0] : src1[0];
+			dst[1] = src1[1] == src0[0] ? src0[0] : src1[0];
+		} else {
+			dst[0] = src1[0];
+			dst[1] = src1[0];
+		}
+
+		++src0;
+		++src1;
+		++src2;
+		dst += 2;
+		--count;
+	}
+
+	/* last pixel */
+	if (src0[0] != src2[0] && src1[-1] != src1[0]) {
+		dst[0] = src1[-1] == src0[0] ? src0[0] : src1[0];
+		dst[1] = src1[0] == src0[0] ? src0[0] : src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+	}
+}
+
+static inline SCALE2X_TARGET_AVX2 void scale2x_16_avx2_border(scale2x_uint16* restrict dst, const scale2x_uint16* restrict src0, const scale2x_uint16* restrict src1, const scale2x_uint16* restrict src2, unsigned count)
+{
+	assert(count >= 2);
+
+	/* first pixel */
+	if (src0[0] != src2[0] && src1[0] != src1[1]) {
+		dst[0] = src1[0] == src0[0] ? src0[0] : src1[0];
+		dst[1] = src1[1] == src0[0] ? src0[0] : src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+	}
+	++src0;
+	++src1;
+	++src2;
+	dst += 2;
+	--count;
+
+	/* central pixels */
+	--count;
+	while (count >= 16) {
+		__m256i b = _mm256_loadu_si256((const __m256i*)(src0));
+		__m256i d = _mm256_loadu_si256((const __m256i*)(src1 - 1));
+		__m256i e = _mm256_loadu_si256((const __m256i*)(src1));
+		__m256i f = _mm256_loadu_si256((const __m256i*)(src1 + 1));
+		__m256i h = _mm256_loadu_si256((const __m256i*)(src2));
+		__m256i c, a0, a1;
+		__m256i lo, hi;
+
+		/* c = B != H && D != F */
+		c = _mm256_andnot_si256(_mm256_or_si256(_mm256_cmpeq_epi16(b, h), _mm256_cmpeq_epi16(d, f)), _mm256_set1_epi32(-1));
+
+		/* a0 = c && D == B ? B : E */
+		a0 = _mm256_and_si256(c, _mm256_cmpeq_epi16(d, b));
+		a0 = _mm256_or_si256(_mm256_and_si256(a0, b), _mm256_andnot_si256(a0, e));
+
+		/* a1 = c && F == B ? B : E */
+		a1 = _mm256_and_si256(c, _mm256_cmpeq_epi16(f, b));
+		a1 = _mm256_or_si256(_mm256_and_si256(a1, b), _mm256_andnot_si256(a1, e));
+
+		lo = _mm256_unpacklo_epi16(a0, a1);
+		hi = _mm256_unpackhi_epi16(a0, a1);
+		_mm256_storeu_si256((__m256i*)(dst), _mm256_permute2x128_si256(lo, hi, 0x20));
+		_mm256_storeu_si256((__m256i*)(dst + 16), _mm256_permute2x128_si256(lo, hi, 0x31));
+
+		src0 += 16;
+		src1 += 16;
+		src2 += 16;
+		dst += 32;
+		count -= 16;
+	}
+
+	while (count) {
+		if (src0[0] != src2[0] && src1[-1] != src1[1]) {
+			dst[0] = src1[-1] == src0[0] ? src0[0] : src1[0];
+			dst[1] = src1[1] == src0[0] ? src0[0] : src1[0];
+		} else {
+			dst[0] = src1[0];
+			dst[1] = src1[0];
+		}
+
+		++src0;
+		++src1;
+		++src2;
+		dst += 2;
+		--count;
+	}
+
+	/* last pixel */
+	if (src0[0] != src2[0] && src1[-1] != src1[0]) {
+		dst[0] = src1[-1] == src0[0] ? src0[0] : src1[0];
+		dst[1] = src1[0] == src0[0] ? src0[0] : src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+	}
+}
+
+static inline SCALE2X_TARGET_AVX2 void scale2x_32_avx2_border(scale2x_uint32* restrict dst, const scale2x_uint32* restrict src0, const scale2x_uint32* restrict src1, const scale2x_uint32* restrict src2, unsigned count)
+{
+	assert(count >= 2);
+
+	/* first pixel */
+	if (src0[0] != src2[0] && src1[0] != src1[1]) {
+		dst[0] = src1[0] == src0[0] ? src0[0] : src1[0];
+		dst[1] = src1[1] == src0[0] ? src0[0] : src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+	}
+	++src0;
+	++src1;
+	++src2;
+	dst += 2;
+	--count;
+
+	/* central pixels */
+	--count;
+	while (count >= 8) {
+		__m256i b = _mm256_loadu_si256((const __m256i*)(src0));
+		__m256i d = _mm256_loadu_si256((const __m256i*)(src1 - 1));
+		__m256i e = _mm256_loadu_si256((const __m256i*)(src1));
+		__m256i f = _mm256_loadu_si256((const __m256i*)(src1 + 1));
+		__m256i h = _mm256_loadu_si256((const __m256i*)(src2));
+		__m256i c, a0, a1;
+		__m256i lo, hi;
+
+		/* c = B != H && D != F */
+		c = _mm256_andnot_si256(_mm256_or_si256(_mm256_cmpeq_epi32(b, h), _mm256_cmpeq_epi32(d, f)), _mm256_set1_epi32(-1));
+
+		/* a0 = c && D == B ? B : E */
+		a0 = _mm256_and_si256(c, _mm256_cmpeq_epi32(d, b));
+		a0 = _mm256_or_si256(_mm256_and_si256(a0, b), _mm256_andnot_si256(a0, e));
+
+		/* a1 = c && F == B ? B : E */
+		a1 = _mm256_and_si256(c, _mm256_cmpeq_epi32(f, b));
+		a1 = _mm256_or_si256(_mm256_and_si256(a1, b), _mm256_andnot_si256(a1, e));
+
+		lo = _mm256_unpacklo_epi32(a0, a1);
+		hi = _mm256_unpackhi_epi32(a0, a1);
+		_mm256_storeu_si256((__m256i*)(dst), _mm256_permute2x128_si256(lo, hi, 0x20));
+		_mm256_storeu_si256((__m256i*)(dst + 8), _mm256_permute2x128_si256(lo, hi, 0x31));
+
+		src0 += 8;
+		src1 += 8;
+		src2 += 8;
+		dst += 16;
+		count -= 8;
+	}
+
+	while (count) {
+		if (src0[0] != src2[0] && src1[-1] != src1[1]) {
+			dst[0] = src1[-1] == src0[0] ? src0[0] : src1[0];
+			dst[1] = src1[1] == src0[0] ? src0[0] : src1[0];
+		} else {
+			dst[0] = src1[0];
+			dst[1] = src1[0];
+		}
+
+		++src0;
+		++src1;
+		++src2;
+		dst += 2;
+		--count;
+	}
+
+	/* last pixel */
+	if (src0[0] != src2[0] && src1[-1] != src1[0]) {
+		dst[0] = src1[-1] == src0[0] ? src0[0] : src1[0];
+		dst[1] = src1[0] == src0[0] ? src0[0] : src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+	}
+}
+
+/**
+ * Scale by a factor of 2 a row of pixels of 8 bits.
+ * This function operates like scale2x_8_def() but it uses the SSE2
+ * instruction set.
+ */
+void scale2x_8_sse2(scale2x_uint8* dst0, scale2x_uint8* dst1, const scale2x_uint8* src0, const scale2x_uint8* src1, const scale2x_uint8* src2, unsigned count)
+{
+	scale2x_8_sse2_border(dst0, src0, src1, src2, count);
+	scale2x_8_sse2_border(dst1, src2, src1, src0, count);
+}
+
+/**
+ * Scale by a factor of 2x3 a row of pixels of 8 bits.
+ * This function operates like scale2x_8_sse2() but with an expansion
+ * factor of 2x3 instead of 2x2.
+ */
+void scale2x3_8_sse2(scale2x_uint8* dst0, scale2x_uint8* dst1, scale2x_uint8* dst2, const scale2x_uint8* src0, const scale2x_uint8* src1, const scale2x_uint8* src2, unsigned count)
+{
+	scale2x_8_sse2_border(dst0, src0, src1, src2, count);
+	scale2x_8_def_center(dst1, src0, src1, src2, count);
+	scale2x_8_sse2_border(dst2, src2, src1, src0, count);
+}
+
+/**
+ * Scale by a factor of 2x4 a row of pixels of 8 bits.
+ * This function operates like scale2x_8_sse2() but with an expansion
+ * factor of 2x4 instead of 2x2.
+ */
+void scale2x4_8_sse2(scale2x_uint8* dst0, scale2x_uint8* dst1, scale2x_uint8* dst2, scale2x_uint8* dst3, const scale2x_uint8* src0, const scale2x_uint8* src1, const scale2x_uint8* src2, unsigned count)
+{
+	scale2x_8_sse2_border(dst0, src0, src1, src2, count);
+	scale2x_8_def_center(dst1, src0, src1, src2, count);
+	scale2x_8_def_center(dst2, src0, src1, src2, count);
+	scale2x_8_sse2_border(dst3, src2, src1, src0, count);
+}
+
+/**
+ * Scale by a factor of 2 a row of pixels of 16 bits.
+ * This function operates like scale2x_8_sse2() but for 16 bits pixels.
+ */
+void scale2x_16_sse2(scale2x_uint16* dst0, scale2x_uint16* dst1, const scale2x_uint16* src0, const scale2x_uint16* src1, const scale2x_uint16* src2, unsigned count)
+{
+	scale2x_16_sse2_border(dst0, src0, src1, src2, count);
+	scale2x_16_sse2_border(dst1, src2, src1, src0, count);
+}
+
+/**
+ * Scale by a factor of 2x3 a row of pixels of 16 bits.
+ * This function operates like scale2x_16_sse2() but with an expansion
+ * factor of 2x3 instead of 2x2.
+ */
+void scale2x3_16_sse2(scale2x_uint16* dst0, scale2x_uint16* dst1, scale2x_uint16* dst2, const scale2x_uint16* src0, const scale2x_uint16* src1, const scale2x_uint16* src2, unsigned count)
+{
+	scale2x_16_sse2_border(dst0, src0, src1, src2, count);
+	scale2x_16_def_center(dst1, src0, src1, src2, count);
+	scale2x_16_sse2_border(dst2, src2, src1, src0, count);
+}
+
+/**
+ * Scale by a factor of 2x4 a row of pixels of 16 bits.
+ * This function operates like scale2x_16_sse2() but with an expansion
+ * factor of 2x4 instead of 2x2.
+ */
+void scale2x4_16_sse2(scale2x_uint16* dst0, scale2x_uint16* dst1, scale2x_uint16* dst2, scale2x_uint16* dst3, const scale2x_uint16* src0, const scale2x_uint16* src1, const scale2x_uint16* src2, unsigned count)
+{
+	scale2x_16_sse2_border(dst0, src0, src1, src2, count);
+	scale2x_16_def_center(dst1, src0, src1, src2, count);
+	scale2x_16_def_center(dst2, src0, src1, src2, count);
+	scale2x_16_sse2_border(dst3, src2, src1, src0, count);
+}
+
+/**
+ * Scale by a factor of 2 a row of pixels of 32 bits.
+ * This function operates like scale2x_8_sse2() but for 32 bits pixels.
+ */
+void scale2x_32_sse2(scale2x_uint32* dst0, scale2x_uint32* dst1, const scale2x_uint32* src0, const scale2x_uint32* src1, const scale2x_uint32* src2, unsigned count)
+{
+	scale2x_32_sse2_border(dst0, src0, src1, src2, count);
+	scale2x_32_sse2_border(dst1, src2, src1, src0, count);
+}
+
+/**
+ * Scale by a factor of 2x3 a row of pixels of 32 bits.
+ * This function operates like scale2x_32_sse2() but with an expansion
+ * factor of 2x3 instead of 2x2.
+ */
+void scale2x3_32_sse2(scale2x_uint32* dst0, scale2x_uint32* dst1, scale2x_uint32* dst2, const scale2x_uint32* src0, const scale2x_uint32* src1, const scale2x_uint32* src2, unsigned count)
+{
+	scale2x_32_sse2_border(dst0, src0, src1, src2, count);
+	scale2x_32_def_center(dst1, src0, src1, src2, count);
+	scale2x_32_sse2_border(dst2, src2, src1, src0, count);
+}
+
+/**
+ * Scale by a factor of 2x4 a row of pixels of 32 bits.
+ * This function operates like scale2x_32_sse2() but with an expansion
+ * factor of 2x4 instead of 2x2.
+ */
+void scale2x4_32_sse2(scale2x_uint32* dst0, scale2x_uint32* dst1, scale2x_uint32* dst2, scale2x_uint32* dst3, const scale2x_uint32* src0, const scale2x_uint32* src1, const scale2x_uint32* src2, unsigned count)
+{
+	scale2x_32_sse2_border(dst0, src0, src1, src2, count);
+	scale2x_32_def_center(dst1, src0, src1, src2, count);
+	scale2x_32_def_center(dst2, src0, src1, src2, count);
+	scale2x_32_sse2_border(dst3, src2, src1, src0, count);
+}
+
+/**
+ * Scale by a factor of 2 a row of pixels of 8 bits.
+ * This function operates like scale2x_8_def() but it uses the AVX2
+ * instruction set. It must be called only if the processor supports it.
+ */
+SCALE2X_TARGET_AVX2 void scale2x_8_avx2(scale2x_uint8* dst0, scale2x_uint8* dst1, const scale2x_uint8* src0, const scale2x_uint8* src1, const scale2x_uint8* src2, unsigned count)
+{
+	scale2x_8_avx2_border(dst0, src0, src1, src2, count);
+	scale2x_8_avx2_border(dst1, src2, src1, src0, count);
+}
+
+/**
+ * Scale by a factor of 2x3 a row of pixels of 8 bits.
+ * This function operates like scale2x_8_avx2() but with an expansion
+ * factor of 2x3 instead of 2x2.
+ */
+SCALE2X_TARGET_AVX2 void scale2x3_8_avx2(scale2x_uint8* dst0, scale2x_uint8* dst1, scale2x_uint8* dst2, const scale2x_uint8* src0, const scale2x_uint8* src1, const scale2x_uint8* src2, unsigned count)
+{
+	scale2x_8_avx2_border(dst0, src0, src1, src2, count);
+	scale2x_8_def_center(dst1, src0, src1, src2, count);
+	scale2x_8_avx2_border(dst2, src2, src1, src0, count);
+}
+
+/**
+ * Scale by a factor of 2x4 a row of pixels of 8 bits.
+ * This function operates like scale2x_8_avx2() but with an expansion
+ * factor of 2x4 instead of 2x2.
+ */
+SCALE2X_TARGET_AVX2 void scale2x4_8_avx2(scale2x_uint8* dst0, scale2x_uint8* dst1, scale2x_uint8* dst2, scale2x_uint8* dst3, const scale2x_uint8* src0, const scale2x_uint8* src1, const scale2x_uint8* src2, unsigned count)
+{
+	scale2x_8_avx2_border(dst0, src0, src1, src2, count);
+	scale2x_8_def_center(dst1, src0, src1, src2, count);
+	scale2x_8_def_center(dst2, src0, src1, src2, count);
+	scale2x_8_avx2_border(dst3, src2, src1, src0, count);
+}
+
+/**
+ * Scale by a factor of 2 a row of pixels of 16 bits.
+ * This function operates like scale2x_8_avx2() but for 16 bits pixels.
+ */
+SCALE2X_TARGET_AVX2 void scale2x_16_avx2(scale2x_uint16* dst0, scale2x_uint16* dst1, const scale2x_uint16* src0, const scale2x_uint16* src1, const scale2x_uint16* src2, unsigned count)
+{
+	scale2x_16_avx2_border(dst0, src0, src1, src2, count);
+	scale2x_16_avx2_border(dst1, src2, src1, src0, count);
+}
+
+/**
+ * Scale by a factor of 2x3 a row of pixels of 16 bits.
+ * This function operates like scale2x_16_avx2() but with an expansion
+ * factor of 2x3 instead of 2x2.
+ */
+SCALE2X_TARGET_AVX2 void scale2x3_16_avx2(scale2x_uint16* dst0, scale2x_uint16* dst1, scale2x_uint16* dst2, const scale2x_uint16* src0, const scale2x_uint16* src1, const scale2x_uint16* src2, unsigned count)
+{
+	scale2x_16_avx2_border(dst0, src0, src1, src2, count);
+	scale2x_16_def_center(dst1, src0, src1, src2, count);
+	scale2x_16_avx2_border(dst2, src2, src1, src0, count);
+}
+
+/**
+ * Scale by a factor of 2x4 a row of pixels of 16 bits.
+ * This function operates like scale2x_16_avx2() but with an expansion
+ * factor of 2x4 instead of 2x2.
+ */
+SCALE2X_TARGET_AVX2 void scale2x4_16_avx2(scale2x_uint16* dst0, scale2x_uint16* dst1, scale2x_uint16* dst2, scale2x_uint16* dst3, const scale2x_uint16* src0, const scale2x_uint16* src1, const scale2x_uint16* src2, unsigned count)
+{
+	scale2x_16_avx2_border(dst0, src0, src1, src2, count);
+	scale2x_16_def_center(dst1, src0, src1, src2, count);
+	scale2x_16_def_center(dst2, src0, src1, src2, count);
+	scale2x_16_avx2_border(dst3, src2, src1, src0, count);
+}
+
+/**
+ * Scale by a factor of 2 a row of pixels of 32 bits.
+ * This function operates like scale2x_8_avx2() but for 32 bits pixels.
+ */
+SCALE2X_TARGET_AVX2 void scale2x_32_avx2(scale2x_uint32* dst0, scale2x_uint32* dst1, const scale2x_uint32* src0, const scale2x_uint32* src1, const scale2x_uint32* src2, unsigned count)
+{
+	scale2x_32_avx2_border(dst0, src0, src1, src2, count);
+	scale2x_32_avx2_border(dst1, src2, src1, src0, count);
+}
+
+/**
+ * Scale by a factor of 2x3 a row of pixels of 32 bits.
+ * This function operates like scale2x_32_avx2() but with an expansion
+ * factor of 2x3 instead of 2x2.
+ */
+SCALE2X_TARGET_AVX2 void scale2x3_32_avx2(scale2x_uint32* dst0, scale2x_uint32* dst1, scale2x_uint32* dst2, const scale2x_uint32* src0, const scale2x_uint32* src1, const scale2x_uint32* src2, unsigned count)
+{
+	scale2x_32_avx2_border(dst0, src0, src1, src2, count);
+	scale2x_32_def_center(dst1, src0, src1, src2, count);
+	scale2x_32_avx2_border(dst2, src2, src1, src0, count);
+}
+
+/**
+ * Scale by a factor of 2x4 a row of pixels of 32 bits.
+ * This function operates like scale2x_32_avx2() but with an expansion
+ * factor of 2x4 instead of 2x2.
+ */
+SCALE2X_TARGET_AVX2 void scale2x4_32_avx2(scale2x_uint32* dst0, scale2x_uint32* dst1, scale2x_uint32* dst2, scale2x_uint32* dst3, const scale2x_uint32* src0, const scale2x_uint32* src1, const scale2x_uint32* src2, unsigned count)
+{
+	scale2x_32_avx2_border(dst0, src0, src1, src2, count);
+	scale2x_32_def_center(dst1, src0, src1, src2, count);
+	scale2x_32_def_center(dst2, src0, src1, src2, count);
+	scale2x_32_avx2_border(dst3, src2, src1, src0, count);
+}
+
+#endif
@@ -34,6 +34,12 @@
 
 #include <assert.h>
 
+#if defined(USE_ASM_INTRINSIC)
+#include <immintrin.h>
+
+#define SCALE3K_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
 /***************************************************************************/
 /* Scale3k C implementation */
 
@@ -86,11 +92,16 @@
 #define interp_17(A, B) interp_16_71(B, A)
 #define interp_11(A, B) interp_16_11(A, B)
 
-void scale3k_16_def(interp_uint16* restrict dst0, interp_uint16* restrict dst1, interp_uint16* restrict dst2, const interp_uint16* restrict src0, const interp_uint16* restrict src1, const interp_uint16* restrict src2, unsigned count)
+static inline void scale3k_16_def_range(interp_uint16* restrict dst0, interp_uint16* restrict dst1, interp_uint16* restrict dst2, const interp_uint16* restrict src0, const interp_uint16* restrict src1, const interp_uint16* restrict src2, unsigned i, unsigned end, unsigned count)
 {
-	unsigned i;
-
-	for (i = 0; i < count; ++i) {
+	src0 += i;
+	src1 += i;
+	src2 += i;
+	dst0 += 3 * i;
+	dst1 += 3 * i;
+	dst2 += 3 * i;
+
+	for (; i < end; ++i) {
 		interp_uint16 c[9];
 		interp_uint16 e[9];
 
@@ -152,6 +163,11 @@ void scale3k_16_def(interp_uint16* restrict dst0, interp_uint16* restrict dst1,
 	}
 }
 
+void scale3k_16_def(interp_uint16* restrict dst0, interp_uint16* restrict dst1, interp_uint16* restrict dst2, const interp_uint16* restrict src0, const interp_uint16* restrict src1, const interp_uint16* restrict src2, unsigned count)
+{
+	scale3k_16_def_range(dst0, dst1, dst2, src0, src1, src2, 0, count, count);
+}
+
 #undef interp_31
 #undef interp_13
 #undef interp_71
@@ -164,11 +180,16 @@ void scale3k_16_def(interp_uint16* restrict dst0, interp_uint16* restrict dst1,
 #define interp_17(A, B) interp_32_71(B, A)
 #define interp_11(A, B) interp_32_11(A, B)
 
-void scale3k_32_def(interp_uint32* restrict dst0, interp_uint32* restrict dst1, interp_uint32* restrict dst2, const interp_uint32* restrict src0, const interp_uint32* restrict src1, const interp_uint32* restrict src2, unsigned count)
+static inline void scale3k_32_def_range(interp_uint32* restrict dst0, interp_uint32* restrict dst1, interp_uint32* restrict dst2, const interp_uint32* restrict src0, const interp_uint32* restrict src1, const interp_uint32* restrict src2, unsigned i, unsigned end, unsigned count)
 {
-	unsigned i;
-
-	for (i = 0; i < count; ++i) {
+	src0 += i;
+	src1 += i;
+	src2 += i;
+	dst0 += 3 * i;
+	dst1 += 3 * i;
+	dst2 += 3 * i;
+
+	for (; i < end; ++i) {
 		interp_uint32 c[9];
 		interp_uint32 e[9];
 
@@ -230,6 +251,11 @@ void scale3k_32_def(interp_uint32* restrict dst0, interp_uint32* restrict dst1,
 	}
 }
 
+void scale3k_32_def(interp_uint32* restrict dst0, interp_uint32* restrict dst1, interp_uint32* restrict dst2, const interp_uint32* restrict src0, const interp_uint32* restrict src1, const interp_uint32* restrict src2, unsigned count)
+{
+	scale3k_32_def_range(dst0, dst1, dst2, src0, src1, src2, 0, count, count);
+}
+
 #undef interp_31
 #undef interp_13
 #undef interp_71
@@ -242,11 +268,16 @@ void scale3k_32_def(interp_uint32* restrict dst0, interp_uint32* restrict dst1,
 #define interp_17(A, B) interp_yuy2_71(B, A)
 #define interp_11(A, B) interp_yuy2_11(A, B)
 
-void scale3k_yuy2_def(interp_uint32* restrict dst0, interp_uint32* restrict dst1, interp_uint32* restrict dst2, const interp_uint32* restrict src0, const interp_uint32* restrict src1, const interp_uint32* restrict src2, unsigned count)
+static inline void scale3k_yuy2_def_range(interp_uint32* restrict dst0, interp_uint32* restrict dst1, interp_uint32* restrict dst2, const interp_uint32* restrict src0, const interp_uint32* restrict src1, const interp_uint32* restrict src2, unsigned i, unsigned end, unsigned count)
 {
-	unsigned i;
-
-	for (i = 0; i < count; ++i) {
+	src0 += i;
+	src1 += i;
+	src2 += i;
+	dst0 += 3 * i;
+	dst1 += 3 * i;
+	dst2 += 3 * i;
+
+	for (; i < end; ++i) {
 		interp_uint32 c[9];
 		interp_uint32 e[9];
 
@@ -308,3 +339,372 @@ void scale3k_yuy2_def(interp_uint32* restrict dst0, interp_uint32* restrict dst1
 	}
 }
 
+void scale3k_yuy2_def(interp_uint32* restrict dst0, interp_uint32* restrict dst1, interp_uint32* restrict dst2, const interp_uint32* restrict src0, const interp_uint32* restrict src1, const interp_uint32* restrict src2, unsigned count)
+{
+	scale3k_yuy2_def_range(dst0, dst1, dst2, src0, src1, src2, 0, count, count);
+}
+
+/***************************************************************************/
+/* Scale3k SSE2/AVX2 intrinsic implementation */
+
+#if defined(USE_ASM_INTRINSIC)
+
+/*
+ * The vector versions check a whole vector of pixels at a time. If for all
+ * of them none of the four diagonals D == B, H == D, F == H and B == F
+ * is active, the pixels are simply replicated. Otherwise, and for the
+ * first and last pixels, the C implementation is used.
+ * This is the common case with the sharp edges of the game graphics.
+ */
+
+/*
+ * Triplicate the 16 bits pixels of a vector.
+ */
+static inline void scale3k_triple16(__m128i* t, __m128i x)
+{
+	__m128i y;
+
+	/* x0 x0 x0 x1 x1 x1 x2 x2 */
+	y = _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 1, 0));
+	t[0] = _mm_shufflehi_epi16(_mm_shufflelo_epi16(y, _MM_SHUFFLE(1, 0, 0, 0)), _MM_SHUFFLE(2, 2, 1, 1));
+
+	/* x2 x3 x3 x3 x4 x4 x4 x5 */
+	y = _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 2, 1, 1));
+	t[1] = _mm_shufflehi_epi16(_mm_shufflelo_epi16(y, _MM_SHUFFLE(1, 1, 1, 0)), _MM_SHUFFLE(1, 0, 0, 0));
+
+	/* x5 x5 x6 x6 x6 x7 x7 x7 */
+	y = _mm_shuffle_epi32(x, _MM_SHUFFLE(3, 3, 3, 2));
+	t[2] = _mm_shufflehi_epi16(_mm_shufflelo_epi16(y, _MM_SHUFFLE(2, 2, 1, 1)), _MM_SHUFFLE(1, 1, 1, 0));
+}
+
+/**
+ * Scale by a factor of 3 a row of pixels with the Scale3k effect.
+ * This function operates like scale3k_16_def() but it uses the SSE2
+ * instruction set.
+ */
+void scale3k_16_sse2(interp_uint16* dst0, interp_uint16* dst1, interp_uint16* dst2, const interp_uint16* src0, const interp_uint16* src1, const interp_uint16* src2, unsigned count)
+{
+	unsigned i = 0;
+
+	if (count > 8 + 1) {
+		/* first pixel */
+		scale3k_16_def_range(dst0, dst1, dst2, src0, src1, src2, 0, 1, count);
+
+		/* central pixels */
+		for (i = 1; i + 8 < count; i += 8) {
+			__m128i b, d, e, f, h;
+			__m128i m;
+			__m128i o[3];
+
+			b = _mm_loadu_si128((const __m128i*)(src0 + i));
+			d = _mm_loadu_si128((const __m128i*)(src1 + i - 1));
+			e = _mm_loadu_si128((const __m128i*)(src1 + i));
+			f = _mm_loadu_si128((const __m128i*)(src1 + i + 1));
+			h = _mm_loadu_si128((const __m128i*)(src2 + i));
+
+			/* m = (D == B && B != E) || (H == D && D != E) || (F == H && H != E) || (B == F && F != E) */
+			m = _mm_or_si128(_mm_andnot_si128(_mm_cmpeq_epi16(b, e), _mm_cmpeq_epi16(d, b)), _mm_andnot_si128(_mm_cmpeq_epi16(d, e), _mm_cmpeq_epi16(h, d)));
+			m = _mm_or_si128(m, _mm_or_si128(_mm_andnot_si128(_mm_cmpeq_epi16(h, e), _mm_cmpeq_epi16(f, h)), _mm_andnot_si128(_mm_cmpeq_epi16(f, e), _mm_cmpeq_epi16(b, f))));
+
+			if (_mm_movemask_epi8(m) != 0) {
+				scale3k_16_def_range(dst0, dst1, dst2, src0, src1, src2, i, i + 8, count);
+				continue;
+			}
+
+			/* all the pixels are copied */
+			scale3k_triple16(o, e);
+			_mm_storeu_si128((__m128i*)(dst0 + 3 * i + 0), o[0]);
+			_mm_storeu_si128((__m128i*)(dst0 + 3 * i + 8), o[1]);
+			_mm_storeu_si128((__m128i*)(dst0 + 3 * i + 16), o[2]);
+			_mm_storeu_si128((__m128i*)(dst1 + 3 * i + 0), o[0]);
+			_mm_storeu_si128((__m128i*)(dst1 + 3 * i + 8), o[1]);
+			_mm_storeu_si128((__m128i*)(dst1 + 3 * i + 16), o[2]);
+			_mm_storeu_si128((__m128i*)(dst2 + 3 * i + 0), o[0]);
+			_mm_storeu_si128((__m128i*)(dst2 + 3 * i + 8), o[1]);
+			_mm_storeu_si128((__m128i*)(dst2 + 3 * i + 16), o[2]);
+		}
+	}
+
+	/* remaining pixels */
+	scale3k_16_def_range(dst0, dst1, dst2, src0, src1, src2, i, count, count);
+}
+
+/**
+ * Scale by a factor of 3 a row of pixels with the Scale3k effect.
+ * This function operates like scale3k_32_def() but it uses the SSE2
+ * instruction set.
+ */
+void scale3k_32_sse2(interp_uint32* dst0, interp_uint32* dst1, interp_uint32* dst2, const interp_uint32* src0, const interp_uint32* src1, const interp_uint32* src2, unsigned count)
+{
+	unsigned i = 0;
+
+	if (count > 4 + 1) {
+		/* first pixel */
+		scale3k_32_def_range(dst0, dst1, dst2, src0, src1, src2, 0, 1, count);
+
+		/* central pixels */
+		for (i = 1; i + 4 < count; i += 4) {
+			__m128i b, d, e, f, h;
+			__m128i m;
+			__m128i o[3];
+
+			b = _mm_loadu_si128((const __m128i*)(src0 + i));
+			d = _mm_loadu_si128((const __m128i*)(src1 + i - 1));
+			e = _mm_loadu_si128((const __m128i*)(src1 + i));
+			f = _mm_loadu_si128((const __m128i*)(src1 + i + 1));
+			h = _mm_loadu_si128((const __m128i*)(src2 + i));
+
+			/* m = (D == B && B != E) || (H == D && D != E) || (F == H && H != E) || (B == F && F != E) */
+			m = _mm_or_si128(_mm_andnot_si128(_mm_cmpeq_epi32(b, e), _mm_cmpeq_epi32(d, b)), _mm_andnot_si128(_mm_cmpeq_epi32(d, e), _mm_cmpeq_epi32(h, d)));
+			m = _mm_or_si128(m, _mm_or_si128(_mm_andnot_si128(_mm_cmpeq_epi32(h, e), _mm_cmpeq_epi32(f, h)), _mm_andnot_si128(_mm_cmpeq_epi32(f, e), _mm_cmpeq_epi32(b, f))));
+
+			if (_mm_movemask_epi8(m) != 0) {
+				scale3k_32_def_range(dst0, dst1, dst2, src0, src1, src2, i, i + 4, count);
+				continue;
+			}
+
+			/* all the pixels are copied */
+			o[0] = _mm_shuffle_epi32(e, _MM_SHUFFLE(1, 0, 0, 0));
+			o[1] = _mm_shuffle_epi32(e, _MM_SHUFFLE(2, 2, 1, 1));
+			o[2] = _mm_shuffle_epi32(e, _MM_SHUFFLE(3, 3, 3, 2));
+			_mm_storeu_si128((__m128i*)(dst0 + 3 * i + 0), o[0]);
+			_mm_storeu_si128((__m128i*)(dst0 + 3 * i + 4), o[1]);
+			_mm_storeu_si128((__m128i*)(dst0 + 3 * i + 8), o[2]);
+			_mm_storeu_si128((__m128i*)(dst1 + 3 * i + 0), o[0]);
+			_mm_storeu_si128((__m128i*)(dst1 + 3 * i + 4), o[1]);
+			_mm_storeu_si128((__m128i*)(dst1 + 3 * i + 8), o[2]);
+			_mm_storeu_si128((__m128i*)(dst2 + 3 * i + 0), o[0]);
+			_mm_storeu_si128((__m128i*)(dst2 + 3 * i + 4), o[1]);
+			_mm_storeu_si128((__m128i*)(dst2 + 3 * i + 8), o[2]);
+		}
+	}
+
+	/* remaining pixels */
+	scale3k_32_def_range(dst0, dst1, dst2, src0, src1, src2, i, count, count);
+}
+
+/**
+ * Scale by a factor of 3 a row of pixels with the Scale3k effect.
+ * This function operates like scale3k_yuy2_def() but it uses the SSE2
+ * instruction set.
+ */
+void scale3k_yuy2_sse2(interp_uint32* dst0, interp_uint32* dst1, interp_uint32* dst2, const interp_uint32* src0, const interp_uint32* src1, const interp_uint32* src2, unsigned count)
+{
+	unsigned i = 0;
+
+	if (count > 4 + 1) {
+		/* first pixel */
+		scale3k_yuy2_def_range(dst0, dst1, dst2, src0, src1, src2, 0, 1, count);
+
+		/* central pixels */
+		for (i = 1; i + 4 < count; i += 4) {
+			__m128i b, d, e, f, h;
+			__m128i m;
+			__m128i o[3];
+
+			b = _mm_loadu_si128((const __m128i*)(src0 + i));
+			d = _mm_loadu_si128((const __m128i*)(src1 + i - 1));
+			e = _mm_loadu_si128((const __m128i*)(src1 + i));
+			f = _mm_loadu_si128((const __m128i*)(src1 + i + 1));
+			h = _mm_loadu_si128((const __m128i*)(src2 + i));
+
+			/* m = (D == B && B != E) || (H == D && D != E) || (F == H && H != E) || (B == F && F != E) */
+			m = _mm_or_si128(_mm_andnot_si128(_mm_cmpeq_epi32(b, e), _mm_cmpeq_epi32(d, b)), _mm_andnot_si128(_mm_cmpeq_epi32(d, e), _mm_cmpeq_epi32(h, d)));
+			m = _mm_or_si128(m, _mm_or_si128(_mm_andnot_si128(_mm_cmpeq_epi32(h, e), _mm_cmpeq_epi32(f, h)), _mm_andnot_si128(_mm_cmpeq_epi32(f, e), _mm_cmpeq_epi32(b, f))));
+
+			if (_mm_movemask_epi8(m) != 0) {
+				scale3k_yuy2_def_range(dst0, dst1, dst2, src0, src1, src2, i, i + 4, count);
+				continue;
+			}
+
+			/* all the pixels are copied */
+			o[0] = _mm_shuffle_epi32(e, _MM_SHUFFLE(1, 0, 0, 0));
+			o[1] = _mm_shuffle_epi32(e, _MM_SHUFFLE(2, 2, 1, 1));
+			o[2] = _mm_shuffle_epi32(e, _MM_SHUFFLE(3, 3, 3, 2));
+			_mm_storeu_si128((__m128i*)(dst0 + 3 * i + 0), o[0]);
+			_mm_storeu_si128((__m128i*)(dst0 + 3 * i + 4), o[1]);
+			_mm_storeu_si128((__m128i*)(dst0 + 3 * i + 8), o[2]);
+			_mm_storeu_si128((__m128i*)(dst1 + 3 * i + 0), o[0]);
+			_mm_storeu_si128((__m128i*)(dst1 + 3 * i + 4), o[1]);
+			_mm_storeu_si128((__m128i*)(dst1 + 3 * i + 8), o[2]);
+			_mm_storeu_si128((__m128i*)(dst2 + 3 * i + 0), o[0]);
+			_mm_storeu_si128((__m128i*)(dst2 + 3 * i + 4), o[1]);
+			_mm_storeu_si128((__m128i*)(dst2 + 3 * i + 8), o[2]);
+		}
+	}
+
+	/* remaining pixels */
+	scale3k_yuy2_def_range(dst0, dst1, dst2, src0, src1, src2, i, count, count);
+}
+
+/**
+ * Scale by a factor of 3 a row of pixels with the Scale3k effect.
+ * This function operates like scale3k_16_def() but it uses the AVX2
+ * instruction set. It must be called only if the processor supports it.
+ */
+SCALE3K_TARGET_AVX2 void scale3k_16_avx2(interp_uint16* dst0, interp_uint16* dst1, interp_uint16* dst2, const interp_uint16* src0, const interp_uint16* src1, const interp_uint16* src2, unsigned count)
+{
+	unsigned i = 0;
+
+	if (count > 16 + 1) {
+		/* first pixel */
+		scale3k_16_def_range(dst0, dst1, dst2, src0, src1, src2, 0, 1, count);
+
+		/* central pixels */
+		for (i = 1; i + 16 < count; i += 16) {
+			__m256i b, d, e, f, h;
+			__m256i m;
+			__m128i t3[6];
+
+			b = _mm256_loadu_si256((const __m256i*)(src0 + i));
+			d = _mm256_loadu_si256((const __m256i*)(src1 + i - 1));
+			e = _mm256_loadu_si256((const __m256i*)(src1 + i));
+			f = _mm256_loadu_si256((const __m256i*)(src1 + i + 1));
+			h = _mm256_loadu_si256((const __m256i*)(src2 + i));
+
+			/* m = (D == B && B != E) || (H == D && D != E) || (F == H && H != E) || (B == F && F != E) */
+			m = _mm256_or_si256(_mm256_andnot_si256(_mm256_cmpeq_epi16(b, e), _mm256_cmpeq_epi16(d, b)), _mm256_andnot_si256(_mm256_cmpeq_epi16(d, e), _mm256_cmpeq_epi16(h, d)));
+			m = _mm256_or_si256(m, _mm256_or_si256(_mm256_andnot_si256(_mm256_cmpeq_epi16(h, e), _mm256_cmpeq_epi16(f, h)), _mm256_andnot_si256(_mm256_cmpeq_epi16(f, e), _mm256_cmpeq_epi16(b, f))));
+
+			if (_mm256_movemask_epi8(m) != 0) {
+				scale3k_16_def_range(dst0, dst1, dst2, src0, src1, src2, i, i + 16, count);
+				continue;
+			}
+
+			/* all the pixels are copied */
+			scale3k_triple16(t3, _mm256_castsi256_si128(e));
+			scale3k_triple16(t3 + 3, _mm256_extracti128_si256(e, 1));
+			_mm_storeu_si128((__m128i*)(dst0 + 3 * i + 0), t3[0]);
+			_mm_storeu_si128((__m128i*)(dst0 + 3 * i + 8), t3[1]);
+			_mm_storeu_si128((__m128i*)(dst0 + 3 * i + 16), t3[2]);
+			_mm_storeu_si128((__m128i*)(dst0 + 3 * i + 24), t3[3]);
+			_mm_storeu_si128((__m128i*)(dst0 + 3 * i + 32), t3[4]);
+			_mm_storeu_si128((__m128i*)(dst0 + 3 * i + 40), t3[5]);
+			_mm_storeu_si128((__m128i*)(dst1 + 3 * i + 0), t3[0]);
+			_mm_storeu_si128((__m128i*)(dst1 + 3 * i + 8), t3[1]);
+			_mm_storeu_si128((__m128i*)(dst1 + 3 * i + 16), t3[2]);
+			_mm_storeu_si128((__m128i*)(dst1 + 3 * i + 24), t3[3]);
+			_mm_storeu_si128((__m128i*)(dst1 + 3 * i + 32), t3[4]);
+			_mm_storeu_si128((__m128i*)(dst1 + 3 * i + 40), t3[5]);
+			_mm_storeu_si128((__m128i*)(dst2 + 3 * i + 0), t3[0]);
+			_mm_storeu_si128((__m128i*)(dst2 + 3 * i + 8), t3[1]);
+			_mm_storeu_si128((__m128i*)(dst2 + 3 * i + 16), t3[2]);
+			_mm_storeu_si128((__m128i*)(dst2 + 3 * i + 24), t3[3]);
+			_mm_storeu_si128((__m128i*)(dst2 + 3 * i + 32), t3[4]);
+			_mm_storeu_si128((__m128i*)(dst2 + 3 * i + 40), t3[5]);
+		}
+	}
+
+	/* remaining pixels */
+	scale3k_16_def_range(dst0, dst1, dst2, src0, src1, src2, i, count, count);
+}
+
+/**
+ * Scale by a factor of 3 a row of pixels with the Scale3k effect.
+ * This function operates like scale3k_32_def() but it uses the AVX2
+ * instruction set. It must be called only if the processor supports it.
+ */
+SCALE3K_TARGET_AVX2 void scale3k_32_avx2(interp_uint32* dst0, interp_uint32* dst1, interp_uint32* dst2, const interp_uint32* src0, const interp_uint32* src1, const interp_uint32* src2, unsigned count)
+{
+	unsigned i = 0;
+
+	if (count > 8 + 1) {
+		/* first pixel */
+		scale3k_32_def_range(dst0, dst1, dst2, src0, src1, src2, 0, 1, count);
+
+		/* central pixels */
+		for (i = 1; i + 8 < count; i += 8) {
+			__m256i b, d, e, f, h;
+			__m256i m;
+			__m256i o[3];
+
+			b = _mm256_loadu_si256((const __m256i*)(src0 + i));
+			d = _mm256_loadu_si256((const __m256i*)(src1 + i - 1));
+			e = _mm256_loadu_si256((const __m256i*)(src1 + i));
+			f = _mm256_loadu_si256((const __m256i*)(src1 + i + 1));
+			h = _mm256_loadu_si256((const __m256i*)(src2 + i));
+
+			/* m = (D == B && B != E) || (H == D && D != E) || (F == H && H != E) || (B == F && F != E) */
+			m = _mm256_or_si256(_mm256_andnot_si256(_mm256_cmpeq_epi32(b, e), _mm256_cmpeq_epi32(d, b)), _mm256_andnot_si256(_mm256_cmpeq_epi32(d, e), _mm256_cmpeq_epi32(h, d)));
+			m = _mm256_or_si256(m, _mm256_or_si256(_mm256_andnot_si256(_mm256_cmpeq_epi32(h, e), _mm256_cmpeq_epi32(f, h)), _mm256_andnot_si256(_mm256_cmpeq_epi32(f, e), _mm256_cmpeq_epi32(b, f))));
+
+			if (_mm256_movemask_epi8(m) != 0) {
+				scale3k_32_def_range(dst0, dst1, dst2, src0, src1, src2, i, i + 8, count);
+				continue;
+			}
+
+			/* all the pixels are copied */
+			o[0] = _mm256_permutevar8x32_epi32(e, _mm256_setr_epi32(0, 0, 0, 1, 1, 1, 2, 2));
+			o[1] = _mm256_permutevar8x32_epi32(e, _mm256_setr_epi32(2, 3, 3, 3, 4, 4, 4, 5));
+			o[2] = _mm256_permutevar8x32_epi32(e, _mm256_setr_epi32(5, 5, 6, 6, 6, 7, 7, 7));
+			_mm256_storeu_si256((__m256i*)(dst0 + 3 * i + 0), o[0]);
+			_mm256_storeu_si256((__m256i*)(dst0 + 3 * i + 8), o[1]);
+			_mm256_storeu_si256((__m256i*)(dst0 + 3 * i + 16), o[2]);
+			_mm256_storeu_si256((__m256i*)(dst1 + 3 * i + 0), o[0]);
+			_mm256_storeu_si256((__m256i*)(dst1 + 3 * i + 8), o[1]);
+			_mm256_storeu_si256((__m256i*)(dst1 + 3 * i + 16), o[2]);
+			_mm256_storeu_si256((__m256i*)(dst2 + 3 * i + 0), o[0]);
+			_mm256_storeu_si256((__m256i*)(dst2 + 3 * i + 8), o[1]);
+			_mm256_storeu_si256((__m256i*)(dst2 + 3 * i + 16), o[2]);
+		}
+	}
+
+	/* remaining pixels */
+	scale3k_32_def_range(dst0, dst1, dst2, src0, src1, src2, i, count, count);
+}
+
+/**
+ * Scale by a factor of 3 a row of pixels with the Scale3k effect.
+ * This function operates like scale3k_yuy2_def() but it uses the AVX2
+ * instruction set. It must be called only if the processor supports it.
+ */
+SCALE3K_TARGET_AVX2 void scale3k_yuy2_avx2(interp_uint32* dst0, interp_uint32* dst1, interp_uint32* dst2, const interp_uint32* src0, const interp_uint32* src1, const interp_uint32* src2, unsigned count)
+{
+	unsigned i = 0;
+
+	if (count > 8 + 1) {
+		/* first pixel */
+		scale3k_yuy2_def_range(dst0, dst1, dst2, src0, src1, src2, 0, 1, count);
+
+		/* central pixels */
+		for (i = 1; i + 8 < count; i += 8) {
+			__m256i b, d, e, f, h;
+			__m256i m;
+			__m256i o[3];
+
+			b = _mm256_loadu_si256((const __m256i*)(src0 + i));
+			d = _mm256_loadu_si256((const __m256i*)(src1 + i - 1));
+			e = _mm256_loadu_si256((const __m256i*)(src1 + i));
+			f = _mm256_loadu_si256((const __m256i*)(src1 + i + 1));
+			h = _mm256_loadu_si256((const __m256i*)(src2 + i));
+
+			/* m = (D == B && B != E) || (H == D && D != E) || (F == H && H != E) || (B == F && F != E) */
+			m = _mm256_or_si256(_mm256_andnot_si256(_mm256_cmpeq_epi32(b, e), _mm256_cmpeq_epi32(d, b)), _mm256_andnot_si256(_mm256_cmpeq_epi32(d, e), _mm256_cmpeq_epi32(h, d)));
+			m = _mm256_or_si256(m, _mm256_or_si256(_mm256_andnot_si256(_mm256_cmpeq_epi32(h, e), _mm256_cmpeq_epi32(f, h)), _mm256_andnot_si256(_mm256_cmpeq_epi32(f, e), _mm256_cmpeq_epi32(b, f))));
+
+			if (_mm256_movemask_epi8(m) != 0) {
+				scale3k_yuy2_def_range(dst0, dst1, dst2, src0, src1, src2, i, i + 8, count);
+				continue;
+			}
+
+			/* all the pixels are copied */
+			o[0] = _mm256_permutevar8x32_epi32(e, _mm256_setr_epi32(0, 0, 0, 1, 1, 1, 2, 2));
+			o[1] = _mm256_permutevar8x32_epi32(e, _mm256_setr_epi32(2, 3, 3, 3, 4, 4, 4, 5));
+			o[2] = _mm256_permutevar8x32_epi32(e, _mm256_setr_epi32(5, 5, 6, 6, 6, 7, 7, 7));
+			_mm256_storeu_si256((__m256i*)(dst0 + 3 * i + 0), o[0]);
+			_mm256_storeu_si256((__m256i*)(dst0 + 3 * i + 8), o[1]);
+			_mm256_storeu_si256((__m256i*)(dst0 + 3 * i + 16), o[2]);
+			_mm256_storeu_si256((__m256i*)(dst1 + 3 * i + 0), o[0]);
+			_mm256_storeu_si256((__m256i*)(dst1 + 3 * i + 8), o[1]);
+			_mm256_storeu_si256((__m256i*)(dst1 + 3 * i + 16), o[2]);
+			_mm256_storeu_si256((__m256i*)(dst2 + 3 * i + 0), o[0]);
+			_mm256_storeu_si256((__m256i*)(dst2 + 3 * i + 8), o[1]);
+			_mm256_storeu_si256((__m256i*)(dst2 + 3 * i + 16), o[2]);
+		}
+	}
+
+	/* remaining pixels */
+	scale3k_yuy2_def_range(dst0, dst1, dst2, src0, src1, src2, i, count, count);
+}
+
+#endif
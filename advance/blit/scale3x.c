@@ -38,6 +38,12 @@
 
 #include <assert.h>
 
+#if defined(USE_ASM_INTRINSIC)
+#include <immintrin.h>
+
+#define SCALE3X_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
 /***************************************************************************/
 /* Scale3x C implementation */
 
@@ -709,3 +715,1312 @@ void scale3x_32_def(scale3x_uint32* dst0, scale3x_uint32* dst1, scale3x_uint32*
 #endif
 }
 
+/***************************************************************************/
+/* Scale3x SSE2/AVX2 intrinsic implementation */
+
+#if defined(USE_ASM_INTRINSIC)
+
+/*
+ * Store the three vectors r0, r1, r2 interleaving their pixels,
+ * r0[0], r1[0], r2[0], r0[1], r1[1], r2[1], ...
+ */
+static inline void scale3x_32_sse2_store(scale3x_uint32* dst, __m128i r0, __m128i r1, __m128i r2)
+{
+	__m128 ab_lo = _mm_castsi128_ps(_mm_unpacklo_epi32(r0, r1)); /* a0 b0 a1 b1 */
+	__m128 ab_hi = _mm_castsi128_ps(_mm_unpackhi_epi32(r0, r1)); /* a2 b2 a3 b3 */
+	__m128 bc_lo = _mm_castsi128_ps(_mm_unpacklo_epi32(r1, r2)); /* b0 c0 b1 c1 */
+	__m128 ca_lo = _mm_castsi128_ps(_mm_unpacklo_epi32(r2, r0)); /* c0 a0 c1 a1 */
+	__m128 ca_hi = _mm_castsi128_ps(_mm_unpackhi_epi32(r2, r0)); /* c2 a2 c3 a3 */
+	__m128 bc_hi = _mm_castsi128_ps(_mm_unpackhi_epi32(r1, r2)); /* b2 c2 b3 c3 */
+
+	_mm_storeu_si128((__m128i*)(dst), _mm_castps_si128(_mm_shuffle_ps(ab_lo, ca_lo, _MM_SHUFFLE(3, 0, 1, 0)))); /* a0 b0 c0 a1 */
+	_mm_storeu_si128((__m128i*)(dst + 4), _mm_castps_si128(_mm_shuffle_ps(bc_lo, ab_hi, _MM_SHUFFLE(1, 0, 3, 2)))); /* b1 c1 a2 b2 */
+	_mm_storeu_si128((__m128i*)(dst + 8), _mm_castps_si128(_mm_shuffle_ps(ca_hi, bc_hi, _MM_SHUFFLE(3, 2, 3, 0)))); /* c2 a3 b3 c3 */
+}
+
+/*
+ * Triplicate the 16 bits pixels of a vector.
+ */
+static inline void scale3x_16_sse2_triple(__m128i* t, __m128i x)
+{
+	__m128i y;
+
+	/* x0 x0 x0 x1 x1 x1 x2 x2 */
+	y = _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 1, 0));
+	t[0] = _mm_shufflehi_epi16(_mm_shufflelo_epi16(y, _MM_SHUFFLE(1, 0, 0, 0)), _MM_SHUFFLE(2, 2, 1, 1));
+
+	/* x2 x3 x3 x3 x4 x4 x4 x5 */
+	y = _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 2, 1, 1));
+	t[1] = _mm_shufflehi_epi16(_mm_shufflelo_epi16(y, _MM_SHUFFLE(1, 1, 1, 0)), _MM_SHUFFLE(1, 0, 0, 0));
+
+	/* x5 x5 x6 x6 x6 x7 x7 x7 */
+	y = _mm_shuffle_epi32(x, _MM_SHUFFLE(3, 3, 3, 2));
+	t[2] = _mm_shufflehi_epi16(_mm_shufflelo_epi16(y, _MM_SHUFFLE(2, 2, 1, 1)), _MM_SHUFFLE(1, 1, 1, 0));
+}
+
+/*
+ * Interleave the 16 bits pixels of three vectors.
+ * SSE2 doesn't have a byte shuffle, so the vectors are triplicated
+ * and then merged with masks.
+ */
+static inline void scale3x_16_sse2_interleave(__m128i* o, __m128i r0, __m128i r1, __m128i r2)
+{
+	__m128i t0[3];
+	__m128i t1[3];
+	__m128i t2[3];
+	__m128i m0, m1;
+
+	scale3x_16_sse2_triple(t0, r0);
+	scale3x_16_sse2_triple(t1, r1);
+	scale3x_16_sse2_triple(t2, r2);
+
+	m0 = _mm_setr_epi16(-1, 0, 0, -1, 0, 0, -1, 0);
+	m1 = _mm_setr_epi16(0, -1, 0, 0, -1, 0, 0, -1);
+	o[0] = _mm_or_si128(_mm_or_si128(_mm_and_si128(m0, t0[0]), _mm_and_si128(m1, t1[0])), _mm_andnot_si128(_mm_or_si128(m0, m1), t2[0]));
+
+	m0 = _mm_setr_epi16(0, -1, 0, 0, -1, 0, 0, -1);
+	m1 = _mm_setr_epi16(0, 0, -1, 0, 0, -1, 0, 0);
+	o[1] = _mm_or_si128(_mm_or_si128(_mm_and_si128(m0, t0[1]), _mm_and_si128(m1, t1[1])), _mm_andnot_si128(_mm_or_si128(m0, m1), t2[1]));
+
+	m0 = _mm_setr_epi16(0, 0, -1, 0, 0, -1, 0, 0);
+	m1 = _mm_setr_epi16(-1, 0, 0, -1, 0, 0, -1, 0);
+	o[2] = _mm_or_si128(_mm_or_si128(_mm_and_si128(m0, t0[2]), _mm_and_si128(m1, t1[2])), _mm_andnot_si128(_mm_or_si128(m0, m1), t2[2]));
+}
+
+static inline void scale3x_16_sse2_store(scale3x_uint16* dst, __m128i r0, __m128i r1, __m128i r2)
+{
+	__m128i o[3];
+
+	scale3x_16_sse2_interleave(o, r0, r1, r2);
+
+	_mm_storeu_si128((__m128i*)(dst), o[0]);
+	_mm_storeu_si128((__m128i*)(dst + 8), o[1]);
+	_mm_storeu_si128((__m128i*)(dst + 16), o[2]);
+}
+
+/*
+ * The 8 bits pixels are expanded at 16 bits, interleaved, and packed again.
+ */
+static inline void scale3x_8_sse2_store(scale3x_uint8* dst, __m128i r0, __m128i r1, __m128i r2)
+{
+	__m128i z = _mm_setzero_si128();
+	__m128i lo[3];
+	__m128i hi[3];
+
+	scale3x_16_sse2_interleave(lo, _mm_unpacklo_epi8(r0, z), _mm_unpacklo_epi8(r1, z), _mm_unpacklo_epi8(r2, z));
+	scale3x_16_sse2_interleave(hi, _mm_unpackhi_epi8(r0, z), _mm_unpackhi_epi8(r1, z), _mm_unpackhi_epi8(r2, z));
+
+	_mm_storeu_si128((__m128i*)(dst), _mm_packus_epi16(lo[0], lo[1]));
+	_mm_storeu_si128((__m128i*)(dst + 16), _mm_packus_epi16(lo[2], hi[0]));
+	_mm_storeu_si128((__m128i*)(dst + 32), _mm_packus_epi16(hi[1], hi[2]));
+}
+
+static inline SCALE3X_TARGET_AVX2 void scale3x_32_avx2_store(scale3x_uint32* dst, __m256i r0, __m256i r1, __m256i r2)
+{
+	__m256i i;
+	__m256i o;
+
+	i = _mm256_setr_epi32(0, 0, 0, 1, 1, 1, 2, 2);
+	o = _mm256_blend_epi32(_mm256_permutevar8x32_epi32(r0, i), _mm256_permutevar8x32_epi32(r1, i), 0x92);
+	o = _mm256_blend_epi32(o, _mm256_permutevar8x32_epi32(r2, i), 0x24);
+	_mm256_storeu_si256((__m256i*)(dst + 0), o);
+
+	i = _mm256_setr_epi32(2, 3, 3, 3, 4, 4, 4, 5);
+	o = _mm256_blend_epi32(_mm256_permutevar8x32_epi32(r0, i), _mm256_permutevar8x32_epi32(r1, i), 0x24);
+	o = _mm256_blend_epi32(o, _mm256_permutevar8x32_epi32(r2, i), 0x49);
+	_mm256_storeu_si256((__m256i*)(dst + 8), o);
+
+	i = _mm256_setr_epi32(5, 5, 6, 6, 6, 7, 7, 7);
+	o = _mm256_blend_epi32(_mm256_permutevar8x32_epi32(r0, i), _mm256_permutevar8x32_epi32(r1, i), 0x49);
+	o = _mm256_blend_epi32(o, _mm256_permutevar8x32_epi32(r2, i), 0x92);
+	_mm256_storeu_si256((__m256i*)(dst + 16), o);
+}
+
+/*
+ * Interleave the 16 bits pixels of three 128 bits vectors with byte shuffles.
+ */
+static inline SCALE3X_TARGET_AVX2 void scale3x_16_avx2_store128(scale3x_uint16* dst, __m128i r0, __m128i r1, __m128i r2)
+{
+	_mm_storeu_si128((__m128i*)(dst + 0), _mm_or_si128(_mm_or_si128(
+		_mm_shuffle_epi8(r0, _mm_setr_epi8(0, 1, -128, -128, -128, -128, 2, 3, -128, -128, -128, -128, 4, 5, -128, -128)),
+		_mm_shuffle_epi8(r1, _mm_setr_epi8(-128, -128, 0, 1, -128, -128, -128, -128, 2, 3, -128, -128, -128, -128, 4, 5))),
+		_mm_shuffle_epi8(r2, _mm_setr_epi8(-128, -128, -128, -128, 0, 1, -128, -128, -128, -128, 2, 3, -128, -128, -128, -128))));
+	_mm_storeu_si128((__m128i*)(dst + 8), _mm_or_si128(_mm_or_si128(
+		_mm_shuffle_epi8(r0, _mm_setr_epi8(-128, -128, 6, 7, -128, -128, -128, -128, 8, 9, -128, -128, -128, -128, 10, 11)),
+		_mm_shuffle_epi8(r1, _mm_setr_epi8(-128, -128, -128, -128, 6, 7, -128, -128, -128, -128, 8, 9, -128, -128, -128, -128))),
+		_mm_shuffle_epi8(r2, _mm_setr_epi8(4, 5, -128, -128, -128, -128, 6, 7, -128, -128, -128, -128, 8, 9, -128, -128))));
+	_mm_storeu_si128((__m128i*)(dst + 16), _mm_or_si128(_mm_or_si128(
+		_mm_shuffle_epi8(r0, _mm_setr_epi8(-128, -128, -128, -128, 12, 13, -128, -128, -128, -128, 14, 15, -128, -128, -128, -128)),
+		_mm_shuffle_epi8(r1, _mm_setr_epi8(10, 11, -128, -128, -128, -128, 12, 13, -128, -128, -128, -128, 14, 15, -128, -128))),
+		_mm_shuffle_epi8(r2, _mm_setr_epi8(-128, -128, 10, 11, -128, -128, -128, -128, 12, 13, -128, -128, -128, -128, 14, 15))));
+}
+
+static inline SCALE3X_TARGET_AVX2 void scale3x_16_avx2_store(scale3x_uint16* dst, __m256i r0, __m256i r1, __m256i r2)
+{
+	scale3x_16_avx2_store128(dst, _mm256_castsi256_si128(r0), _mm256_castsi256_si128(r1), _mm256_castsi256_si128(r2));
+	scale3x_16_avx2_store128(dst + 24, _mm256_extracti128_si256(r0, 1), _mm256_extracti128_si256(r1, 1), _mm256_extracti128_si256(r2, 1));
+}
+
+/*
+ * Interleave the 8 bits pixels of three 128 bits vectors with byte shuffles.
+ */
+static inline SCALE3X_TARGET_AVX2 void scale3x_8_avx2_store128(scale3x_uint8* dst, __m128i r0, __m128i r1, __m128i r2)
+{
+	_mm_storeu_si128((__m128i*)(dst + 0), _mm_or_si128(_mm_or_si128(
+		_mm_shuffle_epi8(r0, _mm_setr_epi8(0, -128, -128, 1, -128, -128, 2, -128, -128, 3, -128, -128, 4, -128, -128, 5)),
+		_mm_shuffle_epi8(r1, _mm_setr_epi8(-128, 0, -128, -128, 1, -128, -128, 2, -128, -128, 3, -128, -128, 4, -128, -128))),
+		_mm_shuffle_epi8(r2, _mm_setr_epi8(-128, -128, 0, -128, -128, 1, -128, -128, 2, -128, -128, 3, -128, -128, 4, -128))));
+	_mm_storeu_si128((__m128i*)(dst + 16), _mm_or_si128(_mm_or_si128(
+		_mm_shuffle_epi8(r0, _mm_setr_epi8(-128, -128, 6, -128, -128, 7, -128, -128, 8, -128, -128, 9, -128, -128, 10, -128)),
+		_mm_shuffle_epi8(r1, _mm_setr_epi8(5, -128, -128, 6, -128, -128, 7, -128, -128, 8, -128, -128, 9, -128, -128, 10))),
+		_mm_shuffle_epi8(r2, _mm_setr_epi8(-128, 5, -128, -128, 6, -128, -128, 7, -128, -128, 8, -128, -128, 9, -128, -128))));
+	_mm_storeu_si128((__m128i*)(dst + 32), _mm_or_si128(_mm_or_si128(
+		_mm_shuffle_epi8(r0, _mm_setr_epi8(-128, 11, -128, -128, 12, -128, -128, 13, -128, -128, 14, -128, -128, 15, -128, -128)),
+		_mm_shuffle_epi8(r1, _mm_setr_epi8(-128, -128, 11, -128, -128, 12, -128, -128, 13, -128, -128, 14, -128, -128, 15, -128))),
+		_mm_shuffle_epi8(r2, _mm_setr_epi8(10, -128, -128, 11, -128, -128, 12, -128, -128, 13, -128, -128, 14, -128, -128, 15))));
+}
+
+static inline SCALE3X_TARGET_AVX2 void scale3x_8_avx2_store(scale3x_uint8* dst, __m256i r0, __m256i r1, __m256i r2)
+{
+	scale3x_8_avx2_store128(dst, _mm256_castsi256_si128(r0), _mm256_castsi256_si128(r1), _mm256_castsi256_si128(r2));
+	scale3x_8_avx2_store128(dst + 48, _mm256_extracti128_si256(r0, 1), _mm256_extracti128_si256(r1, 1), _mm256_extracti128_si256(r2, 1));
+}
+
+/*
+ * Apply the Scale3x effect at a single row using vector registers.
+ * This function must be called only by the other scale3x functions.
+ *
+ * It computes the same result of the scale3x_*_def_border() and
+ * scale3x_*_def_center() functions. The first and the last pixels, and
+ * the central pixels not filling a whole vector register, are computed
+ * with scalar code.
+ *
+ * With the pixel map :
+ *
+ *      ABC (src0)
+ *      DEF (src1)
+ *      GHI (src2)
+ *
+ * the vector registers contain the pixels with the same name in
+ * lowercase, for example d -> D (src1 - 1).
+ */
+
+static inline void scale3x_8_sse2_border(scale3x_uint8* restrict dst, const scale3x_uint8* restrict src0, const scale3x_uint8* restrict src1, const scale3x_uint8* restrict src2, unsigned count)
+{
+	assert(count >= 2);
+
+	/* first pixel */
+	if (src0[0] != src2[0] && src1[0] != src1[1]) {
+		dst[0] = src1[0];
+		dst[1] = (src1[0] == src0[0] && src1[0] != src0[1]) || (src1[1] == src0[0] && src1[0] != src0[0]) ? src0[0] : src1[0];
+		dst[2] = src1[1] == src0[0] ? src1[1] : src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+		dst[2] = src1[0];
+	}
+	++src0;
+	++src1;
+	++src2;
+	dst += 3;
+	--count;
+
+	/* central pixels */
+	--count;
+	while (count >= 16) {
+		__m128i a = _mm_loadu_si128((const __m128i*)(src0 - 1));
+		__m128i b = _mm_loadu_si128((const __m128i*)(src0));
+		__m128i c = _mm_loadu_si128((const __m128i*)(src0 + 1));
+		__m128i d = _mm_loadu_si128((const __m128i*)(src1 - 1));
+		__m128i e = _mm_loadu_si128((const __m128i*)(src1));
+		__m128i f = _mm_loadu_si128((const __m128i*)(src1 + 1));
+		__m128i h = _mm_loadu_si128((const __m128i*)(src2));
+		__m128i k, db, fb, m, r0, r1, r2;
+
+		/* k = B != H && D != F */
+		k = _mm_andnot_si128(_mm_or_si128(_mm_cmpeq_epi8(b, h), _mm_cmpeq_epi8(d, f)), _mm_set1_epi32(-1));
+		db = _mm_cmpeq_epi8(d, b);
+		fb = _mm_cmpeq_epi8(f, b);
+
+		/* r0 = k && D == B ? D : E */
+		m = _mm_and_si128(k, db);
+		r0 = _mm_or_si128(_mm_and_si128(m, d), _mm_andnot_si128(m, e));
+
+		/* r1 = k && ((D == B && E != C) || (F == B && E != A)) ? B : E */
+		m = _mm_or_si128(_mm_andnot_si128(_mm_cmpeq_epi8(e, c), db), _mm_andnot_si128(_mm_cmpeq_epi8(e, a), fb));
+		m = _mm_and_si128(k, m);
+		r1 = _mm_or_si128(_mm_and_si128(m, b), _mm_andnot_si128(m, e));
+
+		/* r2 = k && F == B ? F : E */
+		m = _mm_and_si128(k, fb);
+		r2 = _mm_or_si128(_mm_and_si128(m, f), _mm_andnot_si128(m, e));
+
+		scale3x_8_sse2_store(dst, r0, r1, r2);
+
+		src0 += 16;
+		src1 += 16;
+		src2 += 16;
+		dst += 48;
+		count -= 16;
+	}
+
+	while (count) {
+		if (src0[0] != src2[0] && src1[-1] != src1[1]) {
+			dst[0] = src1[-1] == src0[0] ? src1[-1] : src1[0];
+			dst[1] = (src1[-1] == src0[0] && src1[0] != src0[1]) || (src1[1] == src0[0] && src1[0] != src0[-1]) ? src0[0] : src1[0];
+			dst[2] = src1[1] == src0[0] ? src1[1] : src1[0];
+		} else {
+			dst[0] = src1[0];
+			dst[1] = src1[0];
+			dst[2] = src1[0];
+		}
+
+		++src0;
+		++src1;
+		++src2;
+		dst += 3;
+		--count;
+	}
+
+	/* last pixel */
+	if (src0[0] != src2[0] && src1[-1] != src1[0]) {
+		dst[0] = src1[-1] == src0[0] ? src1[-1] : src1[0];
+		dst[1] = (src1[-1] == src0[0] && src1[0] != src0[0]) || (src1[0] == src0[0] && src1[0] != src0[-1]) ? src0[0] : src1[0];
+		dst[2] = src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+		dst[2] = src1[0];
+	}
+}
+
+static inline void scale3x_8_sse2_center(scale3x_uint8* restrict dst, const scale3x_uint8* restrict src0, const scale3x_uint8* restrict src1, const scale3x_uint8* restrict src2, unsigned count)
+{
+	assert(count >= 2);
+
+	/* first pixel */
+	if (src0[0] != src2[0] && src1[0] != src1[1]) {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+		dst[2] = (src1[1] == src0[0] && src1[0] != src2[1]) || (src1[1] == src2[0] && src1[0] != src0[1]) ? src1[1] : src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+		dst[2] = src1[0];
+	}
+	++src0;
+	++src1;
+	++src2;
+	dst += 3;
+	--count;
+
+	/* central pixels */
+	--count;
+	while (count >= 16) {
+		__m128i a = _mm_loadu_si128((const __m128i*)(src0 - 1));
+		__m128i b = _mm_loadu_si128((const __m128i*)(src0));
+		__m128i c = _mm_loadu_si128((const __m128i*)(src0 + 1));
+		__m128i d = _mm_loadu_si128((const __m128i*)(src1 - 1));
+		__m128i e = _mm_loadu_si128((const __m128i*)(src1));
+		__m128i f = _mm_loadu_si128((const __m128i*)(src1 + 1));
+		__m128i g = _mm_loadu_si128((const __m128i*)(src2 - 1));
+		__m128i h = _mm_loadu_si128((const __m128i*)(src2));
+		__m128i i = _mm_loadu_si128((const __m128i*)(src2 + 1));
+		__m128i k, m, r0, r2;
+
+		/* k = B != H && D != F */
+		k = _mm_andnot_si128(_mm_or_si128(_mm_cmpeq_epi8(b, h), _mm_cmpeq_epi8(d, f)), _mm_set1_epi32(-1));
+
+		/* r0 = k && ((D == B && E != G) || (D == H && E != A)) ? D : E */
+		m = _mm_or_si128(_mm_andnot_si128(_mm_cmpeq_epi8(e, g), _mm_cmpeq_epi8(d, b)), _mm_andnot_si128(_mm_cmpeq_epi8(e, a), _mm_cmpeq_epi8(d, h)));
+		m = _mm_and_si128(k, m);
+		r0 = _mm_or_si128(_mm_and_si128(m, d), _mm_andnot_si128(m, e));
+
+		/* r2 = k && ((F == B && E != I) || (F == H && E != C)) ? F : E */
+		m = _mm_or_si128(_mm_andnot_si128(_mm_cmpeq_epi8(e, i), _mm_cmpeq_epi8(f, b)), _mm_andnot_si128(_mm_cmpeq_epi8(e, c), _mm_cmpeq_epi8(f, h)));
+		m = _mm_and_si128(k, m);
+		r2 = _mm_or_si128(_mm_and_si128(m, f), _mm_andnot_si128(m, e));
+
+		scale3x_8_sse2_store(dst, r0, e, r2);
+
+		src0 += 16;
+		src1 += 16;
+		src2 += 16;
+		dst += 48;
+		count -= 16;
+	}
+
+	while (count) {
+		if (src0[0] != src2[0] && src1[-1] != src1[1]) {
+			dst[0] = (src1[-1] == src0[0] && src1[0] != src2[-1]) || (src1[-1] == src2[0] && src1[0] != src0[-1]) ? src1[-1] : src1[0];
+			dst[1] = src1[0];
+			dst[2] = (src1[1] == src0[0] && src1[0] != src2[1]) || (src1[1] == src2[0] && src1[0] != src0[1]) ? src1[1] : src1[0];
+		} else {
+			dst[0] = src1[0];
+			dst[1] = src1[0];
+			dst[2] = src1[0];
+		}
+
+		++src0;
+		++src1;
+		++src2;
+		dst += 3;
+		--count;
+	}
+
+	/* last pixel */
+	if (src0[0] != src2[0] && src1[-1] != src1[0]) {
+		dst[0] = (src1[-1] == src0[0] && src1[0] != src2[-1]) || (src1[-1] == src2[0] && src1[0] != src0[-1]) ? src1[-1] : src1[0];
+		dst[1] = src1[0];
+		dst[2] = src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+		dst[2] = src1[0];
+	}
+}
+
+static inline void scale3x_16_sse2_border(scale3x_uint16* restrict dst, const scale3x_uint16* restrict src0, const scale3x_uint16* restrict src1, const scale3x_uint16* restrict src2, unsigned count)
+{
+	assert(count >= 2);
+
+	/* first pixel */
+	if (src0[0] != src2[0] && src1[0] != src1[1]) {
+		dst[0] = src1[0];
+		dst[1] = (src1[0] == src0[0] && src1[0] != src0[1]) || (src1[1] == src0[0] && src1[0] != src0[0]) ? src0[0] : src1[0];
+		dst[2] = src1[1] == src0[0] ? src1[1] : src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+		dst[2] = src1[0];
+	}
+	++src0;
+	++src1;
+	++src2;
+	dst += 3;
+	--count;
+
+	/* central pixels */
+	--count;
+	while (count >= 8) {
+		__m128i a = _mm_loadu_si128((const __m128i*)(src0 - 1));
+		__m128i b = _mm_loadu_si128((const __m128i*)(src0));
+		__m128i c = _mm_loadu_si128((const __m128i*)(src0 + 1));
+		__m128i d = _mm_loadu_si128((const __m128i*)(src1 - 1));
+		__m128i e = _mm_loadu_si128((const __m128i*)(src1));
+		__m128i f = _mm_loadu_si128((const __m128i*)(src1 + 1));
+		__m128i h = _mm_loadu_si128((const __m128i*)(src2));
+		__m128i k, db, fb, m, r0, r1, r2;
+
+		/* k = B != H && D != F */
+		k = _mm_andnot_si128(_mm_or_si128(_mm_cmpeq_epi16(b, h), _mm_cmpeq_epi16(d, f)), _mm_set1_epi32(-1));
+		db = _mm_cmpeq_epi16(d, b);
+		fb = _mm_cmpeq_epi16(f, b);
+
+		/* r0 = k && D == B ? D : E */
+		m = _mm_and_si128(k, db);
+		r0 = _mm_or_si128(_mm_and_si128(m, d), _mm_andnot_si128(m, e));
+
+		/* r1 = k && ((D == B && E != C) || (F == B && E != A)) ? B : E */
+		m = _mm_or_si128(_mm_andnot_si128(_mm_cmpeq_epi16(e, c), db), _mm_andnot_si128(_mm_cmpeq_epi16(e, a), fb));
+		m = _mm_and_si128(k, m);
+		r1 = _mm_or_si128(_mm_and_si128(m, b), _mm_andnot_si128(m, e));
+
+		/* r2 = k && F == B ? F : E */
+		m = _mm_and_si128(k, fb);
+		r2 = _mm_or_si128(_mm_and_si128(m, f), _mm_andnot_si128(m, e));
+
+		scale3x_16_sse2_store(dst, r0, r1, r2);
+
+		src0 += 8;
+		src1 += 8;
+		src2 += 8;
+		dst += 24;
+		count -= 8;
+	}
+
+	while (count) {
+		if (src0[0] != src2[0] && src1[-1] != src1[1]) {
+			dst[0] = src1[-1] == src0[0] ? src1[-1] : src1[0];
+			dst[1] = (src1[-1] == src0[0] && src1[0] != src0[1]) || (src1[1] == src0[0] && src1[0] != src0[-1]) ? src0[0] : src1[0];
+			dst[2] = src1[1] == src0[0] ? src1[1] : src1[0];
+		} else {
+			dst[0] = src1[0];
+			dst[1] = src1[0];
+			dst[2] = src1[0];
+		}
+
+		++src0;
+		++src1;
+		++src2;
+		dst += 3;
+		--count;
+	}
+
+	/* last pixel */
+	if (src0[0] != src2[0] && src1[-1] != src1[0]) {
+		dst[0] = src1[-1] == src0[0] ? src1[-1] : src1[0];
+		dst[1] = (src1[-1] == src0[0] && src1[0] != src0[0]) || (src1[0] == src0[0] && src1[0] != src0[-1]) ? src0[0] : src1[0];
+		dst[2] = src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+		dst[2] = src1[0];
+	}
+}
+
+static inline void scale3x_16_sse2_center(scale3x_uint16* restrict dst, const scale3x_uint16* restrict src0, const scale3x_uint16* restrict src1, const scale3x_uint16* restrict src2, unsigned count)
+{
+	assert(count >= 2);
+
+	/* first pixel */
+	if (src0[0] != src2[0] && src1[0] != src1[1]) {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+		dst[2] = (src1[1] == src0[0] && src1[0] != src2[1]) || (src1[1] == src2[0] && src1[0] != src0[1]) ? src1[1] : src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+		dst[2] = src1[0];
+	}
+	++src0;
+	++src1;
+	++src2;
+	dst += 3;
+	--count;
+
+	/* central pixels */
+	--count;
+	while (count >= 8) {
+		__m128i a = _mm_loadu_si128((const __m128i*)(src0 - 1));
+		__m128i b = _mm_loadu_si128((const __m128i*)(src0));
+		__m128i c = _mm_loadu_si128((const __m128i*)(src0 + 1));
+		__m128i d = _mm_loadu_si128((const __m128i*)(src1 - 1));
+		__m128i e = _mm_loadu_si128((const __m128i*)(src1));
+		__m128i f = _mm_loadu_si128((const __m128i*)(src1 + 1));
+		__m128i g = _mm_loadu_si128((const __m128i*)(src2 - 1));
+		__m128i h = _mm_loadu_si128((const __m128i*)(src2));
+		__m128i i = _mm_loadu_si128((const __m128i*)(src2 + 1));
+		__m128i k, m, r0, r2;
+
+		/* k = B != H && D != F */
+		k = _mm_andnot_si128(_mm_or_si128(_mm_cmpeq_epi16(b, h), _mm_cmpeq_epi16(d, f)), _mm_set1_epi32(-1));
+
+		/* r0 = k && ((D == B && E != G) || (D == H && E != A)) ? D : E */
+		m = _mm_or_si128(_mm_andnot_si128(_mm_cmpeq_epi16(e, g), _mm_cmpeq_epi16(d, b)), _mm_andnot_si128(_mm_cmpeq_epi16(e, a), _mm_cmpeq_epi16(d, h)));
+		m = _mm_and_si128(k, m);
+		r0 = _mm_or_si128(_mm_and_si128(m, d), _mm_andnot_si128(m, e));
+
+		/* r2 = k && ((F == B && E != I) || (F == H && E != C)) ? F : E */
+		m = _mm_or_si128(_mm_andnot_si128(_mm_cmpeq_epi16(e, i), _mm_cmpeq_epi16(f, b)), _mm_andnot_si128(_mm_cmpeq_epi16(e, c), _mm_cmpeq_epi16(f, h)));
+		m = _mm_and_si128(k, m);
+		r2 = _mm_or_si128(_mm_and_si128(m, f), _mm_andnot_si128(m, e));
+
+		scale3x_16_sse2_store(dst, r0, e, r2);
+
+		src0 += 8;
+		src1 += 8;
+		src2 += 8;
+		dst += 24;
+		count -= 8;
+	}
+
+	while (count) {
+		if (src0[0] != src2[0] && src1[-1] != src1[1]) {
+			dst[0] = (src1[-1] == src0[0] && src1[0] != src2[-1]) || (src1[-1] == src2[0] && src1[0] != src0[-1]) ? src1[-1] : src1[0];
+			dst[1] = src1[0];
+			dst[2] = (src1[1] == src0[0] && src1[0] != src2[1]) || (src1[1] == src2[0] && src1[0] != src0[1]) ? src1[1] : src1[0];
+		} else {
+			dst[0] = src1[0];
+			dst[1] = src1[0];
+			dst[2] = src1[0];
+		}
+
+		++src0;
+		++src1;
+		++src2;
+		dst += 3;
+		--count;
+	}
+
+	/* last pixel */
+	if (src0[0] != src2[0] && src1[-1] != src1[0]) {
+		dst[0] = (src1[-1] == src0[0] && src1[0] != src2[-1]) || (src1[-1] == src2[0] && src1[0] != src0[-1]) ? src1[-1] : src1[0];
+		dst[1] = src1[0];
+		dst[2] = src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+		dst[2] = src1[0];
+	}
+}
+
+static inline void scale3x_32_sse2_border(scale3x_uint32* restrict dst, const scale3x_uint32* restrict src0, const scale3x_uint32* restrict src1, const scale3x_uint32* restrict src2, unsigned count)
+{
+	assert(count >= 2);
+
+	/* first pixel */
+	if (src0[0] != src2[0] && src1[0] != src1[1]) {
+		dst[0] = src1[0];
+		dst[1] = (src1[0] == src0[0] && src1[0] != src0[1]) || (src1[1] == src0[0] && src1[0] != src0[0]) ? src0[0] : src1[0];
+		dst[2] = src1[1] == src0[0] ? src1[1] : src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+		dst[2] = src1[0];
+	}
+	++src0;
+	++src1;
+	++src2;
+	dst += 3;
+	--count;
+
+	/* central pixels */
+	--count;
+	while (count >= 4) {
+		__m128i a = _mm_loadu_si128((const __m128i*)(src0 - 1));
+		__m128i b = _mm_loadu_si128((const __m128i*)(src0));
+		__m128i c = _mm_loadu_si128((const __m128i*)(src0 + 1));
+		__m128i d = _mm_loadu_si128((const __m128i*)(src1 - 1));
+		__m128i e = _mm_loadu_si128((const __m128i*)(src1));
+		__m128i f = _mm_loadu_si128((const __m128i*)(src1 + 1));
+		__m128i h = _mm_loadu_si128((const __m128i*)(src2));
+		__m128i k, db, fb, m, r0, r1, r2;
+
+		/* k = B != H && D != F */
+		k = _mm_andnot_si128(_mm_or_si128(_mm_cmpeq_epi32(b, h), _mm_cmpeq_epi32(d, f)), _mm_set1_epi32(-1));
+		db = _mm_cmpeq_epi32(d, b);
+		fb = _mm_cmpeq_epi32(f, b);
+
+		/* r0 = k && D == B ? D : E */
+		m = _mm_and_si128(k, db);
+		r0 = _mm_or_si128(_mm_and_si128(m, d), _mm_andnot_si128(m, e));
+
+		/* r1 = k && ((D == B && E != C) || (F == B && E != A)) ? B : E */
+		m = _mm_or_si128(_mm_andnot_si128(_mm_cmpeq_epi32(e, c), db), _mm_andnot_si128(_mm_cmpeq_epi32(e, a), fb));
+		m = _mm_and_si128(k, m);
+		r1 = _mm_or_si128(_mm_and_si128(m, b), _mm_andnot_si128(m, e));
+
+		/* r2 = k && F == B ? F : E */
+		m = _mm_and_si128(k, fb);
+		r2 = _mm_or_si128(_mm_and_si128(m, f), _mm_andnot_si128(m, e));
+
+		scale3x_32_sse2_store(dst, r0, r1, r2);
+
+		src0 += 4;
+		src1 += 4;
+		src2 += 4;
+		dst += 12;
+		count -= 4;
+	}
+
+	while (count) {
+		if (src0[0] != src2[0] && src1[-1] != src1[1]) {
+			dst[0] = src1[-1] == src0[0] ? src1[-1] : src1[0];
+			dst[1] = (src1[-1] == src0[0] && src1[0] != src0[1]) || (src1[1] == src0[0] && src1[0] != src0[-1]) ? src0[0] : src1[0];
+			dst[2] = src1[1] == src0[0] ? src1[1] : src1[0];
+		} else {
+			dst[0] = src1[0];
+			dst[1] = src1[0];
+			dst[2] = src1[0];
+		}
+
+		++src0;
+		++src1;
+		++src2;
+		dst += 3;
+		--count;
+	}
+
+	/* last pixel */
+	if (src0[0] != src2[0] && src1[-1] != src1[0]) {
+		dst[0] = src1[-1] == src0[0] ? src1[-1] : src1[0];
+		dst[1] = (src1[-1] == src0[0] && src1[0] != src0[0]) || (src1[0] == src0[0] && src1[0] != src0[-1]) ? src0[0] : src1[0];
+		dst[2] = src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+		dst[2] = src1[0];
+	}
+}
+
+static inline void scale3x_32_sse2_center(scale3x_uint32* restrict dst, const scale3x_uint32* restrict src0, const scale3x_uint32* restrict src1, const scale3x_uint32* restrict src2, unsigned count)
+{
+	assert(count >= 2);
+
+	/* first pixel */
+	if (src0[0] != src2[0] && src1[0] != src1[1]) {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+		dst[2] = (src1[1] == src0[0] && src1[0] != src2[1]) || (src1[1] == src2[0] && src1[0] != src0[1]) ? src1[1] : src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+		dst[2] = src1[0];
+	}
+	++src0;
+	++src1;
+	++src2;
+	dst += 3;
+	--count;
+
+	/* central pixels */
+	--count;
+	while (count >= 4) {
+		__m128i a = _mm_loadu_si128((const __m128i*)(src0 - 1));
+		__m128i b = _mm_loadu_si128((const __m128i*)(src0));
+		__m128i c = _mm_loadu_si128((const __m128i*)(src0 + 1));
+		__m128i d = _mm_loadu_si128((const __m128i*)(src1 - 1));
+		__m128i e = _mm_loadu_si128((const __m128i*)(src1));
+		__m128i f = _mm_loadu_si128((const __m128i*)(src1 + 1));
+		__m128i g = _mm_loadu_si128((const __m128i*)(src2 - 1));
+		__m128i h = _mm_loadu_si128((const __m128i*)(src2));
+		__m128i i = _mm_loadu_si128((const __m128i*)(src2 + 1));
+		__m128i k, m, r0, r2;
+
+		/* k = B != H && D != F */
+		k = _mm_andnot_si128(_mm_or_si128(_mm_cmpeq_epi32(b, h), _mm_cmpeq_epi32(d, f)), _mm_set1_epi32(-1));
+
+		/* r0 = k && ((D == B && E != G) || (D == H && E != A)) ? D : E */
+		m = _mm_or_si128(_mm_andnot_si128(_mm_cmpeq_epi32(e, g), _mm_cmpeq_epi32(d, b)), _mm_andnot_si128(_mm_cmpeq_epi32(e, a), _mm_cmpeq_epi32(d, h)));
+		m = _mm_and_si128(k, m);
+		r0 = _mm_or_si128(_mm_and_si128(m, d), _mm_andnot_si128(m, e));
+
+		/* r2 = k && ((F == B && E != I) || (F == H && E != C)) ? F : E */
+		m = _mm_or_si128(_mm_andnot_si128(_mm_cmpeq_epi32(e, i), _mm_cmpeq_epi32(f, b)), _mm_andnot_si128(_mm_cmpeq_epi32(e, c), _mm_cmpeq_epi32(f, h)));
+		m = _mm_and_si128(k, m);
+		r2 = _mm_or_si128(_mm_and_si128(m, f), _mm_andnot_si128(m, e));
+
+		scale3x_32_sse2_store(dst, r0, e, r2);
+
+		src0 += 4;
+		src1 += 4;
+		src2 += 4;
+		dst += 12;
+		count -= 4;
+	}
+
+	while (count) {
+		if (src0[0] != src2[0] && src1[-1] != src1[1]) {
+			dst[0] = (src1[-1] == src0[0] && src1[0] != src2[-1]) || (src1[-1] == src2[0] && src1[0] != src0[-1]) ? src1[-1] : src1[0];
+			dst[1] = src1[0];
+			dst[2] = (src1[1] == src0[0] && src1[0] != src2[1]) || (src1[1] == src2[0] && src1[0] != src0[1]) ? src1[1] : src1[0];
+		} else {
+			dst[0] = src1[0];
+			dst[1] = src1[0];
+			dst[2] = src1[0];
+		}
+
+		++src0;
+		++src1;
+		++src2;
+		dst += 3;
+		--count;
+	}
+
+	/* last pixel */
+	if (src0[0] != src2[0] && src1[-1] != src1[0]) {
+		dst[0] = (src1[-1] == src0[0] && src1[0] != src2[-1]) || (src1[-1] == src2[0] && src1[0] != src0[-1]) ? src1[-1] : src1[0];
+		dst[1] = src1[0];
+		dst[2] = src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+		dst[2] = src1[0];
+	}
+}
+
+static inline SCALE3X_TARGET_AVX2 void scale3x_8_avx2_border(scale3x_uint8* restrict dst, const scale3x_uint8* restrict src0, const scale3x_uint8* restrict src1, const scale3x_uint8* restrict src2, unsigned count)
+{
+	assert(count >= 2);
+
+	/* first pixel */
+	if (src0[0] != src2[0] && src1[0] != src1[1]) {
+		dst[0] = src1[0];
+		dst[1] = (src1[0] == src0[0] && src1[0] != src0[1]) || (src1[1] == src0[0] && src1[0] != src0[0]) ? src0[0] : src1[0];
+		dst[2] = src1[1] == src0[0] ? src1[1] : src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+		dst[2] = src1[0];
+	}
+	++src0;
+	++src1;
+	++src2;
+	dst += 3;
+	--count;
+
+	/* central pixels */
+	--count;
+	while (count >= 32) {
+		__m256i a = _mm256_loadu_si256((const __m256i*)(src0 - 1));
+		__m256i b = _mm256_loadu_si256((const __m256i*)(src0));
+		__m256i c = _mm256_loadu_si256((const __m256i*)(src0 + 1));
+		__m256i d = _mm256_loadu_si256((const __m256i*)(src1 - 1));
+		__m256i e = _mm256_loadu_si256((const __m256i*)(src1));
+		__m256i f = _mm256_loadu_si256((const __m256i*)(src1 + 1));
+		__m256i h = _mm256_loadu_si256((const __m256i*)(src2));
+		__m256i k, db, fb, m, r0, r1, r2;
+
+		/* k = B != H && D != F */
+		k = _mm256_andnot_si256(_mm256_or_si256(_mm256_cmpeq_epi8(b, h), _mm256_cmpeq_epi8(d, f)), _mm256_set1_epi32(-1));
+		db = _mm256_cmpeq_epi8(d, b);
+		fb = _mm256_cmpeq_epi8(f, b);
+
+		/* r0 = k && D == B ? D : E */
+		m = _mm256_and_si256(k, db);
+		r0 = _mm256_or_si256(_mm256_and_si256(m, d), _mm256_andnot_si256(m, e));
+
+		/* r1 = k && ((D == B && E != C) || (F == B && E != A)) ? B : E */
+		m = _mm256_or_si256(_mm256_andnot_si256(_mm256_cmpeq_epi8(e, c), db), _mm256_andnot_si256(_mm256_cmpeq_epi8(e, a), fb));
+		m = _mm256_and_si256(k, m);
+		r1 = _mm256_or_si256(_mm256_and_si256(m, b), _mm256_andnot_si256(m, e));
+
+		/* r2 = k && F == B ? F : E */
+		m = _mm256_and_si256(k, fb);
+		r2 = _mm256_or_si256(_mm256_and_si256(m, f), _mm256_andnot_si256(m, e));
+
+		scale3x_8_avx2_store(dst, r0, r1, r2);
+
+		src0 += 32;
+		src1 += 32;
+		src2 += 32;
+		dst += 96;
+		count -= 32;
+	}
+
+	while (count) {
+		if (src0[0] != src2[0] && src1[-1] != src1[1]) {
+			dst[0] = src1[-1] == src0[0] ? src1[-1] : src1[0];
+			dst[1] = (src1[-1] == src0[0] && src1[0] != src0[1]) || (src1[1] == src0[0] && src1[0] != src0[-1]) ? src0[0] : src1[0];
+			dst[2] = src1[1] == src0[0] ? src1[1] : src1[0];
+		} else {
+			dst[0] = src1[0];
+			dst[1] = src1[0];
+			dst[2] = src1[0];
+		}
+
+		++src0;
+		++src1;
+		++src2;
+		dst += 3;
+		--count;
+	}
+
+	/* last pixel */
+	if (src0[0] != src2[0] && src1[-1] != src1[0]) {
+		dst[0] = src1[-1] == src0[0] ? src1[-1] : src1[0];
+		dst[1] = (src1[-1] == src0[0] && src1[0] != src0[0]) || (src1[0] == src0[0] && src1[0] != src0[-1]) ? src0[0] : src1[0];
+		dst[2] = src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+		dst[2] = src1[0];
+	}
+}
+
+static inline SCALE3X_TARGET_AVX2 void scale3x_8_avx2_center(scale3x_uint8* restrict dst, const scale3x_uint8* restrict src0, const scale3x_uint8* restrict src1, const scale3x_uint8* restrict src2, unsigned count)
+{
+	assert(count >= 2);
+
+	/* first pixel */
+	if (src0[0] != src2[0] && src1[0] != src1[1]) {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+		dst[2] = (src1[1] == src0[0] && src1[0] != src2[1]) || (src1[1] == src2[0] && src1[0] != src0[1]) ? src1[1] : src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+		dst[2] = src1[0];
+	}
+	++src0;
+	++src1;
+	++src2;
+	dst += 3;
+	--count;
+
+	/* central pixels */
+	--count;
+	while (count >= 32) {
+		__m256i a = _mm256_loadu_si256((const __m256i*)(src0 - 1));
+		__m256i b = _mm256_loadu_si256((const __m256i*)(src0));
+		__m256i c = _mm256_loadu_si256((const __m256i*)(src0 + 1));
+		__m256i d = _mm256_loadu_si256((const __m256i*)(src1 - 1));
+		__m256i e = _mm256_loadu_si256((const __m256i*)(src1));
+		__m256i f = _mm256_loadu_si256((const __m256i*)(src1 + 1));
+		__m256i g = _mm256_loadu_si256((const __m256i*)(src2 - 1));
+		__m256i h = _mm256_loadu_si256((const __m256i*)(src2));
+		__m256i i = _mm256_loadu_si256((const __m256i*)(src2 + 1));
+		__m256i k, m, r0, r2;
+
+		/* k = B != H && D != F */
+		k = _mm256_andnot_si256(_mm256_or_si256(_mm256_cmpeq_epi8(b, h), _mm256_cmpeq_epi8(d, f)), _mm256_set1_epi32(-1));
+
+		/* r0 = k && ((D == B && E != G) || (D == H && E != A)) ? D : E */
+		m = _mm256_or_si256(_mm256_andnot_si256(_mm256_cmpeq_epi8(e, g), _mm256_cmpeq_epi8(d, b)), _mm256_andnot_si256(_mm256_cmpeq_epi8(e, a), _mm256_cmpeq_epi8(d, h)));
+		m = _mm256_and_si256(k, m);
+		r0 = _mm256_or_si256(_mm256_and_si256(m, d), _mm256_andnot_si256(m, e));
+
+		/* r2 = k && ((F == B && E != I) || (F == H && E != C)) ? F : E */
+		m = _mm256_or_si256(_mm256_andnot_si256(_mm256_cmpeq_epi8(e, i), _mm256_cmpeq_epi8(f, b)), _mm256_andnot_si256(_mm256_cmpeq_epi8(e, c), _mm256_cmpeq_epi8(f, h)));
+		m = _mm256_and_si256(k, m);
+		r2 = _mm256_or_si256(_mm256_and_si256(m, f), _mm256_andnot_si256(m, e));
+
+		scale3x_8_avx2_store(dst, r0, e, r2);
+
+		src0 += 32;
+		src1 += 32;
+		src2 += 32;
+		dst += 96;
+		count -= 32;
+	}
+
+	while (count) {
+		if (src0[0] != src2[0] && src1[-1] != src1[1]) {
+			dst[0] = (src1[-1] == src0[0] && src1[0] != src2[-1]) || (src1[-1] == src2[0] && src1[0] != src0[-1]) ? src1[-1] : src1[0];
+			dst[1] = src1[0];
+			dst[2] = (src1[1] == src0[0] && src1[0] != src2[1]) || (src1[1] == src2[0] && src1[0] != src0[1]) ? src1[1] : src1[0];
+		} else {
+			dst[0] = src1[0];
+			dst[1] = src1[0];
+			dst[2] = src1[0];
+		}
+
+		++src0;
+		++src1;
+		++src2;
+		dst += 3;
+		--count;
+	}
+
+	/* last pixel */
+	if (src0[0] != src2[0] && src1[-1] != src1[0]) {
+		dst[0] = (src1[-1] == src0[0] && src1[0] != src2[-1]) || (src1[-1] == src2[0] && src1[0] != src0[-1]) ? src1[-1] : src1[0];
+		dst[1] = src1[0];
+		dst[2] = src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+		dst[2] = src1[0];
+	}
+}
+
+static inline SCALE3X_TARGET_AVX2 void scale3x_16_avx2_border(scale3x_uint16* restrict dst, const scale3x_uint16* restrict src0, const scale3x_uint16* restrict src1, const scale3x_uint16* restrict src2, unsigned count)
+{
+	assert(count >= 2);
+
+	/* first pixel */
+	if (src0[0] != src2[0] && src1[0] != src1[1]) {
+		dst[0] = src1[0];
+		dst[1] = (src1[0] == src0[0] && src1[0] != src0[1]) || (src1[1] == src0[0] && src1[0] != src0[0]) ? src0[0] : src1[0];
+		dst[2] = src1[1] == src0[0] ? src1[1] : src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+		dst[2] = src1[0];
+	}
+	++src0;
+	++src1;
+	++src2;
+	dst += 3;
+	--count;
+
+	/* central pixels */
+	--count;
+	while (count >= 16) {
+		__m256i a = _mm256_loadu_si256((const __m256i*)(src0 - 1));
+		__m256i b = _mm256_loadu_si256((const __m256i*)(src0));
+		__m256i c = _mm256_loadu_si256((const __m256i*)(src0 + 1));
+		__m256i d = _mm256_loadu_si256((const __m256i*)(src1 - 1));
+		__m256i e = _mm256_loadu_si256((const __m256i*)(src1));
+		__m256i f = _mm256_loadu_si256((const __m256i*)(src1 + 1));
+		__m256i h = _mm256_loadu_si256((const __m256i*)(src2));
+		__m256i k, db, fb, m, r0, r1, r2;
+
+		/* k = B != H && D != F */
+		k = _mm256_andnot_si256(_mm256_or_si256(_mm256_cmpeq_epi16(b, h), _mm256_cmpeq_epi16(d, f)), _mm256_set1_epi32(-1));
+		db = _mm256_cmpeq_epi16(d, b);
+		fb = _mm256_cmpeq_epi16(f, b);
+
+		/* r0 = k && D == B ? D : E */
+		m = _mm256_and_si256(k, db);
+		r0 = _mm256_or_si256(_mm256_and_si256(m, d), _mm256_andnot_si256(m, e));
+
+		/* r1 = k && ((D == B && E != C) || (F == B && E != A)) ? B : E */
+		m = _mm256_or_si256(_mm256_andnot_si256(_mm256_cmpeq_epi16(e, c), db), _mm256_andnot_si256(_mm256_cmpeq_epi16(e, a), fb));
+		m = _mm256_and_si256(k, m);
+		r1 = _mm256_or_si256(_mm256_and_si256(m, b), _mm256_andnot_si256(m, e));
+
+		/* r2 = k && F == B ? F : E */
+		m = _mm256_and_si256(k, fb);
+		r2 = _mm256_or_si256(_mm256_and_si256(m, f), _mm256_andnot_si256(m, e));
+
+		scale3x_16_avx2_store(dst, r0, r1, r2);
+
+		src0 += 16;
+		src1 += 16;
+		src2 += 16;
+		dst += 48;
+		count -= 16;
+	}
+
+	while (count) {
+		if (src0[0] != src2[0] && src1[-1] != src1[1]) {
+			dst[0] = src1[-1] == src0[0] ? src1[-1] : src1[0];
+			dst[1] = (src1[-1] == src0[0] && src1[0] != src0[1]) || (src1[1] == src0[0] && src1[0] != src0[-1]) ? src0[0] : src1[0];
+			dst[2] = src1[1] == src0[0] ? src1[1] : src1[0];
+		} else {
+			dst[0] = src1[0];
+			dst[1] = src1[0];
+			dst[2] = src1[0];
+		}
+
+		++src0;
+		++src1;
+		++src2;
+		dst += 3;
+		--count;
+	}
+
+	/* last pixel */
+	if (src0[0] != src2[0] && src1[-1] != src1[0]) {
+		dst[0] = src1[-1] == src0[0] ? src1[-1] : src1[0];
+		dst[1] = (src1[-1] == src0[0] && src1[0] != src0[0]) || (src1[0] == src0[0] && src1[0] != src0[-1]) ? src0[0] : src1[0];
+		dst[2] = src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+		dst[2] = src1[0];
+	}
+}
+
+static inline SCALE3X_TARGET_AVX2 void scale3x_16_avx2_center(scale3x_uint16* restrict dst, const scale3x_uint16* restrict src0, const scale3x_uint16* restrict src1, const scale3x_uint16* restrict src2, unsigned count)
+{
+	assert(count >= 2);
+
+	/* first pixel */
+	if (src0[0] != src2[0] && src1[0] != src1[1]) {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+		dst[2] = (src1[1] == src0[0] && src1[0] != src2[1]) || (src1[1] == src2[0] && src1[0] != src0[1]) ? src1[1] : src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+		dst[2] = src1[0];
+	}
+	++src0;
+	++src1;
+	++src2;
+	dst += 3;
+	--count;
+
+	/* central pixels */
+	--count;
+	while (count >= 16) {
+		__m256i a = _mm256_loadu_si256((const __m256i*)(src0 - 1));
+		__m256i b = _mm256_loadu_si256((const __m256i*)(src0));
+		__m256i c = _mm256_loadu_si256((const __m256i*)(src0 + 1));
+		__m256i d = _mm256_loadu_si256((const __m256i*)(src1 - 1));
+		__m256i e = _mm256_loadu_si256((const __m256i*)(src1));
+		__m256i f = _mm256_loadu_si256((const __m256i*)(src1 + 1));
+		__m256i g = _mm256_loadu_si256((const __m256i*)(src2 - 1));
+		__m256i h = _mm256_loadu_si256((const __m256i*)(src2));
+		__m256i i = _mm256_loadu_si256((const __m256i*)(src2 + 1));
+		__m256i k, m, r0, r2;
+
+		/* k = B != H && D != F */
+		k = _mm256_andnot_si256(_mm256_or_si256(_mm256_cmpeq_epi16(b, h), _mm256_cmpeq_epi16(d, f)), _mm256_set1_epi32(-1));
+
+		/* r0 = k && ((D == B && E != G) || (D == H && E != A)) ? D : E */
+		m = _mm256_or_si256(_mm256_andnot_si256(_mm256_cmpeq_epi16(e, g), _mm256_cmpeq_epi16(d, b)), _mm256_andnot_si256(_mm256_cmpeq_epi16(e, a), _mm256_cmpeq_epi16(d, h)));
+		m = _mm256_and_si256(k, m);
+		r0 = _mm256_or_si256(_mm256_and_si256(m, d), _mm256_andnot_si256(m, e));
+
+		/* r2 = k && ((F == B && E != I) || (F == H && E != C)) ? F : E */
+		m = _mm256_or_si256(_mm256_andnot_si256(_mm256_cmpeq_epi16(e, i), _mm256_cmpeq_epi16(f, b)), _mm256_andnot_si256(_mm256_cmpeq_epi16(e, c), _mm256_cmpeq_epi16(f, h)));
+		m = _mm256_and_si256(k, m);
+		r2 = _mm256_or_si256(_mm256_and_si256(m, f), _mm256_andnot_si256(m, e));
+
+		scale3x_16_avx2_store(dst, r0, e, r2);
+
+		src0 += 16;
+		src1 += 16;
+		src2 += 16;
+		dst += 48;
+		count -= 16;
+	}
+
+	while (count) {
+		if (src0[0] != src2[0] && src1[-1] != src1[1]) {
+			dst[0] = (src1[-1] == src0[0] && src1[0] != src2[-1]) || (src1[-1] == src2[0] && src1[0] != src0[-1]) ? src1[-1] : src1[0];
+			dst[1] = src1[0];
+			dst[2] = (src1[1] == src0[0] && src1[0] != src2[1]) || (src1[1] == src2[0] && src1[0] != src0[1]) ? src1[1] : src1[0];
+		} else {
+			dst[0] = src1[0];
+			dst[1] = src1[0];
+			dst[2] = src1[0];
+		}
+
+		++src0;
+		++src1;
+		++src2;
+		dst += 3;
+		--count;
+	}
+
+	/* last pixel */
+	if (src0[0] != src2[0] && src1[-1] != src1[0]) {
+		dst[0] = (src1[-1] == src0[0] && src1[0] != src2[-1]) || (src1[-1] == src2[0] && src1[0] != src0[-1]) ? src1[-1] : src1[0];
+		dst[1] = src1[0];
+		dst[2] = src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+		dst[2] = src1[0];
+	}
+}
+
+static inline SCALE3X_TARGET_AVX2 void scale3x_32_avx2_border(scale3x_uint32* restrict dst, const scale3x_uint32* restrict src0, const scale3x_uint32* restrict src1, const scale3x_uint32* restrict src2, unsigned count)
+{
+	assert(count >= 2);
+
+	/* first pixel */
+	if (src0[0] != src2[0] && src1[0] != src1[1]) {
+		dst[0] = src1[0];
+		dst[1] = (src1[0] == src0[0] && src1[0] != src0[1]) || (src1[1] == src0[0] && src1[0] != src0[0]) ? src0[0] : src1[0];
+		dst[2] = src1[1] == src0[0] ? src1[1] : src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+		dst[2] = src1[0];
+	}
+	++src0;
+	++src1;
+	++src2;
+	dst += 3;
+	--count;
+
+	/* central pixels */
+	--count;
+	while (count >= 8) {
+		__m256i a = _mm256_loadu_si256((const __m256i*)(src0 - 1));
+		__m256i b = _mm256_loadu_si256((const __m256i*)(src0));
+		__m256i c = _mm256_loadu_si256((const __m256i*)(src0 + 1));
+		__m256i d = _mm256_loadu_si256((const __m256i*)(src1 - 1));
+		__m256i e = _mm256_loadu_si256((const __m256i*)(src1));
+		__m256i f = _mm256_loadu_si256((const __m256i*)(src1 + 1));
+		__m256i h = _mm256_loadu_si256((const __m256i*)(src2));
+		__m256i k, db, fb, m, r0, r1, r2;
+
+		/* k = B != H && D != F */
+		k = _mm256_andnot_si256(_mm256_or_si256(_mm256_cmpeq_epi32(b, h), _mm256_cmpeq_epi32(d, f)), _mm256_set1_epi32(-1));
+		db = _mm256_cmpeq_epi32(d, b);
+		fb = _mm256_cmpeq_epi32(f, b);
+
+		/* r0 = k && D == B ? D : E */
+		m = _mm256_and_si256(k, db);
+		r0 = _mm256_or_si256(_mm256_and_si256(m, d), _mm256_andnot_si256(m, e));
+
+		/* r1 = k && ((D == B && E != C) || (F == B && E != A)) ? B : E */
+		m = _mm256_or_si256(_mm256_andnot_si256(_mm256_cmpeq_epi32(e, c), db), _mm256_andnot_si256(_mm256_cmpeq_epi32(e, a), fb));
+		m = _mm256_and_si256(k, m);
+		r1 = _mm256_or_si256(_mm256_and_si256(m, b), _mm256_andnot_si256(m, e));
+
+		/* r2 = k && F == B ? F : E */
+		m = _mm256_and_si256(k, fb);
+		r2 = _mm256_or_si256(_mm256_and_si256(m, f), _mm256_andnot_si256(m, e));
+
+		scale3x_32_avx2_store(dst, r0, r1, r2);
+
+		src0 += 8;
+		src1 += 8;
+		src2 += 8;
+		dst += 24;
+		count -= 8;
+	}
+
+	while (count) {
+		if (src0[0] != src2[0] && src1[-1] != src1[1]) {
+			dst[0] = src1[-1] == src0[0] ? src1[-1] : src1[0];
+			dst[1] = (src1[-1] == src0[0] && src1[0] != src0[1]) || (src1[1] == src0[0] && src1[0] != src0[-1]) ? src0[0] : src1[0];
+			dst[2] = src1[1] == src0[0] ? src1[1] : src1[0];
+		} else {
+			dst[0] = src1[0];
+			dst[1] = src1[0];
+			dst[2] = src1[0];
+		}
+
+		++src0;
+		++src1;
+		++src2;
+		dst += 3;
+		--count;
+	}
+
+	/* last pixel */
+	if (src0[0] != src2[0] && src1[-1] != src1[0]) {
+		dst[0] = src1[-1] == src0[0] ? src1[-1] : src1[0];
+		dst[1] = (src1[-1] == src0[0] && src1[0] != src0[0]) || (src1[0] == src0[0] && src1[0] != src0[-1]) ? src0[0] : src1[0];
+		dst[2] = src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+		dst[2] = src1[0];
+	}
+}
+
+static inline SCALE3X_TARGET_AVX2 void scale3x_32_avx2_center(scale3x_uint32* restrict dst, const scale3x_uint32* restrict src0, const scale3x_uint32* restrict src1, const scale3x_uint32* restrict src2, unsigned count)
+{
+	assert(count >= 2);
+
+	/* first pixel */
+	if (src0[0] != src2[0] && src1[0] != src1[1]) {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+		dst[2] = (src1[1] == src0[0] && src1[0] != src2[1]) || (src1[1] == src2[0] && src1[0] != src0[1]) ? src1[1] : src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+		dst[2] = src1[0];
+	}
+	++src0;
+	++src1;
+	++src2;
+	dst += 3;
+	--count;
+
+	/* central pixels */
+	--count;
+	while (count >= 8) {
+		__m256i a = _mm256_loadu_si256((const __m256i*)(src0 - 1));
+		__m256i b = _mm256_loadu_si256((const __m256i*)(src0));
+		__m256i c = _mm256_loadu_si256((const __m256i*)(src0 + 1));
+		__m256i d = _mm256_loadu_si256((const __m256i*)(src1 - 1));
+		__m256i e = _mm256_loadu_si256((const __m256i*)(src1));
+		__m256i f = _mm256_loadu_si256((const __m256i*)(src1 + 1));
+		__m256i g = _mm256_loadu_si256((const __m256i*)(src2 - 1));
+		__m256i h = _mm256_loadu_si256((const __m256i*)(src2));
+		__m256i i = _mm256_loadu_si256((const __m256i*)(src2 + 1));
+		__m256i k, m, r0, r2;
+
+		/* k = B != H && D != F */
+		k = _mm256_andnot_si256(_mm256_or_si256(_mm256_cmpeq_epi32(b, h), _mm256_cmpeq_epi32(d, f)), _mm256_set1_epi32(-1));
+
+		/* r0 = k && ((D == B && E != G) || (D == H && E != A)) ? D : E */
+		m = _mm256_or_si256(_mm256_andnot_si256(_mm256_cmpeq_epi32(e, g), _mm256_cmpeq_epi32(d, b)), _mm256_andnot_si256(_mm256_cmpeq_epi32(e, a), _mm256_cmpeq_epi32(d, h)));
+		m = _mm256_and_si256(k, m);
+		r0 = _mm256_or_si256(_mm256_and_si256(m, d), _mm256_andnot_si256(m, e));
+
+		/* r2 = k && ((F == B && E != I) || (F == H && E != C)) ? F : E */
+		m = _mm256_or_si256(_mm256_andnot_si256(_mm256_cmpeq_epi32(e, i), _mm256_cmpeq_epi32(f, b)), _mm256_andnot_si256(_mm256_cmpeq_epi32(e, c), _mm256_cmpeq_epi32(f, h)));
+		m = _mm256_and_si256(k, m);
+		r2 = _mm256_or_si256(_mm256_and_si256(m, f), _mm256_andnot_si256(m, e));
+
+		scale3x_32_avx2_store(dst, r0, e, r2);
+
+		src0 += 8;
+		src1 += 8;
+		src2 += 8;
+		dst += 24;
+		count -= 8;
+	}
+
+	while (count) {
+		if (src0[0] != src2[0] && src1[-1] != src1[1]) {
+			dst[0] = (src1[-1] == src0[0] && src1[0] != src2[-1]) || (src1[-1] == src2[0] && src1[0] != src0[-1]) ? src1[-1] : src1[0];
+			dst[1] = src1[0];
+			dst[2] = (src1[1] == src0[0] && src1[0] != src2[1]) || (src1[1] == src2[0] && src1[0] != src0[1]) ? src1[1] : src1[0];
+		} else {
+			dst[0] = src1[0];
+			dst[1] = src1[0];
+			dst[2] = src1[0];
+		}
+
+		++src0;
+		++src1;
+		++src2;
+		dst += 3;
+		--count;
+	}
+
+	/* last pixel */
+	if (src0[0] != src2[0] && src1[-1] != src1[0]) {
+		dst[0] = (src1[-1] == src0[0] && src1[0] != src2[-1]) || (src1[-1] == src2[0] && src1[0] != src0[-1]) ? src1[-1] : src1[0];
+		dst[1] = src1[0];
+		dst[2] = src1[0];
+	} else {
+		dst[0] = src1[0];
+		dst[1] = src1[0];
+		dst[2] = src1[0];
+	}
+}
+
+/**
+ * Scale by a factor of 3 a row of pixels of 8 bits.
+ * This function operates like scale3x_8_def() but it uses the SSE2
+ * instruction set.
+ */
+void scale3x_8_sse2(scale3x_uint8* dst0, scale3x_uint8* dst1, scale3x_uint8* dst2, const scale3x_uint8* src0, const scale3x_uint8* src1, const scale3x_uint8* src2, unsigned count)
+{
+	scale3x_8_sse2_border(dst0, src0, src1, src2, count);
+	scale3x_8_sse2_center(dst1, src0, src1, src2, count);
+	scale3x_8_sse2_border(dst2, src2, src1, src0, count);
+}
+
+/**
+ * Scale by a factor of 3 a row of pixels of 16 bits.
+ * This function operates like scale3x_8_sse2() but for 16 bits pixels.
+ */
+void scale3x_16_sse2(scale3x_uint16* dst0, scale3x_uint16* dst1, scale3x_uint16* dst2, const scale3x_uint16* src0, const scale3x_uint16* src1, const scale3x_uint16* src2, unsigned count)
+{
+	scale3x_16_sse2_border(dst0, src0, src1, src2, count);
+	scale3x_16_sse2_center(dst1, src0, src1, src2, count);
+	scale3x_16_sse2_border(dst2, src2, src1, src0, count);
+}
+
+/**
+ * Scale by a factor of 3 a row of pixels of 32 bits.
+ * This function operates like scale3x_8_sse2() but for 32 bits pixels.
+ */
+void scale3x_32_sse2(scale3x_uint32* dst0, scale3x_uint32* dst1, scale3x_uint32* dst2, const scale3x_uint32* src0, const scale3x_uint32* src1, const scale3x_uint32* src2, unsigned count)
+{
+	scale3x_32_sse2_border(dst0, src0, src1, src2, count);
+	scale3x_32_sse2_center(dst1, src0, src1, src2, count);
+	scale3x_32_sse2_border(dst2, src2, src1, src0, count);
+}
+
+/**
+ * Scale by a factor of 3 a row of pixels of 8 bits.
+ * This function operates like scale3x_8_def() but it uses the AVX2
+ * instruction set. It must be called only if the processor supports it.
+ */
+SCALE3X_TARGET_AVX2 void scale3x_8_avx2(scale3x_uint8* dst0, scale3x_uint8* dst1, scale3x_uint8* dst2, const scale3x_uint8* src0, const scale3x_uint8* src1, const scale3x_uint8* src2, unsigned count)
+{
+	scale3x_8_avx2_border(dst0, src0, src1, src2, count);
+	scale3x_8_avx2_center(dst1, src0, src1, src2, count);
+	scale3x_8_avx2_border(dst2, src2, src1, src0, count);
+}
+
+/**
+ * Scale by a factor of 3 a row of pixels of 16 bits.
+ * This function operates like scale3x_8_avx2() but for 16 bits pixels.
+ */
+SCALE3X_TARGET_AVX2 void scale3x_16_avx2(scale3x_uint16* dst0, scale3x_uint16* dst1, scale3x_uint16* dst2, const scale3x_uint16* src0, const scale3x_uint16* src1, const scale3x_uint16* src2, unsigned count)
+{
+	scale3x_16_avx2_border(dst0, src0, src1, src2, count);
+	scale3x_16_avx2_center(dst1, src0, src1, src2, count);
+	scale3x_16_avx2_border(dst2, src2, src1, src0, count);
+}
+
+/**
+ * Scale by a factor of 3 a row of pixels of 32 bits.
+ * This function operates like scale3x_8_avx2() but for 32 bits pixels.
+ */
+SCALE3X_TARGET_AVX2 void scale3x_32_avx2(scale3x_uint32* dst0, scale3x_uint32* dst1, scale3x_uint32* dst2, const scale3x_uint32* src0, const scale3x_uint32* src1, const scale3x_uint32* src2, unsigned count)
+{
+	scale3x_32_avx2_border(dst0, src0, src1, src2, count);
+	scale3x_32_avx2_center(dst1, src0, src1, src2, count);
+	scale3x_32_avx2_border(dst2, src2, src1, src0, count);
+}
+
+#endif
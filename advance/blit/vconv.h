@@ -43,6 +43,18 @@ static void video_line_bgra8888tobgr332_step4_asm(const struct video_stage_horz_
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_bgra8888tobgr332_step4_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_convbgra8888tobgr332_sse2(dst, src, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_bgra8888tobgr332_step4_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_convbgra8888tobgr332_avx2(dst, src, count);
+}
+#endif
+
 static void video_line_bgra8888tobgr332_step4_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_convbgra8888tobgr332_def(dst, src, count);
@@ -64,6 +76,18 @@ static void video_line_bgra8888tobgr565_step4_asm(const struct video_stage_horz_
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_bgra8888tobgr565_step4_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_convbgra8888tobgr565_sse2(dst, src, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_bgra8888tobgr565_step4_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_convbgra8888tobgr565_avx2(dst, src, count);
+}
+#endif
+
 static void video_line_bgra8888tobgr565_step4_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_convbgra8888tobgr565_def(dst, src, count);
@@ -85,6 +109,18 @@ static void video_line_bgra8888tobgra5551_step4_asm(const struct video_stage_hor
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_bgra8888tobgra5551_step4_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_convbgra8888tobgra5551_sse2(dst, src, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_bgra8888tobgra5551_step4_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_convbgra8888tobgra5551_avx2(dst, src, count);
+}
+#endif
+
 static void video_line_bgra8888tobgra5551_step4_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_convbgra8888tobgra5551_def(dst, src, count);
@@ -106,6 +142,18 @@ static void video_line_bgra5551tobgr332_step2_asm(const struct video_stage_horz_
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_bgra5551tobgr332_step2_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_convbgra5551tobgr332_sse2(dst, src, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_bgra5551tobgr332_step2_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_convbgra5551tobgr332_avx2(dst, src, count);
+}
+#endif
+
 static void video_line_bgra5551tobgr332_step2_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_convbgra5551tobgr332_def(dst, src, count);
@@ -127,6 +175,18 @@ static void video_line_bgra5551tobgr565_step2_asm(const struct video_stage_horz_
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_bgra5551tobgr565_step2_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_convbgra5551tobgr565_sse2(dst, src, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_bgra5551tobgr565_step2_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_convbgra5551tobgr565_avx2(dst, src, count);
+}
+#endif
+
 static void video_line_bgra5551tobgr565_step2_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_convbgra5551tobgr565_def(dst, src, count);
@@ -148,6 +208,18 @@ static void video_line_bgra5551tobgra8888_step2_asm(const struct video_stage_hor
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_bgra5551tobgra8888_step2_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_convbgra5551tobgra8888_sse2(dst, src, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_bgra5551tobgra8888_step2_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_convbgra5551tobgra8888_avx2(dst, src, count);
+}
+#endif
+
 static void video_line_bgra5551tobgra8888_step2_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_convbgra5551tobgra8888_def(dst, src, count);
@@ -438,10 +510,86 @@ static void video_line_bgra8888toyuy2_step_def(const struct video_stage_horz_str
 	}
 }
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_bgra8888toyuy2_step_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	uint8* src8 = (uint8*)src;
+	uint8* dst8 = (uint8*)dst;
+	int step1 = stage->sdp;
+
+	if (step1 == 4) {
+		internal_convbgra8888toyuy2_sse2(dst8, src8, count);
+		return;
+	}
+
+	while (count) {
+		pixel_convbgra8888toyuy2_def(dst8, src8);
+
+		dst8 += 4;
+		src8 += step1;
+		--count;
+	}
+}
+
+static ASM_TARGET_AVX2 void video_line_bgra8888toyuy2_step_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	if (stage->sdp == 4) {
+		internal_convbgra8888toyuy2_avx2(dst, src, count);
+		return;
+	}
+
+	video_line_bgra8888toyuy2_step_sse2(stage, line, dst, src, count);
+}
+#endif
+
+#if defined(USE_ASM_INLINE)
+static void video_line_bgra8888toyuy2_asm(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	uint8* src8 = (uint8*)src;
+	uint8* dst8 = (uint8*)dst;
+
+	count /= 2;
+
+	while (count) {
+		pixel_convbgra8888toyuy2_asm(dst8, src8, src8 + 4);
+
+		dst8 += 8;
+		src8 += 8;
+		--count;
+	}
+}
+#endif
+
+static void video_line_bgra8888toyuy2_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	uint8* src8 = (uint8*)src;
+	uint8* dst8 = (uint8*)dst;
+
+	while (count) {
+		pixel_convbgra8888toyuy2_def(dst8, src8);
+
+		dst8 += 4;
+		src8 += 4;
+		--count;
+	}
+}
+
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_bgra8888toyuy2_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_convbgra8888toyuy2_sse2(dst, src, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_bgra8888toyuy2_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_convbgra8888toyuy2_avx2(dst, src, count);
+}
+#endif
+
 static void video_stage_bgra8888toyuy2_set(struct video_stage_horz_struct* stage, unsigned sdx, int sdp)
 {
 	STAGE_SIZE(stage, pipe_bgra8888toyuy2, sdx, sdp, 4, sdx, 4);
-	STAGE_PUT(stage, BLITTER(video_line_bgra8888toyuy2_step), BLITTER(video_line_bgra8888toyuy2_step));
+	STAGE_PUT(stage, BLITTER(video_line_bgra8888toyuy2), BLITTER(video_line_bgra8888toyuy2_step));
 }
 
 /****************************************************************************/
@@ -503,16 +651,111 @@ static void video_line_bgra5551toyuy2_step_def(const struct video_stage_horz_str
 	}
 }
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_bgra5551toyuy2_step_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	uint16* src16 = (uint16*)src;
+	uint8* dst8 = (uint8*)dst;
+	int step1 = stage->sdp;
+
+	if (step1 == 2) {
+		internal_convbgra5551toyuy2_sse2(dst8, src16, count);
+		return;
+	}
+
+	while (count) {
+		internal_convbgra5551toyuy2_sse2(dst8, src16, 1);
+
+		dst8 += 4;
+		PADD(src16, step1);
+		--count;
+	}
+}
+
+static ASM_TARGET_AVX2 void video_line_bgra5551toyuy2_step_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	if (stage->sdp == 2) {
+		internal_convbgra5551toyuy2_avx2(dst, src, count);
+		return;
+	}
+
+	video_line_bgra5551toyuy2_step_sse2(stage, line, dst, src, count);
+}
+#endif
+
+#if defined(USE_ASM_INLINE)
+static void video_line_bgra5551toyuy2_asm(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	uint16* src16 = (uint16*)src;
+	uint8* dst8 = (uint8*)dst;
+
+	count /= 2;
+
+	while (count) {
+		uint32 p0;
+		uint32 p1;
+
+		p0 = ((src16[0] << 3) & 0x000000F8)
+			| ((src16[0] << 6) & 0x0000F800)
+			| ((src16[0] << 9) & 0x00F80000);
+
+		p1 = ((src16[1] << 3) & 0x000000F8)
+			| ((src16[1] << 6) & 0x0000F800)
+			| ((src16[1] << 9) & 0x00F80000);
+
+		pixel_convbgra8888toyuy2_asm(dst8, &p0, &p1);
+
+		src16 += 2;
+		dst8 += 8;
+		--count;
+	}
+}
+#endif
+
+static void video_line_bgra5551toyuy2_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	uint16* src16 = (uint16*)src;
+	uint8* dst8 = (uint8*)dst;
+
+	while (count) {
+		unsigned char p4[4];
+
+		cpu_uint32_write(p4,
+			((src16[0] << 3) & 0x000000F8)
+			| ((src16[0] << 6) & 0x0000F800)
+			| ((src16[0] << 9) & 0x00F80000)
+		);
+
+		pixel_convbgra8888toyuy2_def(dst8, p4);
+
+		dst8 += 4;
+		src16 += 1;
+		--count;
+	}
+}
+
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_bgra5551toyuy2_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_convbgra5551toyuy2_sse2(dst, src, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_bgra5551toyuy2_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_convbgra5551toyuy2_avx2(dst, src, count);
+}
+#endif
+
 static void video_stage_bgra5551toyuy2_set(struct video_stage_horz_struct* stage, unsigned sdx, int sdp)
 {
 	STAGE_SIZE(stage, pipe_bgra5551toyuy2, sdx, sdp, 2, sdx, 4);
-	STAGE_PUT(stage, BLITTER(video_line_bgra5551toyuy2_step), BLITTER(video_line_bgra5551toyuy2_step));
+	STAGE_PUT(stage, BLITTER(video_line_bgra5551toyuy2), BLITTER(video_line_bgra5551toyuy2_step));
 }
 
 /****************************************************************************/
 /* rgb to yuy2 */
 
-static void video_line_rgbtoyuy2_step_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+static inline void internal_rgbtoyuy2_def(const struct video_stage_horz_struct* stage, void* dst, const void* src, unsigned count, int sdp)
 {
 	uint8* src8 = (uint8*)src;
 	uint8* dst8 = (uint8*)dst;
@@ -529,24 +772,34 @@ static void video_line_rgbtoyuy2_step_def(const struct video_stage_horz_struct*
 
 		pixel_convbgra8888toyuy2_def(dst8, &p4);
 
-		PADD(src8, stage->sdp);
+		PADD(src8, sdp);
 		dst8 += 4;
 		--count;
 	}
 }
 
+static void video_line_rgbtoyuy2_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgbtoyuy2_def(stage, dst, src, count, stage->ssp);
+}
+
+static void video_line_rgbtoyuy2_step_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgbtoyuy2_def(stage, dst, src, count, stage->sdp);
+}
+
 static void video_stage_rgbtoyuy2_set(struct video_stage_horz_struct* stage, unsigned sdx, int sdp, adv_color_def sdef)
 {
 	adv_color_def ddef = color_def_make_rgb_from_sizelenpos(4, 8, 16, 8, 8, 8, 0);
 	STAGE_SIZE(stage, pipe_rgbtoyuy2, sdx, sdp, color_def_bytes_per_pixel_get(sdef), sdx, 4);
-	STAGE_PUT(stage, video_line_rgbtoyuy2_step_def, video_line_rgbtoyuy2_step_def);
+	STAGE_PUT(stage, video_line_rgbtoyuy2_def, video_line_rgbtoyuy2_step_def);
 	STAGE_CONVERSION(stage, sdef, ddef);
 }
 
 /****************************************************************************/
 /* rgb to rgb */
 
-static void video_line_rgbtorgb_step_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+static inline void internal_rgbtorgb_def(const struct video_stage_horz_struct* stage, void* dst, const void* src, unsigned count, int sdp)
 {
 	uint8* src8 = (uint8*)src;
 	uint8* dst8 = (uint8*)dst;
@@ -562,16 +815,26 @@ static void video_line_rgbtorgb_step_def(const struct video_stage_horz_struct* s
 
 		cpu_uint_write(dst8, stage->dsp, p);
 
-		PADD(src8, stage->sdp);
+		PADD(src8, sdp);
 		PADD(dst8, stage->dsp);
 		--count;
 	}
 }
 
+static void video_line_rgbtorgb_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgbtorgb_def(stage, dst, src, count, stage->ssp);
+}
+
+static void video_line_rgbtorgb_step_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgbtorgb_def(stage, dst, src, count, stage->sdp);
+}
+
 static void video_stage_rgbtorgb_set(struct video_stage_horz_struct* stage, unsigned sdx, int sdp, adv_color_def sdef, adv_color_def ddef)
 {
 	STAGE_SIZE(stage, pipe_rgbtorgb, sdx, sdp, color_def_bytes_per_pixel_get(sdef), sdx, color_def_bytes_per_pixel_get(ddef));
-	STAGE_PUT(stage, video_line_rgbtorgb_step_def, video_line_rgbtorgb_step_def);
+	STAGE_PUT(stage, video_line_rgbtorgb_def, video_line_rgbtorgb_step_def);
 	STAGE_CONVERSION(stage, sdef, ddef);
 }
 
@@ -43,6 +43,18 @@ static void video_line_filter8_step1_asm(const struct video_stage_horz_struct* s
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_filter8_step1_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_mean8_horz_next_step1_sse2(dst, src, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_filter8_step1_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_mean8_horz_next_step1_avx2(dst, src, count);
+}
+#endif
+
 static void video_line_filter8_step1_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_mean8_horz_next_step1_def(dst, src, count);
@@ -69,6 +81,18 @@ static void video_line_filter16_step2_asm(const struct video_stage_horz_struct*
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_filter16_step2_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_mean16_horz_next_step2_sse2(dst, src, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_filter16_step2_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_mean16_horz_next_step2_avx2(dst, src, count);
+}
+#endif
+
 static void video_line_filter16_step2_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_mean16_horz_next_step2_def(dst, src, count);
@@ -95,6 +119,18 @@ static void video_line_filter32_step4_asm(const struct video_stage_horz_struct*
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_filter32_step4_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_mean32_horz_next_step4_sse2(dst, src, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_filter32_step4_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_mean32_horz_next_step4_avx2(dst, src, count);
+}
+#endif
+
 static void video_line_filter32_step4_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_mean32_horz_next_step4_def(dst, src, count);
@@ -152,6 +188,80 @@ static inline void internal_interlacefilter32_step1_asm(unsigned line, uint32* b
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static inline void internal_interlacefilter8_step1_sse2(unsigned line, uint8* buffer, uint8* dst, const uint8* src, unsigned count)
+{
+	if (line == 0) {
+		internal_copy8_sse2(buffer, src, count);
+		internal_copy8_sse2(dst, buffer, count);
+	} else {
+		internal_mean8_vert_self_sse2(buffer, src, count);
+		internal_copy8_sse2(dst, buffer, count);
+		internal_copy8_sse2(buffer, src, count);
+	}
+}
+
+static inline void internal_interlacefilter16_step1_sse2(unsigned line, uint16* buffer, uint16* dst, const uint16* src, unsigned count)
+{
+	if (line == 0) {
+		internal_copy16_sse2(buffer, src, count);
+		internal_copy16_sse2(dst, buffer, count);
+	} else {
+		internal_mean16_vert_self_sse2(buffer, src, count);
+		internal_copy16_sse2(dst, buffer, count);
+		internal_copy16_sse2(buffer, src, count);
+	}
+}
+
+static inline void internal_interlacefilter32_step1_sse2(unsigned line, uint32* buffer, uint32* dst, const uint32* src, unsigned count)
+{
+	if (line == 0) {
+		internal_copy32_sse2(buffer, src, count);
+		internal_copy32_sse2(dst, buffer, count);
+	} else {
+		internal_mean32_vert_self_sse2(buffer, src, count);
+		internal_copy32_sse2(dst, buffer, count);
+		internal_copy32_sse2(buffer, src, count);
+	}
+}
+
+static inline ASM_TARGET_AVX2 void internal_interlacefilter8_step1_avx2(unsigned line, uint8* buffer, uint8* dst, const uint8* src, unsigned count)
+{
+	if (line == 0) {
+		internal_copy8_avx2(buffer, src, count);
+		internal_copy8_avx2(dst, buffer, count);
+	} else {
+		internal_mean8_vert_self_avx2(buffer, src, count);
+		internal_copy8_avx2(dst, buffer, count);
+		internal_copy8_avx2(buffer, src, count);
+	}
+}
+
+static inline ASM_TARGET_AVX2 void internal_interlacefilter16_step1_avx2(unsigned line, uint16* buffer, uint16* dst, const uint16* src, unsigned count)
+{
+	if (line == 0) {
+		internal_copy16_avx2(buffer, src, count);
+		internal_copy16_avx2(dst, buffer, count);
+	} else {
+		internal_mean16_vert_self_avx2(buffer, src, count);
+		internal_copy16_avx2(dst, buffer, count);
+		internal_copy16_avx2(buffer, src, count);
+	}
+}
+
+static inline ASM_TARGET_AVX2 void internal_interlacefilter32_step1_avx2(unsigned line, uint32* buffer, uint32* dst, const uint32* src, unsigned count)
+{
+	if (line == 0) {
+		internal_copy32_avx2(buffer, src, count);
+		internal_copy32_avx2(dst, buffer, count);
+	} else {
+		internal_mean32_vert_self_avx2(buffer, src, count);
+		internal_copy32_avx2(dst, buffer, count);
+		internal_copy32_avx2(buffer, src, count);
+	}
+}
+#endif
+
 static inline void internal_interlacefilter8_step1_def(unsigned line, uint8* buffer, uint8* dst, const uint8* src, unsigned count)
 {
 	if (line == 0) {
@@ -195,6 +305,18 @@ static void video_line_interlacefilter8_step1_asm(const struct video_stage_horz_
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_interlacefilter8_step1_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_interlacefilter8_step1_sse2(line, (uint8*)stage->buffer_extra, (uint8*)dst, (const uint8*)src, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_interlacefilter8_step1_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_interlacefilter8_step1_avx2(line, (uint8*)stage->buffer_extra, (uint8*)dst, (const uint8*)src, count);
+}
+#endif
+
 /****************************************************************************/
 /* interlacefilter8 */
 
@@ -220,6 +342,18 @@ static void video_line_interlacefilter16_step1_asm(const struct video_stage_horz
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_interlacefilter16_step1_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_interlacefilter8_step1_sse2(line, (uint8*)stage->buffer_extra, (uint8*)dst, (const uint8*)src, count * 2);
+}
+
+static ASM_TARGET_AVX2 void video_line_interlacefilter16_step1_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_interlacefilter8_step1_avx2(line, (uint8*)stage->buffer_extra, (uint8*)dst, (const uint8*)src, count * 2);
+}
+#endif
+
 static void video_line_interlacefilter16_step1_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_interlacefilter8_step1_def(line, (uint8*)stage->buffer_extra, (uint8*)dst, (const uint8*)src, count * 2);
@@ -242,6 +376,18 @@ static void video_line_interlacefilter32_step1_asm(const struct video_stage_horz
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_interlacefilter32_step1_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_interlacefilter8_step1_sse2(line, (uint8*)stage->buffer_extra, (uint8*)dst, (const uint8*)src, count * 4);
+}
+
+static ASM_TARGET_AVX2 void video_line_interlacefilter32_step1_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_interlacefilter8_step1_avx2(line, (uint8*)stage->buffer_extra, (uint8*)dst, (const uint8*)src, count * 4);
+}
+#endif
+
 static void video_line_interlacefilter32_step1_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_interlacefilter8_step1_def(line, (uint8*)stage->buffer_extra, (uint8*)dst, (const uint8*)src, count * 4);
@@ -0,0 +1,492 @@
+/*
+ * This file is part of the Advance project.
+ *
+ * Copyright (C) 1999, 2000, 2001, 2002, 2003, 2008 Andrea Mazzoleni
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * In addition, as a special exception, Andrea Mazzoleni
+ * gives permission to link the code of this program with
+ * the MAME library (or with modified versions of MAME that use the
+ * same license as MAME), and distribute linked combinations including
+ * the two.  You must obey the GNU General Public License in all
+ * respects for all of the code used other than MAME.  If you modify
+ * this file, you may extend this exception to your version of the
+ * file, but you are not obligated to do so.  If you do not wish to
+ * do so, delete this exception statement from your version.
+ */
+
+#ifndef __VFUSE_H
+#define __VFUSE_H
+
+#include "blit.h"
+
+/****************************************************************************/
+/* palette stretch */
+
+/*
+ * Palette conversion followed by an horizontal stretch.
+ * The palette is read only one time for every source pixel, and the
+ * converted pixel is written directly in all the destination positions.
+ */
+
+static inline unsigned internal_palette_get(const void* palette, unsigned index, unsigned dbpp)
+{
+	switch (dbpp) {
+	case 1 : return ((const uint8*)palette)[index];
+	case 2 : return ((const uint16*)palette)[index];
+	default : return ((const uint32*)palette)[index];
+	}
+}
+
+static inline void internal_palette_put(void* dst, unsigned color, unsigned dbpp)
+{
+	switch (dbpp) {
+	case 1 : P8DER0(dst) = color; break;
+	case 2 : P16DER0(dst) = color; break;
+	default : P32DER0(dst) = color; break;
+	}
+}
+
+static inline unsigned internal_palette_index(const void* src, unsigned sbpp)
+{
+	if (sbpp == 1)
+		return P8DER0(src);
+	else
+		return P16DER0(src);
+}
+
+/* Stretch with an expansion factor */
+static inline void video_line_palette_stretchx_1x(const struct video_stage_horz_struct* stage, void* dst, const void* src, int sdp, unsigned count, unsigned sbpp, unsigned dbpp)
+{
+	int error = stage->slice.error;
+	unsigned whole = stage->slice.whole;
+	int up = stage->slice.up;
+	int down = stage->slice.down;
+
+	while (count) {
+		unsigned color = internal_palette_get(stage->palette, internal_palette_index(src, sbpp), dbpp);
+		unsigned run = whole;
+		if ((error += up) > 0) {
+			++run;
+			error -= down;
+		}
+		while (run) {
+			internal_palette_put(dst, color, dbpp);
+			PADD(dst, dbpp);
+			--run;
+		}
+		PADD(src, sdp);
+		--count;
+	}
+}
+
+/* Stretch with a reduction factor, only the used source pixels are converted */
+static inline void video_line_palette_stretchx_x1(const struct video_stage_horz_struct* stage, void* dst, const void* src, int sdp, unsigned count, unsigned sbpp, unsigned dbpp)
+{
+	int error = stage->slice.error;
+	unsigned whole = stage->slice.whole;
+	int up = stage->slice.up;
+	int down = stage->slice.down;
+
+	while (count) {
+		unsigned run = whole;
+		internal_palette_put(dst, internal_palette_get(stage->palette, internal_palette_index(src, sbpp), dbpp), dbpp);
+		PADD(dst, dbpp);
+		if ((error += up) > 0) {
+			++run;
+			error -= down;
+		}
+		PADD(src, sdp * (int)run);
+		--count;
+	}
+}
+
+/* Stretch with a double factor */
+static inline void video_line_palette_stretchx_2x(const struct video_stage_horz_struct* stage, void* dst, const void* src, int sdp, unsigned count, unsigned sbpp, unsigned dbpp)
+{
+	while (count) {
+		unsigned color = internal_palette_get(stage->palette, internal_palette_index(src, sbpp), dbpp);
+		internal_palette_put(dst, color, dbpp);
+		PADD(dst, dbpp);
+		internal_palette_put(dst, color, dbpp);
+		PADD(dst, dbpp);
+		PADD(src, sdp);
+		--count;
+	}
+}
+
+#define VIDEO_LINE_PALETTE_STRETCHX(name, type, sbpp, dbpp) \
+	static void video_line_ ## name ## _ ## type ## _step ## sbpp(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count) \
+	{ \
+		video_line_palette_ ## type(stage, dst, src, sbpp, count, sbpp, dbpp); \
+	} \
+	static void video_line_ ## name ## _ ## type(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count) \
+	{ \
+		video_line_palette_ ## type(stage, dst, src, stage->sdp, count, sbpp, dbpp); \
+	}
+
+VIDEO_LINE_PALETTE_STRETCHX(palette8to8, stretchx_1x, 1, 1)
+VIDEO_LINE_PALETTE_STRETCHX(palette8to8, stretchx_x1, 1, 1)
+VIDEO_LINE_PALETTE_STRETCHX(palette8to8, stretchx_2x, 1, 1)
+VIDEO_LINE_PALETTE_STRETCHX(palette8to16, stretchx_1x, 1, 2)
+VIDEO_LINE_PALETTE_STRETCHX(palette8to16, stretchx_x1, 1, 2)
+VIDEO_LINE_PALETTE_STRETCHX(palette8to16, stretchx_2x, 1, 2)
+VIDEO_LINE_PALETTE_STRETCHX(palette8to32, stretchx_1x, 1, 4)
+VIDEO_LINE_PALETTE_STRETCHX(palette8to32, stretchx_x1, 1, 4)
+VIDEO_LINE_PALETTE_STRETCHX(palette8to32, stretchx_2x, 1, 4)
+VIDEO_LINE_PALETTE_STRETCHX(palette16to8, stretchx_1x, 2, 1)
+VIDEO_LINE_PALETTE_STRETCHX(palette16to8, stretchx_x1, 2, 1)
+VIDEO_LINE_PALETTE_STRETCHX(palette16to8, stretchx_2x, 2, 1)
+VIDEO_LINE_PALETTE_STRETCHX(palette16to16, stretchx_1x, 2, 2)
+VIDEO_LINE_PALETTE_STRETCHX(palette16to16, stretchx_x1, 2, 2)
+VIDEO_LINE_PALETTE_STRETCHX(palette16to16, stretchx_2x, 2, 2)
+VIDEO_LINE_PALETTE_STRETCHX(palette16to32, stretchx_1x, 2, 4)
+VIDEO_LINE_PALETTE_STRETCHX(palette16to32, stretchx_x1, 2, 4)
+VIDEO_LINE_PALETTE_STRETCHX(palette16to32, stretchx_2x, 2, 4)
+
+#undef VIDEO_LINE_PALETTE_STRETCHX
+
+/* The 32 bits palette double is vectorized with the gather instruction */
+#define video_line_palette8to32_stretchx_2x_step1_def video_line_palette8to32_stretchx_2x_step1
+#define video_line_palette16to32_stretchx_2x_step2_def video_line_palette16to32_stretchx_2x_step2
+
+#if defined(USE_ASM_INLINE)
+#define video_line_palette8to32_stretchx_2x_step1_asm video_line_palette8to32_stretchx_2x_step1_def
+#define video_line_palette16to32_stretchx_2x_step2_asm video_line_palette16to32_stretchx_2x_step2_def
+#endif
+
+#if defined(USE_ASM_INTRINSIC)
+#define video_line_palette8to32_stretchx_2x_step1_sse2 video_line_palette8to32_stretchx_2x_step1_def
+#define video_line_palette16to32_stretchx_2x_step2_sse2 video_line_palette16to32_stretchx_2x_step2_def
+
+static inline ASM_TARGET_AVX2 void internal_palette32_double_avx2(uint32* dst32, __m256i index, const uint32* palette)
+{
+	__m256i c = _mm256_i32gather_epi32((const int*)palette, index, 4);
+	__m256i lo = _mm256_unpacklo_epi32(c, c);
+	__m256i hi = _mm256_unpackhi_epi32(c, c);
+
+	_mm256_storeu_si256((__m256i*)dst32, _mm256_permute2x128_si256(lo, hi, 0x20));
+	_mm256_storeu_si256((__m256i*)(dst32 + 8), _mm256_permute2x128_si256(lo, hi, 0x31));
+}
+
+static ASM_TARGET_AVX2 void video_line_palette8to32_stretchx_2x_step1_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	const uint32* palette = stage->palette;
+	const uint8* src8 = (const uint8*)src;
+	uint32* dst32 = (uint32*)dst;
+
+	while (count >= 8) {
+		internal_palette32_double_avx2(dst32, _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)src8)), palette);
+		src8 += 8;
+		dst32 += 16;
+		count -= 8;
+	}
+
+	video_line_palette_stretchx_2x(stage, dst32, src8, 1, count, 1, 4);
+}
+
+static ASM_TARGET_AVX2 void video_line_palette16to32_stretchx_2x_step2_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	const uint32* palette = stage->palette;
+	const uint16* src16 = (const uint16*)src;
+	uint32* dst32 = (uint32*)dst;
+
+	while (count >= 8) {
+		internal_palette32_double_avx2(dst32, _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)src16)), palette);
+		src16 += 8;
+		dst32 += 16;
+		count -= 8;
+	}
+
+	video_line_palette_stretchx_2x(stage, dst32, src16, 2, count, 2, 4);
+}
+#endif
+
+/* Check if the stage is a stretch that can be merged with a previous palette stage */
+static adv_bool pipe_is_stretchx(enum video_stage_enum pipe)
+{
+	switch (pipe) {
+	case pipe_x_stretch:
+	case pipe_x_double:
+	case pipe_x_triple:
+	case pipe_x_quadruple:
+	case pipe_x_copy:
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+/*
+ * Merge a palette stage with the following stretch stage.
+ * \return 0 if the two stages cannot be merged.
+ */
+static adv_bool video_stage_palette_stretchx_set(struct video_stage_horz_struct* stage, const struct video_stage_horz_struct* stage_stretch)
+{
+	unsigned type;
+
+	if (!pipe_is_stretchx(stage_stretch->type)
+		|| stage_stretch->sdp != stage_stretch->sbpp
+		|| stage_stretch->sdx != stage->ddx)
+		return 0;
+
+	if (stage_stretch->sdx > stage_stretch->ddx)
+		type = 0; /* reduction */
+	else if (stage_stretch->slice.whole == 2 && stage_stretch->slice.up == 0)
+		type = 2; /* double */
+	else
+		type = 1; /* expansion */
+
+	switch (stage->type) {
+	case pipe_palette8to8 :
+		switch (type) {
+		case 0 : STAGE_PUT(stage, video_line_palette8to8_stretchx_x1_step1, video_line_palette8to8_stretchx_x1); break;
+		case 1 : STAGE_PUT(stage, video_line_palette8to8_stretchx_1x_step1, video_line_palette8to8_stretchx_1x); break;
+		case 2 : STAGE_PUT(stage, video_line_palette8to8_stretchx_2x_step1, video_line_palette8to8_stretchx_2x); break;
+		}
+		break;
+	case pipe_palette8to16 :
+		switch (type) {
+		case 0 : STAGE_PUT(stage, video_line_palette8to16_stretchx_x1_step1, video_line_palette8to16_stretchx_x1); break;
+		case 1 : STAGE_PUT(stage, video_line_palette8to16_stretchx_1x_step1, video_line_palette8to16_stretchx_1x); break;
+		case 2 : STAGE_PUT(stage, video_line_palette8to16_stretchx_2x_step1, video_line_palette8to16_stretchx_2x); break;
+		}
+		break;
+	case pipe_palette8to32 :
+		switch (type) {
+		case 0 : STAGE_PUT(stage, video_line_palette8to32_stretchx_x1_step1, video_line_palette8to32_stretchx_x1); break;
+		case 1 : STAGE_PUT(stage, video_line_palette8to32_stretchx_1x_step1, video_line_palette8to32_stretchx_1x); break;
+		case 2 : STAGE_PUT(stage, BLITTER(video_line_palette8to32_stretchx_2x_step1), video_line_palette8to32_stretchx_2x); break;
+		}
+		break;
+	case pipe_palette16to8 :
+		switch (type) {
+		case 0 : STAGE_PUT(stage, video_line_palette16to8_stretchx_x1_step2, video_line_palette16to8_stretchx_x1); break;
+		case 1 : STAGE_PUT(stage, video_line_palette16to8_stretchx_1x_step2, video_line_palette16to8_stretchx_1x); break;
+		case 2 : STAGE_PUT(stage, video_line_palette16to8_stretchx_2x_step2, video_line_palette16to8_stretchx_2x); break;
+		}
+		break;
+	case pipe_palette16to16 :
+		switch (type) {
+		case 0 : STAGE_PUT(stage, video_line_palette16to16_stretchx_x1_step2, video_line_palette16to16_stretchx_x1); break;
+		case 1 : STAGE_PUT(stage, video_line_palette16to16_stretchx_1x_step2, video_line_palette16to16_stretchx_1x); break;
+		case 2 : STAGE_PUT(stage, video_line_palette16to16_stretchx_2x_step2, video_line_palette16to16_stretchx_2x); break;
+		}
+		break;
+	case pipe_palette16to32 :
+		switch (type) {
+		case 0 : STAGE_PUT(stage, video_line_palette16to32_stretchx_x1_step2, video_line_palette16to32_stretchx_x1); break;
+		case 1 : STAGE_PUT(stage, video_line_palette16to32_stretchx_1x_step2, video_line_palette16to32_stretchx_1x); break;
+		case 2 : STAGE_PUT(stage, BLITTER(video_line_palette16to32_stretchx_2x_step2), video_line_palette16to32_stretchx_2x); break;
+		}
+		break;
+	default :
+		return 0;
+	}
+
+	stage->type = pipe_palette_stretch;
+	stage->ddx = stage_stretch->ddx;
+	stage->slice = stage_stretch->slice;
+	stage->buffer_size = stage_stretch->buffer_size;
+
+	return 1;
+}
+
+/****************************************************************************/
+/* fuse */
+
+/*
+ * Sequence of stages run in blocks of pixels.
+ * Every stage writes the block in a small buffer, which stays in the
+ * processor cache, and the next stage reads it from there.
+ * Only stages which work on every pixel independently, or with a
+ * periodic pattern, like the rgb effects, can be merged.
+ */
+
+/**
+ * Number of source pixels in every block.
+ * It's a multiple of the period of all the rgb masks and of the
+ * vectorized loops, so every block is processed like the full row.
+ */
+#define VIDEO_FUSE_BLOCK 192
+
+/**
+ * Size in bytes of the block buffers.
+ */
+#define VIDEO_FUSE_TILE 4096
+
+static inline void video_line_fuse_step(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, int sdp, video_stage_hook* put, unsigned count)
+{
+	uint8 tile[2][VIDEO_FUSE_TILE] __attribute__((aligned(64)));
+	const struct video_stage_horz_struct* stage_end = stage->fuse_end - 1;
+	unsigned block = stage->fuse_block;
+	int dst_step = block * (stage->ddx / stage->sdx) * stage->dbpp;
+	int src_step = block * sdp;
+
+	while (count) {
+		const struct video_stage_horz_struct* stage_fuse = stage->fuse_begin;
+		unsigned run = count < block ? count : block;
+		unsigned i = 0;
+
+		put(stage_fuse, line, tile[0], src, run);
+		run *= stage_fuse->ddx / stage_fuse->sdx;
+		++stage_fuse;
+
+		while (stage_fuse != stage_end) {
+			stage_fuse->put(stage_fuse, line, tile[i ^ 1], tile[i], run);
+			run *= stage_fuse->ddx / stage_fuse->sdx;
+			i ^= 1;
+			++stage_fuse;
+		}
+
+		stage_fuse->put(stage_fuse, line, dst, tile[i], run);
+
+		if (count <= block)
+			break;
+
+		PADD(dst, dst_step);
+		PADD(src, src_step);
+		count -= block;
+	}
+}
+
+static void video_line_fuse_plain(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	video_line_fuse_step(stage, line, dst, src, stage->sbpp, stage->fuse_begin->put_plain, count);
+}
+
+static void video_line_fuse(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	video_line_fuse_step(stage, line, dst, src, stage->sdp, stage->fuse_begin->put, count);
+}
+
+/*
+ * Return the expansion factor of a stage that can be merged, or 0 if the
+ * stage cannot be merged.
+ */
+static unsigned video_stage_fuse_ratio(const struct video_stage_horz_struct* stage)
+{
+	/* stages with a state */
+	if (stage->buffer_extra_size != 0)
+		return 0;
+
+	switch (stage->type) {
+	case pipe_x_double :
+	case pipe_x_triple :
+	case pipe_x_quadruple :
+	case pipe_palette_stretch :
+		/* only exact multipliers */
+		if (stage->sdx < stage->ddx && stage->slice.up == 0)
+			return stage->slice.whole;
+		if (stage->sdx == stage->ddx)
+			return 1;
+		return 0;
+	case pipe_x_copy :
+	case pipe_rotation :
+	case pipe_x_rgb_triad3pix :
+	case pipe_x_rgb_triad6pix :
+	case pipe_x_rgb_triad16pix :
+	case pipe_x_rgb_triadstrong3pix :
+	case pipe_x_rgb_triadstrong6pix :
+	case pipe_x_rgb_triadstrong16pix :
+	case pipe_x_rgb_scandoublehorz :
+	case pipe_x_rgb_scantriplehorz :
+	case pipe_x_rgb_scandoublevert :
+	case pipe_x_rgb_scantriplevert :
+	case pipe_palette8to8 :
+	case pipe_palette8to16 :
+	case pipe_palette8to32 :
+	case pipe_palette16to8 :
+	case pipe_palette16to16 :
+	case pipe_palette16to32 :
+	case pipe_imm16to8 :
+	case pipe_imm16to32 :
+	case pipe_bgra8888tobgr332 :
+	case pipe_bgra8888tobgra5551 :
+	case pipe_bgra8888tobgr565 :
+	case pipe_bgra8888toyuy2 :
+	case pipe_bgra5551tobgr332 :
+	case pipe_bgra5551tobgr565 :
+	case pipe_bgra5551tobgra8888 :
+	case pipe_bgra5551toyuy2 :
+	case pipe_rgb888tobgra8888 :
+	case pipe_rgba8888tobgra8888 :
+	case pipe_bgr888tobgra8888 :
+	case pipe_rgbtorgb :
+	case pipe_rgbtoyuy2 :
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+/*
+ * Merge the stages from stage_begin to stage_end in a single stage.
+ * The merged stages are copied in the specified array.
+ * \return 0 if the stages cannot be merged.
+ */
+static adv_bool video_stage_fuse_set(struct video_stage_horz_struct* stage, struct video_stage_horz_struct* stage_map, const struct video_stage_horz_struct* stage_begin, const struct video_stage_horz_struct* stage_end)
+{
+	const struct video_stage_horz_struct* i;
+	struct video_stage_horz_struct* j;
+	unsigned ratio;
+	unsigned size;
+
+	/* if the intermediate rows are so small to fit in the block buffers, */
+	/* they already stay in the cache, and the merge only adds overhead */
+	size = 0;
+	for (i = stage_begin; i != stage_end - 1; ++i)
+		size += i->buffer_size;
+	if (size <= VIDEO_FUSE_TILE)
+		return 0;
+
+	ratio = 1;
+	for (i = stage_begin; i != stage_end; ++i) {
+		unsigned r = video_stage_fuse_ratio(i);
+		if (r == 0)
+			return 0;
+		/* only the first stage can have a not standard pixel step */
+		if (i != stage_begin && i->sdp != i->sbpp)
+			return 0;
+		ratio *= r;
+		/* the block must fit in the buffers */
+		if (VIDEO_FUSE_BLOCK * ratio * i->dbpp > VIDEO_FUSE_TILE)
+			return 0;
+	}
+
+	memcpy(stage_map, stage_begin, (stage_end - stage_begin) * sizeof(struct video_stage_horz_struct));
+	for (j = stage_map; j != stage_map + (stage_end - stage_begin); ++j) {
+		/* the merged stages use the block buffers */
+		j->buffer = 0;
+		j->buffer_size = 0;
+	}
+
+	*stage = *stage_begin;
+	stage->type = pipe_fuse;
+	stage->ddx = stage_end[-1].ddx;
+	stage->dbpp = stage_end[-1].dbpp;
+	slice_set(&stage->slice, stage->sdx, stage->ddx);
+	stage->buffer_size = stage_end[-1].buffer_size;
+	stage->buffer_extra_size = 0;
+	stage->fuse_begin = stage_map;
+	stage->fuse_end = stage_map + (stage_end - stage_begin);
+	stage->fuse_block = VIDEO_FUSE_BLOCK;
+	STAGE_PUT(stage, video_line_fuse_plain, video_line_fuse);
+
+	return 1;
+}
+
+#endif
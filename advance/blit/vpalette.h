@@ -145,6 +145,7 @@ static void video_line_palette8to16_step1_def(const struct video_stage_horz_stru
 	const uint16* palette = stage->palette;
 	uint8* src8 = (uint8*)src;
 	uint32* dst32 = (uint32*)dst;
+	unsigned rest = count % 2;
 
 	count /= 2;
 
@@ -153,8 +154,36 @@ static void video_line_palette8to16_step1_def(const struct video_stage_horz_stru
 		src8 += 2;
 		--count;
 	}
+
+	if (rest)
+		*(uint16*)dst32 = palette[src8[0]];
+}
+
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_palette8to16_step1_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	const uint16* palette = stage->palette;
+	const uint8* src8 = (const uint8*)src;
+	uint16* dst16 = (uint16*)dst;
+
+	while (count >= 8) {
+		__m128i v0 = _mm_setr_epi16(palette[src8[0]], palette[src8[1]], palette[src8[2]], palette[src8[3]], palette[src8[4]], palette[src8[5]], palette[src8[6]], palette[src8[7]]);
+		_mm_storeu_si128((__m128i*)dst16, v0);
+		src8 += 8;
+		dst16 += 8;
+		count -= 8;
+	}
+
+	while (count) {
+		*dst16++ = palette[*src8++];
+		--count;
+	}
 }
 
+/* A 32 bits gather would read outside the 16 bits palette, use the SSE2 version */
+#define video_line_palette8to16_step1_avx2 video_line_palette8to16_step1_sse2
+#endif
+
 static void video_line_palette8to16(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	int step1 = stage->sdp;
@@ -162,6 +191,7 @@ static void video_line_palette8to16(const struct video_stage_horz_struct* stage,
 	const uint16* palette = stage->palette;
 	uint8* src8 = (uint8*)src;
 	uint32* dst32 = (uint32*)dst;
+	unsigned rest = count % 2;
 
 	count /= 2;
 
@@ -170,6 +200,9 @@ static void video_line_palette8to16(const struct video_stage_horz_struct* stage,
 		src8 += step2;
 		--count;
 	}
+
+	if (rest)
+		*(uint16*)dst32 = palette[src8[0]];
 }
 
 static void video_stage_palette8to16_set(struct video_stage_horz_struct* stage, unsigned sdx, int sdp, const uint16* palette)
@@ -328,6 +361,7 @@ static void video_line_palette16to8_step2_def(const struct video_stage_horz_stru
 	const uint8* palette = stage->palette;
 	uint16* src16 = (uint16*)src;
 	uint32* dst32 = (uint32*)dst;
+	unsigned rest = count % 4;
 
 	count /= 4;
 
@@ -336,8 +370,49 @@ static void video_line_palette16to8_step2_def(const struct video_stage_horz_stru
 		src16 += 4;
 		--count;
 	}
+
+	if (rest) {
+		uint8* dst8 = (uint8*)dst32;
+		do {
+			*dst8 = palette[src16[0]];
+			++src16;
+			++dst8;
+			--rest;
+		} while (rest);
+	}
+}
+
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_palette16to8_step2_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	const uint8* palette = stage->palette;
+	const uint16* src16 = (const uint16*)src;
+	uint8* dst8 = (uint8*)dst;
+
+	while (count >= 16) {
+		__m128i v0 = _mm_setr_epi8(
+			palette[src16[0]], palette[src16[1]], palette[src16[2]], palette[src16[3]],
+			palette[src16[4]], palette[src16[5]], palette[src16[6]], palette[src16[7]],
+			palette[src16[8]], palette[src16[9]], palette[src16[10]], palette[src16[11]],
+			palette[src16[12]], palette[src16[13]], palette[src16[14]], palette[src16[15]]
+		);
+		src16 += 16;
+
+		_mm_storeu_si128((__m128i*)dst8, v0);
+		dst8 += 16;
+		count -= 16;
+	}
+
+	while (count) {
+		*dst8++ = palette[*src16++];
+		--count;
+	}
 }
 
+/* A 32 bits gather isn't faster for 8 bits results, use the SSE2 version */
+#define video_line_palette16to8_step2_avx2 video_line_palette16to8_step2_sse2
+#endif
+
 #if defined(USE_ASM_INLINE)
 static void video_line_palette16to8_asm(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
@@ -465,6 +540,7 @@ static void video_line_palette16to8_def(const struct video_stage_horz_struct* st
 	int step4 = step3 + step1;
 	const uint8* palette = stage->palette;
 	uint32* dst32 = (uint32*)dst;
+	unsigned rest = count % 4;
 
 	count /= 4;
 
@@ -473,8 +549,49 @@ static void video_line_palette16to8_def(const struct video_stage_horz_struct* st
 		PADD(src, step4);
 		--count;
 	}
+
+	if (rest) {
+		uint8* dst8 = (uint8*)dst32;
+		do {
+			*dst8 = palette[P16DER0(src)];
+			PADD(src, step1);
+			++dst8;
+			--rest;
+		} while (rest);
+	}
 }
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_palette16to8_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	int step1 = stage->sdp;
+	const uint8* palette = stage->palette;
+	uint8* dst8 = (uint8*)dst;
+
+	while (count >= 16) {
+		__m128i v0 = _mm_setr_epi8(
+			palette[P16DER(src, 0)], palette[P16DER(src, step1)], palette[P16DER(src, 2 * step1)], palette[P16DER(src, 3 * step1)],
+			palette[P16DER(src, 4 * step1)], palette[P16DER(src, 5 * step1)], palette[P16DER(src, 6 * step1)], palette[P16DER(src, 7 * step1)],
+			palette[P16DER(src, 8 * step1)], palette[P16DER(src, 9 * step1)], palette[P16DER(src, 10 * step1)], palette[P16DER(src, 11 * step1)],
+			palette[P16DER(src, 12 * step1)], palette[P16DER(src, 13 * step1)], palette[P16DER(src, 14 * step1)], palette[P16DER(src, 15 * step1)]
+		);
+		PADD(src, 16 * step1);
+
+		_mm_storeu_si128((__m128i*)dst8, v0);
+		dst8 += 16;
+		count -= 16;
+	}
+
+	while (count) {
+		*dst8++ = palette[P16DER0(src)];
+		PADD(src, step1);
+		--count;
+	}
+}
+
+#define video_line_palette16to8_avx2 video_line_palette16to8_sse2
+#endif
+
 static void video_stage_palette16to8_set(struct video_stage_horz_struct* stage, unsigned sdx, int sdp, const uint8* palette)
 {
 	STAGE_SIZE(stage, pipe_palette16to8, sdx, sdp, 2, sdx, 1);
@@ -559,6 +676,7 @@ static void video_line_palette16to16_step2_def(const struct video_stage_horz_str
 	const uint16* palette = stage->palette;
 	uint16* src16 = (uint16*)src;
 	uint32* dst32 = (uint32*)dst;
+	unsigned rest = count % 2;
 
 	count /= 2;
 
@@ -567,8 +685,36 @@ static void video_line_palette16to16_step2_def(const struct video_stage_horz_str
 		src16 += 2;
 		--count;
 	}
+
+	if (rest)
+		*(uint16*)dst32 = palette[src16[0]];
+}
+
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_palette16to16_step2_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	const uint16* palette = stage->palette;
+	const uint16* src16 = (const uint16*)src;
+	uint16* dst16 = (uint16*)dst;
+
+	while (count >= 8) {
+		__m128i v0 = _mm_setr_epi16(palette[src16[0]], palette[src16[1]], palette[src16[2]], palette[src16[3]], palette[src16[4]], palette[src16[5]], palette[src16[6]], palette[src16[7]]);
+		_mm_storeu_si128((__m128i*)dst16, v0);
+		src16 += 8;
+		dst16 += 8;
+		count -= 8;
+	}
+
+	while (count) {
+		*dst16++ = palette[*src16++];
+		--count;
+	}
 }
 
+/* A 32 bits gather would read outside the 16 bits palette, use the SSE2 version */
+#define video_line_palette16to16_step2_avx2 video_line_palette16to16_step2_sse2
+#endif
+
 #if defined(USE_ASM_INLINE)
 static void video_line_palette16to16_asm(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
@@ -651,6 +797,7 @@ static void video_line_palette16to16_def(const struct video_stage_horz_struct* s
 	int step2 = step1 + step1;
 	const uint16* palette = stage->palette;
 	uint32* dst32 = (uint32*)dst;
+	unsigned rest = count % 2;
 
 	count /= 2;
 
@@ -659,8 +806,36 @@ static void video_line_palette16to16_def(const struct video_stage_horz_struct* s
 		PADD(src, step2);
 		--count;
 	}
+
+	if (rest)
+		*(uint16*)dst32 = palette[P16DER0(src)];
+}
+
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_palette16to16_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	int step1 = stage->sdp;
+	const uint16* palette = stage->palette;
+	uint16* dst16 = (uint16*)dst;
+
+	while (count >= 8) {
+		__m128i v0 = _mm_setr_epi16(palette[P16DER0(src)], palette[P16DER(src, step1)], palette[P16DER(src, 2 * step1)], palette[P16DER(src, 3 * step1)], palette[P16DER(src, 4 * step1)], palette[P16DER(src, 5 * step1)], palette[P16DER(src, 6 * step1)], palette[P16DER(src, 7 * step1)]);
+		_mm_storeu_si128((__m128i*)dst16, v0);
+		PADD(src, 8 * step1);
+		dst16 += 8;
+		count -= 8;
+	}
+
+	while (count) {
+		*dst16++ = palette[P16DER0(src)];
+		PADD(src, step1);
+		--count;
+	}
 }
 
+#define video_line_palette16to16_avx2 video_line_palette16to16_sse2
+#endif
+
 static void video_stage_palette16to16_set(struct video_stage_horz_struct* stage, unsigned sdx, int sdp, const uint16* palette)
 {
 	STAGE_SIZE(stage, pipe_palette16to16, sdx, sdp, 2, sdx, 2);
@@ -731,6 +906,46 @@ static void video_line_palette16to32_step2_def(const struct video_stage_horz_str
 	}
 }
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_palette16to32_step2_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	const uint32* palette = stage->palette;
+	const uint16* src16 = (const uint16*)src;
+	uint32* dst32 = (uint32*)dst;
+
+	while (count >= 4) {
+		__m128i v0 = _mm_setr_epi32(palette[src16[0]], palette[src16[1]], palette[src16[2]], palette[src16[3]]);
+		_mm_storeu_si128((__m128i*)dst32, v0);
+		src16 += 4;
+		dst32 += 4;
+		count -= 4;
+	}
+
+	while (count) {
+		*dst32++ = palette[*src16++];
+		--count;
+	}
+}
+
+static ASM_TARGET_AVX2 void video_line_palette16to32_step2_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	const uint32* palette = stage->palette;
+	const uint16* src16 = (const uint16*)src;
+	uint32* dst32 = (uint32*)dst;
+
+	while (count >= 8) {
+		__m256i index = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)src16));
+		__m256i v0 = _mm256_i32gather_epi32((const int*)palette, index, 4);
+		_mm256_storeu_si256((__m256i*)dst32, v0);
+		src16 += 8;
+		dst32 += 8;
+		count -= 8;
+	}
+
+	video_line_palette16to32_step2_sse2(stage, line, dst32, src16, count);
+}
+#endif
+
 #if defined(USE_ASM_INLINE)
 static void video_line_palette16to32_asm(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
@@ -794,6 +1009,31 @@ static void video_line_palette16to32_def(const struct video_stage_horz_struct* s
 	}
 }
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_palette16to32_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	int step1 = stage->sdp;
+	const uint32* palette = stage->palette;
+	uint32* dst32 = (uint32*)dst;
+
+	while (count >= 4) {
+		__m128i v0 = _mm_setr_epi32(palette[P16DER0(src)], palette[P16DER(src, step1)], palette[P16DER(src, 2 * step1)], palette[P16DER(src, 3 * step1)]);
+		_mm_storeu_si128((__m128i*)dst32, v0);
+		PADD(src, 4 * step1);
+		dst32 += 4;
+		count -= 4;
+	}
+
+	while (count) {
+		*dst32++ = palette[P16DER0(src)];
+		PADD(src, step1);
+		--count;
+	}
+}
+
+#define video_line_palette16to32_avx2 video_line_palette16to32_sse2
+#endif
+
 static void video_stage_palette16to32_set(struct video_stage_horz_struct* stage, unsigned sdx, int sdp, const uint32* palette)
 {
 	STAGE_SIZE(stage, pipe_palette16to32, sdx, sdp, 2, sdx, 4);
@@ -43,6 +43,18 @@ static void video_line_rgb_triad16pix8_step1_asm(const struct video_stage_horz_s
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_rgb_triad16pix8_step1_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triad16pix8_sse2(line, dst, src, stage->data, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_rgb_triad16pix8_step1_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triad16pix8_avx2(line, dst, src, stage->data, count);
+}
+#endif
+
 static void video_line_rgb_triad16pix8_step1_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_rgb_triad16pix8_def(line, dst, src, stage->data, count);
@@ -65,6 +77,18 @@ static void video_line_rgb_triad16pix16_step2_asm(const struct video_stage_horz_
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_rgb_triad16pix16_step2_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triad16pix16_sse2(line, dst, src, stage->data, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_rgb_triad16pix16_step2_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triad16pix16_avx2(line, dst, src, stage->data, count);
+}
+#endif
+
 static void video_line_rgb_triad16pix16_step2_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_rgb_triad16pix16_def(line, dst, src, stage->data, count);
@@ -87,6 +111,18 @@ static void video_line_rgb_triad16pix32_step4_asm(const struct video_stage_horz_
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_rgb_triad16pix32_step4_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triad16pix32_sse2(line, dst, src, stage->data, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_rgb_triad16pix32_step4_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triad16pix32_avx2(line, dst, src, stage->data, count);
+}
+#endif
+
 static void video_line_rgb_triad16pix32_step4_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_rgb_triad16pix32_def(line, dst, src, stage->data, count);
@@ -109,6 +145,18 @@ static void video_line_rgb_triad6pix8_step1_asm(const struct video_stage_horz_st
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_rgb_triad6pix8_step1_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triad6pix8_sse2(line, dst, src, stage->data, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_rgb_triad6pix8_step1_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triad6pix8_avx2(line, dst, src, stage->data, count);
+}
+#endif
+
 static void video_line_rgb_triad6pix8_step1_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_rgb_triad6pix8_def(line, dst, src, stage->data, count);
@@ -131,6 +179,18 @@ static void video_line_rgb_triad6pix16_step2_asm(const struct video_stage_horz_s
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_rgb_triad6pix16_step2_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triad6pix16_sse2(line, dst, src, stage->data, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_rgb_triad6pix16_step2_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triad6pix16_avx2(line, dst, src, stage->data, count);
+}
+#endif
+
 static void video_line_rgb_triad6pix16_step2_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_rgb_triad6pix16_def(line, dst, src, stage->data, count);
@@ -153,6 +213,18 @@ static void video_line_rgb_triad6pix32_step4_asm(const struct video_stage_horz_s
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_rgb_triad6pix32_step4_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triad6pix32_sse2(line, dst, src, stage->data, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_rgb_triad6pix32_step4_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triad6pix32_avx2(line, dst, src, stage->data, count);
+}
+#endif
+
 static void video_line_rgb_triad6pix32_step4_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_rgb_triad6pix32_def(line, dst, src, stage->data, count);
@@ -175,6 +247,18 @@ static void video_line_rgb_triad3pix8_step1_asm(const struct video_stage_horz_st
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_rgb_triad3pix8_step1_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triad3pix8_sse2(line, dst, src, stage->data, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_rgb_triad3pix8_step1_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triad3pix8_avx2(line, dst, src, stage->data, count);
+}
+#endif
+
 static void video_line_rgb_triad3pix8_step1_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_rgb_triad3pix8_def(line, dst, src, stage->data, count);
@@ -197,6 +281,18 @@ static void video_line_rgb_triad3pix16_step2_asm(const struct video_stage_horz_s
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_rgb_triad3pix16_step2_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triad3pix16_sse2(line, dst, src, stage->data, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_rgb_triad3pix16_step2_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triad3pix16_avx2(line, dst, src, stage->data, count);
+}
+#endif
+
 static void video_line_rgb_triad3pix16_step2_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_rgb_triad3pix16_def(line, dst, src, stage->data, count);
@@ -219,6 +315,18 @@ static void video_line_rgb_triad3pix32_step4_asm(const struct video_stage_horz_s
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_rgb_triad3pix32_step4_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triad3pix32_sse2(line, dst, src, stage->data, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_rgb_triad3pix32_step4_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triad3pix32_avx2(line, dst, src, stage->data, count);
+}
+#endif
+
 static void video_line_rgb_triad3pix32_step4_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_rgb_triad3pix32_def(line, dst, src, stage->data, count);
@@ -241,6 +349,18 @@ static void video_line_rgb_triadstrong16pix8_step1_asm(const struct video_stage_
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_rgb_triadstrong16pix8_step1_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triadstrong16pix8_sse2(line, dst, src, stage->data, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_rgb_triadstrong16pix8_step1_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triadstrong16pix8_avx2(line, dst, src, stage->data, count);
+}
+#endif
+
 static void video_line_rgb_triadstrong16pix8_step1_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_rgb_triadstrong16pix8_def(line, dst, src, stage->data, count);
@@ -263,6 +383,18 @@ static void video_line_rgb_triadstrong16pix16_step2_asm(const struct video_stage
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_rgb_triadstrong16pix16_step2_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triadstrong16pix16_sse2(line, dst, src, stage->data, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_rgb_triadstrong16pix16_step2_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triadstrong16pix16_avx2(line, dst, src, stage->data, count);
+}
+#endif
+
 static void video_line_rgb_triadstrong16pix16_step2_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_rgb_triadstrong16pix16_def(line, dst, src, stage->data, count);
@@ -285,6 +417,18 @@ static void video_line_rgb_triadstrong16pix32_step4_asm(const struct video_stage
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_rgb_triadstrong16pix32_step4_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triadstrong16pix32_sse2(line, dst, src, stage->data, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_rgb_triadstrong16pix32_step4_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triadstrong16pix32_avx2(line, dst, src, stage->data, count);
+}
+#endif
+
 static void video_line_rgb_triadstrong16pix32_step4_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_rgb_triadstrong16pix32_def(line, dst, src, stage->data, count);
@@ -307,6 +451,18 @@ static void video_line_rgb_triadstrong6pix8_step1_asm(const struct video_stage_h
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_rgb_triadstrong6pix8_step1_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triadstrong6pix8_sse2(line, dst, src, stage->data, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_rgb_triadstrong6pix8_step1_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triadstrong6pix8_avx2(line, dst, src, stage->data, count);
+}
+#endif
+
 static void video_line_rgb_triadstrong6pix8_step1_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_rgb_triadstrong6pix8_def(line, dst, src, stage->data, count);
@@ -329,6 +485,18 @@ static void video_line_rgb_triadstrong6pix16_step2_asm(const struct video_stage_
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_rgb_triadstrong6pix16_step2_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triadstrong6pix16_sse2(line, dst, src, stage->data, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_rgb_triadstrong6pix16_step2_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triadstrong6pix16_avx2(line, dst, src, stage->data, count);
+}
+#endif
+
 static void video_line_rgb_triadstrong6pix16_step2_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_rgb_triadstrong6pix16_def(line, dst, src, stage->data, count);
@@ -351,6 +519,18 @@ static void video_line_rgb_triadstrong6pix32_step4_asm(const struct video_stage_
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_rgb_triadstrong6pix32_step4_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triadstrong6pix32_sse2(line, dst, src, stage->data, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_rgb_triadstrong6pix32_step4_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triadstrong6pix32_avx2(line, dst, src, stage->data, count);
+}
+#endif
+
 static void video_line_rgb_triadstrong6pix32_step4_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_rgb_triadstrong6pix32_def(line, dst, src, stage->data, count);
@@ -373,6 +553,18 @@ static void video_line_rgb_triadstrong3pix8_step1_asm(const struct video_stage_h
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_rgb_triadstrong3pix8_step1_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triadstrong3pix8_sse2(line, dst, src, stage->data, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_rgb_triadstrong3pix8_step1_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triadstrong3pix8_avx2(line, dst, src, stage->data, count);
+}
+#endif
+
 static void video_line_rgb_triadstrong3pix8_step1_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_rgb_triadstrong3pix8_def(line, dst, src, stage->data, count);
@@ -395,6 +587,18 @@ static void video_line_rgb_triadstrong3pix16_step2_asm(const struct video_stage_
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_rgb_triadstrong3pix16_step2_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triadstrong3pix16_sse2(line, dst, src, stage->data, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_rgb_triadstrong3pix16_step2_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triadstrong3pix16_avx2(line, dst, src, stage->data, count);
+}
+#endif
+
 static void video_line_rgb_triadstrong3pix16_step2_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_rgb_triadstrong3pix16_def(line, dst, src, stage->data, count);
@@ -417,6 +621,18 @@ static void video_line_rgb_triadstrong3pix32_step4_asm(const struct video_stage_
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_rgb_triadstrong3pix32_step4_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triadstrong3pix32_sse2(line, dst, src, stage->data, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_rgb_triadstrong3pix32_step4_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_triadstrong3pix32_avx2(line, dst, src, stage->data, count);
+}
+#endif
+
 static void video_line_rgb_triadstrong3pix32_step4_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_rgb_triadstrong3pix32_def(line, dst, src, stage->data, count);
@@ -439,6 +655,18 @@ static void video_line_rgb_scandouble8_step1_asm(const struct video_stage_horz_s
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_rgb_scandouble8_step1_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_scandouble8_sse2(line, dst, src, stage->data, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_rgb_scandouble8_step1_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_scandouble8_avx2(line, dst, src, stage->data, count);
+}
+#endif
+
 static void video_line_rgb_scandouble8_step1_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_rgb_scandouble8_def(line, dst, src, stage->data, count);
@@ -461,6 +689,18 @@ static void video_line_rgb_scandouble16_step2_asm(const struct video_stage_horz_
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_rgb_scandouble16_step2_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_scandouble16_sse2(line, dst, src, stage->data, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_rgb_scandouble16_step2_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_scandouble16_avx2(line, dst, src, stage->data, count);
+}
+#endif
+
 static void video_line_rgb_scandouble16_step2_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_rgb_scandouble16_def(line, dst, src, stage->data, count);
@@ -483,6 +723,18 @@ static void video_line_rgb_scandouble32_step4_asm(const struct video_stage_horz_
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_rgb_scandouble32_step4_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_scandouble32_sse2(line, dst, src, stage->data, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_rgb_scandouble32_step4_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_scandouble32_avx2(line, dst, src, stage->data, count);
+}
+#endif
+
 static void video_line_rgb_scandouble32_step4_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_rgb_scandouble32_def(line, dst, src, stage->data, count);
@@ -505,6 +757,18 @@ static void video_line_rgb_scandoublevert8_step1_asm(const struct video_stage_ho
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_rgb_scandoublevert8_step1_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_scandoublevert8_sse2(dst, src, stage->data, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_rgb_scandoublevert8_step1_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_scandoublevert8_avx2(dst, src, stage->data, count);
+}
+#endif
+
 static void video_line_rgb_scandoublevert8_step1_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_rgb_scandoublevert8_def(dst, src, stage->data, count);
@@ -527,6 +791,18 @@ static void video_line_rgb_scandoublevert16_step2_asm(const struct video_stage_h
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_rgb_scandoublevert16_step2_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_scandoublevert16_sse2(dst, src, stage->data, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_rgb_scandoublevert16_step2_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_scandoublevert16_avx2(dst, src, stage->data, count);
+}
+#endif
+
 static void video_line_rgb_scandoublevert16_step2_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_rgb_scandoublevert16_def(dst, src, stage->data, count);
@@ -549,6 +825,18 @@ static void video_line_rgb_scandoublevert32_step4_asm(const struct video_stage_h
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_rgb_scandoublevert32_step4_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_scandoublevert32_sse2(dst, src, stage->data, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_rgb_scandoublevert32_step4_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_scandoublevert32_avx2(dst, src, stage->data, count);
+}
+#endif
+
 static void video_line_rgb_scandoublevert32_step4_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_rgb_scandoublevert32_def(dst, src, stage->data, count);
@@ -571,6 +859,18 @@ static void video_line_rgb_scantriple8_step1_asm(const struct video_stage_horz_s
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_rgb_scantriple8_step1_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_scantriple8_sse2(line, dst, src, stage->data, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_rgb_scantriple8_step1_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_scantriple8_avx2(line, dst, src, stage->data, count);
+}
+#endif
+
 static void video_line_rgb_scantriple8_step1_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_rgb_scantriple8_def(line, dst, src, stage->data, count);
@@ -593,6 +893,18 @@ static void video_line_rgb_scantriple16_step2_asm(const struct video_stage_horz_
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_rgb_scantriple16_step2_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_scantriple16_sse2(line, dst, src, stage->data, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_rgb_scantriple16_step2_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_scantriple16_avx2(line, dst, src, stage->data, count);
+}
+#endif
+
 static void video_line_rgb_scantriple16_step2_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_rgb_scantriple16_def(line, dst, src, stage->data, count);
@@ -615,6 +927,18 @@ static void video_line_rgb_scantriple32_step4_asm(const struct video_stage_horz_
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_rgb_scantriple32_step4_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_scantriple32_sse2(line, dst, src, stage->data, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_rgb_scantriple32_step4_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_scantriple32_avx2(line, dst, src, stage->data, count);
+}
+#endif
+
 static void video_line_rgb_scantriple32_step4_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_rgb_scantriple32_def(line, dst, src, stage->data, count);
@@ -637,6 +961,18 @@ static void video_line_rgb_scantriplevert8_step1_asm(const struct video_stage_ho
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_rgb_scantriplevert8_step1_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_scantriplevert8_sse2(dst, src, stage->data, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_rgb_scantriplevert8_step1_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_scantriplevert8_avx2(dst, src, stage->data, count);
+}
+#endif
+
 static void video_line_rgb_scantriplevert8_step1_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_rgb_scantriplevert8_def(dst, src, stage->data, count);
@@ -659,6 +995,18 @@ static void video_line_rgb_scantriplevert16_step2_asm(const struct video_stage_h
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_rgb_scantriplevert16_step2_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_scantriplevert16_sse2(dst, src, stage->data, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_rgb_scantriplevert16_step2_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_scantriplevert16_avx2(dst, src, stage->data, count);
+}
+#endif
+
 static void video_line_rgb_scantriplevert16_step2_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_rgb_scantriplevert16_def(dst, src, stage->data, count);
@@ -681,6 +1029,18 @@ static void video_line_rgb_scantriplevert32_step4_asm(const struct video_stage_h
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_rgb_scantriplevert32_step4_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_scantriplevert32_sse2(dst, src, stage->data, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_rgb_scantriplevert32_step4_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_rgb_scantriplevert32_avx2(dst, src, stage->data, count);
+}
+#endif
+
 static void video_line_rgb_scantriplevert32_step4_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_rgb_scantriplevert32_def(dst, src, stage->data, count);
@@ -72,5 +72,287 @@ static void video_stage_rot32_set(struct video_stage_horz_struct* stage, unsigne
 		stage->put = BLITTER(video_line_stretchx32_11);
 }
 
+/****************************************************************************/
+/* transpose */
+
+/*
+ * The rotation of a game reads the source bitmap by columns, touching a
+ * different cache line, and possibly a different memory page, for every pixel.
+ * The transpose reads the source bitmap in strips of adjacent columns, using
+ * more pixels of every cache line read, and stores the rotated rows in a buffer
+ * which the rest of the pipeline reads as a plain image.
+ */
+
+/* Number of rows of the rotated image computed together */
+#define VIDEO_ROT_STRIP 8
+
+/*
+ * Transpose a part of the image.
+ * The row i of the destination gets the count pixels starting at src + i * sdw with step sdp.
+ * \param dst Destination buffer.
+ * \param ddw Row size of the destination buffer (in bytes).
+ * \param sdw Step in the src for the next row. It must be the pixel size, eventually negative.
+ * \param sdp Step in the src for the next pixel.
+ * \param count Number of pixels of every row.
+ * \param rows Number of rows.
+ */
+static inline void internal_transpose_step(uint8* dst, unsigned ddw, const uint8* src, int sdw, int sdp, unsigned count, unsigned rows, unsigned bpp)
+{
+	unsigned r;
+	unsigned c;
+	unsigned k;
+
+	for (r = 0; r < rows; r += VIDEO_ROT_STRIP) {
+		unsigned run = rows - r < VIDEO_ROT_STRIP ? rows - r : VIDEO_ROT_STRIP;
+		const uint8* s = src + (int)r * sdw;
+		uint8* d = dst + r * ddw;
+
+		for (c = 0; c < count; ++c) {
+			for (k = 0; k < run; ++k) {
+				switch (bpp) {
+				case 1 :
+					d[k * ddw] = P8DER(s, (int)k * sdw);
+					break;
+				case 2 :
+					P16DER(d, k * ddw) = P16DER(s, (int)k * sdw);
+					break;
+				case 4 :
+					P32DER(d, k * ddw) = P32DER(s, (int)k * sdw);
+					break;
+				}
+			}
+			s += sdp;
+			d += bpp;
+		}
+	}
+}
+
+static void internal_transpose8_def(void* dst, unsigned ddw, const void* src, int sdw, int sdp, unsigned count, unsigned rows)
+{
+	internal_transpose_step(dst, ddw, src, sdw, sdp, count, rows, 1);
+}
+
+static void internal_transpose16_def(void* dst, unsigned ddw, const void* src, int sdw, int sdp, unsigned count, unsigned rows)
+{
+	internal_transpose_step(dst, ddw, src, sdw, sdp, count, rows, 2);
+}
+
+static void internal_transpose32_def(void* dst, unsigned ddw, const void* src, int sdw, int sdp, unsigned count, unsigned rows)
+{
+	internal_transpose_step(dst, ddw, src, sdw, sdp, count, rows, 4);
+}
+
+#if defined(USE_ASM_INLINE)
+#define internal_transpose8_asm internal_transpose8_def
+#define internal_transpose16_asm internal_transpose16_def
+#define internal_transpose32_asm internal_transpose32_def
+#endif
+
+#if defined(USE_ASM_INTRINSIC)
+/*
+ * Set the destination row of every pixel of a strip.
+ * The pixels of the strip are loaded from the lowest address,
+ * so with a negative row step they are in the reverse order.
+ */
+static inline void internal_transpose_strip(uint8** row, uint8* dst, unsigned ddw, int sdw)
+{
+	unsigned k;
+
+	for (k = 0; k < VIDEO_ROT_STRIP; ++k) {
+		if (sdw > 0)
+			row[k] = dst + k * ddw;
+		else
+			row[k] = dst + (VIDEO_ROT_STRIP - 1 - k) * ddw;
+	}
+}
+
+#define internal_transpose8_sse2 internal_transpose8_def
+#define internal_transpose8_avx2 internal_transpose8_def
+
+static void internal_transpose16_sse2(void* dst, unsigned ddw, const void* src, int sdw, int sdp, unsigned count, unsigned rows)
+{
+	const uint8* src8 = (const uint8*)src;
+	uint8* dst8 = (uint8*)dst;
+	unsigned strip = rows - rows % VIDEO_ROT_STRIP;
+	unsigned block = count - count % 8;
+	unsigned r;
+
+	for (r = 0; r < strip; r += VIDEO_ROT_STRIP) {
+		const uint8* s = src8 + (int)r * sdw;
+		uint8* row[VIDEO_ROT_STRIP];
+		unsigned c;
+
+		internal_transpose_strip(row, dst8 + r * ddw, ddw, sdw);
+
+		/* start from the lowest address */
+		if (sdw < 0)
+			s += (VIDEO_ROT_STRIP - 1) * sdw;
+
+		for (c = 0; c < block; c += 8) {
+			__m128i a0 = _mm_loadu_si128((const __m128i*)(s));
+			__m128i a1 = _mm_loadu_si128((const __m128i*)(s + sdp));
+			__m128i a2 = _mm_loadu_si128((const __m128i*)(s + 2 * sdp));
+			__m128i a3 = _mm_loadu_si128((const __m128i*)(s + 3 * sdp));
+			__m128i a4 = _mm_loadu_si128((const __m128i*)(s + 4 * sdp));
+			__m128i a5 = _mm_loadu_si128((const __m128i*)(s + 5 * sdp));
+			__m128i a6 = _mm_loadu_si128((const __m128i*)(s + 6 * sdp));
+			__m128i a7 = _mm_loadu_si128((const __m128i*)(s + 7 * sdp));
+			__m128i t0 = _mm_unpacklo_epi16(a0, a1);
+			__m128i t1 = _mm_unpackhi_epi16(a0, a1);
+			__m128i t2 = _mm_unpacklo_epi16(a2, a3);
+			__m128i t3 = _mm_unpackhi_epi16(a2, a3);
+			__m128i t4 = _mm_unpacklo_epi16(a4, a5);
+			__m128i t5 = _mm_unpackhi_epi16(a4, a5);
+			__m128i t6 = _mm_unpacklo_epi16(a6, a7);
+			__m128i t7 = _mm_unpackhi_epi16(a6, a7);
+			__m128i u0 = _mm_unpacklo_epi32(t0, t2);
+			__m128i u1 = _mm_unpackhi_epi32(t0, t2);
+			__m128i u2 = _mm_unpacklo_epi32(t1, t3);
+			__m128i u3 = _mm_unpackhi_epi32(t1, t3);
+			__m128i u4 = _mm_unpacklo_epi32(t4, t6);
+			__m128i u5 = _mm_unpackhi_epi32(t4, t6);
+			__m128i u6 = _mm_unpacklo_epi32(t5, t7);
+			__m128i u7 = _mm_unpackhi_epi32(t5, t7);
+
+			_mm_storeu_si128((__m128i*)(row[0] + c * 2), _mm_unpacklo_epi64(u0, u4));
+			_mm_storeu_si128((__m128i*)(row[1] + c * 2), _mm_unpackhi_epi64(u0, u4));
+			_mm_storeu_si128((__m128i*)(row[2] + c * 2), _mm_unpacklo_epi64(u1, u5));
+			_mm_storeu_si128((__m128i*)(row[3] + c * 2), _mm_unpackhi_epi64(u1, u5));
+			_mm_storeu_si128((__m128i*)(row[4] + c * 2), _mm_unpacklo_epi64(u2, u6));
+			_mm_storeu_si128((__m128i*)(row[5] + c * 2), _mm_unpackhi_epi64(u2, u6));
+			_mm_storeu_si128((__m128i*)(row[6] + c * 2), _mm_unpacklo_epi64(u3, u7));
+			_mm_storeu_si128((__m128i*)(row[7] + c * 2), _mm_unpackhi_epi64(u3, u7));
+
+			s += 8 * sdp;
+		}
+
+		internal_transpose_step(dst8 + r * ddw + block * 2, ddw, src8 + (int)r * sdw + (int)block * sdp, sdw, sdp, count - block, VIDEO_ROT_STRIP, 2);
+	}
+
+	internal_transpose_step(dst8 + strip * ddw, ddw, src8 + (int)strip * sdw, sdw, sdp, count, rows - strip, 2);
+}
+
+/* The 16 bits transpose is already limited by the memory access */
+#define internal_transpose16_avx2 internal_transpose16_sse2
+
+static inline void internal_transpose32_4x4_sse2(uint8** row, unsigned c, __m128i a0, __m128i a1, __m128i a2, __m128i a3)
+{
+	__m128i t0 = _mm_unpacklo_epi32(a0, a1);
+	__m128i t1 = _mm_unpackhi_epi32(a0, a1);
+	__m128i t2 = _mm_unpacklo_epi32(a2, a3);
+	__m128i t3 = _mm_unpackhi_epi32(a2, a3);
+
+	_mm_storeu_si128((__m128i*)(row[0] + c * 4), _mm_unpacklo_epi64(t0, t2));
+	_mm_storeu_si128((__m128i*)(row[1] + c * 4), _mm_unpackhi_epi64(t0, t2));
+	_mm_storeu_si128((__m128i*)(row[2] + c * 4), _mm_unpacklo_epi64(t1, t3));
+	_mm_storeu_si128((__m128i*)(row[3] + c * 4), _mm_unpackhi_epi64(t1, t3));
+}
+
+static void internal_transpose32_sse2(void* dst, unsigned ddw, const void* src, int sdw, int sdp, unsigned count, unsigned rows)
+{
+	const uint8* src8 = (const uint8*)src;
+	uint8* dst8 = (uint8*)dst;
+	unsigned strip = rows - rows % VIDEO_ROT_STRIP;
+	unsigned block = count - count % 4;
+	unsigned r;
+
+	for (r = 0; r < strip; r += VIDEO_ROT_STRIP) {
+		const uint8* s = src8 + (int)r * sdw;
+		uint8* row[VIDEO_ROT_STRIP];
+		unsigned c;
+
+		internal_transpose_strip(row, dst8 + r * ddw, ddw, sdw);
+
+		/* start from the lowest address */
+		if (sdw < 0)
+			s += (VIDEO_ROT_STRIP - 1) * sdw;
+
+		for (c = 0; c < block; c += 4) {
+			const uint8* s1 = s + sdp;
+			const uint8* s2 = s + 2 * sdp;
+			const uint8* s3 = s + 3 * sdp;
+
+			/* two 4x4 blocks, with the first and the last four pixels of the strip */
+			internal_transpose32_4x4_sse2(row, c,
+				_mm_loadu_si128((const __m128i*)s), _mm_loadu_si128((const __m128i*)s1),
+				_mm_loadu_si128((const __m128i*)s2), _mm_loadu_si128((const __m128i*)s3));
+			internal_transpose32_4x4_sse2(row + 4, c,
+				_mm_loadu_si128((const __m128i*)(s + 16)), _mm_loadu_si128((const __m128i*)(s1 + 16)),
+				_mm_loadu_si128((const __m128i*)(s2 + 16)), _mm_loadu_si128((const __m128i*)(s3 + 16)));
+
+			s += 4 * sdp;
+		}
+
+		internal_transpose_step(dst8 + r * ddw + block * 4, ddw, src8 + (int)r * sdw + (int)block * sdp, sdw, sdp, count - block, VIDEO_ROT_STRIP, 4);
+	}
+
+	internal_transpose_step(dst8 + strip * ddw, ddw, src8 + (int)strip * sdw, sdw, sdp, count, rows - strip, 4);
+}
+
+static ASM_TARGET_AVX2 void internal_transpose32_avx2(void* dst, unsigned ddw, const void* src, int sdw, int sdp, unsigned count, unsigned rows)
+{
+	const uint8* src8 = (const uint8*)src;
+	uint8* dst8 = (uint8*)dst;
+	unsigned strip = rows - rows % VIDEO_ROT_STRIP;
+	unsigned block = count - count % 8;
+	unsigned r;
+
+	for (r = 0; r < strip; r += VIDEO_ROT_STRIP) {
+		const uint8* s = src8 + (int)r * sdw;
+		uint8* row[VIDEO_ROT_STRIP];
+		unsigned c;
+
+		internal_transpose_strip(row, dst8 + r * ddw, ddw, sdw);
+
+		/* start from the lowest address */
+		if (sdw < 0)
+			s += (VIDEO_ROT_STRIP - 1) * sdw;
+
+		for (c = 0; c < block; c += 8) {
+			__m256i a0 = _mm256_loadu_si256((const __m256i*)(s));
+			__m256i a1 = _mm256_loadu_si256((const __m256i*)(s + sdp));
+			__m256i a2 = _mm256_loadu_si256((const __m256i*)(s + 2 * sdp));
+			__m256i a3 = _mm256_loadu_si256((const __m256i*)(s + 3 * sdp));
+			__m256i a4 = _mm256_loadu_si256((const __m256i*)(s + 4 * sdp));
+			__m256i a5 = _mm256_loadu_si256((const __m256i*)(s + 5 * sdp));
+			__m256i a6 = _mm256_loadu_si256((const __m256i*)(s + 6 * sdp));
+			__m256i a7 = _mm256_loadu_si256((const __m256i*)(s + 7 * sdp));
+			__m256i t0 = _mm256_unpacklo_epi32(a0, a1);
+			__m256i t1 = _mm256_unpackhi_epi32(a0, a1);
+			__m256i t2 = _mm256_unpacklo_epi32(a2, a3);
+			__m256i t3 = _mm256_unpackhi_epi32(a2, a3);
+			__m256i t4 = _mm256_unpacklo_epi32(a4, a5);
+			__m256i t5 = _mm256_unpackhi_epi32(a4, a5);
+			__m256i t6 = _mm256_unpacklo_epi32(a6, a7);
+			__m256i t7 = _mm256_unpackhi_epi32(a6, a7);
+			__m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+			__m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+			__m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+			__m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+			__m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+			__m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+			__m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+			__m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+
+			/* the 128 bits lanes contain the first and the last four pixels of the strip */
+			_mm256_storeu_si256((__m256i*)(row[0] + c * 4), _mm256_permute2x128_si256(u0, u4, 0x20));
+			_mm256_storeu_si256((__m256i*)(row[1] + c * 4), _mm256_permute2x128_si256(u1, u5, 0x20));
+			_mm256_storeu_si256((__m256i*)(row[2] + c * 4), _mm256_permute2x128_si256(u2, u6, 0x20));
+			_mm256_storeu_si256((__m256i*)(row[3] + c * 4), _mm256_permute2x128_si256(u3, u7, 0x20));
+			_mm256_storeu_si256((__m256i*)(row[4] + c * 4), _mm256_permute2x128_si256(u0, u4, 0x31));
+			_mm256_storeu_si256((__m256i*)(row[5] + c * 4), _mm256_permute2x128_si256(u1, u5, 0x31));
+			_mm256_storeu_si256((__m256i*)(row[6] + c * 4), _mm256_permute2x128_si256(u2, u6, 0x31));
+			_mm256_storeu_si256((__m256i*)(row[7] + c * 4), _mm256_permute2x128_si256(u3, u7, 0x31));
+
+			s += 8 * sdp;
+		}
+
+		internal_transpose_step(dst8 + r * ddw + block * 4, ddw, src8 + (int)r * sdw + (int)block * sdp, sdw, sdp, count - block, VIDEO_ROT_STRIP, 4);
+	}
+
+	internal_transpose_step(dst8 + strip * ddw, ddw, src8 + (int)strip * sdw, sdw, sdp, count, rows - strip, 4);
+}
+#endif
+
 #endif
 
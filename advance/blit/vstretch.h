@@ -102,7 +102,7 @@ static inline void video_line_stretchx8_x1_step(const struct video_stage_horz_st
 			++run;
 			error -= down;
 		}
-		PADD(src, sdp * run);
+		PADD(src, sdp * (int)run);
 		--count;
 	}
 }
@@ -124,6 +124,18 @@ static void video_line_stretchx8_11_step1_asm(const struct video_stage_horz_stru
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_stretchx8_11_step1_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_copy8_sse2(dst, src, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_stretchx8_11_step1_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_copy8_avx2(dst, src, count);
+}
+#endif
+
 static void video_line_stretchx8_11_step1_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_copy8_def(dst, src, count);
@@ -136,6 +148,18 @@ static void video_line_stretchx8_11_step2_asm(const struct video_stage_horz_stru
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_stretchx8_11_step2_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_copy8_step2_sse2(dst, src, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_stretchx8_11_step2_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_copy8_step2_avx2(dst, src, count);
+}
+#endif
+
 static void video_line_stretchx8_11_step2_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_copy8_step2_def(dst, src, count);
@@ -148,6 +172,18 @@ static void video_line_stretchx8_11_asm(const struct video_stage_horz_struct* st
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_stretchx8_11_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_copy8_step_sse2(dst, src, count, stage->sdp);
+}
+
+static ASM_TARGET_AVX2 void video_line_stretchx8_11_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_copy8_step_avx2(dst, src, count, stage->sdp);
+}
+#endif
+
 static void video_line_stretchx8_11_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_copy8_step_def(dst, src, count, stage->sdp);
@@ -191,6 +227,18 @@ static void video_line_stretchx8_22_step1_asm(const struct video_stage_horz_stru
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_stretchx8_22_step1_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_double8_sse2(dst, src, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_stretchx8_22_step1_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_double8_avx2(dst, src, count);
+}
+#endif
+
 static void video_line_stretchx8_22_step1_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_double8_def(dst, src, count);
@@ -356,7 +404,7 @@ static inline void video_line_stretchx16_x1_step(const struct video_stage_horz_s
 			++run;
 			error -= down;
 		}
-		PADD(src, sdp * run);
+		PADD(src, sdp * (int)run);
 		--count;
 	}
 }
@@ -378,6 +426,18 @@ static void video_line_stretchx16_11_step2_asm(const struct video_stage_horz_str
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_stretchx16_11_step2_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_copy16_sse2(dst, src, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_stretchx16_11_step2_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_copy16_avx2(dst, src, count);
+}
+#endif
+
 static void video_line_stretchx16_11_step2_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_copy16_def(dst, src, count);
@@ -390,6 +450,18 @@ static void video_line_stretchx16_11_asm(const struct video_stage_horz_struct* s
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_stretchx16_11_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_copy16_step_sse2(dst, src, count, stage->sdp);
+}
+
+static ASM_TARGET_AVX2 void video_line_stretchx16_11_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_copy16_step_avx2(dst, src, count, stage->sdp);
+}
+#endif
+
 static void video_line_stretchx16_11_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_copy16_step_def(dst, src, count, stage->sdp);
@@ -433,6 +505,18 @@ static void video_line_stretchx16_22_step2_asm(const struct video_stage_horz_str
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_stretchx16_22_step2_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_double16_sse2(dst, src, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_stretchx16_22_step2_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_double16_avx2(dst, src, count);
+}
+#endif
+
 static void video_line_stretchx16_22_step2_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_double16_def(dst, src, count);
@@ -591,7 +675,7 @@ static inline void video_line_stretchx32_x1_step(const struct video_stage_horz_s
 			++run;
 			error -= down;
 		}
-		PADD(src, sdp * run);
+		PADD(src, sdp * (int)run);
 		--count;
 	}
 }
@@ -613,6 +697,18 @@ static void video_line_stretchx32_11_step4_asm(const struct video_stage_horz_str
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_stretchx32_11_step4_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_copy32_sse2(dst, src, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_stretchx32_11_step4_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_copy32_avx2(dst, src, count);
+}
+#endif
+
 static void video_line_stretchx32_11_step4_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_copy32_def(dst, src, count);
@@ -625,6 +721,18 @@ static void video_line_stretchx32_11_asm(const struct video_stage_horz_struct* s
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_stretchx32_11_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_copy32_step_sse2(dst, src, count, stage->sdp);
+}
+
+static ASM_TARGET_AVX2 void video_line_stretchx32_11_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_copy32_step_avx2(dst, src, count, stage->sdp);
+}
+#endif
+
 static void video_line_stretchx32_11_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_copy32_step_def(dst, src, count, stage->sdp);
@@ -668,6 +776,18 @@ static void video_line_stretchx32_22_step4_asm(const struct video_stage_horz_str
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_stretchx32_22_step4_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_double32_sse2(dst, src, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_stretchx32_22_step4_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_double32_avx2(dst, src, count);
+}
+#endif
+
 static void video_line_stretchx32_22_step4_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_double32_def(dst, src, count);
@@ -64,6 +64,60 @@ static inline void internal_swapodd8_step1_asm(unsigned line, uint8* buffer, uin
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static inline void internal_swapeven8_step1_sse2(unsigned line, uint8* buffer, uint8* dst, const uint8* src, unsigned count)
+{
+	if (line == 0) {
+		internal_copy8_sse2(dst, src, count);
+		internal_copy8_sse2(buffer, src, count);
+	} else if (line % 2) {
+		internal_copy8_sse2(dst, src, count);
+	} else {
+		internal_copy8_sse2(dst, buffer, count);
+		internal_copy8_sse2(buffer, src, count);
+	}
+}
+
+static inline void internal_swapodd8_step1_sse2(unsigned line, uint8* buffer, uint8* dst, const uint8* src, unsigned count)
+{
+	if (line == 0) {
+		internal_copy8_sse2(dst, src, count);
+		internal_copy8_sse2(buffer, src, count);
+	} else if (line % 2) {
+		internal_copy8_sse2(dst, buffer, count);
+		internal_copy8_sse2(buffer, src, count);
+	} else {
+		internal_copy8_sse2(dst, src, count);
+	}
+}
+
+static inline ASM_TARGET_AVX2 void internal_swapeven8_step1_avx2(unsigned line, uint8* buffer, uint8* dst, const uint8* src, unsigned count)
+{
+	if (line == 0) {
+		internal_copy8_avx2(dst, src, count);
+		internal_copy8_avx2(buffer, src, count);
+	} else if (line % 2) {
+		internal_copy8_avx2(dst, src, count);
+	} else {
+		internal_copy8_avx2(dst, buffer, count);
+		internal_copy8_avx2(buffer, src, count);
+	}
+}
+
+static inline ASM_TARGET_AVX2 void internal_swapodd8_step1_avx2(unsigned line, uint8* buffer, uint8* dst, const uint8* src, unsigned count)
+{
+	if (line == 0) {
+		internal_copy8_avx2(dst, src, count);
+		internal_copy8_avx2(buffer, src, count);
+	} else if (line % 2) {
+		internal_copy8_avx2(dst, buffer, count);
+		internal_copy8_avx2(buffer, src, count);
+	} else {
+		internal_copy8_avx2(dst, src, count);
+	}
+}
+#endif
+
 static inline void internal_swapeven8_step1_def(unsigned line, uint8* buffer, uint8* dst, const uint8* src, unsigned count)
 {
 	if (line == 0) {
@@ -105,6 +159,28 @@ static void video_line_swapodd8_step1_asm(const struct video_stage_horz_struct*
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_swapeven8_step1_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_swapeven8_step1_sse2(line, (uint8*)stage->buffer_extra, (uint8*)dst, (const uint8*)src, count);
+}
+
+static void video_line_swapodd8_step1_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_swapodd8_step1_sse2(line, (uint8*)stage->buffer_extra, (uint8*)dst, (const uint8*)src, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_swapeven8_step1_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_swapeven8_step1_avx2(line, (uint8*)stage->buffer_extra, (uint8*)dst, (const uint8*)src, count);
+}
+
+static ASM_TARGET_AVX2 void video_line_swapodd8_step1_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_swapodd8_step1_avx2(line, (uint8*)stage->buffer_extra, (uint8*)dst, (const uint8*)src, count);
+}
+#endif
+
 static void video_line_swapeven8_step1_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_swapeven8_step1_def(line, (uint8*)stage->buffer_extra, (uint8*)dst, (const uint8*)src, count);
@@ -144,6 +220,28 @@ static void video_line_swapodd16_step1_asm(const struct video_stage_horz_struct*
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_swapeven16_step1_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_swapeven8_step1_sse2(line, (uint8*)stage->buffer_extra, (uint8*)dst, (const uint8*)src, count * 2);
+}
+
+static void video_line_swapodd16_step1_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_swapodd8_step1_sse2(line, (uint8*)stage->buffer_extra, (uint8*)dst, (const uint8*)src, count * 2);
+}
+
+static ASM_TARGET_AVX2 void video_line_swapeven16_step1_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_swapeven8_step1_avx2(line, (uint8*)stage->buffer_extra, (uint8*)dst, (const uint8*)src, count * 2);
+}
+
+static ASM_TARGET_AVX2 void video_line_swapodd16_step1_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_swapodd8_step1_avx2(line, (uint8*)stage->buffer_extra, (uint8*)dst, (const uint8*)src, count * 2);
+}
+#endif
+
 static void video_line_swapeven16_step1_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_swapeven8_step1_def(line, (uint8*)stage->buffer_extra, (uint8*)dst, (const uint8*)src, count * 2);
@@ -183,6 +281,28 @@ static void video_line_swapodd32_step1_asm(const struct video_stage_horz_struct*
 }
 #endif
 
+#if defined(USE_ASM_INTRINSIC)
+static void video_line_swapeven32_step1_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_swapeven8_step1_sse2(line, (uint8*)stage->buffer_extra, (uint8*)dst, (const uint8*)src, count * 4);
+}
+
+static void video_line_swapodd32_step1_sse2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_swapodd8_step1_sse2(line, (uint8*)stage->buffer_extra, (uint8*)dst, (const uint8*)src, count * 4);
+}
+
+static ASM_TARGET_AVX2 void video_line_swapeven32_step1_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_swapeven8_step1_avx2(line, (uint8*)stage->buffer_extra, (uint8*)dst, (const uint8*)src, count * 4);
+}
+
+static ASM_TARGET_AVX2 void video_line_swapodd32_step1_avx2(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
+{
+	internal_swapodd8_step1_avx2(line, (uint8*)stage->buffer_extra, (uint8*)dst, (const uint8*)src, count * 4);
+}
+#endif
+
 static void video_line_swapeven32_step1_def(const struct video_stage_horz_struct* stage, unsigned line, void* dst, const void* src, unsigned count)
 {
 	internal_swapeven8_step1_def(line, (uint8*)stage->buffer_extra, (uint8*)dst, (const uint8*)src, count * 4);
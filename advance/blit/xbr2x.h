@@ -37,5 +37,23 @@ void xbr2x_16_def(interp_uint16* dst0, interp_uint16* dst1, const interp_uint16*
 void xbr2x_32_def(interp_uint32* dst0, interp_uint32* dst1, const interp_uint32* src0, const interp_uint32* src1, const interp_uint32* src2, const interp_uint32* src3, const interp_uint32* src4, unsigned count);
 void xbr2x_yuy2_def(interp_uint32* dst0, interp_uint32* dst1, const interp_uint32* src0, const interp_uint32* src1, const interp_uint32* src2, const interp_uint32* src3, const interp_uint32* src4, unsigned count);
 
+#if defined(USE_ASM_INLINE)
+/* No assembler version, use the C one */
+#define xbr2x_16_asm xbr2x_16_def
+#define xbr2x_32_asm xbr2x_32_def
+#define xbr2x_yuy2_asm xbr2x_yuy2_def
+#endif
+
+#if defined(USE_ASM_INTRINSIC)
+void xbr2x_16_sse2(interp_uint16* dst0, interp_uint16* dst1, const interp_uint16* src0, const interp_uint16* src1, const interp_uint16* src2, const interp_uint16* src3, const interp_uint16* src4, unsigned count);
+void xbr2x_32_sse2(interp_uint32* dst0, interp_uint32* dst1, const interp_uint32* src0, const interp_uint32* src1, const interp_uint32* src2, const interp_uint32* src3, const interp_uint32* src4, unsigned count);
+/* No vector version for yuy2, use the C one */
+#define xbr2x_yuy2_sse2 xbr2x_yuy2_def
+
+void xbr2x_16_avx2(interp_uint16* dst0, interp_uint16* dst1, const interp_uint16* src0, const interp_uint16* src1, const interp_uint16* src2, const interp_uint16* src3, const interp_uint16* src4, unsigned count);
+void xbr2x_32_avx2(interp_uint32* dst0, interp_uint32* dst1, const interp_uint32* src0, const interp_uint32* src1, const interp_uint32* src2, const interp_uint32* src3, const interp_uint32* src4, unsigned count);
+#define xbr2x_yuy2_avx2 xbr2x_yuy2_def
+#endif
+
 #endif
 
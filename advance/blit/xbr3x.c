@@ -34,6 +34,12 @@
 
 #include <assert.h>
 
+#if defined(USE_ASM_INTRINSIC)
+#include <immintrin.h>
+
+#define XBR3X_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
 /***************************************************************************/
 /* xbr3x C implementation */
 
@@ -102,11 +108,18 @@
 #define df(A, B) interp_16_dist(A, B)
 #define df3(A, B, C) interp_16_dist3(A, B, C)
 
-void xbr3x_16_def(interp_uint16* restrict dst0, interp_uint16* restrict dst1, interp_uint16* restrict dst2, const interp_uint16* restrict src0, const interp_uint16* restrict src1, const interp_uint16* restrict src2, const interp_uint16* restrict src3, const interp_uint16* restrict src4, unsigned count)
+static inline void xbr3x_16_def_range(interp_uint16* restrict dst0, interp_uint16* restrict dst1, interp_uint16* restrict dst2, const interp_uint16* restrict src0, const interp_uint16* restrict src1, const interp_uint16* restrict src2, const interp_uint16* restrict src3, const interp_uint16* restrict src4, unsigned i, unsigned end, unsigned count)
 {
-	unsigned i;
-
-	for (i = 0; i < count; ++i) {
+	src0 += i;
+	src1 += i;
+	src2 += i;
+	src3 += i;
+	src4 += i;
+	dst0 += 3 * i;
+	dst1 += 3 * i;
+	dst2 += 3 * i;
+
+	for (; i < end; ++i) {
 		interp_uint16 PA, PB, PC, PD, PE, PF, PG, PH, xPI;
 		interp_uint16 A0, D0, G0, A1, B1, C1, C4, F4, I4, G5, H5, I5;
 		interp_uint16 E[9];
@@ -222,6 +235,11 @@ void xbr3x_16_def(interp_uint16* restrict dst0, interp_uint16* restrict dst1, in
 	}
 }
 
+void xbr3x_16_def(interp_uint16* restrict dst0, interp_uint16* restrict dst1, interp_uint16* restrict dst2, const interp_uint16* restrict src0, const interp_uint16* restrict src1, const interp_uint16* restrict src2, const interp_uint16* restrict src3, const interp_uint16* restrict src4, unsigned count)
+{
+	xbr3x_16_def_range(dst0, dst1, dst2, src0, src1, src2, src3, src4, 0, count, count);
+}
+
 #undef LEFT_UP_2_3X
 #undef LEFT_2_3X
 #undef UP_2_3X
@@ -254,11 +272,18 @@ void xbr3x_16_def(interp_uint16* restrict dst0, interp_uint16* restrict dst1, in
 #define df(A, B) interp_32_dist(A, B)
 #define df3(A, B, C) interp_32_dist3(A, B, C)
 
-void xbr3x_32_def(interp_uint32* restrict dst0, interp_uint32* restrict dst1, interp_uint32* restrict dst2, const interp_uint32* restrict src0, const interp_uint32* restrict src1, const interp_uint32* restrict src2, const interp_uint32* restrict src3, const interp_uint32* restrict src4, unsigned count)
+static inline void xbr3x_32_def_range(interp_uint32* restrict dst0, interp_uint32* restrict dst1, interp_uint32* restrict dst2, const interp_uint32* restrict src0, const interp_uint32* restrict src1, const interp_uint32* restrict src2, const interp_uint32* restrict src3, const interp_uint32* restrict src4, unsigned i, unsigned end, unsigned count)
 {
-	unsigned i;
-
-	for (i = 0; i < count; ++i) {
+	src0 += i;
+	src1 += i;
+	src2 += i;
+	src3 += i;
+	src4 += i;
+	dst0 += 3 * i;
+	dst1 += 3 * i;
+	dst2 += 3 * i;
+
+	for (; i < end; ++i) {
 		interp_uint32 PA, PB, PC, PD, PE, PF, PG, PH, xPI;
 		interp_uint32 A0, D0, G0, A1, B1, C1, C4, F4, I4, G5, H5, I5;
 		interp_uint32 E[9];
@@ -374,6 +399,11 @@ void xbr3x_32_def(interp_uint32* restrict dst0, interp_uint32* restrict dst1, in
 	}
 }
 
+void xbr3x_32_def(interp_uint32* restrict dst0, interp_uint32* restrict dst1, interp_uint32* restrict dst2, const interp_uint32* restrict src0, const interp_uint32* restrict src1, const interp_uint32* restrict src2, const interp_uint32* restrict src3, const interp_uint32* restrict src4, unsigned count)
+{
+	xbr3x_32_def_range(dst0, dst1, dst2, src0, src1, src2, src3, src4, 0, count, count);
+}
+
 #undef LEFT_UP_2_3X
 #undef LEFT_2_3X
 #undef UP_2_3X
@@ -406,11 +436,18 @@ void xbr3x_32_def(interp_uint32* restrict dst0, interp_uint32* restrict dst1, in
 #define df(A, B) interp_yuy2_dist(A, B)
 #define df3(A, B, C) interp_yuy2_dist3(A, B, C)
 
-void xbr3x_yuy2_def(interp_uint32* restrict dst0, interp_uint32* restrict dst1, interp_uint32* restrict dst2, const interp_uint32* restrict src0, const interp_uint32* restrict src1, const interp_uint32* restrict src2, const interp_uint32* restrict src3, const interp_uint32* restrict src4, unsigned count)
+static inline void xbr3x_yuy2_def_range(interp_uint32* restrict dst0, interp_uint32* restrict dst1, interp_uint32* restrict dst2, const interp_uint32* restrict src0, const interp_uint32* restrict src1, const interp_uint32* restrict src2, const interp_uint32* restrict src3, const interp_uint32* restrict src4, unsigned i, unsigned end, unsigned count)
 {
-	unsigned i;
-
-	for (i = 0; i < count; ++i) {
+	src0 += i;
+	src1 += i;
+	src2 += i;
+	src3 += i;
+	src4 += i;
+	dst0 += 3 * i;
+	dst1 += 3 * i;
+	dst2 += 3 * i;
+
+	for (; i < end; ++i) {
 		interp_uint32 PA, PB, PC, PD, PE, PF, PG, PH, xPI;
 		interp_uint32 A0, D0, G0, A1, B1, C1, C4, F4, I4, G5, H5, I5;
 		interp_uint32 E[9];
@@ -526,3 +563,475 @@ void xbr3x_yuy2_def(interp_uint32* restrict dst0, interp_uint32* restrict dst1,
 	}
 }
 
+void xbr3x_yuy2_def(interp_uint32* restrict dst0, interp_uint32* restrict dst1, interp_uint32* restrict dst2, const interp_uint32* restrict src0, const interp_uint32* restrict src1, const interp_uint32* restrict src2, const interp_uint32* restrict src3, const interp_uint32* restrict src4, unsigned count)
+{
+	xbr3x_yuy2_def_range(dst0, dst1, dst2, src0, src1, src2, src3, src4, 0, count, count);
+}
+
+/***************************************************************************/
+/* xbr3x SSE2/AVX2 intrinsic implementation */
+
+#if defined(USE_ASM_INTRINSIC)
+
+/*
+ * The vector versions process a whole vector of pixels at a time, using
+ * masks in place of the conditions of the C implementation. The four
+ * corners are computed in the same order, and a corner is skipped if it's
+ * not active in any pixel. The two first and last pixels use the
+ * C implementation. The results are the same of the C implementation.
+ */
+
+#undef df
+#undef df3
+
+#define XBR_SSE2(PE, PI, PH, PF, PG, PC, PD, PB, PA, G5, C4, G0, D0, C1, B1, F4, I4, H5, I5, A0, A1, N0, N1, N2, N3, N4, N5, N6, N7, N8) \
+	{ \
+		__m128i act = _mm_andnot_si128(_mm_or_si128(_mm_cmpeq_epi32(PE, PH), _mm_cmpeq_epi32(PE, PF)), ones); \
+		if (_mm_movemask_epi8(act) != 0) { \
+			__m128i e = _mm_add_epi32(_mm_add_epi32(df3(PC, PE, PG), df3(H5, PI, F4)), _mm_slli_epi32(df(PH, PF), 2)); \
+			__m128i i = _mm_add_epi32(_mm_add_epi32(df3(PD, PH, I5), df3(I4, PF, PB)), _mm_slli_epi32(df(PE, PI), 2)); \
+			act = _mm_and_si128(act, _mm_cmpgt_epi32(i, e)); \
+			if (_mm_movemask_epi8(act) != 0) { \
+				__m128i ex2 = _mm_andnot_si128(_mm_or_si128(_mm_cmpeq_epi32(PE, PC), _mm_cmpeq_epi32(PB, PC)), ones); \
+				__m128i ex3 = _mm_andnot_si128(_mm_or_si128(_mm_cmpeq_epi32(PE, PG), _mm_cmpeq_epi32(PD, PG)), ones); \
+				__m128i ke = df(PF, PG); \
+				__m128i ki = df(PH, PC); \
+				__m128i px = interp_sse2_select(_mm_cmpgt_epi32(df(PE, PF), df(PE, PH)), PH, PF); \
+				__m128i m1, m2, m3, m4, t; \
+				m1 = _mm_and_si128(_mm_and_si128(act, _mm_cmpeq_epi32(_mm_or_si128(ke, ki), zero)), _mm_and_si128(ex3, ex2)); \
+				act = _mm_andnot_si128(m1, act); \
+				m2 = _mm_and_si128(act, _mm_andnot_si128(_mm_cmpgt_epi32(_mm_slli_epi32(ke, 1), ki), ex3)); \
+				act = _mm_andnot_si128(m2, act); \
+				m3 = _mm_and_si128(act, _mm_andnot_si128(_mm_cmpgt_epi32(_mm_slli_epi32(ki, 1), ke), ex2)); \
+				m4 = _mm_andnot_si128(m3, act); \
+				if (_mm_movemask_epi8(m1) != 0) { \
+					LEFT_UP_2_3X_SSE2(m1, N7, N5, N6, N2, N8, px); \
+				} \
+				if (_mm_movemask_epi8(m2) != 0) { \
+					LEFT_2_3X_SSE2(m2, N7, N5, N6, N8, px); \
+				} \
+				if (_mm_movemask_epi8(m3) != 0) { \
+					UP_2_3X_SSE2(m3, N5, N7, N2, N8, px); \
+				} \
+				if (_mm_movemask_epi8(m4) != 0) { \
+					DIA_3X_SSE2(m4, N8, N5, N7, px); \
+				} \
+			} \
+		} \
+	}
+
+#define LEFT_UP_2_3X_SSE2(M, N7, N5, N6, N2, N8, PIXEL) \
+	t = interp_sse2_31(&k, PIXEL, E[N7]); \
+	E[N5] = interp_sse2_select(M, t, E[N5]); \
+	E[N7] = interp_sse2_select(M, t, E[N7]); \
+	t = interp_sse2_31(&k, E[N6], PIXEL); \
+	E[N2] = interp_sse2_select(M, t, E[N2]); \
+	E[N6] = interp_sse2_select(M, t, E[N6]); \
+	E[N8] = interp_sse2_select(M, PIXEL, E[N8]);
+
+#define LEFT_2_3X_SSE2(M, N7, N5, N6, N8, PIXEL) \
+	t = interp_sse2_31(&k, PIXEL, E[N7]); \
+	E[N7] = interp_sse2_select(M, t, E[N7]); \
+	t = interp_sse2_31(&k, E[N5], PIXEL); \
+	E[N5] = interp_sse2_select(M, t, E[N5]); \
+	t = interp_sse2_31(&k, E[N6], PIXEL); \
+	E[N6] = interp_sse2_select(M, t, E[N6]); \
+	E[N8] = interp_sse2_select(M, PIXEL, E[N8]);
+
+#define UP_2_3X_SSE2(M, N5, N7, N2, N8, PIXEL) \
+	t = interp_sse2_31(&k, PIXEL, E[N5]); \
+	E[N5] = interp_sse2_select(M, t, E[N5]); \
+	t = interp_sse2_31(&k, E[N7], PIXEL); \
+	E[N7] = interp_sse2_select(M, t, E[N7]); \
+	t = interp_sse2_31(&k, E[N2], PIXEL); \
+	E[N2] = interp_sse2_select(M, t, E[N2]); \
+	E[N8] = interp_sse2_select(M, PIXEL, E[N8]);
+
+#define DIA_3X_SSE2(M, N8, N5, N7, PIXEL) \
+	t = interp_sse2_71(&k, PIXEL, E[N8]); \
+	E[N8] = interp_sse2_select(M, t, E[N8]); \
+	t = interp_sse2_71(&k, E[N5], PIXEL); \
+	E[N5] = interp_sse2_select(M, t, E[N5]); \
+	t = interp_sse2_71(&k, E[N7], PIXEL); \
+	E[N7] = interp_sse2_select(M, t, E[N7]);
+
+#define df(A, B) interp_16_sse2_dist(&k, A, B)
+#define df3(A, B, C) _mm_add_epi32(interp_16_sse2_dist(&k, A, B), interp_16_sse2_dist(&k, B, C))
+
+/**
+ * Scale a row of pixels with the xbr3x effect.
+ * This function operates like xbr3x_16_def() but it uses the SSE2
+ * instruction set.
+ */
+void xbr3x_16_sse2(interp_uint16* dst0, interp_uint16* dst1, interp_uint16* dst2, const interp_uint16* src0, const interp_uint16* src1, const interp_uint16* src2, const interp_uint16* src3, const interp_uint16* src4, unsigned count)
+{
+	unsigned i = 0;
+
+	if (count > 4 + 3) {
+		struct interp_sse2_struct k;
+		__m128i zero = _mm_setzero_si128();
+		__m128i ones = _mm_cmpeq_epi32(zero, zero);
+
+		interp_16_sse2_set(&k);
+
+		/* first two pixels */
+		xbr3x_16_def_range(dst0, dst1, dst2, src0, src1, src2, src3, src4, 0, 2, count);
+
+		/* central pixels */
+		for (i = 2; i + 4 + 1 < count; i += 4) {
+			__m128i PA, PB, PC, PD, PE, PF, PG, PH, xPI;
+			__m128i A0, D0, G0, A1, B1, C1, C4, F4, I4, G5, H5, I5;
+			__m128i E[9];
+			unsigned j;
+
+			A1 = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(src0 + i - 1)), zero);
+			B1 = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(src0 + i)), zero);
+			C1 = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(src0 + i + 1)), zero);
+			A0 = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(src1 + i - 2)), zero);
+			PA = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(src1 + i - 1)), zero);
+			PB = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(src1 + i)), zero);
+			PC = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(src1 + i + 1)), zero);
+			C4 = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(src1 + i + 2)), zero);
+			D0 = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(src2 + i - 2)), zero);
+			PD = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(src2 + i - 1)), zero);
+			PE = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(src2 + i)), zero);
+			PF = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(src2 + i + 1)), zero);
+			F4 = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(src2 + i + 2)), zero);
+			G0 = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(src3 + i - 2)), zero);
+			PG = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(src3 + i - 1)), zero);
+			PH = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(src3 + i)), zero);
+			xPI = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(src3 + i + 1)), zero);
+			I4 = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(src3 + i + 2)), zero);
+			G5 = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(src4 + i - 1)), zero);
+			H5 = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(src4 + i)), zero);
+			I5 = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(src4 + i + 1)), zero);
+
+			/* default pixels */
+			for (j = 0; j < 9; ++j)
+				E[j] = PE;
+
+			XBR_SSE2(PE, xPI, PH, PF, PG, PC, PD, PB, PA, G5, C4, G0, D0, C1, B1, F4, I4, H5, I5, A0, A1, 0, 1, 2, 3, 4, 5, 6, 7, 8);
+			XBR_SSE2(PE, PC, PF, PB, xPI, PA, PH, PD, PG, I4, A1, I5, H5, A0, D0, B1, C1, F4, C4, G5, G0, 6, 3, 0, 7, 4, 1, 8, 5, 2);
+			XBR_SSE2(PE, PA, PB, PD, PC, PG, PF, PH, xPI, C1, G0, C4, F4, G5, H5, D0, A0, B1, A1, I4, I5, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+			XBR_SSE2(PE, PG, PD, PH, PA, xPI, PB, PF, PC, A0, I5, A1, B1, I4, F4, H5, G5, D0, G0, C1, C4, 2, 5, 8, 1, 4, 7, 0, 3, 6);
+
+			/* copy resulting pixel into dst */
+			interp_16_sse2_store(dst0 + 3 * i, E + 0, 3);
+			interp_16_sse2_store(dst1 + 3 * i, E + 3, 3);
+			interp_16_sse2_store(dst2 + 3 * i, E + 6, 3);
+		}
+	}
+
+	/* remaining pixels */
+	xbr3x_16_def_range(dst0, dst1, dst2, src0, src1, src2, src3, src4, i, count, count);
+}
+
+#undef df
+#undef df3
+
+#define df(A, B) interp_32_sse2_dist(&k, A, B)
+#define df3(A, B, C) _mm_add_epi32(interp_32_sse2_dist(&k, A, B), interp_32_sse2_dist(&k, B, C))
+
+/**
+ * Scale a row of pixels with the xbr3x effect.
+ * This function operates like xbr3x_32_def() but it uses the SSE2
+ * instruction set.
+ */
+void xbr3x_32_sse2(interp_uint32* dst0, interp_uint32* dst1, interp_uint32* dst2, const interp_uint32* src0, const interp_uint32* src1, const interp_uint32* src2, const interp_uint32* src3, const interp_uint32* src4, unsigned count)
+{
+	unsigned i = 0;
+
+	if (count > 4 + 3) {
+		struct interp_sse2_struct k;
+		__m128i zero = _mm_setzero_si128();
+		__m128i ones = _mm_cmpeq_epi32(zero, zero);
+
+		interp_32_sse2_set(&k);
+
+		/* first two pixels */
+		xbr3x_32_def_range(dst0, dst1, dst2, src0, src1, src2, src3, src4, 0, 2, count);
+
+		/* central pixels */
+		for (i = 2; i + 4 + 1 < count; i += 4) {
+			__m128i PA, PB, PC, PD, PE, PF, PG, PH, xPI;
+			__m128i A0, D0, G0, A1, B1, C1, C4, F4, I4, G5, H5, I5;
+			__m128i E[9];
+			unsigned j;
+
+			A1 = _mm_loadu_si128((const __m128i*)(src0 + i - 1));
+			B1 = _mm_loadu_si128((const __m128i*)(src0 + i));
+			C1 = _mm_loadu_si128((const __m128i*)(src0 + i + 1));
+			A0 = _mm_loadu_si128((const __m128i*)(src1 + i - 2));
+			PA = _mm_loadu_si128((const __m128i*)(src1 + i - 1));
+			PB = _mm_loadu_si128((const __m128i*)(src1 + i));
+			PC = _mm_loadu_si128((const __m128i*)(src1 + i + 1));
+			C4 = _mm_loadu_si128((const __m128i*)(src1 + i + 2));
+			D0 = _mm_loadu_si128((const __m128i*)(src2 + i - 2));
+			PD = _mm_loadu_si128((const __m128i*)(src2 + i - 1));
+			PE = _mm_loadu_si128((const __m128i*)(src2 + i));
+			PF = _mm_loadu_si128((const __m128i*)(src2 + i + 1));
+			F4 = _mm_loadu_si128((const __m128i*)(src2 + i + 2));
+			G0 = _mm_loadu_si128((const __m128i*)(src3 + i - 2));
+			PG = _mm_loadu_si128((const __m128i*)(src3 + i - 1));
+			PH = _mm_loadu_si128((const __m128i*)(src3 + i));
+			xPI = _mm_loadu_si128((const __m128i*)(src3 + i + 1));
+			I4 = _mm_loadu_si128((const __m128i*)(src3 + i + 2));
+			G5 = _mm_loadu_si128((const __m128i*)(src4 + i - 1));
+			H5 = _mm_loadu_si128((const __m128i*)(src4 + i));
+			I5 = _mm_loadu_si128((const __m128i*)(src4 + i + 1));
+
+			/* default pixels */
+			for (j = 0; j < 9; ++j)
+				E[j] = PE;
+
+			XBR_SSE2(PE, xPI, PH, PF, PG, PC, PD, PB, PA, G5, C4, G0, D0, C1, B1, F4, I4, H5, I5, A0, A1, 0, 1, 2, 3, 4, 5, 6, 7, 8);
+			XBR_SSE2(PE, PC, PF, PB, xPI, PA, PH, PD, PG, I4, A1, I5, H5, A0, D0, B1, C1, F4, C4, G5, G0, 6, 3, 0, 7, 4, 1, 8, 5, 2);
+			XBR_SSE2(PE, PA, PB, PD, PC, PG, PF, PH, xPI, C1, G0, C4, F4, G5, H5, D0, A0, B1, A1, I4, I5, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+			XBR_SSE2(PE, PG, PD, PH, PA, xPI, PB, PF, PC, A0, I5, A1, B1, I4, F4, H5, G5, D0, G0, C1, C4, 2, 5, 8, 1, 4, 7, 0, 3, 6);
+
+			/* copy resulting pixel into dst */
+			interp_32_sse2_store(dst0 + 3 * i, E + 0, 3);
+			interp_32_sse2_store(dst1 + 3 * i, E + 3, 3);
+			interp_32_sse2_store(dst2 + 3 * i, E + 6, 3);
+		}
+	}
+
+	/* remaining pixels */
+	xbr3x_32_def_range(dst0, dst1, dst2, src0, src1, src2, src3, src4, i, count, count);
+}
+
+#undef df
+#undef df3
+
+#undef XBR_SSE2
+#undef LEFT_UP_2_3X_SSE2
+#undef LEFT_2_3X_SSE2
+#undef UP_2_3X_SSE2
+#undef DIA_3X_SSE2
+
+#define XBR_AVX2(PE, PI, PH, PF, PG, PC, PD, PB, PA, G5, C4, G0, D0, C1, B1, F4, I4, H5, I5, A0, A1, N0, N1, N2, N3, N4, N5, N6, N7, N8) \
+	{ \
+		__m256i act = _mm256_andnot_si256(_mm256_or_si256(_mm256_cmpeq_epi32(PE, PH), _mm256_cmpeq_epi32(PE, PF)), ones); \
+		if (_mm256_movemask_epi8(act) != 0) { \
+			__m256i e = _mm256_add_epi32(_mm256_add_epi32(df3(PC, PE, PG), df3(H5, PI, F4)), _mm256_slli_epi32(df(PH, PF), 2)); \
+			__m256i i = _mm256_add_epi32(_mm256_add_epi32(df3(PD, PH, I5), df3(I4, PF, PB)), _mm256_slli_epi32(df(PE, PI), 2)); \
+			act = _mm256_and_si256(act, _mm256_cmpgt_epi32(i, e)); \
+			if (_mm256_movemask_epi8(act) != 0) { \
+				__m256i ex2 = _mm256_andnot_si256(_mm256_or_si256(_mm256_cmpeq_epi32(PE, PC), _mm256_cmpeq_epi32(PB, PC)), ones); \
+				__m256i ex3 = _mm256_andnot_si256(_mm256_or_si256(_mm256_cmpeq_epi32(PE, PG), _mm256_cmpeq_epi32(PD, PG)), ones); \
+				__m256i ke = df(PF, PG); \
+				__m256i ki = df(PH, PC); \
+				__m256i px = interp_avx2_select(_mm256_cmpgt_epi32(df(PE, PF), df(PE, PH)), PH, PF); \
+				__m256i m1, m2, m3, m4, t; \
+				m1 = _mm256_and_si256(_mm256_and_si256(act, _mm256_cmpeq_epi32(_mm256_or_si256(ke, ki), zero)), _mm256_and_si256(ex3, ex2)); \
+				act = _mm256_andnot_si256(m1, act); \
+				m2 = _mm256_and_si256(act, _mm256_andnot_si256(_mm256_cmpgt_epi32(_mm256_slli_epi32(ke, 1), ki), ex3)); \
+				act = _mm256_andnot_si256(m2, act); \
+				m3 = _mm256_and_si256(act, _mm256_andnot_si256(_mm256_cmpgt_epi32(_mm256_slli_epi32(ki, 1), ke), ex2)); \
+				m4 = _mm256_andnot_si256(m3, act); \
+				if (_mm256_movemask_epi8(m1) != 0) { \
+					LEFT_UP_2_3X_AVX2(m1, N7, N5, N6, N2, N8, px); \
+				} \
+				if (_mm256_movemask_epi8(m2) != 0) { \
+					LEFT_2_3X_AVX2(m2, N7, N5, N6, N8, px); \
+				} \
+				if (_mm256_movemask_epi8(m3) != 0) { \
+					UP_2_3X_AVX2(m3, N5, N7, N2, N8, px); \
+				} \
+				if (_mm256_movemask_epi8(m4) != 0) { \
+					DIA_3X_AVX2(m4, N8, N5, N7, px); \
+				} \
+			} \
+		} \
+	}
+
+#define LEFT_UP_2_3X_AVX2(M, N7, N5, N6, N2, N8, PIXEL) \
+	t = interp_avx2_31(&k, PIXEL, E[N7]); \
+	E[N5] = interp_avx2_select(M, t, E[N5]); \
+	E[N7] = interp_avx2_select(M, t, E[N7]); \
+	t = interp_avx2_31(&k, E[N6], PIXEL); \
+	E[N2] = interp_avx2_select(M, t, E[N2]); \
+	E[N6] = interp_avx2_select(M, t, E[N6]); \
+	E[N8] = interp_avx2_select(M, PIXEL, E[N8]);
+
+#define LEFT_2_3X_AVX2(M, N7, N5, N6, N8, PIXEL) \
+	t = interp_avx2_31(&k, PIXEL, E[N7]); \
+	E[N7] = interp_avx2_select(M, t, E[N7]); \
+	t = interp_avx2_31(&k, E[N5], PIXEL); \
+	E[N5] = interp_avx2_select(M, t, E[N5]); \
+	t = interp_avx2_31(&k, E[N6], PIXEL); \
+	E[N6] = interp_avx2_select(M, t, E[N6]); \
+	E[N8] = interp_avx2_select(M, PIXEL, E[N8]);
+
+#define UP_2_3X_AVX2(M, N5, N7, N2, N8, PIXEL) \
+	t = interp_avx2_31(&k, PIXEL, E[N5]); \
+	E[N5] = interp_avx2_select(M, t, E[N5]); \
+	t = interp_avx2_31(&k, E[N7], PIXEL); \
+	E[N7] = interp_avx2_select(M, t, E[N7]); \
+	t = interp_avx2_31(&k, E[N2], PIXEL); \
+	E[N2] = interp_avx2_select(M, t, E[N2]); \
+	E[N8] = interp_avx2_select(M, PIXEL, E[N8]);
+
+#define DIA_3X_AVX2(M, N8, N5, N7, PIXEL) \
+	t = interp_avx2_71(&k, PIXEL, E[N8]); \
+	E[N8] = interp_avx2_select(M, t, E[N8]); \
+	t = interp_avx2_71(&k, E[N5], PIXEL); \
+	E[N5] = interp_avx2_select(M, t, E[N5]); \
+	t = interp_avx2_71(&k, E[N7], PIXEL); \
+	E[N7] = interp_avx2_select(M, t, E[N7]);
+
+#define df(A, B) interp_16_avx2_dist(&k, A, B)
+#define df3(A, B, C) _mm256_add_epi32(interp_16_avx2_dist(&k, A, B), interp_16_avx2_dist(&k, B, C))
+
+/**
+ * Scale a row of pixels with the xbr3x effect.
+ * This function operates like xbr3x_16_def() but it uses the AVX2
+ * instruction set. It must be called only if the processor supports it.
+ */
+XBR3X_TARGET_AVX2 void xbr3x_16_avx2(interp_uint16* dst0, interp_uint16* dst1, interp_uint16* dst2, const interp_uint16* src0, const interp_uint16* src1, const interp_uint16* src2, const interp_uint16* src3, const interp_uint16* src4, unsigned count)
+{
+	unsigned i = 0;
+
+	if (count > 8 + 3) {
+		struct interp_avx2_struct k;
+		__m256i zero = _mm256_setzero_si256();
+		__m256i ones = _mm256_cmpeq_epi32(zero, zero);
+
+		interp_16_avx2_set(&k);
+
+		/* first two pixels */
+		xbr3x_16_def_range(dst0, dst1, dst2, src0, src1, src2, src3, src4, 0, 2, count);
+
+		/* central pixels */
+		for (i = 2; i + 8 + 1 < count; i += 8) {
+			__m256i PA, PB, PC, PD, PE, PF, PG, PH, xPI;
+			__m256i A0, D0, G0, A1, B1, C1, C4, F4, I4, G5, H5, I5;
+			__m256i E[9];
+			unsigned j;
+
+			A1 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src0 + i - 1)));
+			B1 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src0 + i)));
+			C1 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src0 + i + 1)));
+			A0 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src1 + i - 2)));
+			PA = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src1 + i - 1)));
+			PB = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src1 + i)));
+			PC = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src1 + i + 1)));
+			C4 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src1 + i + 2)));
+			D0 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src2 + i - 2)));
+			PD = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src2 + i - 1)));
+			PE = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src2 + i)));
+			PF = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src2 + i + 1)));
+			F4 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src2 + i + 2)));
+			G0 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src3 + i - 2)));
+			PG = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src3 + i - 1)));
+			PH = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src3 + i)));
+			xPI = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src3 + i + 1)));
+			I4 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src3 + i + 2)));
+			G5 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src4 + i - 1)));
+			H5 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src4 + i)));
+			I5 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src4 + i + 1)));
+
+			/* default pixels */
+			for (j = 0; j < 9; ++j)
+				E[j] = PE;
+
+			XBR_AVX2(PE, xPI, PH, PF, PG, PC, PD, PB, PA, G5, C4, G0, D0, C1, B1, F4, I4, H5, I5, A0, A1, 0, 1, 2, 3, 4, 5, 6, 7, 8);
+			XBR_AVX2(PE, PC, PF, PB, xPI, PA, PH, PD, PG, I4, A1, I5, H5, A0, D0, B1, C1, F4, C4, G5, G0, 6, 3, 0, 7, 4, 1, 8, 5, 2);
+			XBR_AVX2(PE, PA, PB, PD, PC, PG, PF, PH, xPI, C1, G0, C4, F4, G5, H5, D0, A0, B1, A1, I4, I5, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+			XBR_AVX2(PE, PG, PD, PH, PA, xPI, PB, PF, PC, A0, I5, A1, B1, I4, F4, H5, G5, D0, G0, C1, C4, 2, 5, 8, 1, 4, 7, 0, 3, 6);
+
+			/* copy resulting pixel into dst */
+			interp_16_avx2_store(dst0 + 3 * i, E + 0, 3);
+			interp_16_avx2_store(dst1 + 3 * i, E + 3, 3);
+			interp_16_avx2_store(dst2 + 3 * i, E + 6, 3);
+		}
+	}
+
+	/* remaining pixels */
+	xbr3x_16_def_range(dst0, dst1, dst2, src0, src1, src2, src3, src4, i, count, count);
+}
+
+#undef df
+#undef df3
+
+#define df(A, B) interp_32_avx2_dist(&k, A, B)
+#define df3(A, B, C) _mm256_add_epi32(interp_32_avx2_dist(&k, A, B), interp_32_avx2_dist(&k, B, C))
+
+/**
+ * Scale a row of pixels with the xbr3x effect.
+ * This function operates like xbr3x_32_def() but it uses the AVX2
+ * instruction set. It must be called only if the processor supports it.
+ */
+XBR3X_TARGET_AVX2 void xbr3x_32_avx2(interp_uint32* dst0, interp_uint32* dst1, interp_uint32* dst2, const interp_uint32* src0, const interp_uint32* src1, const interp_uint32* src2, const interp_uint32* src3, const interp_uint32* src4, unsigned count)
+{
+	unsigned i = 0;
+
+	if (count > 8 + 3) {
+		struct interp_avx2_struct k;
+		__m256i zero = _mm256_setzero_si256();
+		__m256i ones = _mm256_cmpeq_epi32(zero, zero);
+
+		interp_32_avx2_set(&k);
+
+		/* first two pixels */
+		xbr3x_32_def_range(dst0, dst1, dst2, src0, src1, src2, src3, src4, 0, 2, count);
+
+		/* central pixels */
+		for (i = 2; i + 8 + 1 < count; i += 8) {
+			__m256i PA, PB, PC, PD, PE, PF, PG, PH, xPI;
+			__m256i A0, D0, G0, A1, B1, C1, C4, F4, I4, G5, H5, I5;
+			__m256i E[9];
+			unsigned j;
+
+			A1 = _mm256_loadu_si256((const __m256i*)(src0 + i - 1));
+			B1 = _mm256_loadu_si256((const __m256i*)(src0 + i));
+			C1 = _mm256_loadu_si256((const __m256i*)(src0 + i + 1));
+			A0 = _mm256_loadu_si256((const __m256i*)(src1 + i - 2));
+			PA = _mm256_loadu_si256((const __m256i*)(src1 + i - 1));
+			PB = _mm256_loadu_si256((const __m256i*)(src1 + i));
+			PC = _mm256_loadu_si256((const __m256i*)(src1 + i + 1));
+			C4 = _mm256_loadu_si256((const __m256i*)(src1 + i + 2));
+			D0 = _mm256_loadu_si256((const __m256i*)(src2 + i - 2));
+			PD = _mm256_loadu_si256((const __m256i*)(src2 + i - 1));
+			PE = _mm256_loadu_si256((const __m256i*)(src2 + i));
+			PF = _mm256_loadu_si256((const __m256i*)(src2 + i + 1));
+			F4 = _mm256_loadu_si256((const __m256i*)(src2 + i + 2));
+			G0 = _mm256_loadu_si256((const __m256i*)(src3 + i - 2));
+			PG = _mm256_loadu_si256((const __m256i*)(src3 + i - 1));
+			PH = _mm256_loadu_si256((const __m256i*)(src3 + i));
+			xPI = _mm256_loadu_si256((const __m256i*)(src3 + i + 1));
+			I4 = _mm256_loadu_si256((const __m256i*)(src3 + i + 2));
+			G5 = _mm256_loadu_si256((const __m256i*)(src4 + i - 1));
+			H5 = _mm256_loadu_si256((const __m256i*)(src4 + i));
+			I5 = _mm256_loadu_si256((const __m256i*)(src4 + i + 1));
+
+			/* default pixels */
+			for (j = 0; j < 9; ++j)
+				E[j] = PE;
+
+			XBR_AVX2(PE, xPI, PH, PF, PG, PC, PD, PB, PA, G5, C4, G0, D0, C1, B1, F4, I4, H5, I5, A0, A1, 0, 1, 2, 3, 4, 5, 6, 7, 8);
+			XBR_AVX2(PE, PC, PF, PB, xPI, PA, PH, PD, PG, I4, A1, I5, H5, A0, D0, B1, C1, F4, C4, G5, G0, 6, 3, 0, 7, 4, 1, 8, 5, 2);
+			XBR_AVX2(PE, PA, PB, PD, PC, PG, PF, PH, xPI, C1, G0, C4, F4, G5, H5, D0, A0, B1, A1, I4, I5, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+			XBR_AVX2(PE, PG, PD, PH, PA, xPI, PB, PF, PC, A0, I5, A1, B1, I4, F4, H5, G5, D0, G0, C1, C4, 2, 5, 8, 1, 4, 7, 0, 3, 6);
+
+			/* copy resulting pixel into dst */
+			interp_32_avx2_store(dst0 + 3 * i, E + 0, 3);
+			interp_32_avx2_store(dst1 + 3 * i, E + 3, 3);
+			interp_32_avx2_store(dst2 + 3 * i, E + 6, 3);
+		}
+	}
+
+	/* remaining pixels */
+	xbr3x_32_def_range(dst0, dst1, dst2, src0, src1, src2, src3, src4, i, count, count);
+}
+
+#undef df
+#undef df3
+
+#undef XBR_AVX2
+#undef LEFT_UP_2_3X_AVX2
+#undef LEFT_2_3X_AVX2
+#undef UP_2_3X_AVX2
+#undef DIA_3X_AVX2
+
+#endif
@@ -88,6 +88,11 @@ void target_yield(void)
 		getkey();
 }
 
+adv_error target_realtime(void)
+{
+	return -1;
+}
+
 void target_idle(void)
 {
 	target_yield();
@@ -114,6 +119,10 @@ target_clock_t target_clock(void)
 	return r;
 }
 
+void target_usleep_until(target_clock_t clock)
+{
+}
+
 /***************************************************************************/
 /* Hardware */
 
@@ -47,7 +47,7 @@ ifeq ($(CONF_LIB_PTHREAD),yes)
 CFLAGS += -D_REENTRANT
 ADVANCECFLAGS += -DUSE_SMP
 ADVANCELIBS += -lpthread
-ADVANCEOBJS += $(OBJ)/advance/osd/thdouble.o
+ADVANCEOBJS += $(OBJ)/advance/osd/thfifo.o
 else
 ADVANCEOBJS += $(OBJ)/advance/osd/thmono.o
 endif
@@ -439,6 +439,7 @@ ADVANCEOBJS += \
 	$(OBJ)/advance/osd/menu.o \
 	$(OBJ)/advance/osd/estimate.o \
 	$(OBJ)/advance/osd/record.o \
+	$(OBJ)/advance/osd/timeline.o \
 	$(OBJ)/advance/osd/sound.o \
 	$(OBJ)/advance/osd/input.o \
 	$(OBJ)/advance/osd/lexyy.o \
@@ -491,6 +492,7 @@ ADVANCEOBJS += \
 	$(OBJ)/advance/lib/crtcbag.o \
 	$(OBJ)/advance/lib/monitor.o \
 	$(OBJ)/advance/lib/sounddrv.o \
+	$(OBJ)/advance/lib/ring.o \
 	$(OBJ)/advance/lib/snone.o \
 	$(OBJ)/advance/lib/vnone.o \
 	$(OBJ)/advance/lib/device.o \
@@ -693,6 +695,10 @@ DBGOBJS =
 MESSDBGOBJS =
 endif
 
+ifeq ($(CONF_PROFILER),yes)
+EMUDEFS += -DMAME_PROFILER
+endif
+
 MAMECFLAGS += \
 	$(EMUCFLAGS) \
 	-I$(srcdir)/src \
@@ -843,6 +849,7 @@ EMU_ADVANCE_SRC = \
 	$(srcdir)/advance/cfg.mak \
 	$(srcdir)/advance/k.mak \
 	$(srcdir)/advance/s.mak \
+	$(srcdir)/advance/bench.mak \
 	$(srcdir)/advance/i.mak \
 	$(srcdir)/advance/j.mak \
 	$(srcdir)/advance/m.mak \
@@ -1136,6 +1143,8 @@ dist: $(DOCOBJ)/readme.txt $(DOCOBJ)/release.txt $(DOCOBJ)/history.txt $(DOCOBJ)
 	cp $(M_SRC) $(EMU_DIST_DIR_SRC)/advance/m
 	mkdir $(EMU_DIST_DIR_SRC)/advance/s
 	cp $(S_SRC) $(EMU_DIST_DIR_SRC)/advance/s
+	mkdir $(EMU_DIST_DIR_SRC)/advance/bench
+	cp $(BENCH_SRC) $(EMU_DIST_DIR_SRC)/advance/bench
 	mkdir $(EMU_DIST_DIR_SRC)/advance/i
 	cp $(I_SRC) $(EMU_DIST_DIR_SRC)/advance/i
 	mkdir $(EMU_DIST_DIR_SRC)/advance/cfg
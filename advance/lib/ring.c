@@ -0,0 +1,255 @@
+/*
+ * This file is part of the Advance project.
+ *
+ * Copyright (C) 2003 Andrea Mazzoleni
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * In addition, as a special exception, Andrea Mazzoleni
+ * gives permission to link the code of this program with
+ * the MAME library (or with modified versions of MAME that use the
+ * same license as MAME), and distribute linked combinations including
+ * the two.  You must obey the GNU General Public License in all
+ * respects for all of the code used other than MAME.  If you modify
+ * this file, you may extend this exception to your version of the
+ * file, but you are not obligated to do so.  If you do not wish to
+ * do so, delete this exception statement from your version.
+ */
+
+#include "portable.h"
+
+#include "ring.h"
+#include "log.h"
+#include "error.h"
+
+/**
+ * Read a position written by the other thread.
+ * The samples written before the position are visible after reading it.
+ */
+static inline unsigned ring_pos_get(adv_ring_pos* pos)
+{
+#if defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7))
+	return __atomic_load_n(&pos->value, __ATOMIC_ACQUIRE);
+#elif defined(__GNUC__)
+	unsigned value = *(volatile unsigned*)&pos->value;
+	__sync_synchronize();
+	return value;
+#else
+	return *(volatile unsigned*)&pos->value;
+#endif
+}
+
+/**
+ * Write a position read by the other thread.
+ * The samples accessed before are done when the other thread reads the position.
+ */
+static inline void ring_pos_set(adv_ring_pos* pos, unsigned value)
+{
+#if defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7))
+	__atomic_store_n(&pos->value, value, __ATOMIC_RELEASE);
+#elif defined(__GNUC__)
+	__sync_synchronize();
+	*(volatile unsigned*)&pos->value = value;
+#else
+	*(volatile unsigned*)&pos->value = value;
+#endif
+}
+
+/**
+ * Initialize the ring.
+ * \param ring Ring to initialize.
+ * \param size Minimum number of samples. It's rounded up to a power of 2.
+ */
+adv_error ring_init(adv_ring* ring, unsigned size)
+{
+	unsigned char* raw;
+
+	ring->size = 1;
+	while (ring->size < size)
+		ring->size *= 2;
+	ring->mask = ring->size - 1;
+
+	raw = malloc(ring->size * sizeof(adv_sample) + ADV_RING_CACHE_LINE);
+	if (!raw) {
+		error_set("Low memory.\n");
+		return -1;
+	}
+
+	ring->map_raw = raw;
+	ring->map = (adv_sample*)(raw + ADV_RING_CACHE_LINE - ((size_t)raw & (ADV_RING_CACHE_LINE - 1)));
+
+	ring_reset(ring);
+
+	log_std(("ring: size %u samples\n", ring->size));
+
+	return 0;
+}
+
+/**
+ * Deinitialize the ring.
+ */
+void ring_done(adv_ring* ring)
+{
+	free(ring->map_raw);
+	ring->map_raw = 0;
+	ring->map = 0;
+}
+
+/**
+ * Empty the ring.
+ * It can be called only if the producer and the consumer are both stopped.
+ */
+void ring_reset(adv_ring* ring)
+{
+	ring_pos_set(&ring->head, 0);
+	ring_pos_set(&ring->tail, 0);
+}
+
+/**
+ * Number of samples stored in the ring.
+ * It can be called by any thread without locking.
+ */
+unsigned ring_count(adv_ring* ring)
+{
+	/* read the tail first, the head is never before it */
+	unsigned tail = ring_pos_get(&ring->tail);
+	unsigned head = ring_pos_get(&ring->head);
+
+	return head - tail;
+}
+
+/**
+ * Number of samples that can be written in the ring.
+ * It can be called by any thread without locking.
+ */
+unsigned ring_free(adv_ring* ring)
+{
+	return ring->size - ring_count(ring);
+}
+
+/**
+ * Get the contiguous space to write after the head.
+ * Only for the producer.
+ * \param count Where to put the number of samples that can be written.
+ * \return Where to write the samples.
+ */
+adv_sample* ring_write_map(adv_ring* ring, unsigned* count)
+{
+	unsigned head = ring->head.value;
+	unsigned tail = ring_pos_get(&ring->tail);
+	unsigned pos = head & ring->mask;
+	unsigned run = ring->size - (head - tail);
+
+	if (run > ring->size - pos)
+		run = ring->size - pos;
+
+	*count = run;
+	return ring->map + pos;
+}
+
+/**
+ * Make the written samples available to the consumer.
+ * Only for the producer.
+ */
+void ring_write_commit(adv_ring* ring, unsigned count)
+{
+	ring_pos_set(&ring->head, ring->head.value + count);
+}
+
+/**
+ * Write samples in the ring.
+ * Only for the producer.
+ * \return Number of samples written, less than requested if the ring is full.
+ */
+unsigned ring_write(adv_ring* ring, const adv_sample* sample_map, unsigned sample_count)
+{
+	unsigned done = 0;
+
+	/* at most two runs, the second one after the wraparound */
+	while (done < sample_count) {
+		unsigned run;
+		adv_sample* dst = ring_write_map(ring, &run);
+
+		if (!run)
+			break;
+		if (run > sample_count - done)
+			run = sample_count - done;
+
+		memcpy(dst, sample_map + done, run * sizeof(adv_sample));
+		ring_write_commit(ring, run);
+
+		done += run;
+	}
+
+	return done;
+}
+
+/**
+ * Get the contiguous samples to read after the tail.
+ * Only for the consumer.
+ * \param count Where to put the number of samples that can be read.
+ * \return Where to read the samples.
+ */
+const adv_sample* ring_read_map(adv_ring* ring, unsigned* count)
+{
+	unsigned tail = ring->tail.value;
+	unsigned head = ring_pos_get(&ring->head);
+	unsigned pos = tail & ring->mask;
+	unsigned run = head - tail;
+
+	if (run > ring->size - pos)
+		run = ring->size - pos;
+
+	*count = run;
+	return ring->map + pos;
+}
+
+/**
+ * Free the read samples for the producer.
+ * Only for the consumer.
+ */
+void ring_read_commit(adv_ring* ring, unsigned count)
+{
+	ring_pos_set(&ring->tail, ring->tail.value + count);
+}
+
+/**
+ * Read samples from the ring.
+ * Only for the consumer.
+ * \return Number of samples read, less than requested if the ring is empty.
+ */
+unsigned ring_read(adv_ring* ring, adv_sample* sample_map, unsigned sample_count)
+{
+	unsigned done = 0;
+
+	/* at most two runs, the second one after the wraparound */
+	while (done < sample_count) {
+		unsigned run;
+		const adv_sample* src = ring_read_map(ring, &run);
+
+		if (!run)
+			break;
+		if (run > sample_count - done)
+			run = sample_count - done;
+
+		memcpy(sample_map + done, src, run * sizeof(adv_sample));
+		ring_read_commit(ring, run);
+
+		done += run;
+	}
+
+	return done;
+}
+
@@ -0,0 +1,98 @@
+/*
+ * This file is part of the Advance project.
+ *
+ * Copyright (C) 2003 Andrea Mazzoleni
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * In addition, as a special exception, Andrea Mazzoleni
+ * gives permission to link the code of this program with
+ * the MAME library (or with modified versions of MAME that use the
+ * same license as MAME), and distribute linked combinations including
+ * the two.  You must obey the GNU General Public License in all
+ * respects for all of the code used other than MAME.  If you modify
+ * this file, you may extend this exception to your version of the
+ * file, but you are not obligated to do so.  If you do not wish to
+ * do so, delete this exception statement from your version.
+ */
+
+/** \file
+ * Sound ring buffer.
+ */
+
+#ifndef __RING_H
+#define __RING_H
+
+#include "extra.h"
+#include "sounddrv.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \addtogroup Sound */
+/*@{*/
+
+/**
+ * Size of the cache line.
+ * The positions of the producer and of the consumer are stored in different
+ * cache lines, to avoid to move the line between the processors at every access.
+ */
+#define ADV_RING_CACHE_LINE 64
+
+/**
+ * Position in the ring, alone in a cache line.
+ */
+typedef union adv_ring_pos_union {
+	unsigned value; /**< Position, never wrapped. Only the low bits select the sample. */
+	unsigned char pad[ADV_RING_CACHE_LINE];
+} adv_ring_pos;
+
+/**
+ * Lock-free ring of sound samples with a single producer and a single consumer.
+ * The producer and the consumer can be different threads. The producer only
+ * moves the head, the consumer only moves the tail, and the number of
+ * stored samples can be read by any thread without locking.
+ */
+typedef struct adv_ring_struct {
+	adv_sample* map; /**< Samples. */
+	void* map_raw; /**< Allocated memory of the samples. */
+	unsigned size; /**< Number of samples, a power of 2. */
+	unsigned mask; /**< Mask of the sample index. */
+	unsigned char pad[ADV_RING_CACHE_LINE]; /**< Separation of the read only fields. */
+	adv_ring_pos head; /**< Write position. */
+	adv_ring_pos tail; /**< Read position. */
+} adv_ring;
+
+adv_error ring_init(adv_ring* ring, unsigned size);
+void ring_done(adv_ring* ring);
+void ring_reset(adv_ring* ring);
+unsigned ring_count(adv_ring* ring);
+unsigned ring_free(adv_ring* ring);
+adv_sample* ring_write_map(adv_ring* ring, unsigned* count);
+void ring_write_commit(adv_ring* ring, unsigned count);
+unsigned ring_write(adv_ring* ring, const adv_sample* sample_map, unsigned sample_count);
+const adv_sample* ring_read_map(adv_ring* ring, unsigned* count);
+void ring_read_commit(adv_ring* ring, unsigned count);
+unsigned ring_read(adv_ring* ring, adv_sample* sample_map, unsigned sample_count);
+
+/*@}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
@@ -77,6 +77,15 @@ void target_done(void);
  */
 void target_yield(void);
 
+/**
+ * Raise the priority of the calling thread to real-time.
+ * The thread is then scheduled before all the other not real-time threads,
+ * and it must wait regularly to leave the CPU at the rest of the system.
+ * Generally it requires special privileges.
+ * \return 0 on success.
+ */
+adv_error target_realtime(void);
+
 /**
  * Put the process in idle state.
  * If no process is waiting the current process waits anyway some time.
@@ -114,6 +123,17 @@ extern target_clock_t TARGET_CLOCKS_PER_SEC;
  */
 target_clock_t target_clock(void);
 
+/**
+ * Wait until the specified clock value.
+ * The wait is absolute, and it isn't extended by the signals received.
+ * Note that the wait may end a little later than the requested time,
+ * and on some systems it doesn't wait at all.
+ * The caller has to complete the wait with a busy loop on target_clock().
+ * Calling this function generally reduces the CPU occupation.
+ * \param clock Clock value to wait.
+ */
+void target_usleep_until(target_clock_t clock);
+
 /***************************************************************************/
 /* Hardware */
 
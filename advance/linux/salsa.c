@@ -31,6 +31,7 @@
 #include "portable.h"
 
 #include "salsa.h"
+#include "ring.h"
 #include "snstring.h"
 #include "log.h"
 #include "error.h"
@@ -62,6 +63,7 @@ struct soundb_alsa_context {
 	int volume; /**< Volume adjustement. ALSA_VOLUME_BASE == full volume. */
 	snd_pcm_uframes_t buffer_size; /**< ALSA buffer size in frames. */
 	snd_pcm_uframes_t period_size; /**< ALSA period size in frames. */
+	adv_ring fifo; /**< Samples not yet accepted by ALSA. */
 };
 
 static struct soundb_alsa_context alsa_state;
@@ -263,6 +265,10 @@ adv_error soundb_alsa_init(int sound_id, unsigned* rate, adv_bool stereo_flag, d
 
 	alsa_log(hw_params, sw_params);
 
+	/* room for a full ALSA buffer, the samples wait here when ALSA is full */
+	if (ring_init(&alsa_state.fifo, alsa_state.buffer_size * alsa_state.channel) != 0)
+		goto err_close;
+
 	*rate = alsa_state.rate;
 
 	return 0;
@@ -280,6 +286,8 @@ void soundb_alsa_done(void)
 
 	snd_pcm_drop(alsa_state.handle);
 	snd_pcm_close(alsa_state.handle);
+
+	ring_done(&alsa_state.fifo);
 }
 
 void soundb_alsa_stop(void)
@@ -304,11 +312,12 @@ unsigned soundb_alsa_buffered(void)
 
 	avail = r;
 
-	log_debug(("sound:alsa: buffer_size = %d, snd_pcm_avail() = %d, buffered = %d\n", (int)alsa_state.buffer_size, (int)avail, (int)(alsa_state.buffer_size - avail)));
+	log_debug(("sound:alsa: buffer_size = %d, snd_pcm_avail() = %d, buffered = %d, queued = %d\n", (int)alsa_state.buffer_size, (int)avail, (int)(alsa_state.buffer_size - avail), ring_count(&alsa_state.fifo) / alsa_state.channel));
 
+	/* the samples still in the ring are also buffered */
 	if (avail > alsa_state.buffer_size)
-		return 0;
-	return alsa_state.buffer_size - avail;
+		return ring_count(&alsa_state.fifo) / alsa_state.channel;
+	return alsa_state.buffer_size - avail + ring_count(&alsa_state.fifo) / alsa_state.channel;
 }
 
 static void alsa_volume_channel(double volume)
@@ -423,61 +432,84 @@ void soundb_alsa_volume(double volume)
 		alsa_volume_mixer(volume);
 }
 
-void soundb_alsa_play(const adv_sample* sample_map, unsigned sample_count)
+/**
+ * Move the samples from the ring to ALSA, until ALSA is full.
+ * \return <0 on error.
+ */
+static int alsa_flush(void)
 {
 	int r;
 
-	log_debug(("sound:alsa: soundb_alsa_play(count:%d)\n", sample_count));
+	while (1) {
+		unsigned count;
+		const adv_sample* sample_map = ring_read_map(&alsa_state.fifo, &count);
 
-	/* calling write with a 0 size result in wrong output */
-	while (sample_count) {
-		if (alsa_state.volume == ALSA_VOLUME_BASE) {
-			/* write directly */
-			r = snd_pcm_writei(alsa_state.handle, sample_map, sample_count);
-		} else {
-			/* adjust the volume and write */
-			const unsigned buf_size = 2048;
-			adv_sample buf_map[buf_size];
-			unsigned run;
-			unsigned i;
-
-			run = sample_count * alsa_state.channel;
-			if (run > buf_size)
-				run = buf_size;
+		/* calling write with a 0 size result in wrong output */
+		if (count < alsa_state.channel)
+			return 0;
 
-			for (i = 0; i < run; ++i)
-				buf_map[i] = (int)sample_map[i] * alsa_state.volume / ALSA_VOLUME_BASE;
-
-			r = snd_pcm_writei(alsa_state.handle, buf_map, run / alsa_state.channel);
-		}
+		r = snd_pcm_writei(alsa_state.handle, sample_map, count / alsa_state.channel);
 
 		log_debug(("sound:alsa: snd_pcm_writei() -> %d\n", r));
 
 		if (r < 0) {
-			if (r == -EAGAIN) {
-				/* audio buffer full, it should never happen */
-				log_std(("WARNING:sound:alsa: snd_pcm_writei() failed: internal buffer full\n"));
-				/* retry */
-				continue;
-			}
+			/* audio buffer full, the samples remain in the ring */
+			if (r == -EAGAIN)
+				return 0;
 
 			if (r == -EPIPE)
 				log_std(("ERROR:sound:alsa: snd_pcm_writei() failed: %s. Increase the latency with -sound_latency.\n", snd_strerror(r)));
 			else
 				log_std(("ERROR:sound:alsa: snd_pcm_writei() failed: %s (%d)\n", snd_strerror(r), r));
 
+			r = snd_pcm_prepare(alsa_state.handle);
 			if (r < 0) {
-				r = snd_pcm_prepare(alsa_state.handle);
-				if (r < 0)
-					log_std(("ERROR:sound:alsa: snd_pcm_prepare() failed: %s\n", snd_strerror(r)));
+				log_std(("ERROR:sound:alsa: snd_pcm_prepare() failed: %s\n", snd_strerror(r)));
+				return r;
 			}
+		} else {
+			ring_read_commit(&alsa_state.fifo, r * alsa_state.channel);
+		}
+	}
+}
 
-			if (r < 0) {
-				break;
-			}
+void soundb_alsa_play(const adv_sample* sample_map, unsigned sample_count)
+{
+	unsigned count = sample_count * alsa_state.channel;
+
+	log_debug(("sound:alsa: soundb_alsa_play(count:%d)\n", sample_count));
+
+	while (count) {
+		unsigned run;
+		adv_sample* dst = ring_write_map(&alsa_state.fifo, &run);
+
+		if (run > count)
+			run = count;
+
+		if (alsa_state.volume == ALSA_VOLUME_BASE) {
+			memcpy(dst, sample_map, run * sizeof(adv_sample));
 		} else {
-			sample_count -= r;
-			sample_map += r * alsa_state.channel;
+			/* adjust the volume */
+			unsigned i;
+			for (i = 0; i < run; ++i)
+				dst[i] = (int)sample_map[i] * alsa_state.volume / ALSA_VOLUME_BASE;
+		}
+
+		ring_write_commit(&alsa_state.fifo, run);
+
+		sample_map += run;
+		count -= run;
+
+		if (alsa_flush() < 0) {
+			/* drop everything, the device is unusable */
+			ring_reset(&alsa_state.fifo);
+			break;
+		}
+
+		/* if both ALSA and the ring are full, wait instead of spinning */
+		if (count && ring_free(&alsa_state.fifo) < alsa_state.channel) {
+			log_std(("WARNING:sound:alsa: audio buffer full, wait\n"));
+			snd_pcm_wait(alsa_state.handle, 1000);
 		}
 	}
 }
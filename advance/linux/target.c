@@ -295,6 +295,26 @@ void target_yield(void)
 #endif
 }
 
+adv_error target_realtime(void)
+{
+#if HAVE_SCHED_SETSCHEDULER && HAVE_SCHED_GET_PRIORITY_MAX
+	struct sched_param param;
+
+	/* use the lowest real-time priority, enough to preempt the normal threads */
+	param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+
+	/* the pid 0 is the calling thread */
+	if (sched_setscheduler(0, SCHED_FIFO, &param) != 0) {
+		log_std(("WARNING:linux: sched_setscheduler(SCHED_FIFO) failed with error %d, %s\n", errno, strerror(errno)));
+		return -1;
+	}
+
+	return 0;
+#else
+	return -1;
+#endif
+}
+
 void target_idle(void)
 {
 	struct timespec req;
@@ -344,8 +364,24 @@ void target_usleep(unsigned us)
 
 target_clock_t TARGET_CLOCKS_PER_SEC = 1000000LL;
 
+#if HAVE_CLOCK_GETTIME && HAVE_CLOCK_NANOSLEEP
+/* use the monotonic clock, not affected by the changes of the system time */
+/* and usable for absolute waits with clock_nanosleep() */
+#define USE_CLOCK_MONOTONIC
+#endif
+
 target_clock_t target_clock(void)
 {
+#ifdef USE_CLOCK_MONOTONIC
+	struct timespec ts;
+	target_clock_t r;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	r = ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+
+	return r;
+#else
 	struct timeval tv;
 	target_clock_t r;
 
@@ -354,6 +390,33 @@ target_clock_t target_clock(void)
 	r = tv.tv_sec * 1000000LL + tv.tv_usec;
 
 	return r;
+#endif
+}
+
+void target_usleep_until(target_clock_t clock)
+{
+#ifdef USE_CLOCK_MONOTONIC
+	struct timespec req;
+
+	req.tv_sec = clock / 1000000LL;
+	req.tv_nsec = (clock % 1000000LL) * 1000;
+
+	/* the wait is absolute, and it can be simply restarted if interrupted */
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &req, 0) == EINTR) {
+	}
+#else
+	target_clock_t current = target_clock();
+
+	if (current < clock) {
+		struct timespec req;
+		target_clock_t delay = clock - current;
+
+		req.tv_sec = delay / 1000000LL;
+		req.tv_nsec = (delay % 1000000LL) * 1000;
+
+		nanosleep(&req, 0);
+	}
+#endif
 }
 
 /***************************************************************************/
@@ -64,6 +64,7 @@ MENUOBJS += \
 	$(MENUOBJ)/lib/monitor.o \
 	$(MENUOBJ)/lib/device.o \
 	$(MENUOBJ)/lib/sounddrv.o \
+	$(MENUOBJ)/lib/ring.o \
 	$(MENUOBJ)/lib/snone.o \
 	$(MENUOBJ)/lib/keydrv.o \
 	$(MENUOBJ)/lib/keyall.o \
@@ -232,6 +232,7 @@ static void help(void)
 	target_out("%slistbare       output the rom XML file removing info not required by frontends\n", slash);
 	target_out("%srecord FILE    record an .inp file\n", slash);
 	target_out("%splayback FILE  play an .inp file\n", slash);
+	target_out("%sbench SECONDS  run a headless benchmark and print a report\n", slash);
 	target_out("%sversion        print the version\n", slash);
 	target_out("\n");
 #ifdef MESS
@@ -613,6 +614,31 @@ int osd_has_save_config(void)
 	return !CONTEXT.global.config.autosave;
 }
 
+/**
+ * Force the options of the benchmark mode.
+ * They have the highest priority, over the command line and all the
+ * configuration files. The emulation runs unthrottled for the
+ * specified time, without any video, sound and input device.
+ */
+static adv_error bench_load(adv_conf* context, int seconds)
+{
+	char time_buffer[16];
+	char* arg_map[] = {
+		"-device_video", "none",
+		"-device_sound", "none",
+		"-device_keyboard", "none",
+		"-device_joystick", "none",
+		"-device_mouse", "none",
+		"-misc_timetorun", time_buffer,
+		"-misc_quiet"
+	};
+	int arg_mac = sizeof(arg_map) / sizeof(arg_map[0]);
+
+	snprintf(time_buffer, sizeof(time_buffer), "%d", seconds);
+
+	return conf_input_args_load(context, 5, "", &arg_mac, arg_map, error_callback, 0);
+}
+
 /***************************************************************************/
 /* Main */
 
@@ -631,6 +657,7 @@ int os_main(int argc, char* argv[])
 	const char* opt_cfg;
 	char* opt_gamename;
 	int opt_version;
+	int opt_bench;
 	struct advance_context* context = &CONTEXT;
 	const char* section_map[32];
 	unsigned section_mac;
@@ -649,6 +676,7 @@ int os_main(int argc, char* argv[])
 	opt_version = 0;
 	opt_help = 0;
 	opt_cfg = 0;
+	opt_bench = 0;
 
 	memset(&option, 0, sizeof(option));
 	memset(&CONTEXT, 0, sizeof(CONTEXT));
@@ -686,6 +714,8 @@ int os_main(int argc, char* argv[])
 		goto err_os;
 	if (advance_record_init(&context->record, context->cfg) != 0)
 		goto err_os;
+	if (advance_timeline_init(&context->timeline, context->cfg) != 0)
+		goto err_os;
 	if (advance_fileio_init(&context->fileio, context->cfg) != 0)
 		goto err_os;
 	if (advance_safequit_init(&context->safequit, context->cfg) != 0)
@@ -731,6 +761,13 @@ int os_main(int argc, char* argv[])
 			else
 				snprintf(option.playback_file_buffer, sizeof(option.playback_file_buffer), "%s", argv[i + 1]);
 			++i;
+		} else if (target_option_compare(argv[i], "bench") && i + 1 < argc && argv[i + 1][0] != '-') {
+			opt_bench = atoi(argv[i + 1]);
+			if (opt_bench <= 0 || opt_bench > 3600) {
+				target_err("Invalid argument '%s' for option 'bench'.\n", argv[i + 1]);
+				goto err_os;
+			}
+			++i;
 		} else if (target_option_extract(argv[i]) == 0) {
 			unsigned j;
 			if (opt_gamename) {
@@ -747,6 +784,12 @@ int os_main(int argc, char* argv[])
 		}
 	}
 
+	if (opt_bench) {
+		if (bench_load(context->cfg, opt_bench) != 0)
+			goto err_os;
+		option.bench_flag = 1;
+	}
+
 	if (opt_cfg) {
 		sncpy(cfg_buffer, sizeof(cfg_buffer), file_config_file_home(opt_cfg));
 	} else {
@@ -948,6 +991,8 @@ int os_main(int argc, char* argv[])
 		goto err_os;
 	if (advance_record_config_load(&context->record, context->cfg) != 0)
 		goto err_os;
+	if (advance_timeline_config_load(&context->timeline, context->cfg) != 0)
+		goto err_os;
 	if (advance_fileio_config_load(&context->fileio, context->cfg, &option) != 0)
 		goto err_os;
 	if (advance_safequit_config_load(&context->safequit, context->cfg) != 0)
@@ -977,8 +1022,10 @@ int os_main(int argc, char* argv[])
 		goto err_inner_input;
 	if (advance_safequit_inner_init(&context->safequit, &option) != 0)
 		goto err_inner_ui;
-	if (hardware_script_inner_init() != 0)
+	if (advance_timeline_inner_init(&context->timeline) != 0)
 		goto err_inner_safequit;
+	if (hardware_script_inner_init() != 0)
+		goto err_inner_timeline;
 
 	log_std(("emu: mame_game_run()\n"));
 
@@ -989,6 +1036,7 @@ int os_main(int argc, char* argv[])
 	log_std(("emu: *_inner_done()\n"));
 
 	hardware_script_inner_done();
+	advance_timeline_inner_done(&context->timeline);
 	advance_safequit_inner_done(&context->safequit);
 	advance_ui_inner_done(&context->ui);
 	advance_input_inner_done(&context->input);
@@ -1004,6 +1052,7 @@ int os_main(int argc, char* argv[])
 	hardware_script_done();
 	advance_safequit_done(&context->safequit);
 	advance_fileio_done(&context->fileio);
+	advance_timeline_done(&context->timeline);
 	advance_record_done(&context->record);
 	advance_ui_done(&context->ui);
 	advance_input_done(&context->input);
@@ -1046,6 +1095,8 @@ done_os:
 
 err_inner_script:
 	hardware_script_inner_done();
+err_inner_timeline:
+	advance_timeline_inner_done(&context->timeline);
 err_inner_safequit:
 	advance_safequit_inner_done(&context->safequit);
 err_inner_ui:
@@ -1061,6 +1112,7 @@ err_os_inner:
 	hardware_script_done();
 	advance_safequit_done(&context->safequit);
 	advance_fileio_done(&context->fileio);
+	advance_timeline_done(&context->timeline);
 	advance_record_done(&context->record);
 	advance_ui_done(&context->ui);
 	advance_input_done(&context->input);
@@ -311,6 +311,44 @@ struct ui_color_set {
 	struct ui_color help_u; /**< Help unassigned foreground. */
 };
 
+#define UI_HELP_KEY_MAX 512 /**< Max number of help keys to highlight. */
+
+struct ui_help_key {
+	unsigned index; /**< Entry in the help map. */
+	unsigned player; /**< Player of the port, 0 for global ports. */
+	adv_bool pressed_flag; /**< If the port is pressed. */
+};
+
+/**
+ * User interface to draw in a frame.
+ * It's taken from the user interface state by the MAME thread, and it's
+ * not changed until the frame is drawn. It's so safe to draw it from the
+ * video thread.
+ */
+struct advance_ui_frame {
+	adv_bool extra_flag; /**< Extra frame to be drawn to clear the off game border. */
+	adv_bool message_flag; /**< Message to draw. */
+	char message_buffer[256];
+	adv_bool help_flag; /**< Help to draw. */
+	struct ui_help_key help_key_map[UI_HELP_KEY_MAX]; /**< Help keys to highlight. */
+	unsigned help_key_mac;
+	char help_buffer[256]; /**< Help message with the ports pressed. */
+	adv_bool menu_flag; /**< Menu to draw. */
+	struct ui_menu_entry* menu_map;
+	unsigned menu_mac;
+	unsigned menu_sel;
+	adv_bool osd_flag; /**< On Screen Display to draw. */
+	char osd_buffer[256];
+	adv_bool scroll_flag; /**< Scroll to draw. */
+	char* scroll_begin;
+	char* scroll_end;
+	unsigned scroll_pos;
+	adv_bool direct_text_flag; /**< Direct text to draw. */
+	char direct_buffer[256];
+	adv_bool direct_slow_flag; /**< Direct slow tag to draw. */
+	adv_bool direct_fast_flag; /**< Direct fast tag to draw. */
+};
+
 struct advance_ui_config_context {
 	unsigned help_mac; /**< Number of help entries. */
 	struct help_entry help_map[INPUT_HELP_MAX]; /**< Help map. */
@@ -380,8 +418,13 @@ unsigned advance_ui_menu_text_insert(struct ui_menu* menu, const char* text);
 unsigned advance_ui_menu_option_insert(struct ui_menu* menu, const char* text, const char* option);
 void advance_ui_menu_dft_insert(struct ui_menu* menu, double* m, unsigned n, double cut0, double cut1);
 
-void advance_ui_buffer_update(struct advance_ui_context* context, void* ptr, unsigned dx, unsigned dy, unsigned dw, adv_color_def color_def, adv_color_rgb* palette_map, unsigned palette_max);
-void advance_ui_direct_update(struct advance_ui_context* context, void* ptr, unsigned dx, unsigned dy, unsigned dw, adv_color_def color_def, adv_color_rgb* palette_map, unsigned palette_max);
+void advance_ui_frame_init(struct advance_ui_frame* frame);
+void advance_ui_frame_done(struct advance_ui_frame* frame);
+void advance_ui_frame_set(struct advance_ui_context* context, struct advance_ui_frame* frame);
+adv_bool advance_ui_frame_buffer_active(const struct advance_ui_frame* frame);
+adv_bool advance_ui_frame_direct_active(const struct advance_ui_frame* frame);
+void advance_ui_buffer_update(struct advance_ui_context* context, const struct advance_ui_frame* frame, void* ptr, unsigned dx, unsigned dy, unsigned dw, adv_color_def color_def, adv_color_rgb* palette_map, unsigned palette_max);
+void advance_ui_direct_update(struct advance_ui_context* context, const struct advance_ui_frame* frame, void* ptr, unsigned dx, unsigned dy, unsigned dw, adv_color_def color_def, adv_color_rgb* palette_map, unsigned palette_max);
 adv_error advance_ui_init(struct advance_ui_context* context, adv_conf* cfg_context);
 adv_error advance_ui_config_load(struct advance_ui_context* context, adv_conf* cfg_context, struct mame_option* option);
 void advance_ui_done(struct advance_ui_context* context);
@@ -456,6 +499,19 @@ adv_error advance_record_png_write(adv_fz* f, const void* video_buffer, unsigned
 /***************************************************************************/
 /* Estimate */
 
+/** Number of frames in the history of the measured times. */
+#define ESTIMATE_HISTORY_MAX 64
+
+/**
+ * History of the last measured times.
+ * Used to get the percentiles of the time distribution.
+ */
+struct advance_estimate_history {
+	double map[ESTIMATE_HISTORY_MAX]; /**< Last measured times. */
+	unsigned mac; /**< Number of times stored. */
+	unsigned pos; /**< Position of the next time to store. */
+};
+
 struct advance_estimate_context {
 	double estimate_mame_full; /**< Estimate time for a MAME full frame */
 	double estimate_mame_skip; /**< Estimate time for a MAME skip frame */
@@ -464,6 +520,7 @@ struct advance_estimate_context {
 	double estimate_common_full;
 	double estimate_common_skip;
 	double estimate_frame; /**< Estimate time for a MAME+OSD frame */
+	double estimate_queue; /**< Estimate time from the queuing of a frame to the video thread to its completion */
 	adv_bool estimate_mame_flag; /**< If last time at point 1 is set */
 	adv_bool estimate_osd_flag; /**< If last time at point 2 is set */
 	adv_bool estimate_frame_flag; /**< If last time at point 3 is set */
@@ -472,6 +529,10 @@ struct advance_estimate_context {
 	double estimate_osd_last; /**< Last time at point 2 */
 	double estimate_frame_last; /**< Last time at point 3 */
 	double estimate_common_last;
+	struct advance_estimate_history history_mame_full; /**< History of the MAME full frame times */
+	struct advance_estimate_history history_mame_skip; /**< History of the MAME skip frame times */
+	struct advance_estimate_history history_osd_full; /**< History of the OSD full frame times */
+	struct advance_estimate_history history_osd_skip; /**< History of the OSD skip frame times */
 };
 
 void advance_estimate_init(struct advance_estimate_context* context, double step);
@@ -483,6 +544,75 @@ void advance_estimate_osd_end(struct advance_estimate_context* context, adv_bool
 void advance_estimate_frame(struct advance_estimate_context* context);
 void advance_estimate_common_begin(struct advance_estimate_context* context);
 void advance_estimate_common_end(struct advance_estimate_context* context, adv_bool skip_flag);
+void advance_estimate_queue(struct advance_estimate_context* context, double latency);
+double advance_estimate_percentile(const struct advance_estimate_history* history, double estimate, double percentile);
+
+/***************************************************************************/
+/* Timeline */
+
+/** Number of frames stored in the timeline. */
+#define TIMELINE_FRAME_MAX 1024
+
+/**
+ * Phases of a frame measured in the timeline.
+ * The first ones run in the emulation thread, the others in the video thread if active.
+ */
+enum advance_timeline_phase {
+	TIMELINE_INPUT = 0, /**< Poll of the input. */
+	TIMELINE_EMULATION = 1, /**< Emulation of the frame. */
+	TIMELINE_UPDATE = 2, /**< MAME video update. */
+	TIMELINE_PREPARE = 3, /**< OSD preparation of the frame. */
+	TIMELINE_SYNC = 4, /**< Wait of the frame time. */
+	TIMELINE_BLIT = 5, /**< Blit of the frame. */
+	TIMELINE_AUDIO = 6, /**< Enqueue of the audio samples. */
+	TIMELINE_PRESENT = 7, /**< Presentation of the frame, with the optional vsync wait. */
+	TIMELINE_MAX = 8
+};
+
+#define TIMELINE_FORMAT_NONE 0 /**< Timeline disabled. */
+#define TIMELINE_FORMAT_JSON 1 /**< Chrome trace event JSON. */
+#define TIMELINE_FORMAT_CSV 2 /**< One CSV row for frame. */
+
+/** Times of a frame. A zero time means that the phase is not reached. */
+struct advance_timeline_frame {
+	unsigned counter; /**< Number of the frame. */
+	adv_bool skip_flag; /**< If the frame is skipped. */
+	target_clock_t begin[TIMELINE_MAX]; /**< Begin time of every phase. */
+	target_clock_t end[TIMELINE_MAX]; /**< End time of every phase. */
+	target_clock_t sound_time; /**< Time of the sound measure. Zero if not measured. */
+	int sound_buffered; /**< Sound samples buffered. */
+	int sound_target; /**< Target of the sound samples buffered. */
+	double sound_correction; /**< Rate correction of the sound. */
+};
+
+struct advance_timeline_config_context {
+	int format; /**< Format of the saved timeline, or TIMELINE_FORMAT_NONE to disable it. */
+	char dir_buffer[FILE_MAXPATH]; /**< Directory where to save the timeline. */
+};
+
+struct advance_timeline_state_context {
+	adv_bool active_flag; /**< If the timeline is recorded. */
+	struct advance_timeline_frame* frame_map; /**< Ring of the last frames. */
+	unsigned counter; /**< Number of the current frame. */
+	target_clock_t base; /**< Time of the start of the recording. */
+};
+
+struct advance_timeline_context {
+	struct advance_timeline_config_context config;
+	struct advance_timeline_state_context state;
+};
+
+adv_error advance_timeline_init(struct advance_timeline_context* context, adv_conf* cfg_context);
+void advance_timeline_done(struct advance_timeline_context* context);
+adv_error advance_timeline_inner_init(struct advance_timeline_context* context);
+void advance_timeline_inner_done(struct advance_timeline_context* context);
+adv_error advance_timeline_config_load(struct advance_timeline_context* context, adv_conf* cfg_context);
+
+unsigned advance_timeline_frame(struct advance_timeline_context* context);
+void advance_timeline_next(struct advance_timeline_context* context, adv_bool skip_flag);
+void advance_timeline_begin(struct advance_timeline_context* context, unsigned counter, unsigned phase);
+void advance_timeline_end(struct advance_timeline_context* context, unsigned counter, unsigned phase);
+void advance_timeline_sound(struct advance_timeline_context* context, unsigned counter, int buffered, int target, double correction);
 
 /***************************************************************************/
 /* Sound */
@@ -539,6 +669,16 @@ struct advance_sound_state_context {
 
 	unsigned sample_mult; /**< Current volume sample multiplicator. */
 
+	short scale_last[2]; /**< Last sample of the previous frame for every channel, the start of the internal resampling. */
+
+	/* Rate control */
+	int rate_buffered; /**< Last measure of the buffered samples. */
+	int rate_target; /**< Target of the buffered samples. */
+	double rate_integral; /**< Integral term of the rate controller. */
+	double rate_correction; /**< Current rate correction, positive if less samples are played. */
+	double rate_fraction; /**< Fraction of sample of the correction not yet applied. */
+	unsigned rate_counter; /**< Frame counter for the periodic log. */
+
 	unsigned adjust_power_db_map[SOUND_POWER_DB_MAX]; /**< Power normalization table. */
 	unsigned adjust_power_db_counter; /**< Counter of the insertion in the ::adjust_power_db_map table. */
 	unsigned char* adjust_power_history_map; /**< History of the power measures. */
@@ -586,6 +726,7 @@ void advance_sound_done(struct advance_sound_context* context);
 adv_error advance_sound_config_load(struct advance_sound_context* context, adv_conf* cfg_context, struct mame_option* game_options);
 int advance_sound_latency_diff(struct advance_sound_context* context, double extra_latency);
 int advance_sound_latency(struct advance_sound_context* context, double extra_latency);
+int advance_sound_rate_control(struct advance_sound_context* context, int latency_error, unsigned sample_count);
 void advance_sound_reconfigure(struct advance_sound_context* context, struct advance_sound_config_context* config);
 void advance_sound_config_save(struct advance_sound_context* context, const char* section);
 
@@ -684,12 +825,15 @@ struct advance_video_config_context {
 	double fps_fixed; /**< Fixed fps. If ==0 use the original fps. */
 	int fastest_time; /**< Time for turbo at the startup [seconds]. */
 	int measure_time; /**< Time for the speed measure [seconds]. */
+	adv_bool bench_flag; /**< Benchmark mode, profile the measure without blitting [boolean]. */
 	adv_bool restore_flag; /**< Reset the video mode at the exit [boolean]. */
 	unsigned magnify_factor; /**< Magnify factor requested [0=auto,1,2,3,4]. */
 	unsigned magnify_size; /**< Magnify target size. */
 	unsigned index; /**< Index mode. */
 	double frameskip_factor; /**< Current frameskip factor. */
 	adv_bool frameskip_auto_flag; /**< boolean. */
+	adv_bool frameskip_predict_flag; /**< Use the predictive controller for the auto frameskip. */
+	adv_bool frameskip_blit_flag; /**< Allow to skip only the blit and not the MAME draw. */
 	double aspect_expansion_factor; /**< Expansion factor of the aspect. */
 	adv_monitor monitor; /**< Monitor specifications. */
 	adv_generate_interpolate_set interpolate; /**< Video mode generator specifications. */
@@ -699,6 +843,10 @@ struct advance_video_config_context {
 	char section_resolutionclock_buffer[256]; /**< Section used to store the option for the resolution/freq. */
 	char section_orientation_buffer[256]; /**< Section used to store the option for the orientation. */
 	adv_bool smp_flag; /**< Use threads */
+	unsigned smp_queue; /**< Max number of frames queued to the video thread. */
+	adv_bool realtime_flag; /**< Use the real-time priority. */
+	adv_bool unchanged_flag; /**< Skip the blit of the unchanged rows. */
+	int blit_level; /**< Instruction set level of the blit functions, VIDEO_BLIT_LEVEL_AUTO for automatic. */
 	adv_bool crash_flag; /**< If enable the crash menu entry. */
 	adv_bool rawsound_flag; /**< Force the generation of all the sound samples. */
 	unsigned monitor_aspect_x; /**< Horizontal aspect of the monitor (4 for a standard monitor) */
@@ -720,6 +868,43 @@ struct advance_video_config_context {
 #define PIPELINE_MEASURE_MAX 13
 #define PIPELINE_BLIT_MAX 2 /**< Number of pipelines to create. 0 for buffered, 1 for direct write. */
 
+/** Max number of frames queued to the video thread. */
+#define THREAD_QUEUE_MAX 3
+
+/** Number of game bitmaps in the ring shared with the video thread. One more than the queued frames. */
+#define THREAD_RING_MAX (THREAD_QUEUE_MAX + 1)
+
+/**
+ * Frame queued to the video thread.
+ */
+struct advance_video_thread_frame {
+	struct osd_bitmap* game; /**< Game bitmap to draw. It points to game_ring or game_copy. */
+	struct osd_bitmap game_ring; /**< Game bitmap, taken from the ring. */
+	struct osd_bitmap* game_copy; /**< Game bitmap, copied from the MAME one. */
+	short* sample_buffer; /**< Game sound to play. */
+	unsigned sample_count;
+	unsigned sample_recount;
+	unsigned sample_max;
+	unsigned led; /**< Game led to set. */
+	unsigned input; /**< Input to process. */
+	adv_bool skip_flag; /**< Frame skip_flag to use. */
+	struct advance_ui_frame ui; /**< User interface to draw. */
+	double time; /**< Time when the frame was queued. */
+	unsigned timeline; /**< Frame number in the timeline. */
+};
+
+#define CHANGE_PAGE_MAX 3 /**< Max number of video pages tracked for the unchanged rows. */
+
+/** Rows drawn in a video page. */
+struct advance_video_change_page {
+	adv_bool valid_flag; /**< If the page contains the rows of the hash_map. */
+	unsigned pipeline_index; /**< Pipeline used to draw the rows. */
+	unsigned x; /**< Position of the rows in the screen. */
+	unsigned y; /**< Position of the rows in the screen. */
+	unsigned palette_generation; /**< Palette used to draw the rows. */
+	uint64* hash_map; /**< Hash of the source rows drawn. */
+};
+
 /** State for the video part. */
 struct advance_video_state_context {
 	int av_sync_map[AUDIOVIDEO_MEASURE_MAX]; /**< Circular buffer of the most recent audio/video syncronization measures. */
@@ -743,6 +928,7 @@ struct advance_video_state_context {
 	adv_color_def game_color_def; /**< Game color format. */
 
 	adv_bool debugger_flag; /**< Debugger show flag. */
+	struct advance_ui_frame ui_frame; /**< User interface to draw in the frames not drawn by the video thread. */
 
 	double gamma_effect_factor; /**< Gamma value required by the display effect. */
 
@@ -770,6 +956,7 @@ struct advance_video_state_context {
 	osd_mask_t* palette_dirty_map; /**< If the palette is dirty this is the list of dirty colors. */
 	osd_mask_t palette_dirty_mask; /**< Mask for the last dirty element. */
 	adv_bool palette_dirty_flag; /**< If the current palette dirty, it need to be updated. */
+	unsigned palette_generation; /**< Counter of the changes of the software palette. */
 	uint32* palette_index32_map; /**< Software palette at 32 bit. */
 	uint16* palette_index16_map; /**< Software palette at 16 bit. */
 	uint8* palette_index8_map; /**< Software palette at 8 bit. */
@@ -783,10 +970,17 @@ struct advance_video_state_context {
 	double sync_last; /**< Time of the last syncronization. */
 	adv_bool sync_throttle_flag; /**< Throttle mode flag. */
 	unsigned sync_skip_counter; /**< Number of frames skipped. */
+	double sync_spin; /**< Time before the frame deadline waited with a busy loop. */
+	unsigned sync_late_counter; /**< Number of frame deadlines waited. */
+	unsigned sync_late_miss; /**< Number of frame deadlines missed by more than 100 us. */
+	double sync_late_sum; /**< Sum of the lateness of the frames. */
+	double sync_late_max; /**< Max lateness of the frames. */
 
 	/* Frameskip */
 	adv_bool skip_warming_up_flag; /**< Initializing flag. */
 	adv_bool skip_flag; /**< Skip the next frame flag. */
+	adv_bool skip_draw_flag; /**< Skip also the MAME draw of the next frame, otherwise only the blit. */
+	unsigned skip_plan_counter; /**< Position in the pattern of the predictive frameskip. */
 	double skip_step; /**< Time for one frame. */
 	unsigned skip_level_counter; /**< Current position in the cycle. */
 	unsigned skip_level_full; /**< Number of frames to draw in the cycle. */
@@ -804,15 +998,20 @@ struct advance_video_state_context {
 	pthread_cond_t thread_video_cond; /**< Thread start/stop condition. */
 	pthread_mutex_t thread_video_mutex; /**< Thread access control. */
 	adv_bool thread_exit_flag; /**< If the thread must exit. */
-	adv_bool thread_state_ready_flag; /**< If the thread data is ready. */
-	struct osd_bitmap* thread_state_game; /**< Thread game bitmap to draw. */
-	short* thread_state_sample_buffer; /**< Thread game sound to play. */
-	unsigned thread_state_sample_count;
-	unsigned thread_state_sample_recount;
-	unsigned thread_state_sample_max;
-	unsigned thread_state_led; /**< Thread game led to set. */
-	unsigned thread_state_input; /**< Thread input to process. */
-	adv_bool thread_state_skip_flag; /**< Thread frame skip_flag to use. */
+	struct advance_video_thread_frame thread_queue_map[THREAD_QUEUE_MAX]; /**< Frames queued to the thread. */
+	unsigned thread_queue_in; /**< Position where to queue the next frame. */
+	unsigned thread_queue_out; /**< Position of the frame to draw by the thread. */
+	unsigned thread_queue_count; /**< Number of frames queued, including the one in drawing. */
+	double thread_queue_latency_max; /**< Max time from the queuing to the completion of a frame. */
+	double thread_queue_latency_sum; /**< Sum of the times from the queuing to the completion of the frames. */
+	unsigned thread_queue_latency_count; /**< Number of frames in the sum. */
+	void* thread_ring_map[THREAD_RING_MAX]; /**< Ring of memory blocks used for the game bitmap. The first one is owned by MAME. */
+	unsigned thread_ring_mac; /**< Number of blocks in the ring, 0 if not allocated. */
+	unsigned thread_ring_size; /**< Size of every block in the ring. */
+	unsigned thread_ring_pos; /**< Block where MAME draws the next frame. */
+	adv_bool thread_ring_fail_flag; /**< If the ring cannot be allocated. */
+	void* thread_ring_copy_src; /**< Block to copy in the block where MAME draws, 0 if none. */
+	void* thread_ring_copy_dst; /**< Block where MAME draws, target of the copy. */
 #endif
 
 	unsigned frame_counter; /**< Counter of number of frames. */
@@ -845,6 +1044,15 @@ struct advance_video_state_context {
 	struct video_pipeline_struct blit_pipeline[PIPELINE_BLIT_MAX]; /**< Put pipeline to video. */
 	unsigned blit_pipeline_index; /**< Pipeline to use. */
 
+	/* Unchanged rows */
+	struct advance_video_change_page change_page_map[CHANGE_PAGE_MAX]; /**< Rows drawn in every video page. */
+	unsigned change_page_max; /**< Number of pages tracked, 0 if disabled. */
+	unsigned change_size; /**< Number of source rows tracked. */
+	unsigned char* change_map; /**< Rows changed in the current frame. */
+	unsigned long long change_row_total; /**< Number of target rows to draw. */
+	unsigned long long change_row_skip; /**< Number of target rows not drawn because unchanged. */
+	unsigned change_frame_skip; /**< Number of frames not drawn because unchanged. */
+
 	/* Buffer info */
 	int buffer_src_dp; /**< Source pixel step of the game bitmap. */
 	int buffer_src_dw; /**< Source row step of the game bitmap. */
@@ -943,11 +1151,12 @@ void advance_video_mode_done(struct advance_video_context* context);
 adv_error advance_video_mode_update(struct advance_video_context* context);
 
 void advance_video_thread_wait(struct advance_video_context* context);
+void advance_video_thread_bitmap_wait(struct advance_video_context* context);
 void advance_video_reconfigure(struct advance_video_context* context, struct advance_video_config_context* config);
 
 void advance_video_skip(struct advance_video_context* context, struct advance_estimate_context* estimate_context, struct advance_record_context* record_context);
 void advance_video_sync(struct advance_video_context* context, struct advance_sound_context* sound_context, struct advance_estimate_context* estimate_context, adv_bool skip_flag);
-void advance_video_frame(struct advance_video_context* context, struct advance_record_context* record_context, struct advance_ui_context* ui_context, const struct osd_bitmap* game, const struct osd_bitmap* debug, const osd_rgb_t* debug_palette, unsigned debug_palette_size, adv_bool skip_flag);
+void advance_video_frame(struct advance_video_context* context, struct advance_record_context* record_context, struct advance_ui_context* ui_context, const struct advance_ui_frame* ui_frame, const struct osd_bitmap* game, const struct osd_bitmap* debug, const osd_rgb_t* debug_palette, unsigned debug_palette_size, adv_bool skip_flag);
 void advance_sound_frame(struct advance_sound_context* context, struct advance_record_context* record_context, struct advance_video_context* video_context, struct advance_safequit_context* safequit_context, const short* sample_buffer, unsigned sample_count, unsigned sample_recount, adv_bool normal_speed);
 
 adv_bool advance_video_is_programmable(const struct advance_video_context* context);
@@ -1033,6 +1242,7 @@ struct advance_context {
 	struct advance_global_context global;
 	struct advance_video_context video;
 	struct advance_estimate_context estimate;
+	struct advance_timeline_context timeline;
 	struct advance_input_context input;
 	struct advance_sound_context sound;
 	struct advance_record_context record;
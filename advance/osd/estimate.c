@@ -37,6 +37,30 @@ static inline double estimate_merge(double estimator, double v)
 	return 0.95 * estimator + 0.05 * v;
 }
 
+static inline void estimate_history(struct advance_estimate_history* history, double v)
+{
+	history->map[history->pos] = v;
+
+	if (history->pos == ESTIMATE_HISTORY_MAX - 1)
+		history->pos = 0;
+	else
+		++history->pos;
+
+	if (history->mac < ESTIMATE_HISTORY_MAX)
+		++history->mac;
+}
+
+static int estimate_compare(const void* void_a, const void* void_b)
+{
+	const double* a = (const double*)void_a;
+	const double* b = (const double*)void_b;
+	if (*a < *b)
+		return -1;
+	if (*a > *b)
+		return 1;
+	return 0;
+}
+
 void advance_estimate_init(struct advance_estimate_context* context, double step)
 {
 	context->estimate_mame_flag = 0;
@@ -51,6 +75,16 @@ void advance_estimate_init(struct advance_estimate_context* context, double step
 	context->estimate_osd_full = 0.1 * step;
 	context->estimate_common_skip = 0.001 * step;
 	context->estimate_common_full = 0.001 * step;
+	context->estimate_queue = step;
+
+	context->history_mame_full.mac = 0;
+	context->history_mame_full.pos = 0;
+	context->history_mame_skip.mac = 0;
+	context->history_mame_skip.pos = 0;
+	context->history_osd_full.mac = 0;
+	context->history_osd_full.pos = 0;
+	context->history_osd_skip.mac = 0;
+	context->history_osd_skip.pos = 0;
 }
 
 void advance_estimate_mame_end(struct advance_estimate_context* context, adv_bool skip_flag)
@@ -60,10 +94,13 @@ void advance_estimate_mame_end(struct advance_estimate_context* context, adv_boo
 	if (context->estimate_mame_flag) {
 		double previous;
 		previous = current - context->estimate_mame_last;
-		if (skip_flag)
+		if (skip_flag) {
 			context->estimate_mame_skip = estimate_merge(context->estimate_mame_skip, previous);
-		else
+			estimate_history(&context->history_mame_skip, previous);
+		} else {
 			context->estimate_mame_full = estimate_merge(context->estimate_mame_full, previous);
+			estimate_history(&context->history_mame_full, previous);
+		}
 	}
 }
 
@@ -82,10 +119,13 @@ void advance_estimate_osd_end(struct advance_estimate_context* context, adv_bool
 	if (context->estimate_osd_flag) {
 		double previous;
 		previous = current - context->estimate_osd_last;
-		if (skip_flag)
+		if (skip_flag) {
 			context->estimate_osd_skip = estimate_merge(context->estimate_osd_skip, previous);
-		else
+			estimate_history(&context->history_osd_skip, previous);
+		} else {
 			context->estimate_osd_full = estimate_merge(context->estimate_osd_full, previous);
+			estimate_history(&context->history_osd_full, previous);
+		}
 	}
 }
 
@@ -111,6 +151,11 @@ void advance_estimate_common_end(struct advance_estimate_context* context, adv_b
 	}
 }
 
+void advance_estimate_queue(struct advance_estimate_context* context, double latency)
+{
+	context->estimate_queue = estimate_merge(context->estimate_queue, latency);
+}
+
 void advance_estimate_mame_begin(struct advance_estimate_context* context)
 {
 	double current = advance_timer();
@@ -133,3 +178,21 @@ void advance_estimate_frame(struct advance_estimate_context* context)
 	context->estimate_frame_last = current;
 }
 
+/**
+ * Get a percentile of the recent times.
+ * \param history History of the times.
+ * \param estimate Estimate to use if the history is empty.
+ * \param percentile Percentile to get, from 0 to 1.
+ */
+double advance_estimate_percentile(const struct advance_estimate_history* history, double estimate, double percentile)
+{
+	double map[ESTIMATE_HISTORY_MAX];
+
+	if (history->mac == 0)
+		return estimate;
+
+	memcpy(map, history->map, history->mac * sizeof(double));
+	qsort(map, history->mac, sizeof(double), estimate_compare);
+
+	return map[(unsigned)(percentile * (history->mac - 1) + 0.5)];
+}
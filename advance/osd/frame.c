@@ -431,6 +431,202 @@ adv_error advance_video_update_index(struct advance_video_context* context)
 	return 0;
 }
 
+/***************************************************************************/
+/* Unchanged rows */
+
+static inline uint64 video_change_hash_word(uint64 hash, uint64 word)
+{
+	/* the xor, the multiplication by an odd number and the rotation are */
+	/* all invertible, so a single changed word always changes the hash */
+	hash = (hash ^ word) * 0x100000001B3ULL;
+	return (hash << 31) | (hash >> 33);
+}
+
+/**
+ * Compute the hash of a source row.
+ */
+static uint64 video_change_hash(const unsigned char* ptr, unsigned size_x, int dp, unsigned bytes_per_pixel)
+{
+	uint64 hash = 0xCBF29CE484222325ULL;
+	unsigned i;
+
+	if (dp == (int)bytes_per_pixel || dp == -(int)bytes_per_pixel) {
+		unsigned size = size_x * bytes_per_pixel;
+
+		/* contiguous row, it's read in memory order */
+		if (dp < 0)
+			ptr -= size - bytes_per_pixel;
+
+		for (i = 0; i + 8 <= size; i += 8) {
+			uint64 word;
+			memcpy(&word, ptr + i, 8);
+			hash = video_change_hash_word(hash, word);
+		}
+		for (; i < size; ++i)
+			hash = video_change_hash_word(hash, ptr[i]);
+	} else {
+		/* row with a pixel step, like a column of a rotated game */
+		switch (bytes_per_pixel) {
+		case 1:
+			for (i = 0; i < size_x; ++i, ptr += dp)
+				hash = video_change_hash_word(hash, *ptr);
+			break;
+		case 2:
+			for (i = 0; i < size_x; ++i, ptr += dp)
+				hash = video_change_hash_word(hash, *(const uint16*)ptr);
+			break;
+		default:
+			for (i = 0; i < size_x; ++i, ptr += dp)
+				hash = video_change_hash_word(hash, *(const uint32*)ptr);
+			break;
+		}
+	}
+
+	return hash;
+}
+
+/**
+ * Forget the rows drawn in all the video pages.
+ * At the next frame all the rows are drawn.
+ */
+static void video_change_invalidate(struct advance_video_context* context)
+{
+	unsigned i;
+
+	for (i = 0; i < context->state.change_page_max; ++i)
+		context->state.change_page_map[i].valid_flag = 0;
+}
+
+static void video_change_done(struct advance_video_context* context)
+{
+	unsigned i;
+
+	for (i = 0; i < context->state.change_page_max; ++i) {
+		free(context->state.change_page_map[i].hash_map);
+		context->state.change_page_map[i].hash_map = 0;
+	}
+
+	free(context->state.change_map);
+	context->state.change_map = 0;
+	context->state.change_page_max = 0;
+	context->state.change_size = 0;
+}
+
+static void video_change_init(struct advance_video_context* context)
+{
+	unsigned page_max;
+	unsigned size;
+	unsigned i;
+
+	video_change_done(context);
+
+	if (!context->config.unchanged_flag)
+		return;
+
+	/* every video page keeps the rows drawn the last time it was used */
+	page_max = update_page_max_get();
+	if (page_max > CHANGE_PAGE_MAX) {
+		log_std(("WARNING:emu:video: unchanged rows disabled with %d video pages\n", page_max));
+		return;
+	}
+
+	size = context->state.game_visible_size_y;
+
+	context->state.change_map = malloc(size);
+	if (!context->state.change_map) {
+		log_std(("ERROR:emu:video: out of memory for the unchanged rows\n"));
+		return;
+	}
+
+	for (i = 0; i < page_max; ++i) {
+		context->state.change_page_map[i].valid_flag = 0;
+		context->state.change_page_map[i].hash_map = malloc(size * sizeof(uint64));
+		if (!context->state.change_page_map[i].hash_map) {
+			log_std(("ERROR:emu:video: out of memory for the unchanged rows\n"));
+			context->state.change_page_max = i;
+			video_change_done(context);
+			return;
+		}
+	}
+
+	context->state.change_page_max = page_max;
+	context->state.change_size = size;
+
+	log_std(("emu:video: unchanged rows tracked in %d video pages\n", page_max));
+}
+
+/**
+ * Blit only the rows changed from the last time the same video page was drawn.
+ */
+static void video_change_blit(struct advance_video_context* context, const struct video_pipeline_struct* pipeline, unsigned x, unsigned y, const unsigned char* src)
+{
+	struct advance_video_change_page* page;
+	unsigned size_x = context->state.game_visible_size_x;
+	unsigned size_y = context->state.game_visible_size_y;
+	unsigned bytes_per_pixel = context->state.game_bytes_per_pixel;
+	int dp = context->state.blit_src_dp;
+	int dw = context->state.blit_src_dw;
+	unsigned ddy = video_pipeline_vert(pipeline)->ddy;
+	const unsigned char* row;
+	unsigned page_index;
+	adv_bool valid;
+	unsigned changed;
+	unsigned written;
+	unsigned i;
+
+	page_index = update_page_get();
+
+	if (page_index >= context->state.change_page_max || size_y != context->state.change_size) {
+		video_pipeline_blit(pipeline, x, y, src);
+		return;
+	}
+
+	page = &context->state.change_page_map[page_index];
+
+	/* the rows in the page are usable only if drawn in the same way */
+	valid = page->valid_flag
+		&& page->pipeline_index == context->state.blit_pipeline_index
+		&& page->x == x
+		&& page->y == y
+		&& page->palette_generation == context->state.palette_generation;
+
+	changed = 0;
+	row = src;
+	for (i = 0; i < size_y; ++i) {
+		uint64 hash = video_change_hash(row, size_x, dp, bytes_per_pixel);
+
+		if (!valid || page->hash_map[i] != hash) {
+			page->hash_map[i] = hash;
+			context->state.change_map[i] = 1;
+			++changed;
+		} else {
+			context->state.change_map[i] = 0;
+		}
+
+		row += dw;
+	}
+
+	if (changed == size_y) {
+		video_pipeline_blit(pipeline, x, y, src);
+		written = ddy;
+	} else if (changed == 0) {
+		written = 0;
+	} else {
+		written = video_pipeline_blit_change(pipeline, x, y, src, context->state.change_map);
+	}
+
+	page->valid_flag = 1;
+	page->pipeline_index = context->state.blit_pipeline_index;
+	page->x = x;
+	page->y = y;
+	page->palette_generation = context->state.palette_generation;
+
+	context->state.change_row_total += ddy;
+	context->state.change_row_skip += ddy - written;
+	if (written == 0)
+		++context->state.change_frame_skip;
+}
+
 /**
  * Invalidates and clears the contents of the screen.
  */
@@ -461,6 +657,8 @@ void advance_video_invalidate_screen(struct advance_video_context* context)
 		video_clear(update_x_get(), update_y_get(), video_size_x(), video_size_y(), color);
 		update_stop(update_x_get(), update_y_get(), video_size_x(), video_size_y(), 0);
 	}
+
+	video_change_invalidate(context);
 }
 
 /**
@@ -489,6 +687,8 @@ static void video_done_pipeline(struct advance_video_context* context)
 		context->state.blit_pipeline_flag = 0;
 	}
 
+	video_change_done(context);
+
 	if (context->state.buffer_ptr_alloc) {
 		free(context->state.buffer_ptr_alloc);
 		context->state.buffer_ptr_alloc = 0;
@@ -532,6 +732,8 @@ static adv_error vidmode_init(struct advance_video_context* context, adv_mode* m
 	/* initialize the blit pipeline */
 	context->state.blit_pipeline_flag = 0;
 	context->state.buffer_ptr_alloc = 0;
+	context->state.change_page_max = 0;
+	context->state.change_map = 0;
 
 	/* initialize the update system */
 	update_init(context->config.triplebuf_flag != 0 ? 3 : 1);
@@ -1312,6 +1514,11 @@ static adv_error video_init_state(struct advance_video_context* context, struct
 	context->state.update_timing_i = 0;
 	context->state.update_timing_min = TARGET_CLOCKS_PER_SEC;
 
+	context->state.change_row_total = 0;
+	context->state.change_row_skip = 0;
+	context->state.change_frame_skip = 0;
+	context->state.palette_generation = 0;
+
 	context->state.debugger_flag = 0;
 	context->state.sync_throttle_flag = 1;
 
@@ -1916,6 +2123,9 @@ static void video_recompute_pipeline(struct advance_video_context* context, cons
 		}
 	}
 
+	/* the rows drawn with the previous pipeline are not usable */
+	video_change_init(context);
+
 	/* print the pipelines */
 	{
 		int i;
@@ -1972,7 +2182,7 @@ static void video_recompute_pipeline(struct advance_video_context* context, cons
 	context->state.blit_pipeline_index = 0;
 }
 
-static void video_frame_put(struct advance_video_context* context, struct advance_ui_context* ui_context, const struct osd_bitmap* bitmap, unsigned x, unsigned y)
+static void video_frame_put(struct advance_video_context* context, struct advance_ui_context* ui_context, const struct advance_ui_frame* ui_frame, const struct osd_bitmap* bitmap, unsigned x, unsigned y)
 {
 	unsigned src_offset;
 	unsigned dst_x, dst_y;
@@ -1993,7 +2203,7 @@ static void video_frame_put(struct advance_video_context* context, struct advanc
 	log_debug(("osd:frame dst_dxxdst_dy:%dx%d, xxy:%dx%d, dxxdy:%dx%d, dpxdw:%dx%d\n", context->state.mode_visible_size_x, context->state.mode_visible_size_y, context->state.game_visible_pos_x, context->state.game_visible_pos_y, context->state.game_visible_size_x, context->state.game_visible_size_y, context->state.blit_src_dp, context->state.blit_src_dw));
 
 	/* draw the onscreen direct interface */
-	if (advance_ui_direct_active(ui_context)) {
+	if (advance_ui_frame_direct_active(ui_frame)) {
 		unsigned pos_x = context->state.game_used_pos_x + context->state.game_visible_pos_x;
 		unsigned pos_y = context->state.game_used_pos_y + context->state.game_visible_pos_y;
 		unsigned size_x = context->state.game_visible_size_x;
@@ -2007,11 +2217,11 @@ static void video_frame_put(struct advance_video_context* context, struct advanc
 
 		src_offset = pos_x * context->state.game_bytes_per_pixel + pos_y * bitmap->bytes_per_scanline;
 
-		advance_ui_direct_update(ui_context, (unsigned char*)bitmap->ptr + src_offset, size_x, size_y, bitmap->bytes_per_scanline, context->state.game_color_def, context->state.palette_map, context->state.palette_total);
+		advance_ui_direct_update(ui_context, ui_frame, (unsigned char*)bitmap->ptr + src_offset, size_x, size_y, bitmap->bytes_per_scanline, context->state.game_color_def, context->state.palette_map, context->state.palette_total);
 	}
 
 	/* check if the ui requires a buffered write */
-	ui_buffer_active = advance_ui_buffer_active(ui_context);
+	ui_buffer_active = advance_ui_frame_buffer_active(ui_frame);
 
 	/* use buffered or direct write to screen ? */
 	buffer_flag = 0;
@@ -2052,7 +2262,7 @@ static void video_frame_put(struct advance_video_context* context, struct advanc
 
 		/* draw the user interface */
 		if (ui_buffer_active) {
-			advance_ui_buffer_update(ui_context, context->state.buffer_ptr, context->state.buffer_size_x, context->state.buffer_size_y, context->state.buffer_bytes_per_scanline, context->state.buffer_def, context->state.palette_map, context->state.palette_total);
+			advance_ui_buffer_update(ui_context, ui_frame, context->state.buffer_ptr, context->state.buffer_size_x, context->state.buffer_size_y, context->state.buffer_bytes_per_scanline, context->state.buffer_def, context->state.palette_map, context->state.palette_total);
 		}
 
 		buf_ptr = context->state.buffer_ptr;
@@ -2102,6 +2312,9 @@ static void video_frame_put(struct advance_video_context* context, struct advanc
 			/* because the ui may write over the game area */
 			video_buffer_clear(context);
 		}
+
+		/* the buffer overwrites the rows of the video page */
+		video_change_invalidate(context);
 	} else {
 		/* direct write on screen */
 
@@ -2109,7 +2322,10 @@ static void video_frame_put(struct advance_video_context* context, struct advanc
 		src_offset = context->state.blit_src_offset + context->state.game_visible_pos_y * context->state.blit_src_dw + context->state.game_visible_pos_x * context->state.blit_src_dp;
 
 		/* blit directly on the video */
-		video_pipeline_blit(&context->state.blit_pipeline[context->state.blit_pipeline_index], dst_x + x, dst_y + y, (unsigned char*)bitmap->ptr + src_offset);
+		if (context->state.change_page_max != 0)
+			video_change_blit(context, &context->state.blit_pipeline[context->state.blit_pipeline_index], dst_x + x, dst_y + y, (unsigned char*)bitmap->ptr + src_offset);
+		else
+			video_pipeline_blit(&context->state.blit_pipeline[context->state.blit_pipeline_index], dst_x + x, dst_y + y, (unsigned char*)bitmap->ptr + src_offset);
 	}
 
 	/* no buffering is used */
@@ -2167,11 +2383,11 @@ static void video_frame_put(struct advance_video_context* context, struct advanc
 	}
 }
 
-static void video_frame_screen(struct advance_video_context* context, struct advance_ui_context* ui_context, const struct osd_bitmap *bitmap)
+static void video_frame_screen(struct advance_video_context* context, struct advance_ui_context* ui_context, const struct advance_ui_frame* ui_frame, const struct osd_bitmap *bitmap)
 {
 	video_recompute_pipeline(context, bitmap);
 
-	video_frame_put(context, ui_context, bitmap, update_x_get(), update_y_get());
+	video_frame_put(context, ui_context, ui_frame, bitmap, update_x_get(), update_y_get());
 }
 
 static void video_frame_palette(struct advance_video_context* context)
@@ -2181,6 +2397,10 @@ static void video_frame_palette(struct advance_video_context* context)
 
 		context->state.palette_dirty_flag = 0;
 
+		/* the software palette is applied by the blit */
+		if (context->state.mode_index != MODE_FLAGS_INDEX_PALETTE8)
+			++context->state.palette_generation;
+
 		for (i = 0; i < context->state.palette_dirty_total; ++i) {
 			if (context->state.palette_dirty_map[i]) {
 				unsigned j;
@@ -2253,12 +2473,12 @@ static void video_frame_palette(struct advance_video_context* context)
 	}
 }
 
-static void video_frame_game(struct advance_video_context* context, struct advance_record_context* record_context, struct advance_ui_context* ui_context, const struct osd_bitmap *bitmap, adv_bool skip_flag)
+static void video_frame_game(struct advance_video_context* context, struct advance_record_context* record_context, struct advance_ui_context* ui_context, const struct advance_ui_frame* ui_frame, const struct osd_bitmap *bitmap, adv_bool skip_flag)
 {
 	/* bitmap */
 	if (!skip_flag) {
 		video_frame_palette(context);
-		video_frame_screen(context, ui_context, bitmap);
+		video_frame_screen(context, ui_context, ui_frame, bitmap);
 
 		if (advance_record_video_is_active(record_context)
 			&& !context->state.pause_flag) {
@@ -2360,12 +2580,12 @@ static void video_frame_debugger(struct advance_video_context* context, const st
 /**
  * Update the video drawing a frame.
  */
-void advance_video_frame(struct advance_video_context* context, struct advance_record_context* record_context, struct advance_ui_context* ui_context, const struct osd_bitmap* game, const struct osd_bitmap* debug, const osd_rgb_t* debug_palette, unsigned debug_palette_size, adv_bool skip_flag)
+void advance_video_frame(struct advance_video_context* context, struct advance_record_context* record_context, struct advance_ui_context* ui_context, const struct advance_ui_frame* ui_frame, const struct osd_bitmap* game, const struct osd_bitmap* debug, const osd_rgb_t* debug_palette, unsigned debug_palette_size, adv_bool skip_flag)
 {
 	if (context->state.debugger_flag) {
 		video_frame_debugger(context, debug, debug_palette, debug_palette_size);
 	} else {
-		video_frame_game(context, record_context, ui_context, game, skip_flag);
+		video_frame_game(context, record_context, ui_context, ui_frame, game, skip_flag);
 	}
 }
 
@@ -2542,6 +2762,10 @@ adv_error advance_video_mode_init(struct advance_video_context* context, struct
  */
 void advance_video_mode_done(struct advance_video_context* context)
 {
+	if (context->config.unchanged_flag && context->state.change_row_total != 0) {
+		log_std(("emu:video: unchanged rows skipped %llu of %llu, %d frames skipped\n", context->state.change_row_skip, context->state.change_row_total, context->state.change_frame_skip));
+	}
+
 	if (context->config.restore_flag || context->state.measure_flag) {
 		vidmode_done(context, 1);
 		video_mode_restore();
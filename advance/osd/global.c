@@ -724,6 +724,14 @@ void osd_customize_inputport_list(input_port_default_entry* defaults)
 	seq_set_1(&i->defaultseq, KEYCODE_MINUS_PAD);
 	i->name = "Startup End";
 
+	i = config_portdef_find(defaults, IPT_UI_REWIND);
+	seq_set_1(&i->defaultseq, KEYCODE_BACKSLASH);
+	i->name = "Rewind";
+
+	i = config_portdef_find(defaults, IPT_UI_TIMELINE);
+	seq_set_2(&i->defaultseq, KEYCODE_F11, KEYCODE_LCONTROL);
+	i->name = "Timeline";
+
 	i = config_portdef_find(defaults, IPT_UI_MODE_NEXT);
 	seq_set_1(&i->defaultseq, KEYCODE_STOP);
 	i->name = "Mode Next";
@@ -100,6 +100,10 @@ struct advance_glue_context {
 	char software_buffer[256]; /**< Buffer for software name. */
 
 	unsigned input; /**< Last user interface input. */
+
+	adv_bool bench_flag; /**< If the benchmark is measuring. */
+	unsigned bench_frame; /**< Number of frames measured by the benchmark. */
+	target_clock_t bench_osd; /**< Time spent in the OSD frame update measured by the benchmark. */
 };
 
 static struct advance_glue_context GLUE;
@@ -110,6 +114,7 @@ static struct advance_glue_context GLUE;
 /* MAME internal variables */
 extern char* cheatfile;
 extern const char *db_filename;
+extern mame_bitmap* scrbitmap[];
 #ifdef MESS
 const char* crcfile;
 const char* pcrcfile;
@@ -613,6 +618,13 @@ int mame_game_run(struct advance_context* context, const struct mame_option* adv
 	options.logfile = 0; /* use internal logging */
 	options.mame_debug = advance->debug_flag;
 	options.cheat = advance->cheat_flag;
+#ifndef MESS /* the run-ahead, the rewind and the sound changes are not in the MESS core */
+	options.runahead = advance->runahead;
+	options.rewind_size = advance->rewind_size;
+	options.rewind_step = advance->rewind_step;
+	options.sound_smp = advance->smpsound_flag;
+	options.sound_resample = advance->resample_taps;
+#endif
 	options.gui_host = 1; /* this prevents text mode messages that may stop the execution */
 	options.skip_disclaimer = context->global.config.quiet_flag;
 	options.skip_gameinfo = context->global.config.quiet_flag;
@@ -1187,6 +1199,8 @@ static struct mame_port GLUE_PORT_STD[] = {
 	S("ui_help", "Help", UI_HELP)
 	S("ui_keyboard", "Keyboard", UI_KEYBOARD)
 	S("ui_startup", "Startup", UI_STARTUP_END)
+	S("ui_rewind", "Rewind", UI_REWIND)
+	S("ui_timeline", "Timeline", UI_TIMELINE)
 
 	/* UI */
 	S("ui_configure", "Configure", UI_CONFIGURE)
@@ -1759,6 +1773,8 @@ static unsigned PORT_TYPE_REPORT_DEFAULT[] = {
 	IPT_UI_HELP,
 	IPT_UI_KEYBOARD,
 	IPT_UI_STARTUP_END,
+	IPT_UI_REWIND,
+	IPT_UI_TIMELINE,
 
 	IPT_UI_CONFIGURE,
 	IPT_UI_ON_SCREEN_DISPLAY,
@@ -2041,6 +2057,23 @@ unsigned mame_ui_frames_per_second(void)
 	return Machine->drv->frames_per_second;
 }
 
+void mame_ui_rewind_info(unsigned* seconds, unsigned* memory, double* time)
+{
+#ifdef MESS
+	*seconds = 0;
+	*memory = 0;
+	*time = 0;
+#else
+	int frames;
+	UINT32 used;
+
+	mame_get_rewind_info(&frames, &used, time);
+
+	*seconds = frames / Machine->drv->frames_per_second;
+	*memory = used;
+#endif
+}
+
 /**
  * Check if a MAME port is active.
  * A port is active if the associated key sequence is pressed.
@@ -2330,6 +2363,62 @@ static unsigned glue_sound_sample(void)
 	return GLUE.sound_last_count;
 }
 
+/**
+ * Check if the pixels of a bitmap can be moved in another memory block.
+ * Only the screen bitmap of the raster games is movable. The new block
+ * gets a copy of the previous frame before MAME draws in it, as some drivers
+ * draw only the changed parts, or nothing if the video is disabled.
+ * The vector games erase only the previously drawn vectors, and they
+ * are left out to keep them drawing always in the same block.
+ */
+static adv_bool glue_bitmap_is_movable(mame_bitmap* bitmap)
+{
+	if (bitmap != scrbitmap[0])
+		return 0;
+
+	if ((Machine->drv->video_attributes & VIDEO_TYPE_VECTOR) != 0)
+		return 0;
+
+	return 1;
+}
+
+/**
+ * Get the memory block of the pixels of a bitmap.
+ * It includes the safety area all around the bitmap.
+ */
+static void* glue_bitmap_block(mame_bitmap* bitmap)
+{
+	unsigned pixel_size = bitmap->rowbytes / bitmap->rowpixels;
+
+	return (unsigned char*)bitmap->line[-BITMAP_SAFETY] - BITMAP_SAFETY * pixel_size;
+}
+
+/**
+ * Move the pixels of the screen bitmap in another memory block.
+ * The pixels are not copied, MAME draws the next frame in the new block.
+ * \param block_ptr Memory block of the size reported in the osd_bitmap.
+ */
+void mame_video_bitmap_relocate(void* block_ptr)
+{
+	mame_bitmap* bitmap = scrbitmap[0];
+	ptrdiff_t delta = (unsigned char*)block_ptr - (unsigned char*)glue_bitmap_block(bitmap);
+	int i;
+
+	for (i = -BITMAP_SAFETY; i < bitmap->height + BITMAP_SAFETY; ++i)
+		bitmap->line[i] = (unsigned char*)bitmap->line[i] + delta;
+
+	bitmap->base = bitmap->line[0];
+}
+
+/**
+ * Wait until the screen bitmap can be accessed.
+ * After a move the memory block is filled with the previous frame by the video thread.
+ */
+void osd_video_bitmap_wait(void)
+{
+	advance_video_thread_bitmap_wait(&CONTEXT.video);
+}
+
 /**
  * Update the video frame.
  * \note Called after osd_update_audio_stream().
@@ -2343,6 +2432,8 @@ void osd_update_video_and_audio(mame_display *display)
 	unsigned input;
 	const short* sample_buffer;
 	unsigned sample_count;
+	adv_bool bench_flag = GLUE.bench_flag;
+	target_clock_t bench_start = bench_flag ? target_clock() : 0;
 
 	profiler_mark(PROFILER_BLIT);
 
@@ -2355,6 +2446,13 @@ void osd_update_video_and_audio(mame_display *display)
 		game.size_y = display->game_bitmap->height;
 		game.ptr = display->game_bitmap->base;
 		game.bytes_per_scanline = display->game_bitmap->rowbytes;
+		if (glue_bitmap_is_movable(display->game_bitmap)) {
+			game.block_ptr = glue_bitmap_block(display->game_bitmap);
+			game.block_size = (display->game_bitmap->height + 2 * BITMAP_SAFETY) * display->game_bitmap->rowbytes;
+		} else {
+			game.block_ptr = 0;
+			game.block_size = 0;
+		}
 	} else {
 		pgame = 0;
 		log_std(("ERROR:glue: null game bitmap\n"));
@@ -2366,6 +2464,8 @@ void osd_update_video_and_audio(mame_display *display)
 		debug.size_y = display->debug_bitmap->height;
 		debug.ptr = display->debug_bitmap->base;
 		debug.bytes_per_scanline = display->debug_bitmap->rowbytes;
+		debug.block_ptr = 0;
+		debug.block_size = 0;
 	} else {
 		pdebug = 0;
 	}
@@ -2432,6 +2532,12 @@ void osd_update_video_and_audio(mame_display *display)
 #endif
 		);
 
+	/* the benchmark times all the frame update, also if the blit is skipped */
+	if (bench_flag) {
+		GLUE.bench_osd += target_clock() - bench_start;
+		++GLUE.bench_frame;
+	}
+
 	profiler_mark(PROFILER_END);
 }
 
@@ -2560,6 +2666,105 @@ cycles_t osd_profiling_ticks(void)
 	return target_clock();
 }
 
+/**
+ * Start the measure of the benchmark.
+ */
+void mame_bench_start(void)
+{
+	GLUE.bench_flag = 1;
+	GLUE.bench_frame = 0;
+	GLUE.bench_osd = 0;
+
+	profiler_start();
+}
+
+/**
+ * Stop the measure of the benchmark.
+ */
+void mame_bench_stop(void)
+{
+	GLUE.bench_flag = 0;
+
+	profiler_stop();
+}
+
+#if defined(MAME_DEBUG) || defined(MAME_PROFILER)
+/**
+ * Time in seconds spent in the profiler sections from first to last.
+ */
+static double glue_bench_time(int first, int last)
+{
+	UINT64 ticks = 0;
+	int i;
+
+	for (i = first; i <= last; ++i)
+		ticks += profiler_get_ticks(i);
+
+	return (double)ticks / TARGET_CLOCKS_PER_SEC;
+}
+#endif
+
+/**
+ * Print the benchmark report.
+ * The report has one "key=value" line for every measure, and the
+ * keys don't change between versions to allow a simple comparison.
+ * The times of the emulation sections are reported only if the
+ * profiler is built.
+ * \param real_time Real time spent in the emulation [seconds].
+ */
+void mame_bench_report(double real_time)
+{
+	double emulated_time = GLUE.bench_frame / Machine->refresh_rate;
+	double osd_time = (double)GLUE.bench_osd / TARGET_CLOCKS_PER_SEC;
+	int i;
+
+	target_out("bench_game=%s\n", Machine->gamedrv->name);
+	target_out("bench_frames=%u\n", GLUE.bench_frame);
+	target_out("bench_emulated=%.6f\n", emulated_time);
+	target_out("bench_real=%.6f\n", real_time);
+	target_out("bench_speed=%.4f\n", real_time > 0 ? emulated_time / real_time : 0);
+	target_out("bench_osd=%.6f\n", osd_time);
+
+#if defined(MAME_DEBUG) || defined(MAME_PROFILER)
+	{
+		double cpu_time;
+		double video_time;
+		double sound_time;
+		double other_time;
+
+		/* the marks are exclusive, nested sections are not counted in the outer one, */
+		/* and the OSD frame update is in the blit section */
+		cpu_time = 0;
+		video_time = glue_bench_time(PROFILER_VIDEO, PROFILER_ARTWORK);
+		sound_time = glue_bench_time(PROFILER_SOUND, PROFILER_MIXER);
+		other_time = glue_bench_time(PROFILER_TIMER_CALLBACK, PROFILER_USER4);
+
+		target_out("bench_profiler=1\n");
+		for (i = 0; i < MAX_CPU && Machine->drv->cpu[i].cpu_type != CPU_DUMMY; ++i) {
+			double t = glue_bench_time(PROFILER_CPU1 + i, PROFILER_CPU1 + i);
+			target_out("bench_cpu%d=%.6f\n", i + 1, t);
+			target_out("bench_cpu%d_type=%s\n", i + 1, cputype_name(Machine->drv->cpu[i].cpu_type));
+			cpu_time += t;
+		}
+		target_out("bench_cpu=%.6f\n", cpu_time);
+		target_out("bench_video=%.6f\n", video_time);
+		target_out("bench_sound=%.6f\n", sound_time);
+		target_out("bench_other=%.6f\n", other_time);
+	}
+#else
+	/* the same keys, without the profiler the split isn't available */
+	target_out("bench_profiler=0\n");
+	for (i = 0; i < MAX_CPU && Machine->drv->cpu[i].cpu_type != CPU_DUMMY; ++i) {
+		target_out("bench_cpu%d=unavailable\n", i + 1);
+		target_out("bench_cpu%d_type=%s\n", i + 1, cputype_name(Machine->drv->cpu[i].cpu_type));
+	}
+	target_out("bench_cpu=unavailable\n");
+	target_out("bench_video=unavailable\n");
+	target_out("bench_sound=unavailable\n");
+	target_out("bench_other=unavailable\n");
+#endif
+}
+
 /**
  * Filter the main exit request.
  * \param result Result until now.
@@ -2867,10 +3072,17 @@ int osd_handle_user_interface(mame_bitmap *bitmap, int is_menu_active)
 
 	GLUE.input = input;
 
+#ifndef MESS
+	/* rewind until pressed */
+	mame_schedule_rewind(seq_pressed(input_port_default_seq(IPT_UI_REWIND, 0, SEQ_TYPE_STANDARD)));
+#endif
+
 	if (input_ui_pressed(IPT_UI_RECORD_START))
 		osd_record_start();
 	if (input_ui_pressed(IPT_UI_RECORD_STOP))
 		osd_record_stop();
+	if (input_ui_pressed(IPT_UI_TIMELINE))
+		osd_timeline_save();
 
 	return 0;
 }
@@ -2989,6 +3201,13 @@ static adv_conf_enum_int OPTION_ARTWORK_MAGNIFY[] = {
 	{ "4", 4 }
 };
 
+static adv_conf_enum_int OPTION_RESAMPLE[] = {
+	{ "linear", 0 },
+	{ "fast", 8 },
+	{ "medium", 16 },
+	{ "best", 32 }
+};
+
 adv_error mame_init(struct advance_context* context)
 {
 	unsigned i, j;
@@ -3043,6 +3262,7 @@ adv_error mame_init(struct advance_context* context)
 	conf_bool_register_default(context->cfg, "display_artwork_crop", 1);
 	conf_int_register_enum_default(context->cfg, "display_artwork_magnify", conf_enum(OPTION_ARTWORK_MAGNIFY), 0);
 	conf_bool_register_default(context->cfg, "sound_samples", 1);
+	conf_int_register_enum_default(context->cfg, "sound_resample", conf_enum(OPTION_RESAMPLE), 0);
 
 	conf_bool_register_default(context->cfg, "display_antialias", 1);
 	conf_bool_register_default(context->cfg, "display_translucency", 1);
@@ -3054,6 +3274,10 @@ adv_error mame_init(struct advance_context* context)
 	conf_float_register_limit_default(context->cfg, "display_brightness", 0.1, 10.0, 1.0);
 
 	conf_bool_register_default(context->cfg, "misc_cheat", 0);
+	conf_int_register_limit_default(context->cfg, "misc_runahead", 0, 4, 0);
+	conf_int_register_limit_default(context->cfg, "misc_rewind", 0, 2047, 0);
+	conf_int_register_limit_default(context->cfg, "misc_rewindstep", 1, 60, 4);
+	conf_bool_register_default(context->cfg, "misc_smpsound", 0);
 	conf_string_register_default(context->cfg, "misc_languagefile", "english.lng");
 	conf_string_register_default(context->cfg, "misc_cheatfile", "cheat.dat");
 
@@ -3086,6 +3310,7 @@ adv_error mame_config_load(adv_conf* cfg_context, struct mame_option* option)
 	option->artwork_crop_flag = conf_bool_get_default(cfg_context, "display_artwork_crop");
 	option->artwork_scale = conf_int_get_default(cfg_context, "display_artwork_magnify");
 	option->samples_flag = conf_bool_get_default(cfg_context, "sound_samples");
+	option->resample_taps = conf_int_get_default(cfg_context, "sound_resample");
 
 	option->antialias = conf_bool_get_default(cfg_context, "display_antialias");
 	option->translucency = conf_bool_get_default(cfg_context, "display_translucency");
@@ -3105,6 +3330,10 @@ adv_error mame_config_load(adv_conf* cfg_context, struct mame_option* option)
 	option->brightness = conf_float_get_default(cfg_context, "display_brightness");
 
 	option->cheat_flag = conf_bool_get_default(cfg_context, "misc_cheat");
+	option->runahead = conf_int_get_default(cfg_context, "misc_runahead");
+	option->rewind_size = conf_int_get_default(cfg_context, "misc_rewind") * 1024 * 1024;
+	option->rewind_step = conf_int_get_default(cfg_context, "misc_rewindstep");
+	option->smpsound_flag = conf_bool_get_default(cfg_context, "misc_smpsound");
 
 	sncpy(option->language_file_buffer, sizeof(option->language_file_buffer), conf_string_get_default(cfg_context, "misc_languagefile"));
 
@@ -59,11 +59,17 @@ struct mame_option {
 
 	adv_bool cheat_flag;
 
+	unsigned runahead;
+	unsigned rewind_size;
+	unsigned rewind_step;
+	adv_bool smpsound_flag;
+
 	double gamma;
 	double brightness;
 
 	int samplerate;
 	int samples_flag;
+	unsigned resample_taps;
 
 	int vector_width;
 	int vector_height;
@@ -72,6 +78,8 @@ struct mame_option {
 	int debug_width;
 	int debug_height;
 
+	int bench_flag;
+
 	unsigned ui_orientation;
 	unsigned direct_orientation;
 	int norotate;
@@ -251,7 +259,12 @@ void mame_ui_refresh(void);
 void mame_ui_gamma_factor_set(double gamma);
 unsigned char mame_ui_cpu_read(unsigned cpu, unsigned addr);
 unsigned mame_ui_frames_per_second(void);
+void mame_ui_rewind_info(unsigned* seconds, unsigned* memory, double* time);
 void mame_ui_input_map(unsigned* pdigital_mac, struct mame_digital_map_entry* digital_map, unsigned digital_max);
+void mame_video_bitmap_relocate(void* block_ptr);
+void mame_bench_start(void);
+void mame_bench_stop(void);
+void mame_bench_report(double real_time);
 
 /***************************************************************************/
 /* OSD interface */
@@ -300,6 +313,8 @@ struct osd_bitmap {
 	unsigned size_x;
 	unsigned size_y;
 	unsigned bytes_per_scanline;
+	void* block_ptr; /* memory block containing the bitmap and the area around it, 0 if it cannot be moved */
+	unsigned block_size; /* size of the memory block */
 };
 
 struct osd_video_option {
@@ -64,6 +64,8 @@
 #define IPT_UI_RECORD_START IPT_OSD_7
 #define IPT_UI_RECORD_STOP IPT_OSD_8
 #define IPT_UI_KEYBOARD IPT_OSD_9
+#define IPT_UI_REWIND IPT_OSD_10
+#define IPT_UI_TIMELINE IPT_OSD_11
 
 input_seq* glue_portdef_seq_get(input_port_default_entry* port, int seqtype);
 input_seq* glue_port_seq_get(input_port_entry* port, int seqtype);
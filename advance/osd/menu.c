@@ -176,6 +176,22 @@ static int video_pipeline_menu(struct advance_video_context* context, struct adv
 		}
 	}
 
+	if (context->config.unchanged_flag) {
+		advance_ui_menu_title_insert(&menu, "Unchanged Rows");
+
+		if (context->state.change_page_max == 0) {
+			advance_ui_menu_text_insert(&menu, "Not active");
+		} else {
+			unsigned long long total = context->state.change_row_total;
+			if (total == 0)
+				total = 1;
+			snprintf(buffer, sizeof(buffer), "Skipped rows %.1f%%", 100.0 * context->state.change_row_skip / total);
+			advance_ui_menu_text_insert(&menu, buffer);
+			snprintf(buffer, sizeof(buffer), "Skipped frames %d", context->state.change_frame_skip);
+			advance_ui_menu_text_insert(&menu, buffer);
+		}
+	}
+
 	exit_index = advance_ui_menu_text_insert(&menu, "Return to Main Menu");
 
 	mac = advance_ui_menu_done(&menu, ui_context, selected);
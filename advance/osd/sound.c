@@ -386,93 +386,40 @@ static void sound_equalizer(struct advance_sound_context* context, unsigned chan
 	}
 }
 
-/* Resample */
+/**
+ * Resample with a linear interpolation.
+ * The input is continued from the last sample of the previous frame, and
+ * the last output sample is always the last input sample, so a small change
+ * of the number of samples is spread over all the frame without any jump.
+ */
 static void sound_scale(struct advance_sound_context* context, unsigned channel, const short* input_sample, short* output_sample, unsigned sample_count, unsigned sample_recount)
 {
-	adv_slice slice;
-
-	slice_set(&slice, sample_count, sample_recount);
-
-	if (channel == 1) {
-		if (sample_count < sample_recount) {
-			/* expansion */
-			int count = slice.count;
-			int error = slice.error;
-			while (count) {
-				unsigned run = slice.whole;
-				if ((error += slice.up) > 0) {
-					++run;
-					error -= slice.down;
-				}
-
-				while (run) {
-					output_sample[0] = input_sample[0];
-					output_sample += 1;
-					--run;
-				}
-				input_sample += 1;
-
-				--count;
-			}
-		} else {
-			/* reduction */
-			int count = slice.count;
-			int error = slice.error;
-			while (count) {
-				unsigned run = slice.whole;
-				if ((error += slice.up) > 0) {
-					++run;
-					error -= slice.down;
-				}
-
-				output_sample[0] = input_sample[0];
-				output_sample += 1;
-				input_sample += run;
-
-				--count;
+	unsigned step = (sample_count << 16) / sample_recount;
+	unsigned pos = 0;
+	unsigned i, c;
+
+	for (i = 0; i < sample_recount; ++i) {
+		unsigned whole;
+		int frac;
+
+		pos += step;
+		if (i == sample_recount - 1)
+			pos = sample_count << 16;
+
+		/* position in the input preceded by the last sample of the previous frame */
+		whole = pos >> 16;
+		frac = (pos & 0xFFFF) >> 1;
+
+		for (c = 0; c < channel; ++c) {
+			int v0 = whole ? input_sample[(whole - 1) * channel + c] : context->state.scale_last[c];
+			if (frac) {
+				int v1 = input_sample[whole * channel + c];
+				v0 += ((v1 - v0) * frac) >> 15;
 			}
+			output_sample[c] = v0;
 		}
-	} else if (channel == 2) {
-		if (sample_count < sample_recount) {
-			/* expansion */
-			int count = slice.count;
-			int error = slice.error;
-			while (count) {
-				unsigned run = slice.whole;
-				if ((error += slice.up) > 0) {
-					++run;
-					error -= slice.down;
-				}
 
-				while (run) {
-					output_sample[0] = input_sample[0];
-					output_sample[1] = input_sample[1];
-					output_sample += 2;
-					--run;
-				}
-				input_sample += 2;
-
-				--count;
-			}
-		} else {
-			/* reduction */
-			int count = slice.count;
-			int error = slice.error;
-			while (count) {
-				unsigned run = slice.whole;
-				if ((error += slice.up) > 0) {
-					++run;
-					error -= slice.down;
-				}
-
-				output_sample[0] = input_sample[0];
-				output_sample[1] = input_sample[1];
-				output_sample += 2;
-				input_sample += 2 * run;
-
-				--count;
-			}
-		}
+		output_sample += channel;
 	}
 }
 
@@ -491,6 +438,13 @@ static void sound_play_recount(struct advance_sound_context* context, const shor
 	} else {
 		soundb_play(sample_buffer, sample_count);
 	}
+
+	/* save the start of the next resampling */
+	if (sample_count) {
+		unsigned c;
+		for (c = 0; c < output_channel; ++c)
+			context->state.scale_last[c] = sample_buffer[(sample_count - 1) * output_channel + c];
+	}
 }
 
 static void sound_play_effect(struct advance_sound_context* context, const short* sample_buffer, unsigned sample_count, unsigned sample_recount)
@@ -677,12 +631,96 @@ int advance_sound_latency_diff(struct advance_sound_context* context, double ext
 
 		log_debug(("advance: sound buffered %d, expected %d, diff %d, min %d, max %d\n", buffered, expected, buffered - expected, context->state.latency_min, context->state.latency_max));
 
+		context->state.rate_buffered = buffered;
+		context->state.rate_target = expected;
+
 		return buffered - expected;
 	} else {
 		return 0;
 	}
 }
 
+/** Maximum rate correction, 0.5%. */
+#define SOUND_RATE_CORRECTION_MAX 0.005
+
+/** Proportional gain. The maximum correction is reached with an error equal to the latency. */
+#define SOUND_RATE_KP SOUND_RATE_CORRECTION_MAX
+
+/** Integral gain for frame. At 60 Hz the integral term matches the proportional one in 5 seconds. */
+#define SOUND_RATE_KI (SOUND_RATE_KP / 300)
+
+/** Number of frames on which to distribute the latency error too big for the rate control. */
+#define SOUND_RATE_RESYNC_COUNT 4
+
+/** Frames between the logs of the rate control. */
+#define SOUND_RATE_LOG_COUNT 600
+
+/**
+ * Dynamic rate control of the sound.
+ * A PI controller keeps the buffered samples at the target latency changing
+ * the number of played samples of less than 0.5%, with a fractional remainder
+ * carried to the next frames. An error bigger than half the latency, like
+ * after a pause, is instead recovered in a few frames.
+ * \param latency_error Error of the buffered samples, as returned by advance_sound_latency_diff().
+ * \param sample_count Number of samples of the frame.
+ * \return Number of samples to remove from the frame, negative to add them.
+ */
+int advance_sound_rate_control(struct advance_sound_context* context, int latency_error, unsigned sample_count)
+{
+	int latency_limit = advance_sound_latency(context, 0) / 2;
+	int resync;
+	int diff;
+	double error;
+	double correction;
+	double samples;
+
+	if (!context->state.active_flag)
+		return 0;
+
+	/* without a latency use a reference of 50 ms */
+	if (latency_limit <= 0)
+		latency_limit = context->state.rate / 40;
+
+	/* error relative to the latency */
+	error = latency_error / (2.0 * latency_limit);
+
+	if (latency_error > latency_limit) {
+		resync = (latency_error - latency_limit) / SOUND_RATE_RESYNC_COUNT;
+	} else if (latency_error < -latency_limit) {
+		resync = (latency_error + latency_limit) / SOUND_RATE_RESYNC_COUNT;
+	} else {
+		resync = 0;
+
+		/* integrate only the errors in the range of the rate control */
+		context->state.rate_integral += SOUND_RATE_KI * error;
+		if (context->state.rate_integral > SOUND_RATE_CORRECTION_MAX)
+			context->state.rate_integral = SOUND_RATE_CORRECTION_MAX;
+		if (context->state.rate_integral < -SOUND_RATE_CORRECTION_MAX)
+			context->state.rate_integral = -SOUND_RATE_CORRECTION_MAX;
+	}
+
+	correction = SOUND_RATE_KP * error + context->state.rate_integral;
+	if (correction > SOUND_RATE_CORRECTION_MAX)
+		correction = SOUND_RATE_CORRECTION_MAX;
+	if (correction < -SOUND_RATE_CORRECTION_MAX)
+		correction = -SOUND_RATE_CORRECTION_MAX;
+
+	context->state.rate_correction = correction;
+
+	/* apply the integer part, and keep the fraction for the next frames */
+	samples = sample_count * correction + context->state.rate_fraction;
+	diff = samples;
+	context->state.rate_fraction = samples - diff;
+
+	if (resync != 0)
+		log_std(("WARNING:emu:sound: audio/video syncronization correction of %d samples. Try increasing the 'sound_latency' option.\n", resync));
+
+	if (++context->state.rate_counter % SOUND_RATE_LOG_COUNT == 0)
+		log_std(("emu:sound: rate control buffered %d, target %d, correction %.3f%%\n", context->state.rate_buffered, context->state.rate_target, correction * 100));
+
+	return diff + resync;
+}
+
 static adv_conf_enum_int OPTION_CHANNELS[] = {
 	{ "auto", SOUND_MODE_AUTO },
 	{ "mono", SOUND_MODE_MONO },
@@ -1152,6 +1190,15 @@ int osd2_sound_init(unsigned* sample_rate, int stereo_flag)
 
 	context->state.overflow = 0;
 
+	context->state.scale_last[0] = 0;
+	context->state.scale_last[1] = 0;
+	context->state.rate_buffered = 0;
+	context->state.rate_target = 0;
+	context->state.rate_integral = 0;
+	context->state.rate_correction = 0;
+	context->state.rate_fraction = 0;
+	context->state.rate_counter = 0;
+
 	soundb_start(context->config.latency_time);
 
 	sound_normalize_update(context);
@@ -39,6 +39,21 @@
 /** Max frameskip factor */
 #define SYNC_MAX 4
 
+/** Limits of the busy wait before the frame deadline. */
+/*@{*/
+#define SYNC_SPIN_MIN 0.00005 /**< 50 us */
+#define SYNC_SPIN_MAX 0.002 /**< 2 ms */
+/*@}*/
+
+/** Lateness of a frame counted as a miss. */
+#define SYNC_LATE_LIMIT 0.0001 /* 100 us */
+
+/** Number of frames planned by the predictive frameskip. */
+#define SYNC_PLAN 8
+
+/** Percentile of the frame times used by the predictive frameskip. */
+#define SYNC_PERCENTILE 0.9
+
 /**
  * Update the skip state.
  * Recompute the skip counters from the config.frameskip_factor variable.
@@ -200,13 +215,172 @@ static void video_time(struct advance_video_context* context, struct advance_est
 		*skip = *full;
 }
 
+/**
+ * Time of the frames from the percentile of the recent times.
+ * \param full Time of a frame drawn and blitted.
+ * \param skip Time of a frame not drawn.
+ * \param blit Time of a frame drawn but not blitted.
+ */
+static void video_time_percentile(struct advance_video_context* context, struct advance_estimate_context* estimate_context, double* full, double* skip, double* blit)
+{
+	double mame_full = advance_estimate_percentile(&estimate_context->history_mame_full, estimate_context->estimate_mame_full, SYNC_PERCENTILE);
+	double mame_skip = advance_estimate_percentile(&estimate_context->history_mame_skip, estimate_context->estimate_mame_skip, SYNC_PERCENTILE);
+	double osd_full = advance_estimate_percentile(&estimate_context->history_osd_full, estimate_context->estimate_osd_full, SYNC_PERCENTILE);
+	double osd_skip = advance_estimate_percentile(&estimate_context->history_osd_skip, estimate_context->estimate_osd_skip, SYNC_PERCENTILE);
+
+	if (context->config.smp_flag) {
+		/* if SMP is active the MAME and OSD times overlap */
+		*full = mame_full > osd_full ? mame_full : osd_full;
+		*skip = mame_skip > osd_skip ? mame_skip : osd_skip;
+		*blit = mame_full > osd_skip ? mame_full : osd_skip;
+	} else {
+		*full = mame_full + osd_full;
+		*skip = mame_skip + osd_skip;
+		*blit = mame_full + osd_skip;
+	}
+
+	/* common time */
+	*full += estimate_context->estimate_common_full;
+	*skip += estimate_context->estimate_common_skip;
+	*blit += estimate_context->estimate_common_skip;
+
+	/* correct errors, it may happen that a time is not measured and it contains an old value */
+	if (*blit > *full)
+		*blit = *full;
+	if (*skip > *blit)
+		*skip = *blit;
+}
+
+/**
+ * Time the frames queued to the video thread are late.
+ * With a queue of more than one frame the emulation may run ahead of the
+ * screen update, and the frames waiting in the queue are not accounted
+ * in the time we are late. It's the time a frame spends in the queue and
+ * in the drawing over one frame, limited at the length of the queue.
+ */
+static double video_queue_late(struct advance_video_context* context, struct advance_estimate_context* estimate_context)
+{
+	double step = context->state.skip_step;
+	double late;
+
+	if (!context->config.smp_flag || context->config.smp_queue <= 1)
+		return 0;
+
+	late = estimate_context->estimate_queue - step;
+	if (late < 0)
+		late = 0;
+	if (late > (context->config.smp_queue - 1) * step)
+		late = (context->config.smp_queue - 1) * step;
+
+	return late;
+}
+
+/**
+ * Predictive frameskip.
+ * Plan which of the next SYNC_PLAN frames are drawn, and decide if the next
+ * one is drawn. The plan is recomputed at every frame from a high percentile
+ * of the recent frame times, and from the time the emulation is late,
+ * so a burst of slow frames is recovered in the next few frames.
+ * The drawn frames are spread uniformly in the plan.
+ */
+static void video_skip_predict(struct advance_video_context* context, struct advance_estimate_context* estimate_context)
+{
+	/* frame time */
+	double step = context->state.skip_step;
+
+	/* time of a frame drawn, skipped, and drawn but not blitted */
+	double full, skip, blit;
+
+	/* time of the frames skipped */
+	double cost;
+
+	/* time available for the planned frames */
+	double budget;
+
+	/* number of frames drawn in the plan */
+	unsigned plan;
+
+	/* skip only the blit */
+	adv_bool blit_flag;
+
+	unsigned full_level, skip_level;
+
+	video_time_percentile(context, estimate_context, &full, &skip, &blit);
+
+	/* skip only the blit if it takes more time than the MAME draw */
+	blit_flag = context->config.frameskip_blit_flag && full - blit >= blit - skip;
+	cost = blit_flag ? blit : skip;
+
+	/* the time we are late, also in the queue, is recovered in the plan */
+	budget = SYNC_PLAN * step - video_queue_late(context, estimate_context);
+	if (context->state.sync_pivot < 0)
+		budget += context->state.sync_pivot;
+
+	context->state.skip_level_disable_flag = 0;
+
+	if (full * SYNC_PLAN <= budget) {
+		/* full frame rate */
+		plan = SYNC_PLAN;
+	} else if (cost >= step || full <= cost) {
+		if (context->state.turbo_flag) {
+			/* minimum frame rate */
+			plan = 1;
+		} else {
+			/* mid frame rate, the correct speed is impossible */
+			plan = SYNC_PLAN / 2;
+			context->state.skip_level_disable_flag = 1; /* signal the special condition */
+		}
+	} else {
+		/* number of frames that can be drawn in the plan */
+		double v = (budget - SYNC_PLAN * cost) / (full - cost);
+
+		if (v < 1)
+			plan = 1;
+		else if (v > SYNC_PLAN - 1)
+			plan = SYNC_PLAN - 1;
+		else
+			plan = floor(v);
+	}
+
+	/* spread the drawn frames in the plan */
+	context->state.skip_plan_counter += plan;
+	if (context->state.skip_plan_counter >= SYNC_PLAN) {
+		context->state.skip_plan_counter -= SYNC_PLAN;
+		context->state.skip_flag = 0;
+	} else {
+		context->state.skip_flag = 1;
+	}
+
+	context->state.skip_draw_flag = context->state.skip_flag && !blit_flag;
+
+	/* report the plan as a reduced cycle */
+	if (plan == SYNC_PLAN) {
+		full_level = SYNC_MAX;
+		skip_level = 0;
+	} else {
+		full_level = plan;
+		skip_level = SYNC_PLAN - plan;
+		while (full_level % 2 == 0 && skip_level % 2 == 0) {
+			full_level /= 2;
+			skip_level /= 2;
+		}
+	}
+
+	if (context->state.skip_level_full != full_level || context->state.skip_level_skip != skip_level) {
+		log_debug(("advance:skip: predict full %g [sec], skip %g [sec], blit %g [sec], budget %g [sec], plan %d/%d%s\n", full, skip, blit, budget, plan, SYNC_PLAN, blit_flag ? " blit" : ""));
+	}
+
+	context->state.skip_level_full = full_level;
+	context->state.skip_level_skip = skip_level;
+}
+
 /* Define to optimize for full CPU usage (reduce the wait time) instead of full speed */
 /* #define USE_FULLCPU */
 
 static void video_skip_recompute(struct advance_video_context* context, struct advance_estimate_context* estimate_context)
 {
-	/* frame time */
-	double step = context->state.skip_step;
+	/* frame time, reduced to recover the time the queued frames are late */
+	double step = context->state.skip_step - video_queue_late(context, estimate_context) / SYNC_PLAN;
 
 	/* time required to compute and draw a complete frame */
 	double full;
@@ -220,6 +394,7 @@ static void video_skip_recompute(struct advance_video_context* context, struct a
 	log_debug(("advance:skip: frame full %g [sec], frame skip %g [sec]\n", estimate_context->estimate_mame_full + estimate_context->estimate_osd_full, estimate_context->estimate_mame_skip + estimate_context->estimate_osd_skip));
 	log_debug(("advance:skip: mame_full %g [sec], mame_skip %g [sec], osd_full %g [sec], osd_skip %g [sec]\n", estimate_context->estimate_mame_full, estimate_context->estimate_mame_skip, estimate_context->estimate_osd_full, estimate_context->estimate_osd_skip));
 	log_debug(("advance:skip: common_full %g [sec], common_skip %g [sec]\n", estimate_context->estimate_common_full, estimate_context->estimate_common_skip));
+	log_debug(("advance:skip: queue %g [sec], late %g [sec]\n", estimate_context->estimate_queue, video_queue_late(context, estimate_context)));
 	log_debug(("advance:skip: full %g [sec], skip %g [sec]\n", full, skip));
 
 	context->state.skip_level_disable_flag = 0;
@@ -301,16 +476,55 @@ static void video_skip_recompute(struct advance_video_context* context, struct a
 	log_debug(("advance:skip: cycle %d/%d\n", context->state.skip_level_full, context->state.skip_level_skip));
 }
 
-static double video_frame_wait(double current, double expected)
+/**
+ * Wait the frame deadline.
+ * The process sleeps until a short time before the deadline, and it waits
+ * the remaining time with a busy loop. The busy wait time is calibrated
+ * with the measured wakeup delay of the sleep.
+ */
+static double video_frame_wait(struct advance_video_context* context, double current, double expected)
 {
-	while (current < expected) {
-		double diff = expected - current;
+	double wakeup;
+	double late;
+
+	wakeup = expected - context->state.sync_spin;
 
-		target_usleep(diff * 1E6);
+	if (current < wakeup) {
+		double delay;
+
+		target_usleep_until(wakeup * TARGET_CLOCKS_PER_SEC);
 
 		current = advance_timer();
+
+		/* keep a margin over the wakeup delay, increasing it immediately */
+		/* and decreasing it slowly */
+		delay = 2 * (current - wakeup);
+		if (delay > context->state.sync_spin)
+			context->state.sync_spin = delay;
+		else
+			context->state.sync_spin = 0.99 * context->state.sync_spin + 0.01 * delay;
+
+		if (context->state.sync_spin < SYNC_SPIN_MIN)
+			context->state.sync_spin = SYNC_SPIN_MIN;
+		if (context->state.sync_spin > SYNC_SPIN_MAX)
+			context->state.sync_spin = SYNC_SPIN_MAX;
+	}
+
+	while (current < expected) {
+		current = advance_timer();
 	}
 
+	/* update the lateness statistics */
+	late = current - expected;
+	++context->state.sync_late_counter;
+	context->state.sync_late_sum += late;
+	if (late > context->state.sync_late_max)
+		context->state.sync_late_max = late;
+	if (late > SYNC_LATE_LIMIT)
+		++context->state.sync_late_miss;
+
+	log_debug(("advance:sync: late %g [us], spin %g [us]\n", late * 1E6, context->state.sync_spin * 1E6));
+
 	return current;
 }
 
@@ -360,7 +574,7 @@ static void video_frame_sync(struct advance_video_context* context)
 				video_wait_vsync();
 				current = advance_timer();
 			} else {
-				current = video_frame_wait(current, expected);
+				current = video_frame_wait(context, current, expected);
 			}
 
 			error = expected - current;
@@ -399,7 +613,7 @@ static void video_frame_sync(struct advance_video_context* context)
 			/* adjust with the previous error to try to recover it */
 			expected += context->state.sync_pivot;
 
-			current = video_frame_wait(current, expected);
+			current = video_frame_wait(context, current, expected);
 
 			/* save the time of the latest sync */
 			context->state.sync_last = current;
@@ -466,7 +680,9 @@ static void video_frame_skip(struct advance_video_context* context, struct advan
 {
 	if (context->state.skip_warming_up_flag) {
 		context->state.skip_flag = 0;
+		context->state.skip_draw_flag = 0;
 		context->state.skip_level_counter = 0;
+		context->state.skip_plan_counter = 0;
 
 		if (context->state.measure_flag) {
 			context->state.skip_step = 1.0 / context->state.game_fps;
@@ -489,9 +705,18 @@ static void video_frame_skip(struct advance_video_context* context, struct advan
 		context->state.skip_warming_up_flag = 0;
 
 		log_debug(("advance:skip: throttle warming up\n"));
+	} else if (context->config.frameskip_predict_flag
+		&& !context->state.fastest_flag
+		&& !context->state.measure_flag
+		&& (context->state.turbo_flag || context->config.frameskip_auto_flag)) {
+		/* compute if the next (not the current one) frame must be skipped */
+		video_skip_predict(context, estimate_context);
+
+		log_debug(("advance:skip: skip %d, draw %d, plan %d/%d\n", context->state.skip_flag, !context->state.skip_draw_flag, context->state.skip_level_full, context->state.skip_level_skip));
 	} else {
 		/* compute if the next (not the current one) frame must be skipped */
 		context->state.skip_flag = context->state.skip_level_counter >= context->state.skip_level_full;
+		context->state.skip_draw_flag = context->state.skip_flag;
 
 		++context->state.skip_level_counter;
 		if (context->state.skip_level_counter >= context->state.skip_level_full + context->state.skip_level_skip) {
@@ -514,6 +739,7 @@ static void video_frame_skip_none(struct advance_video_context* context, struct
 {
 	context->state.skip_step = 1.0 / context->state.game_fps;
 	context->state.skip_flag = 0;
+	context->state.skip_draw_flag = 0;
 	context->state.skip_level_counter = 0;
 
 	/* force a recomputation when needed */
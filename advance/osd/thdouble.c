@@ -120,6 +120,11 @@ void thread_done(void)
 	pthread_cond_destroy(&thread_cond);
 }
 
+unsigned thread_max(void)
+{
+	return 2;
+}
+
 void osd_parallelize(void (*func)(void* arg, int num, int max), void* arg, int max)
 {
 	if (!thread_is_active()) {
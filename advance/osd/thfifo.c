@@ -275,6 +275,14 @@ void thread_done(void)
 	free(work_map);
 }
 
+unsigned thread_max(void)
+{
+	/* one thread for every processor */
+	if (work_limit < 2)
+		return 1;
+	return work_limit - 1;
+}
+
 /** Max number of thread for osd_parallelize(). */
 #define THREAD_MAX 16
 
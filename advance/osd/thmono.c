@@ -37,6 +37,11 @@ void osd_parallelize(void (*func)(void* arg, int num, int max), void* arg, int m
 	func(arg, 0, 1);
 }
 
+unsigned thread_max(void)
+{
+	return 1;
+}
+
 int thread_init(void)
 {
 	return 0;
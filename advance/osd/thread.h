@@ -51,5 +51,18 @@ void thread_done(void);
  */
 int thread_is_active(void);
 
+/**
+ * Get the max number of threads used by osd_parallelize().
+ */
+unsigned thread_max(void);
+
+/**
+ * Call a function in parallel on more threads.
+ * The function is called with all the num values from 0 to max - 1.
+ * The number of calls max may be reduced if not enough threads are available.
+ * It returns when all the calls are completed.
+ */
+void osd_parallelize(void (*func)(void* arg, int num, int max), void* arg, int max);
+
 #endif
 
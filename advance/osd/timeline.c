@@ -0,0 +1,377 @@
+/*
+ * This file is part of the Advance project.
+ *
+ * Copyright (C) 2001, 2002, 2003, 2004 Andrea Mazzoleni
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ * In addition, as a special exception, Andrea Mazzoleni
+ * gives permission to link the code of this program with
+ * the MAME library (or with modified versions of MAME that use the
+ * same license as MAME), and distribute linked combinations including
+ * the two.  You must obey the GNU General Public License in all
+ * respects for all of the code used other than MAME.  If you modify
+ * this file, you may extend this exception to your version of the
+ * file, but you are not obligated to do so.  If you do not wish to
+ * do so, delete this exception statement from your version.
+ */
+
+#include "portable.h"
+
+#include "emu.h"
+
+#include "advance.h"
+
+/***************************************************************************/
+/* Timeline */
+
+/** Name of the phases, used in the saved files. */
+static const char* TIMELINE_NAME[TIMELINE_MAX] = {
+	"input",
+	"emulation",
+	"update",
+	"prepare",
+	"sync",
+	"blit",
+	"audio",
+	"present"
+};
+
+/**
+ * Thread of the phases, used in the JSON file.
+ * The phases after the prepare are run by the video thread, if active.
+ */
+static unsigned TIMELINE_TID[TIMELINE_MAX] = {
+	1, 1, 1, 1, 2, 2, 2, 2
+};
+
+/**
+ * Time in microseconds from the start of the recording.
+ */
+static double timeline_us(struct advance_timeline_context* context, target_clock_t clock)
+{
+	return (clock - context->state.base) * 1E6 / TARGET_CLOCKS_PER_SEC;
+}
+
+/**
+ * Get the first frame still stored in the ring.
+ * The current frame is excluded because it's not complete.
+ */
+static unsigned timeline_first(struct advance_timeline_context* context)
+{
+	if (context->state.counter < TIMELINE_FRAME_MAX)
+		return 0;
+	else
+		return context->state.counter - TIMELINE_FRAME_MAX + 1;
+}
+
+static void timeline_save_json(struct advance_timeline_context* context, FILE* f)
+{
+	unsigned i, j;
+
+	fprintf(f, "{\"traceEvents\":[\n");
+	fprintf(f, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"emulation\"}},\n");
+	fprintf(f, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"video\"}}");
+
+	for (i = timeline_first(context); i < context->state.counter; ++i) {
+		struct advance_timeline_frame* frame = &context->state.frame_map[i % TIMELINE_FRAME_MAX];
+
+		if (frame->counter != i)
+			continue;
+
+		for (j = 0; j < TIMELINE_MAX; ++j) {
+			if (!frame->begin[j] || !frame->end[j])
+				continue;
+
+			fprintf(f, ",\n{\"name\":\"%s\",\"cat\":\"frame\",\"ph\":\"X\",\"ts\":%.1f,\"dur\":%.1f,\"pid\":1,\"tid\":%u,\"args\":{\"frame\":%u,\"skip\":%d}}",
+				TIMELINE_NAME[j],
+				timeline_us(context, frame->begin[j]),
+				(frame->end[j] - frame->begin[j]) * 1E6 / TARGET_CLOCKS_PER_SEC,
+				TIMELINE_TID[j],
+				i,
+				frame->skip_flag != 0
+			);
+		}
+
+		if (frame->sound_time) {
+			fprintf(f, ",\n{\"name\":\"sound\",\"ph\":\"C\",\"ts\":%.1f,\"pid\":1,\"args\":{\"buffered\":%d,\"target\":%d}}",
+				timeline_us(context, frame->sound_time),
+				frame->sound_buffered,
+				frame->sound_target
+			);
+			fprintf(f, ",\n{\"name\":\"sound_correction\",\"ph\":\"C\",\"ts\":%.1f,\"pid\":1,\"args\":{\"ppm\":%.0f}}",
+				timeline_us(context, frame->sound_time),
+				frame->sound_correction * 1E6
+			);
+		}
+	}
+
+	fprintf(f, "\n],\"displayTimeUnit\":\"ms\"}\n");
+}
+
+static void timeline_save_csv(struct advance_timeline_context* context, FILE* f)
+{
+	unsigned i, j;
+
+	fprintf(f, "frame,skip");
+	for (j = 0; j < TIMELINE_MAX; ++j)
+		fprintf(f, ",%s_begin,%s_end", TIMELINE_NAME[j], TIMELINE_NAME[j]);
+	fprintf(f, ",sound_buffered,sound_target,sound_correction");
+	fprintf(f, "\n");
+
+	for (i = timeline_first(context); i < context->state.counter; ++i) {
+		struct advance_timeline_frame* frame = &context->state.frame_map[i % TIMELINE_FRAME_MAX];
+
+		if (frame->counter != i)
+			continue;
+
+		fprintf(f, "%u,%d", i, frame->skip_flag != 0);
+		for (j = 0; j < TIMELINE_MAX; ++j) {
+			if (frame->begin[j] && frame->end[j])
+				fprintf(f, ",%.1f,%.1f", timeline_us(context, frame->begin[j]), timeline_us(context, frame->end[j]));
+			else
+				fprintf(f, ",,");
+		}
+		if (frame->sound_time)
+			fprintf(f, ",%d,%d,%.6f", frame->sound_buffered, frame->sound_target, frame->sound_correction);
+		else
+			fprintf(f, ",,,");
+		fprintf(f, "\n");
+	}
+}
+
+/**
+ * Get the name of the first file not existing.
+ * \return 0 on success, -1 if the path is too long.
+ */
+static adv_error timeline_next_file(struct advance_timeline_context* context, const mame_game* game, char* path, unsigned size)
+{
+	const char* ext = context->config.format == TIMELINE_FORMAT_CSV ? "csv" : "json";
+	unsigned counter = 0;
+
+	if (snprintf(path, size, "%s/%.8s.%s", context->config.dir_buffer, mame_game_name(game), ext) >= size)
+		return -1;
+
+	if (access(path, F_OK) == 0) {
+		do {
+			if (snprintf(path, size, "%s/%.4s%04d.%s", context->config.dir_buffer, mame_game_name(game), counter, ext) >= size)
+				return -1;
+			++counter;
+		} while (access(path, F_OK) == 0);
+	}
+
+	return 0;
+}
+
+static adv_error timeline_save(struct advance_timeline_context* context, const mame_game* game)
+{
+	char path[FILE_MAXPATH];
+	FILE* f;
+
+	if (timeline_next_file(context, game, path, sizeof(path)) != 0) {
+		log_std(("ERROR: timeline path too long in %s\n", context->config.dir_buffer));
+		return -1;
+	}
+
+	log_std(("osd: timeline save %s\n", path));
+
+	f = fopen(path, "w");
+	if (!f) {
+		log_std(("ERROR: opening file %s\n", path));
+		return -1;
+	}
+
+	if (context->config.format == TIMELINE_FORMAT_CSV)
+		timeline_save_csv(context, f);
+	else
+		timeline_save_json(context, f);
+
+	if (fclose(f) != 0) {
+		log_std(("ERROR: writing file %s\n", path));
+		remove(path);
+		return -1;
+	}
+
+	return 0;
+}
+
+/*************************************************************************************/
+/* OSD */
+
+void osd_timeline_save(void)
+{
+	struct advance_timeline_context* context = &CONTEXT.timeline;
+
+	log_std(("osd: osd_timeline_save()\n"));
+
+	if (!context->state.active_flag) {
+		advance_global_message(&CONTEXT.global, "Timeline disabled");
+		return;
+	}
+
+	if (timeline_save(context, CONTEXT.game) != 0) {
+		advance_global_message(&CONTEXT.global, "Error saving the timeline");
+		return;
+	}
+
+	advance_global_message(&CONTEXT.global, "Saved timeline");
+}
+
+void osd_video_update_begin(void)
+{
+	struct advance_timeline_context* context = &CONTEXT.timeline;
+
+	advance_timeline_begin(context, context->state.counter, TIMELINE_UPDATE);
+}
+
+void osd_video_update_end(void)
+{
+	struct advance_timeline_context* context = &CONTEXT.timeline;
+
+	advance_timeline_end(context, context->state.counter, TIMELINE_UPDATE);
+}
+
+/*************************************************************************************/
+/* Advance */
+
+/**
+ * Get the number of the current frame.
+ * It's the frame emulated by MAME. The video thread may still be
+ * drawing the previous ones.
+ */
+unsigned advance_timeline_frame(struct advance_timeline_context* context)
+{
+	return context->state.counter;
+}
+
+/**
+ * Move to the next frame.
+ * \param skip_flag If the next frame is skipped.
+ */
+void advance_timeline_next(struct advance_timeline_context* context, adv_bool skip_flag)
+{
+	struct advance_timeline_frame* frame;
+
+	if (!context->state.active_flag)
+		return;
+
+	++context->state.counter;
+
+	frame = &context->state.frame_map[context->state.counter % TIMELINE_FRAME_MAX];
+
+	memset(frame, 0, sizeof(*frame));
+	frame->counter = context->state.counter;
+	frame->skip_flag = skip_flag;
+}
+
+void advance_timeline_begin(struct advance_timeline_context* context, unsigned counter, unsigned phase)
+{
+	if (!context->state.active_flag)
+		return;
+
+	context->state.frame_map[counter % TIMELINE_FRAME_MAX].begin[phase] = target_clock();
+}
+
+void advance_timeline_end(struct advance_timeline_context* context, unsigned counter, unsigned phase)
+{
+	if (!context->state.active_flag)
+		return;
+
+	context->state.frame_map[counter % TIMELINE_FRAME_MAX].end[phase] = target_clock();
+}
+
+/**
+ * Store the state of the sound rate control.
+ * \param buffered Number of samples buffered.
+ * \param target Number of samples that should be buffered.
+ * \param correction Relative correction of the sound rate.
+ */
+void advance_timeline_sound(struct advance_timeline_context* context, unsigned counter, int buffered, int target, double correction)
+{
+	struct advance_timeline_frame* frame;
+
+	if (!context->state.active_flag)
+		return;
+
+	frame = &context->state.frame_map[counter % TIMELINE_FRAME_MAX];
+
+	frame->sound_time = target_clock();
+	frame->sound_buffered = buffered;
+	frame->sound_target = target;
+	frame->sound_correction = correction;
+}
+
+static adv_conf_enum_int OPTION_TIMELINE[] = {
+	{ "none", TIMELINE_FORMAT_NONE },
+	{ "json", TIMELINE_FORMAT_JSON },
+	{ "csv", TIMELINE_FORMAT_CSV }
+};
+
+adv_error advance_timeline_config_load(struct advance_timeline_context* context, adv_conf* cfg_context)
+{
+	sncpy(context->config.dir_buffer, sizeof(context->config.dir_buffer), conf_string_get_default(cfg_context, "dir_snap"));
+	context->config.format = conf_int_get_default(cfg_context, "misc_timeline");
+
+	return 0;
+}
+
+adv_error advance_timeline_init(struct advance_timeline_context* context, adv_conf* cfg_context)
+{
+	conf_int_register_enum_default(cfg_context, "misc_timeline", conf_enum(OPTION_TIMELINE), TIMELINE_FORMAT_NONE);
+
+	context->state.active_flag = 0;
+	context->state.frame_map = 0;
+	context->state.counter = 0;
+
+	return 0;
+}
+
+void advance_timeline_done(struct advance_timeline_context* context)
+{
+}
+
+adv_error advance_timeline_inner_init(struct advance_timeline_context* context)
+{
+	if (context->config.format == TIMELINE_FORMAT_NONE)
+		return 0;
+
+	context->state.frame_map = malloc(TIMELINE_FRAME_MAX * sizeof(struct advance_timeline_frame));
+	if (!context->state.frame_map)
+		return -1;
+
+	memset(context->state.frame_map, 0, TIMELINE_FRAME_MAX * sizeof(struct advance_timeline_frame));
+
+	context->state.counter = 0;
+	context->state.base = target_clock();
+	context->state.active_flag = 1;
+
+	log_std(("osd: timeline of %d frames\n", TIMELINE_FRAME_MAX));
+
+	return 0;
+}
+
+void advance_timeline_inner_done(struct advance_timeline_context* context)
+{
+	if (!context->state.active_flag)
+		return;
+
+	/* save the last frames at the exit */
+	timeline_save(context, CONTEXT.game);
+
+	context->state.active_flag = 0;
+
+	free(context->state.frame_map);
+	context->state.frame_map = 0;
+}
@@ -779,13 +779,9 @@ adv_bool advance_ui_direct_active(struct advance_ui_context* context)
 /**************************************************************************/
 /* Update */
 
-static void ui_message_update(struct advance_ui_context* context, adv_bitmap* dst, struct ui_color_set* color)
+static void ui_message_update(struct advance_ui_context* context, const struct advance_ui_frame* frame, adv_bitmap* dst, struct ui_color_set* color)
 {
-	if (context->state.ui_message_stop_time < advance_timer()) {
-		context->state.ui_message_flag = 0;
-	}
-
-	ui_messagebox_center(context, dst, dst->size_x / 2, dst->size_y / 2, context->state.ui_message_buffer, context->state.ui_message_buffer + strlen(context->state.ui_message_buffer), color->ui_f, color->ui_b, color->ui_alpha, color->def);
+	ui_messagebox_center(context, dst, dst->size_x / 2, dst->size_y / 2, frame->message_buffer, frame->message_buffer + strlen(frame->message_buffer), color->ui_f, color->ui_b, color->ui_alpha, color->def);
 }
 
 #define UI_MAP_MAX 256
@@ -807,51 +803,20 @@ static void ui_help_update_key(adv_bitmap* dst, adv_bitmap* src, int x, int y, i
 	}
 }
 
-static void ui_help_update(struct advance_ui_context* context, adv_bitmap* dst, struct ui_color_set* color)
+/**
+ * Get the keys to highlight in the help image.
+ * It accesses the MAME ports, and it cannot be called from the video thread.
+ */
+static void ui_help_set(struct advance_ui_context* context, struct advance_ui_frame* frame)
 {
-	int size_x;
-	int size_y;
-	int pos_x;
-	int pos_y;
-	unsigned cx;
-	unsigned cy;
 	unsigned i;
-	unsigned pb;
-	char msg_buffer[256];
-	adv_bitmap* flat;
-	adv_color_def def = color->def;
-
 	struct mame_digital_map_entry digital_map[UI_MAP_MAX];
 	unsigned digital_mac;
 
 	mame_ui_input_map(&digital_mac, digital_map, UI_MAP_MAX);
 
-	size_x = context->state.help_image->size_x;
-	size_y = context->state.help_image->size_y;
-
-	pos_x = dst->size_x / 2 - size_x / 2;
-	pos_y = dst->size_y / 8;
-
-	if (ui_alpha(def))
-		flat = adv_bitmap_alloc(size_x, size_y, color_def_bytes_per_pixel_get(context->state.buffer_def));
-	else
-		flat = adv_bitmap_alloc(size_x, size_y, color_def_bytes_per_pixel_get(def));
-
-	pb = 0; /* black on RGB format */
-
-	for (cy = 0; cy < context->state.help_image->size_y; ++cy) {
-		for (cx = 0; cx < context->state.help_image->size_x; ++cx) {
-			adv_pixel c;
-			if ((adv_bitmap_pixel_get(context->state.help_image, cx, cy)) != pb) {
-				c = color->ui_f.f;
-			} else {
-				c = color->ui_b.b;
-			}
-			adv_bitmap_pixel_put(flat, cx, cy, c);
-		}
-	}
-
-	msg_buffer[0] = 0;
+	frame->help_buffer[0] = 0;
+	frame->help_key_mac = 0;
 
 	for (i = 0; i < digital_mac; ++i) {
 		unsigned j;
@@ -871,9 +836,9 @@ static void ui_help_update(struct advance_ui_context* context, adv_bitmap* dst,
 						break;
 
 				if (k == i) {
-					if (msg_buffer[0])
-						sncat(msg_buffer, sizeof(msg_buffer), ", ");
-					sncat(msg_buffer, sizeof(msg_buffer), p->desc);
+					if (frame->help_buffer[0])
+						sncat(frame->help_buffer, sizeof(frame->help_buffer), ", ");
+					sncat(frame->help_buffer, sizeof(frame->help_buffer), p->desc);
 				}
 			}
 		}
@@ -881,27 +846,15 @@ static void ui_help_update(struct advance_ui_context* context, adv_bitmap* dst,
 		for (j = 0; j < MAME_INPUT_MAP_MAX && digital_map[i].seq[j] != DIGITAL_SPECIAL_NONE; ++j) {
 			if (!pred_not) {
 				unsigned k;
-				unsigned ckf;
-				unsigned ckb;
-
-				switch (mame_port_player(digital_map[i].port)) {
-				case 1: ckb = color->help_p1.b; break;
-				case 2: ckb = color->help_p2.b; break;
-				case 3: ckb = color->help_p3.b; break;
-				case 4: ckb = color->help_p4.b; break;
-				default: ckb = color->help_u.b; break;
-				}
-				ckf = color->ui_f.f;
-
-				if (digital_map[i].port_state) {
-					ckf = color->ui_f.f;
-					ckb = color->ui_f.b;
-				}
 
 				for (k = 0; k < context->config.help_mac; ++k) {
-					if (context->config.help_map[k].code == digital_map[i].seq[j]) {
-						struct help_entry* h = context->config.help_map + k;
-						ui_help_update_key(flat, context->state.help_image, 0, 0, h->x, h->y, h->dx, h->dy, ckf, ckb, pb);
+					if (context->config.help_map[k].code == digital_map[i].seq[j]
+						&& frame->help_key_mac < UI_HELP_KEY_MAX) {
+						struct ui_help_key* key = &frame->help_key_map[frame->help_key_mac];
+						key->index = k;
+						key->player = mame_port_player(digital_map[i].port);
+						key->pressed_flag = digital_map[i].port_state;
+						++frame->help_key_mac;
 					}
 				}
 			}
@@ -909,6 +862,68 @@ static void ui_help_update(struct advance_ui_context* context, adv_bitmap* dst,
 			pred_not = digital_map[i].seq[j] == DIGITAL_SPECIAL_NOT;
 		}
 	}
+}
+
+static void ui_help_update(struct advance_ui_context* context, const struct advance_ui_frame* frame, adv_bitmap* dst, struct ui_color_set* color)
+{
+	int size_x;
+	int size_y;
+	int pos_x;
+	int pos_y;
+	unsigned cx;
+	unsigned cy;
+	unsigned i;
+	unsigned pb;
+	adv_bitmap* flat;
+	adv_color_def def = color->def;
+
+	size_x = context->state.help_image->size_x;
+	size_y = context->state.help_image->size_y;
+
+	pos_x = dst->size_x / 2 - size_x / 2;
+	pos_y = dst->size_y / 8;
+
+	if (ui_alpha(def))
+		flat = adv_bitmap_alloc(size_x, size_y, color_def_bytes_per_pixel_get(context->state.buffer_def));
+	else
+		flat = adv_bitmap_alloc(size_x, size_y, color_def_bytes_per_pixel_get(def));
+
+	pb = 0; /* black on RGB format */
+
+	for (cy = 0; cy < context->state.help_image->size_y; ++cy) {
+		for (cx = 0; cx < context->state.help_image->size_x; ++cx) {
+			adv_pixel c;
+			if ((adv_bitmap_pixel_get(context->state.help_image, cx, cy)) != pb) {
+				c = color->ui_f.f;
+			} else {
+				c = color->ui_b.b;
+			}
+			adv_bitmap_pixel_put(flat, cx, cy, c);
+		}
+	}
+
+	for (i = 0; i < frame->help_key_mac; ++i) {
+		const struct ui_help_key* key = &frame->help_key_map[i];
+		const struct help_entry* h = context->config.help_map + key->index;
+		unsigned ckf;
+		unsigned ckb;
+
+		switch (key->player) {
+		case 1: ckb = color->help_p1.b; break;
+		case 2: ckb = color->help_p2.b; break;
+		case 3: ckb = color->help_p3.b; break;
+		case 4: ckb = color->help_p4.b; break;
+		default: ckb = color->help_u.b; break;
+		}
+		ckf = color->ui_f.f;
+
+		if (key->pressed_flag) {
+			ckf = color->ui_f.f;
+			ckb = color->ui_f.b;
+		}
+
+		ui_help_update_key(flat, context->state.help_image, 0, 0, h->x, h->y, h->dx, h->dy, ckf, ckb, pb);
+	}
 
 	if (ui_alpha(def))
 		adv_bitmap_put_alpha(dst, pos_x, pos_y, def, flat, 0, 0, flat->size_x, flat->size_y, context->state.buffer_def);
@@ -917,42 +932,34 @@ static void ui_help_update(struct advance_ui_context* context, adv_bitmap* dst,
 
 	adv_bitmap_free(flat);
 
-	if (msg_buffer[0])
-		ui_messagebox_center(context, dst, dst->size_x / 2, pos_y + size_y + adv_font_sizey(context->state.ui_font) * 2, msg_buffer, msg_buffer + strlen(msg_buffer), color->ui_f, color->ui_b, color->ui_alpha, color->def);
+	if (frame->help_buffer[0])
+		ui_messagebox_center(context, dst, dst->size_x / 2, pos_y + size_y + adv_font_sizey(context->state.ui_font) * 2, frame->help_buffer, frame->help_buffer + strlen(frame->help_buffer), color->ui_f, color->ui_b, color->ui_alpha, color->def);
 }
 
-static void ui_menu_update(struct advance_ui_context* context, adv_bitmap* dst, struct ui_color_set* color)
+static void ui_menu_update(struct advance_ui_context* context, const struct advance_ui_frame* frame, adv_bitmap* dst, struct ui_color_set* color)
 {
-	ui_menu(context, dst, context->state.ui_menu_map, context->state.ui_menu_mac, context->state.ui_menu_sel, color->ui_f, color->ui_b, color->ui_alpha, color->select_f, color->select_b, color->select_alpha, color->title_f, color->title_b, color->title_alpha, color->def);
-
-	free(context->state.ui_menu_map);
-	context->state.ui_menu_map = 0;
-	context->state.ui_menu_flag = 0;
+	ui_menu(context, dst, frame->menu_map, frame->menu_mac, frame->menu_sel, color->ui_f, color->ui_b, color->ui_alpha, color->select_f, color->select_b, color->select_alpha, color->title_f, color->title_b, color->title_alpha, color->def);
 }
 
-static void ui_osd_update(struct advance_ui_context* context, adv_bitmap* dst, struct ui_color_set* color)
+static void ui_osd_update(struct advance_ui_context* context, const struct advance_ui_frame* frame, adv_bitmap* dst, struct ui_color_set* color)
 {
 	unsigned pos_x, pos_y;
 
 	pos_x = dst->size_x / 2;
 	pos_y = dst->size_y * 7 / 8;
 
-	ui_messagebox_center(context, dst, pos_x, pos_y, context->state.ui_osd_buffer, context->state.ui_osd_buffer + strlen(context->state.ui_osd_buffer), color->ui_f, color->ui_b, color->ui_alpha, color->def);
-
-	context->state.ui_osd_flag = 0;
+	ui_messagebox_center(context, dst, pos_x, pos_y, frame->osd_buffer, frame->osd_buffer + strlen(frame->osd_buffer), color->ui_f, color->ui_b, color->ui_alpha, color->def);
 }
 
-static void ui_scroll_update(struct advance_ui_context* context, adv_bitmap* dst, struct ui_color_set* color)
+static void ui_scroll_update(struct advance_ui_context* context, const struct advance_ui_frame* frame, adv_bitmap* dst, struct ui_color_set* color)
 {
-	ui_scroll(context, dst, context->state.ui_scroll_begin, context->state.ui_scroll_end, context->state.ui_scroll_pos, color->ui_f, color->ui_b, color->ui_alpha, color->title_f, color->title_b, color->title_alpha, color->def);
-
-	context->state.ui_scroll_flag = 0;
+	ui_scroll(context, dst, frame->scroll_begin, frame->scroll_end, frame->scroll_pos, color->ui_f, color->ui_b, color->ui_alpha, color->title_f, color->title_b, color->title_alpha, color->def);
 }
 
-static void ui_direct_text_update(struct advance_ui_context* context, adv_bitmap* dst, struct ui_color_set* color)
+static void ui_direct_text_update(struct advance_ui_context* context, const struct advance_ui_frame* frame, adv_bitmap* dst, struct ui_color_set* color)
 {
-	const char* begin = context->state.ui_direct_buffer;
-	const char* end = context->state.ui_direct_buffer + strlen(context->state.ui_direct_buffer);
+	const char* begin = frame->direct_buffer;
+	const char* end = frame->direct_buffer + strlen(frame->direct_buffer);
 	int pos_x, pos_y;
 	int size_x, size_y;
 	unsigned orientation;
@@ -983,8 +990,6 @@ static void ui_direct_text_update(struct advance_ui_context* context, adv_bitmap
 	}
 
 	adv_font_put_string_oriented(context->state.ui_font_oriented, dst, pos_x, pos_y, begin, end, color->ui_f.p, color->ui_b.p, context->config.ui_font_orientation);
-
-	context->state.ui_direct_text_flag = 0;
 }
 
 static void ui_direct_slow_update(struct advance_ui_context* context, adv_bitmap* dst, struct ui_color_set* color)
@@ -999,8 +1004,6 @@ static void ui_direct_slow_update(struct advance_ui_context* context, adv_bitmap
 	pos_y = size_y / 4;
 
 	adv_bitmap_clear(dst, pos_x, pos_y, size_x, size_y, color->help_p3.p);
-
-	context->state.ui_direct_slow_flag = 0;
 }
 
 static void ui_direct_fast_update(struct advance_ui_context* context, adv_bitmap* dst, struct ui_color_set* color)
@@ -1026,8 +1029,6 @@ static void ui_direct_fast_update(struct advance_ui_context* context, adv_bitmap
 		adv_bitmap_clear(dst, pos_x, pos_y + i, l, 1, color->help_p3.p);
 		adv_bitmap_clear(dst, pos_x, pos_y + size_y - 1 - i, l, 1, color->help_p3.p);
 	}
-
-	context->state.ui_direct_slow_flag = 0;
 }
 
 static void ui_color_rgb_set(struct ui_color* color, const adv_color_rgb* c, adv_color_def color_def, adv_color_def buffer_def, unsigned translucency, adv_pixel* background)
@@ -1185,7 +1186,109 @@ static void ui_setup_color(struct advance_ui_context* context, struct ui_color_s
 	color->def = color_def;
 }
 
-void advance_ui_buffer_update(struct advance_ui_context* context, void* ptr, unsigned dx, unsigned dy, unsigned dw, adv_color_def color_def, adv_color_rgb* palette_map, unsigned palette_max)
+/**************************************************************************/
+/* Frame */
+
+void advance_ui_frame_init(struct advance_ui_frame* frame)
+{
+	memset(frame, 0, sizeof(struct advance_ui_frame));
+}
+
+void advance_ui_frame_done(struct advance_ui_frame* frame)
+{
+	free(frame->menu_map);
+	frame->menu_map = 0;
+	free(frame->scroll_begin);
+	frame->scroll_begin = 0;
+	frame->scroll_end = 0;
+}
+
+/**
+ * Take the user interface to draw in the next frame.
+ * The commands drawn only one time are removed from the user interface state.
+ * This function cannot be called from the video thread.
+ */
+void advance_ui_frame_set(struct advance_ui_context* context, struct advance_ui_frame* frame)
+{
+	frame->extra_flag = context->state.ui_extra_flag;
+
+	frame->help_flag = context->state.ui_help_flag;
+	if (frame->help_flag) {
+		ui_help_set(context, frame);
+	}
+
+	frame->menu_flag = context->state.ui_menu_flag;
+	if (frame->menu_flag) {
+		/* move the menu in the frame */
+		free(frame->menu_map);
+		frame->menu_map = context->state.ui_menu_map;
+		frame->menu_mac = context->state.ui_menu_mac;
+		frame->menu_sel = context->state.ui_menu_sel;
+		context->state.ui_menu_map = 0;
+		context->state.ui_menu_flag = 0;
+	}
+
+	frame->message_flag = context->state.ui_message_flag;
+	if (frame->message_flag) {
+		sncpy(frame->message_buffer, sizeof(frame->message_buffer), context->state.ui_message_buffer);
+		if (context->state.ui_message_stop_time < advance_timer()) {
+			context->state.ui_message_flag = 0;
+		}
+	}
+
+	frame->osd_flag = context->state.ui_osd_flag;
+	if (frame->osd_flag) {
+		sncpy(frame->osd_buffer, sizeof(frame->osd_buffer), context->state.ui_osd_buffer);
+		context->state.ui_osd_flag = 0;
+	}
+
+	frame->scroll_flag = context->state.ui_scroll_flag;
+	if (frame->scroll_flag) {
+		/* move the text in the frame */
+		free(frame->scroll_begin);
+		frame->scroll_begin = context->state.ui_scroll_begin;
+		frame->scroll_end = context->state.ui_scroll_end;
+		frame->scroll_pos = context->state.ui_scroll_pos;
+		context->state.ui_scroll_begin = 0;
+		context->state.ui_scroll_end = 0;
+		context->state.ui_scroll_flag = 0;
+	}
+
+	frame->direct_text_flag = context->state.ui_direct_text_flag;
+	if (frame->direct_text_flag) {
+		sncpy(frame->direct_buffer, sizeof(frame->direct_buffer), context->state.ui_direct_buffer);
+		context->state.ui_direct_text_flag = 0;
+	}
+
+	frame->direct_slow_flag = context->state.ui_direct_slow_flag;
+	frame->direct_fast_flag = context->state.ui_direct_fast_flag;
+
+	/* if something is drawn in the buffer, the next frame has to clear it */
+	context->state.ui_extra_flag = frame->help_flag
+		|| frame->menu_flag
+		|| frame->message_flag
+		|| frame->osd_flag
+		|| frame->scroll_flag;
+}
+
+adv_bool advance_ui_frame_buffer_active(const struct advance_ui_frame* frame)
+{
+	return frame->extra_flag
+	       || frame->message_flag
+	       || frame->help_flag
+	       || frame->menu_flag
+	       || frame->osd_flag
+	       || frame->scroll_flag;
+}
+
+adv_bool advance_ui_frame_direct_active(const struct advance_ui_frame* frame)
+{
+	return frame->direct_text_flag
+	       || frame->direct_slow_flag
+	       || frame->direct_fast_flag;
+}
+
+void advance_ui_buffer_update(struct advance_ui_context* context, const struct advance_ui_frame* frame, void* ptr, unsigned dx, unsigned dy, unsigned dw, adv_color_def color_def, adv_color_rgb* palette_map, unsigned palette_max)
 {
 	adv_bitmap* dst;
 	struct ui_color_set* color = &context->state.color_map;
@@ -1194,33 +1297,26 @@ void advance_ui_buffer_update(struct advance_ui_context* context, void* ptr, uns
 
 	dst = adv_bitmap_import_rgb(dx, dy, color_def_bytes_per_pixel_get(color_def), 0, 0, ptr, dw);
 
-	context->state.ui_extra_flag = 0;
-
-	if (context->state.ui_help_flag) {
-		ui_help_update(context, dst, color);
-		context->state.ui_extra_flag = 1;
+	if (frame->help_flag) {
+		ui_help_update(context, frame, dst, color);
 	}
-	if (context->state.ui_menu_flag) {
-		ui_menu_update(context, dst, color);
-		context->state.ui_extra_flag = 1;
+	if (frame->menu_flag) {
+		ui_menu_update(context, frame, dst, color);
 	}
-	if (context->state.ui_message_flag) {
-		ui_message_update(context, dst, color);
-		context->state.ui_extra_flag = 1;
+	if (frame->message_flag) {
+		ui_message_update(context, frame, dst, color);
 	}
-	if (context->state.ui_osd_flag) {
-		ui_osd_update(context, dst, color);
-		context->state.ui_extra_flag = 1;
+	if (frame->osd_flag) {
+		ui_osd_update(context, frame, dst, color);
 	}
-	if (context->state.ui_scroll_flag) {
-		ui_scroll_update(context, dst, color);
-		context->state.ui_extra_flag = 1;
+	if (frame->scroll_flag) {
+		ui_scroll_update(context, frame, dst, color);
 	}
 
 	adv_bitmap_free(dst);
 }
 
-void advance_ui_direct_update(struct advance_ui_context* context, void* ptr, unsigned dx, unsigned dy, unsigned dw, adv_color_def color_def, adv_color_rgb* palette_map, unsigned palette_max)
+void advance_ui_direct_update(struct advance_ui_context* context, const struct advance_ui_frame* frame, void* ptr, unsigned dx, unsigned dy, unsigned dw, adv_color_def color_def, adv_color_rgb* palette_map, unsigned palette_max)
 {
 	adv_bitmap* dst;
 	struct ui_color_set color;
@@ -1229,16 +1325,16 @@ void advance_ui_direct_update(struct advance_ui_context* context, void* ptr, uns
 
 	dst = adv_bitmap_import_rgb(dx, dy, color_def_bytes_per_pixel_get(color_def), 0, 0, ptr, dw);
 
-	if (context->state.ui_direct_slow_flag) {
+	if (frame->direct_slow_flag) {
 		ui_direct_slow_update(context, dst, &color);
 	}
 
-	if (context->state.ui_direct_fast_flag) {
+	if (frame->direct_fast_flag) {
 		ui_direct_fast_update(context, dst, &color);
 	}
 
-	if (context->state.ui_direct_text_flag) {
-		ui_direct_text_update(context, dst, &color);
+	if (frame->direct_text_flag) {
+		ui_direct_text_update(context, frame, dst, &color);
 	}
 
 	adv_bitmap_free(dst);
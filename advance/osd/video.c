@@ -326,6 +326,9 @@ static void video_command(struct advance_video_context* context, struct advance_
 			if (context->state.measure_counter == 0) {
 				context->state.measure_stop = target_clock();
 
+				if (context->config.bench_flag)
+					mame_bench_stop();
+
 				/* force the exit at the next frame */
 				CONTEXT.input.state.input_forced_exit_flag = 1;
 			}
@@ -454,6 +457,9 @@ static void video_command(struct advance_video_context* context, struct advance_
 		unsigned skip;
 		unsigned rate;
 		unsigned l;
+		unsigned rewind_seconds;
+		unsigned rewind_memory;
+		double rewind_time;
 
 		if (context->state.info_counter) {
 			--context->state.info_counter;
@@ -489,6 +495,11 @@ static void video_command(struct advance_video_context* context, struct advance_
 		if (l >= 11 && isspace(buffer[l - 11]))
 			buffer[l - 11] = ADV_FONT_FIXSPACE;
 
+		/* rewind ring, time span, memory used and time per frame */
+		mame_ui_rewind_info(&rewind_seconds, &rewind_memory, &rewind_time);
+		if (rewind_memory != 0)
+			snprintf(buffer + l, sizeof(buffer) - l, " - %us %uM %.2fms", rewind_seconds, rewind_memory / (1024 * 1024), rewind_time * 1000);
+
 		advance_ui_direct_text(ui_context, buffer);
 
 		hardware_script_info(0, 0, 0, buffer);
@@ -544,8 +555,10 @@ static void video_frame_stop(struct advance_video_context* context)
 		context->state.update_timing_min = stop;
 }
 
-static void video_frame_update_now(struct advance_video_context* context, struct advance_sound_context* sound_context, struct advance_estimate_context* estimate_context, struct advance_record_context* record_context, struct advance_ui_context* ui_context, struct advance_safequit_context* safequit_context, const struct osd_bitmap* game, const struct osd_bitmap* debug, const osd_rgb_t* debug_palette, unsigned debug_palette_size, unsigned led, unsigned input, const short* sample_buffer, unsigned sample_count, unsigned sample_recount, adv_bool skip_flag)
+static void video_frame_update_now(struct advance_video_context* context, struct advance_sound_context* sound_context, struct advance_estimate_context* estimate_context, struct advance_record_context* record_context, struct advance_ui_context* ui_context, const struct advance_ui_frame* ui_frame, struct advance_safequit_context* safequit_context, const struct osd_bitmap* game, const struct osd_bitmap* debug, const osd_rgb_t* debug_palette, unsigned debug_palette_size, unsigned led, unsigned input, const short* sample_buffer, unsigned sample_count, unsigned sample_recount, adv_bool skip_flag, unsigned timeline)
 {
+	struct advance_timeline_context* timeline_context = &CONTEXT.timeline;
+
 	/* Do a yield immediatly before the time syncronization. */
 	/* If a schedule will be done, it's better to have it now when */
 	/* we need to wait the syncronization point. Obviously it may happen */
@@ -553,7 +566,9 @@ static void video_frame_update_now(struct advance_video_context* context, struct
 	target_yield();
 
 	/* the frame syncronization is out of the time estimation */
+	advance_timeline_begin(timeline_context, timeline, TIMELINE_SYNC);
 	advance_video_sync(context, sound_context, estimate_context, skip_flag);
+	advance_timeline_end(timeline_context, timeline, TIMELINE_SYNC);
 
 	/* start updating */
 	video_frame_start(context);
@@ -562,16 +577,22 @@ static void video_frame_update_now(struct advance_video_context* context, struct
 	advance_estimate_osd_begin(estimate_context);
 
 	/* update the video for the new frame */
-	advance_video_frame(context, record_context, ui_context, game, debug, debug_palette, debug_palette_size, skip_flag);
+	advance_timeline_begin(timeline_context, timeline, TIMELINE_BLIT);
+	advance_video_frame(context, record_context, ui_context, ui_frame, game, debug, debug_palette, debug_palette_size, skip_flag);
+	advance_timeline_end(timeline_context, timeline, TIMELINE_BLIT);
 
 	/* update the audio buffer for the new frame */
+	advance_timeline_begin(timeline_context, timeline, TIMELINE_AUDIO);
 	advance_sound_frame(sound_context, record_context, context, safequit_context, sample_buffer, sample_count, sample_recount, context->config.rawsound_flag || video_is_normal_speed(context));
+	advance_timeline_end(timeline_context, timeline, TIMELINE_AUDIO);
 
 	/* estimate the time */
 	advance_estimate_osd_end(estimate_context, skip_flag);
 
 	/* stop updating, this may include a vsync and it's out of the time estimation */
+	advance_timeline_begin(timeline_context, timeline, TIMELINE_PRESENT);
 	video_frame_stop(context);
+	advance_timeline_end(timeline_context, timeline, TIMELINE_PRESENT);
 }
 
 /**
@@ -583,8 +604,32 @@ void advance_video_thread_wait(struct advance_video_context* context)
 	/* wait until the thread is ready */
 	pthread_mutex_lock(&context->state.thread_video_mutex);
 
-	/* wait for the stop notification  */
-	while (context->state.thread_state_ready_flag) {
+	/* wait until all the queued frames are drawn and the bitmap copied */
+	while (context->state.thread_queue_count != 0 || context->state.thread_ring_copy_src != 0) {
+		pthread_cond_wait(&context->state.thread_video_cond, &context->state.thread_video_mutex);
+	}
+
+	pthread_mutex_unlock(&context->state.thread_video_mutex);
+#else
+	/* nothing */
+#endif
+}
+
+/**
+ * Wait until MAME can draw in the game bitmap.
+ * After a move of the bitmap in the next block of the ring, the video thread
+ * copies in it the previous frame, because not all the drivers redraw it completely.
+ * The queued frames are not waited.
+ */
+void advance_video_thread_bitmap_wait(struct advance_video_context* context)
+{
+#ifdef USE_SMP
+	if (!context->config.smp_flag)
+		return;
+
+	pthread_mutex_lock(&context->state.thread_video_mutex);
+
+	while (context->state.thread_ring_copy_src != 0) {
 		pthread_cond_wait(&context->state.thread_video_cond, &context->state.thread_video_mutex);
 	}
 
@@ -644,84 +689,214 @@ static void video_thread_bitmap_free(struct osd_bitmap* bitmap)
 	}
 }
 
+/**
+ * Free the ring of game bitmaps.
+ * The MAME bitmap is moved back in its original memory block.
+ */
+static void video_thread_ring_free(struct advance_video_context* context)
+{
+	unsigned i;
+
+	if (!context->state.thread_ring_mac)
+		return;
+
+	if (context->state.thread_ring_pos != 0)
+		mame_video_bitmap_relocate(context->state.thread_ring_map[0]);
+
+	/* the first block is owned by MAME */
+	for (i = 1; i < context->state.thread_ring_mac; ++i)
+		free(context->state.thread_ring_map[i]);
+
+	context->state.thread_ring_mac = 0;
+	context->state.thread_ring_pos = 0;
+}
+
+/**
+ * Allocate the ring of game bitmaps.
+ * The first block is the one currently used by MAME.
+ */
+static adv_error video_thread_ring_alloc(struct advance_video_context* context, const struct osd_bitmap* game)
+{
+	context->state.thread_ring_map[0] = game->block_ptr;
+	context->state.thread_ring_size = game->block_size;
+	context->state.thread_ring_pos = 0;
+	context->state.thread_ring_mac = 1;
+
+	/* one block for every queued frame, and one for MAME */
+	while (context->state.thread_ring_mac < context->config.smp_queue + 1) {
+		void* block = malloc(game->block_size);
+		if (!block) {
+			video_thread_ring_free(context);
+			return -1;
+		}
+
+		/* start with the same data, including the safety area around the bitmap */
+		memcpy(block, game->block_ptr, game->block_size);
+
+		context->state.thread_ring_map[context->state.thread_ring_mac] = block;
+		++context->state.thread_ring_mac;
+	}
+
+	log_std(("advance:thread: bitmap ring of %d blocks of %d bytes\n", context->state.thread_ring_mac, context->state.thread_ring_size));
+
+	return 0;
+}
+
+/**
+ * Pass the game bitmap at the thread.
+ * If the MAME bitmap is movable, the thread uses directly its memory block,
+ * and MAME draws the next frame in the next block of the ring, after the
+ * thread has copied in it the frame just passed.
+ * Otherwise the bitmap is copied.
+ */
+static void video_thread_bitmap_set(struct advance_video_context* context, struct advance_video_thread_frame* frame, const struct osd_bitmap* game)
+{
+	unsigned pos;
+
+	/* allocate the ring at the first movable bitmap */
+	if (game && game->block_ptr && !context->state.thread_ring_mac && !context->state.thread_ring_fail_flag) {
+		if (video_thread_ring_alloc(context, game) != 0) {
+			log_std(("ERROR:advance:thread: low memory for the bitmap ring, copy the bitmap\n"));
+			context->state.thread_ring_fail_flag = 1;
+		}
+	}
+
+	if (game && game->block_ptr && context->state.thread_ring_mac) {
+		/* the MAME bitmap is moved only by us */
+		assert(context->state.thread_ring_map[context->state.thread_ring_pos] == game->block_ptr);
+		assert(context->state.thread_ring_size == game->block_size);
+
+		frame->game_ring = *game;
+		frame->game = &frame->game_ring;
+
+		/* the queue has at most smp_queue - 1 frames, all using the blocks */
+		/* before the current one, and then the next block is not used */
+		pos = context->state.thread_ring_pos + 1;
+		if (pos == context->state.thread_ring_mac)
+			pos = 0;
+
+		/* MAME has already waited the previous copy before drawing, */
+		/* but a frame may be passed without drawing it */
+		while (context->state.thread_ring_copy_src != 0) {
+			pthread_cond_wait(&context->state.thread_video_cond, &context->state.thread_video_mutex);
+		}
+
+		mame_video_bitmap_relocate(context->state.thread_ring_map[pos]);
+
+		/* the drivers may draw only part of the bitmap, or nothing, */
+		/* and then the next block must start with the same frame */
+		context->state.thread_ring_copy_src = context->state.thread_ring_map[context->state.thread_ring_pos];
+		context->state.thread_ring_copy_dst = context->state.thread_ring_map[pos];
+
+		context->state.thread_ring_pos = pos;
+	} else {
+		frame->game_copy = video_thread_bitmap_duplicate(frame->game_copy, game);
+		frame->game = frame->game_copy;
+	}
+}
+
+/**
+ * Check if the frame is drawn by the video thread.
+ */
+static adv_bool video_thread_is_used(struct advance_video_context* context)
+{
+	return context->config.smp_flag && !context->state.debugger_flag;
+}
+
 #endif
 
 /**
  * Precomputation of the frame before updating.
- * Mainly used to duplicate the data for the video thread.
+ * Mainly used to pass the data at the video thread.
  */
-static void video_frame_prepare(struct advance_video_context* context, struct advance_sound_context* sound_context, struct advance_estimate_context* estimate_context, const struct osd_bitmap* game, const struct osd_bitmap* debug, const osd_rgb_t* debug_palette, unsigned debug_palette_size, unsigned led, unsigned input, const short* sample_buffer, unsigned sample_count, unsigned sample_recount, adv_bool skip_flag)
+static void video_frame_prepare(struct advance_video_context* context, struct advance_sound_context* sound_context, struct advance_estimate_context* estimate_context, struct advance_ui_context* ui_context, const struct osd_bitmap* game, const struct osd_bitmap* debug, const osd_rgb_t* debug_palette, unsigned debug_palette_size, unsigned led, unsigned input, const short* sample_buffer, unsigned sample_count, unsigned sample_recount, adv_bool skip_flag)
 {
 #ifdef USE_SMP
-	/* don't use the thread if the debugger is active */
-	if (context->config.smp_flag && !context->state.debugger_flag) {
+	struct advance_video_thread_frame* frame;
 
-		/* duplicate the data */
-		pthread_mutex_lock(&context->state.thread_video_mutex);
+	if (!video_thread_is_used(context)) {
+		/* the frame is drawn directly, wait for the queued ones */
+		if (context->config.smp_flag)
+			advance_video_thread_wait(context);
+		return;
+	}
 
-		/* wait for the stop notification  */
-		while (context->state.thread_state_ready_flag) {
-			pthread_cond_wait(&context->state.thread_video_cond, &context->state.thread_video_mutex);
-		}
+	/* pass the data */
+	pthread_mutex_lock(&context->state.thread_video_mutex);
 
-		advance_estimate_common_begin(estimate_context);
+	/* wait for a free position in the queue */
+	while (context->state.thread_queue_count >= context->config.smp_queue) {
+		pthread_cond_wait(&context->state.thread_video_cond, &context->state.thread_video_mutex);
+	}
 
-		if (!skip_flag) {
-			context->state.thread_state_game = video_thread_bitmap_duplicate(context->state.thread_state_game, game);
-		}
+	advance_estimate_common_begin(estimate_context);
 
-		context->state.thread_state_led = led;
-		context->state.thread_state_input = input;
-		context->state.thread_state_skip_flag = skip_flag;
+	frame = &context->state.thread_queue_map[context->state.thread_queue_in];
 
-		if (sample_count > context->state.thread_state_sample_max) {
-			log_std(("advance:thread: realloc sample buffer %d samples -> %d samples, %d bytes\n", context->state.thread_state_sample_max, 2 * sample_count, sound_context->state.input_bytes_per_sample * 2 * sample_count));
-			context->state.thread_state_sample_max = 2 * sample_count;
-			context->state.thread_state_sample_buffer = realloc(context->state.thread_state_sample_buffer, sound_context->state.input_bytes_per_sample * context->state.thread_state_sample_max);
-			assert(context->state.thread_state_sample_buffer);
-		}
+	if (!skip_flag) {
+		video_thread_bitmap_set(context, frame, game);
+	}
 
-		memcpy(context->state.thread_state_sample_buffer, sample_buffer, sample_count * sound_context->state.input_bytes_per_sample);
-		context->state.thread_state_sample_count = sample_count;
-		context->state.thread_state_sample_recount = sample_recount;
+	frame->led = led;
+	frame->input = input;
+	frame->skip_flag = skip_flag;
+	frame->timeline = advance_timeline_frame(&CONTEXT.timeline);
 
-		advance_estimate_common_end(estimate_context, skip_flag);
+	/* the ui is taken only if the frame is drawn, otherwise it remains for the next one */
+	if (!skip_flag) {
+		advance_ui_frame_set(ui_context, &frame->ui);
+	}
 
-		pthread_mutex_unlock(&context->state.thread_video_mutex);
+	if (sample_count > frame->sample_max) {
+		log_std(("advance:thread: realloc sample buffer %d samples -> %d samples, %d bytes\n", frame->sample_max, 2 * sample_count, sound_context->state.input_bytes_per_sample * 2 * sample_count));
+		frame->sample_max = 2 * sample_count;
+		frame->sample_buffer = realloc(frame->sample_buffer, sound_context->state.input_bytes_per_sample * frame->sample_max);
+		assert(frame->sample_buffer);
 	}
+
+	memcpy(frame->sample_buffer, sample_buffer, sample_count * sound_context->state.input_bytes_per_sample);
+	frame->sample_count = sample_count;
+	frame->sample_recount = sample_recount;
+
+	advance_estimate_common_end(estimate_context, skip_flag);
+
+	pthread_mutex_unlock(&context->state.thread_video_mutex);
 #endif
 }
 
 /**
  * Update the frame.
- * If SMP is active only signals at the thread to start the
- * update and returns immeditely. Otherwise it returns only then the
+ * If SMP is active only queues the frame at the thread and
+ * returns immeditely. Otherwise it returns only then the
  * frame is complete.
  */
 static void video_frame_update(struct advance_video_context* context, struct advance_sound_context* sound_context, struct advance_estimate_context* estimate_context, struct advance_record_context* record_context, struct advance_ui_context* ui_context, struct advance_safequit_context* safequit_context, const struct osd_bitmap* game, const struct osd_bitmap* debug, const osd_rgb_t* debug_palette, unsigned debug_palette_size, unsigned led, unsigned input, const short* sample_buffer, unsigned sample_count, unsigned sample_recount, adv_bool skip_flag)
 {
 #ifdef USE_SMP
-	if (context->config.smp_flag && !context->state.debugger_flag
-	        /* we don't duplicate the UI data, and then we cannot access it directly from the thread */
-		&& !advance_ui_buffer_active(ui_context)
-	) {
+	if (video_thread_is_used(context)) {
 		pthread_mutex_lock(&context->state.thread_video_mutex);
 
 		log_debug(("advance:thread: signal\n"));
 
-		/* notify that the data is ready */
-		context->state.thread_state_ready_flag = 1;
+		/* queue the frame */
+		context->state.thread_queue_map[context->state.thread_queue_in].time = advance_timer();
+		context->state.thread_queue_in = (context->state.thread_queue_in + 1) % THREAD_QUEUE_MAX;
+		++context->state.thread_queue_count;
 
 		/* signal at the thread to start */
 		pthread_cond_signal(&context->state.thread_video_cond);
 
 		pthread_mutex_unlock(&context->state.thread_video_mutex);
-	} else {
-		video_frame_update_now(context, sound_context, estimate_context, record_context, ui_context, safequit_context, game, debug, debug_palette, debug_palette_size, led, input, sample_buffer, sample_count, sample_recount, skip_flag);
+		return;
 	}
-#else
-	video_frame_update_now(context, sound_context, estimate_context, record_context, ui_context, safequit_context, game, debug, debug_palette, debug_palette_size, led, input, sample_buffer, sample_count, sample_recount, skip_flag);
 #endif
+
+	/* the ui is taken only if the frame is drawn, otherwise it remains for the next one */
+	if (!skip_flag) {
+		advance_ui_frame_set(ui_context, &context->state.ui_frame);
+	}
+
+	video_frame_update_now(context, sound_context, estimate_context, record_context, ui_context, &context->state.ui_frame, safequit_context, game, debug, debug_palette, debug_palette_size, led, input, sample_buffer, sample_count, sample_recount, skip_flag, advance_timeline_frame(&CONTEXT.timeline));
 }
 
 #ifdef USE_SMP
@@ -743,17 +918,38 @@ static void* video_thread(void* void_context)
 
 	while (1) {
 		adv_bool exit;
+		struct advance_video_thread_frame* frame;
+		double latency;
 
 		log_debug(("advance:thread: wait\n"));
 
-		/* wait for the start notification */
-		while (!context->state.thread_state_ready_flag && !context->state.thread_exit_flag) {
+		/* wait for a queued frame or a bitmap to copy */
+		while (context->state.thread_queue_count == 0 && context->state.thread_ring_copy_src == 0 && !context->state.thread_exit_flag) {
 			pthread_cond_wait(&context->state.thread_video_cond, &context->state.thread_video_mutex);
 		}
 
 		log_debug(("advance:thread: wakeup\n"));
 
+		/* copy the bitmap before drawing, because MAME is waiting for it */
+		if (context->state.thread_ring_copy_src != 0 && !context->state.thread_exit_flag) {
+			void* src = context->state.thread_ring_copy_src;
+			void* dst = context->state.thread_ring_copy_dst;
+
+			pthread_mutex_unlock(&context->state.thread_video_mutex);
+
+			memcpy(dst, src, context->state.thread_ring_size);
+
+			pthread_mutex_lock(&context->state.thread_video_mutex);
+
+			context->state.thread_ring_copy_src = 0;
+			context->state.thread_ring_copy_dst = 0;
+
+			pthread_cond_signal(&context->state.thread_video_cond);
+			continue;
+		}
+
 		exit = context->state.thread_exit_flag;
+		frame = &context->state.thread_queue_map[context->state.thread_queue_out];
 
 		/* now we can start to draw outside the lock */
 		pthread_mutex_unlock(&context->state.thread_video_mutex);
@@ -772,25 +968,36 @@ static void* video_thread(void* void_context)
 			estimate_context,
 			record_context,
 			ui_context,
+			&frame->ui,
 			safequit_context,
-			context->state.thread_state_game,
+			frame->game,
 			0,
 			0,
 			0,
-			context->state.thread_state_led,
-			context->state.thread_state_input,
-			context->state.thread_state_sample_buffer,
-			context->state.thread_state_sample_count,
-			context->state.thread_state_sample_recount,
-			context->state.thread_state_skip_flag
+			frame->led,
+			frame->input,
+			frame->sample_buffer,
+			frame->sample_count,
+			frame->sample_recount,
+			frame->skip_flag,
+			frame->timeline
 		);
 
 		log_debug(("advance:thread: draw stop\n"));
 
 		pthread_mutex_lock(&context->state.thread_video_mutex);
 
-		/* notify that the data was used, and a new one can be setup */
-		context->state.thread_state_ready_flag = 0;
+		/* account the time spent in the queue and in the drawing */
+		latency = advance_timer() - frame->time;
+		advance_estimate_queue(estimate_context, latency);
+		if (latency > context->state.thread_queue_latency_max)
+			context->state.thread_queue_latency_max = latency;
+		context->state.thread_queue_latency_sum += latency;
+		++context->state.thread_queue_latency_count;
+
+		/* notify that the frame was used, and a new one can be queued */
+		context->state.thread_queue_out = (context->state.thread_queue_out + 1) % THREAD_QUEUE_MAX;
+		--context->state.thread_queue_count;
 
 		/* wakeup the main thread, signalign that the draw finished */
 		pthread_cond_signal(&context->state.thread_video_cond);
@@ -955,20 +1162,34 @@ void osd_stretch_32to32(void* dst, unsigned dst_dx, unsigned dst_dy, unsigned ds
  */
 int osd2_thread_init(void)
 {
-#ifdef USE_SMP
 	struct advance_video_context* context = &CONTEXT.video;
 
+	/* the video thread, created later, inherits the priority */
+	if (context->config.realtime_flag) {
+		if (target_realtime() != 0) {
+			log_std(("WARNING:emu:video: real-time priority not available\n"));
+		} else {
+			log_std(("emu:video: real-time priority\n"));
+		}
+	}
+
+#ifdef USE_SMP
 	log_std(("osd: osd2_thread_init\n"));
 
 	context->state.thread_exit_flag = 0;
-	context->state.thread_state_ready_flag = 0;
-	context->state.thread_state_game = 0;
-	context->state.thread_state_led = 0;
-	context->state.thread_state_input = 0;
-	context->state.thread_state_sample_count = 0;
-	context->state.thread_state_sample_max = 0;
-	context->state.thread_state_sample_buffer = 0;
-	context->state.thread_state_skip_flag = 0;
+	memset(context->state.thread_queue_map, 0, sizeof(context->state.thread_queue_map));
+	context->state.thread_queue_in = 0;
+	context->state.thread_queue_out = 0;
+	context->state.thread_queue_count = 0;
+	context->state.thread_queue_latency_max = 0;
+	context->state.thread_queue_latency_sum = 0;
+	context->state.thread_queue_latency_count = 0;
+	context->state.thread_ring_mac = 0;
+	context->state.thread_ring_size = 0;
+	context->state.thread_ring_pos = 0;
+	context->state.thread_ring_fail_flag = 0;
+	context->state.thread_ring_copy_src = 0;
+	context->state.thread_ring_copy_dst = 0;
 	if (pthread_mutex_init(&context->state.thread_video_mutex, NULL) != 0) {
 		log_std(("ERROR:advance: error calling pthread_mutex_init()\n"));
 		target_err("Error initializing the thread system.\n");
@@ -997,6 +1218,7 @@ void osd2_thread_done(void)
 {
 #ifdef USE_SMP
 	struct advance_video_context* context = &CONTEXT.video;
+	unsigned i;
 
 	log_std(("osd: osd2_thread_done\n"));
 	advance_video_thread_wait(context);
@@ -1011,8 +1233,15 @@ void osd2_thread_done(void)
 	pthread_join(context->state.thread_id, NULL);
 
 	log_std(("advance:thread: exit\n"));
-	video_thread_bitmap_free(context->state.thread_state_game);
-	free(context->state.thread_state_sample_buffer);
+	if (context->state.thread_queue_latency_count) {
+		log_std(("advance:thread: queue of %d frames, latency avg %g ms, max %g ms\n", context->config.smp_queue, context->state.thread_queue_latency_sum * 1000 / context->state.thread_queue_latency_count, context->state.thread_queue_latency_max * 1000));
+	}
+	video_thread_ring_free(context);
+	for (i = 0; i < THREAD_QUEUE_MAX; ++i) {
+		video_thread_bitmap_free(context->state.thread_queue_map[i].game_copy);
+		free(context->state.thread_queue_map[i].sample_buffer);
+		advance_ui_frame_done(&context->state.thread_queue_map[i].ui);
+	}
 	pthread_cond_destroy(&context->state.thread_video_cond);
 	pthread_mutex_destroy(&context->state.thread_video_mutex);
 
@@ -1087,10 +1316,18 @@ void osd2_video_done(void)
 
 	advance_video_mode_done(context);
 
+	if (context->state.sync_late_counter) {
+		log_std(("emu:video: frame deadlines %u, late avg %g [us], max %g [us], missed %u, spin %g [us]\n", context->state.sync_late_counter, context->state.sync_late_sum * 1E6 / context->state.sync_late_counter, context->state.sync_late_max * 1E6, context->state.sync_late_miss, context->state.sync_spin * 1E6));
+	}
+
 	/* print the speed measure */
 	if (context->state.measure_flag
 		&& context->state.measure_stop > context->state.measure_start) {
-		target_out("%g\n", (double)(context->state.measure_stop - context->state.measure_start) / TARGET_CLOCKS_PER_SEC);
+		double real_time = (double)(context->state.measure_stop - context->state.measure_start) / TARGET_CLOCKS_PER_SEC;
+		if (context->config.bench_flag)
+			mame_bench_report(real_time);
+		else
+			target_out("%g\n", real_time);
 	}
 }
 
@@ -1104,6 +1341,9 @@ void osd2_area(unsigned x1, unsigned y1, unsigned x2, unsigned y2)
 
 	log_std(("osd: osd2_area(%d, %d, %d, %d)\n", x1, y1, x2, y2));
 
+	/* the queued frames must be drawn with the old area */
+	advance_video_thread_wait(context);
+
 	pos_x = x1;
 	pos_y = y1;
 	size_x = x2 - x1 + 1;
@@ -1211,10 +1451,17 @@ void osd_reset(void)
 	context->state.fastest_limit = context->config.fastest_time * context->state.game_fps;
 	context->state.fastest_flag = context->state.fastest_limit != 0;
 
-	/* initialize the measure state */
-	context->state.measure_counter = context->config.measure_time * context->state.game_fps;
-	context->state.measure_flag = context->state.measure_counter != 0;
-	context->state.measure_start = target_clock();
+	/* initialize the measure state, only at the first reset to not restart */
+	/* the measure at the soft resets of the game */
+	if (!context->state.measure_flag) {
+		context->state.measure_counter = context->config.measure_time * context->state.game_fps;
+		context->state.measure_flag = context->state.measure_counter != 0;
+		context->state.measure_start = target_clock();
+
+		/* the benchmark profiles all the measured frames */
+		if (context->state.measure_flag && context->config.bench_flag)
+			mame_bench_start();
+	}
 
 	advance_video_update_skip(context);
 	advance_video_update_sync(context);
@@ -1243,7 +1490,7 @@ int osd_skip_this_frame(void)
 	if (context->state.debugger_flag)
 		return 0;
 	else
-		return context->state.skip_flag;
+		return context->state.skip_draw_flag;
 }
 
 static int int_compare(const void* void_a, const void* void_b)
@@ -1257,9 +1504,6 @@ static int int_compare(const void* void_a, const void* void_b)
 	return 0;
 }
 
-/** Number of steps, and maximum correction allowed, for small latency errors. */
-#define AUDIOVIDEO_NEAR_STEP_COUNT 16
-
 /** Number of frames on which distribute the latency error. */
 #define AUDIOVIDEO_DISTRIBUTE_COUNT 4
 
@@ -1269,6 +1513,7 @@ int osd2_frame(const struct osd_bitmap* game, const struct osd_bitmap* debug, co
 
 	/* save the values of the previous skip frame */
 	int skip_flag = context->state.skip_flag;
+	int skip_draw_flag = context->state.skip_draw_flag;
 
 	/* current error of video/sound syncronization */
 	int latency_diff;
@@ -1278,10 +1523,12 @@ int osd2_frame(const struct osd_bitmap* game, const struct osd_bitmap* debug, co
 
 	unsigned i;
 	int sample_limit;
-	int latency_limit;
 
 	adv_bool normal_speed = video_is_normal_speed(&CONTEXT.video);
 
+	/* the emulation of the frame is complete */
+	advance_timeline_end(&CONTEXT.timeline, advance_timeline_frame(&CONTEXT.timeline), TIMELINE_EMULATION);
+
 	/* store the current audio video syncronization error measured in sound samples */
 	context->state.av_sync_map[context->state.av_sync_mac] = context->state.latency_diff;
 
@@ -1291,10 +1538,6 @@ int osd2_frame(const struct osd_bitmap* game, const struct osd_bitmap* debug, co
 	else
 		++context->state.av_sync_mac;
 
-	/* get the latency limit, the computation is different if the error */
-	/* is bigger or lower than the limit */
-	latency_limit = advance_sound_latency(&CONTEXT.sound, 0) / 2;
-
 	if (normal_speed) {
 		int latency_median;
 
@@ -1310,24 +1553,10 @@ int osd2_frame(const struct osd_bitmap* game, const struct osd_bitmap* debug, co
 		/* get the median value from the most recent errors */
 		latency_median = median_map[AUDIOVIDEO_MEASURE_MAX / 2];
 
-		/* if playing at normal speed */
-		if (latency_median >= -latency_limit && latency_median <= latency_limit) {
-			/* if the error is small (in the latency_limit), use a small correction */
-			latency_diff = latency_median / (latency_limit / AUDIOVIDEO_NEAR_STEP_COUNT);
-		} else if (latency_median > latency_limit) {
-			/* if the error is big, use a stronger correction */
-			latency_diff = AUDIOVIDEO_NEAR_STEP_COUNT + (latency_median - latency_limit) / AUDIOVIDEO_DISTRIBUTE_COUNT;
-		} else {
-			latency_diff = -AUDIOVIDEO_NEAR_STEP_COUNT + (latency_median + latency_limit) / AUDIOVIDEO_DISTRIBUTE_COUNT;
-		}
+		/* drive the sound buffer to the target latency with a small rate correction */
+		latency_diff = advance_sound_rate_control(&CONTEXT.sound, latency_median, sample_count);
 
-		if (latency_diff <= -AUDIOVIDEO_NEAR_STEP_COUNT || latency_diff >= AUDIOVIDEO_NEAR_STEP_COUNT) {
-			/* report the big error */
-			log_std(("WARNING:emu:video: audio/video syncronization correction of %d samples. Try increasing the 'sound_latency' option.\n", latency_diff));
-		} else if (latency_diff <= -3 || latency_diff >= 3) {
-			/* report the error, an error of 1,2 samples is the normal condition */
-			log_std(("emu:video: audio/video syncronization correction of %d samples\n", latency_diff));
-		}
+		advance_timeline_sound(&CONTEXT.timeline, advance_timeline_frame(&CONTEXT.timeline), CONTEXT.sound.state.rate_buffered, CONTEXT.sound.state.rate_target, CONTEXT.sound.state.rate_correction);
 	} else {
 		/* adjust without any check on sound distortion */
 		latency_diff = context->state.latency_diff / AUDIOVIDEO_DISTRIBUTE_COUNT;
@@ -1369,20 +1598,32 @@ int osd2_frame(const struct osd_bitmap* game, const struct osd_bitmap* debug, co
 	/* update the global info */
 	video_command(&CONTEXT.video, &CONTEXT.estimate, &CONTEXT.safequit, &CONTEXT.ui, CONTEXT.cfg, led, input, skip_flag, knocker);
 	advance_video_skip(&CONTEXT.video, &CONTEXT.estimate, &CONTEXT.record);
+
+	advance_timeline_begin(&CONTEXT.timeline, advance_timeline_frame(&CONTEXT.timeline), TIMELINE_INPUT);
 	advance_input_update(&CONTEXT.input, &CONTEXT.safequit, CONTEXT.video.state.pause_flag);
+	advance_timeline_end(&CONTEXT.timeline, advance_timeline_frame(&CONTEXT.timeline), TIMELINE_INPUT);
 
 	/* estimate the time */
 	advance_estimate_frame(&CONTEXT.estimate);
-	advance_estimate_mame_end(&CONTEXT.estimate, skip_flag);
+	advance_estimate_mame_end(&CONTEXT.estimate, skip_draw_flag);
 
-	/* prepare the frame */
-	video_frame_prepare(&CONTEXT.video, &CONTEXT.sound, &CONTEXT.estimate, game, debug, debug_palette, debug_palette_size, led, input, sample_buffer, sample_count, sample_recount, skip_flag);
+	/* the benchmark measures only the emulation, the frame is not blitted */
+	if (!context->config.bench_flag) {
+		/* prepare the frame */
+		advance_timeline_begin(&CONTEXT.timeline, advance_timeline_frame(&CONTEXT.timeline), TIMELINE_PREPARE);
+		video_frame_prepare(&CONTEXT.video, &CONTEXT.sound, &CONTEXT.estimate, &CONTEXT.ui, game, debug, debug_palette, debug_palette_size, led, input, sample_buffer, sample_count, sample_recount, skip_flag);
+		advance_timeline_end(&CONTEXT.timeline, advance_timeline_frame(&CONTEXT.timeline), TIMELINE_PREPARE);
 
-	/* update the local info */
-	video_frame_update(&CONTEXT.video, &CONTEXT.sound, &CONTEXT.estimate, &CONTEXT.record, &CONTEXT.ui, &CONTEXT.safequit, game, debug, debug_palette, debug_palette_size, led, input, sample_buffer, sample_count, sample_recount, skip_flag);
+		/* update the local info */
+		video_frame_update(&CONTEXT.video, &CONTEXT.sound, &CONTEXT.estimate, &CONTEXT.record, &CONTEXT.ui, &CONTEXT.safequit, game, debug, debug_palette, debug_palette_size, led, input, sample_buffer, sample_count, sample_recount, skip_flag);
+	}
+
+	/* the next frame starts */
+	advance_timeline_next(&CONTEXT.timeline, context->state.skip_draw_flag);
 
 	/* estimate the time */
 	advance_estimate_mame_begin(&CONTEXT.estimate);
+	advance_timeline_begin(&CONTEXT.timeline, advance_timeline_frame(&CONTEXT.timeline), TIMELINE_EMULATION);
 
 	return latency_diff;
 }
@@ -1487,6 +1728,15 @@ static adv_conf_enum_int OPTION_INTERLACEEFFECT[] = {
 	{ "filter", EFFECT_INTERLACE_FILTER }
 };
 
+static adv_conf_enum_int OPTION_BLITLEVEL[] = {
+	{ "auto", VIDEO_BLIT_LEVEL_AUTO },
+	{ "c", VIDEO_BLIT_LEVEL_C },
+	{ "sse2", VIDEO_BLIT_LEVEL_SSE2 },
+	{ "ssse3", VIDEO_BLIT_LEVEL_SSSE3 },
+	{ "sse41", VIDEO_BLIT_LEVEL_SSE41 },
+	{ "avx2", VIDEO_BLIT_LEVEL_AVX2 }
+};
+
 static adv_conf_enum_int OPTION_INDEX[] = {
 	{ "auto", MODE_FLAGS_INDEX_NONE },
 	{ "palette8", MODE_FLAGS_INDEX_PALETTE8 },
@@ -1506,10 +1756,17 @@ adv_error advance_video_init(struct advance_video_context* context, adv_conf* cf
 	for (i = 0; i < AUDIOVIDEO_MEASURE_MAX; ++i)
 		context->state.av_sync_map[i] = 0;
 	context->state.latency_diff = 0;
+	context->state.sync_spin = 0.0005; /* 500 us */
+	context->state.sync_late_counter = 0;
+	context->state.sync_late_miss = 0;
+	context->state.sync_late_sum = 0;
+	context->state.sync_late_max = 0;
+	advance_ui_frame_init(&context->state.ui_frame);
 
 	conf_bool_register_default(cfg_context, "display_scanlines", 0);
 	conf_bool_register_default(cfg_context, "display_vsync", 1);
 	conf_bool_register_default(cfg_context, "display_buffer", 0);
+	conf_bool_register_default(cfg_context, "display_unchanged", 0);
 	conf_int_register_enum_default(cfg_context, "display_resize", conf_enum(OPTION_RESIZE), STRETCH_FRACTIONAL_XY);
 	conf_int_register_enum_default(cfg_context, "display_magnify", conf_enum(OPTION_MAGNIFY), 0);
 	conf_int_register_default(cfg_context, "display_magnifysize", 640);
@@ -1517,6 +1774,8 @@ adv_error advance_video_init(struct advance_video_context* context, adv_conf* cf
 	conf_string_register_default(cfg_context, "display_skiplines", "auto");
 	conf_string_register_default(cfg_context, "display_skipcolumns", "auto");
 	conf_string_register_default(cfg_context, "display_frameskip", "auto");
+	conf_bool_register_default(cfg_context, "display_frameskippredict", 0);
+	conf_bool_register_default(cfg_context, "display_frameskipblit", 0);
 	conf_bool_register_default(cfg_context, "display_ror", 0);
 	conf_bool_register_default(cfg_context, "display_rol", 0);
 	conf_bool_register_default(cfg_context, "display_flipx", 0);
@@ -1544,7 +1803,10 @@ adv_error advance_video_init(struct advance_video_context* context, adv_conf* cf
 #ifdef USE_SMP
 	/* SMP always enabled by default */
 	conf_bool_register_default(cfg_context, "misc_smp", 1);
+	conf_int_register_limit_default(cfg_context, "misc_smpqueue", 1, THREAD_QUEUE_MAX, 1);
 #endif
+	conf_int_register_enum_default(cfg_context, "misc_blitlevel", conf_enum(OPTION_BLITLEVEL), VIDEO_BLIT_LEVEL_AUTO);
+	conf_bool_register_default(cfg_context, "misc_realtime", 0);
 
 	conf_int_register_enum_default(cfg_context, "sync_resample", conf_enum(OPTION_RESAMPLE), -1);
 
@@ -1741,6 +2003,7 @@ adv_error advance_video_config_load(struct advance_video_context* context, adv_c
 	context->config.scanlines_flag = conf_bool_get_default(cfg_context, "display_scanlines");
 	context->config.vsync_flag = conf_bool_get_default(cfg_context, "display_vsync");
 	context->config.triplebuf_flag = conf_bool_get_default(cfg_context, "display_buffer");
+	context->config.unchanged_flag = conf_bool_get_default(cfg_context, "display_unchanged");
 	context->config.stretch = conf_int_get_default(cfg_context, "display_resize");
 	context->config.magnify_factor = conf_int_get_default(cfg_context, "display_magnify");
 	context->config.magnify_size = conf_int_get_default(cfg_context, "display_magnifysize");
@@ -1858,6 +2121,7 @@ adv_error advance_video_config_load(struct advance_video_context* context, adv_c
 	}
 	context->config.fastest_time = d;
 	context->config.measure_time = conf_int_get_default(cfg_context, "misc_timetorun");
+	context->config.bench_flag = option->bench_flag && context->config.measure_time != 0;
 	context->config.crash_flag = conf_bool_get_default(cfg_context, "debug_crash");
 	context->config.rawsound_flag = conf_bool_get_default(cfg_context, "debug_rawsound");
 
@@ -1882,13 +2146,20 @@ adv_error advance_video_config_load(struct advance_video_context* context, adv_c
 			return -1;
 		}
 	}
+	context->config.frameskip_predict_flag = conf_bool_get_default(cfg_context, "display_frameskippredict");
+	context->config.frameskip_blit_flag = conf_bool_get_default(cfg_context, "display_frameskipblit");
 
 #ifdef USE_SMP
 	context->config.smp_flag = conf_bool_get_default(cfg_context, "misc_smp");
+	context->config.smp_queue = conf_int_get_default(cfg_context, "misc_smpqueue");
 #else
 	context->config.smp_flag = 0;
+	context->config.smp_queue = 1;
 #endif
 
+	context->config.blit_level = conf_int_get_default(cfg_context, "misc_blitlevel");
+	context->config.realtime_flag = conf_bool_get_default(cfg_context, "misc_realtime");
+
 	i = conf_int_get_default(cfg_context, "sync_resample");
 	if (i == -1) {
 		for (i = 0; GAME_RESAMPLE[i] != 0; ++i)
@@ -1966,6 +2237,7 @@ adv_error advance_video_config_load(struct advance_video_context* context, adv_c
 
 void advance_video_done(struct advance_video_context* context)
 {
+	advance_ui_frame_done(&context->state.ui_frame);
 	crtc_container_done(&context->config.crtc_bag);
 }
 
@@ -1976,12 +2248,20 @@ adv_error advance_video_inner_init(struct advance_video_context* context, struct
 		return -1;
 	}
 
+	video_blit_level_set(context->config.blit_level);
+
 	if (video_blit_init() != 0) {
 		adv_video_done();
 		target_err("%s\n", error_get());
 		return -1;
 	}
 
+	/* split the blit in bands running on all the processors */
+	video_blit_band_set(osd_parallelize, thread_max());
+
+	/* write only the rows changed, if requested */
+	video_blit_change_set(context->config.unchanged_flag);
+
 	advance_video_mode_preinit(context, option);
 
 	return 0;
@@ -14,6 +14,7 @@ SOBJS += \
 	$(SOBJ)/lib/conf.o \
 	$(SOBJ)/lib/incstr.o \
 	$(SOBJ)/lib/sounddrv.o \
+	$(SOBJ)/lib/ring.o \
 	$(SOBJ)/lib/device.o \
 	$(SOBJ)/lib/mixer.o \
 	$(SOBJ)/lib/wave.o \
@@ -35,6 +35,7 @@
 #include "portable.h"
 
 #include "ssdl.h"
+#include "ring.h"
 #include "log.h"
 #include "endianrw.h"
 #include "error.h"
@@ -48,6 +49,9 @@
  */
 #define SDL_VOLUME_BASE 32768
 
+/**
+ * Size of the ring buffer in samples.
+ */
 #define FIFO_MAX 32768
 
 struct sdl_option_struct {
@@ -62,11 +66,9 @@ struct soundb_sdl_context {
 
 	SDL_AudioSpec info;
 
-	unsigned fifo_pos;
-	unsigned fifo_mac;
-	adv_sample fifo_map[FIFO_MAX];
+	adv_ring fifo; /**< Samples to play, written by soundb_sdl_play() and read by the SDL callback without locking. */
 
-	adv_bool underflow_flag;
+	volatile adv_bool underflow_flag; /**< Set by the SDL callback, cleared by soundb_sdl_play(). */
 
 	int volume; /**< Volume adjustement. SDL_VOLUME_BASE == full volume. */
 };
@@ -82,25 +84,27 @@ static void soundb_sdl_callback(void *userdata, Uint8 *stream, int len)
 {
 	struct soundb_sdl_context* state = (struct soundb_sdl_context*)userdata;
 	unsigned samples_count;
-	Uint8* samples_buffer;
+	unsigned done;
+	adv_sample* samples_buffer;
 
 	assert(state == &sdl_state);
 
 	samples_count = len / 2;
-	samples_buffer = stream;
-
-	while (samples_count) {
-		if (state->fifo_mac) {
-			le_uint16_write(samples_buffer, state->fifo_map[state->fifo_pos]);
-			state->fifo_pos = (state->fifo_pos + 1) % FIFO_MAX;
-			--state->fifo_mac;
-		} else {
-			le_uint16_write(samples_buffer, state->info.silence);
-			state->underflow_flag = 1; /* signal the underflow */
-		}
+	samples_buffer = (adv_sample*)stream;
+
+	done = ring_read(&state->fifo, samples_buffer, samples_count);
+
+#ifndef USE_LSB
+	{
+		unsigned i;
+		for (i = 0; i < done; ++i)
+			le_uint16_write(samples_buffer + i, samples_buffer[i]);
+	}
+#endif
 
-		samples_buffer += 2;
-		--samples_count;
+	if (done < samples_count) {
+		memset(samples_buffer + done, state->info.silence, (samples_count - done) * 2);
+		state->underflow_flag = 1; /* signal the underflow */
 	}
 }
 
@@ -121,13 +125,14 @@ adv_error soundb_sdl_init(int sound_id, unsigned* rate, adv_bool stereo_flag, do
 	log_std(("sound:sdl device_sdl_samples %u\n", sdl_option.samples));
 
 	sdl_state.underflow_flag = 0;
-	sdl_state.fifo_pos = 0;
-	sdl_state.fifo_mac = 0;
 	sdl_state.volume = SDL_VOLUME_BASE;
 
+	if (ring_init(&sdl_state.fifo, FIFO_MAX) != 0)
+		goto err;
+
 	if (SDL_InitSubSystem(SDL_INIT_AUDIO) != 0) {
 		error_set("Function SDL_InitSubSystem(SDL_INIT_AUDIO) failed, %s.\n", SDL_GetError());
-		goto err;
+		goto err_ring;
 	}
 
 #if SDL_MAJOR_VERSION == 1
@@ -160,6 +165,8 @@ adv_error soundb_sdl_init(int sound_id, unsigned* rate, adv_bool stereo_flag, do
 
 err_quit:
 	SDL_QuitSubSystem(SDL_INIT_AUDIO);
+err_ring:
+	ring_done(&sdl_state.fifo);
 err:
 	return -1;
 }
@@ -172,6 +179,7 @@ void soundb_sdl_done(void)
 		sdl_state.active_flag = 0;
 		SDL_CloseAudio();
 		SDL_QuitSubSystem(SDL_INIT_AUDIO);
+		ring_done(&sdl_state.fifo);
 	}
 }
 
@@ -184,7 +192,7 @@ void soundb_sdl_stop(void)
 
 unsigned soundb_sdl_buffered(void)
 {
-	return sdl_state.fifo_mac / sdl_state.info.channels;
+	return ring_count(&sdl_state.fifo) / sdl_state.info.channels;
 }
 
 void soundb_sdl_volume(double volume)
@@ -200,46 +208,44 @@ void soundb_sdl_volume(double volume)
 
 void soundb_sdl_play(const adv_sample* sample_map, unsigned sample_count)
 {
-	unsigned i;
 	unsigned count = sample_count * sdl_state.info.channels;
 
-	SDL_LockAudio();
-
-	log_debug(("sound:sdl: soundb_sdl_play(count:%d), stored %d\n", sample_count, sdl_state.fifo_mac / sdl_state.info.channels));
+	log_debug(("sound:sdl: soundb_sdl_play(count:%d), stored %d\n", sample_count, ring_count(&sdl_state.fifo) / sdl_state.info.channels));
 
 	if (sdl_state.underflow_flag) {
 		sdl_state.underflow_flag = 0;
 		log_std(("ERROR: sound buffer fifo underflow\n"));
 	}
 
-	if (sdl_state.fifo_mac + count > FIFO_MAX) {
-		sdl_state.fifo_mac = 0;
-		sdl_state.fifo_pos = 0;
-		log_std(("ERROR: sound buffer fifo overflow, reset the buffer\n"));
+	/* the callback may be reading, so the samples that don't fit are dropped */
+	if (count > ring_free(&sdl_state.fifo)) {
+		count = ring_free(&sdl_state.fifo) / sdl_state.info.channels * sdl_state.info.channels;
+		log_std(("ERROR: sound buffer fifo overflow, drop %d samples\n", sample_count - count / sdl_state.info.channels));
 	}
 
-	i = (sdl_state.fifo_pos + sdl_state.fifo_mac) % FIFO_MAX;
-	sdl_state.fifo_mac += count;
-
 	if (sdl_state.volume == SDL_VOLUME_BASE) {
-		while (count) {
-			sdl_state.fifo_map[i] = *sample_map;
-			i = (i + 1) % FIFO_MAX;
-			--count;
-			++sample_map;
-		}
+		ring_write(&sdl_state.fifo, sample_map, count);
 	} else {
+		/* at most two runs, the second one after the wraparound */
 		while (count) {
-			sdl_state.fifo_map[i] = (int)*sample_map * sdl_state.volume / SDL_VOLUME_BASE;
-			i = (i + 1) % FIFO_MAX;
-			--count;
-			++sample_map;
+			unsigned run;
+			unsigned i;
+			adv_sample* dst = ring_write_map(&sdl_state.fifo, &run);
+
+			if (run > count)
+				run = count;
+
+			for (i = 0; i < run; ++i)
+				dst[i] = (int)sample_map[i] * sdl_state.volume / SDL_VOLUME_BASE;
+
+			ring_write_commit(&sdl_state.fifo, run);
+
+			sample_map += run;
+			count -= run;
 		}
 	}
 
-	log_debug(("sound:sdl: soundb_sdl_play() return stored %d\n", sdl_state.fifo_mac / sdl_state.info.channels));
-
-	SDL_UnlockAudio();
+	log_debug(("sound:sdl: soundb_sdl_play() return stored %d\n", ring_count(&sdl_state.fifo) / sdl_state.info.channels));
 }
 
 adv_error soundb_sdl_start(double silence_time)
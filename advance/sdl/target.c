@@ -68,6 +68,11 @@ void target_yield(void)
 {
 }
 
+adv_error target_realtime(void)
+{
+	return -1;
+}
+
 void target_idle(void)
 {
 	SDL_Delay(1);
@@ -87,6 +92,10 @@ target_clock_t target_clock(void)
 	return SDL_GetTicks();
 }
 
+void target_usleep_until(target_clock_t clock)
+{
+}
+
 /***************************************************************************/
 /* Hardware */
 
@@ -109,6 +109,11 @@ void target_yield(void)
 	Sleep(0);
 }
 
+adv_error target_realtime(void)
+{
+	return -1;
+}
+
 void target_idle(void)
 {
 	Sleep(1);
@@ -170,6 +175,10 @@ target_clock_t target_clock(void)
 	return r;
 }
 
+void target_usleep_until(target_clock_t clock)
+{
+}
+
 /***************************************************************************/
 /* Hardware */
 
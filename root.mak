@@ -74,6 +74,9 @@ endif
 ifneq ($(wildcard $(srcdir)/advance/s.mak),)
 include $(srcdir)/advance/s.mak
 endif
+ifneq ($(wildcard $(srcdir)/advance/bench.mak),)
+include $(srcdir)/advance/bench.mak
+endif
 ifneq ($(wildcard $(srcdir)/advance/k.mak),)
 include $(srcdir)/advance/k.mak
 endif
@@ -42,6 +42,7 @@ COREOBJS = \
 	$(OBJ)/memory.o \
 	$(OBJ)/palette.o \
 	$(OBJ)/png.o \
+	$(OBJ)/profiler.o \
 	$(OBJ)/romload.o \
 	$(OBJ)/sha1.o \
 	$(OBJ)/sound.o \
@@ -60,6 +61,7 @@ COREOBJS = \
 	$(OBJ)/sound/filter.o \
 	$(OBJ)/sound/flt_vol.o \
 	$(OBJ)/sound/flt_rc.o \
+	$(OBJ)/sound/resample.o \
 	$(OBJ)/sound/wavwrite.o \
 	$(OBJ)/machine/eeprom.o \
 	$(OBJ)/machine/generic.o \
@@ -81,9 +83,6 @@ endif
 #-------------------------------------------------
 
 ifdef DEBUG
-COREOBJS += \
-	$(OBJ)/profiler.o
-
 ifdef NEW_DEBUGGER
 COREOBJS += \
 	$(OBJ)/debug/debugcmd.o \
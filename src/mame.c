@@ -94,6 +94,9 @@
 
 #define MAX_MEMORY_REGIONS		32
 
+/* frames run without run-ahead after the anonymous timers prevented a restore */
+#define RUNAHEAD_HOLDOFF		60
+
 
 
 /***************************************************************************
@@ -151,6 +154,20 @@ static mame_timer *soft_reset_timer;
 static void (*saveload_schedule_callback)(void);
 static mame_time saveload_schedule_time;
 
+/* run-ahead statics */
+static int runahead_frames;
+static int runahead_phase;
+static int runahead_holdoff;
+
+/* rewind statics */
+static int rewind_enabled;
+static int rewind_hold;
+static int rewind_frame;
+static int rewind_countdown;
+static int rewind_window;
+static cycles_t rewind_cycles;
+static double rewind_time;
+
 /* error recovery and exiting */
 static callback_item *reset_callback_list;
 static callback_item *pause_callback_list;
@@ -246,6 +263,14 @@ static void saveload_init(void);
 static void handle_save(void);
 static void handle_load(void);
 
+static void runahead_init(void);
+static void runahead_execute(void);
+
+static void rewind_init(void);
+static void rewind_done(void);
+static void rewind_record(void);
+static void rewind_execute(void);
+
 
 static void logfile_callback(const char *buffer);
 
@@ -322,6 +347,10 @@ int run_game(int game)
 			/* perform a soft reset -- this takes us to the running phase */
 			soft_reset(0);
 
+			/* check if the run-ahead and the rewind are possible */
+			runahead_init();
+			rewind_init();
+
 			/* run the CPUs until a reset or exit */
 			hard_reset_pending = FALSE;
 			while ((!hard_reset_pending && !exit_pending) || saveload_pending_file != NULL)
@@ -330,7 +359,18 @@ int run_game(int game)
 
 				/* execute CPUs if not paused */
 				if (!mame_paused)
-					cpuexec_timeslice();
+				{
+					if (rewind_enabled && rewind_hold)
+						rewind_execute();
+					else if (runahead_frames > 0)
+						runahead_execute();
+					else
+						cpuexec_timeslice();
+
+					/* record the rewind states at the frame boundaries */
+					if (rewind_enabled)
+						rewind_record();
+				}
 
 				/* otherwise, just pump video updates through */
 				else
@@ -349,6 +389,9 @@ int run_game(int game)
 			/* and out via the exit phase */
 			current_phase = MAME_PHASE_EXIT;
 
+			/* release the rewind states */
+			rewind_done();
+
 			/* stop tracking resources at this level */
 			end_resource_tracking();
 
@@ -583,6 +626,52 @@ int mame_is_paused(void)
 }
 
 
+/*-------------------------------------------------
+    mame_get_runahead_phase - the run-ahead phase
+    of the frame in execution
+-------------------------------------------------*/
+
+int mame_get_runahead_phase(void)
+{
+	return runahead_phase;
+}
+
+
+/*-------------------------------------------------
+    mame_schedule_rewind - rewind the machine at
+    the next frames, until hold is cleared
+-------------------------------------------------*/
+
+void mame_schedule_rewind(int hold)
+{
+	rewind_hold = hold;
+}
+
+
+/*-------------------------------------------------
+    mame_get_rewind_info - return the rewind
+    statistics
+-------------------------------------------------*/
+
+void mame_get_rewind_info(int *frames, UINT32 *memory, double *time)
+{
+	UINT32 count;
+
+	if (!rewind_enabled)
+	{
+		*frames = 0;
+		*memory = 0;
+		*time = 0;
+		return;
+	}
+
+	state_save_rewind_info(&count, memory);
+
+	*frames = count > 1 ? (count - 1) * options.rewind_step : 0;
+	*time = rewind_time;
+}
+
+
 
 /***************************************************************************
 
@@ -1407,3 +1496,329 @@ cancel:
 	saveload_pending_file = NULL;
 	saveload_schedule_callback = NULL;
 }
+
+
+
+/***************************************************************************
+
+    Run-ahead
+
+***************************************************************************/
+
+/*-------------------------------------------------
+    snapshot_save - save the state in the memory
+    snapshot, like handle_save()
+-------------------------------------------------*/
+
+static int snapshot_save(void)
+{
+	int cpunum;
+
+	if (state_save_snapshot_save_begin() != 0)
+		return 1;
+
+	/* save the default tag */
+	state_save_push_tag(0);
+	state_save_snapshot_save_continue();
+	state_save_pop_tag();
+
+	/* loop over CPUs */
+	for (cpunum = 0; cpunum < cpu_gettotalcpu(); cpunum++)
+	{
+		cpuintrf_push_context(cpunum);
+
+		/* make sure banking is set */
+		activecpu_reset_banking();
+
+		/* save the CPU data */
+		state_save_push_tag(cpunum + 1);
+		state_save_snapshot_save_continue();
+		state_save_pop_tag();
+
+		cpuintrf_pop_context();
+	}
+
+	state_save_snapshot_save_finish();
+	return 0;
+}
+
+
+/*-------------------------------------------------
+    snapshot_load - restore the state from the
+    memory snapshot, like handle_load()
+-------------------------------------------------*/
+
+static int snapshot_load(void)
+{
+	int cpunum;
+
+	if (state_save_snapshot_load_begin() != 0)
+		return 1;
+
+	/* restore the default tag */
+	state_save_push_tag(0);
+	state_save_snapshot_load_continue();
+	state_save_pop_tag();
+
+	/* loop over CPUs */
+	for (cpunum = 0; cpunum < cpu_gettotalcpu(); cpunum++)
+	{
+		cpuintrf_push_context(cpunum);
+
+		/* make sure banking is set */
+		activecpu_reset_banking();
+
+		/* restore the CPU data */
+		state_save_push_tag(cpunum + 1);
+		state_save_snapshot_load_continue();
+		state_save_pop_tag();
+
+		/* make sure banking is set */
+		activecpu_reset_banking();
+
+		cpuintrf_pop_context();
+	}
+
+	return 0;
+}
+
+
+/*-------------------------------------------------
+    runahead_init - check if the run-ahead can be
+    used with the running game
+-------------------------------------------------*/
+
+static void runahead_init(void)
+{
+	runahead_frames = options.runahead;
+	runahead_phase = RUNAHEAD_NONE;
+	runahead_holdoff = 0;
+
+	if (runahead_frames <= 0)
+		return;
+
+	/* the frames run ahead are discarded with a state load */
+	if (!(Machine->gamedrv->flags & GAME_SUPPORTS_SAVE))
+	{
+		logerror("Run-ahead disabled, save states are not supported by the game\n");
+		runahead_frames = 0;
+	}
+
+	/* the input recording and the debugger must see only the committed frames */
+	if (options.record || options.playback || options.mame_debug)
+	{
+		logerror("Run-ahead disabled, not compatible with input recording and debugging\n");
+		runahead_frames = 0;
+	}
+
+	if (runahead_frames > 0)
+		logerror("Run-ahead of %d frames\n", runahead_frames);
+}
+
+
+/*-------------------------------------------------
+    runahead_frame - execute the CPUs until the
+    end of the current frame
+-------------------------------------------------*/
+
+static void runahead_frame(int phase)
+{
+	int frame = cpu_getcurrentframe();
+
+	runahead_phase = phase;
+
+	while (cpu_getcurrentframe() == frame)
+		cpuexec_timeslice();
+}
+
+
+/*-------------------------------------------------
+    runahead_execute - execute a frame with the
+    run-ahead; the frame is committed, then the
+    next frames are run with the same input, the
+    last one is shown, and the state is restored
+    at the committed frame
+-------------------------------------------------*/
+
+static void runahead_execute(void)
+{
+	int i;
+
+	/* the game recently used anonymous timers in the frames run ahead */
+	if (runahead_holdoff > 0)
+	{
+		--runahead_holdoff;
+		runahead_frame(RUNAHEAD_NONE);
+		return;
+	}
+
+	/* if the next frame is not shown, or the state cannot be saved, run normally */
+	if (osd_skip_this_frame() || timer_is_anonymous_pending())
+	{
+		runahead_frame(RUNAHEAD_NONE);
+		return;
+	}
+
+	/* run the committed frame, its sound is played but its video is deferred */
+	runahead_frame(RUNAHEAD_COMMIT);
+
+	/* if a save is not possible now, present the committed frame late */
+	if (timer_is_anonymous_pending() || snapshot_save() != 0)
+	{
+		runahead_phase = RUNAHEAD_NONE;
+		updatescreen_present();
+		return;
+	}
+
+	/* run ahead without sound, and show only the last frame */
+	for (i = 1; i < runahead_frames; ++i)
+		runahead_frame(RUNAHEAD_HIDDEN);
+	runahead_frame(RUNAHEAD_PRESENT);
+
+	/* the anonymous timers started in the frames run ahead are not in the */
+	/* snapshot, and they would fire into the restored state; these frames */
+	/* cannot be undone, so they are kept, and the run-ahead is suspended */
+	/* to not advance the game time again while the game uses the timers */
+	if (timer_is_anonymous_pending())
+	{
+		logerror("Run-ahead frames kept due to anonymous timers, run-ahead suspended for %d frames\n", RUNAHEAD_HOLDOFF);
+		runahead_holdoff = RUNAHEAD_HOLDOFF;
+		runahead_phase = RUNAHEAD_NONE;
+		return;
+	}
+
+	/* go back to the committed frame; if a reset happened in the frames */
+	/* run ahead the snapshot is invalid, and these frames are kept */
+	if (snapshot_load() != 0)
+		logerror("Run-ahead frames kept after a reset\n");
+
+	runahead_phase = RUNAHEAD_NONE;
+}
+
+
+/***************************************************************************
+
+    Rewind
+
+***************************************************************************/
+
+/*-------------------------------------------------
+    rewind_init - allocate the rewind ring if
+    requested and possible with the running game
+-------------------------------------------------*/
+
+static void rewind_init(void)
+{
+	rewind_enabled = 0;
+	rewind_hold = 0;
+	rewind_frame = cpu_getcurrentframe();
+	rewind_countdown = 0;
+	rewind_window = 0;
+	rewind_cycles = 0;
+	rewind_time = 0;
+
+	if (options.rewind_size <= 0 || options.rewind_step <= 0)
+		return;
+
+	/* the rewind is a state load */
+	if (!(Machine->gamedrv->flags & GAME_SUPPORTS_SAVE))
+	{
+		logerror("Rewind disabled, save states are not supported by the game\n");
+		return;
+	}
+
+	/* the input recording and the debugger must see only the committed frames */
+	if (options.record || options.playback || options.mame_debug)
+	{
+		logerror("Rewind disabled, not compatible with input recording and debugging\n");
+		return;
+	}
+
+	if (state_save_rewind_init(options.rewind_size) != 0)
+		return;
+
+	logerror("Rewind of %d bytes every %d frames\n", options.rewind_size, options.rewind_step);
+	rewind_enabled = 1;
+}
+
+
+/*-------------------------------------------------
+    rewind_done - free the rewind ring
+-------------------------------------------------*/
+
+static void rewind_done(void)
+{
+	UINT32 count, used;
+
+	if (!rewind_enabled)
+		return;
+
+	state_save_rewind_info(&count, &used);
+	logerror("Rewind ring with %u states in %u bytes\n", count, used);
+
+	state_save_rewind_free();
+	rewind_enabled = 0;
+}
+
+
+/*-------------------------------------------------
+    rewind_record - record a rewind state at the
+    frame boundaries, every rewind step
+-------------------------------------------------*/
+
+static void rewind_record(void)
+{
+	int frame = cpu_getcurrentframe();
+
+	/* only at the frame boundaries */
+	if (frame == rewind_frame)
+		return;
+	rewind_frame = frame;
+
+	/* the anonymous timers are not saved, retry at the next frame */
+	if (--rewind_countdown <= 0 && !timer_is_anonymous_pending())
+	{
+		cycles_t start = osd_cycles();
+
+		if (snapshot_save() == 0)
+			state_save_rewind_push();
+
+		rewind_cycles += osd_cycles() - start;
+		rewind_countdown = options.rewind_step;
+	}
+
+	/* update the time per frame every second */
+	if (++rewind_window >= Machine->refresh_rate)
+	{
+		rewind_time = (double)rewind_cycles / (double)osd_cycles_per_second() / rewind_window;
+		rewind_cycles = 0;
+		rewind_window = 0;
+	}
+}
+
+
+/*-------------------------------------------------
+    rewind_execute - go back of one rewind step,
+    and show the restored frame
+-------------------------------------------------*/
+
+static void rewind_execute(void)
+{
+	/* the anonymous timers are not saved, let them expire before the load */
+	if (timer_is_anonymous_pending())
+	{
+		cpuexec_timeslice();
+		return;
+	}
+
+	/* the oldest state is kept when the ring is exhausted */
+	if (state_save_rewind_pop() == 0 && snapshot_load() == 0)
+	{
+		rewind_frame = cpu_getcurrentframe();
+		rewind_countdown = options.rewind_step;
+	}
+
+	/* show the restored frame, without sound */
+	updatescreen_present();
+	reset_partial_updates();
+}
@@ -31,6 +31,12 @@
 #define MAME_PHASE_RUNNING		3
 #define MAME_PHASE_EXIT			4
 
+/* run-ahead frame phases */
+#define RUNAHEAD_NONE			0	/* normal frame */
+#define RUNAHEAD_COMMIT			1	/* committed frame, sound played but video not shown */
+#define RUNAHEAD_HIDDEN			2	/* frame run ahead, nor played nor shown */
+#define RUNAHEAD_PRESENT		3	/* last frame run ahead, video shown with the committed sound */
+
 
 /* maxima */
 #define MAX_GFX_ELEMENTS		32
@@ -230,6 +236,12 @@ struct _global_options
 
 	const char *controller;	/* controller-specific cfg to load */
 
+	int		runahead;		/* AdvanceMAME: number of frames to run ahead */
+	int		rewind_size;	/* AdvanceMAME: memory used by the rewind, 0 to disable it */
+	int		rewind_step;	/* AdvanceMAME: number of frames between the rewind states */
+	int		sound_smp;		/* AdvanceMAME: generate the independent sound streams in parallel */
+	int		sound_resample;	/* AdvanceMAME: taps of the polyphase resampler, 0 for the linear interpolation */
+
 #ifdef MESS
 	UINT32	ram;
 	struct ImageFile image_files[32];
@@ -308,6 +320,15 @@ void mame_pause(int pause);
 /* get the current pause state */
 int mame_is_paused(void);
 
+/* get the run-ahead phase of the current frame */
+int mame_get_runahead_phase(void);
+
+/* rewind the machine while hold is set */
+void mame_schedule_rewind(int hold);
+
+/* get the rewind statistics, the time span in frames, the memory used and the time per frame */
+void mame_get_rewind_info(int *frames, UINT32 *memory, double *time);
+
 
 
 /* ----- memory region management ----- */
@@ -66,13 +66,23 @@ profiler_mark(PROFILER_END);
 the profiler handles a FILO list so calls may be nested.
 */
 
-#ifdef MAME_DEBUG
+/* AdvanceMAME: the profiler is also built with MAME_PROFILER for the benchmark mode. */
+/* Without MAME_DEBUG a mark costs only a test when the profiler is stopped. */
+#if defined(MAME_DEBUG) || defined(MAME_PROFILER)
+extern int profiler_enabled;
+
 void profiler_mark(int type);
+#ifndef MAME_DEBUG
+#define profiler_mark(type) do { if (profiler_enabled) profiler_mark(type); } while (0)
+#endif
 
 /* functions called by usrintf.c */
 void profiler_start(void);
 void profiler_stop(void);
 const char *profiler_get_text(void);
+
+/* AdvanceMAME: total ticks spent in a section since the start */
+UINT64 profiler_get_ticks(int type);
 #else
 #define profiler_mark(type)
 
@@ -161,6 +161,35 @@ INLINE sound_info *find_sound_by_tag(const char *tag)
 }
 
 
+/*-------------------------------------------------
+    sound_group - AdvanceMAME: return the stream
+    group of a sound chip, the chips of the same
+    type or family may share the emulation code
+    and state, and they are never updated in
+    parallel; a chip without a family shares the
+    group only with the chips of the same type
+-------------------------------------------------*/
+
+INLINE int sound_group(int sndnum)
+{
+	int type = Machine->drv->sound[sndnum].sound_type;
+	const char *family = sndtype_core_family(type);
+	int index;
+
+	for (index = 0; index < sndnum; index++)
+	{
+		int other_type = Machine->drv->sound[index].sound_type;
+		const char *other = sndtype_core_family(other_type);
+		if (other_type == type)
+			break;
+		if (family != NULL && other != NULL && !strcmp(family, other))
+			break;
+	}
+
+	return index + 1;
+}
+
+
 
 /***************************************************************************
 
@@ -320,6 +349,7 @@ static int start_sound_chips(void)
 		VPRINTF(("sndnum = %d -- sound_type = %d\n", sndnum, msound->sound_type));
 		num_regs = state_save_get_reg_count();
 		streams_set_tag(info);
+		streams_set_group(sound_group(sndnum));
 		if (sndintrf_init_sound(sndnum, msound->sound_type, msound->clock, msound->config) != 0)
 			return 1;
 
@@ -453,6 +483,7 @@ static int route_sound(void)
 
 	/* now allocate the mixers and input data */
 	streams_set_tag(NULL);
+	streams_set_group(0);
 	for (spknum = 0; spknum < totalspeakers; spknum++)
 	{
 		speaker_info *info = &speaker[spknum];
@@ -650,9 +681,13 @@ static void sound_save(int config_type, xml_data_node *parentnode)
 void sound_frame_update(void)
 {
 	int sample, spknum;
+	int ahead;
 
 	VPRINTF(("sound_frame_update\n"));
 
+	/* the sound of the frames run ahead is discarded, the OSD keeps the committed one */
+	ahead = mame_get_runahead_phase() == RUNAHEAD_HIDDEN || mame_get_runahead_phase() == RUNAHEAD_PRESENT;
+
 	profiler_mark(PROFILER_SOUND);
 
 	/* reset the mixing streams */
@@ -662,6 +697,19 @@ void sound_frame_update(void)
 	/* if we're not paused, keep the sounds going */
 	if (!mame_is_paused())
 	{
+		/* AdvanceMAME: generate the independent streams in parallel */
+		if (options.sound_smp)
+		{
+			sound_stream *sink[MAX_SPEAKER];
+			int sinks = 0;
+
+			for (spknum = 0; spknum < totalspeakers; spknum++)
+				if (speaker[spknum].mixer_stream)
+					sink[sinks++] = speaker[spknum].mixer_stream;
+
+			streams_frame_generate(sink, sinks, samples_this_frame);
+		}
+
 		/* force all the speaker streams to generate the proper number of samples */
 		for (spknum = 0; spknum < totalspeakers; spknum++)
 		{
@@ -688,7 +736,7 @@ void sound_frame_update(void)
 #endif
 
 				/* mix if sound is enabled */
-				if (global_sound_enabled && !nosound_mode)
+				if (global_sound_enabled && !nosound_mode && !ahead)
 				{
 					/* if the speaker is centered, send to both left and right */
 					if (spk->speaker->x == 0)
@@ -712,33 +760,37 @@ void sound_frame_update(void)
 		}
 	}
 
-	/* now downmix the final result */
-	for (sample = 0; sample < samples_this_frame; sample++)
+	/* the final mix of the committed frame is still in use by the OSD */
+	if (!ahead)
 	{
-		INT32 samp;
-
-		/* clamp the left side */
-		samp = leftmix[sample];
-		if (samp < -32768)
-			samp = -32768;
-		else if (samp > 32767)
-			samp = 32767;
-		finalmix[sample*2+0] = samp;
-
-		/* clamp the right side */
-		samp = rightmix[sample];
-		if (samp < -32768)
-			samp = -32768;
-		else if (samp > 32767)
-			samp = 32767;
-		finalmix[sample*2+1] = samp;
-	}
+		/* now downmix the final result */
+		for (sample = 0; sample < samples_this_frame; sample++)
+		{
+			INT32 samp;
+
+			/* clamp the left side */
+			samp = leftmix[sample];
+			if (samp < -32768)
+				samp = -32768;
+			else if (samp > 32767)
+				samp = 32767;
+			finalmix[sample*2+0] = samp;
+
+			/* clamp the right side */
+			samp = rightmix[sample];
+			if (samp < -32768)
+				samp = -32768;
+			else if (samp > 32767)
+				samp = 32767;
+			finalmix[sample*2+1] = samp;
+		}
 
-	if (wavfile && !mame_is_paused())
-		wav_add_data_16(wavfile, finalmix, samples_this_frame * 2);
+		if (wavfile && !mame_is_paused())
+			wav_add_data_16(wavfile, finalmix, samples_this_frame * 2);
 
-	/* play the result */
-	samples_this_frame = osd_update_audio_stream(finalmix);
+		/* play the result */
+		samples_this_frame = osd_update_audio_stream(finalmix);
+	}
 
 	/* update the streamer */
 	streams_frame_update();
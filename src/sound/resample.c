@@ -0,0 +1,391 @@
+/***************************************************************************
+
+    resample.c
+
+    Sample rate conversion of the sound streams
+
+***************************************************************************/
+
+#include "resample.h"
+
+#include <stdlib.h>
+#include <math.h>
+
+#if defined(USE_ASM_INTRINSIC)
+#include <immintrin.h>
+#include <cpuid.h>
+#define RESAMPLE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* Fraction of the Nyquist frequency kept by the filter */
+#define RESAMPLE_ROLLOFF 0.90
+
+static int resample_level_force = RESAMPLE_LEVEL_AUTO;
+
+/***************************************************************************/
+/* Cpu */
+
+#if defined(USE_ASM_INTRINSIC)
+
+static unsigned resample_cpu_level(void)
+{
+	unsigned a, b, c, d;
+	unsigned lo, hi;
+
+	/* SSE2 is always present in x86-64 */
+	if (__get_cpuid_max(0, 0) < 7)
+		return RESAMPLE_LEVEL_SSE2;
+
+	/* OSXSAVE and AVX */
+	__cpuid_count(1, 0, a, b, c, d);
+	if ((c & 0x18000000) != 0x18000000)
+		return RESAMPLE_LEVEL_SSE2;
+
+	/* the OS must save the XMM and YMM registers */
+	__asm__ __volatile__ ("xgetbv" : "=a" (lo), "=d" (hi) : "c" (0));
+	if ((lo & 0x6) != 0x6)
+		return RESAMPLE_LEVEL_SSE2;
+
+	/* AVX2 */
+	__cpuid_count(7, 0, a, b, c, d);
+	if ((b & 0x20) == 0)
+		return RESAMPLE_LEVEL_SSE2;
+
+	return RESAMPLE_LEVEL_AVX2;
+}
+
+#else
+
+static unsigned resample_cpu_level(void)
+{
+	return RESAMPLE_LEVEL_C;
+}
+
+#endif
+
+void resample_level_set(int level)
+{
+	resample_level_force = level;
+}
+
+const char* resample_level_name(unsigned level)
+{
+	switch (level) {
+	case RESAMPLE_LEVEL_SSE2 : return "sse2";
+	case RESAMPLE_LEVEL_AVX2 : return "avx2";
+	}
+	return "c";
+}
+
+/***************************************************************************/
+/* Kernels */
+
+static int resample_round(float acc)
+{
+	if (acc >= 0)
+		return (int)(acc + 0.5f);
+	else
+		return -(int)(0.5f - acc);
+}
+
+static const float* resample_row(const resample* r, unsigned pos)
+{
+	unsigned phase = ((pos & RESAMPLE_FRAC_MASK) + (1 << (RESAMPLE_FRAC_BITS - RESAMPLE_PHASE_BITS - 1))) >> (RESAMPLE_FRAC_BITS - RESAMPLE_PHASE_BITS);
+
+	return r->coeff + phase * r->width;
+}
+
+static unsigned resample_poly_def(const resample* r, int* dest, const int* source, unsigned pos, int gain, int samples)
+{
+	unsigned width = r->width;
+	unsigned step = r->step;
+
+	while (samples--) {
+		const int* x = source + (pos >> RESAMPLE_FRAC_BITS) + 2 - width;
+		const float* c = resample_row(r, pos);
+		float acc = 0;
+		unsigned j;
+
+		for (j = 0; j < width; ++j)
+			acc += x[j] * c[j];
+
+		*dest++ = (resample_round(acc) * gain) >> 8;
+		pos += step;
+	}
+
+	return pos;
+}
+
+#if defined(USE_ASM_INTRINSIC)
+
+static unsigned resample_poly_sse2(const resample* r, int* dest, const int* source, unsigned pos, int gain, int samples)
+{
+	unsigned width = r->width;
+	unsigned step = r->step;
+
+	while (samples--) {
+		const int* x = source + (pos >> RESAMPLE_FRAC_BITS) + 2 - width;
+		const float* c = resample_row(r, pos);
+		__m128 acc0 = _mm_setzero_ps();
+		__m128 acc1 = _mm_setzero_ps();
+		unsigned j;
+
+		for (j = 0; j < width; j += 8) {
+			__m128 x0 = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)(x + j)));
+			__m128 x1 = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)(x + j + 4)));
+			acc0 = _mm_add_ps(acc0, _mm_mul_ps(x0, _mm_load_ps(c + j)));
+			acc1 = _mm_add_ps(acc1, _mm_mul_ps(x1, _mm_load_ps(c + j + 4)));
+		}
+
+		acc0 = _mm_add_ps(acc0, acc1);
+		acc0 = _mm_add_ps(acc0, _mm_movehl_ps(acc0, acc0));
+		acc0 = _mm_add_ss(acc0, _mm_shuffle_ps(acc0, acc0, 0x55));
+
+		*dest++ = (resample_round(_mm_cvtss_f32(acc0)) * gain) >> 8;
+		pos += step;
+	}
+
+	return pos;
+}
+
+static RESAMPLE_TARGET_AVX2 unsigned resample_poly_avx2(const resample* r, int* dest, const int* source, unsigned pos, int gain, int samples)
+{
+	unsigned width = r->width;
+	unsigned step = r->step;
+
+	while (samples--) {
+		const int* x = source + (pos >> RESAMPLE_FRAC_BITS) + 2 - width;
+		const float* c = resample_row(r, pos);
+		__m256 acc0 = _mm256_setzero_ps();
+		__m256 acc1 = _mm256_setzero_ps();
+		__m128 sum;
+		unsigned j;
+
+		for (j = 0; j + 16 <= width; j += 16) {
+			__m256 x0 = _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i*)(x + j)));
+			__m256 x1 = _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i*)(x + j + 8)));
+			acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(x0, _mm256_load_ps(c + j)));
+			acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(x1, _mm256_load_ps(c + j + 8)));
+		}
+
+		/* the width is a multiple of 8 */
+		if (j < width) {
+			__m256 x0 = _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i*)(x + j)));
+			acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(x0, _mm256_load_ps(c + j)));
+		}
+
+		acc0 = _mm256_add_ps(acc0, acc1);
+		sum = _mm_add_ps(_mm256_castps256_ps128(acc0), _mm256_extractf128_ps(acc0, 1));
+		sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+		sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 0x55));
+
+		*dest++ = (resample_round(_mm_cvtss_f32(sum)) * gain) >> 8;
+		pos += step;
+	}
+
+	return pos;
+}
+
+#endif
+
+/* Filter reading before the start of the source, only at the start of the stream */
+static unsigned resample_poly_head(const resample* r, int* dest, const int* source, unsigned pos, int gain, int samples)
+{
+	unsigned width = r->width;
+	unsigned step = r->step;
+
+	while (samples--) {
+		int base = (int)(pos >> RESAMPLE_FRAC_BITS) + 2 - (int)width;
+		const float* c = resample_row(r, pos);
+		float acc = 0;
+		unsigned j;
+
+		for (j = 0; j < width; ++j)
+			if (base + (int)j >= 0)
+				acc += source[base + j] * c[j];
+
+		*dest++ = (resample_round(acc) * gain) >> 8;
+		pos += step;
+	}
+
+	return pos;
+}
+
+unsigned resample_poly(const resample* r, int* dest, const int* source, unsigned pos, int gain, int samples)
+{
+	/* samples without enough history */
+	while (samples > 0 && (pos >> RESAMPLE_FRAC_BITS) + 2 < r->width) {
+		pos = resample_poly_head(r, dest++, source, pos, gain, 1);
+		--samples;
+	}
+
+	return r->kernel(r, dest, source, pos, gain, samples);
+}
+
+/***************************************************************************/
+/* Filter */
+
+static double resample_sinc(double x)
+{
+	if (fabs(x) < 1E-9)
+		return 1;
+	return sin(M_PI * x) / (M_PI * x);
+}
+
+/* Blackman window in [-1,1] */
+static double resample_window(double x)
+{
+	return 0.42 + 0.5 * cos(M_PI * x) + 0.08 * cos(2 * M_PI * x);
+}
+
+resample* resample_alloc(unsigned step, unsigned taps)
+{
+	resample* r;
+	double ratio = step / (double)RESAMPLE_FRAC_ONE;
+	double cutoff;
+	double half;
+	unsigned width;
+	unsigned level;
+	unsigned i, j;
+
+	/* when decimating, the filter has to be longer to keep the same quality */
+	if (ratio > 1) {
+		width = (unsigned)ceil(taps * ratio);
+		cutoff = RESAMPLE_ROLLOFF / ratio;
+	} else {
+		width = taps;
+		cutoff = RESAMPLE_ROLLOFF;
+	}
+
+	width = (width + 7) & ~7U;
+	if (width < 8)
+		width = 8;
+	if (width > RESAMPLE_WIDTH_MAX)
+		width = RESAMPLE_WIDTH_MAX;
+
+	r = malloc(sizeof(resample));
+	if (!r)
+		return 0;
+
+	r->coeff_raw = malloc(RESAMPLE_PHASE_MAX * width * sizeof(float) + 32);
+	if (!r->coeff_raw) {
+		free(r);
+		return 0;
+	}
+
+	r->coeff = (float*)(((size_t)r->coeff_raw + 31) & ~(size_t)31);
+	r->step = step;
+	r->taps = taps;
+	r->width = width;
+
+	/* the filter of the source sample j at the fractional position f is centered in j + 1 - width/2 - f */
+	half = width / 2;
+	for (i = 0; i < RESAMPLE_PHASE_MAX; ++i) {
+		float* row = r->coeff + i * width;
+		double f = i / (double)(RESAMPLE_PHASE_MAX - 1);
+		double sum = 0;
+
+		for (j = 0; j < width; ++j) {
+			double x = j + 1 - half - f;
+			double v = 0;
+			if (fabs(x) < half)
+				v = cutoff * resample_sinc(cutoff * x) * resample_window(x / half);
+			row[j] = v;
+			sum += v;
+		}
+
+		/* unity gain at DC for every phase */
+		for (j = 0; j < width; ++j)
+			row[j] /= sum;
+	}
+
+	level = resample_cpu_level();
+	if (resample_level_force >= 0 && resample_level_force < (int)level)
+		level = resample_level_force;
+
+	r->level = level;
+	switch (level) {
+#if defined(USE_ASM_INTRINSIC)
+	case RESAMPLE_LEVEL_AVX2 : r->kernel = resample_poly_avx2; break;
+	case RESAMPLE_LEVEL_SSE2 : r->kernel = resample_poly_sse2; break;
+#endif
+	default : r->kernel = resample_poly_def; break;
+	}
+
+	return r;
+}
+
+void resample_free(resample* r)
+{
+	free(r->coeff_raw);
+	free(r);
+}
+
+/***************************************************************************/
+/* Linear */
+
+unsigned resample_linear(int* dest, const int* source, unsigned pos, unsigned step, int gain, int samples)
+{
+	int sample;
+
+	/* perfectly matching */
+	if (step == RESAMPLE_FRAC_ONE)
+	{
+		while (samples--)
+		{
+			/* compute the sample */
+			sample = source[pos >> RESAMPLE_FRAC_BITS];
+			*dest++ = (sample * gain) >> 8;
+			pos += RESAMPLE_FRAC_ONE;
+		}
+	}
+
+	/* input is undersampled: use linear interpolation */
+	else if (step < RESAMPLE_FRAC_ONE)
+	{
+		while (samples--)
+		{
+			/* compute the sample */
+			sample  = source[(pos >> RESAMPLE_FRAC_BITS) + 0] * (RESAMPLE_FRAC_ONE - (pos & RESAMPLE_FRAC_MASK));
+			sample += source[(pos >> RESAMPLE_FRAC_BITS) + 1] * (pos & RESAMPLE_FRAC_MASK);
+			sample >>= RESAMPLE_FRAC_BITS;
+			*dest++ = (sample * gain) >> 8;
+			pos += step;
+		}
+	}
+
+	/* input is oversampled: sum the energy */
+	else
+	{
+		/* use 8 bits to allow some extra headroom */
+		int smallstep = step >> (RESAMPLE_FRAC_BITS - 8);
+
+		while (samples--)
+		{
+			int tpos = pos >> RESAMPLE_FRAC_BITS;
+			int remainder = smallstep;
+			int scale;
+
+			/* compute the sample */
+			scale = (RESAMPLE_FRAC_ONE - (pos & RESAMPLE_FRAC_MASK)) >> (RESAMPLE_FRAC_BITS - 8);
+			sample = source[tpos++] * scale;
+			remainder -= scale;
+			while (remainder > 0x100)
+			{
+				sample += source[tpos++] * 0x100;
+				remainder -= 0x100;
+			}
+			sample += source[tpos] * remainder;
+			sample /= smallstep;
+
+			*dest++ = (sample * gain) >> 8;
+			pos += step;
+		}
+	}
+
+	return pos;
+}
@@ -0,0 +1,59 @@
+#ifndef __RESAMPLE_H
+#define __RESAMPLE_H
+
+/* Fixed point of the source position, the same of the streams */
+#define RESAMPLE_FRAC_BITS 14
+#define RESAMPLE_FRAC_ONE (1 << RESAMPLE_FRAC_BITS)
+#define RESAMPLE_FRAC_MASK (RESAMPLE_FRAC_ONE - 1)
+
+/* Number of phases of the polyphase filter */
+#define RESAMPLE_PHASE_BITS 8
+#define RESAMPLE_PHASE_MAX ((1 << RESAMPLE_PHASE_BITS) + 1)
+
+/* Max length of the filter in source samples */
+#define RESAMPLE_WIDTH_MAX 512
+
+/* Instruction set levels */
+#define RESAMPLE_LEVEL_AUTO -1
+#define RESAMPLE_LEVEL_C 0
+#define RESAMPLE_LEVEL_SSE2 1
+#define RESAMPLE_LEVEL_AVX2 2
+#define RESAMPLE_LEVEL_MAX 3
+
+struct resample_struct;
+
+typedef unsigned (*resample_kernel)(const struct resample_struct* r, int* dest, const int* source, unsigned pos, int gain, int samples);
+
+/*
+ * Windowed-sinc polyphase filter for a fixed step.
+ * The filter of every output sample reads the source samples from
+ * pos + 2 - width to pos + 1, so it needs only one sample over the
+ * position, like the linear interpolation, and the history before it.
+ */
+typedef struct resample_struct {
+	unsigned step; /* source step in RESAMPLE_FRAC_BITS fixed point */
+	unsigned taps; /* requested quality */
+	unsigned width; /* length of the filter in source samples, multiple of 8 */
+	unsigned level; /* instruction set level used */
+	float* coeff; /* RESAMPLE_PHASE_MAX rows of width coefficients, 32 bytes aligned */
+	void* coeff_raw;
+	resample_kernel kernel;
+} resample;
+
+/* Force the instruction set level of the next allocated filters */
+void resample_level_set(int level);
+
+/* Get the name of an instruction set level */
+const char* resample_level_name(unsigned level);
+
+/* Allocate a filter with the specified quality */
+resample* resample_alloc(unsigned step, unsigned taps);
+void resample_free(resample* r);
+
+/* Resample with the polyphase filter, return the new position */
+unsigned resample_poly(const resample* r, int* dest, const int* source, unsigned pos, int gain, int samples);
+
+/* Resample with linear interpolation or box sum, return the new position */
+unsigned resample_linear(int* dest, const int* source, unsigned pos, unsigned step, int gain, int samples);
+
+#endif
@@ -47,6 +47,9 @@
 
 #define TAG_STACK_SIZE		4
 
+#define REWIND_ENTRY_MAX	65536		/* maximum number of states in the rewind ring */
+#define REWIND_ZERO_RUN		4			/* minimum run of equal bytes that ends a literal */
+
 /* Available flags */
 enum
 {
@@ -80,6 +83,24 @@ struct _ss_entry
 };
 
 
+typedef struct _ss_block ss_block;
+struct _ss_block
+{
+	UINT8 *			data;				/* pointer to the memory to save/restore */
+	UINT32			size;				/* size in bytes */
+	UINT32			offset;				/* offset within the memory snapshot */
+	int				tag;				/* saving tag */
+};
+
+
+typedef struct _ss_rewind ss_rewind;
+struct _ss_rewind
+{
+	UINT32			offset;				/* offset within the rewind ring */
+	UINT32			size;				/* size of the delta in bytes */
+};
+
+
 typedef struct _ss_func ss_func;
 struct _ss_func
 {
@@ -120,6 +141,27 @@ static UINT8 *ss_dump_array;
 static mame_file *ss_dump_file;
 static UINT32 ss_dump_size;
 
+static ss_block *ss_block_list;
+static UINT32 ss_block_count;
+static UINT8 ss_block_valid;
+
+static UINT8 *ss_snapshot_array;
+static UINT32 ss_snapshot_size;
+static UINT8 ss_snapshot_valid;
+
+static UINT8 *ss_rewind_ring;
+static UINT32 ss_rewind_ring_size;
+static UINT32 ss_rewind_head;
+static ss_rewind *ss_rewind_list;
+static UINT32 ss_rewind_first;
+static UINT32 ss_rewind_count;
+static UINT32 ss_rewind_used;
+static UINT8 *ss_rewind_last;
+static UINT8 *ss_rewind_delta;
+static UINT32 ss_rewind_size;
+static UINT8 ss_rewind_valid;
+static UINT8 ss_rewind_fresh;
+
 #ifdef MESS
 static const char ss_magic_num[8] = { 'M', 'E', 'S', 'S', 'S', 'A', 'V', 'E' };
 #else
@@ -296,6 +338,10 @@ void state_save_register_memory(const char *module, UINT32 instance, const char
 	(*entry)->typecount = valcount;
 	(*entry)->tag       = ss_current_tag;
 	(*entry)->restag    = get_resource_tag();
+
+	/* the memory snapshot refers to the old layout */
+	ss_block_valid = 0;
+	ss_snapshot_valid = 0;
 }
 
 
@@ -534,9 +580,23 @@ void state_save_free(void)
 	func_free(&ss_prefunc_reg);
 	func_free(&ss_postfunc_reg);
 
+	/* the memory snapshot refers to the old layout */
+	ss_block_valid = 0;
+	ss_snapshot_valid = 0;
+
 	/* if we're clear of all registrations, reset the invalid counter */
 	if (ss_registry == NULL && ss_prefunc_reg == NULL && ss_postfunc_reg == NULL)
+	{
 		ss_illegal_regs = 0;
+
+		/* and release the memory snapshot */
+		free(ss_block_list);
+		ss_block_list = NULL;
+		ss_block_count = 0;
+		free(ss_snapshot_array);
+		ss_snapshot_array = NULL;
+		ss_snapshot_size = 0;
+	}
 }
 
 
@@ -955,6 +1015,531 @@ void state_save_load_finish(void)
 
 
 
+/***************************************************************************
+
+    Memory snapshot processing
+
+***************************************************************************/
+
+/*-------------------------------------------------
+    block_compare - qsort compare function for
+    the memory blocks, by tag and by address
+-------------------------------------------------*/
+
+static int CLIB_DECL block_compare(const void *e1, const void *e2)
+{
+	const ss_block *b1 = e1;
+	const ss_block *b2 = e2;
+
+	if (b1->tag != b2->tag)
+		return b1->tag < b2->tag ? -1 : 1;
+	if (b1->data != b2->data)
+		return (FPTR)b1->data < (FPTR)b2->data ? -1 : 1;
+	return 0;
+}
+
+
+/*-------------------------------------------------
+    build_block_list - flatten the registry in a
+    list of memory blocks sorted by address, with
+    the adjacent and overlapping entries merged,
+    and preallocate the memory snapshot
+-------------------------------------------------*/
+
+static int build_block_list(void)
+{
+	ss_entry *entry;
+	ss_block *list;
+	UINT32 count, merged, offset, i;
+
+	/* count the entries */
+	count = 0;
+	for (entry = ss_registry; entry; entry = entry->next)
+		count++;
+
+	list = malloc((count ? count : 1) * sizeof(*list));
+	if (!list)
+	{
+		logerror("malloc failed in build_block_list\n");
+		return 1;
+	}
+
+	/* copy the entries and sort them */
+	count = 0;
+	for (entry = ss_registry; entry; entry = entry->next)
+		if (entry->typecount != 0)
+		{
+			list[count].data = entry->data;
+			list[count].size = entry->typesize * entry->typecount;
+			list[count].tag = entry->tag;
+			count++;
+		}
+	qsort(list, count, sizeof(list[0]), block_compare);
+
+	/* merge the blocks that touch or overlap in the same tag */
+	merged = 0;
+	for (i = 0; i < count; i++)
+	{
+		ss_block *last = merged ? &list[merged - 1] : NULL;
+
+		if (last && last->tag == list[i].tag && (FPTR)list[i].data <= (FPTR)last->data + last->size)
+		{
+			UINT32 size = list[i].data + list[i].size - last->data;
+			if (size > last->size)
+				last->size = size;
+		}
+		else
+			list[merged++] = list[i];
+	}
+
+	/* assign the offsets in the snapshot */
+	offset = 0;
+	for (i = 0; i < merged; i++)
+	{
+		list[i].offset = offset;
+		offset += list[i].size;
+	}
+
+	/* grow the snapshot if required, it's never shrunk */
+	if (offset > ss_snapshot_size)
+	{
+		UINT8 *array = realloc(ss_snapshot_array, offset);
+		if (!array)
+		{
+			logerror("realloc failed in build_block_list\n");
+			free(list);
+			return 1;
+		}
+		ss_snapshot_array = array;
+		ss_snapshot_size = offset;
+	}
+
+	free(ss_block_list);
+	ss_block_list = list;
+	ss_block_count = merged;
+	ss_block_valid = 1;
+
+	/* the recorded deltas refer to the old layout */
+	ss_rewind_count = 0;
+	ss_rewind_used = 0;
+	ss_rewind_valid = 0;
+	ss_rewind_fresh = 0;
+
+	logerror("Memory snapshot of %u bytes in %u blocks from %u entries\n", offset, merged, count);
+	return 0;
+}
+
+
+/*-------------------------------------------------
+    state_save_snapshot_save_begin - begin the
+    process of saving a snapshot in memory; the
+    block list and the buffer are built once and
+    kept until the registry changes
+-------------------------------------------------*/
+
+int state_save_snapshot_save_begin(void)
+{
+	/* if we have illegal registrations, return an error */
+	if (ss_illegal_regs > 0)
+		return 1;
+
+	if (!ss_block_valid && build_block_list() != 0)
+		return 1;
+
+	ss_snapshot_valid = 0;
+	return 0;
+}
+
+
+/*-------------------------------------------------
+    state_save_snapshot_save_continue - save the
+    current tag in the memory snapshot
+-------------------------------------------------*/
+
+void state_save_snapshot_save_continue(void)
+{
+	ss_block *block = ss_block_list;
+	ss_block *end = ss_block_list + ss_block_count;
+
+	/* call the pre-save functions */
+	call_hook_functions(ss_prefunc_reg);
+
+	/* skip to the blocks of the current tag */
+	while (block < end && block->tag < ss_current_tag)
+		block++;
+
+	/* then copy in all of them */
+	for (; block < end && block->tag == ss_current_tag; block++)
+		memcpy(ss_snapshot_array + block->offset, block->data, block->size);
+}
+
+
+/*-------------------------------------------------
+    state_save_snapshot_save_finish - mark the
+    memory snapshot as complete
+-------------------------------------------------*/
+
+void state_save_snapshot_save_finish(void)
+{
+	ss_snapshot_valid = 1;
+}
+
+
+/*-------------------------------------------------
+    state_save_snapshot_load_begin - begin the
+    process of restoring the memory snapshot
+-------------------------------------------------*/
+
+int state_save_snapshot_load_begin(void)
+{
+	/* any change in the registry invalidates the snapshot */
+	if (!ss_snapshot_valid)
+		return 1;
+
+	return 0;
+}
+
+
+/*-------------------------------------------------
+    state_save_snapshot_load_continue - restore
+    the current tag from the memory snapshot
+-------------------------------------------------*/
+
+void state_save_snapshot_load_continue(void)
+{
+	ss_block *block = ss_block_list;
+	ss_block *end = ss_block_list + ss_block_count;
+
+	/* skip to the blocks of the current tag */
+	while (block < end && block->tag < ss_current_tag)
+		block++;
+
+	/* copy back all of them, always in the native endianness */
+	for (; block < end && block->tag == ss_current_tag; block++)
+		memcpy(block->data, ss_snapshot_array + block->offset, block->size);
+
+	/* call the post-load functions */
+	call_hook_functions(ss_postfunc_reg);
+}
+
+
+
+/***************************************************************************
+
+    Rewind processing
+
+***************************************************************************/
+
+/*-------------------------------------------------
+    rewind_put_count - store a variable length
+    count
+-------------------------------------------------*/
+
+static UINT8 *rewind_put_count(UINT8 *dst, UINT32 count)
+{
+	while (count >= 0x80)
+	{
+		*dst++ = (count & 0x7f) | 0x80;
+		count >>= 7;
+	}
+	*dst++ = count;
+	return dst;
+}
+
+
+/*-------------------------------------------------
+    rewind_get_count - read a variable length
+    count
+-------------------------------------------------*/
+
+static const UINT8 *rewind_get_count(const UINT8 *src, UINT32 *count)
+{
+	UINT32 value = 0;
+	int shift = 0;
+
+	while (*src & 0x80)
+	{
+		value |= (*src++ & 0x7f) << shift;
+		shift += 7;
+	}
+	value |= *src++ << shift;
+
+	*count = value;
+	return src;
+}
+
+
+/*-------------------------------------------------
+    rewind_encode - encode the XOR of two states
+    as a sequence of runs of equal bytes, each
+    one followed by a literal of XOR bytes
+-------------------------------------------------*/
+
+static UINT32 rewind_encode(UINT8 *dst, const UINT8 *cur, const UINT8 *prev, UINT32 size)
+{
+	UINT8 *start = dst;
+	UINT32 i = 0;
+
+	while (i < size)
+	{
+		UINT32 equal, literal, j;
+
+		/* skip the equal bytes */
+		equal = i;
+		while (i < size && cur[i] == prev[i])
+			i++;
+		equal = i - equal;
+
+		/* nothing more to store */
+		if (i == size)
+			break;
+
+		/* extend the literal until a long enough run of equal bytes */
+		literal = i;
+		while (i < size)
+		{
+			if (cur[i] != prev[i])
+			{
+				i++;
+				continue;
+			}
+
+			for (j = i; j < size && j < i + REWIND_ZERO_RUN && cur[j] == prev[j]; j++)
+				;
+			if (j == size || j == i + REWIND_ZERO_RUN)
+				break;
+			i = j;
+		}
+		literal = i - literal;
+
+		dst = rewind_put_count(dst, equal);
+		dst = rewind_put_count(dst, literal);
+		for (j = i - literal; j < i; j++)
+			*dst++ = cur[j] ^ prev[j];
+	}
+
+	return dst - start;
+}
+
+
+/*-------------------------------------------------
+    rewind_decode - apply an encoded XOR to a
+    state, getting the other one
+-------------------------------------------------*/
+
+static void rewind_decode(UINT8 *state, const UINT8 *src, UINT32 size)
+{
+	const UINT8 *end = src + size;
+
+	while (src < end)
+	{
+		UINT32 equal, literal;
+
+		src = rewind_get_count(src, &equal);
+		src = rewind_get_count(src, &literal);
+
+		state += equal;
+		while (literal--)
+			*state++ ^= *src++;
+	}
+}
+
+
+/*-------------------------------------------------
+    rewind_drop_oldest - remove the oldest delta
+    from the rewind ring
+-------------------------------------------------*/
+
+static void rewind_drop_oldest(void)
+{
+	ss_rewind_used -= ss_rewind_list[ss_rewind_first].size;
+	ss_rewind_first = (ss_rewind_first + 1) % REWIND_ENTRY_MAX;
+	ss_rewind_count--;
+}
+
+
+/*-------------------------------------------------
+    state_save_rewind_init - allocate the rewind
+    ring
+-------------------------------------------------*/
+
+int state_save_rewind_init(UINT32 size)
+{
+	ss_rewind_ring = malloc(size);
+	ss_rewind_list = malloc(REWIND_ENTRY_MAX * sizeof(*ss_rewind_list));
+	if (!ss_rewind_ring || !ss_rewind_list)
+	{
+		logerror("malloc failed in state_save_rewind_init\n");
+		state_save_rewind_free();
+		return 1;
+	}
+
+	ss_rewind_ring_size = size;
+	ss_rewind_head = 0;
+	ss_rewind_first = 0;
+	ss_rewind_count = 0;
+	ss_rewind_used = 0;
+	ss_rewind_valid = 0;
+	ss_rewind_fresh = 0;
+	return 0;
+}
+
+
+/*-------------------------------------------------
+    state_save_rewind_free - free the rewind ring
+-------------------------------------------------*/
+
+void state_save_rewind_free(void)
+{
+	free(ss_rewind_ring);
+	ss_rewind_ring = NULL;
+	ss_rewind_ring_size = 0;
+	free(ss_rewind_list);
+	ss_rewind_list = NULL;
+	free(ss_rewind_last);
+	ss_rewind_last = NULL;
+	free(ss_rewind_delta);
+	ss_rewind_delta = NULL;
+	ss_rewind_size = 0;
+	ss_rewind_count = 0;
+	ss_rewind_used = 0;
+	ss_rewind_valid = 0;
+	ss_rewind_fresh = 0;
+}
+
+
+/*-------------------------------------------------
+    state_save_rewind_push - record the memory
+    snapshot in the rewind ring, as a delta from
+    the previous recorded state
+-------------------------------------------------*/
+
+int state_save_rewind_push(void)
+{
+	UINT32 size, pos;
+
+	if (!ss_rewind_ring || !ss_snapshot_valid)
+		return 1;
+
+	/* resize the last state if the layout changed */
+	if (ss_rewind_size != ss_snapshot_size)
+	{
+		UINT8 *last = realloc(ss_rewind_last, ss_snapshot_size);
+		UINT8 *delta = realloc(ss_rewind_delta, ss_snapshot_size + ss_snapshot_size / 2 + 16);
+		if (last)
+			ss_rewind_last = last;
+		if (delta)
+			ss_rewind_delta = delta;
+		if (!last || !delta)
+		{
+			logerror("realloc failed in state_save_rewind_push\n");
+			return 1;
+		}
+		ss_rewind_size = ss_snapshot_size;
+		ss_rewind_count = 0;
+		ss_rewind_used = 0;
+		ss_rewind_valid = 0;
+		ss_rewind_fresh = 0;
+	}
+
+	/* the first state is only kept */
+	if (!ss_rewind_valid)
+	{
+		memcpy(ss_rewind_last, ss_snapshot_array, ss_rewind_size);
+		ss_rewind_valid = 1;
+		ss_rewind_fresh = 1;
+		return 0;
+	}
+
+	/* the delta restores the last state from the new one */
+	size = rewind_encode(ss_rewind_delta, ss_snapshot_array, ss_rewind_last, ss_rewind_size);
+	memcpy(ss_rewind_last, ss_snapshot_array, ss_rewind_size);
+	ss_rewind_fresh = 1;
+
+	/* a delta that doesn't fit in the ring breaks the chain of states */
+	if (size > ss_rewind_ring_size)
+	{
+		ss_rewind_count = 0;
+		ss_rewind_used = 0;
+		return 0;
+	}
+
+	/* place the delta contiguously, wrapping at the end of the ring */
+	pos = ss_rewind_head;
+	if (pos + size > ss_rewind_ring_size)
+	{
+		/* the deltas at the end of the ring are the oldest ones */
+		while (ss_rewind_count > 0 && ss_rewind_list[ss_rewind_first].offset >= pos)
+			rewind_drop_oldest();
+		pos = 0;
+	}
+
+	/* remove the oldest deltas overwritten */
+	while (ss_rewind_count > 0)
+	{
+		ss_rewind *oldest = &ss_rewind_list[ss_rewind_first];
+		if (ss_rewind_count < REWIND_ENTRY_MAX && (oldest->offset >= pos + size || oldest->offset + oldest->size <= pos))
+			break;
+		rewind_drop_oldest();
+	}
+
+	memcpy(ss_rewind_ring + pos, ss_rewind_delta, size);
+	ss_rewind_list[(ss_rewind_first + ss_rewind_count) % REWIND_ENTRY_MAX].offset = pos;
+	ss_rewind_list[(ss_rewind_first + ss_rewind_count) % REWIND_ENTRY_MAX].size = size;
+	ss_rewind_count++;
+	ss_rewind_used += size;
+	ss_rewind_head = pos + size;
+
+	return 0;
+}
+
+
+/*-------------------------------------------------
+    state_save_rewind_pop - go back to the
+    previous recorded state, and put it in the
+    memory snapshot; the first pop after a push
+    returns the newest state, the next ones undo
+    the deltas; the oldest state is kept
+-------------------------------------------------*/
+
+int state_save_rewind_pop(void)
+{
+	if (!ss_rewind_valid || ss_rewind_size != ss_snapshot_size)
+		return 1;
+
+	/* undo the newest delta, if the newest state was already restored */
+	if (ss_rewind_fresh)
+		ss_rewind_fresh = 0;
+	else if (ss_rewind_count > 0)
+	{
+		ss_rewind *newest = &ss_rewind_list[(ss_rewind_first + ss_rewind_count - 1) % REWIND_ENTRY_MAX];
+
+		rewind_decode(ss_rewind_last, ss_rewind_ring + newest->offset, newest->size);
+
+		ss_rewind_head = newest->offset;
+		ss_rewind_used -= newest->size;
+		ss_rewind_count--;
+	}
+
+	memcpy(ss_snapshot_array, ss_rewind_last, ss_rewind_size);
+	ss_snapshot_valid = 1;
+	return 0;
+}
+
+
+/*-------------------------------------------------
+    state_save_rewind_info - return the number of
+    states and the memory used in the ring
+-------------------------------------------------*/
+
+void state_save_rewind_info(UINT32 *count, UINT32 *used)
+{
+	*count = ss_rewind_valid ? ss_rewind_count + 1 : 0;
+	*used = ss_rewind_used;
+}
+
+
+
 /***************************************************************************
 
     Debugging
@@ -106,6 +106,20 @@ void state_save_load_continue(void);
 void state_save_save_finish(void);
 void state_save_load_finish(void);
 
+/* Memory snapshot functions, used by the run-ahead */
+int  state_save_snapshot_save_begin(void);
+void state_save_snapshot_save_continue(void);
+void state_save_snapshot_save_finish(void);
+int  state_save_snapshot_load_begin(void);
+void state_save_snapshot_load_continue(void);
+
+/* Rewind functions, recording the memory snapshots in a ring of deltas */
+int  state_save_rewind_init(UINT32 size);
+void state_save_rewind_free(void);
+int  state_save_rewind_push(void);
+int  state_save_rewind_pop(void);
+void state_save_rewind_info(UINT32 *count, UINT32 *used);
+
 /* Display function */
 void state_save_dump_registry(void);
 
@@ -11,6 +11,7 @@
 
 #include "driver.h"
 #include "streams.h"
+#include "sound/resample.h"
 #include <math.h>
 
 #define VERBOSE			(0)
@@ -28,9 +29,17 @@
 
 #define OUTPUT_BUFFER_SAMPLES			(128*1024)
 #define OUTPUT_TOSS_SAMPLES_THRESH		(OUTPUT_BUFFER_SAMPLES/2)
-#define OUTPUT_KEEP_SAMPLES				256
+/* AdvanceMAME: keep enough history for the polyphase resampler */
+#define OUTPUT_KEEP_SAMPLES				(RESAMPLE_WIDTH_MAX * 2)
 
-#define FRAC_BITS						14
+/* AdvanceMAME: limits of the parallel generation, above them it stays serial */
+#define PARALLEL_MAX_STREAMS			256
+#define PARALLEL_MAX_LEVELS				16
+
+/* AdvanceMAME: max number of different polyphase filters */
+#define RESAMPLE_MAX_FILTERS			32
+
+#define FRAC_BITS						RESAMPLE_FRAC_BITS
 #define FRAC_ONE						(1 << FRAC_BITS)
 #define FRAC_MASK						(FRAC_ONE - 1)
 
@@ -52,6 +61,7 @@ struct stream_input
 	UINT32			resample_in_pos;			/* resample index where next sample will be written */
 	UINT32			resample_out_pos;			/* resample index where next sample will be read */
 	INT16			gain;						/* gain to apply to this input */
+	resample *		filter;						/* AdvanceMAME: polyphase filter, NULL for the linear interpolation */
 };
 
 
@@ -90,6 +100,12 @@ struct _sound_stream
 	/* callback information */
 	void *			param;
 	stream_callback callback;					/* callback function */
+
+	/* AdvanceMAME: parallel generation information */
+	int				group;						/* streams of the same group are never generated in parallel */
+	int				level;						/* dependency level, all the inputs have a lower level */
+	UINT32			target;						/* sample index to reach at the end of the frame */
+	struct _sound_stream *job_next;				/* next stream generated by the same job */
 };
 
 
@@ -102,8 +118,17 @@ struct _sound_stream
 
 static sound_stream *stream_head;
 static void *stream_current_tag;
+static int stream_current_group;
 static int stream_index;
 
+/* AdvanceMAME: jobs of the parallel generation */
+static sound_stream *stream_job[PARALLEL_MAX_STREAMS];
+static int stream_job_count;
+
+/* AdvanceMAME: polyphase filters, shared by the inputs with the same step */
+static resample *stream_filter[RESAMPLE_MAX_FILTERS];
+static int stream_filter_count;
+
 
 
 /*************************************
@@ -114,6 +139,8 @@ static int stream_index;
 
 static void stream_generate_samples(sound_stream *stream, int samples);
 static void resample_input_stream(struct stream_input *input, int samples);
+static void resample_input_setup(struct stream_input *input);
+static void streams_exit(void);
 
 
 
@@ -128,13 +155,35 @@ int streams_init(void)
 	/* reset globals */
 	stream_head = NULL;
 	stream_current_tag = NULL;
+	stream_current_group = 0;
 	stream_index = 0;
+	stream_filter_count = 0;
+
+	add_exit_callback(streams_exit);
 
 	return 0;
 }
 
 
 
+/*************************************
+ *
+ *  AdvanceMAME: Shut down the streams
+ *  engine
+ *
+ *************************************/
+
+static void streams_exit(void)
+{
+	int filternum;
+
+	for (filternum = 0; filternum < stream_filter_count; filternum++)
+		resample_free(stream_filter[filternum]);
+	stream_filter_count = 0;
+}
+
+
+
 /*************************************
  *
  *  Set the current stream tag
@@ -148,6 +197,20 @@ void streams_set_tag(void *streamtag)
 
 
 
+/*************************************
+ *
+ *  AdvanceMAME: Set the current
+ *  stream group
+ *
+ *************************************/
+
+void streams_set_group(int streamgroup)
+{
+	stream_current_group = streamgroup;
+}
+
+
+
 /*************************************
  *
  *  Update all
@@ -234,7 +297,10 @@ void streams_frame_update(void)
 
 							/* if the stream has changed sample rate, update things */
 							if (stream->new_sample_rate != 0)
+							{
 								str->input[inputnum].step_frac = ((UINT64)stream->new_sample_rate << FRAC_BITS) / str->sample_rate;
+								resample_input_setup(&str->input[inputnum]);
+							}
 						}
 
 				/* update the in position to the minimum source frac */
@@ -254,6 +320,170 @@ void streams_frame_update(void)
 
 
 
+/*************************************
+ *
+ *  AdvanceMAME: Generate the samples
+ *  of the frame in parallel
+ *
+ *************************************/
+
+static int stream_compute_level(sound_stream *stream)
+{
+	int inputnum;
+
+	/* already computed */
+	if (stream->level >= 0)
+		return stream->level;
+
+	/* one more than the highest input */
+	stream->level = 0;
+	for (inputnum = 0; inputnum < stream->inputs; inputnum++)
+	{
+		sound_stream *source = stream->input[inputnum].stream;
+		if (source != NULL)
+		{
+			int level = stream_compute_level(source) + 1;
+			if (stream->level < level)
+				stream->level = level;
+		}
+	}
+
+	return stream->level;
+}
+
+
+static void stream_compute_target(sound_stream *stream)
+{
+	INT32 samples = stream->target - stream->output[0].cur_in_pos;
+	int inputnum;
+
+	if (samples <= 0)
+		return;
+
+	/* same computation of stream_generate_samples() */
+	for (inputnum = 0; inputnum < stream->inputs; inputnum++)
+	{
+		struct stream_input *input = &stream->input[inputnum];
+		INT32 resample_samples_needed = input->resample_out_pos + samples - input->resample_in_pos;
+
+		if (resample_samples_needed > 0 && input->stream != NULL)
+		{
+			UINT32 target_source_frac = input->source_frac + resample_samples_needed * input->step_frac;
+			UINT32 target_source;
+
+			if (input->step_frac < FRAC_ONE)
+				target_source_frac += FRAC_ONE;
+
+			target_source = (target_source_frac + FRAC_ONE - 1) >> FRAC_BITS;
+
+			if ((INT32)(target_source - input->stream->target) > 0)
+				input->stream->target = target_source;
+		}
+	}
+}
+
+
+static void stream_generate_job(void *arg, int num, int max)
+{
+	int job;
+
+	for (job = num; job < stream_job_count; job += max)
+	{
+		sound_stream *stream;
+
+		for (stream = stream_job[job]; stream != NULL; stream = stream->job_next)
+			stream_generate_samples(stream, stream->target - stream->output[0].cur_in_pos);
+	}
+}
+
+
+void streams_frame_generate(sound_stream **sink, int sinks, int samples)
+{
+	sound_stream *stream;
+	int count, level, maxlevel, sinknum;
+
+	VPRINTF(("streams_frame_generate\n"));
+
+	/* reset the state */
+	count = 0;
+	for (stream = stream_head; stream != NULL; stream = stream->next)
+	{
+		/* a stream without outputs cannot be generated in advance */
+		if (stream->outputs == 0)
+			return;
+		stream->level = -1;
+		stream->target = stream->output[0].cur_in_pos;
+		++count;
+	}
+
+	if (count > PARALLEL_MAX_STREAMS)
+		return;
+
+	/* sort the streams by dependency level */
+	maxlevel = 0;
+	for (stream = stream_head; stream != NULL; stream = stream->next)
+	{
+		level = stream_compute_level(stream);
+		if (level >= PARALLEL_MAX_LEVELS)
+			return;
+		if (maxlevel < level)
+			maxlevel = level;
+	}
+
+	/* the sinks have to output a full frame, like stream_consume_output() */
+	for (sinknum = 0; sinknum < sinks; sinknum++)
+	{
+		UINT32 target = sink[sinknum]->output[0].cur_out_pos + samples;
+		if ((INT32)(target - sink[sinknum]->target) > 0)
+			sink[sinknum]->target = target;
+	}
+
+	/* propagate the number of samples to generate from the sinks to the sources */
+	for (level = maxlevel; level >= 0; level--)
+		for (stream = stream_head; stream != NULL; stream = stream->next)
+			if (stream->level == level)
+				stream_compute_target(stream);
+
+	/* generate the streams from the sources to the sinks, a level at time */
+	for (level = 0; level <= maxlevel; level++)
+	{
+		stream_job_count = 0;
+
+		for (stream = stream_head; stream != NULL; stream = stream->next)
+		{
+			int job;
+
+			if (stream->level != level || (INT32)(stream->target - stream->output[0].cur_in_pos) <= 0)
+				continue;
+
+			/* streams of the same group go in the same job */
+			stream->job_next = NULL;
+			for (job = 0; job < stream_job_count; job++)
+				if (stream->group != 0 && stream_job[job]->group == stream->group)
+					break;
+
+			if (job == stream_job_count)
+			{
+				stream_job[stream_job_count++] = stream;
+			}
+			else
+			{
+				sound_stream *last;
+				for (last = stream_job[job]; last->job_next != NULL; last = last->job_next) ;
+				last->job_next = stream;
+			}
+		}
+
+		/* the inputs are already generated, so the jobs don't recurse in the lower levels */
+		if (stream_job_count > 1)
+			osd_parallelize(stream_generate_job, NULL, stream_job_count);
+		else if (stream_job_count == 1)
+			stream_generate_job(NULL, 0, 1);
+	}
+}
+
+
+
 /*************************************
  *
  *  Create a new stream
@@ -299,6 +529,7 @@ sound_stream *stream_create(int inputs, int outputs, int sample_rate, void *para
 
 	/* fill in the data */
 	stream->tag         = stream_current_tag;
+	stream->group		= stream_current_group;
 	stream->index		= stream_index++;
 	stream->sample_rate = sample_rate;
 	stream->samples_per_frame_frac = (UINT32)((double)sample_rate * (double)(1 << FRAC_BITS) / Machine->drv->frames_per_second);
@@ -377,6 +608,7 @@ void stream_set_input(sound_stream *stream, int index, sound_stream *input_strea
 	input->resample_in_pos = 0;
 	input->resample_out_pos = 0;
 	input->gain = (int)(0x100 * gain);
+	resample_input_setup(input);
 	VPRINTF(("  step_frac = %08X\n", input->step_frac));
 
 	/* update the dependent info */
@@ -620,68 +852,55 @@ static void resample_input_stream(struct stream_input *input, int samples)
 	stream_sample_t *dest = input->resample + input->resample_in_pos;
 	stream_sample_t *source = input->source->buffer;
 	INT16 gain = (input->gain * input->source->gain) >> 8;
-	UINT32 pos = input->source_frac;
-	UINT32 step = input->step_frac;
-	INT32 sample;
 
-	VPRINTF(("    resample_input_stream -- step = %d\n", step));
+	VPRINTF(("    resample_input_stream -- step = %d\n", input->step_frac));
 
-	/* perfectly matching */
-	if (step == FRAC_ONE)
-	{
-		while (samples--)
-		{
-			/* compute the sample */
-			sample = source[pos >> FRAC_BITS];
-			*dest++ = (sample * gain) >> 8;
-			pos += FRAC_ONE;
-		}
-	}
+	/* AdvanceMAME: the polyphase filter, if selected */
+	if (input->filter != NULL)
+		input->source_frac = resample_poly(input->filter, dest, source, input->source_frac, gain, samples);
+	else
+		input->source_frac = resample_linear(dest, source, input->source_frac, input->step_frac, gain, samples);
 
-	/* input is undersampled: use linear interpolation */
-	else if (step < FRAC_ONE)
-	{
-		while (samples--)
+	/* update the input parameters */
+	input->resample_in_pos += samples;
+}
+
+
+
+/*************************************
+ *
+ *  AdvanceMAME: Select the polyphase
+ *  filter of an input
+ *
+ *************************************/
+
+static void resample_input_setup(struct stream_input *input)
+{
+	int filternum;
+
+	input->filter = NULL;
+
+	/* the linear interpolation is exact without a rate conversion */
+	if (options.sound_resample == 0 || input->stream == NULL || input->step_frac == FRAC_ONE)
+		return;
+
+	/* share the filters with the same step */
+	for (filternum = 0; filternum < stream_filter_count; filternum++)
+		if (stream_filter[filternum]->step == input->step_frac && stream_filter[filternum]->taps == options.sound_resample)
 		{
-			/* compute the sample */
-			sample  = source[(pos >> FRAC_BITS) + 0] * (FRAC_ONE - (pos & FRAC_MASK));
-			sample += source[(pos >> FRAC_BITS) + 1] * (pos & FRAC_MASK);
-			sample >>= FRAC_BITS;
-			*dest++ = (sample * gain) >> 8;
-			pos += step;
+			input->filter = stream_filter[filternum];
+			return;
 		}
-	}
 
-	/* input is oversampled: sum the energy */
-	else
-	{
-		/* use 8 bits to allow some extra headroom */
-		int smallstep = step >> (FRAC_BITS - 8);
+	/* with too many different steps the last ones use the linear interpolation */
+	if (stream_filter_count == RESAMPLE_MAX_FILTERS)
+		return;
 
-		while (samples--)
-		{
-			int tpos = pos >> FRAC_BITS;
-			int remainder = smallstep;
-			int scale;
-
-			/* compute the sample */
-			scale = (FRAC_ONE - (pos & FRAC_MASK)) >> (FRAC_BITS - 8);
-			sample = source[tpos++] * scale;
-			remainder -= scale;
-			while (remainder > 0x100)
-			{
-				sample += source[tpos++] * 0x100;
-				remainder -= 0x100;
-			}
-			sample += source[tpos] * remainder;
-			sample /= smallstep;
+	input->filter = resample_alloc(input->step_frac, options.sound_resample);
+	if (input->filter == NULL)
+		return;
 
-			*dest++ = (sample * gain) >> 8;
-			pos += step;
-		}
-	}
+	logerror("Resample filter of step %.3f, %d taps, %d source samples, %s\n", (double)input->step_frac / FRAC_ONE, input->filter->taps, input->filter->width, resample_level_name(input->filter->level));
 
-	/* update the input parameters */
-	input->resample_in_pos = dest - input->resample;
-	input->source_frac = pos;
+	stream_filter[stream_filter_count++] = input->filter;
 }
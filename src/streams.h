@@ -22,6 +22,10 @@ int streams_init(void);
 void streams_set_tag(void *streamtag);
 void streams_frame_update(void);
 
+/* AdvanceMAME: parallel generation of the independent streams */
+void streams_set_group(int streamgroup);
+void streams_frame_generate(sound_stream **sink, int sinks, int samples);
+
 /* core stream configuration and operation */
 sound_stream *stream_create(int inputs, int outputs, int sample_rate, void *param, stream_callback callback);
 void stream_set_input(sound_stream *stream, int index, sound_stream *input_stream, int output_index, float gain);
@@ -499,6 +499,24 @@ int timer_count_anonymous(void)
 }
 
 
+/*-------------------------------------------------
+    timer_is_anonymous_pending - return TRUE if
+    any anonymous timer is pending, without
+    logging them
+-------------------------------------------------*/
+
+int timer_is_anonymous_pending(void)
+{
+	mame_timer *t;
+
+	for (t = timer_head; t; t = t->next)
+		if (t->temporary && t != callback_timer)
+			return TRUE;
+
+	return FALSE;
+}
+
+
 
 /***************************************************************************
 
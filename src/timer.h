@@ -127,6 +127,7 @@ extern double sec_to_cycles[];
 void timer_init(void);
 void timer_free(void);
 int timer_count_anonymous(void);
+int timer_is_anonymous_pending(void);
 
 mame_time mame_timer_next_fire_time(void);
 void mame_timer_set_global_time(mame_time newbase);
@@ -28,11 +28,6 @@
 
 #define FRAMES_PER_FPS_UPDATE		12
 
-/* VERY IMPORTANT: bitmap_alloc must allocate also a "safety area" 16 pixels wide all
-   around the bitmap. This is required because, for performance reasons, some graphic
-   routines don't clip at boundaries of the bitmap. */
-#define BITMAP_SAFETY				16
-
 
 
 /***************************************************************************
@@ -618,13 +613,17 @@ void force_partial_update(int scanline)
 	rectangle clip = Machine->visible_area;
 
 	/* if skipping this frame, bail */
-	if (osd_skip_this_frame())
+	if (skip_this_frame())
 		return;
 
 	/* skip if less than the lowest so far */
 	if (scanline < last_partial_scanline)
 		return;
 
+	/* wait for the bitmap before the first update of the frame */
+	if (last_partial_scanline == 0)
+		osd_video_bitmap_wait();
+
 	/* if there's a dirty bitmap and we didn't do any partial updates yet, handle it now */
 	if (full_refresh_pending && last_partial_scanline == 0)
 	{
@@ -671,7 +670,7 @@ void draw_screen(void)
 
 void update_video_and_audio(void)
 {
-	int skipped_it = osd_skip_this_frame();
+	int skipped_it = skip_this_frame();
 
 #if defined(MAME_DEBUG) && !defined(NEW_DEBUGGER)
 	debug_trace_delay = 0;
@@ -801,24 +800,31 @@ void updatescreen(void)
 	sound_frame_update();
 
 	/* if we're not skipping this frame, draw the screen */
-	if (!osd_skip_this_frame())
+	if (!skip_this_frame())
 	{
+		osd_video_update_begin();
 		profiler_mark(PROFILER_VIDEO);
 		draw_screen();
 		profiler_mark(PROFILER_END);
+		osd_video_update_end();
 	}
 
-	/* the user interface must be called between vh_update() and osd_update_video_and_audio(), */
-	/* to allow it to overlay things on the game display. We must call it even */
-	/* if the frame is skipped, to keep a consistent timing. */
-	ui_update_and_render(artwork_get_ui_bitmap());
+	/* the frames run ahead but the last one are not shown, and the */
+	/* committed one is presented by the last frame run ahead */
+	if (mame_get_runahead_phase() == RUNAHEAD_NONE || mame_get_runahead_phase() == RUNAHEAD_PRESENT)
+	{
+		/* the user interface must be called between vh_update() and osd_update_video_and_audio(), */
+		/* to allow it to overlay things on the game display. We must call it even */
+		/* if the frame is skipped, to keep a consistent timing. */
+		ui_update_and_render(artwork_get_ui_bitmap());
 
-	/* update our movie recording state */
-	if (!mame_is_paused())
-		record_movie_frame(scrbitmap[0]);
+		/* update our movie recording state */
+		if (!mame_is_paused())
+			record_movie_frame(scrbitmap[0]);
 
-	/* blit to the screen */
-	update_video_and_audio();
+		/* blit to the screen */
+		update_video_and_audio();
+	}
 
 	/* call the end-of-frame callback */
 	if (Machine->drv->video_eof && !mame_is_paused())
@@ -830,12 +836,39 @@ void updatescreen(void)
 }
 
 
+/*-------------------------------------------------
+    updatescreen_present - draw and show a frame
+    already executed, used when the run-ahead
+    cannot go ahead from the committed frame
+-------------------------------------------------*/
+
+void updatescreen_present(void)
+{
+	if (!skip_this_frame())
+	{
+		osd_video_update_begin();
+		profiler_mark(PROFILER_VIDEO);
+		draw_screen();
+		profiler_mark(PROFILER_END);
+		osd_video_update_end();
+	}
+
+	ui_update_and_render(artwork_get_ui_bitmap());
+
+	update_video_and_audio();
+}
+
+
 /*-------------------------------------------------
     skip_this_frame -
 -------------------------------------------------*/
 
 int skip_this_frame(void)
 {
+	/* the frames run ahead are never drawn, but the last one */
+	if (mame_get_runahead_phase() == RUNAHEAD_COMMIT || mame_get_runahead_phase() == RUNAHEAD_HIDDEN)
+		return 1;
+
 	return osd_skip_this_frame();
 }
 
@@ -123,6 +123,9 @@ void update_video_and_audio(void);
 /* (this calls draw_screen and update_video_and_audio) */
 void updatescreen(void);
 
+/* draw and show a frame executed by the run-ahead without showing it */
+void updatescreen_present(void);
+
 /* can we skip this frame? */
 int skip_this_frame(void);
 
@@ -147,6 +150,12 @@ void record_movie_toggle(void);
 void record_movie_frame(mame_bitmap *bitmap);
 
 /* bitmap allocation */
+
+/* VERY IMPORTANT: bitmap_alloc must allocate also a "safety area" 16 pixels wide all
+   around the bitmap. This is required because, for performance reasons, some graphic
+   routines don't clip at boundaries of the bitmap. */
+#define BITMAP_SAFETY				16
+
 #define bitmap_alloc(w,h) bitmap_alloc_depth(w, h, Machine->color_depth)
 #define auto_bitmap_alloc(w,h) auto_bitmap_alloc_depth(w, h, Machine->color_depth)
 mame_bitmap *bitmap_alloc_depth(int width, int height, int depth);
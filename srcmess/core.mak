@@ -42,6 +42,7 @@ MESSCOREOBJS = \
 	$(MESSOBJ)/memory.o \
 	$(MESSOBJ)/palette.o \
 	$(MESSOBJ)/png.o \
+	$(MESSOBJ)/profiler.o \
 	$(MESSOBJ)/romload.o \
 	$(MESSOBJ)/sha1.o \
 	$(MESSOBJ)/sound.o \
@@ -81,9 +82,6 @@ endif
 #-------------------------------------------------
 
 ifdef DEBUG
-MESSCOREOBJS += \
-	$(MESSOBJ)/profiler.o
-
 ifdef NEW_DEBUGGER
 MESSCOREOBJS += \
 	$(MESSOBJ)/debug/debugcmd.o \
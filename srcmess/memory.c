@@ -136,10 +136,18 @@
 ***************************************************************************/
 
 /* macros for the profiler */
+#ifdef MAME_DEBUG
 #define MEMREADSTART()			do { profiler_mark(PROFILER_MEMREAD); } while (0)
 #define MEMREADEND(ret)			do { profiler_mark(PROFILER_END); return ret; } while (0)
 #define MEMWRITESTART()			do { profiler_mark(PROFILER_MEMWRITE); } while (0)
 #define MEMWRITEEND(ret)		do { (ret); profiler_mark(PROFILER_END); return; } while (0)
+#else
+/* AdvanceMAME: the memory accesses are too frequent to be profiled in the release build */
+#define MEMREADSTART()			do { } while (0)
+#define MEMREADEND(ret)			do { return ret; } while (0)
+#define MEMWRITESTART()			do { } while (0)
+#define MEMWRITEEND(ret)		do { (ret); return; } while (0)
+#endif
 
 /* helper macros */
 #define HANDLER_IS_RAM(h)		((FPTR)(h) == STATIC_RAM)
@@ -342,6 +342,9 @@ INT32 osd_get_analog_value(unsigned type, unsigned player, int* analog_type);
 /* called then the game is reset */
 void osd_reset(void);
 
+/* call func in parallel with all the num values from 0 to max - 1, max may be reduced */
+void osd_parallelize(void (*func)(void* arg, int num, int max), void* arg, int max);
+
 /* execute the specified menu (0,1,...) */
 int osd_menu(unsigned menu, int sel);
 
@@ -362,6 +365,16 @@ void osd_save_snapshot(void);
 void osd_record_start(void);
 void osd_record_stop(void);
 
+/* save the timeline of the last frames */
+void osd_timeline_save(void);
+
+/* called at the begin and at the end of the game video update */
+void osd_video_update_begin(void);
+void osd_video_update_end(void);
+
+/* wait until the game bitmap can be drawn */
+void osd_video_bitmap_wait(void);
+
 void osd_ui_menu(const ui_menu_item *items, int numitems, int selected);
 void osd_ui_message(const char* text, int second);
 void osd_ui_osd(const char *text, int percentage, int default_percentage);
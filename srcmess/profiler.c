@@ -14,9 +14,12 @@
 #include "osinline.h"
 #include "profiler.h"
 
+/* AdvanceMAME: the profiler is built only on request */
+#if defined(MAME_DEBUG) || defined(MAME_PROFILER)
+
 
 /* in usrintf.c */
-static int use_profiler;
+int profiler_enabled;
 
 
 /*
@@ -49,21 +52,26 @@ static int FILO_length;
 
 void profiler_start(void)
 {
-	use_profiler = 1;
+	profiler_enabled = 1;
 	FILO_length = 0;
+	memset(&profile, 0, sizeof(profile));
+	memory = 0;
 }
 
 void profiler_stop(void)
 {
-	use_profiler = 0;
+	profiler_enabled = 0;
 }
 
+/* the release build uses a macro to test if the profiler is enabled */
+#undef profiler_mark
+
 void profiler_mark(int type)
 {
 	cycles_t curr_cycles;
 
 
-	if (!use_profiler)
+	if (!profiler_enabled)
 	{
 		FILO_length = 0;
 		return;
@@ -154,7 +162,7 @@ const char *profiler_get_text(void)
 	char *bufptr = buf;
 
 
-	if (!use_profiler) return "";
+	if (!profiler_enabled) return "";
 
 	profiler_mark(PROFILER_PROFILER);
 
@@ -214,3 +222,17 @@ const char *profiler_get_text(void)
 
 	return buf;
 }
+
+UINT64 profiler_get_ticks(int type)
+{
+	UINT64 computed;
+	int j;
+
+	computed = 0;
+	for (j = 0;j < MEMORY;j++)
+		computed += profile.count[j][type];
+
+	return computed;
+}
+
+#endif
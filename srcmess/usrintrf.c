@@ -483,6 +483,9 @@ void ui_set_visible_area(int xmin, int ymin, int xmax, int ymax)
 
 void ui_update_and_render(mame_bitmap *bitmap)
 {
+	/* the user interface may draw in the bitmap, also in the skipped frames */
+	osd_video_bitmap_wait();
+
 	/* if we're single-stepping, pause now */
 	if (single_step)
 	{
@@ -646,6 +646,10 @@ void force_partial_update(int scanline)
 	if (scanline < last_partial_scanline)
 		return;
 
+	/* wait for the bitmap before the first update of the frame */
+	if (last_partial_scanline == 0)
+		osd_video_bitmap_wait();
+
 	/* if there's a dirty bitmap and we didn't do any partial updates yet, handle it now */
 	if (full_refresh_pending && last_partial_scanline == 0)
 	{
@@ -856,9 +860,11 @@ void updatescreen(void)
 	/* if we're not skipping this frame, draw the screen */
 	if (!osd_skip_this_frame())
 	{
+		osd_video_update_begin();
 		profiler_mark(PROFILER_VIDEO);
 		draw_screen();
 		profiler_mark(PROFILER_END);
+		osd_video_update_end();
 	}
 
 	/* the user interface must be called between vh_update() and osd_update_video_and_audio(), */